@@ -37,7 +37,11 @@ QueryMetricsCatalog::QueryMetricsCatalog(concurrency::TransactionContext *txn,
     "inserts  INT NOT NULL, "
     "latency  INT NOT NULL, "
     "cpu_time INT NOT NULL, "
-    "time_stamp INT NOT NULL);") {
+    "time_stamp INT NOT NULL, "
+    "spilled_bytes BIGINT NOT NULL, "
+    "spill_passes  BIGINT NOT NULL, "
+    "interpreted_us BIGINT NOT NULL, "
+    "native_us      BIGINT NOT NULL);") {
   // Add secondary index here if necessary
 }
 
@@ -57,6 +61,10 @@ bool QueryMetricsCatalog::InsertQueryMetrics(concurrency::TransactionContext *tx
                                              int64_t latency,
                                              int64_t cpu_time,
                                              int64_t time_stamp,
+                                             int64_t spilled_bytes,
+                                             int64_t spill_passes,
+                                             int64_t interpreted_us,
+                                             int64_t native_us,
                                              type::AbstractPool *pool) {
   std::unique_ptr<storage::Tuple> tuple(
       new storage::Tuple(catalog_table_->GetSchema(), true));
@@ -85,6 +93,10 @@ bool QueryMetricsCatalog::InsertQueryMetrics(concurrency::TransactionContext *tx
   auto val10 = type::ValueFactory::GetIntegerValue(latency);
   auto val11 = type::ValueFactory::GetIntegerValue(cpu_time);
   auto val12 = type::ValueFactory::GetIntegerValue(time_stamp);
+  auto val13 = type::ValueFactory::GetBigIntValue(spilled_bytes);
+  auto val14 = type::ValueFactory::GetBigIntValue(spill_passes);
+  auto val15 = type::ValueFactory::GetBigIntValue(interpreted_us);
+  auto val16 = type::ValueFactory::GetBigIntValue(native_us);
 
   tuple->SetValue(ColumnId::NAME, val0, pool);
   tuple->SetValue(ColumnId::DATABASE_OID, val1, pool);
@@ -99,6 +111,10 @@ bool QueryMetricsCatalog::InsertQueryMetrics(concurrency::TransactionContext *tx
   tuple->SetValue(ColumnId::LATENCY, val10, pool);
   tuple->SetValue(ColumnId::CPU_TIME, val11, pool);
   tuple->SetValue(ColumnId::TIME_STAMP, val12, pool);
+  tuple->SetValue(ColumnId::SPILLED_BYTES, val13, pool);
+  tuple->SetValue(ColumnId::SPILL_PASSES, val14, pool);
+  tuple->SetValue(ColumnId::INTERPRETED_US, val15, pool);
+  tuple->SetValue(ColumnId::NATIVE_US, val16, pool);
 
   // Insert the tuple
   return InsertTuple(txn, std::move(tuple));
@@ -572,6 +572,95 @@ void Aggregation::AdvanceValues(CodeGen &codegen, llvm::Value *space,
   AdvanceValues(codegen, space, next, empty);
 }
 
+// Merge a single aggregate component stored in the other storage space into
+// the same component in the provided storage space. Partial aggregates merge
+// like SUM(), except for MIN() and MAX(), which merge like themselves.
+void Aggregation::MergeValue(
+    CodeGen &codegen, llvm::Value *space, ExpressionType type,
+    uint32_t storage_index, llvm::Value *other_space,
+    UpdateableStorage::NullBitmap &null_bitmap,
+    UpdateableStorage::NullBitmap &other_null_bitmap) const {
+  switch (type) {
+    case ExpressionType::AGGREGATE_MIN:
+    case ExpressionType::AGGREGATE_MAX:
+      break;
+    default:
+      type = ExpressionType::AGGREGATE_SUM;
+      break;
+  }
+
+  if (!null_bitmap.IsNullable(storage_index)) {
+    codegen::Value other =
+        storage_.GetValueSkipNull(codegen, other_space, storage_index);
+    DoAdvanceValue(codegen, space, type, storage_index, other);
+  } else {
+    // A NULL partial aggregate means the other side hasn't seen a non-NULL
+    // value yet, which DoNullCheck() skips
+    codegen::Value other = storage_.GetValue(codegen, other_space,
+                                             storage_index, other_null_bitmap);
+    DoNullCheck(codegen, space, type, storage_index, other, null_bitmap);
+  }
+}
+
+// Merge all the aggregates stored in the other storage space into the
+// aggregates in the provided storage space
+void Aggregation::MergeValues(CodeGen &codegen, llvm::Value *space,
+                              llvm::Value *other_space) const {
+  // The null bitmap trackers
+  UpdateableStorage::NullBitmap null_bitmap(codegen, storage_, space);
+  UpdateableStorage::NullBitmap other_null_bitmap(codegen, storage_,
+                                                  other_space);
+
+  for (const auto &agg_info : aggregate_infos_) {
+    PELOTON_ASSERT(!agg_info.is_distinct);
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        MergeValue(codegen, space, agg_info.aggregate_type,
+                   agg_info.storage_indices[0], other_space, null_bitmap,
+                   other_null_bitmap);
+        break;
+      }
+      case ExpressionType::AGGREGATE_AVG: {
+        // AVG merges both the SUM and the COUNT
+        MergeValue(codegen, space, ExpressionType::AGGREGATE_SUM,
+                   agg_info.storage_indices[0], other_space, null_bitmap,
+                   other_null_bitmap);
+        MergeValue(codegen, space, ExpressionType::AGGREGATE_COUNT,
+                   agg_info.storage_indices[1], other_space, null_bitmap,
+                   other_null_bitmap);
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when merging aggregator",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+
+  // Write the final contents of the null bitmap
+  null_bitmap.WriteBack(codegen);
+}
+
+// MIN() and MAX() never use a hash table for distinct values
+bool Aggregation::CanMergeValues(
+    const std::vector<planner::AggregatePlan::AggTerm> &agg_terms) {
+  for (const auto &agg_term : agg_terms) {
+    if (agg_term.distinct &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_MIN &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_MAX) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // This function will compute the final values of all aggregates stored in the
 // provided storage space, populating the provided vector with these values.
 void Aggregation::FinalizeValues(
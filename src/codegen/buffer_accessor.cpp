@@ -46,6 +46,13 @@ void BufferAccessor::Append(CodeGen &codegen, llvm::Value *buffer_ptr,
   null_bitmap.WriteBack(codegen);
 }
 
+void BufferAccessor::SetValue(CodeGen &codegen, llvm::Value *tuple_ptr,
+                              uint32_t col_id,
+                              const codegen::Value &value) const {
+  PELOTON_ASSERT(!value.IsNullable());
+  storage_format_.SetValueSkipNull(codegen, tuple_ptr, col_id, value);
+}
+
 void BufferAccessor::Iterate(CodeGen &codegen, llvm::Value *buffer_ptr,
                              BufferAccessor::IterateCallback &callback) const {
   auto *start = codegen.Load(BufferProxy::buffer_start, buffer_ptr);
@@ -64,7 +71,7 @@ void BufferAccessor::Iterate(CodeGen &codegen, llvm::Value *buffer_ptr,
     }
 
     // Invoke callback
-    callback.ProcessEntry(codegen, vals);
+    callback.ProcessEntry(codegen, vals, pos);
 
     // Move along
     auto *next = codegen->CreateConstInBoundsGEP1_64(
@@ -88,7 +95,8 @@ llvm::Value *BufferAccessor::NumTuples(CodeGen &codegen,
   start = codegen->CreatePtrToInt(start, codegen.Int64Type());
   end = codegen->CreatePtrToInt(end, codegen.Int64Type());
   auto *diff = codegen->CreateSub(end, start);
-  diff = codegen->CreateAShr(diff, 3, "numTuples", true);
+  diff = codegen->CreateUDiv(diff, codegen.Const64(GetTupleSize()), "numTuples",
+                             true);
   return codegen->CreateTrunc(diff, codegen.Int32Type());
 }
 
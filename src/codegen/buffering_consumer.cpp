@@ -76,9 +76,8 @@ BufferingConsumer::BufferingConsumer(const std::vector<oid_t> &cols,
 void BufferingConsumer::BufferTuple(char *opaque_state, char *tuple,
                                     uint32_t num_cols) {
   auto *buffer = reinterpret_cast<Buffer *>(opaque_state);
-  std::lock_guard<std::mutex> lock{buffer->mutex};
-  buffer->output.emplace_back(reinterpret_cast<peloton::type::Value *>(tuple),
-                              num_cols);
+  buffer->local_output.local().emplace_back(
+      reinterpret_cast<peloton::type::Value *>(tuple), num_cols);
 }
 
 // Create two pieces of state: a pointer to the output tuple vector and an
@@ -164,6 +163,17 @@ char *BufferingConsumer::GetConsumerState() {
 }
 
 const std::vector<WrappedTuple> &BufferingConsumer::GetOutputTuples() const {
+  std::lock_guard<std::mutex> lock{buffer_.mutex};
+  for (auto &local_output : buffer_.local_output) {
+    if (buffer_.output.empty()) {
+      // Common case for serial plans: steal the only local buffer, no copies
+      buffer_.output.swap(local_output);
+    } else {
+      buffer_.output.insert(buffer_.output.end(), local_output.begin(),
+                            local_output.end());
+    }
+  }
+  buffer_.local_output.clear();
   return buffer_.output;
 }
 
@@ -12,10 +12,14 @@
 
 #include "codegen/code_context.h"
 
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Operator.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Transforms/Scalar.h"
@@ -43,9 +47,27 @@ namespace {
 
 class PelotonMemoryManager : public llvm::SectionMemoryManager {
  public:
-  explicit PelotonMemoryManager(const std::unordered_map<
-      std::string, std::pair<llvm::Function *, CodeContext::FuncPtr>> &builtins)
-      : builtins_(builtins) {}
+  PelotonMemoryManager(const std::unordered_map<
+      std::string, std::pair<llvm::Function *, CodeContext::FuncPtr>> &builtins,
+      std::atomic<size_t> &code_size)
+      : builtins_(builtins), code_size_(code_size) {}
+
+  uint8_t *allocateCodeSection(uintptr_t size, unsigned alignment,
+                               unsigned section_id,
+                               llvm::StringRef section_name) override {
+    code_size_ += size;
+    return llvm::SectionMemoryManager::allocateCodeSection(
+        size, alignment, section_id, section_name);
+  }
+
+  uint8_t *allocateDataSection(uintptr_t size, unsigned alignment,
+                               unsigned section_id,
+                               llvm::StringRef section_name,
+                               bool is_read_only) override {
+    code_size_ += size;
+    return llvm::SectionMemoryManager::allocateDataSection(
+        size, alignment, section_id, section_name, is_read_only);
+  }
 
 #if LLVM_VERSION_GE(4, 0)
 #define RET_TYPE llvm::JITSymbol
@@ -94,8 +116,69 @@ class PelotonMemoryManager : public llvm::SectionMemoryManager {
   const std::unordered_map<std::string,
                            std::pair<llvm::Function *, CodeContext::FuncPtr>> &
       builtins_;
+
+  // The number of bytes allocated for the sections of the compiled code
+  std::atomic<size_t> &code_size_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// Peloton Object Cache
+///
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Hands the object code of a module to the JIT engine instead of generating
+ * it, or hands the generated object code to a callback.
+ */
+class PelotonObjectCache : public llvm::ObjectCache {
+ public:
+  PelotonObjectCache(const std::string &object,
+                     const CodeContext::ObjectCallback &callback)
+      : object_(object), callback_(callback) {}
+
+  void notifyObjectCompiled(const llvm::Module *,
+                            llvm::MemoryBufferRef object) override {
+    if (callback_) {
+      callback_(object.getBufferStart(), object.getBufferSize());
+    }
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override {
+    if (object_.empty()) {
+      return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(object_);
+  }
+
+ private:
+  const std::string &object_;
+  const CodeContext::ObjectCallback &callback_;
 };
 
+/// Check if the value is an integer constant cast to a pointer, i.e., an
+/// address of this process, or a constant expression computed from one
+bool IsProcessAddress(const llvm::Value *value) {
+  const auto *op = llvm::dyn_cast<llvm::Operator>(value);
+  if (op == nullptr) {
+    return false;
+  }
+  if (op->getOpcode() == llvm::Instruction::IntToPtr) {
+    const auto *addr = llvm::dyn_cast<llvm::ConstantInt>(op->getOperand(0));
+    if (addr != nullptr && !addr->isZero()) {
+      return true;
+    }
+  }
+  if (llvm::isa<llvm::ConstantExpr>(op)) {
+    for (const auto &operand : op->operands()) {
+      if (IsProcessAddress(operand.get())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// Instruction Count Pass
@@ -177,6 +260,7 @@ CodeContext::CodeContext()
       udf_func_ptr_(nullptr),
       pass_manager_(nullptr),
       engine_(nullptr),
+      code_size_(0),
       is_verified_(false) {
   // Initialize JIT stuff
   llvm::InitializeNativeTarget();
@@ -200,7 +284,8 @@ CodeContext::CodeContext()
   engine_.reset(llvm::EngineBuilder(std::move(m))
                     .setEngineKind(llvm::EngineKind::JIT)
                     .setMCJITMemoryManager(
-                         llvm::make_unique<PelotonMemoryManager>(builtins_))
+                         llvm::make_unique<PelotonMemoryManager>(builtins_,
+                                                                 code_size_))
                     .setMCPU(llvm::sys::getHostCPUName())
                     .setErrorStr(&err_str_)
                     .create());
@@ -322,9 +407,22 @@ void CodeContext::Compile() {
     inst_count.DumpStats();
   }
 
+  // Load the cached object code, or pass on the generated one
+  std::unique_ptr<PelotonObjectCache> object_cache;
+  if (HasCachedObject() || object_callback_) {
+    object_cache.reset(new PelotonObjectCache(cached_object_, object_callback_));
+    engine_->setObjectCache(object_cache.get());
+  }
+
   // JIT compile the module
   engine_->finalizeObject();
 
+  if (object_cache != nullptr) {
+    engine_->setObjectCache(nullptr);
+    cached_object_.clear();
+    cached_object_.shrink_to_fit();
+  }
+
   // Pull out the compiled function implementations
   for (auto &func_iter : functions_) {
     func_iter.second = engine_->getPointerToFunction(func_iter.first);
@@ -336,6 +434,57 @@ void CodeContext::Compile() {
   }
 }
 
+std::string CodeContext::GetDigest() const {
+  std::string ir;
+  llvm::raw_string_ostream ostream{ir};
+
+  // The target the code is compiled for
+  auto *target_machine = engine_->getTargetMachine();
+  ostream << target_machine->getTargetTriple().str() << ' '
+          << target_machine->getTargetCPU() << ' '
+          << target_machine->getTargetFeatureString() << '\n';
+
+  // The module's name contains the ID, so only its contents are hashed
+  for (const auto *type : module_->getIdentifiedStructTypes()) {
+    type->print(ostream);
+    ostream << '\n';
+  }
+  for (const auto &global : module_->globals()) {
+    global.print(ostream);
+    ostream << '\n';
+  }
+  for (const auto &func : *module_) {
+    func.print(ostream);
+  }
+  ostream.flush();
+
+  llvm::MD5 md5;
+  md5.update(ir);
+  llvm::MD5::MD5Result result;
+  md5.final(result);
+  llvm::SmallString<32> digest;
+  llvm::MD5::stringifyResult(result, digest);
+  return digest.str().str();
+}
+
+bool CodeContext::HasProcessAddresses() const {
+  for (const auto &func : *module_) {
+    for (const auto &block : func) {
+      for (const auto &inst : block) {
+        if (IsProcessAddress(&inst)) {
+          return true;
+        }
+        for (const auto &operand : inst.operands()) {
+          if (IsProcessAddress(operand.get())) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
 size_t CodeContext::GetTypeSize(llvm::Type *type) const {
   auto size = GetDataLayout().getTypeSizeInBits(type) / 8;
   return size != 0 ? size : 1;
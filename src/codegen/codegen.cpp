@@ -216,6 +216,12 @@ llvm::Value *CodeGen::Sqrt(llvm::Value *val) {
   return CallFunc(sqrt_func, {val});
 }
 
+llvm::Value *CodeGen::ByteSwap(llvm::Value *val) {
+  llvm::Function *bswap_func = llvm::Intrinsic::getDeclaration(
+      &GetModule(), llvm::Intrinsic::bswap, val->getType());
+  return CallFunc(bswap_func, {val});
+}
+
 llvm::Value *CodeGen::CallAddWithOverflow(llvm::Value *left, llvm::Value *right,
                                           llvm::Value *&overflow_bit) {
   PELOTON_ASSERT(left->getType() == right->getType());
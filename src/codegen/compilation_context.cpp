@@ -132,7 +132,7 @@ void CompilationContext::GenerateHelperFunctions() {
 // Generate code for the init() function of the query
 llvm::Function *CompilationContext::GenerateInitFunction() {
   // Create function definition
-  std::string name = StringUtil::Format("_%lu_init", code_context_.GetID());
+  std::string name = "_init";
   std::vector<FunctionDeclaration::ArgumentInfo> args = {
       {"queryState", query_state_.GetType()->getPointerTo()}};
   FunctionBuilder init_func(code_context_, name, codegen_.VoidType(), args);
@@ -157,7 +157,7 @@ llvm::Function *CompilationContext::GenerateInitFunction() {
 // Generate the code for the plan() function of the query
 llvm::Function *CompilationContext::GeneratePlanFunction(
     const planner::AbstractPlan &root) {
-  std::string name = StringUtil::Format("_%lu_plan", code_context_.GetID());
+  std::string name = "_plan";
   std::vector<FunctionDeclaration::ArgumentInfo> args = {
       {"queryState", query_state_.GetType()->getPointerTo()}};
   FunctionBuilder plan_func(code_context_, name, codegen_.VoidType(), args);
@@ -174,7 +174,7 @@ llvm::Function *CompilationContext::GeneratePlanFunction(
 
 // Generate the code for the tearDown() function of the query
 llvm::Function *CompilationContext::GenerateTearDownFunction() {
-  std::string name = StringUtil::Format("_%lu_tearDown", code_context_.GetID());
+  std::string name = "_tearDown";
   std::vector<FunctionDeclaration::ArgumentInfo> args = {
       {"queryState", query_state_.GetType()->getPointerTo()}};
   FunctionBuilder tear_down_func(code_context_, name, codegen_.VoidType(),
@@ -224,7 +224,7 @@ AuxiliaryProducerFunction CompilationContext::DeclareAuxiliaryProducer(
   if (!provided_name.empty()) {
     fn_name = provided_name;
   } else {
-    fn_name = StringUtil::Format("_%lu_auxPlanFunction", code_context_.GetID());
+    fn_name = "_auxPlanFunction";
   }
 
   std::vector<FunctionDeclaration::ArgumentInfo> fn_args = {
@@ -84,7 +84,7 @@ llvm::Value *ExecutionConsumer::GetThreadStatesPtr(
   CodeGen &codegen = compilation_ctx.GetCodeGen();
   auto *exec_ctx_ptr = GetExecutorContextPtr(compilation_ctx);
   return codegen->CreateConstInBoundsGEP2_32(executor_ctx_type_, exec_ctx_ptr,
-                                             0, 5, "threadStatesPtr");
+                                             0, 6, "threadStatesPtr");
 }
 
 }  // namespace codegen
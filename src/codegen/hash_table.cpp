@@ -21,14 +21,14 @@
 namespace peloton {
 namespace codegen {
 
-HashTable::HashTable() {
+HashTable::HashTable() : value_size_(0), track_matches_(false) {
   // This constructor shouldn't generally be used at all, but there are
   // cases when the key-type is not known at construction time.
 }
 
 HashTable::HashTable(CodeGen &codegen, const std::vector<type::Type> &key_type,
-                     uint32_t value_size)
-    : value_size_(value_size) {
+                     uint32_t value_size, bool track_matches)
+    : value_size_(value_size), track_matches_(track_matches) {
   key_storage_.Setup(codegen, key_type);
 }
 
@@ -41,7 +41,7 @@ void HashTable::Init(UNUSED_ATTRIBUTE CodeGen &codegen,
 void HashTable::Init(CodeGen &codegen, llvm::Value *exec_ctx,
                      llvm::Value *ht_ptr) const {
   auto *key_size = codegen.Const32(key_storage_.MaxStorageSize());
-  auto *value_size = codegen.Const32(value_size_);
+  auto *value_size = codegen.Const32(value_size_ + (track_matches_ ? 1 : 0));
   codegen.Call(HashTableProxy::Init, {ht_ptr, exec_ctx, key_size, value_size});
 }
 
@@ -153,6 +153,12 @@ void HashTable::Insert(CodeGen &codegen, llvm::Value *ht_ptr, llvm::Value *hash,
   // Invoke the callback to let her store the payload
   llvm::Value *data_space_ptr = key_storage_.StoreValues(codegen, ptr, key);
   insert_callback.StoreValue(codegen, data_space_ptr);
+
+  // New entries haven't been matched yet
+  if (track_matches_) {
+    codegen->CreateStore(codegen.ConstBool(false),
+                         MatchFlagPtr(codegen, data_space_ptr));
+  }
 }
 
 void HashTable::InsertLazy(CodeGen &codegen, llvm::Value *ht_ptr,
@@ -178,6 +184,24 @@ void HashTable::MergeLazyUnfinished(CodeGen &codegen, llvm::Value *global_ht,
   codegen.Call(HashTableProxy::MergeLazyUnfinished, {global_ht, local_ht});
 }
 
+void HashTable::BuildLazyPartitioned(CodeGen &codegen, llvm::Value *ht_ptr,
+                                     llvm::Value *thread_states,
+                                     uint32_t ht_state_offset) const {
+  codegen.Call(HashTableProxy::BuildLazyPartitioned,
+               {ht_ptr, thread_states, codegen.Const32(ht_state_offset)});
+}
+
+void HashTable::EnableSpilling(CodeGen &codegen, llvm::Value *ht_ptr,
+                               llvm::Value *exec_ctx_ptr,
+                               llvm::Value *owner_ptr) const {
+  codegen.Call(HashTableProxy::EnableSpilling,
+               {ht_ptr, exec_ctx_ptr, owner_ptr});
+}
+
+llvm::Value *HashTable::NextPass(CodeGen &codegen, llvm::Value *ht_ptr) const {
+  return codegen.Call(HashTableProxy::NextPass, {ht_ptr});
+}
+
 void HashTable::Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                         IterateCallback &callback) const {
   llvm::Value *buckets_ptr = codegen.Load(HashTableProxy::directory, ht_ptr);
@@ -264,6 +288,25 @@ void HashTable::Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const {
   codegen.Call(HashTableProxy::Destroy, {ht_ptr});
 }
 
+void HashTable::MarkMatched(CodeGen &codegen, llvm::Value *value_ptr) const {
+  codegen->CreateStore(codegen.ConstBool(true),
+                       MatchFlagPtr(codegen, value_ptr));
+}
+
+llvm::Value *HashTable::IsMatched(CodeGen &codegen,
+                                  llvm::Value *value_ptr) const {
+  return codegen->CreateLoad(MatchFlagPtr(codegen, value_ptr));
+}
+
+llvm::Value *HashTable::MatchFlagPtr(CodeGen &codegen,
+                                     llvm::Value *value_ptr) const {
+  PELOTON_ASSERT(track_matches_);
+  llvm::Value *flag_ptr = codegen->CreateConstInBoundsGEP1_32(
+      codegen.ByteType(), value_ptr, value_size_);
+  return codegen->CreateBitCast(flag_ptr,
+                                codegen.BoolType()->getPointerTo());
+}
+
 void HashTable::VectorizedIterate(
     UNUSED_ATTRIBUTE CodeGen &codegen, UNUSED_ATTRIBUTE llvm::Value *ht_ptr,
     UNUSED_ATTRIBUTE Vector &selection_vector,
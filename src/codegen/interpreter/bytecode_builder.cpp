@@ -24,18 +24,21 @@ namespace codegen {
 namespace interpreter {
 
 BytecodeBuilder::BytecodeBuilder(const CodeContext &code_context,
-                                 const llvm::Function *function)
+                                 const llvm::Function *function,
+                                 const FunctionResolver *function_resolver)
     : bytecode_function_(function->getName().str()),
       number_value_slots_(0),
       number_temporary_value_slots_(0),
       rpo_traversal_(function),
       code_context_(code_context),
-      llvm_function_(function) {}
+      llvm_function_(function),
+      function_resolver_(function_resolver) {}
 
 BytecodeFunction BytecodeBuilder::CreateBytecodeFunction(
     const CodeContext &code_context, const llvm::Function *function,
-    bool use_naive_register_allocator) {
-  BytecodeBuilder builder(code_context, function);
+    bool use_naive_register_allocator,
+    const FunctionResolver *function_resolver) {
+  BytecodeBuilder builder(code_context, function, function_resolver);
   builder.AnalyseFunction();
 
   if (use_naive_register_allocator) {
@@ -302,6 +305,17 @@ value_t BytecodeBuilder::GetConstantValue(
       }
 
       case llvm::Type::PointerTyID: {
+        // The address of a function in this code context, which the resolver
+        // replaces with a native entry point
+        if (auto *function = llvm::dyn_cast<llvm::Function>(
+                constant->stripPointerCasts())) {
+          if (function_resolver_ == nullptr || function->isDeclaration()) {
+            throw NotSupportedException("function pointer not supported: " +
+                                        function->getName().str());
+          }
+          return reinterpret_cast<value_t>((*function_resolver_)(function));
+        }
+
         if (constant->getNumOperands() > 0) {
           if (auto *constant_int =
                   llvm::dyn_cast<llvm::ConstantInt>(constant->getOperand(0))) {
@@ -1784,8 +1798,8 @@ void BytecodeBuilder::TranslateCall(const llvm::Instruction *instruction) {
     if (result != sub_function_mapping_.end()) {
       sub_function_index = result->second;
     } else {
-      auto sub_function =
-          BytecodeBuilder::CreateBytecodeFunction(code_context_, function);
+      auto sub_function = BytecodeBuilder::CreateBytecodeFunction(
+          code_context_, function, false, function_resolver_);
 
       bytecode_function_.sub_functions_.push_back(std::move(sub_function));
       sub_function_index = bytecode_function_.sub_functions_.size() - 1;
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// function_trampoline.cpp
+//
+// Identification: src/codegen/interpreter/function_trampoline.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/interpreter/function_trampoline.h"
+
+#include <cstring>
+
+#include "codegen/codegen.h"
+#include "codegen/interpreter/bytecode_interpreter.h"
+#include "common/exception.h"
+
+namespace peloton {
+namespace codegen {
+namespace interpreter {
+
+FunctionTrampoline::FunctionTrampoline(
+    const CodeContext &code_context, const llvm::Function *function,
+    const BytecodeBuilder::FunctionResolver *function_resolver)
+    : llvm_function_(function),
+      bytecode_function_(BytecodeBuilder::CreateBytecodeFunction(
+          code_context, function, false, function_resolver)),
+      return_size_(0),
+      returns_floating_point_(false),
+      closure_(nullptr),
+      entry_point_(nullptr),
+      native_function_(nullptr) {
+  // Every argument and the return value fit in a value slot
+  for (const auto &argument : function->args()) {
+    argument_types_.push_back(GetFFIType(code_context, argument.getType()));
+    argument_sizes_.push_back(code_context.GetTypeSize(argument.getType()));
+  }
+
+  llvm::Type *return_type = function->getReturnType();
+  ffi_type *return_ffi_type = GetFFIType(code_context, return_type);
+  if (!return_type->isVoidTy()) {
+    return_size_ = code_context.GetTypeSize(return_type);
+    returns_floating_point_ = return_type->isFloatingPointTy();
+  }
+
+  if (ffi_prep_cif(&call_interface_, FFI_DEFAULT_ABI,
+                   static_cast<unsigned int>(argument_types_.size()),
+                   return_ffi_type, argument_types_.data()) != FFI_OK) {
+    throw Exception("initializing ffi call interface failed");
+  }
+
+  closure_ = reinterpret_cast<ffi_closure *>(
+      ffi_closure_alloc(sizeof(ffi_closure), &entry_point_));
+  if (closure_ == nullptr) {
+    throw Exception("allocating ffi closure failed");
+  }
+
+  if (ffi_prep_closure_loc(closure_, &call_interface_,
+                           &FunctionTrampoline::Call, this,
+                           entry_point_) != FFI_OK) {
+    ffi_closure_free(closure_);
+    throw Exception("initializing ffi closure failed");
+  }
+}
+
+FunctionTrampoline::~FunctionTrampoline() { ffi_closure_free(closure_); }
+
+void FunctionTrampoline::Call(ffi_cif *call_interface, void *return_value,
+                              void **arguments, void *trampoline) {
+  auto *self = reinterpret_cast<FunctionTrampoline *>(trampoline);
+
+  void *native_function =
+      self->native_function_.load(std::memory_order_acquire);
+  if (native_function != nullptr) {
+    ffi_call(call_interface, FFI_FN(native_function), return_value, arguments);
+    return;
+  }
+
+  std::vector<value_t> values(self->argument_sizes_.size(), 0);
+  for (size_t i = 0; i < values.size(); i++) {
+    PELOTON_MEMCPY(&values[i], arguments[i], self->argument_sizes_[i]);
+  }
+
+  value_t result =
+      BytecodeInterpreter::ExecuteFunction(self->bytecode_function_, values);
+
+  if (self->return_size_ == 0) {
+    return;
+  } else if (self->returns_floating_point_) {
+    PELOTON_MEMCPY(return_value, &result, self->return_size_);
+  } else {
+    // libffi expects integral return values widened to a full register
+    ffi_arg widened = 0;
+    PELOTON_MEMCPY(&widened, &result, self->return_size_);
+    *reinterpret_cast<ffi_arg *>(return_value) = widened;
+  }
+}
+
+ffi_type *FunctionTrampoline::GetFFIType(const CodeContext &code_context,
+                                         llvm::Type *type) const {
+  if (type->isVoidTy()) {
+    return &ffi_type_void;
+  } else if (type->isPointerTy()) {
+    return &ffi_type_pointer;
+  } else if (type->isFloatTy()) {
+    return &ffi_type_float;
+  } else if (type->isDoubleTy()) {
+    return &ffi_type_double;
+  }
+
+  // exact type not necessary, only size is important
+  switch (code_context.GetTypeSize(type)) {
+    case 1:
+      return &ffi_type_uint8;
+    case 2:
+      return &ffi_type_uint16;
+    case 4:
+      return &ffi_type_uint32;
+    case 8:
+      return &ffi_type_uint64;
+    default:
+      throw NotSupportedException(
+          std::string("can't find a ffi_type for type: ") +
+          CodeGen::Dump(type));
+  }
+}
+
+}  // namespace interpreter
+}  // namespace codegen
+}  // namespace peloton
@@ -702,6 +702,65 @@ void OAHashTable::Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const {
   codegen.Call(OAHashTableProxy::Destroy, {ht_ptr});
 }
 
+llvm::Value *OAHashTable::LoadEntry(CodeGen &codegen, llvm::Value *entry_ptr,
+                                    llvm::Value *&hash,
+                                    std::vector<codegen::Value> &key) const {
+  hash = LoadHashEntryField(codegen, entry_ptr, 0, 1);
+  llvm::Value *key_ptr = GetKeyPtr(codegen, entry_ptr);
+  return key_storage_.LoadValues(codegen, key_ptr, key);
+}
+
+void OAHashTable::InitPartitions(CodeGen &codegen,
+                                 llvm::Value *partitions_ptr) const {
+  auto *ht_ptr_type = OAHashTableProxy::GetType(codegen)->getPointerTo();
+  codegen.Call(OAHashTableProxy::InitPartitions,
+               {codegen->CreatePointerCast(partitions_ptr, ht_ptr_type)});
+}
+
+void OAHashTable::MergePartitioned(CodeGen &codegen,
+                                   llvm::Value *partitions_ptr,
+                                   llvm::Value *thread_states,
+                                   uint32_t ht_state_offset,
+                                   llvm::Function *merge_func) const {
+  auto *ht_ptr_type = OAHashTableProxy::GetType(codegen)->getPointerTo();
+  auto *merge_func_type =
+      proxy::TypeBuilder<util::OAHashTable::MergeFunction>::GetType(codegen);
+  codegen.Call(
+      OAHashTableProxy::MergePartitioned,
+      {codegen->CreatePointerCast(codegen.GetState(), codegen.VoidPtrType()),
+       thread_states, codegen.Const32(ht_state_offset),
+       codegen->CreatePointerCast(partitions_ptr, ht_ptr_type),
+       codegen->CreatePointerCast(merge_func, merge_func_type)});
+}
+
+void OAHashTable::DestroyPartitions(CodeGen &codegen,
+                                    llvm::Value *partitions_ptr) const {
+  auto *ht_ptr_type = OAHashTableProxy::GetType(codegen)->getPointerTo();
+  codegen.Call(OAHashTableProxy::DestroyPartitions,
+               {codegen->CreatePointerCast(partitions_ptr, ht_ptr_type)});
+}
+
+void OAHashTable::EnableSpilling(CodeGen &codegen, llvm::Value *ht_ptr,
+                                 llvm::Value *exec_ctx_ptr,
+                                 llvm::Value *owner_ptr) const {
+  codegen.Call(OAHashTableProxy::EnableSpilling,
+               {ht_ptr, exec_ctx_ptr, owner_ptr});
+}
+
+void OAHashTable::FlushSpilled(CodeGen &codegen, llvm::Value *ht_ptr) const {
+  codegen.Call(OAHashTableProxy::FlushSpilled, {ht_ptr});
+}
+
+llvm::Value *OAHashTable::NextSpilledPartition(
+    CodeGen &codegen, llvm::Value *ht_ptr, llvm::Function *merge_func) const {
+  auto *merge_func_type =
+      proxy::TypeBuilder<util::OAHashTable::MergeFunction>::GetType(codegen);
+  return codegen.Call(
+      OAHashTableProxy::NextSpilledPartition,
+      {codegen->CreatePointerCast(codegen.GetState(), codegen.VoidPtrType()),
+       ht_ptr, codegen->CreatePointerCast(merge_func, merge_func_type)});
+}
+
 void OAHashTable::PrefetchBucket(CodeGen &codegen, llvm::Value *ht_ptr,
                                  llvm::Value *hash,
                                  OAHashTable::PrefetchType pf_type,
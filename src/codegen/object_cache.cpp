@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache.cpp
+//
+// Identification: src/codegen/object_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/object_cache.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include <boost/filesystem.hpp>
+
+#include "catalog/schema.h"
+#include "codegen/code_context.h"
+#include "common/logger.h"
+#include "planner/abstract_scan_plan.h"
+#include "planner/delete_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/update_plan.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// The extension of the object code files
+const std::string kObjectFileExtension = ".o";
+
+// Get the table the plan node reads or modifies, if any
+const storage::DataTable *GetTable(const planner::AbstractPlan &plan) {
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN:
+      return static_cast<const planner::AbstractScan &>(plan).GetTable();
+    case PlanNodeType::INSERT:
+      return static_cast<const planner::InsertPlan &>(plan).GetTable();
+    case PlanNodeType::UPDATE:
+      return static_cast<const planner::UpdatePlan &>(plan).GetTable();
+    case PlanNodeType::DELETE:
+      return static_cast<const planner::DeletePlan &>(plan).GetTable();
+    default:
+      return nullptr;
+  }
+}
+
+// Combine the schemas of the tables accessed in the plan into the hash
+hash_t HashSchemas(const planner::AbstractPlan &plan, hash_t hash) {
+  const auto *table = GetTable(plan);
+  if (table != nullptr) {
+    hash = HashUtil::CombineHashes(hash, table->GetSchema()->Hash());
+  }
+  for (size_t i = 0; i < plan.GetChildrenSize(); i++) {
+    hash = HashSchemas(*plan.GetChild(i), hash);
+  }
+  return hash;
+}
+
+}  // namespace
+
+ObjectCache::ObjectCache() {
+  SetDirectory(settings::SettingsManager::GetString(
+      settings::SettingId::codegen_object_cache_directory));
+}
+
+void ObjectCache::SetDirectory(const std::string &directory) {
+  if (!directory.empty()) {
+    boost::system::error_code error;
+    boost::filesystem::create_directories(directory, error);
+    if (error) {
+      LOG_ERROR("Cannot create directory %s: %s", directory.c_str(),
+                error.message().c_str());
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(directory_lock_);
+  directory_ = directory;
+}
+
+bool ObjectCache::IsEnabled() const { return !GetDirectory().empty(); }
+
+std::string ObjectCache::GetDirectory() const {
+  std::lock_guard<std::mutex> lock(directory_lock_);
+  return directory_;
+}
+
+bool ObjectCache::Attach(const planner::AbstractPlan &plan,
+                         CodeContext &code_context) {
+  std::string directory = GetDirectory();
+  if (directory.empty() || code_context.HasProcessAddresses()) {
+    return false;
+  }
+
+  std::string path =
+      StringUtil::Format("%s/%016" PRIx64 "%s", directory.c_str(),
+                         static_cast<uint64_t>(GetKey(plan)),
+                         kObjectFileExtension.c_str());
+  std::string digest = code_context.GetDigest();
+
+  std::string object;
+  if (Load(path, digest, object)) {
+    LOG_TRACE("Loaded object code from %s", path.c_str());
+    hit_count_++;
+    code_context.SetCachedObject(std::move(object));
+    return true;
+  }
+
+  miss_count_++;
+  code_context.SetObjectCallback(
+      [path, digest](const char *object, size_t size) {
+        Store(path, digest, object, size);
+      });
+  return false;
+}
+
+void ObjectCache::Clear() {
+  std::string directory = GetDirectory();
+  if (directory.empty()) {
+    return;
+  }
+
+  boost::system::error_code error;
+  boost::filesystem::directory_iterator itr(directory, error), end;
+  for (; !error && itr != end; itr.increment(error)) {
+    if (itr->path().extension() == kObjectFileExtension) {
+      boost::system::error_code remove_error;
+      boost::filesystem::remove(itr->path(), remove_error);
+    }
+  }
+}
+
+hash_t ObjectCache::GetKey(const planner::AbstractPlan &plan) {
+  return HashSchemas(plan, plan.Hash());
+}
+
+bool ObjectCache::Load(const std::string &path, const std::string &digest,
+                       std::string &object) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  // The file starts with the digest, the object code follows
+  bool success = false;
+  std::string file_digest(digest.size(), '\0');
+  if (fread(&file_digest[0], file_digest.size(), 1, file) == 1 &&
+      file_digest == digest && fseek(file, 0, SEEK_END) == 0) {
+    long size = ftell(file) - static_cast<long>(digest.size());
+    if (size > 0 && fseek(file, digest.size(), SEEK_SET) == 0) {
+      object.resize(static_cast<size_t>(size));
+      success = fread(&object[0], size, 1, file) == 1;
+    }
+  }
+  fclose(file);
+
+  if (!success) {
+    LOG_DEBUG("Object code in %s is stale or invalid", path.c_str());
+    object.clear();
+  }
+  return success;
+}
+
+void ObjectCache::Store(const std::string &path, const std::string &digest,
+                        const char *object, size_t size) {
+  // Write a temporary file first, so that concurrent readers, possibly in
+  // other processes, see either the old or the new file
+  boost::system::error_code error;
+  auto temp_path = boost::filesystem::unique_path(path + ".%%%%-%%%%", error);
+  if (error) {
+    return;
+  }
+
+  FILE *file = fopen(temp_path.c_str(), "wb");
+  if (file == nullptr) {
+    LOG_ERROR("Cannot create object code file %s", temp_path.c_str());
+    return;
+  }
+  bool success = fwrite(digest.data(), digest.size(), 1, file) == 1 &&
+                 fwrite(object, size, 1, file) == 1;
+  success = (fclose(file) == 0) && success;
+
+  if (success) {
+    boost::filesystem::rename(temp_path, path, error);
+    success = !error;
+  }
+  if (!success) {
+    LOG_ERROR("Cannot write object code file %s", path.c_str());
+    boost::filesystem::remove(temp_path, error);
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
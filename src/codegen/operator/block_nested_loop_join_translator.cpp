@@ -16,8 +16,12 @@
 #include "codegen/compilation_context.h"
 #include "codegen/function_builder.h"
 #include "codegen/lang/if.h"
+#include "codegen/operator/index_scan_translator.h"
 #include "codegen/operator/projection_translator.h"
 #include "codegen/proxy/buffer_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/vector.h"
+#include "planner/index_scan_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "settings/settings_manager.h"
 
@@ -52,20 +56,80 @@ namespace codegen {
 /// auxiliary function. This function implements the logic for the right-side
 /// query pipeline.
 ///
+/// When the right side is an index scan on the join columns, scanning all of S
+/// for every buffer is wasteful. Instead, every left tuple writes its join
+/// values into the scan key and is joined on its own:
+///
+/// function main():
+///   Buffer b
+///   for r in R:
+///     S.key := r.join_values
+///     b.insert(r)
+///     call joinBuffer(b)
+///     b.reset()
+///
+/// SEMI and ANTI joins produce each left tuple at most once, so they only mark
+/// the buffered tuples that find a partner. Once joinBuffer has seen all of S,
+/// it produces the marked tuples (SEMI) or the unmarked ones (ANTI). This
+/// happens at the end of the right pipeline, so that pipeline must be serial:
+///
+/// function joinBuffer(Buffer b):
+///   for s in S:
+///     for r in b:
+///       if pred(r, s):
+///         r.matched := true
+///   for r in b:
+///     if r.matched == (type == SEMI):
+///       emit(r)
+///
 ////////////////////////////////////////////////////////////////////////////////
 
 BlockNestedLoopJoinTranslator::BlockNestedLoopJoinTranslator(
     const planner::NestedLoopJoinPlan &nlj_plan, CompilationContext &context,
     Pipeline &pipeline)
     : OperatorTranslator(nlj_plan, context, pipeline),
-      left_pipeline_(this, Pipeline::Parallelism::Serial) {
+      left_pipeline_(this, Pipeline::Parallelism::Serial),
+      index_probe_(nullptr) {
   PELOTON_ASSERT(nlj_plan.GetChildrenSize() == 2 &&
                  "NLJ must have exactly two children");
 
+  // The left tuples of semi and anti joins are produced at the end of the
+  // right pipeline, which has to happen serially for every tuple to be
+  // produced exactly once
+  JoinType join_type = nlj_plan.GetJoinType();
+  track_left_matches_ =
+      join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+  if (track_left_matches_) {
+    pipeline.SetSerial();
+  }
+
   // Prepare children
   context.Prepare(*nlj_plan.GetChild(0), left_pipeline_);
   context.Prepare(*nlj_plan.GetChild(1), pipeline);
 
+  // If the right child is an index scan, try to probe it with the join values
+  // of each left tuple
+  const auto *right_child = nlj_plan.GetChild(1);
+  const auto &left_join_cols = nlj_plan.GetJoinColumnsLeft();
+  const auto &right_join_cols = nlj_plan.GetJoinColumnsRight();
+  if (right_child->GetPlanNodeType() == PlanNodeType::INDEXSCAN &&
+      !right_join_cols.empty() &&
+      left_join_cols.size() == right_join_cols.size()) {
+    // The join columns are positions in the output of the scan
+    const auto &scan_column_ids =
+        static_cast<const planner::IndexScanPlan &>(*right_child)
+            .GetColumnIds();
+    std::vector<oid_t> probe_column_ids;
+    for (auto col_idx : right_join_cols) {
+      probe_column_ids.push_back(scan_column_ids[col_idx]);
+    }
+    auto *translator =
+        static_cast<IndexScanTranslator *>(context.GetTranslator(*right_child));
+    if (translator->UseAsProbe(probe_column_ids)) {
+      index_probe_ = translator;
+    }
+  }
+
   // Prepare join predicate (if one exists)
   auto *predicate = nlj_plan.GetPredicate();
   if (predicate != nullptr) {
@@ -95,6 +159,10 @@ BlockNestedLoopJoinTranslator::BlockNestedLoopJoinTranslator(
   for (const auto *ai : unique_left_attributes_) {
     left_input_desc.push_back(ai->type);
   }
+  if (track_left_matches_) {
+    // Whether the tuple found a partner
+    left_input_desc.emplace_back(type::Boolean::Instance());
+  }
 
   // Allocate buffer instance in runtime state and configure its accessor
   CodeGen &codegen = GetCodeGen();
@@ -160,11 +228,27 @@ void BlockNestedLoopJoinTranslator::ConsumeFromLeft(
   for (const auto &left_ai : unique_left_attributes_) {
     tuple.push_back(row.DeriveValue(codegen, left_ai));
   }
+  if (track_left_matches_) {
+    tuple.emplace_back(type::Boolean::Instance(), codegen.ConstBool(false));
+  }
 
   // Append tuple to buffer
   auto *buffer_ptr = LoadStatePtr(buffer_id_);
   buffer_.Append(codegen, buffer_ptr, tuple);
 
+  if (index_probe_ != nullptr) {
+    // Probe the index with the join values of this tuple, then join it alone
+    const auto &plan = GetPlanAs<planner::NestedLoopJoinPlan>();
+    const auto &join_ais = plan.GetJoinAIsLeft();
+    for (uint32_t i = 0; i < join_ais.size(); i++) {
+      index_probe_->WriteProbeKey(codegen, i,
+                                  row.DeriveValue(codegen, join_ais[i]));
+    }
+    join_buffer_func_.Call(codegen);
+    buffer_.Reset(codegen, buffer_ptr);
+    return;
+  }
+
   // Check if we should process the filled buffer
   auto *buf_size = buffer_.NumTuples(codegen, buffer_ptr);
   auto *flush_buffer_cond =
@@ -195,6 +279,17 @@ void BlockNestedLoopJoinTranslator::Consume(ConsumerContext &ctx,
   }
 }
 
+void BlockNestedLoopJoinTranslator::ProduceRemaining(
+    ConsumerContext &ctx) const {
+  // The right pipeline finishes when joinBuffer has seen all of the right
+  // input, so this is where the buffered tuples of semi and anti joins are
+  // produced
+  if (IsFromLeftChild(ctx.GetPipeline()) || !track_left_matches_) {
+    return;
+  }
+  ProduceLeftTuples(ctx);
+}
+
 namespace {
 
 // This is the callback called for every tuple in the buffer. There's a bit of
@@ -205,19 +300,27 @@ class BufferedTupleCallback : public BufferAccessor::IterateCallback {
   BufferedTupleCallback(
       const planner::NestedLoopJoinPlan &plan,
       const std::vector<const planner::AttributeInfo *> &left_attributes,
-      ConsumerContext &ctx, RowBatch::Row &right_row);
+      const BufferAccessor &buffer, ConsumerContext &ctx,
+      RowBatch::Row &right_row);
 
   // The callback invoked for each tuple in the sorter/buffer
   void ProcessEntry(CodeGen &codegen,
-                    const std::vector<codegen::Value> &left_row) const override;
+                    const std::vector<codegen::Value> &left_row,
+                    llvm::Value *tuple_ptr) const override;
 
   void ProjectAndConsume() const;
 
+ private:
+  // Handle a buffered tuple that satisfies the join predicate
+  void ProcessMatch(CodeGen &codegen, llvm::Value *tuple_ptr) const;
+
  private:
   // The plan
   const planner::NestedLoopJoinPlan &plan_;
   // The attributes produced by the left child
   const std::vector<const planner::AttributeInfo *> &left_attributes_;
+  // The buffer holding the left tuples
+  const BufferAccessor &buffer_;
   // The consumer context
   ConsumerContext &ctx_;
   // The current "outer" row
@@ -227,16 +330,21 @@ class BufferedTupleCallback : public BufferAccessor::IterateCallback {
 BufferedTupleCallback::BufferedTupleCallback(
     const planner::NestedLoopJoinPlan &plan,
     const std::vector<const planner::AttributeInfo *> &left_attributes,
-    ConsumerContext &ctx, RowBatch::Row &right_row)
+    const BufferAccessor &buffer, ConsumerContext &ctx,
+    RowBatch::Row &right_row)
     : plan_(plan),
       left_attributes_(left_attributes),
+      buffer_(buffer),
       ctx_(ctx),
       right_row_(right_row) {}
 
 // This function is called for each tuple in the BNLJ buffer.
 void BufferedTupleCallback::ProcessEntry(
-    CodeGen &codegen, const std::vector<codegen::Value> &left_row) const {
-  PELOTON_ASSERT(left_row.size() == left_attributes_.size());
+    CodeGen &codegen, const std::vector<codegen::Value> &left_row,
+    llvm::Value *tuple_ptr) const {
+  // Semi and anti joins store a match flag after the attributes
+  PELOTON_ASSERT(left_row.size() == left_attributes_.size() ||
+                 left_row.size() == left_attributes_.size() + 1);
 
   // Add all the attributes from left tuple (from the sorter) into the row
   // coming from the right input side. We need to do this in order to evaluate
@@ -247,20 +355,35 @@ void BufferedTupleCallback::ProcessEntry(
 
   auto *predicate = plan_.GetPredicate();
   if (predicate == nullptr) {
-    // No predicate, just apply projection and finish
-    ProjectAndConsume();
+    // No predicate, every pair matches
+    ProcessMatch(codegen, tuple_ptr);
   } else {
     // Check predicate before sending to parent
     const auto &valid = right_row_.DeriveValue(codegen, *predicate);
     lang::If valid_match(codegen, valid);
     {
       // Valid tuple
-      ProjectAndConsume();
+      ProcessMatch(codegen, tuple_ptr);
     }
     valid_match.EndIf();
   }
 }
 
+void BufferedTupleCallback::ProcessMatch(CodeGen &codegen,
+                                         llvm::Value *tuple_ptr) const {
+  JoinType join_type = plan_.GetJoinType();
+  if (join_type != JoinType::SEMI && join_type != JoinType::ANTI) {
+    // Apply projection and finish
+    ProjectAndConsume();
+    return;
+  }
+
+  // Semi and anti joins only remember that the left tuple found a partner
+  buffer_.SetValue(
+      codegen, tuple_ptr, static_cast<uint32_t>(left_attributes_.size()),
+      codegen::Value{type::Boolean::Instance(), codegen.ConstBool(true)});
+}
+
 void BufferedTupleCallback::ProjectAndConsume() const {
   const auto *projection_info = plan_.GetProjInfo();
   std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
@@ -273,12 +396,87 @@ void BufferedTupleCallback::ProjectAndConsume() const {
   ctx_.Consume(right_row_);
 }
 
+// This is the callback called for every tuple in the buffer of a semi or anti
+// join after all the right tuples have been seen. It produces the tuple if it
+// found a partner (for semi joins) or if it didn't (for anti joins).
+class LeftTupleCallback : public BufferAccessor::IterateCallback {
+ public:
+  // Constructor
+  LeftTupleCallback(
+      const planner::NestedLoopJoinPlan &plan,
+      const std::vector<const planner::AttributeInfo *> &left_attributes,
+      ConsumerContext &ctx)
+      : plan_(plan), left_attributes_(left_attributes), ctx_(ctx) {}
+
+  // The callback invoked for each tuple in the buffer
+  void ProcessEntry(CodeGen &codegen,
+                    const std::vector<codegen::Value> &left_row,
+                    llvm::Value *tuple_ptr) const override;
+
+ private:
+  // The plan
+  const planner::NestedLoopJoinPlan &plan_;
+  // The attributes produced by the left child
+  const std::vector<const planner::AttributeInfo *> &left_attributes_;
+  // The consumer context of the right pipeline
+  ConsumerContext &ctx_;
+};
+
+void LeftTupleCallback::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &left_row,
+    UNUSED_ATTRIBUTE llvm::Value *tuple_ptr) const {
+  PELOTON_ASSERT(left_row.size() == left_attributes_.size() + 1);
+
+  // The match flag is stored after the attributes
+  llvm::Value *produce = left_row.back().GetValue();
+  if (plan_.GetJoinType() != JoinType::SEMI) {
+    produce = codegen->CreateNot(produce);
+  }
+
+  lang::If should_produce{codegen, produce};
+  {
+    // Create a batch of one row for the tuple
+    Vector v{nullptr, 1, nullptr};
+    RowBatch one{ctx_.GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), v, false};
+    RowBatch::Row row{one, nullptr, nullptr};
+
+    // The left values come from the buffer, the right values are NULL
+    for (size_t i = 0; i < left_attributes_.size(); i++) {
+      row.RegisterAttributeValue(left_attributes_[i], left_row[i]);
+    }
+    for (const auto *ai : plan_.GetRightAttributes()) {
+      row.RegisterAttributeValue(ai,
+                                 ai->type.GetSqlType().GetNullValue(codegen));
+    }
+
+    const auto *projection_info = plan_.GetProjInfo();
+    std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
+    if (projection_info != nullptr) {
+      ProjectionTranslator::AddNonTrivialAttributes(
+          one, *projection_info, derived_attribute_access);
+    }
+
+    // Send the row up to the parent
+    ctx_.Consume(row);
+  }
+  should_produce.EndIf();
+}
+
 }  // anonymous namespace
 
 void BlockNestedLoopJoinTranslator::FindMatchesForRow(
     ConsumerContext &ctx, RowBatch::Row &row) const {
   const auto &plan = GetPlanAs<planner::NestedLoopJoinPlan>();
-  BufferedTupleCallback callback{plan, unique_left_attributes_, ctx, row};
+  BufferedTupleCallback callback{plan, unique_left_attributes_, buffer_, ctx,
+                                 row};
+  buffer_.Iterate(GetCodeGen(), LoadStatePtr(buffer_id_), callback);
+}
+
+void BlockNestedLoopJoinTranslator::ProduceLeftTuples(
+    ConsumerContext &ctx) const {
+  const auto &plan = GetPlanAs<planner::NestedLoopJoinPlan>();
+  LeftTupleCallback callback{plan, unique_left_attributes_, ctx};
   buffer_.Iterate(GetCodeGen(), LoadStatePtr(buffer_id_), callback);
 }
 
@@ -13,6 +13,7 @@
 #include "codegen/operator/global_group_by_translator.h"
 
 #include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
 #include "common/logger.h"
 #include "planner/aggregate_plan.h"
 
@@ -23,7 +24,10 @@ GlobalGroupByTranslator::GlobalGroupByTranslator(
     const planner::AggregatePlan &plan, CompilationContext &context,
     Pipeline &pipeline)
     : OperatorTranslator(plan, context, pipeline),
-      child_pipeline_(this, Pipeline::Parallelism::Serial),
+      child_pipeline_(this,
+                      Aggregation::CanMergeValues(plan.GetUniqueAggTerms())
+                          ? Pipeline::Parallelism::Flexible
+                          : Pipeline::Parallelism::Serial),
       aggregation_(context.GetQueryState()) {
   LOG_DEBUG("Constructing GlobalGroupByTranslator ...");
 
@@ -47,14 +51,14 @@ GlobalGroupByTranslator::GlobalGroupByTranslator(
   auto *aggregate_storage = aggregation_.GetAggregateStorage().GetStorageType();
   PELOTON_ASSERT(aggregate_storage->isStructTy());
 
-  auto *mat_buffer_type = llvm::StructType::create(
+  mat_buffer_type_ = llvm::StructType::create(
       codegen.GetContext(),
       llvm::cast<llvm::StructType>(aggregate_storage)->elements(), "Buffer",
       true);
 
   // Allocate state in the function argument for our materialization buffer
   QueryState &query_state = context.GetQueryState();
-  mat_buffer_id_ = query_state.RegisterState("buf", mat_buffer_type);
+  mat_buffer_id_ = query_state.RegisterState("buf", mat_buffer_type_);
 
   LOG_DEBUG("Finished constructing GlobalGroupByTranslator ...");
 }
@@ -109,7 +113,7 @@ void GlobalGroupByTranslator::Produce() const {
   GetPipeline().RunSerial(producer);
 }
 
-void GlobalGroupByTranslator::Consume(ConsumerContext &,
+void GlobalGroupByTranslator::Consume(ConsumerContext &ctx,
                                       RowBatch::Row &row) const {
   // Get the updates to advance the aggregates
   const auto &plan = GetPlanAs<planner::AggregatePlan>();
@@ -123,9 +127,56 @@ void GlobalGroupByTranslator::Consume(ConsumerContext &,
     }
   }
 
+  // When running in parallel, each thread aggregates into its own buffer
+  llvm::Value *mat_buffer = nullptr;
+  if (ctx.GetPipeline().IsParallel()) {
+    mat_buffer =
+        ctx.GetPipelineContext()->LoadStatePtr(GetCodeGen(), mat_buffer_tl_id_);
+  } else {
+    mat_buffer = LoadStatePtr(mat_buffer_id_);
+  }
+
   // Just advance each of the aggregates in the buffer with the provided
   // new values
-  aggregation_.AdvanceValues(GetCodeGen(), LoadStatePtr(mat_buffer_id_), vals);
+  aggregation_.AdvanceValues(GetCodeGen(), mat_buffer, vals);
+}
+
+void GlobalGroupByTranslator::RegisterPipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    mat_buffer_tl_id_ =
+        pipeline_ctx.RegisterState("localBuf", mat_buffer_type_);
+  }
+}
+
+void GlobalGroupByTranslator::InitializePipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    CodeGen &codegen = GetCodeGen();
+    aggregation_.CreateInitialGlobalValues(
+        codegen, pipeline_ctx.LoadStatePtr(codegen, mat_buffer_tl_id_));
+  }
+}
+
+void GlobalGroupByTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    // Merge the partial aggregates of each thread into the global buffer
+    PipelineContext::LoopOverStates loop_states{pipeline_ctx};
+    loop_states.Do([this, &pipeline_ctx](llvm::Value *thread_state) {
+      CodeGen &codegen = GetCodeGen();
+      PipelineContext::SetState state_access(pipeline_ctx, thread_state);
+      lang::If initialized{codegen, pipeline_ctx.LoadFlag(codegen)};
+      {
+        aggregation_.MergeValues(
+            codegen, LoadStatePtr(mat_buffer_id_),
+            pipeline_ctx.LoadStatePtr(codegen, mat_buffer_tl_id_));
+      }
+      initialized.EndIf();
+    });
+  }
 }
 
 // Cleanup by destroying the aggregation hash-table
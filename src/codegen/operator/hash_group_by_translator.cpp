@@ -13,7 +13,9 @@
 #include "codegen/operator/hash_group_by_translator.h"
 
 #include "codegen/compilation_context.h"
+#include "codegen/function_builder.h"
 #include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
 #include "codegen/operator/projection_translator.h"
 #include "codegen/lang/vectorized_loop.h"
@@ -33,8 +35,17 @@ HashGroupByTranslator::HashGroupByTranslator(
     const planner::AggregatePlan &group_by, CompilationContext &context,
     Pipeline &pipeline)
     : OperatorTranslator(group_by, context, pipeline),
-      child_pipeline_(this, Pipeline::Parallelism::Serial),
+      child_pipeline_(this, Pipeline::Parallelism::Flexible),
+      merge_func_(nullptr),
       aggregation_(context.GetQueryState()) {
+  // Threads can only aggregate into their own hash tables if the partial
+  // aggregates can be merged. Prefetching aggregations always run serially.
+  mergeable_ = Aggregation::CanMergeValues(group_by.GetUniqueAggTerms()) &&
+               !UsePrefetching();
+  if (!mergeable_) {
+    child_pipeline_.SetSerial();
+  }
+
   // If we should be prefetching into the hash-table, install a boundary in the
   // pipeline at the input into this translator to ensure it receives a vector
   // of input tuples
@@ -48,6 +59,15 @@ HashGroupByTranslator::HashGroupByTranslator(
   hash_table_id_ =
       query_state.RegisterState("groupBy", OAHashTableProxy::GetType(codegen));
 
+  // Register the partitioned hash-tables that thread-local hash tables are
+  // merged into
+  if (mergeable_) {
+    partitions_id_ = query_state.RegisterState(
+        "groupByParts",
+        llvm::ArrayType::get(OAHashTableProxy::GetType(codegen),
+                             util::OAHashTable::kNumMergePartitions));
+  }
+
   // Prepare the input operator to this group by
   context.Prepare(*group_by.GetChild(0), child_pipeline_);
 
@@ -89,10 +109,81 @@ HashGroupByTranslator::HashGroupByTranslator(
 
 // Initialize the hash table instance
 void HashGroupByTranslator::InitializeQueryState() {
-  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  CodeGen &codegen = GetCodeGen();
+  llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+  hash_table_.Init(codegen, hash_table);
+  if (mergeable_) {
+    // Spilled groups are merged back with the merge function
+    hash_table_.EnableSpilling(codegen, hash_table, GetExecutorContextPtr(),
+                               hash_table);
+    hash_table_.InitPartitions(codegen, LoadStatePtr(partitions_id_));
+  }
   aggregation_.InitializeQueryState(GetCodeGen());
 }
 
+// Define the function that merges a list of entries of a thread-local hash
+// table into a partitioned hash-table. Groups found in the partition merge
+// their partial aggregates, new groups are copied over.
+void HashGroupByTranslator::DefineAuxiliaryFunctions() {
+  if (!mergeable_) {
+    return;
+  }
+
+  CodeGen &codegen = GetCodeGen();
+  QueryState &query_state = GetCompilationContext().GetQueryState();
+
+  auto *entry_type = OAHashEntryProxy::GetType(codegen);
+  std::vector<FunctionDeclaration::ArgumentInfo> args = {
+      {"queryState", query_state.GetType()->getPointerTo()},
+      {"partition", OAHashTableProxy::GetType(codegen)->getPointerTo()},
+      {"entries", entry_type->getPointerTo()->getPointerTo()},
+      {"numEntries", codegen.Int64Type()}};
+  FunctionBuilder merge(codegen.GetCodeContext(), "mergeGroups",
+                        codegen.VoidType(), args);
+  {
+    llvm::Value *partition = merge.GetArgumentByPosition(1);
+    llvm::Value *entries = merge.GetArgumentByPosition(2);
+    llvm::Value *num_entries = merge.GetArgumentByPosition(3);
+
+    auto *storage_type = aggregation_.GetAggregateStorage().GetStorageType();
+
+    llvm::Value *pos = codegen.Const64(0);
+    lang::Loop entry_loop{
+        codegen, codegen->CreateICmpULT(pos, num_entries), {{"pos", pos}}};
+    {
+      pos = entry_loop.GetLoopVar(0);
+      llvm::Value *entry =
+          codegen->CreateLoad(codegen->CreateInBoundsGEP(entries, {pos}));
+
+      // Probe the partition with the (already hashed) key of the entry
+      llvm::Value *hash = nullptr;
+      std::vector<codegen::Value> key;
+      llvm::Value *values = hash_table_.LoadEntry(codegen, entry, hash, key);
+      auto probe = hash_table_.ProbeOrInsert(codegen, partition, hash, key);
+
+      lang::If key_exists{codegen, probe.key_exists};
+      {
+        aggregation_.MergeValues(codegen, probe.data_ptr, values);
+      }
+      key_exists.ElseBlock();
+      {
+        auto *src = codegen->CreatePointerCast(values,
+                                               storage_type->getPointerTo());
+        auto *dst = codegen->CreatePointerCast(probe.data_ptr,
+                                               storage_type->getPointerTo());
+        codegen->CreateStore(codegen->CreateLoad(src), dst);
+      }
+      key_exists.EndIf();
+
+      pos = codegen->CreateAdd(pos, codegen.Const64(1));
+      entry_loop.LoopEnd(codegen->CreateICmpULT(pos, num_entries), {pos});
+    }
+
+    merge.ReturnAndFinish();
+  }
+  merge_func_ = merge.GetFunction();
+}
+
 // Produce!
 void HashGroupByTranslator::Produce() const {
   // Let the left child produce its tuples which we aggregate in our hash-table
@@ -111,8 +202,55 @@ void HashGroupByTranslator::Produce() const {
     // Iterate
     const auto &plan = GetPlanAs<planner::AggregatePlan>();
     ProduceResults produce_results{ctx, plan, aggregation_};
-    hash_table_.VectorizedIterate(codegen, LoadStatePtr(hash_table_id_),
-                                  selection_vec, produce_results);
+    llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+    if (!mergeable_) {
+      hash_table_.VectorizedIterate(codegen, hash_table, selection_vec,
+                                    produce_results);
+      return;
+    }
+
+    // The groups are in the hash table, or in the partitioned hash-tables if
+    // they were merged in parallel. Afterwards, the groups that spilled to
+    // disk are loaded into the hash table one partition at a time. The tables
+    // are iterated in a single loop, as the groups can only be produced once.
+    bool parallel = child_pipeline_.IsParallel();
+    llvm::Value *partitions = parallel ? LoadStatePtr(partitions_id_) : nullptr;
+    llvm::Value *num_tables = codegen.Const32(
+        parallel ? util::OAHashTable::kNumMergePartitions : 1);
+    llvm::Value *idx = codegen.Const32(0);
+    lang::Loop table_loop{codegen, codegen.ConstBool(true), {{"idx", idx}}};
+    {
+      idx = table_loop.GetLoopVar(0);
+      llvm::Value *table = hash_table;
+      if (parallel) {
+        llvm::Value *partition = nullptr;
+        lang::If is_partition{codegen, codegen->CreateICmpULT(idx, num_tables)};
+        {
+          partition = codegen->CreateInBoundsGEP(partitions,
+                                                 {codegen.Const32(0), idx});
+        }
+        is_partition.EndIf();
+        table = is_partition.BuildPHI(partition, hash_table);
+      }
+      hash_table_.VectorizedIterate(codegen, table, selection_vec,
+                                    produce_results);
+
+      // Move to the next table, loading the next spilled partition if all
+      // in-memory tables were produced
+      idx = codegen->CreateAdd(idx, codegen.Const32(1));
+      llvm::Value *more = nullptr;
+      lang::If in_memory{codegen, codegen->CreateICmpULT(idx, num_tables)};
+      {
+        more = codegen.ConstBool(true);
+      }
+      in_memory.ElseBlock();
+      llvm::Value *spilled =
+          hash_table_.NextSpilledPartition(codegen, hash_table, merge_func_);
+      in_memory.EndIf();
+      more = in_memory.BuildPHI(more, spilled);
+
+      table_loop.LoopEnd(more, {idx});
+    }
   };
 
   GetPipeline().RunSerial(producer);
@@ -205,7 +343,7 @@ void HashGroupByTranslator::Consume(ConsumerContext &context,
 }
 
 // Consume the tuples from the context, grouping them into the hash table
-void HashGroupByTranslator::Consume(ConsumerContext &,
+void HashGroupByTranslator::Consume(ConsumerContext &context,
                                     RowBatch::Row &row) const {
   CodeGen &codegen = GetCodeGen();
 
@@ -230,16 +368,77 @@ void HashGroupByTranslator::Consume(ConsumerContext &,
     hash = hash_val.GetValue();
   }
 
+  // When running in parallel, each thread aggregates into its own hash table
+  llvm::Value *hash_table = nullptr;
+  if (context.GetPipeline().IsParallel()) {
+    hash_table = context.GetPipelineContext()->LoadStatePtr(codegen,
+                                                            hash_table_tl_id_);
+  } else {
+    hash_table = LoadStatePtr(hash_table_id_);
+  }
+
   // Perform the insertion into the hash table
-  llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
   ConsumerProbe probe{GetCompilationContext(), aggregation_, vals, key};
   ConsumerInsert insert{aggregation_, vals, key};
   hash_table_.ProbeOrInsert(codegen, hash_table, hash, key, probe, insert);
 }
 
+void HashGroupByTranslator::RegisterPipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    hash_table_tl_id_ = pipeline_ctx.RegisterState(
+        "localHT", OAHashTableProxy::GetType(GetCodeGen()));
+  }
+}
+
+void HashGroupByTranslator::InitializePipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    CodeGen &codegen = GetCodeGen();
+    llvm::Value *local_table =
+        pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
+    hash_table_.Init(codegen, local_table);
+    hash_table_.EnableSpilling(codegen, local_table, GetExecutorContextPtr(),
+                               LoadStatePtr(hash_table_id_));
+  }
+}
+
+void HashGroupByTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
+  if (mergeable_ && !pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    // If the hash table spilled, the groups it holds must spill too
+    hash_table_.FlushSpilled(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  }
+
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    // Radix-partition the thread-local tables and merge each partition into
+    // its own hash-table, in parallel
+    CodeGen &codegen = GetCodeGen();
+    hash_table_.MergePartitioned(
+        codegen, LoadStatePtr(partitions_id_), GetThreadStatesPtr(),
+        pipeline_ctx.GetEntryOffset(codegen, hash_table_tl_id_), merge_func_);
+  }
+}
+
+void HashGroupByTranslator::TearDownPipelineState(
+    PipelineContext &pipeline_ctx) {
+  if (pipeline_ctx.IsParallel() &&
+      IsChildPipeline(pipeline_ctx.GetPipeline())) {
+    CodeGen &codegen = GetCodeGen();
+    hash_table_.Destroy(codegen,
+                        pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_));
+  }
+}
+
 // Cleanup by destroying the aggregation hash-table
 void HashGroupByTranslator::TearDownQueryState() {
   hash_table_.Destroy(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  if (mergeable_) {
+    hash_table_.DestroyPartitions(GetCodeGen(), LoadStatePtr(partitions_id_));
+  }
   aggregation_.TearDownQueryState(GetCodeGen());
 }
 
@@ -14,9 +14,11 @@
 
 #include "codegen/expression/tuple_value_translator.h"
 #include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/proxy/bloom_filter_proxy.h"
 #include "codegen/proxy/hash_table_proxy.h"
+#include "codegen/type/sql_type.h"
 #include "expression/tuple_value_expression.h"
 #include "planner/hash_join_plan.h"
 
@@ -25,6 +27,56 @@ namespace codegen {
 
 std::atomic<bool> HashJoinTranslator::kUsePrefetch{false};
 
+namespace {
+
+// Does producing the given plan again yield the same tuples?
+bool IsRescannable(const planner::AbstractPlan &plan) {
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::PROJECTION:
+      break;
+    default:
+      return false;
+  }
+  for (size_t i = 0; i < plan.GetChildrenSize(); i++) {
+    if (!IsRescannable(*plan.GetChild(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Can the consumers of the join produce the probe pipeline once per pass over
+// a spilled hash table? Every pass runs the whole pipeline again, so the rows
+// must reach the query output only through operators that keep no state
+// across the rows of the pipeline.
+bool ConsumesEveryPass(const CompilationContext &context,
+                       const Pipeline &pipeline,
+                       const OperatorTranslator *join_translator) {
+  if (!context.IsLastPipeline(pipeline)) {
+    return false;
+  }
+  for (const auto *consumer : pipeline.GetConsumers(join_translator)) {
+    const auto &plan = consumer->GetPlan();
+    switch (plan.GetPlanNodeType()) {
+      case PlanNodeType::PROJECTION:
+        break;
+      case PlanNodeType::HASHJOIN:
+        // Only an inner join probes without producing rows at the end
+        if (static_cast<const planner::HashJoinPlan &>(plan).GetJoinType() !=
+            JoinType::INNER) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 /**
  * The callback used when we probe the hash table with right-side tuples during
  * the probe phase of the join.
@@ -38,10 +90,13 @@ class HashJoinTranslator::ProbeRight : public HashTable::IterateCallback {
    * @param context The context reference
    * @param row A reference to the row from the right side of the join
    * @param right_key A reference to the key from the right side of the join
+   * @param probe_matched Where to record that the row found a join partner,
+   *                      if the join tracks matches of right-side rows
    */
   ProbeRight(const HashJoinTranslator &join_translator,
              ConsumerContext &context, RowBatch::Row &row,
-             const std::vector<codegen::Value> &right_key);
+             const std::vector<codegen::Value> &right_key,
+             llvm::Value *probe_matched);
 
   /**
    * The callback function called to process each matching tuple found in the
@@ -55,6 +110,10 @@ class HashJoinTranslator::ProbeRight : public HashTable::IterateCallback {
   void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
                     llvm::Value *data_area) const override;
 
+ private:
+  // Handle a join partner that satisfies the join predicate
+  void ProcessMatch(CodeGen &codegen, llvm::Value *data_area) const;
+
  private:
   // The translator (we need lots of its state)
   const HashJoinTranslator &join_translator_;
@@ -65,6 +124,52 @@ class HashJoinTranslator::ProbeRight : public HashTable::IterateCallback {
 
   // The value of the key used during the probe
   const std::vector<codegen::Value> &right_key_;
+
+  // The flag recording whether the row found a join partner, if tracked
+  llvm::Value *probe_matched_;
+};
+
+/**
+ * The callback used when iterating over the hash table after the probe to
+ * produce the build-side tuples of outer, semi and anti joins.
+ */
+class HashJoinTranslator::ProduceLeft : public HashTable::IterateCallback {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param join_translator The translator reference
+   * @param context The context of the probe-side pipeline
+   * @param probe_nonempty Whether the probe side produced any tuples, if the
+   *                       join is a NULL-aware anti join
+   */
+  ProduceLeft(const HashJoinTranslator &join_translator,
+              ConsumerContext &context, llvm::Value *probe_nonempty)
+      : join_translator_(join_translator),
+        context_(context),
+        probe_nonempty_(probe_nonempty) {}
+
+  /**
+   * The callback function called for every tuple in the hash table. Produces
+   * the tuple if it found a join partner (for semi joins) or if it didn't (for
+   * all other joins).
+   *
+   * @param codegen The codegen instance
+   * @param key The key stored in the table
+   * @param data_area Memory space where the value is stored
+   */
+  void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                    llvm::Value *data_area) const override;
+
+ private:
+  // The translator (we need lots of its state)
+  const HashJoinTranslator &join_translator_;
+
+  // The context of the probe-side pipeline
+  ConsumerContext &context_;
+
+  // Whether the probe side produced any tuples
+  llvm::Value *probe_nonempty_;
 };
 
 /**
@@ -121,10 +226,28 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
                                        CompilationContext &context,
                                        Pipeline &pipeline)
     : OperatorTranslator(join, context, pipeline),
-      left_pipeline_(this, Pipeline::Parallelism::Flexible) {
+      // The bloom filter is shared by all threads and isn't updated atomically,
+      // so the build side can only run in parallel without it
+      left_pipeline_(this, join.IsBloomFilterEnabled()
+                               ? Pipeline::Parallelism::Serial
+                               : Pipeline::Parallelism::Flexible) {
   CodeGen &codegen = GetCodeGen();
   QueryState &query_state = context.GetQueryState();
 
+  // Determine which side's tuples must be produced even without a partner
+  JoinType join_type = join.GetJoinType();
+  track_left_matches_ =
+      join_type == JoinType::LEFT || join_type == JoinType::OUTER ||
+      join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+  track_right_matches_ =
+      join_type == JoinType::RIGHT || join_type == JoinType::OUTER;
+
+  // The build-side tuples are produced at the end of the probe, which has to
+  // happen serially for every tuple to be produced exactly once
+  if (track_left_matches_) {
+    pipeline.SetSerial();
+  }
+
   // If we should be prefetching into the hash-table, install a boundary in the
   // both the left and right pipeline at the input into this translator to
   // ensure it receives a vector of input tuples
@@ -141,6 +264,13 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
     bloom_filter_id_ = query_state.RegisterState(
         "bloomfilter", BloomFilterProxy::GetType(codegen));
   }
+  if (join.IsNullAware()) {
+    PELOTON_ASSERT(join_type == JoinType::ANTI);
+    probe_nonempty_id_ =
+        query_state.RegisterState("probeNonEmpty", codegen.BoolType());
+    probe_has_null_id_ =
+        query_state.RegisterState("probeHasNull", codegen.BoolType());
+  }
 
   // Prepare translators for the left and right input operators
   context.Prepare(*join.GetChild(0), left_pipeline_);
@@ -212,19 +342,37 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   }
   needs_output_vector_ = false;
 
+  // Only an inner join produces the matches of every pass independently, and
+  // only if nothing above it aggregates or materializes the probe pipeline
+  spillable_ = join.GetJoinType() == JoinType::INNER &&
+               IsRescannable(*join.GetChild(1)->GetChild(0)) &&
+               ConsumesEveryPass(context, pipeline, this);
+
   // Create the hash table
-  hash_table_ =
-      HashTable{codegen, left_key_type, left_value_storage_.MaxStorageSize()};
+  hash_table_ = HashTable{codegen, left_key_type,
+                          left_value_storage_.MaxStorageSize(),
+                          track_left_matches_};
 }
 
 // Initialize the hash-table instance
 void HashJoinTranslator::InitializeQueryState() {
-  hash_table_.Init(GetCodeGen(), GetExecutorContextPtr(),
-                   LoadStatePtr(hash_table_id_));
+  llvm::Value *ht_ptr = LoadStatePtr(hash_table_id_);
+  hash_table_.Init(GetCodeGen(), GetExecutorContextPtr(), ht_ptr);
+  if (spillable_) {
+    hash_table_.EnableSpilling(GetCodeGen(), ht_ptr, GetExecutorContextPtr(),
+                               ht_ptr);
+  }
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_.Init(GetCodeGen(), LoadStatePtr(bloom_filter_id_),
                        EstimateCardinalityLeft());
   }
+  if (GetJoinPlan().IsNullAware()) {
+    CodeGen &codegen = GetCodeGen();
+    codegen->CreateStore(codegen.ConstBool(false),
+                         LoadStatePtr(probe_nonempty_id_));
+    codegen->CreateStore(codegen.ConstBool(false),
+                         LoadStatePtr(probe_has_null_id_));
+  }
 }
 
 // Produce!
@@ -233,7 +381,22 @@ void HashJoinTranslator::Produce() const {
   GetCompilationContext().Produce(*GetJoinPlan().GetChild(0));
 
   // Let the right child produce tuples, which we use to probe the hash table
-  GetCompilationContext().Produce(*GetJoinPlan().GetChild(1)->GetChild(0));
+  const auto &right = *GetJoinPlan().GetChild(1)->GetChild(0);
+  if (!spillable_) {
+    GetCompilationContext().Produce(right);
+    return;
+  }
+
+  // If the hash table spilled, it holds a part of the left side only. The
+  // right side is then produced again for every pass over the hash table.
+  CodeGen &codegen = GetCodeGen();
+  lang::Loop pass_loop{codegen, codegen.ConstBool(true), {}};
+  {
+    GetCompilationContext().Produce(right);
+    llvm::Value *next_pass =
+        hash_table_.NextPass(codegen, LoadStatePtr(hash_table_id_));
+    pass_loop.LoopEnd(next_pass, {});
+  }
 
   // That's it, we've produced all the tuples
 }
@@ -391,8 +554,14 @@ void HashJoinTranslator::InitializePipelineState(
     PipelineContext &pipeline_ctx) {
   if (pipeline_ctx.IsParallel() && IsLeftPipeline(pipeline_ctx.GetPipeline())) {
     CodeGen &codegen = GetCodeGen();
-    hash_table_.Init(codegen, GetExecutorContextPtr(),
-                     pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_));
+    llvm::Value *local_ht_ptr =
+        pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
+    hash_table_.Init(codegen, GetExecutorContextPtr(), local_ht_ptr);
+    if (spillable_) {
+      hash_table_.EnableSpilling(codegen, local_ht_ptr,
+                                 GetExecutorContextPtr(),
+                                 LoadStatePtr(hash_table_id_));
+    }
   }
 }
 
@@ -404,20 +573,11 @@ void HashJoinTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
       // Build the hash table over the lazily inserted tuples
       hash_table_.BuildLazy(codegen, global_ht_ptr);
     } else {
-      // First size the global hash table
-      hash_table_.ReserveLazy(
+      // Radix-partition the local tables and build the global table one
+      // partition at a time, in parallel
+      hash_table_.BuildLazyPartitioned(
           codegen, global_ht_ptr, GetThreadStatesPtr(),
           pipeline_ctx.GetEntryOffset(codegen, hash_table_tl_id_));
-
-      // Then merge each local table in parallel
-      PipelineContext::LoopOverStates loop_states{pipeline_ctx};
-      loop_states.DoParallel([this, &pipeline_ctx, &codegen](
-          UNUSED_ATTRIBUTE llvm::Value *thread_state) {
-        llvm::Value *global_ht_ptr = LoadStatePtr(hash_table_id_);
-        llvm::Value *local_ht_ptr =
-            pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
-        hash_table_.MergeLazyUnfinished(codegen, global_ht_ptr, local_ht_ptr);
-      });
     }
   }
 }
@@ -433,37 +593,101 @@ void HashJoinTranslator::TearDownPipelineState(PipelineContext &pipeline_ctx) {
 // The given row is from the right child. Probe hash-table.
 void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
                                           RowBatch::Row &row) const {
+  CodeGen &codegen = GetCodeGen();
+
   // Pull out the values of the keys we probe the hash-table with
   std::vector<codegen::Value> key;
   CollectKeys(row, right_key_exprs_, key);
 
+  if (GetJoinPlan().IsNullAware()) {
+    // Record that the probe side isn't empty, and whether it has a NULL key
+    codegen->CreateStore(codegen.ConstBool(true),
+                         LoadStatePtr(probe_nonempty_id_));
+    llvm::Value *has_null_ptr = LoadStatePtr(probe_has_null_id_);
+    llvm::Value *has_null = codegen->CreateLoad(has_null_ptr);
+    for (const auto &key_val : key) {
+      has_null = codegen->CreateOr(has_null, key_val.IsNull(codegen));
+    }
+    codegen->CreateStore(has_null, has_null_ptr);
+  }
+
+  // The probe places the build-side values of every partner into the row, so
+  // keep a copy of the row (and our position in the pipeline) to produce the
+  // row on its own if it doesn't find any partner
+  RowBatch::Row unmatched_row = row;
+  uint32_t position = GetPipeline().GetPosition();
+
+  llvm::Value *probe_matched = nullptr;
+  if (track_right_matches_) {
+    probe_matched = codegen.AllocateVariable(codegen.BoolType(), "matched");
+    codegen->CreateStore(codegen.ConstBool(false), probe_matched);
+  }
+
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     // Prefilter the tuple using Bloom Filter
-    llvm::Value *contains = bloom_filter_.Contains(
-        GetCodeGen(), LoadStatePtr(bloom_filter_id_), key);
+    llvm::Value *contains =
+        bloom_filter_.Contains(codegen, LoadStatePtr(bloom_filter_id_), key);
 
-    lang::If is_valid_row{GetCodeGen(), contains};
+    lang::If is_valid_row{codegen, contains};
     {
       // For each tuple that passes the bloom filter, probe the hash table
       // to eliminate the false positives.
-      CodegenHashProbe(context, row, key);
+      CodegenHashProbe(context, row, key, probe_matched);
     }
     is_valid_row.EndIf();
   } else {
     // Bloom filter is not enabled. Directly probe the hash table
-    CodegenHashProbe(context, row, key);
+    CodegenHashProbe(context, row, key, probe_matched);
+  }
+
+  if (track_right_matches_) {
+    llvm::Value *matched = codegen->CreateLoad(probe_matched);
+    lang::If no_partner{codegen, codegen->CreateNot(matched)};
+    {
+      // Produce the row with NULLs for all the build-side attributes
+      GetPipeline().SetPosition(position);
+      RegisterNullLeftValues(codegen, unmatched_row);
+      context.Consume(unmatched_row);
+    }
+    no_partner.EndIf();
   }
 }
 
-void HashJoinTranslator::CodegenHashProbe(
-    ConsumerContext &context, RowBatch::Row &row,
-    std::vector<codegen::Value> &key) const {
-  if (GetJoinPlan().GetJoinType() == JoinType::INNER) {
-    // For inner joins, find all join partners
-    ProbeRight probe_right{*this, context, row, key};
-    hash_table_.FindAll(GetCodeGen(), LoadStatePtr(hash_table_id_), key,
-                        probe_right);
+void HashJoinTranslator::CodegenHashProbe(ConsumerContext &context,
+                                          RowBatch::Row &row,
+                                          std::vector<codegen::Value> &key,
+                                          llvm::Value *probe_matched) const {
+  // Find all join partners
+  ProbeRight probe_right{*this, context, row, key, probe_matched};
+  hash_table_.FindAll(GetCodeGen(), LoadStatePtr(hash_table_id_), key,
+                      probe_right);
+}
+
+void HashJoinTranslator::ProduceRemaining(ConsumerContext &context) const {
+  if (IsFromLeftChild(context) || !track_left_matches_) {
+    return;
+  }
+
+  CodeGen &codegen = GetCodeGen();
+  llvm::Value *ht_ptr = LoadStatePtr(hash_table_id_);
+
+  if (!GetJoinPlan().IsNullAware()) {
+    ProduceLeft produce_left{*this, context, nullptr};
+    hash_table_.Iterate(codegen, ht_ptr, produce_left);
+    return;
+  }
+
+  // Nothing is NOT IN a set containing NULL
+  llvm::Value *probe_has_null =
+      codegen->CreateLoad(LoadStatePtr(probe_has_null_id_));
+  lang::If no_null{codegen, codegen->CreateNot(probe_has_null)};
+  {
+    llvm::Value *probe_nonempty =
+        codegen->CreateLoad(LoadStatePtr(probe_nonempty_id_));
+    ProduceLeft produce_left{*this, context, probe_nonempty};
+    hash_table_.Iterate(codegen, ht_ptr, produce_left);
   }
+  no_null.EndIf();
 }
 
 // Cleanup by destroying the hash-table instance
@@ -512,6 +736,43 @@ void HashJoinTranslator::CollectValues(
   }
 }
 
+void HashJoinTranslator::RegisterLeftValues(
+    CodeGen &codegen, RowBatch::Row &row,
+    const std::vector<codegen::Value> &key, llvm::Value *data_area) const {
+  // Load all the values from the hash entry and put them directly into the row
+  std::vector<codegen::Value> left_vals;
+  left_value_storage_.LoadValues(codegen, data_area, left_vals);
+  for (uint32_t i = 0; i < left_val_ais_.size(); i++) {
+    row.RegisterAttributeValue(left_val_ais_[i], left_vals[i]);
+  }
+
+  // The keys that are plain attributes aren't stored in the value
+  for (uint32_t i = 0; i < left_key_exprs_.size(); i++) {
+    const auto *exp = left_key_exprs_[i];
+    if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+      LOG_DEBUG("Putting AI %s (%p) into row",
+                tve->GetAttributeRef()->name.c_str(), tve->GetAttributeRef());
+      row.RegisterAttributeValue(tve->GetAttributeRef(), key[i]);
+    }
+  }
+}
+
+void HashJoinTranslator::RegisterNullLeftValues(CodeGen &codegen,
+                                                RowBatch::Row &row) const {
+  for (const auto *ai : left_val_ais_) {
+    row.RegisterAttributeValue(ai, ai->type.GetSqlType().GetNullValue(codegen));
+  }
+  for (const auto *exp : left_key_exprs_) {
+    if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+      const auto *ai = tve->GetAttributeRef();
+      row.RegisterAttributeValue(ai,
+                                 ai->type.GetSqlType().GetNullValue(codegen));
+    }
+  }
+}
+
 const planner::HashJoinPlan &HashJoinTranslator::GetJoinPlan() const {
   return GetPlanAs<planner::HashJoinPlan>();
 }
@@ -524,42 +785,23 @@ const planner::HashJoinPlan &HashJoinTranslator::GetJoinPlan() const {
 
 HashJoinTranslator::ProbeRight::ProbeRight(
     const HashJoinTranslator &join_translator, ConsumerContext &context,
-    RowBatch::Row &row, const std::vector<codegen::Value> &right_key)
+    RowBatch::Row &row, const std::vector<codegen::Value> &right_key,
+    llvm::Value *probe_matched)
     : join_translator_(join_translator),
       context_(context),
       row_(row),
-      right_key_(right_key) {}
+      right_key_(right_key),
+      probe_matched_(probe_matched) {}
 
 void HashJoinTranslator::ProbeRight::ProcessEntry(
     CodeGen &codegen, const std::vector<codegen::Value> &key,
     llvm::Value *data_area) const {
-  const auto &storage = join_translator_.left_value_storage_;
-
   if (join_translator_.needs_output_vector_) {
     // Use output vector for attribute access
     throw Exception{"Shouldn't need output"};
   } else {
-    // LoadValues all the values from the hash entry
-    std::vector<codegen::Value> left_vals;
-    storage.LoadValues(codegen, data_area, left_vals);
-
     // Put the values directly into the row
-    const auto &left_val_ais = join_translator_.left_val_ais_;
-    for (uint32_t i = 0; i < left_val_ais.size(); i++) {
-      row_.RegisterAttributeValue(left_val_ais[i], left_vals[i]);
-    }
-
-    const auto &left_key_exprs = join_translator_.left_key_exprs_;
-    for (uint32_t i = 0; i < left_key_exprs.size(); i++) {
-      const auto *exp = left_key_exprs[i];
-      if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
-        auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
-        codegen::Value v = key[i];
-        LOG_DEBUG("Putting AI %s (%p) into row",
-                  tve->GetAttributeRef()->name.c_str(), tve->GetAttributeRef());
-        row_.RegisterAttributeValue(tve->GetAttributeRef(), v);
-      }
-    }
+    join_translator_.RegisterLeftValues(codegen, row_, key, data_area);
   }
 
   // Check predicate if one exists
@@ -569,15 +811,81 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
     auto valid_row = row_.DeriveValue(codegen, *predicate);
     lang::If is_valid_row{codegen, valid_row};
     {
-      // Send row up to the parent
-      context_.Consume(row_);
+      ProcessMatch(codegen, data_area);
     }
     is_valid_row.EndIf();
   } else {
+    ProcessMatch(codegen, data_area);
+  }
+}
+
+void HashJoinTranslator::ProbeRight::ProcessMatch(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  // Record the match on either side, if needed
+  if (join_translator_.track_left_matches_) {
+    join_translator_.hash_table_.MarkMatched(codegen, data_area);
+  }
+  if (probe_matched_ != nullptr) {
+    codegen->CreateStore(codegen.ConstBool(true), probe_matched_);
+  }
+
+  // Semi and anti joins only produce build-side rows, after the probe
+  auto join_type = join_translator_.GetJoinPlan().GetJoinType();
+  if (join_type != JoinType::SEMI && join_type != JoinType::ANTI) {
     // Send the row up to the parent
     context_.Consume(row_);
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// ProduceLeft
+///
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinTranslator::ProduceLeft::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  const auto &join = join_translator_.GetJoinPlan();
+
+  // Semi joins produce the rows that found a partner, all others the rest
+  llvm::Value *produce = join_translator_.hash_table_.IsMatched(codegen,
+                                                                data_area);
+  if (join.GetJoinType() != JoinType::SEMI) {
+    produce = codegen->CreateNot(produce);
+  }
+
+  // A NULL key is only NOT IN an empty set
+  if (probe_nonempty_ != nullptr) {
+    llvm::Value *null_key = codegen.ConstBool(false);
+    for (const auto &key_val : key) {
+      null_key = codegen->CreateOr(null_key, key_val.IsNull(codegen));
+    }
+    llvm::Value *not_null_or_empty = codegen->CreateOr(
+        codegen->CreateNot(null_key), codegen->CreateNot(probe_nonempty_));
+    produce = codegen->CreateAnd(produce, not_null_or_empty);
+  }
+
+  lang::If should_produce{codegen, produce};
+  {
+    // Create a batch of one row for the entry
+    Vector v{nullptr, 1, nullptr};
+    RowBatch one{context_.GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), v, false};
+    RowBatch::Row row{one, nullptr, nullptr};
+
+    // The build-side values come from the entry, probe-side values are NULL
+    join_translator_.RegisterLeftValues(codegen, row, key, data_area);
+    for (const auto *ai : join.GetRightAttributes()) {
+      row.RegisterAttributeValue(ai,
+                                 ai->type.GetSqlType().GetNullValue(codegen));
+    }
+
+    // Send the row up to the parent
+    context_.Consume(row);
+  }
+  should_produce.EndIf();
+}
+
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -0,0 +1,469 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator.cpp
+//
+// Identification: src/codegen/operator/index_scan_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/index_scan_translator.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/index_scan_iterator_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
+#include "codegen/proxy/storage_manager_proxy.h"
+#include "codegen/proxy/transaction_runtime_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/vector.h"
+#include "index/index.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace codegen {
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// AttributeAccess
+///
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This class enables deferred access to any one available attribute in an input
+ * row. It loads the attribute from the tile group the current batch of index
+ * results belongs to.
+ */
+class IndexScanTranslator::AttributeAccess : public RowBatch::AttributeAccess {
+ public:
+  AttributeAccess(const TileGroup::TileGroupAccess &access,
+                  const planner::AttributeInfo *ai)
+      : tile_group_access_(access), ai_(ai) {}
+
+  // Access an attribute in the given row
+  codegen::Value Access(CodeGen &codegen, RowBatch::Row &row) override {
+    auto raw_row = tile_group_access_.GetRow(row.GetTID(codegen));
+    return raw_row.LoadColumn(codegen, ai_->attribute_id);
+  }
+
+  const planner::AttributeInfo *GetAttributeRef() const { return ai_; }
+
+ private:
+  // The accessor we use to load column values
+  const TileGroup::TileGroupAccess &tile_group_access_;
+  // The attribute we will access
+  const planner::AttributeInfo *ai_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// ScanConsumer
+///
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The ScanConsumer is the callback invoked for every batch of tuples the index
+ * lookup found. The selection vector already holds the TIDs of the (visible)
+ * tuples in the batch, in index order.
+ */
+class IndexScanTranslator::ScanConsumer : public codegen::ScanCallback {
+ public:
+  // Constructor
+  ScanConsumer(ConsumerContext &ctx, const planner::IndexScanPlan &plan,
+               Vector &selection_vector)
+      : ctx_(ctx),
+        plan_(plan),
+        selection_vector_(selection_vector),
+        tile_group_id_(nullptr),
+        tile_group_ptr_(nullptr) {}
+
+  // The callback when starting iteration over a new batch
+  void TileGroupStart(CodeGen &, llvm::Value *tile_group_id,
+                      llvm::Value *tile_group_ptr) override {
+    tile_group_id_ = tile_group_id;
+    tile_group_ptr_ = tile_group_ptr;
+  }
+
+  // The code that processes a batch of index results
+  void ProcessTuples(CodeGen &codegen, llvm::Value *tid_start,
+                     llvm::Value *tid_end,
+                     TileGroup::TileGroupAccess &tile_group_access) override;
+
+  // The callback when finishing iteration over a batch
+  void TileGroupFinish(CodeGen &, llvm::Value *) override {}
+
+ private:
+  void SetupRowBatch(RowBatch &batch,
+                     TileGroup::TileGroupAccess &tile_group_access,
+                     std::vector<AttributeAccess> &access) const;
+
+  void FilterRowsByPredicate(CodeGen &codegen,
+                             const TileGroup::TileGroupAccess &access,
+                             llvm::Value *tid_start, llvm::Value *tid_end,
+                             Vector &selection_vector) const;
+
+  void PerformReads(CodeGen &codegen, Vector &selection_vector) const;
+
+ private:
+  // The consumer context
+  ConsumerContext &ctx_;
+  // The plan node
+  const planner::IndexScanPlan &plan_;
+  // The selection vector holding the TIDs of the current batch
+  Vector &selection_vector_;
+  // The current tile group id
+  llvm::Value *tile_group_id_;
+  // The current tile group
+  llvm::Value *tile_group_ptr_;
+};
+
+// Generate the body of the loop over the batches of index results
+void IndexScanTranslator::ScanConsumer::ProcessTuples(
+    CodeGen &codegen, llvm::Value *tid_start, llvm::Value *tid_end,
+    TileGroup::TileGroupAccess &tile_group_access) {
+  // 1. Filter rows by the residual predicate (if one exists)
+  auto *predicate = plan_.GetPredicate();
+  if (predicate != nullptr) {
+    FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
+                          selection_vector_);
+  }
+
+  // 2. Record reads for all of the tuples that pass the predicate
+  PerformReads(codegen, selection_vector_);
+
+  // 3. Setup the (filtered) row batch and setup attribute accessors
+  RowBatch batch{ctx_.GetCompilationContext(), tile_group_id_, tid_start,
+                 tid_end, selection_vector_, true};
+
+  std::vector<IndexScanTranslator::AttributeAccess> attribute_accesses;
+  SetupRowBatch(batch, tile_group_access, attribute_accesses);
+
+  // 4. Push the batch into the pipeline
+  ctx_.Consume(batch);
+}
+
+void IndexScanTranslator::ScanConsumer::SetupRowBatch(
+    RowBatch &batch, TileGroup::TileGroupAccess &tile_group_access,
+    std::vector<IndexScanTranslator::AttributeAccess> &access) const {
+  std::vector<const planner::AttributeInfo *> ais;
+  plan_.GetAttributes(ais);
+  const auto &output_col_ids = plan_.GetColumnIds();
+
+  // 1. Put all the attribute accessors into a vector
+  access.clear();
+  for (oid_t col_idx = 0; col_idx < output_col_ids.size(); col_idx++) {
+    access.emplace_back(tile_group_access, ais[output_col_ids[col_idx]]);
+  }
+
+  // 2. Add the attribute accessors into the row batch
+  for (oid_t col_idx = 0; col_idx < output_col_ids.size(); col_idx++) {
+    auto *attribute = ais[output_col_ids[col_idx]];
+    batch.AddAttribute(attribute, &access[col_idx]);
+  }
+}
+
+void IndexScanTranslator::ScanConsumer::FilterRowsByPredicate(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  // The batch we're filtering
+  RowBatch batch{ctx_.GetCompilationContext(), tile_group_id_, tid_start,
+                 tid_end, selection_vector, true};
+
+  // Determine the attributes the predicate needs
+  const auto *predicate = plan_.GetPredicate();
+
+  std::unordered_set<const planner::AttributeInfo *> used_attributes;
+  predicate->GetUsedAttributes(used_attributes);
+
+  // Setup the row batch with attribute accessors for the predicate
+  std::vector<AttributeAccess> attribute_accessors;
+  for (const auto *ai : used_attributes) {
+    attribute_accessors.emplace_back(access, ai);
+  }
+  for (uint32_t i = 0; i < attribute_accessors.size(); i++) {
+    auto &accessor = attribute_accessors[i];
+    batch.AddAttribute(accessor.GetAttributeRef(), &accessor);
+  }
+
+  // Iterate over the batch using a scalar loop
+  batch.Iterate(codegen, [&](RowBatch::Row &row) {
+    // Evaluate the predicate to determine row validity
+    codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
+
+    // Reify the boolean value since it may be NULL
+    PELOTON_ASSERT(valid_row.GetType().GetSqlType() ==
+                   type::Boolean::Instance());
+    llvm::Value *bool_val = type::Boolean::Instance().Reify(codegen, valid_row);
+
+    // Set the validity of the row
+    row.SetValidity(codegen, bool_val);
+  });
+}
+
+void IndexScanTranslator::ScanConsumer::PerformReads(
+    CodeGen &codegen, Vector &selection_vector) const {
+  ExecutionConsumer &ec = ctx_.GetCompilationContext().GetExecutionConsumer();
+  llvm::Value *txn = ec.GetTransactionPtr(ctx_.GetCompilationContext());
+  llvm::Value *raw_sel_vec = selection_vector.GetVectorPtr();
+
+  llvm::Value *is_for_update = codegen.ConstBool(plan_.IsForUpdate());
+  llvm::Value *end_idx = selection_vector.GetNumElements();
+
+  // Invoke TransactionRuntime::PerformVectorizedRead(...)
+  llvm::Value *out_idx =
+      codegen.Call(TransactionRuntimeProxy::PerformVectorizedRead,
+                   {txn, tile_group_ptr_, raw_sel_vec, end_idx, is_for_update});
+  selection_vector.SetNumElements(out_idx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// Index Scan Translator
+///
+////////////////////////////////////////////////////////////////////////////////
+
+IndexScanTranslator::IndexScanTranslator(const planner::IndexScanPlan &scan,
+                                         CompilationContext &context,
+                                         Pipeline &pipeline)
+    : OperatorTranslator(scan, context, pipeline),
+      tile_group_(*scan.GetTable()->GetSchema()) {
+  // Index scans produce tuples in index order, which the plan above may rely
+  // on. Hence, they're always executed serially.
+  pipeline.MarkSource(this, Pipeline::Parallelism::Serial);
+
+  // Register the iterator that performs the index lookup
+  auto &query_state = context.GetQueryState();
+  iterator_id_ = query_state.RegisterState(
+      "indexScanIterator", IndexScanIteratorProxy::GetType(GetCodeGen()));
+
+  // Collect the scan key, and prepare translators for the key values
+  const auto &key_column_ids = scan.GetKeyColumnIds();
+  const auto &expr_types = scan.GetExprTypes();
+  key_exprs_ = scan.GetKeyValueExpressions();
+  PELOTON_ASSERT(key_column_ids.size() == key_exprs_.size());
+  for (uint32_t i = 0; i < key_column_ids.size(); i++) {
+    key_column_ids_.push_back(key_column_ids[i]);
+    expr_types_.push_back(static_cast<int32_t>(expr_types[i]));
+    context.Prepare(*key_exprs_[i]);
+  }
+
+  // If there is a predicate, prepare a translator for it
+  const auto *predicate = scan.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+}
+
+bool IndexScanTranslator::UseAsProbe(const std::vector<oid_t> &column_ids) {
+  // The index must cover every probed column
+  auto &scan = GetScanPlan();
+  auto index = scan.GetTable()->GetIndexWithOid(scan.GetIndexId());
+  const auto &key_attrs = index->GetMetadata()->GetKeyAttrs();
+  for (auto column_id : column_ids) {
+    if (std::find(key_attrs.begin(), key_attrs.end(), column_id) ==
+        key_attrs.end()) {
+      return false;
+    }
+  }
+
+  // Probed values replace the plan's value for the same column, if any, and
+  // are otherwise compared for equality. This mirrors what the interpreted
+  // index scan does in IndexScanExecutor::UpdatePredicate().
+  auto equal = static_cast<int32_t>(ExpressionType::COMPARE_EQUAL);
+  for (auto column_id : column_ids) {
+    auto iter = std::find(key_column_ids_.begin(), key_column_ids_.end(),
+                          column_id);
+    uint32_t slot = static_cast<uint32_t>(iter - key_column_ids_.begin());
+    if (iter == key_column_ids_.end()) {
+      key_column_ids_.push_back(column_id);
+      expr_types_.push_back(equal);
+      key_exprs_.push_back(nullptr);
+    } else {
+      key_exprs_[slot] = nullptr;
+    }
+    probe_slots_.push_back(slot);
+  }
+  return true;
+}
+
+void IndexScanTranslator::InitializeQueryState() {
+  CodeGen &codegen = GetCodeGen();
+  auto &scan = GetScanPlan();
+
+  // The scan key description is passed as constant arrays. We always create
+  // at least one element so that an empty key still gets a valid pointer.
+  auto num_keys = static_cast<uint32_t>(key_column_ids_.size());
+  std::vector<uint32_t> key_column_ids{key_column_ids_};
+  std::vector<int32_t> expr_types{expr_types_};
+  key_column_ids.resize(std::max(num_keys, 1u));
+  expr_types.resize(std::max(num_keys, 1u));
+
+  llvm::Value *key_column_ids_ptr = codegen->CreatePointerCast(
+      codegen.ConstGenericBytes(
+          key_column_ids.data(),
+          static_cast<uint32_t>(key_column_ids.size() * sizeof(uint32_t)),
+          "keyColumnIds"),
+      codegen.Int32Type()->getPointerTo());
+  llvm::Value *expr_types_ptr = codegen->CreatePointerCast(
+      codegen.ConstGenericBytes(
+          expr_types.data(),
+          static_cast<uint32_t>(expr_types.size() * sizeof(int32_t)),
+          "keyExprTypes"),
+      codegen.Int32Type()->getPointerTo());
+
+  // Call IndexScanIterator::Init()
+  auto vec_size = Vector::kDefaultVectorSize.load();
+  codegen.Call(IndexScanIteratorProxy::Init,
+               {LoadStatePtr(iterator_id_), LoadTablePtr(codegen),
+                codegen.Const32(scan.GetIndexId()), key_column_ids_ptr,
+                expr_types_ptr, codegen.Const32(num_keys),
+                codegen.Const32(vec_size)});
+}
+
+void IndexScanTranslator::TearDownQueryState() {
+  GetCodeGen().Call(IndexScanIteratorProxy::Destroy,
+                    {LoadStatePtr(iterator_id_)});
+}
+
+// Produce the tuples found by the index lookup.
+//
+// @code
+// iterator.GetKeyValues()[i] := key_value_i
+// iterator.Scan(txn)
+//
+// for (batch := 0; batch < iterator.NumBatches(); ++batch) {
+//   tile_group_ptr := iterator.GetTileGroup(batch)
+//   num_tids := iterator.FillSelectionVector(batch, position_list)
+//   consumer.ProcessTuples(0, num_tids, tile_group_ptr)
+// }
+// @endcode
+void IndexScanTranslator::Produce() const {
+  auto producer = [this](ConsumerContext &ctx) {
+    CodeGen &codegen = GetCodeGen();
+    llvm::Value *iterator_ptr = LoadStatePtr(iterator_id_);
+
+    // Write the parts of the scan key that come from the plan. These are
+    // constants and query parameters, so there is no row to derive them from.
+    Vector v{nullptr, 1, nullptr};
+    RowBatch one{GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), v, false};
+    RowBatch::Row row{one, nullptr, nullptr};
+    for (uint32_t i = 0; i < key_exprs_.size(); i++) {
+      if (key_exprs_[i] != nullptr) {
+        WriteKeyValue(codegen, i, row.DeriveValue(codegen, *key_exprs_[i]));
+      }
+    }
+
+    // Probe the index
+    codegen.Call(IndexScanIteratorProxy::Scan,
+                 {iterator_ptr, GetTransactionPtr()});
+
+    // The selection vector for the scan
+    auto *i32_type = codegen.Int32Type();
+    auto vec_size = Vector::kDefaultVectorSize.load();
+    auto *raw_vec = codegen.AllocateBuffer(i32_type, vec_size, "scanPosList");
+    Vector position_list{raw_vec, vec_size, i32_type};
+
+    // Some space for the column layouts of each tile group
+    const auto num_columns = static_cast<uint32_t>(
+        GetScanPlan().GetTable()->GetSchema()->GetColumnCount());
+    llvm::Value *column_layouts = codegen.AllocateBuffer(
+        ColumnLayoutInfoProxy::GetType(codegen), num_columns, "columnLayout");
+
+    ScanConsumer scan_consumer{ctx, GetScanPlan(), position_list};
+
+    llvm::Value *num_batches =
+        codegen.Call(IndexScanIteratorProxy::NumBatches, {iterator_ptr});
+    llvm::Value *batch_idx = codegen.Const32(0);
+    lang::Loop loop{codegen, codegen->CreateICmpULT(batch_idx, num_batches),
+                    {{"batchIdx", batch_idx}}};
+    {
+      batch_idx = loop.GetLoopVar(0);
+
+      // Load the TIDs of the batch into the selection vector
+      llvm::Value *tile_group_ptr = codegen.Call(
+          IndexScanIteratorProxy::GetTileGroup, {iterator_ptr, batch_idx});
+      llvm::Value *num_tids =
+          codegen.Call(IndexScanIteratorProxy::FillSelectionVector,
+                       {iterator_ptr, batch_idx, position_list.GetVectorPtr()});
+      position_list.SetNumElements(num_tids);
+
+      // Process the batch
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
+      scan_consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
+      tile_group_.GenerateTidRangeAccess(codegen, tile_group_ptr,
+                                         column_layouts, codegen.Const32(0),
+                                         num_tids, scan_consumer);
+      scan_consumer.TileGroupFinish(codegen, tile_group_ptr);
+
+      // Move to the next batch
+      batch_idx = codegen->CreateAdd(batch_idx, codegen.Const32(1));
+      loop.LoopEnd(codegen->CreateICmpULT(batch_idx, num_batches), {batch_idx});
+    }
+  };
+
+  // Execute serially
+  GetPipeline().RunSerial(producer);
+}
+
+void IndexScanTranslator::WriteProbeKey(CodeGen &codegen, uint32_t probe_idx,
+                                        const codegen::Value &value) const {
+  PELOTON_ASSERT(probe_idx < probe_slots_.size());
+  WriteKeyValue(codegen, probe_slots_[probe_idx], value);
+}
+
+void IndexScanTranslator::WriteKeyValue(CodeGen &codegen, uint32_t key_idx,
+                                        const codegen::Value &value) const {
+  llvm::Value *key_values = codegen.Call(IndexScanIteratorProxy::GetKeyValues,
+                                         {LoadStatePtr(iterator_id_)});
+
+  const auto &sql_type = value.GetType().GetSqlType();
+
+  // Replace NULLs with the NULL value of the type, which the runtime checks
+  Value val = value;
+  Value null_val;
+  lang::If val_is_null{codegen, val.IsNull(codegen)};
+  {
+    null_val = sql_type.GetNullValue(codegen);
+  }
+  val_is_null.EndIf();
+  val = val_is_null.BuildPHI(null_val, val);
+
+  // Write the value using the type's output function
+  auto *output_func = sql_type.GetOutputFunction(codegen, val.GetType());
+  std::vector<llvm::Value *> args = {key_values, codegen.Const32(key_idx),
+                                     val.GetValue()};
+  if (val.GetLength() != nullptr) {
+    args.push_back(val.GetLength());
+  }
+  if (sql_type.TypeId() == peloton::type::TypeId::BOOLEAN) {
+    args.push_back(val.IsNull(codegen));
+  }
+  codegen.CallFunc(output_func, args);
+}
+
+llvm::Value *IndexScanTranslator::LoadTablePtr(CodeGen &codegen) const {
+  const storage::DataTable &table = *GetScanPlan().GetTable();
+
+  // Get the table instance from the database
+  llvm::Value *db_oid = codegen.Const32(table.GetDatabaseOid());
+  llvm::Value *table_oid = codegen.Const32(table.GetOid());
+  return codegen.Call(StorageManagerProxy::GetTableWithOid,
+                      {GetStorageManagerPtr(), db_oid, table_oid});
+}
+
+const planner::IndexScanPlan &IndexScanTranslator::GetScanPlan() const {
+  return GetPlanAs<planner::IndexScanPlan>();
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -23,6 +23,37 @@
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+// The number of bytes of a string kept in its normalized sort key
+constexpr uint32_t kStringKeyPrefixSize = 16;
+
+// The size of the normalized (memcomparable) encoding of values of the given
+// type, excluding the NULL indicator. Returns 0 if the type can't be
+// normalized.
+uint32_t NormalizedValueSize(peloton::type::TypeId type_id) {
+  switch (type_id) {
+    case peloton::type::TypeId::BOOLEAN:
+    case peloton::type::TypeId::TINYINT:
+      return 1;
+    case peloton::type::TypeId::SMALLINT:
+      return 2;
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::DATE:
+      return 4;
+    case peloton::type::TypeId::BIGINT:
+    case peloton::type::TypeId::TIMESTAMP:
+    case peloton::type::TypeId::DECIMAL:
+      return 8;
+    case peloton::type::TypeId::VARCHAR:
+      return kStringKeyPrefixSize;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// Sorter Attribute Access
@@ -124,7 +155,11 @@ OrderByTranslator::OrderByTranslator(const planner::OrderByPlan &plan,
                                      CompilationContext &context,
                                      Pipeline &pipeline)
     : OperatorTranslator(plan, context, pipeline),
-      child_pipeline_(this, Pipeline::Parallelism::Flexible) {
+      child_pipeline_(this, Pipeline::Parallelism::Flexible),
+      compare_func_(nullptr),
+      normalize_func_(nullptr),
+      key_size_(0),
+      key_is_exact_(false) {
   // Scanning the sorter happens serially (for now ...)
   pipeline.MarkSource(this, Pipeline::Parallelism::Serial);
 
@@ -202,6 +237,7 @@ void OrderByTranslator::InitializeQueryState() {
   auto *sorter_ptr = LoadStatePtr(sorter_id_);
   auto *exec_ctx_ptr = GetExecutorContextPtr();
   sorter_.Init(GetCodeGen(), sorter_ptr, exec_ctx_ptr, compare_func_);
+  UseNormalizedKeys(sorter_ptr);
 }
 
 void OrderByTranslator::TearDownQueryState() {
@@ -298,6 +334,179 @@ void OrderByTranslator::DefineAuxiliaryFunctions() {
   }
   // Set the function pointer
   compare_func_ = compare.GetFunction();
+
+  // Now the normalized keys
+  DefineNormalizeFunction();
+}
+
+//===----------------------------------------------------------------------===//
+// Here, we define the function producing the normalized sort key of a tuple.
+// Normalized keys are memcomparable: comparing two keys byte-by-byte gives the
+// order of their tuples, letting the sorter radix sort rather than call the
+// comparison function. The key concatenates the encodings of a prefix of the
+// sort columns:
+//
+//   => For NULL-able columns, a byte that is 1 for NULL (NULLs sort last)
+//   => Integers (and dates and timestamps) in big-endian with their sign bit
+//      flipped, decimals with their sign bit flipped and, if negative, all
+//      other bits too
+//   => The first bytes of strings, padded with zeros
+//
+// The bytes of descending columns are inverted. The key ends with the last
+// column that fits into the maximum key size, or with the first string since a
+// prefix doesn't decide the order of the columns after it. In either case, the
+// sorter falls back to the comparison function for tuples with equal keys.
+//===----------------------------------------------------------------------===//
+void OrderByTranslator::DefineNormalizeFunction() {
+  CodeGen &codegen = GetCodeGen();
+  const auto &plan = GetPlanAs<planner::OrderByPlan>();
+
+  const auto &storage_format = sorter_.GetStorageFormat();
+  const auto &descend_flags = plan.GetDescendFlags();
+
+  // Lay out the key: the sort columns it covers and the size of each
+  struct KeyColumn {
+    uint32_t sort_key_idx;
+    uint32_t value_size;
+  };
+  std::vector<KeyColumn> key_cols;
+  uint32_t key_size = 0;
+  bool key_is_exact = true;
+  for (uint32_t idx = 0; idx < sort_key_info_.size(); idx++) {
+    const auto &type = sort_key_info_[idx].sort_key->type;
+    uint32_t null_size = type.nullable ? 1 : 0;
+    uint32_t value_size = NormalizedValueSize(type.type_id);
+    uint32_t remaining = util::Sorter::kMaxNormalizedKeySize - key_size;
+
+    bool is_string = type.type_id == peloton::type::TypeId::VARCHAR;
+    if (is_string && remaining > null_size) {
+      value_size = std::min(value_size, remaining - null_size);
+    }
+
+    if (value_size == 0 || null_size + value_size > remaining) {
+      key_is_exact = false;
+      break;
+    }
+
+    key_cols.push_back(KeyColumn{idx, value_size});
+    key_size += null_size + value_size;
+
+    if (is_string) {
+      key_is_exact = false;
+      break;
+    }
+  }
+
+  if (key_cols.empty()) {
+    LOG_DEBUG("Sort keys can't be normalized, sorting by comparison");
+    return;
+  }
+
+  // Keys are padded to a multiple of 8 bytes
+  uint32_t padded_key_size = (key_size + 7) & ~7u;
+
+  std::vector<FunctionDeclaration::ArgumentInfo> args = {
+      {"tuple", codegen.CharPtrType()}, {"key", codegen.CharPtrType()}};
+  FunctionBuilder normalize(codegen.GetCodeContext(), "normalizeKey",
+                            codegen.VoidType(), args);
+  {
+    llvm::Value *tuple = normalize.GetArgumentByPosition(0);
+    llvm::Value *key = normalize.GetArgumentByPosition(1);
+
+    UpdateableStorage::NullBitmap null_bitmap(codegen, storage_format, tuple);
+
+    uint32_t offset = 0;
+    for (const auto &key_col : key_cols) {
+      const auto &sort_key_info = sort_key_info_[key_col.sort_key_idx];
+      bool descending = descend_flags[key_col.sort_key_idx];
+
+      codegen::Value val = storage_format.GetValue(
+          codegen, tuple, sort_key_info.tuple_slot, null_bitmap);
+      llvm::Value *is_null = val.IsNull(codegen);
+
+      // The NULL indicator
+      if (val.IsNullable()) {
+        llvm::Value *null_byte =
+            codegen->CreateZExt(is_null, codegen.ByteType());
+        if (descending) {
+          null_byte = codegen->CreateNot(null_byte);
+        }
+        codegen->CreateStore(null_byte, codegen->CreateConstInBoundsGEP1_32(
+                                            codegen.ByteType(), key, offset));
+        offset++;
+      }
+
+      llvm::Value *dest = codegen->CreateConstInBoundsGEP1_32(
+          codegen.ByteType(), key, offset);
+      offset += key_col.value_size;
+
+      // Strings are normalized at runtime
+      if (val.GetType().type_id == peloton::type::TypeId::VARCHAR) {
+        llvm::Value *len = codegen->CreateSelect(is_null, codegen.Const32(0),
+                                                 val.GetLength());
+        codegen.Call(SorterProxy::NormalizeStringPrefix,
+                     {dest, val.GetValue(), len,
+                      codegen.Const32(key_col.value_size),
+                      codegen.ConstBool(descending)});
+        continue;
+      }
+
+      // Fixed-size values are made into unsigned integers that order like the
+      // values, and written big-endian
+      llvm::Value *bits = val.GetValue();
+      auto type_id = val.GetType().type_id;
+      if (type_id == peloton::type::TypeId::BOOLEAN) {
+        bits = codegen->CreateZExt(bits, codegen.ByteType());
+      } else if (type_id == peloton::type::TypeId::DECIMAL) {
+        bits = codegen->CreateBitCast(bits, codegen.Int64Type());
+        llvm::Value *mask = codegen->CreateOr(
+            codegen->CreateAShr(bits, 63),
+            codegen.Const64(std::numeric_limits<int64_t>::min()));
+        bits = codegen->CreateXor(bits, mask);
+      } else {
+        auto num_bits = bits->getType()->getIntegerBitWidth();
+        bits = codegen->CreateXor(
+            bits, llvm::ConstantInt::get(bits->getType(),
+                                         uint64_t{1} << (num_bits - 1)));
+      }
+
+      // All NULLs have the same key
+      bits = codegen->CreateSelect(is_null,
+                                   llvm::Constant::getNullValue(bits->getType()),
+                                   bits);
+      if (descending) {
+        bits = codegen->CreateNot(bits);
+      }
+      if (key_col.value_size > 1) {
+        bits = codegen.ByteSwap(bits);
+      }
+      codegen->CreateStore(
+          bits, codegen->CreateBitCast(dest, bits->getType()->getPointerTo()));
+    }
+
+    // Zero the padding
+    for (; offset < padded_key_size; offset++) {
+      codegen->CreateStore(codegen.Const8(0),
+                           codegen->CreateConstInBoundsGEP1_32(
+                               codegen.ByteType(), key, offset));
+    }
+
+    normalize.ReturnAndFinish();
+  }
+
+  normalize_func_ = normalize.GetFunction();
+  key_size_ = padded_key_size;
+  key_is_exact_ = key_is_exact;
+
+  LOG_DEBUG("Normalized sort keys of %u bytes cover %zu of %zu sort columns",
+            key_size_, key_cols.size(), sort_key_info_.size());
+}
+
+void OrderByTranslator::UseNormalizedKeys(llvm::Value *sorter_ptr) const {
+  if (normalize_func_ != nullptr) {
+    sorter_.UseNormalizedKeys(GetCodeGen(), sorter_ptr, normalize_func_,
+                              key_size_, key_is_exact_);
+  }
 }
 
 void OrderByTranslator::Produce() const {
@@ -377,6 +586,7 @@ void OrderByTranslator::InitializePipelineState(PipelineContext &pipeline_ctx) {
     auto *sorter_ptr = pipeline_ctx.LoadStatePtr(codegen, thread_sorter_id_);
     auto *exec_ctx_ptr = GetExecutorContextPtr();
     sorter_.Init(codegen, sorter_ptr, exec_ctx_ptr, compare_func_);
+    UseNormalizedKeys(sorter_ptr);
   }
 }
 
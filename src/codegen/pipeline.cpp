@@ -16,6 +16,7 @@
 #include "codegen/codegen.h"
 #include "codegen/compilation_context.h"
 #include "codegen/consumer_context.h"
+#include "codegen/lang/if.h"
 #include "codegen/lang/loop.h"
 #include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
@@ -28,10 +29,11 @@ namespace {
 
 std::string CreateUniqueFunctionName(Pipeline &pipeline,
                                      const std::string &prefix) {
-  CompilationContext &compilation_ctx = pipeline.GetCompilationContext();
-  CodeContext &cc = compilation_ctx.GetCodeGen().GetCodeContext();
-  return StringUtil::Format("_%" PRId64 "_pipeline_%u_%s_%s", cc.GetID(),
-                            pipeline.GetId(), prefix.c_str(),
+  // Every query has its own module, so the name doesn't need the ID of the
+  // code context. It stays the same across processes, which the persistent
+  // object cache relies on.
+  return StringUtil::Format("_pipeline_%u_%s_%s", pipeline.GetId(),
+                            prefix.c_str(),
                             pipeline.ConstructPipelineName().c_str());
 }
 
@@ -312,6 +314,14 @@ const OperatorTranslator *Pipeline::NextStep() {
   }
 }
 
+std::vector<const OperatorTranslator *> Pipeline::GetConsumers(
+    const OperatorTranslator *translator) const {
+  auto iter = std::find(pipeline_.begin(), pipeline_.end(), translator);
+  PELOTON_ASSERT(iter != pipeline_.end());
+  return std::vector<const OperatorTranslator *>(
+      std::reverse_iterator<decltype(iter)>(iter), pipeline_.rend());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// Stage-related functionality
@@ -462,11 +472,17 @@ void Pipeline::CompletePipeline(PipelineContext &pipeline_ctx) {
   PipelineContext::LoopOverStates loop_state{pipeline_ctx};
   loop_state.Do([this, &pipeline_ctx](llvm::Value *thread_state) {
     PipelineContext::SetState state_access(pipeline_ctx, thread_state);
-    // Let operators in the pipeline clean up any pipeline state
-    for (auto riter = pipeline_.rbegin(), rend = pipeline_.rend();
-         riter != rend; ++riter) {
-      (*riter)->TearDownPipelineState(pipeline_ctx);
+    // Only states that were handed to a worker have been initialized
+    CodeGen &codegen = compilation_ctx_.GetCodeGen();
+    lang::If initialized{codegen, pipeline_ctx.LoadFlag(codegen)};
+    {
+      // Let operators in the pipeline clean up any pipeline state
+      for (auto riter = pipeline_.rbegin(), rend = pipeline_.rend();
+           riter != rend; ++riter) {
+        (*riter)->TearDownPipelineState(pipeline_ctx);
+      }
     }
+    initialized.EndIf();
   });
 }
 
@@ -537,18 +553,28 @@ void Pipeline::DoRun(
     auto *query_state = func.GetArgumentByPosition(0);
     auto *thread_state = func.GetArgumentByPosition(1);
 
-    // If the pipeline is parallel, we need to call the generated init function
     if (IsParallel()) {
       thread_state = codegen->CreatePointerCast(
           thread_state, pipeline_ctx.GetThreadStateType()->getPointerTo());
-
-      auto *init_func = pipeline_ctx.thread_init_func_;
-      codegen.CallFunc(init_func, {query_state, thread_state});
     }
 
     // Setup the thread state access for the pipeline context
     PipelineContext::SetState state_access(pipeline_ctx, thread_state);
 
+    // If the pipeline is parallel, we need to call the generated init function.
+    // A worker runs the pipeline once for every morsel it grabs, always with
+    // the same thread state, so only initialize the state on the first run.
+    if (IsParallel()) {
+      llvm::Value *initialized = pipeline_ctx.LoadFlag(codegen);
+      lang::If init_state{codegen, codegen->CreateNot(initialized),
+                          "initWorkerState"};
+      {
+        auto *init_func = pipeline_ctx.thread_init_func_;
+        codegen.CallFunc(init_func, {query_state, thread_state});
+      }
+      init_state.EndIf();
+    }
+
     // First initialize the execution consumer
     auto &execution_consumer = compilation_ctx_.GetExecutionConsumer();
     execution_consumer.InitializePipelineState(pipeline_ctx);
@@ -564,6 +590,17 @@ void Pipeline::DoRun(
                         func.GetExitBlock());
     body(ctx, pipeline_args);
 
+    // Let the operators produce any rows that depend on all of the input to
+    // the pipeline, starting at the source. These rows flow up the remainder
+    // of the pipeline one at a time, and only once, so this is only possible
+    // in a serial pipeline.
+    if (!IsParallel()) {
+      for (auto i = static_cast<uint32_t>(pipeline_.size()); i > 0; i--) {
+        pipeline_index_ = i - 1;
+        pipeline_[pipeline_index_]->ProduceRemaining(ctx);
+      }
+    }
+
     // Finish
     func.ReturnAndFinish();
   }
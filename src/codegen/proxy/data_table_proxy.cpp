@@ -12,12 +12,15 @@
 
 #include "codegen/proxy/data_table_proxy.h"
 
+#include "codegen/proxy/zone_map_proxy.h"
+
 namespace peloton {
 namespace codegen {
 
 DEFINE_TYPE(DataTable, "storage::DataTable", opaque);
 
 DEFINE_METHOD(peloton::storage, DataTable, GetTileGroupCount);
+DEFINE_METHOD(peloton::storage, DataTable, GetZoneMap);
 
 }  // namespace codegen
 }  // namespace peloton
@@ -42,7 +42,7 @@ DEFINE_MEMBER(dummy, Entry, hash);
 DEFINE_MEMBER(dummy, Entry, next);
 
 DEFINE_TYPE(HashTable, "peloton::HashTable", memory, directory, size, mask,
-            entry_buffer, num_elems, capacity, stats);
+            entry_buffer, num_elems, capacity, spill);
 
 DEFINE_METHOD(peloton::codegen::util, HashTable, Init);
 DEFINE_METHOD(peloton::codegen::util, HashTable, Insert);
@@ -50,6 +50,9 @@ DEFINE_METHOD(peloton::codegen::util, HashTable, InsertLazy);
 DEFINE_METHOD(peloton::codegen::util, HashTable, BuildLazy);
 DEFINE_METHOD(peloton::codegen::util, HashTable, ReserveLazy);
 DEFINE_METHOD(peloton::codegen::util, HashTable, MergeLazyUnfinished);
+DEFINE_METHOD(peloton::codegen::util, HashTable, BuildLazyPartitioned);
+DEFINE_METHOD(peloton::codegen::util, HashTable, EnableSpilling);
+DEFINE_METHOD(peloton::codegen::util, HashTable, NextPass);
 DEFINE_METHOD(peloton::codegen::util, HashTable, Destroy);
 
 }  // namespace codegen
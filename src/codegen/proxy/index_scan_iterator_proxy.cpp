@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_iterator_proxy.cpp
+//
+// Identification: src/codegen/proxy/index_scan_iterator_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/index_scan_iterator_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(IndexScanIterator, "util::IndexScanIterator", opaque);
+
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, Init);
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, Destroy);
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, GetKeyValues);
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, Scan);
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, NumBatches);
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, GetTileGroup);
+DEFINE_METHOD(peloton::codegen::util, IndexScanIterator, FillSelectionVector);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -12,6 +12,8 @@
 
 #include "codegen/proxy/oa_hash_table_proxy.h"
 
+#include "codegen/proxy/executor_context_proxy.h"
+
 namespace peloton {
 namespace codegen {
 
@@ -24,11 +26,17 @@ DEFINE_TYPE(OAHashEntry, "peloton::OAHashEntry", kv_list, hash);
 /// OAHashTable
 DEFINE_TYPE(OAHashTable, "peloton::OAHashTable", buckets, num_buckets,
             bucket_mask, num_occupied_buckets, num_entries, resize_threshold,
-            entry_size, key_size, value_size);
+            entry_size, key_size, value_size, memory, spill);
 
 DEFINE_METHOD(peloton::codegen::util, OAHashTable, Init);
 DEFINE_METHOD(peloton::codegen::util, OAHashTable, StoreTuple);
 DEFINE_METHOD(peloton::codegen::util, OAHashTable, Destroy);
+DEFINE_METHOD(peloton::codegen::util, OAHashTable, InitPartitions);
+DEFINE_METHOD(peloton::codegen::util, OAHashTable, DestroyPartitions);
+DEFINE_METHOD(peloton::codegen::util, OAHashTable, MergePartitioned);
+DEFINE_METHOD(peloton::codegen::util, OAHashTable, EnableSpilling);
+DEFINE_METHOD(peloton::codegen::util, OAHashTable, FlushSpilled);
+DEFINE_METHOD(peloton::codegen::util, OAHashTable, NextSpilledPartition);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
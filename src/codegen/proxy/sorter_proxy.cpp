@@ -18,7 +18,7 @@ namespace peloton {
 namespace codegen {
 
 DEFINE_TYPE(Sorter, "peloton::util::Sorter", opaque1, tuples_start, tuples_end,
-            opaque2);
+            opaque2, opaque3, external);
 
 DEFINE_METHOD(peloton::codegen::util, Sorter, Init);
 DEFINE_METHOD(peloton::codegen::util, Sorter, StoreTuple);
@@ -28,6 +28,9 @@ DEFINE_METHOD(peloton::codegen::util, Sorter, Sort);
 DEFINE_METHOD(peloton::codegen::util, Sorter, SortParallel);
 DEFINE_METHOD(peloton::codegen::util, Sorter, SortTopKParallel);
 DEFINE_METHOD(peloton::codegen::util, Sorter, Destroy);
+DEFINE_METHOD(peloton::codegen::util, Sorter, UseNormalizedKeys);
+DEFINE_METHOD(peloton::codegen::util, Sorter, NormalizeStringPrefix);
+DEFINE_METHOD(peloton::codegen::util, Sorter, NextBatch);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -20,10 +20,9 @@ namespace codegen {
 
 DEFINE_TYPE(PredicateInfo, "peloton::storage::PredicateInfo", col_id,
             comparison_operator, predicate_value);
-DEFINE_TYPE(ZoneMapManager, "peloton::storage::ZoneMapManager", opaque);
+DEFINE_TYPE(ZoneMap, "peloton::storage::ZoneMap", opaque);
 
-DEFINE_METHOD(peloton::storage, ZoneMapManager, ShouldScanTileGroup);
-DEFINE_METHOD(peloton::storage, ZoneMapManager, GetInstance);
+DEFINE_METHOD(peloton::storage, ZoneMap, ShouldScanTileGroup);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
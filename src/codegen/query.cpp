@@ -11,8 +11,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/query.h"
+
+#include <unordered_map>
+
 #include "codegen/interpreter/bytecode_builder.h"
 #include "codegen/interpreter/bytecode_interpreter.h"
+#include "codegen/interpreter/function_trampoline.h"
+#include "codegen/object_cache.h"
 #include "codegen/query_compiler.h"
 #include "common/timer.h"
 #include "executor/plan_executor.h"
@@ -20,22 +25,44 @@
 #include "executor/executor_context.h"
 #include "storage/storage_manager.h"
 #include "settings/settings_manager.h"
+#include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
 namespace codegen {
 
+// The bytecode of the query functions, and trampolines for all functions whose
+// addresses are passed to the runtime
+struct Query::AdaptiveState {
+  AdaptiveState(interpreter::BytecodeFunction &&init,
+                interpreter::BytecodeFunction &&plan,
+                interpreter::BytecodeFunction &&tear_down)
+      : init_bytecode(std::move(init)),
+        plan_bytecode(std::move(plan)),
+        tear_down_bytecode(std::move(tear_down)) {}
+
+  interpreter::BytecodeFunction init_bytecode;
+  interpreter::BytecodeFunction plan_bytecode;
+  interpreter::BytecodeFunction tear_down_bytecode;
+
+  std::vector<std::unique_ptr<interpreter::FunctionTrampoline>> trampolines;
+};
+
 // Constructor
 Query::Query(const planner::AbstractPlan &query_plan)
-    : query_plan_(query_plan) {}
+    : query_plan_(query_plan), parameter_size_(0), is_compiled_(false) {}
+
+Query::~Query() {
+  // The compilation uses the code context and the trampolines
+  if (compile_future_.valid()) {
+    compile_future_.wait();
+  }
+}
 
 void Query::Execute(executor::ExecutorContext &executor_context,
                     ExecutionConsumer &consumer, RuntimeStats *stats) {
-  CodeGen codegen{code_context_};
-
-  llvm::Type *query_state_type = query_state_.GetType();
-  size_t parameter_size = codegen.SizeOf(query_state_type);
-  PELOTON_ASSERT((parameter_size % 8 == 0) &&
-      "parameter size not multiple of 8");
+  // The size was computed up front, the data layout must not be used while
+  // the query is compiled in the background
+  size_t parameter_size = parameter_size_;
 
   // Allocate some space for the function arguments
   std::unique_ptr<char[]> param_data{new char[parameter_size]};
@@ -50,9 +77,15 @@ void Query::Execute(executor::ExecutorContext &executor_context,
   bool force_interpreter = settings::SettingsManager::GetBool(
       settings::SettingId::codegen_interpreter);
 
-  if (is_compiled_ && !force_interpreter) {
+  if (IsCompiled() && !force_interpreter) {
     ExecuteNative(func_args, stats);
+  } else if (adaptive_state_ != nullptr && !force_interpreter) {
+    ExecuteAdaptive(func_args, stats);
   } else {
+    // The IR must not change while the interpreter translates it
+    if (compile_future_.valid()) {
+      compile_future_.wait();
+    }
     try {
       ExecuteInterpreter(func_args, stats);
     } catch (interpreter::NotSupportedException e) {
@@ -64,16 +97,24 @@ void Query::Execute(executor::ExecutorContext &executor_context,
 void Query::Prepare(const LLVMFunctions &query_funcs) {
   llvm_functions_ = query_funcs;
 
+  CodeGen codegen{code_context_};
+  parameter_size_ = codegen.SizeOf(query_state_.GetType());
+  PELOTON_ASSERT((parameter_size_ % 8 == 0) &&
+      "parameter size not multiple of 8");
+
   // verify the functions
   // will also be done by Optimize() or Compile() if not done before,
   // but we do not want to mix up the timings, so do it here
   code_context_.Verify();
 
-  // optimize the functions
+  // optimize the functions, unless the object code is in the persistent cache
+  // and is loaded as it is
   // TODO(marcel): add switch to enable/disable optimization
   // TODO(marcel): add timer to measure time used for optimization (see
   // RuntimeStats)
-  code_context_.Optimize();
+  if (!ObjectCache::Instance().Attach(query_plan_, code_context_)) {
+    code_context_.Optimize();
+  }
 
   is_compiled_ = false;
 }
@@ -105,7 +146,16 @@ void Query::Compile(CompileStats *stats) {
           llvm_functions_.tear_down_func);
   PELOTON_ASSERT(compiled_functions_.tear_down_func != nullptr);
 
-  is_compiled_ = true;
+  // Calls through the trampolines use the native code from now on
+  if (adaptive_state_ != nullptr) {
+    for (auto &trampoline : adaptive_state_->trampolines) {
+      trampoline->SetNativeFunction(code_context_.GetRawFunctionPointer(
+          const_cast<llvm::Function *>(trampoline->GetFunction())));
+    }
+  }
+
+  compiled_at_ = std::chrono::steady_clock::now();
+  is_compiled_.store(true, std::memory_order_release);
 
   LOG_TRACE("Compilation finished.");
 
@@ -117,6 +167,69 @@ void Query::Compile(CompileStats *stats) {
   }
 }
 
+void Query::CompileAsync() {
+  // Loading cached object code is as fast as building the bytecode
+  if (code_context_.HasCachedObject()) {
+    Compile();
+    return;
+  }
+
+  // The bytecode has to be built before the compilation starts, as the LLVM
+  // code generator modifies the IR of the functions. Functions whose addresses
+  // are passed to the runtime are called through trampolines, which switch to
+  // the native code once the compilation finishes.
+  std::unordered_map<const llvm::Function *, void *> entry_points;
+  std::vector<std::unique_ptr<interpreter::FunctionTrampoline>> trampolines;
+  interpreter::BytecodeBuilder::FunctionResolver resolver;
+  resolver = [this, &resolver, &entry_points,
+              &trampolines](const llvm::Function *function) {
+    auto iter = entry_points.find(function);
+    if (iter != entry_points.end()) {
+      return iter->second;
+    }
+    trampolines.emplace_back(
+        new interpreter::FunctionTrampoline(code_context_, function, &resolver));
+    void *entry_point = trampolines.back()->GetEntryPoint();
+    entry_points[function] = entry_point;
+    return entry_point;
+  };
+
+  try {
+    auto build = [this, &resolver](llvm::Function *function) {
+      return interpreter::BytecodeBuilder::CreateBytecodeFunction(
+          code_context_, function, false, &resolver);
+    };
+    adaptive_state_.reset(new AdaptiveState(
+        build(llvm_functions_.init_func), build(llvm_functions_.plan_func),
+        build(llvm_functions_.tear_down_func)));
+    adaptive_state_->trampolines = std::move(trampolines);
+  } catch (interpreter::NotSupportedException &e) {
+    LOG_DEBUG("query not supported by interpreter, compiling it now: %s",
+              e.what());
+    adaptive_state_.reset();
+    Compile();
+    return;
+  }
+
+  // A bounded pool compiles the queries, a burst of new queries waits in its
+  // queue and keeps running in the interpreter meanwhile
+  auto compiled = std::make_shared<std::promise<void>>();
+  compile_future_ = compiled->get_future().share();
+  threadpool::MonoQueuePool::GetCompileInstance().SubmitTask(
+      [this, compiled]() {
+        try {
+          CompileStats stats;
+          Compile(&stats);
+          LOG_DEBUG("Compiled query in the background (%.2lf ms)",
+                    stats.compile_ms);
+          compiled->set_value();
+        } catch (...) {
+          // The query keeps running in the interpreter
+          compiled->set_exception(std::current_exception());
+        }
+      });
+}
+
 void Query::ExecuteNative(FunctionArguments *function_arguments,
                           RuntimeStats *stats) {
   // Start timer
@@ -169,6 +282,7 @@ void Query::ExecuteNative(FunctionArguments *function_arguments,
   if (stats != nullptr) {
     timer.Stop();
     stats->tear_down_ms = timer.GetDuration();
+    stats->native_ms = stats->init_ms + stats->plan_ms + stats->tear_down_ms;
   }
 }
 
@@ -247,7 +361,86 @@ void Query::ExecuteInterpreter(FunctionArguments *function_arguments,
   if (stats != nullptr) {
     timer.Stop();
     stats->tear_down_ms = timer.GetDuration();
+    stats->interpreted_ms =
+        stats->init_ms + stats->plan_ms + stats->tear_down_ms;
+  }
+}
+
+void Query::ExecuteAdaptive(FunctionArguments *function_arguments,
+                            RuntimeStats *stats) {
+  PELOTON_ASSERT(adaptive_state_ != nullptr);
+  const auto &state = *adaptive_state_;
+
+  // Call init
+  LOG_TRACE("Calling query's init() ...");
+  double init_ms = 0.0;
+  try {
+    init_ms = ExecuteAdaptiveFunction(&CompiledFunctions::init_func,
+                                      state.init_bytecode, function_arguments,
+                                      stats);
+  } catch (...) {
+    ExecuteAdaptiveFunction(&CompiledFunctions::tear_down_func,
+                            state.tear_down_bytecode, function_arguments,
+                            nullptr);
+    throw;
+  }
+
+  // Execute the query!
+  LOG_TRACE("Calling query's plan() ...");
+  double plan_ms = 0.0;
+  try {
+    plan_ms = ExecuteAdaptiveFunction(&CompiledFunctions::plan_func,
+                                      state.plan_bytecode, function_arguments,
+                                      stats);
+  } catch (...) {
+    ExecuteAdaptiveFunction(&CompiledFunctions::tear_down_func,
+                            state.tear_down_bytecode, function_arguments,
+                            nullptr);
+    throw;
+  }
+
+  // Clean up
+  LOG_TRACE("Calling query's tearDown() ...");
+  double tear_down_ms = ExecuteAdaptiveFunction(
+      &CompiledFunctions::tear_down_func, state.tear_down_bytecode,
+      function_arguments, stats);
+
+  if (stats != nullptr) {
+    stats->init_ms = init_ms;
+    stats->plan_ms = plan_ms;
+    stats->tear_down_ms = tear_down_ms;
+  }
+}
+
+double Query::ExecuteAdaptiveFunction(
+    compiled_function_t CompiledFunctions::*native_func,
+    const interpreter::BytecodeFunction &bytecode_func,
+    FunctionArguments *function_arguments, RuntimeStats *stats) {
+  using milliseconds = std::chrono::duration<double, std::milli>;
+
+  auto start = std::chrono::steady_clock::now();
+  bool native = IsCompiled();
+  if (native) {
+    (compiled_functions_.*native_func)(function_arguments);
+  } else {
+    interpreter::BytecodeInterpreter::ExecuteFunction(
+        bytecode_func, reinterpret_cast<char *>(function_arguments));
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  if (stats != nullptr) {
+    if (native) {
+      stats->native_ms += milliseconds(end - start).count();
+    } else if (IsCompiled() && compiled_at_ > start) {
+      // The pipelines called through trampolines ran natively from the moment
+      // the compilation finished
+      stats->interpreted_ms += milliseconds(compiled_at_ - start).count();
+      stats->native_ms += milliseconds(end - compiled_at_).count();
+    } else {
+      stats->interpreted_ms += milliseconds(end - start).count();
+    }
   }
+  return milliseconds(end - start).count();
 }
 
 }  // namespace codegen
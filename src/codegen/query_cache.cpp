@@ -11,96 +11,208 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/query_cache.h"
-#include "planner/delete_plan.h"
-#include "planner/insert_plan.h"
-#include "planner/seq_scan_plan.h"
-#include "planner/update_plan.h"
-#include "storage/data_table.h"
+
+#include "planner/plan_util.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace codegen {
 
-Query* QueryCache::Find(const std::shared_ptr<planner::AbstractPlan> &key) {
-  cache_lock_.ReadLock();
-  auto it = cache_map_.find(key);
-  if (it == cache_map_.end()) {
-    cache_lock_.Unlock();
+QueryCache::QueryCache() {
+  capacity_ = static_cast<size_t>(settings::SettingsManager::GetInt(
+                  settings::SettingId::codegen_query_cache_size)) *
+              1024 * 1024;
+}
+
+std::shared_ptr<Query> QueryCache::Find(
+    const std::shared_ptr<planner::AbstractPlan> &key) {
+  Shard &shard = GetShard(*key);
+  shard.latch.ReadLock();
+  auto it = shard.map.find(key);
+  if (it == shard.map.end()) {
+    shard.latch.Unlock();
+    shard.miss_count++;
     return nullptr;
   }
-  query_list_.splice(query_list_.begin(), query_list_, it->second);
-  auto *query = it->second->second.get();
-  cache_lock_.Unlock();
+
+  // Avoid writing the cache line if the bit is set already
+  Entry &entry = it->second->second;
+  if (!entry.referenced.load(std::memory_order_relaxed)) {
+    entry.referenced.store(true, std::memory_order_relaxed);
+  }
+  std::shared_ptr<Query> query = entry.query;
+  shard.latch.Unlock();
+  shard.hit_count++;
   return query;
 }
 
 void QueryCache::Add(const std::shared_ptr<planner::AbstractPlan> &key,
-                     std::unique_ptr<Query> &&val) {
-  cache_lock_.WriteLock();
-  query_list_.push_front(make_pair(key, std::move(val)));
-  cache_map_.insert(make_pair(key, query_list_.begin()));
-  cache_lock_.Unlock();
+                     std::shared_ptr<Query> val) {
+  size_t size = val->GetCodeContext().GetCodeSize();
+  std::vector<std::shared_ptr<Query>> evicted;
+
+  Shard &shard = GetShard(*key);
+  shard.latch.WriteLock();
+  auto it = shard.map.find(key);
+  if (it != shard.map.end()) {
+    // Someone else added the same plan in the meantime
+    evicted.push_back(Erase(shard, it->second));
+  }
+
+  // New entries are added right behind the hand, i.e., they are the last ones
+  // it visits
+  auto entry = shard.entries.emplace(
+      shard.hand, std::piecewise_construct, std::forward_as_tuple(key),
+      std::forward_as_tuple(std::move(val), size));
+  shard.map.emplace(key, entry);
+  for (oid_t table_oid : planner::PlanUtil::GetTablesReferenced(key.get())) {
+    shard.table_index.emplace(table_oid, entry);
+  }
+  shard.size += size;
+
+  size_t capacity = capacity_;
+  if (capacity != 0) {
+    Evict(shard, capacity / kNumShards, evicted);
+  }
+  shard.latch.Unlock();
 }
 
 void QueryCache::Clear() {
-  cache_lock_.WriteLock();
-  cache_map_.clear();
-  query_list_.clear();
-  cache_lock_.Unlock();
+  for (auto &shard : shards_) {
+    EntryList entries;
+    shard.latch.WriteLock();
+    shard.map.clear();
+    shard.table_index.clear();
+    entries.swap(shard.entries);
+    shard.hand = shard.entries.end();
+    shard.size = 0;
+    shard.latch.Unlock();
+  }
 }
 
 void QueryCache::Remove(const oid_t table_oid) {
-  cache_lock_.WriteLock();
-
-  for (auto it = cache_map_.begin(); it != cache_map_.end(); ) {
-    oid_t oid = GetOidFromPlan(*it->first.get());
-    if (oid == table_oid) {
-      query_list_.erase(it->second);
-      it = cache_map_.erase(it);
-    } else {
-      ++it;
+  for (auto &shard : shards_) {
+    std::vector<std::shared_ptr<Query>> removed;
+    shard.latch.WriteLock();
+    auto range = shard.table_index.equal_range(table_oid);
+    std::vector<EntryList::iterator> entries;
+    for (auto it = range.first; it != range.second; ++it) {
+      entries.push_back(it->second);
+    }
+    for (auto entry : entries) {
+      removed.push_back(Erase(shard, entry));
     }
+    shard.latch.Unlock();
   }
-  cache_lock_.Unlock();
 }
 
-void QueryCache::Resize(size_t target_size) {
-  cache_lock_.WriteLock();
-  while (cache_map_.size() > target_size) {
-    auto last_it = query_list_.end();
-    last_it--;
-    cache_map_.erase(last_it->first);
-    query_list_.pop_back();
+size_t QueryCache::GetCount() const {
+  size_t count = 0;
+  for (const auto &shard : shards_) {
+    shard.latch.ReadLock();
+    count += shard.map.size();
+    shard.latch.Unlock();
   }
-  capacity_ = target_size;
-  cache_lock_.Unlock();
+  return count;
 }
 
-oid_t QueryCache::GetOidFromPlan(const planner::AbstractPlan &plan) const {
- switch (plan.GetPlanNodeType()) {
-    case PlanNodeType::SEQSCAN: {
-      auto &dplan = static_cast<const planner::SeqScanPlan &>(plan);
-      return dplan.GetTable()->GetOid();
-    }
-    case PlanNodeType::DELETE: {
-      auto &dplan = static_cast<const planner::DeletePlan &>(plan);
-      return dplan.GetTable()->GetOid();
+size_t QueryCache::GetSize() const {
+  size_t size = 0;
+  for (const auto &shard : shards_) {
+    shard.latch.ReadLock();
+    size += shard.size;
+    shard.latch.Unlock();
+  }
+  return size;
+}
+
+void QueryCache::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  if (capacity == 0) {
+    return;
+  }
+
+  for (auto &shard : shards_) {
+    std::vector<std::shared_ptr<Query>> evicted;
+    shard.latch.WriteLock();
+    Evict(shard, capacity / kNumShards, evicted);
+    shard.latch.Unlock();
+  }
+}
+
+uint64_t QueryCache::GetHitCount() const {
+  uint64_t count = 0;
+  for (const auto &shard : shards_) {
+    count += shard.hit_count;
+  }
+  return count;
+}
+
+uint64_t QueryCache::GetMissCount() const {
+  uint64_t count = 0;
+  for (const auto &shard : shards_) {
+    count += shard.miss_count;
+  }
+  return count;
+}
+
+uint64_t QueryCache::GetEvictionCount() const {
+  uint64_t count = 0;
+  for (const auto &shard : shards_) {
+    count += shard.eviction_count;
+  }
+  return count;
+}
+
+void QueryCache::Evict(Shard &shard, size_t capacity,
+                       std::vector<std::shared_ptr<Query>> &evicted) {
+  // Every entry is visited at most twice, the first visit clears its bit
+  size_t visits = 2 * shard.entries.size();
+  while (shard.size > capacity && visits-- > 0) {
+    if (shard.hand == shard.entries.end()) {
+      shard.hand = shard.entries.begin();
     }
-    case PlanNodeType::INSERT: {
-      auto &dplan = static_cast<const planner::InsertPlan &>(plan);
-      return dplan.GetTable()->GetOid();
+
+    // Account for the code compiled since the last visit
+    Entry &entry = shard.hand->second;
+    size_t size = entry.query->GetCodeContext().GetCodeSize();
+    shard.size += size - entry.size;
+    entry.size = size;
+
+    if (entry.referenced.load(std::memory_order_relaxed)) {
+      entry.referenced.store(false, std::memory_order_relaxed);
+      ++shard.hand;
+      continue;
     }
-    case PlanNodeType::UPDATE: {
-      auto &dplan = static_cast<const planner::UpdatePlan &>(plan);
-      return dplan.GetTable()->GetOid();
+
+    evicted.push_back(Erase(shard, shard.hand));
+    shard.eviction_count++;
+  }
+}
+
+std::shared_ptr<Query> QueryCache::Erase(Shard &shard,
+                                         EntryList::iterator entry) {
+  for (oid_t table_oid :
+       planner::PlanUtil::GetTablesReferenced(entry->first.get())) {
+    auto range = shard.table_index.equal_range(table_oid);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == entry) {
+        shard.table_index.erase(it);
+        break;
+      }
     }
-    default: { break; }
   }
-  if (plan.GetChildren().size() == 0) {
-    return INVALID_OID;
+  shard.map.erase(entry->first);
+  shard.size -= entry->second.size;
+
+  std::shared_ptr<Query> query = std::move(entry->second.query);
+  if (shard.hand == entry) {
+    shard.hand = shard.entries.erase(entry);
   } else {
-    return GetOidFromPlan(*plan.GetChild(0));
+    shard.entries.erase(entry);
   }
+  return query;
 }
 
 }  // namespace codegen
-}  // namespace peloton 
+}  // namespace peloton
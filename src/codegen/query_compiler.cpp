@@ -15,6 +15,7 @@
 #include "codegen/compilation_context.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/index_scan_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
@@ -55,6 +56,19 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
     case PlanNodeType::AGGREGATE_V2: {
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      // Index scans that push a limit into the index aren't compiled
+      auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      if (scan_plan.GetLimit() || scan_plan.GetDescend()) {
+        return false;
+      }
+      for (const auto *key_expr : scan_plan.GetKeyValueExpressions()) {
+        if (!IsExpressionSupported(*key_expr)) {
+          return false;
+        }
+      }
+      break;
+    }
     case PlanNodeType::PROJECTION: {
       // TODO(pmenon): Why does this check exists?
       if (plan.GetChildren().empty()) {
@@ -72,13 +86,30 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       }
       break;
     }
-    case PlanNodeType::NESTLOOP:
+    case PlanNodeType::NESTLOOP: {
+      const auto &join = static_cast<const planner::AbstractJoinPlan &>(plan);
+      switch (join.GetJoinType()) {
+        case JoinType::INNER:
+        case JoinType::SEMI:
+        case JoinType::ANTI:
+          break;
+        default: { return false; }
+      }
+      break;
+    }
     case PlanNodeType::HASHJOIN: {
       const auto &join = static_cast<const planner::AbstractJoinPlan &>(plan);
-      // Right now, only support inner joins
-      if (join.GetJoinType() == JoinType::INNER) {
-        break;
+      switch (join.GetJoinType()) {
+        case JoinType::INNER:
+        case JoinType::LEFT:
+        case JoinType::RIGHT:
+        case JoinType::OUTER:
+        case JoinType::SEMI:
+        case JoinType::ANTI:
+          break;
+        default: { return false; }
       }
+      break;
     }
     case PlanNodeType::HASH: {
       break;
@@ -94,6 +125,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       pred = scan_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      pred = scan_plan.GetPredicate();
+      break;
+    }
     case PlanNodeType::AGGREGATE_V2: {
       auto &agg_plan = static_cast<const planner::AggregatePlan &>(plan);
       pred = agg_plan.GetPredicate();
@@ -12,6 +12,7 @@
 
 #include "codegen/runtime_functions.h"
 
+#include <atomic>
 #include <nmmintrin.h>
 
 #include "murmur3/MurmurHash3.h"
@@ -21,6 +22,7 @@
 #include "common/timer.h"
 #include "common/synchronization/count_down_latch.h"
 #include "expression/abstract_expression.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
 #include "storage/layout.h"
 #include "storage/storage_manager.h"
@@ -70,10 +72,12 @@ uint64_t RuntimeFunctions::HashCrc64(const char *buf, uint64_t length,
 }
 
 //===----------------------------------------------------------------------===//
-// Get the tile group with the given index from the table.
+// Get the tile group with the given index from the table, or NULL if the tile
+// group has been compacted and dropped.
 //
-// TODO: DataTable::GetTileGroup() returns a std::shared_ptr<> that we strip
-//       off. This means we could be touching free'd data. This must be fixed.
+// DataTable::GetTileGroup() returns a std::shared_ptr<> that we strip off. The
+// GC frees a dropped tile group only once all transactions that were active
+// when it was dropped have finished, so the pointer stays valid for the query.
 //===----------------------------------------------------------------------===//
 storage::TileGroup *RuntimeFunctions::GetTileGroup(storage::DataTable *table,
                                                    uint64_t tile_group_index) {
@@ -160,28 +164,38 @@ void RuntimeFunctions::ExecuteTableScan(
   auto *table = sm->GetTableWithOid(db_oid, table_oid);
   auto num_tilegroups = static_cast<uint32_t>(table->GetTileGroupCount());
 
-  // Determine the number of tasks to generate. In this case, we use:
-  // num_tasks := num_tile_groups / num_workers
-  uint32_t num_tasks = std::min(worker_pool.NumWorkers(), num_tilegroups);
-  uint32_t num_tilegroups_per_task = num_tilegroups / num_tasks;
+  // Split the table into morsels of a fixed number of tile groups. Morsels are
+  // handed out dynamically, so workers that finish early (e.g., because their
+  // tile groups were skipped by zone maps, or were mostly invisible) pick up
+  // more work rather than idling at the end of the pipeline.
+  auto morsel_size = static_cast<uint32_t>(settings::SettingsManager::GetInt(
+      settings::SettingId::parallel_morsel_size));
+  uint32_t num_morsels = (num_tilegroups + morsel_size - 1) / morsel_size;
+
+  // One task (and one thread state) per worker, but never more tasks than
+  // morsels. Each task runs the pipeline over all the morsels it grabs using
+  // the same thread state, so thread-local state is only merged once per
+  // worker at the end of the pipeline.
+  uint32_t num_tasks = std::min(worker_pool.NumWorkers(), num_morsels);
 
   // Allocate states for each task
   thread_states.Allocate(num_tasks);
 
+  if (num_tasks == 0) {
+    return;
+  }
+
   // Create count down latch
   common::synchronization::CountDownLatch latch{num_tasks};
 
+  // The first morsel of every task is assigned statically so that all thread
+  // states are initialized. The rest are claimed through this counter.
+  std::atomic<uint32_t> next_morsel{num_tasks};
+
   // Now, submit the tasks
   for (uint32_t task_id = 0; task_id < num_tasks; task_id++) {
-    bool last_task = (task_id == num_tasks - 1);
-    auto tilegroup_start = task_id * num_tilegroups_per_task;
-    auto tilegroup_stop =
-        last_task ? num_tilegroups : tilegroup_start + num_tilegroups_per_task;
-    auto work = [&query_state, &thread_states, &scanner, &latch, task_id,
-                 tilegroup_start, tilegroup_stop]() {
-      LOG_DEBUG("Task-%u scanning tile groups [%u-%u)", task_id,
-                tilegroup_start, tilegroup_stop);
-
+    auto work = [&query_state, &thread_states, &scanner, &latch, &next_morsel,
+                 task_id, morsel_size, num_morsels, num_tilegroups]() {
       // Time this
       Timer<std::milli> timer;
       timer.Start();
@@ -189,18 +203,30 @@ void RuntimeFunctions::ExecuteTableScan(
       // Pull out this task's thread state
       auto thread_state = thread_states.AccessThreadState(task_id);
 
-      // Invoke scan function
-      scanner(query_state, thread_state, tilegroup_start, tilegroup_stop);
+      // Invoke scan function on each morsel we can grab
+      uint32_t num_processed = 0;
+      for (uint32_t morsel = task_id; morsel < num_morsels;
+           morsel = next_morsel.fetch_add(1)) {
+        auto tilegroup_start = morsel * morsel_size;
+        auto tilegroup_stop =
+            std::min(tilegroup_start + morsel_size, num_tilegroups);
+        LOG_TRACE("Task-%u scanning tile groups [%u-%u)", task_id,
+                  tilegroup_start, tilegroup_stop);
+        scanner(query_state, thread_state, tilegroup_start, tilegroup_stop);
+        num_processed++;
+      }
 
       // Count down latch
       latch.CountDown();
 
       // Log stuff
       timer.Stop();
-      LOG_DEBUG("Task-%u done scanning (%.2lf ms) ...", task_id,
-                timer.GetDuration());
+      LOG_DEBUG("Task-%u done scanning %u morsels (%.2lf ms) ...", task_id,
+                num_processed, timer.GetDuration());
     };
-    worker_pool.SubmitTask(work);
+    // Spread the tasks over the workers up front rather than relying on
+    // stealing to balance them
+    worker_pool.SubmitTask(work, task_id);
   }
 
   // Wait for everything to finish
@@ -218,7 +244,8 @@ void RuntimeFunctions::ExecutePerState(
   uint32_t num_tasks = thread_states.NumThreads();
   common::synchronization::CountDownLatch latch{num_tasks};
 
-  // Loop over states
+  // Loop over states. Each state preferably goes to the worker that filled it
+  // in the scan, whose cache may still hold it.
   for (uint32_t tid = 0; tid < num_tasks; tid++) {
     worker_pool.SubmitTask(
         [&query_state, &work_func, &thread_states, &latch, tid]() {
@@ -240,7 +267,8 @@ void RuntimeFunctions::ExecutePerState(
           timer.Stop();
           LOG_DEBUG("Finished processing thread state %u (%.2lf ms) ...", tid,
                     timer.GetDuration());
-        });
+        },
+        tid);
   }
 
   // Wait for all tasks to complete
@@ -42,6 +42,14 @@ void Sorter::Init(CodeGen &codegen, llvm::Value *sorter_ptr,
                {sorter_ptr, executor_ctx, comparison_func, tuple_size});
 }
 
+void Sorter::UseNormalizedKeys(CodeGen &codegen, llvm::Value *sorter_ptr,
+                               llvm::Value *normalize_func, uint32_t key_size,
+                               bool key_is_exact) const {
+  codegen.Call(SorterProxy::UseNormalizedKeys,
+               {sorter_ptr, normalize_func, codegen.Const32(key_size),
+                codegen.ConstBool(key_is_exact)});
+}
+
 void Sorter::StoreTuple(CodeGen &codegen, llvm::Value *sorter_ptr,
                         const std::vector<codegen::Value> &tuple) const {
   // First, call Sorter::StoreInputTuple() to get a handle to a contiguous
@@ -140,30 +148,48 @@ void Sorter::Iterate(CodeGen &codegen, llvm::Value *sorter_ptr,
 void Sorter::VectorizedIterate(
     CodeGen &codegen, llvm::Value *sorter_ptr, uint32_t vector_size,
     uint64_t offset, Sorter::VectorizedIterateCallback &callback) const {
-  llvm::Value *start_pos = codegen.Load(SorterProxy::tuples_start, sorter_ptr);
-  llvm::Value *num_tuples = NumTuples(codegen, sorter_ptr);
-  num_tuples = codegen->CreateTrunc(num_tuples, codegen.Int32Type());
-
-  if (offset != 0) {
-    start_pos = codegen->CreateConstInBoundsGEP1_32(codegen.CharPtrType(),
-                                                    start_pos, offset);
-    num_tuples = codegen->CreateSub(num_tuples, codegen.Const32(offset));
-  }
-
-  lang::VectorizedLoop loop(codegen, num_tuples, vector_size, {});
+  // The sorted tuples are produced in batches, a single one unless the sort
+  // spilled to disk. The offset applies to the first batch only.
+  llvm::Value *first_batch = codegen.ConstBool(true);
+  lang::Loop batch_loop(codegen,
+                        codegen.Call(SorterProxy::NextBatch, {sorter_ptr}),
+                        {{"firstBatch", first_batch}});
   {
-    // Current loop range
-    auto curr_range = loop.GetCurrentRange();
+    first_batch = batch_loop.GetLoopVar(0);
+
+    llvm::Value *start_pos =
+        codegen.Load(SorterProxy::tuples_start, sorter_ptr);
+    llvm::Value *num_tuples = NumTuples(codegen, sorter_ptr);
+    num_tuples = codegen->CreateTrunc(num_tuples, codegen.Int32Type());
+
+    if (offset != 0) {
+      auto *skip = codegen->CreateSelect(first_batch, codegen.Const32(offset),
+                                         codegen.Const32(0));
+      skip = codegen->CreateSelect(
+          codegen->CreateICmpULT(skip, num_tuples), skip, num_tuples);
+      start_pos = codegen->CreateInBoundsGEP(codegen.CharPtrType(), start_pos,
+                                             skip);
+      num_tuples = codegen->CreateSub(num_tuples, skip);
+    }
+
+    lang::VectorizedLoop loop(codegen, num_tuples, vector_size, {});
+    {
+      // Current loop range
+      auto curr_range = loop.GetCurrentRange();
 
-    // Provide an accessor into the sorted space
-    SorterAccess sorter_access(*this, start_pos);
+      // Provide an accessor into the sorted space
+      SorterAccess sorter_access(*this, start_pos);
 
-    // Issue the callback
-    callback.ProcessEntries(codegen, curr_range.start, curr_range.end,
-                            sorter_access);
+      // Issue the callback
+      callback.ProcessEntries(codegen, curr_range.start, curr_range.end,
+                              sorter_access);
+
+      // That's it
+      loop.LoopEnd(codegen, {});
+    }
 
-    // That's it
-    loop.LoopEnd(codegen, {});
+    batch_loop.LoopEnd(codegen.Call(SorterProxy::NextBatch, {sorter_ptr}),
+                       {codegen.ConstBool(false)});
   }
 }
 
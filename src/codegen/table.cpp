@@ -40,9 +40,10 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                       {table_ptr, tile_group_id});
 }
 
-// We acquire a Zone Map manager instance
-llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
-  return codegen.Call(ZoneMapManagerProxy::GetInstance, {});
+// We acquire the table's in-memory zone map by calling
+// DataTable::GetZoneMap(...)
+llvm::Value *Table::GetZoneMap(CodeGen &codegen, llvm::Value *table_ptr) const {
+  return codegen.Call(DataTableProxy::GetZoneMap, {table_ptr});
 }
 
 // Generate a scan over all tile groups.
@@ -52,13 +53,15 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 //     table.GetSchema().GetColumnCount())
 // predicate_array := alloca<peloton::PredicateInfo>(
 //     num_predicates)
+// zone_map := GetZoneMap(table_ptr)
 //
 // oid_t tile_group_idx := 0
 // num_tile_groups = GetTileGroupCount(table_ptr)
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
-//   if (ShouldScanTileGroup(predicate_array, tile_group_idx)) {
-//      tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
+//   tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
+//   if (tile_group_ptr != nullptr &&
+//       zone_map.ShouldScanTileGroup(predicate_array, tile_group_idx)) {
 //      consumer.TileGroupStart(tile_group_ptr);
 //      tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
 //                         consumer);
@@ -67,6 +70,8 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 // }
 //
 // @endcode
+//
+// The zone map check is left out entirely if there are no predicates to check.
 void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                          llvm::Value *tilegroup_start,
                          llvm::Value *tilegroup_end, uint32_t batch_size,
@@ -79,13 +84,14 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
       ColumnLayoutInfoProxy::GetType(codegen), num_columns, "columnLayout");
 
   // Allocate some space for the parsed predicates (if need be!)
-  llvm::Value *predicate_array =
-      codegen.NullPtr(PredicateInfoProxy::GetType(codegen)->getPointerTo());
+  llvm::Value *predicate_array = nullptr;
+  llvm::Value *zone_map = nullptr;
   if (num_predicates != 0) {
     predicate_array = codegen.AllocateBuffer(
         PredicateInfoProxy::GetType(codegen), num_predicates, "predicateInfo");
     codegen.Call(RuntimeFunctionsProxy::FillPredicateArray,
                  {predicate_ptr, predicate_array});
+    zone_map = GetZoneMap(codegen, table_ptr);
   }
 
   // Get the number of tile groups in the given table
@@ -103,28 +109,39 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
     tile_group_idx = loop.GetLoopVar(0);
     llvm::Value *tile_group_ptr =
         GetTileGroup(codegen, table_ptr, tile_group_idx);
-    llvm::Value *tile_group_id =
-        tile_group_.GetTileGroupId(codegen, tile_group_ptr);
-
-    // Check zone map
-    llvm::Value *cond = codegen.Call(
-        ZoneMapManagerProxy::ShouldScanTileGroup,
-        {GetZoneMapManager(codegen), predicate_array,
-         codegen.Const32(num_predicates), table_ptr, tile_group_idx});
 
-    codegen::lang::If should_scan_tilegroup{codegen, cond};
+    // Skip the tile groups that have been compacted and freed
+    codegen::lang::If tile_group_exists{
+        codegen, codegen->CreateIsNotNull(tile_group_ptr)};
     {
-      // Inform the consumer that we're starting iteration over the tile group
-      consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
-
-      // Generate the scan cover over the given tile group
-      tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
-                                  batch_size, consumer);
-
-      // Inform the consumer that we've finished iteration over the tile group
-      consumer.TileGroupFinish(codegen, tile_group_ptr);
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
+
+      // Check zone map
+      llvm::Value *cond = codegen.ConstBool(true);
+      if (num_predicates != 0) {
+        cond = codegen.Call(ZoneMapProxy::ShouldScanTileGroup,
+                            {zone_map, predicate_array,
+                             codegen.Const32(num_predicates), tile_group_idx});
+      }
+
+      codegen::lang::If should_scan_tilegroup{codegen, cond};
+      {
+        // Inform the consumer that we're starting iteration over the tile
+        // group
+        consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
+
+        // Generate the scan cover over the given tile group
+        tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
+                                    batch_size, consumer);
+
+        // Inform the consumer that we've finished iteration over the tile
+        // group
+        consumer.TileGroupFinish(codegen, tile_group_ptr);
+      }
+      should_scan_tilegroup.EndIf();
     }
-    should_scan_tilegroup.EndIf();
+    tile_group_exists.EndIf();
 
     // Move to next tile group in the table
     tile_group_idx = codegen->CreateAdd(tile_group_idx, codegen.Const64(1));
@@ -65,6 +65,28 @@ void TileGroup::GenerateTidScan(CodeGen &codegen, llvm::Value *tile_group_ptr,
   }
 }
 
+// This method generates code that hands the consumer access to the tuples
+// with TIDs in the range [tid_start, tid_end) of the provided tile group.
+//
+// @code
+// col_layouts := GetColumnLayouts(tile_group_ptr, column_layouts)
+// ProcessTuples(tid_start, tid_end, tile_group_ptr);
+// @endcode
+//
+void TileGroup::GenerateTidRangeAccess(CodeGen &codegen,
+                                       llvm::Value *tile_group_ptr,
+                                       llvm::Value *column_layouts,
+                                       llvm::Value *tid_start,
+                                       llvm::Value *tid_end,
+                                       ScanCallback &consumer) const {
+  // Get the column layouts
+  auto col_layouts = GetColumnLayouts(codegen, tile_group_ptr, column_layouts);
+
+  // Pass the range to the consumer
+  TileGroupAccess tile_group_access{*this, col_layouts};
+  consumer.ProcessTuples(codegen, tid_start, tid_end, tile_group_access);
+}
+
 // Call TileGroup::GetNextTupleSlot(...) to determine # of tuples in tile group.
 llvm::Value *TileGroup::GetNumTuples(CodeGen &codegen,
                                      llvm::Value *tile_group) const {
@@ -29,6 +29,7 @@
 #include "codegen/operator/hash_group_by_translator.h"
 #include "codegen/operator/hash_join_translator.h"
 #include "codegen/operator/hash_translator.h"
+#include "codegen/operator/index_scan_translator.h"
 #include "codegen/operator/insert_translator.h"
 #include "codegen/operator/limit_translator.h"
 #include "codegen/operator/order_by_translator.h"
@@ -48,6 +49,7 @@
 #include "planner/delete_plan.h"
 #include "planner/hash_join_plan.h"
 #include "planner/hash_plan.h"
+#include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/limit_plan.h"
 #include "planner/nested_loop_join_plan.h"
@@ -72,6 +74,11 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new TableScanTranslator(scan, context, pipeline);
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan = static_cast<const planner::IndexScanPlan &>(plan_node);
+      translator = new IndexScanTranslator(scan, context, pipeline);
+      break;
+    }
     case PlanNodeType::CSVSCAN: {
       auto &scan = static_cast<const planner::CSVScanPlan &>(plan_node);
       translator = new CSVScanTranslator(scan, context, pipeline);
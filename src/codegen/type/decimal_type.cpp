@@ -139,12 +139,14 @@ struct CompareDecimal : public TypeSystem::SimpleComparisonHandleNull {
 
   Value CompareForSortImpl(CodeGen &codegen, const Value &left,
                            const Value &right) const override {
-    // For integer comparisons, just subtract left from right and cast the
-    // result to a 32-bit value
-    llvm::Value *diff = codegen->CreateFSub(left.GetValue(), right.GetValue());
-    return Value{Integer::Instance(),
-                 codegen->CreateFPToSI(diff, codegen.Int32Type()), nullptr,
-                 nullptr};
+    // Return (left > right) - (left < right). Truncating the difference of the
+    // values would treat values less than one apart as equal.
+    auto *gt = codegen->CreateFCmpOGT(left.GetValue(), right.GetValue());
+    auto *lt = codegen->CreateFCmpOLT(left.GetValue(), right.GetValue());
+    llvm::Value *result =
+        codegen->CreateSub(codegen->CreateZExt(gt, codegen.Int32Type()),
+                           codegen->CreateZExt(lt, codegen.Int32Type()));
+    return Value{Integer::Instance(), result, nullptr, nullptr};
   }
 };
 
@@ -164,10 +164,14 @@ struct CompareInteger : public TypeSystem::SimpleComparisonHandleNull {
 
   Value CompareForSortImpl(CodeGen &codegen, const Value &left,
                            const Value &right) const override {
-    // For integer comparisons, just subtract left from right and cast the
-    // result to a 32-bit value
-    llvm::Value *diff = codegen->CreateSub(left.GetValue(), right.GetValue());
-    return Value{Integer::Instance(), diff, nullptr, nullptr};
+    // Return (left > right) - (left < right). Subtracting the values instead
+    // overflows for values far apart.
+    auto *gt = codegen->CreateICmpSGT(left.GetValue(), right.GetValue());
+    auto *lt = codegen->CreateICmpSLT(left.GetValue(), right.GetValue());
+    llvm::Value *result =
+        codegen->CreateSub(codegen->CreateZExt(gt, codegen.Int32Type()),
+                           codegen->CreateZExt(lt, codegen.Int32Type()));
+    return Value{Integer::Instance(), result, nullptr, nullptr};
   }
 };
 
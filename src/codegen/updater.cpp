@@ -20,6 +20,7 @@
 #include "storage/tile_group.h"
 #include "storage/tile.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 #include "type/abstract_pool.h"
 #include "common/internal_types.h"
 #include "type/value.h"
@@ -139,6 +140,8 @@ void Updater::Update() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   // Either update in-place
   if (is_owner_ == true) {
+    ContainerTuple<storage::TileGroup> tuple(tile_group, old_location_.offset);
+    table_->GetZoneMap()->UpdateOnUpdate(old_location_.block, tuple);
     txn_manager.PerformUpdate(txn, old_location_);
     // we do not need to add any item pointer to statement-level write set
     // here, because we do not generate any new version
@@ -31,6 +31,9 @@ CSVScanner::CSVScanner(peloton::type::AbstractPool &pool,
     : memory_(pool),
       file_path_(file_path),
       file_(),
+      input_(nullptr),
+      input_len_(0),
+      input_pos_(0),
       buffer_(nullptr),
       buffer_pos_(0),
       buffer_end_(0),
@@ -83,6 +86,12 @@ void CSVScanner::Init(CSVScanner &scanner,
   new (&scanner)
       CSVScanner(*executor_context.GetPool(), file_path, col_types, num_cols,
                  func, opaque_state, delimiter, quote, escape);
+
+  // Without a file, we're loading the rows the client sent with COPY FROM STDIN
+  const auto *copy_input = executor_context.GetCopyInput();
+  if (file_path[0] == '\0' && copy_input != nullptr) {
+    scanner.SetInput(copy_input->data(), copy_input->size());
+  }
 }
 
 void CSVScanner::Destroy(CSVScanner &scanner) {
@@ -90,6 +99,12 @@ void CSVScanner::Destroy(CSVScanner &scanner) {
   scanner.~CSVScanner();
 }
 
+void CSVScanner::SetInput(const char *data, uint64_t len) {
+  input_ = data;
+  input_len_ = len;
+  input_pos_ = 0;
+}
+
 void CSVScanner::Produce() {
   // Initialize
   Initialize();
@@ -101,20 +116,23 @@ void CSVScanner::Produce() {
 }
 
 void CSVScanner::Initialize() {
-  // Let's first perform a few validity checks
-  boost::filesystem::path path(file_path_);
-
-  if (!boost::filesystem::exists(path)) {
-    throw ExecutorException(StringUtil::Format("input path '%s' does not exist",
-                                               file_path_.c_str()));
-  } else if (!boost::filesystem::is_regular_file(file_path_)) {
-    auto msg =
-        StringUtil::Format("unable to read file '%s'", file_path_.c_str());
-    throw ExecutorException(msg);
-  }
+  // In-memory input needs no file
+  if (input_ == nullptr) {
+    // Let's first perform a few validity checks
+    boost::filesystem::path path(file_path_);
+
+    if (!boost::filesystem::exists(path)) {
+      throw ExecutorException(StringUtil::Format(
+          "input path '%s' does not exist", file_path_.c_str()));
+    } else if (!boost::filesystem::is_regular_file(file_path_)) {
+      auto msg =
+          StringUtil::Format("unable to read file '%s'", file_path_.c_str());
+      throw ExecutorException(msg);
+    }
 
-  // The path looks okay, let's try opening it
-  file_.Open(file_path_, peloton::util::File::AccessMode::ReadOnly);
+    // The path looks okay, let's try opening it
+    file_.Open(file_path_, peloton::util::File::AccessMode::ReadOnly);
+  }
 
   // Allocate buffer space
   buffer_ = static_cast<char *>(memory_.Allocate(kDefaultBufferSize));
@@ -132,7 +150,15 @@ void CSVScanner::Initialize() {
 bool CSVScanner::NextBuffer() {
   // Do read
   buffer_pos_ = 0;
-  buffer_end_ = static_cast<uint32_t>(file_.Read(buffer_, kDefaultBufferSize));
+  if (input_ != nullptr) {
+    buffer_end_ = static_cast<uint32_t>(
+        std::min<uint64_t>(kDefaultBufferSize, input_len_ - input_pos_));
+    PELOTON_MEMCPY(buffer_, input_ + input_pos_, buffer_end_);
+    input_pos_ += buffer_end_;
+  } else {
+    buffer_end_ =
+        static_cast<uint32_t>(file_.Read(buffer_, kDefaultBufferSize));
+  }
 
   // Update stats
   stats_.num_reads++;
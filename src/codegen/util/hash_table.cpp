@@ -12,7 +12,15 @@
 
 #include "codegen/util/hash_table.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "common/logger.h"
 #include "common/platform.h"
+#include "common/synchronization/count_down_latch.h"
+#include "common/timer.h"
+#include "threadpool/mono_queue_pool.h"
 #include "type/abstract_pool.h"
 
 namespace peloton {
@@ -22,6 +30,11 @@ namespace util {
 static const uint32_t kDefaultNumElements = 256;
 static const uint32_t kNumBlockElems = 1024;
 
+// The size (in bytes) of the directory range covered by one partition in a
+// partitioned build, and the maximum number of partitions (i.e., fan-out)
+static const uint64_t kPartitionSize = 256 * 1024;
+static const uint32_t kMaxPartitions = 1024;
+
 static_assert((kDefaultNumElements & (kDefaultNumElements - 1)) == 0,
               "Default number of elements must be a power of two");
 
@@ -76,6 +89,28 @@ HashTable::Entry *HashTable::EntryBuffer::NextFree() {
   return entry;
 }
 
+void HashTable::EntryBuffer::Reset() {
+  // Free all but the current block
+  if (block_ == nullptr) {
+    block_ = reinterpret_cast<MemoryBlock *>(memory_.Allocate(BlockSize()));
+    block_->next = nullptr;
+  }
+  MemoryBlock *block = block_->next;
+  while (block != nullptr) {
+    MemoryBlock *next = block->next;
+    memory_.Free(block);
+    block = next;
+  }
+  block_->next = nullptr;
+
+  next_entry_ = block_->data;
+  available_bytes_ = BlockSize() - sizeof(MemoryBlock);
+}
+
+uint64_t HashTable::EntryBuffer::BlockSize() const {
+  return sizeof(MemoryBlock) + (entry_size_ * kNumBlockElems);
+}
+
 void HashTable::EntryBuffer::TransferMemoryBlocks(
     HashTable::EntryBuffer &target) {
   // Find end of our memory block chain
@@ -114,7 +149,8 @@ HashTable::HashTable(::peloton::type::AbstractPool &memory, uint32_t key_size,
       directory_mask_(0),
       entry_buffer_(memory, Entry::Size(key_size, value_size)),
       num_elems_(0),
-      capacity_(kDefaultNumElements) {
+      capacity_(kDefaultNumElements),
+      spill_(nullptr) {
   // Upon creation, we allocate room for kDefaultNumElements in the hash table.
   // We assume 50% load factor on the directory, thus the directory size is
   // twice the number of elements.
@@ -133,6 +169,11 @@ HashTable::~HashTable() {
     memory_.Free(directory_);
     directory_ = nullptr;
   }
+
+  // Thread-local tables share the spill partitions of their global table
+  if (spill_ != nullptr && spill_->Owner() == this) {
+    delete spill_;
+  }
 }
 
 void HashTable::Init(HashTable &table, executor::ExecutorContext &exec_ctx,
@@ -147,6 +188,17 @@ char *HashTable::InsertLazy(uint64_t hash) {
   // from storage. It is assumed that actual construction of the hash table is
   // done by a subsequent call to BuildLazy() only after ALL lazy insertions
   // have completed.
+  //
+  // If the table is bound to the memory limit and allocating another block of
+  // entries would exceed it, all entries inserted so far are spilled first.
+  if (entry_buffer_.IsFull() && ShouldSpill()) {
+    SpillLazy();
+  }
+
+  return AppendLazy(hash);
+}
+
+char *HashTable::AppendLazy(uint64_t hash) {
   auto *entry = entry_buffer_.NextFree();
   entry->hash = hash;
 
@@ -191,9 +243,21 @@ char *HashTable::Insert(uint64_t hash) {
 }
 
 void HashTable::BuildLazy() {
+  // If the table spilled, spill the remaining entries too, and build the first
+  // pass over the spilled partitions instead
+  if (spill_ != nullptr && spill_->HasSpilled()) {
+    SpillLazy();
+    LoadPass();
+    return;
+  }
+
   // Early exit if no elements have been added (hash table is still valid)
   if (num_elems_ == 0) return;
 
+  BuildDirectory();
+}
+
+void HashTable::BuildDirectory() {
   // Grab entry head
   Entry *head = directory_[0];
 
@@ -239,11 +303,16 @@ void HashTable::ReserveLazy(
 
   // Perfectly size the hash table
   num_elems_ = 0;
-  capacity_ = NextPowerOf2(total_size);
+  capacity_ = NextPowerOf2(std::max<uint64_t>(total_size, 1));
 
   directory_size_ = capacity_ * 2;
   directory_mask_ = directory_size_ - 1;
 
+  // Clean up old directory
+  if (directory_ != nullptr) {
+    memory_.Free(directory_);
+  }
+
   uint64_t alloc_size = sizeof(Entry *) * directory_size_;
   directory_ = static_cast<Entry **>(memory_.Allocate(alloc_size));
   PELOTON_MEMSET(directory_, 0, alloc_size);
@@ -279,6 +348,263 @@ void HashTable::MergeLazyUnfinished(HashTable &other) {
   other.entry_buffer_.TransferMemoryBlocks(entry_buffer_);
 }
 
+// The build works as follows. We first size the directory to accommodate the
+// entries in all N thread-local tables. We then split the directory into P
+// partitions, each covering a contiguous range of slots. P is chosen such that
+// the slots of a partition fit into cache. In the first phase, each
+// thread-local table is scanned (in parallel) and its entries are chained into
+// one of P thread-local partition lists based on the high bits of their slot.
+// In the second phase, each partition is built by a single thread by inserting
+// the entries of that partition from all N thread-local tables. Since the
+// partitions cover disjoint ranges of the directory, no synchronization is
+// needed, and all writes of a partition hit the same few cache lines.
+void HashTable::BuildLazyPartitioned(
+    const executor::ExecutorContext::ThreadStates &thread_states,
+    uint32_t hash_table_offset) {
+  // Collect all thread-local tables
+  std::vector<HashTable *> tables;
+  thread_states.ForEach<HashTable>(
+      hash_table_offset, [&tables](HashTable *table) {
+        tables.push_back(table);
+      });
+
+  // If a thread-local table spilled, spill the entries of all of them, and
+  // build the first pass over the spilled partitions instead
+  if (spill_ != nullptr && spill_->HasSpilled()) {
+    for (auto *table : tables) {
+      if (table->spill_ != nullptr) {
+        table->SpillLazy();
+      }
+    }
+    LoadPass();
+    return;
+  }
+
+  // Perfectly size the directory
+  ReserveLazy(thread_states, hash_table_offset);
+
+  // Determine the number of partitions
+  uint64_t slots_per_partition =
+      std::min(directory_size_, kPartitionSize / sizeof(Entry *));
+  auto num_partitions =
+      static_cast<uint32_t>(std::min(directory_size_ / slots_per_partition,
+                                     static_cast<uint64_t>(kMaxPartitions)));
+  uint32_t partition_shift = static_cast<uint32_t>(
+      CountLeadingZeroes(num_partitions) - CountLeadingZeroes(directory_size_));
+
+  // The head and tail of the list of entries in each thread-local partition.
+  // The lists of the t-th table start at index (t * num_partitions).
+  std::vector<Entry *> heads(tables.size() * num_partitions, nullptr);
+  std::vector<Entry *> tails(tables.size() * num_partitions, nullptr);
+
+  // The worker pool we use to execute parallel work
+  auto &work_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 1 - Partition each thread-local table in parallel
+  ////////////////////////////////////////////////////////////////////
+  {
+    common::synchronization::CountDownLatch latch(tables.size());
+    for (uint32_t table_idx = 0; table_idx < tables.size(); table_idx++) {
+      work_pool.SubmitTask([this, &tables, &heads, &tails, &latch, table_idx,
+                            num_partitions, partition_shift]() {
+        Entry **part_heads = heads.data() + (table_idx * num_partitions);
+        Entry **part_tails = tails.data() + (table_idx * num_partitions);
+
+        // The entries are chained through the first directory slot
+        Entry *entry = tables[table_idx]->directory_[0];
+        while (entry != nullptr) {
+          Entry *next = entry->next;
+          uint64_t part = (entry->hash & directory_mask_) >> partition_shift;
+          entry->next = nullptr;
+          if (part_heads[part] == nullptr) {
+            part_heads[part] = entry;
+          } else {
+            part_tails[part]->next = entry;
+          }
+          part_tails[part] = entry;
+          entry = next;
+        }
+
+        latch.CountDown();
+      });
+    }
+    latch.Await(0);
+  }
+
+  timer.Stop();
+  LOG_DEBUG("Partitioned %zu thread-local tables into %u partitions: %.2lf ms",
+            tables.size(), num_partitions, timer.GetDuration());
+  timer.Reset();
+  timer.Start();
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 2 - Build each partition of the directory in parallel
+  ////////////////////////////////////////////////////////////////////
+  {
+    // Partitions are claimed dynamically, so skewed partitions don't stall
+    // the build
+    auto num_tasks = std::min(num_partitions, work_pool.NumWorkers());
+    std::atomic<uint32_t> next_partition{0};
+    common::synchronization::CountDownLatch latch(num_tasks);
+    for (uint32_t task = 0; task < num_tasks; task++) {
+      work_pool.SubmitTask([this, &tables, &heads, &next_partition, &latch,
+                            num_partitions]() {
+        for (uint32_t part = next_partition.fetch_add(1);
+             part < num_partitions; part = next_partition.fetch_add(1)) {
+          for (uint32_t table_idx = 0; table_idx < tables.size();
+               table_idx++) {
+            Entry *entry = heads[(table_idx * num_partitions) + part];
+            while (entry != nullptr) {
+              Entry *next = entry->next;
+              uint64_t index = entry->hash & directory_mask_;
+              entry->next = directory_[index];
+              directory_[index] = entry;
+              entry = next;
+            }
+          }
+        }
+        latch.CountDown();
+      });
+    }
+    latch.Await(0);
+  }
+
+  timer.Stop();
+  LOG_DEBUG("Built %u partitions: %.2lf ms", num_partitions,
+            timer.GetDuration());
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 3 - Transfer ownership of thread-local memory
+  ////////////////////////////////////////////////////////////////////
+  for (auto *table : tables) {
+    num_elems_ += table->NumElements();
+    table->directory_[0] = table->directory_[1] = nullptr;
+    table->num_elems_ = table->capacity_ = 0;
+    table->entry_buffer_.TransferMemoryBlocks(entry_buffer_);
+  }
+}
+
+void HashTable::EnableSpilling(HashTable &table,
+                               executor::ExecutorContext &exec_ctx,
+                               HashTable *owner) {
+  PELOTON_ASSERT(table.num_elems_ == 0);
+  PELOTON_ASSERT(&table.memory_ == exec_ctx.GetPool());
+
+  // Spill records are the hash, key and value of an entry
+  if (owner == &table) {
+    uint32_t record_size = table.entry_buffer_.EntrySize() -
+                           sizeof(Entry) + sizeof(uint64_t);
+    table.spill_ = new SpillPartitions(exec_ctx, record_size, &table);
+  } else {
+    table.spill_ = owner->spill_;
+  }
+}
+
+bool HashTable::NextPass() {
+  // A table that didn't spill was entirely built in the first pass
+  if (spill_ == nullptr || !spill_->HasPending()) {
+    return false;
+  }
+  return LoadPass();
+}
+
+bool HashTable::ShouldSpill() const {
+  return spill_ != nullptr && spill_->CanSpill() &&
+         spill_->ExceedsMemoryLimit(entry_buffer_.BlockSize());
+}
+
+void HashTable::SpillLazy() {
+  PELOTON_ASSERT(spill_ != nullptr);
+
+  LOG_DEBUG("Spilling hash table with %" PRIu64 " entries", num_elems_);
+
+  // The entries are chained through the first directory slot
+  SpillPartitions::Writer writer{*spill_};
+  for (Entry *entry = directory_[0]; entry != nullptr; entry = entry->next) {
+    writer.Append(entry->hash, entry->data);
+  }
+  writer.Finish();
+
+  directory_[0] = directory_[1] = nullptr;
+  num_elems_ = 0;
+  entry_buffer_.Reset();
+}
+
+void HashTable::ResetLazy() {
+  entry_buffer_.Reset();
+  num_elems_ = 0;
+  capacity_ = kDefaultNumElements;
+
+  memory_.Free(directory_);
+  directory_size_ = capacity_ * 2;
+  directory_mask_ = directory_size_ - 1;
+
+  uint64_t alloc_size = sizeof(Entry *) * directory_size_;
+  directory_ = static_cast<Entry **>(memory_.Allocate(alloc_size));
+  PELOTON_MEMSET(directory_, 0, alloc_size);
+}
+
+bool HashTable::LoadPass() {
+  // Drop the entries of the previous pass. The spilled partitions are now
+  // complete, and wait to be processed.
+  ResetLazy();
+  spill_->TakeFiles();
+
+  uint32_t entry_size = entry_buffer_.EntrySize();
+  uint32_t record_size = spill_->RecordSize();
+  uint64_t payload_size = record_size - sizeof(uint64_t);
+
+  uint32_t num_loaded = 0;
+  uint64_t loaded_bytes = 0;
+  while (spill_->HasPending()) {
+    // The memory the entries of the partition and their directory slots take
+    const auto &next = spill_->NextPending();
+    uint64_t bytes = (next.file->Size() / record_size) *
+                     (entry_size + 2 * sizeof(Entry *));
+    if (spill_->ExceedsMemoryLimit(loaded_bytes + bytes)) {
+      if (num_loaded > 0) {
+        // The partition is left for the next pass
+        break;
+      }
+      if (next.level + 1 < SpillPartitions::kMaxLevel) {
+        // The partition doesn't fit on its own, split it
+        spill_->Split(spill_->PopPending());
+        continue;
+      }
+    }
+
+    auto partition = spill_->PopPending();
+    std::vector<char> records(kNumBlockElems * record_size);
+    partition.file->Rewind();
+    uint64_t read;
+    while ((read = partition.file->Read(records.data(), records.size())) > 0) {
+      for (uint64_t pos = 0; pos + record_size <= read; pos += record_size) {
+        uint64_t hash;
+        PELOTON_MEMCPY(&hash, &records[pos], sizeof(uint64_t));
+        PELOTON_MEMCPY(AppendLazy(hash), &records[pos + sizeof(uint64_t)],
+                       payload_size);
+      }
+    }
+
+    num_loaded++;
+    loaded_bytes += bytes;
+  }
+
+  if (num_loaded == 0) {
+    return false;
+  }
+
+  LOG_DEBUG("Loaded %u spilled partitions with %" PRIu64 " entries",
+            num_loaded, num_elems_);
+  spill_->AddPass();
+  BuildDirectory();
+  return true;
+}
+
 void HashTable::Resize() {
   // Sanity check
   PELOTON_ASSERT(NeedsResize());
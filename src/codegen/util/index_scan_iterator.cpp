@@ -0,0 +1,243 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_iterator.cpp
+//
+// Identification: src/codegen/util/index_scan_iterator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/index_scan_iterator.h"
+
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "concurrency/transaction_context.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "index/index.h"
+#include "index/scan_optimizer.h"
+#include "storage/data_table.h"
+#include "storage/masked_tuple.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+IndexScanIterator::IndexScanIterator(storage::DataTable &table,
+                                     oid_t index_oid,
+                                     const uint32_t *key_column_ids,
+                                     const int32_t *expr_types,
+                                     uint32_t num_keys,
+                                     uint32_t max_batch_size)
+    : table_(table),
+      index_(table.GetIndexWithOid(index_oid)),
+      key_column_ids_(key_column_ids, key_column_ids + num_keys),
+      recheck_key_(false),
+      key_values_(num_keys),
+      max_batch_size_(max_batch_size) {
+  PELOTON_ASSERT(index_ != nullptr);
+  PELOTON_ASSERT(max_batch_size_ > 0);
+
+  expr_types_.reserve(num_keys);
+  for (uint32_t i = 0; i < num_keys; i++) {
+    expr_types_.push_back(static_cast<ExpressionType>(expr_types[i]));
+  }
+
+  // Entries in a secondary index point to the head of the version chain of
+  // the tuple that was inserted with the key, but a later version may have
+  // changed the key. The index also includes the boundaries of open ranges.
+  // In both cases, the visible version must be compared with the key again.
+  recheck_key_ = (index_->GetIndexType() != IndexConstraintType::PRIMARY_KEY);
+  for (auto expr_type : expr_types_) {
+    if (expr_type != ExpressionType::COMPARE_EQUAL &&
+        expr_type != ExpressionType::COMPARE_LESSTHANOREQUALTO &&
+        expr_type != ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
+      recheck_key_ = true;
+    }
+  }
+}
+
+void IndexScanIterator::Init(IndexScanIterator &iterator,
+                             storage::DataTable &table, uint32_t index_oid,
+                             const uint32_t *key_column_ids,
+                             const int32_t *expr_types, uint32_t num_keys,
+                             uint32_t max_batch_size) {
+  new (&iterator) IndexScanIterator(table, index_oid, key_column_ids,
+                                    expr_types, num_keys, max_batch_size);
+}
+
+void IndexScanIterator::Destroy(IndexScanIterator &iterator) {
+  iterator.~IndexScanIterator();
+}
+
+void IndexScanIterator::Scan(concurrency::TransactionContext &txn) {
+  locations_.clear();
+  batches_.clear();
+
+  std::vector<peloton::type::Value> values;
+  if (PrepareScanKey(values)) {
+    // Probe the index
+    std::vector<ItemPointer *> entries;
+    if (key_column_ids_.empty()) {
+      index_->ScanAllKeys(entries);
+    } else {
+      index::ConjunctionScanPredicate predicate{index_.get(), values,
+                                                key_column_ids_, expr_types_};
+      index_->Scan(values, key_column_ids_, expr_types_,
+                   ScanDirectionType::FORWARD, entries, &predicate);
+    }
+
+    // Find the visible version of every tuple the index returned
+    std::shared_ptr<storage::TileGroup> tile_group;
+    for (const auto *entry : entries) {
+      ItemPointer location = *entry;
+      bool visible = false;
+      if (!FindVisibleVersion(txn, location, tile_group, visible)) {
+        auto &txn_manager =
+            concurrency::TransactionManagerFactory::GetInstance();
+        txn_manager.SetTransactionResult(&txn, ResultType::FAILURE);
+        locations_.clear();
+        batches_.clear();
+        break;
+      }
+      if (visible &&
+          (!recheck_key_ ||
+           MatchesScanKey(*tile_group, location.offset, values))) {
+        AddResult(tile_group, location);
+      }
+    }
+  }
+
+  // Release the key so the next scan can write a new one in its place
+  for (auto &value : key_values_) {
+    value = peloton::type::Value();
+  }
+}
+
+storage::TileGroup *IndexScanIterator::GetTileGroup(uint32_t batch_idx) const {
+  PELOTON_ASSERT(batch_idx < batches_.size());
+  return batches_[batch_idx].tile_group.get();
+}
+
+uint32_t IndexScanIterator::FillSelectionVector(
+    uint32_t batch_idx, uint32_t *selection_vector) const {
+  PELOTON_ASSERT(batch_idx < batches_.size());
+  const auto &batch = batches_[batch_idx];
+  for (uint32_t i = batch.start; i < batch.end; i++) {
+    selection_vector[i - batch.start] = locations_[i].offset;
+  }
+  return batch.end - batch.start;
+}
+
+bool IndexScanIterator::PrepareScanKey(
+    std::vector<peloton::type::Value> &values) {
+  const auto *schema = table_.GetSchema();
+  values.reserve(key_values_.size());
+  for (uint32_t i = 0; i < key_values_.size(); i++) {
+    const auto &value = key_values_[i];
+    if (value.IsNull()) {
+      // Nothing compares true against NULL
+      return false;
+    }
+    auto column_type = schema->GetColumn(key_column_ids_[i]).GetType();
+    values.push_back(value.GetTypeId() == column_type
+                         ? value.Copy()
+                         : value.CastAs(column_type));
+  }
+  return true;
+}
+
+bool IndexScanIterator::FindVisibleVersion(
+    concurrency::TransactionContext &txn, ItemPointer &location,
+    std::shared_ptr<storage::TileGroup> &tile_group, bool &visible) const {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *storage_manager = storage::StorageManager::GetInstance();
+
+  visible = false;
+
+  // Consecutive entries often live in the same tile group
+  if (tile_group == nullptr ||
+      tile_group->GetTileGroupId() != location.block) {
+    tile_group = storage_manager->GetTileGroup(location.block);
+  }
+
+  // The tile group of a deleted tuple may have been freed by the GC
+  if (tile_group == nullptr) {
+    return true;
+  }
+
+  auto *tile_group_header = tile_group->GetHeader();
+  uint32_t chain_length = 0;
+  while (true) {
+    chain_length++;
+
+    auto visibility =
+        txn_manager.IsVisible(&txn, tile_group_header, location.offset);
+    if (visibility == VisibilityType::DELETED) {
+      return true;
+    }
+    if (visibility == VisibilityType::OK) {
+      visible = true;
+      return true;
+    }
+
+    PELOTON_ASSERT(visibility == VisibilityType::INVISIBLE);
+
+    bool is_acquired = (tile_group_header->GetTransactionId(
+                            location.offset) == INITIAL_TXN_ID);
+    bool is_alive = (tile_group_header->GetEndCommitId(location.offset) <=
+                     txn.GetReadId());
+    if (is_acquired && is_alive) {
+      // This version expired after the chain was modified by another
+      // transaction. Start over from the head of the chain.
+      location = *tile_group_header->GetIndirection(location.offset);
+      chain_length = 0;
+    } else {
+      ItemPointer next = tile_group_header->GetNextItemPointer(location.offset);
+      if (next.IsNull()) {
+        // An aborted version that was never part of a chain is fine. Otherwise
+        // there must be a visible version somewhere in the chain.
+        return chain_length == 1;
+      }
+      location = next;
+    }
+
+    tile_group = storage_manager->GetTileGroup(location.block);
+    tile_group_header = tile_group->GetHeader();
+  }
+}
+
+bool IndexScanIterator::MatchesScanKey(
+    storage::TileGroup &tile_group, oid_t tuple_offset,
+    const std::vector<peloton::type::Value> &values) const {
+  ContainerTuple<storage::TileGroup> tuple{&tile_group, tuple_offset};
+  const auto &indexed_columns = index_->GetKeySchema()->GetIndexedColumns();
+  storage::MaskedTuple key_tuple{&tuple, indexed_columns};
+  return index_->Compare(key_tuple, key_column_ids_, expr_types_, values);
+}
+
+void IndexScanIterator::AddResult(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    const ItemPointer &location) {
+  auto pos = static_cast<uint32_t>(locations_.size());
+  locations_.push_back(location);
+
+  if (!batches_.empty()) {
+    auto &last = batches_.back();
+    if (last.tile_group == tile_group &&
+        last.end - last.start < max_batch_size_) {
+      last.end++;
+      return;
+    }
+  }
+  batches_.push_back(Batch{tile_group, pos, pos + 1});
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -12,8 +12,15 @@
 
 #include "codegen/util/oa_hash_table.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #include "common/logger.h"
 #include "common/platform.h"
+#include "common/synchronization/count_down_latch.h"
+#include "common/timer.h"
+#include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
 namespace codegen {
@@ -28,6 +35,20 @@ uint32_t OAHashTable::kDefaultInitialSize = 8 * 1024;
 // The default capacity of key-value (overflow) lists when we create them
 uint32_t OAHashTable::kInitialKVListCapacity = 8;
 
+constexpr uint32_t OAHashTable::kNumMergePartitions;
+
+// The number of hash bits choosing the partition of an entry in a partitioned
+// merge, and the multiplier spreading all bits of the hash into them. The low
+// bits of a hash value already choose its bucket in the table.
+static const uint32_t kPartitionBits = 6;
+static const uint64_t kPartitionMix = 0x9E3779B97F4A7C15ull;
+
+// The minimum number of entries a partition table is sized for
+static const uint64_t kMinPartitionSize = 256;
+
+static_assert(OAHashTable::kNumMergePartitions == (1u << kPartitionBits),
+              "The number of merge partitions must match the partition bits");
+
 OAHashTable::OAHashTable(uint64_t key_size, uint64_t value_size,
                          uint64_t estimated_num_entries)
     : buckets_(nullptr),
@@ -37,7 +58,9 @@ OAHashTable::OAHashTable(uint64_t key_size, uint64_t value_size,
       num_entries_(0),
       resize_threshold_(num_buckets_ >> 1),
       key_size_(key_size),
-      value_size_(value_size) {
+      value_size_(value_size),
+      memory_(nullptr),
+      spill_(nullptr) {
   // Sanity check
   PELOTON_ASSERT((num_buckets_ & bucket_mask_) == 0);
 
@@ -62,7 +85,7 @@ OAHashTable::~OAHashTable() {
     if (!current_entry->IsFree()) {
       processed_count++;
       if (current_entry->HasKeyValueList()) {
-        free(current_entry->kv_list);
+        Free(current_entry->kv_list);
       }
     }
 
@@ -70,7 +93,12 @@ OAHashTable::~OAHashTable() {
   }
 
   // Free main buckets array
-  free(buckets_);
+  Free(buckets_);
+
+  // Thread-local tables share the spill partitions of their global table
+  if (spill_ != nullptr && spill_->Owner() == this) {
+    delete spill_;
+  }
 }
 
 void OAHashTable::Init(OAHashTable &table, uint64_t key_size,
@@ -80,6 +108,322 @@ void OAHashTable::Init(OAHashTable &table, uint64_t key_size,
 
 void OAHashTable::Destroy(OAHashTable &table) { table.~OAHashTable(); }
 
+void OAHashTable::InitPartitions(OAHashTable *partitions) {
+  // A table without buckets can be destroyed
+  PELOTON_MEMSET(partitions, 0, sizeof(OAHashTable) * kNumMergePartitions);
+}
+
+void OAHashTable::DestroyPartitions(OAHashTable *partitions) {
+  for (uint32_t part = 0; part < kNumMergePartitions; part++) {
+    Destroy(partitions[part]);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Merge all thread-local tables into the partition tables. Each thread-local
+// table is first split into the partitions its entries fall into, in parallel.
+// Then, each partition table is built by a single thread, merging that
+// partition of all N thread-local tables. Entries are not copied while they
+// are split, the partitions only collect pointers to them.
+//===----------------------------------------------------------------------===//
+void OAHashTable::MergePartitioned(
+    void *query_state,
+    const executor::ExecutorContext::ThreadStates &thread_states,
+    uint32_t table_offset, OAHashTable *partitions,
+    OAHashTable::MergeFunction merge_func) {
+  // Collect all thread-local tables
+  std::vector<OAHashTable *> tables;
+  thread_states.ForEach<OAHashTable>(
+      table_offset, [&tables](OAHashTable *table) { tables.push_back(table); });
+
+  if (tables.empty()) {
+    return;
+  }
+
+  // If a thread-local table ran out of memory, the groups of all tables are
+  // merged one spilled partition at a time instead. The partition tables are
+  // left empty.
+  SpillPartitions *spill = nullptr;
+  for (auto *table : tables) {
+    if (table->spill_ != nullptr) {
+      spill = table->spill_;
+    }
+  }
+  if (spill != nullptr && spill->HasSpilled()) {
+    for (auto *table : tables) {
+      if (table->spill_ != nullptr) {
+        table->SpillEntries();
+      }
+    }
+  }
+
+  uint64_t key_size = tables[0]->key_size_;
+  uint64_t value_size = tables[0]->value_size_;
+
+  // The entries of each thread-local partition. The partitions of the t-th
+  // table start at index (t * kNumMergePartitions).
+  std::vector<std::vector<HashEntry *>> entries(tables.size() *
+                                                kNumMergePartitions);
+
+  // The worker pool we use to execute parallel work
+  auto &work_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 1 - Partition each thread-local table in parallel
+  ////////////////////////////////////////////////////////////////////
+  {
+    common::synchronization::CountDownLatch latch(tables.size());
+    for (uint32_t table_idx = 0; table_idx < tables.size(); table_idx++) {
+      work_pool.SubmitTask([&tables, &entries, &latch, table_idx]() {
+        const OAHashTable &table = *tables[table_idx];
+        auto *part_entries = entries.data() + (table_idx * kNumMergePartitions);
+
+        uint64_t processed_count = 0;
+        char *entry_char_p = reinterpret_cast<char *>(table.buckets_);
+        while (processed_count < table.num_valid_buckets_) {
+          auto *entry = reinterpret_cast<HashEntry *>(entry_char_p);
+          if (!entry->IsFree()) {
+            processed_count++;
+
+            // Merged tables keep a single value per key
+            PELOTON_ASSERT(!entry->HasKeyValueList());
+            uint64_t part =
+                (entry->hash * kPartitionMix) >> (64 - kPartitionBits);
+            part_entries[part].push_back(entry);
+          }
+          entry_char_p += table.entry_size_;
+        }
+
+        latch.CountDown();
+      });
+    }
+    latch.Await(0);
+  }
+
+  timer.Stop();
+  LOG_DEBUG("Partitioned %zu thread-local tables into %u partitions: %.2lf ms",
+            tables.size(), kNumMergePartitions, timer.GetDuration());
+  timer.Reset();
+  timer.Start();
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 2 - Merge each partition in parallel
+  ////////////////////////////////////////////////////////////////////
+  {
+    // Partitions are claimed dynamically, so skewed partitions don't stall
+    // the merge
+    auto num_tasks = std::min(kNumMergePartitions, work_pool.NumWorkers());
+    std::atomic<uint32_t> next_partition{0};
+    common::synchronization::CountDownLatch latch(num_tasks);
+    for (uint32_t task = 0; task < num_tasks; task++) {
+      work_pool.SubmitTask([query_state, &tables, &entries, partitions,
+                            merge_func, &next_partition, &latch, key_size,
+                            value_size]() {
+        for (uint32_t part = next_partition.fetch_add(1);
+             part < kNumMergePartitions; part = next_partition.fetch_add(1)) {
+          // Size the partition for the case that no two thread-local tables
+          // share a key
+          uint64_t num_entries = 0;
+          for (uint32_t table_idx = 0; table_idx < tables.size();
+               table_idx++) {
+            num_entries +=
+                entries[(table_idx * kNumMergePartitions) + part].size();
+          }
+          Init(partitions[part], key_size, value_size,
+               std::max(num_entries, kMinPartitionSize));
+
+          for (uint32_t table_idx = 0; table_idx < tables.size();
+               table_idx++) {
+            auto &part_entries =
+                entries[(table_idx * kNumMergePartitions) + part];
+            if (!part_entries.empty()) {
+              merge_func(query_state, &partitions[part], part_entries.data(),
+                         part_entries.size());
+            }
+          }
+        }
+        latch.CountDown();
+      });
+    }
+    latch.Await(0);
+  }
+
+  timer.Stop();
+  LOG_DEBUG("Merged %u partitions: %.2lf ms", kNumMergePartitions,
+            timer.GetDuration());
+}
+
+void OAHashTable::EnableSpilling(OAHashTable &table,
+                                 executor::ExecutorContext &exec_ctx,
+                                 OAHashTable *owner) {
+  PELOTON_ASSERT(table.num_entries_ == 0);
+
+  // Move the buckets into the pool of the query, accounting for them in its
+  // memory limit
+  free(table.buckets_);
+  table.memory_ = exec_ctx.GetPool();
+  table.buckets_ = static_cast<HashEntry *>(
+      table.Allocate(table.entry_size_ * table.num_buckets_));
+  table.InitializeArray(table.buckets_);
+
+  // Spill records are the hash, key and value of an entry
+  if (owner == &table) {
+    table.spill_ = new SpillPartitions(
+        exec_ctx, static_cast<uint32_t>(table.entry_size_ - sizeof(uint64_t)),
+        &table);
+  } else {
+    table.spill_ = owner->spill_;
+  }
+}
+
+void OAHashTable::FlushSpilled(OAHashTable &table) {
+  if (table.spill_ != nullptr && table.spill_->HasSpilled()) {
+    table.SpillEntries();
+  }
+}
+
+bool OAHashTable::NextSpilledPartition(void *query_state, OAHashTable &table,
+                                       OAHashTable::MergeFunction merge_func) {
+  SpillPartitions *spill = table.spill_;
+  if (spill == nullptr) {
+    return false;
+  }
+
+  // The previous partition was consumed, all spilled entries are in the
+  // pending partitions
+  table.Clear();
+  spill->TakeFiles();
+
+  while (spill->HasPending()) {
+    auto partition = spill->PopPending();
+
+    // Entries of the partition spill on the next bits of their hash
+    spill->SetLevel(partition.level + 1);
+    table.MergeSpilled(query_state, partition, merge_func);
+    spill->AddPass();
+
+    if (!spill->HasSpilled()) {
+      return true;
+    }
+
+    // The partition didn't fit either, its groups are in the next level
+    table.SpillEntries();
+    spill->TakeFiles();
+  }
+  return false;
+}
+
+void OAHashTable::MergeSpilled(void *query_state,
+                               SpillPartitions::Partition &partition,
+                               OAHashTable::MergeFunction merge_func) {
+  static const uint64_t kNumMergeEntries = 1024;
+
+  LOG_DEBUG("Merging spilled partition of %" PRIu64 " bytes at level %u",
+            partition.file->Size(), partition.level);
+
+  // Records are read in chunks, and rebuilt into entries in place. The hash,
+  // key and value of an entry follow its status.
+  uint64_t record_size = entry_size_ - sizeof(uint64_t);
+  std::vector<char> records(kNumMergeEntries * record_size);
+  std::vector<char> entry_space(kNumMergeEntries * entry_size_);
+  std::vector<HashEntry *> entries(kNumMergeEntries);
+  for (uint64_t i = 0; i < kNumMergeEntries; i++) {
+    entries[i] = reinterpret_cast<HashEntry *>(&entry_space[i * entry_size_]);
+    entries[i]->status = HashEntry::StatusCode::SINGLE_VALUE;
+  }
+
+  partition.file->Rewind();
+  uint64_t read;
+  while ((read = partition.file->Read(records.data(), records.size())) > 0) {
+    uint64_t num_entries = read / record_size;
+    for (uint64_t i = 0; i < num_entries; i++) {
+      PELOTON_MEMCPY(&entries[i]->hash, &records[i * record_size],
+                     record_size);
+    }
+    merge_func(query_state, this, entries.data(), num_entries);
+  }
+}
+
+void *OAHashTable::Allocate(uint64_t size) {
+  return memory_ != nullptr ? memory_->Allocate(size) : malloc(size);
+}
+
+void OAHashTable::Free(void *ptr) {
+  if (memory_ != nullptr) {
+    if (ptr != nullptr) {
+      memory_->Free(ptr);
+    }
+  } else {
+    free(ptr);
+  }
+}
+
+bool OAHashTable::ShouldSpill() const {
+  // Spill rather than double the buckets beyond the limit
+  return spill_ != nullptr && spill_->CanSpill() &&
+         spill_->ExceedsMemoryLimit(entry_size_ * num_buckets_ * 2);
+}
+
+//===----------------------------------------------------------------------===//
+// Write every key-value pair of the table to the spill partitions, as the hash
+// followed by the key and value, and empty the table. Values in key-value lists
+// are written with a copy of their key.
+//===----------------------------------------------------------------------===//
+void OAHashTable::SpillEntries() {
+  PELOTON_ASSERT(spill_ != nullptr);
+
+  LOG_DEBUG("Spilling hash table with %" PRIu64 " entries", num_entries_);
+
+  SpillPartitions::Writer writer{*spill_};
+  std::vector<char> payload(key_size_ + value_size_);
+
+  uint64_t processed_count = 0;
+  char *entry_char_p = reinterpret_cast<char *>(buckets_);
+  while (processed_count < num_valid_buckets_) {
+    auto *entry = reinterpret_cast<HashEntry *>(entry_char_p);
+    if (!entry->IsFree()) {
+      processed_count++;
+      if (entry->HasKeyValueList()) {
+        PELOTON_MEMCPY(payload.data(), entry->data, key_size_);
+        for (uint32_t pos = 0; pos < entry->kv_list->size; pos++) {
+          PELOTON_MEMCPY(payload.data() + key_size_,
+                         entry->kv_list->data + (pos * value_size_),
+                         value_size_);
+          writer.Append(entry->hash, payload.data());
+        }
+      } else {
+        writer.Append(entry->hash, entry->data);
+      }
+    }
+    entry_char_p += entry_size_;
+  }
+  writer.Finish();
+
+  Clear();
+}
+
+void OAHashTable::Clear() {
+  uint64_t processed_count = 0;
+  char *entry_char_p = reinterpret_cast<char *>(buckets_);
+  while (processed_count < num_valid_buckets_) {
+    auto *entry = reinterpret_cast<HashEntry *>(entry_char_p);
+    if (!entry->IsFree()) {
+      processed_count++;
+      if (entry->HasKeyValueList()) {
+        Free(entry->kv_list);
+      }
+    }
+    entry_char_p += entry_size_;
+  }
+
+  InitializeArray(buckets_);
+  num_valid_buckets_ = 0;
+  num_entries_ = 0;
+}
+
 //===----------------------------------------------------------------------===//
 // Find the next available slot in the key value list. If the list is already
 // full then extend the list before storing into it
@@ -122,7 +466,7 @@ char *OAHashTable::StoreToKeyValueList(KeyValueList **kv_list_p_p) {
     // Get the new size of the kv list header + 1 key + values
     uint64_t new_kv_list_length = GetCurrentKeyValueListSize(new_capacity);
 
-    kv_list_p = static_cast<KeyValueList *>(malloc(new_kv_list_length));
+    kv_list_p = static_cast<KeyValueList *>(Allocate(new_kv_list_length));
     PELOTON_ASSERT(kv_list_p != nullptr);
 
     // Copy from the old memory chunk to the new chunk
@@ -132,7 +476,7 @@ char *OAHashTable::StoreToKeyValueList(KeyValueList **kv_list_p_p) {
     kv_list_p->capacity = new_capacity;
 
     // Free memory and assign it back to the place where kv_list_p is stored
-    free(*kv_list_p_p);
+    Free(*kv_list_p_p);
     *kv_list_p_p = kv_list_p;
   }
 
@@ -194,10 +538,18 @@ char *OAHashTable::StoreTuple(HashEntry *entry, uint64_t hash) {
   //      entry without any probing after resizing. This is because we don't
   //      have the key value available here, and hence, cannot perform key
   //      comparisons in case of key collisions.
+  //
+  // A table bound to the memory limit spills all its entries rather than grow
+  // beyond the limit, and the new entry goes into the emptied table. This is
+  // only possible when the target entry is free, for the same reason.
   if (NeedsResize()) {
-    // This will modify entry if the entry is not free and when it is
-    // being moved
-    Resize(&entry);
+    if (entry_is_free && ShouldSpill()) {
+      SpillEntries();
+    } else {
+      // This will modify entry if the entry is not free and when it is
+      // being moved
+      Resize(&entry);
+    }
 
     // If entry is not free then entry points to the entry after resizing
     if (entry_is_free) {
@@ -227,7 +579,7 @@ char *OAHashTable::StoreTuple(HashEntry *entry, uint64_t hash) {
   // we allocate one.
   if (!entry->HasKeyValueList()) {
     // Allocate a chunk that contains kv list header and several value slots
-    entry->kv_list = static_cast<KeyValueList *>(malloc(
+    entry->kv_list = static_cast<KeyValueList *>(Allocate(
         GetCurrentKeyValueListSize(OAHashTable::kInitialKVListCapacity)));
 
     PELOTON_ASSERT(entry->kv_list != nullptr);
@@ -301,7 +653,7 @@ void OAHashTable::Resize(HashEntry **entry_p_p) {
   resize_threshold_ <<= 1;
 
   // Allocate the new array
-  char *new_buckets = static_cast<char *>(malloc(entry_size_ * num_buckets_));
+  char *new_buckets = static_cast<char *>(Allocate(entry_size_ * num_buckets_));
 
   // Set it all to status code FREE
   InitializeArray(reinterpret_cast<HashEntry *>(new_buckets));
@@ -367,7 +719,7 @@ void OAHashTable::Resize(HashEntry **entry_p_p) {
   }
 
   // Free the old array after probing of all elements, and then update
-  free(buckets_);
+  Free(buckets_);
   buckets_ = reinterpret_cast<HashEntry *>(new_buckets);
 }
 
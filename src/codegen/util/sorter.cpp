@@ -13,8 +13,11 @@
 #include "codegen/util/sorter.h"
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
 #include <queue>
 
+#include "codegen/util/spill_file.h"
 #include "common/synchronization/count_down_latch.h"
 #include "common/timer.h"
 #include "threadpool/mono_queue_pool.h"
@@ -23,6 +26,245 @@ namespace peloton {
 namespace codegen {
 namespace util {
 
+// The minimum number of bytes of tuples buffered before they're spilled as a
+// run, so a nearly exhausted memory limit doesn't produce many tiny runs
+static const uint64_t kMinRunSize = 256 * 1024;
+
+// The maximum number of runs merged at once. Spills producing more runs are
+// merged in multiple passes.
+static const uint32_t kMaxMergeFanIn = 64;
+
+// The number of bytes read from a run at once while merging
+static const uint64_t kRunReadSize = 64 * 1024;
+
+// The number of tuples in each batch of merged output
+static const uint64_t kMergeBatchSize = 4096;
+
+// Buckets with at most this many tuples are sorted by comparison rather than
+// radix-partitioned further
+static const uint64_t kRadixSortCutoff = 64;
+
+constexpr uint32_t Sorter::kMaxNormalizedKeySize;
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// Normalized key sorting
+///
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// A tuple with its normalized key. Entries are sorted in a contiguous array
+// rather than through the tuple pointers to keep the keys cache-resident.
+template <uint32_t KeySize>
+struct SortEntry {
+  unsigned char key[KeySize];
+  char *tuple;
+};
+
+// An MSD radix sort on the bytes of the normalized keys. Partitions are sorted
+// by comparing keys (and tuples, if the keys aren't exact) once they're small.
+template <uint32_t KeySize>
+class RadixSorter {
+ public:
+  using Entry = SortEntry<KeySize>;
+
+  RadixSorter(Sorter::ComparisonFunction cmp_func, bool key_is_exact)
+      : cmp_func_(cmp_func), key_is_exact_(key_is_exact) {}
+
+  // Sort the given tuples, using the provided function to produce their keys
+  void Sort(std::vector<char *> &tuples, Sorter::NormalizeFunction norm_func) {
+    uint64_t num_tuples = tuples.size();
+    std::unique_ptr<Entry[]> entries{new Entry[num_tuples]};
+    std::unique_ptr<Entry[]> scratch{new Entry[num_tuples]};
+
+    for (uint64_t i = 0; i < num_tuples; i++) {
+      norm_func(tuples[i], reinterpret_cast<char *>(entries[i].key));
+      entries[i].tuple = tuples[i];
+    }
+
+    SortPartition(entries.get(), scratch.get(), num_tuples, 0);
+
+    for (uint64_t i = 0; i < num_tuples; i++) {
+      tuples[i] = entries[i].tuple;
+    }
+  }
+
+ private:
+  // Sort the entries sharing their keys' first 'byte' bytes
+  void SortPartition(Entry *entries, Entry *scratch, uint64_t num_entries,
+                     uint32_t byte) {
+    if (byte == KeySize) {
+      // All keys are equal, only the tuples can tell them apart
+      if (!key_is_exact_) {
+        std::sort(entries, entries + num_entries,
+                  [this](const Entry &left, const Entry &right) {
+                    return cmp_func_(left.tuple, right.tuple) < 0;
+                  });
+      }
+      return;
+    }
+
+    if (num_entries <= kRadixSortCutoff) {
+      std::sort(entries, entries + num_entries,
+                [this, byte](const Entry &left, const Entry &right) {
+                  int cmp = std::memcmp(left.key + byte, right.key + byte,
+                                        KeySize - byte);
+                  if (cmp == 0 && !key_is_exact_) {
+                    cmp = cmp_func_(left.tuple, right.tuple);
+                  }
+                  return cmp < 0;
+                });
+      return;
+    }
+
+    // Histogram the current byte
+    uint64_t counts[256] = {0};
+    for (uint64_t i = 0; i < num_entries; i++) {
+      counts[entries[i].key[byte]]++;
+    }
+
+    // If all entries share the byte, there's nothing to partition
+    if (counts[entries[0].key[byte]] == num_entries) {
+      SortPartition(entries, scratch, num_entries, byte + 1);
+      return;
+    }
+
+    // Scatter the entries into their buckets, and copy them back in order
+    uint64_t offsets[256];
+    uint64_t offset = 0;
+    for (uint32_t bucket = 0; bucket < 256; bucket++) {
+      offsets[bucket] = offset;
+      offset += counts[bucket];
+    }
+    for (uint64_t i = 0; i < num_entries; i++) {
+      scratch[offsets[entries[i].key[byte]]++] = entries[i];
+    }
+    std::copy(scratch, scratch + num_entries, entries);
+
+    // Sort each bucket on the remaining bytes
+    uint64_t start = 0;
+    for (uint32_t bucket = 0; bucket < 256; bucket++) {
+      if (counts[bucket] > 1) {
+        SortPartition(entries + start, scratch + start, counts[bucket],
+                      byte + 1);
+      }
+      start += counts[bucket];
+    }
+  }
+
+ private:
+  Sorter::ComparisonFunction cmp_func_;
+  bool key_is_exact_;
+};
+
+template <uint32_t KeySize>
+void RadixSort(std::vector<char *> &tuples, Sorter::NormalizeFunction norm_func,
+               Sorter::ComparisonFunction cmp_func, bool key_is_exact) {
+  RadixSorter<KeySize>{cmp_func, key_is_exact}.Sort(tuples, norm_func);
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// External sort
+///
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The sorted runs a sorter spilled, and the merge producing its output. Runs
+ * are files of tuples, written in sorted order.
+ */
+class Sorter::ExternalSort {
+ public:
+  // Reads a run a buffer at a time while it is merged
+  struct RunReader {
+    std::unique_ptr<SpillFile> file;
+    std::vector<char> buffer;
+    char *pos;
+    char *end;
+
+    // Read the next tuples, returning false at the end of the run
+    bool Refill(uint32_t tuple_size) {
+      uint64_t read = file->Read(buffer.data(), buffer.size());
+      pos = buffer.data();
+      end = pos + (read / tuple_size) * tuple_size;
+      return pos != end;
+    }
+  };
+
+  // A k-way merge of runs, producing their tuples in sort order
+  class Merger {
+   public:
+    Merger(std::vector<std::unique_ptr<SpillFile>> runs, uint32_t tuple_size,
+           ComparisonFunction cmp_func)
+        : tuple_size_(tuple_size), cmp_func_(cmp_func), last_(nullptr) {
+      uint64_t buffer_size =
+          std::max<uint64_t>(kRunReadSize / tuple_size, 1) * tuple_size;
+      readers_.resize(runs.size());
+      for (uint32_t i = 0; i < runs.size(); i++) {
+        auto &reader = readers_[i];
+        reader.file = std::move(runs[i]);
+        reader.file->Rewind();
+        reader.buffer.resize(buffer_size);
+        if (reader.Refill(tuple_size_)) {
+          heap_.push_back(&reader);
+        }
+      }
+      std::make_heap(heap_.begin(), heap_.end(), Order());
+    }
+
+    // Return the next tuple in sort order, or null once all runs are merged.
+    // The tuple remains valid until the next call.
+    const char *Next() {
+      // Move past the tuple returned last time
+      if (last_ != nullptr) {
+        last_->pos += tuple_size_;
+        if (last_->pos != last_->end || last_->Refill(tuple_size_)) {
+          heap_.push_back(last_);
+          std::push_heap(heap_.begin(), heap_.end(), Order());
+        }
+        last_ = nullptr;
+      }
+
+      if (heap_.empty()) {
+        return nullptr;
+      }
+
+      std::pop_heap(heap_.begin(), heap_.end(), Order());
+      last_ = heap_.back();
+      heap_.pop_back();
+      return last_->pos;
+    }
+
+   private:
+    // Order readers such that the heap's top holds the smallest tuple
+    struct HeapOrder {
+      ComparisonFunction cmp_func;
+      bool operator()(const RunReader *left, const RunReader *right) const {
+        return cmp_func(left->pos, right->pos) > 0;
+      }
+    };
+    HeapOrder Order() const { return HeapOrder{cmp_func_}; }
+
+   private:
+    uint32_t tuple_size_;
+    ComparisonFunction cmp_func_;
+    std::vector<RunReader> readers_;
+    std::vector<RunReader *> heap_;
+    RunReader *last_;
+  };
+
+  // The runs that have been spilled and not merged yet
+  std::vector<std::unique_ptr<SpillFile>> runs;
+
+  // The merge producing the sorted output, and the buffer the current batch of
+  // merged tuples is copied into
+  std::unique_ptr<Merger> merger;
+  char *batch = nullptr;
+};
+
 Sorter::Sorter(::peloton::type::AbstractPool &memory, ComparisonFunction func,
                uint32_t tuple_size)
     : memory_(memory),
@@ -32,12 +274,21 @@ Sorter::Sorter(::peloton::type::AbstractPool &memory, ComparisonFunction func,
       buffer_end_(nullptr),
       next_alloc_size_(kInitialBufferSize),
       tuples_start_(nullptr),
-      tuples_end_(nullptr) {
+      tuples_end_(nullptr),
+      exec_ctx_(nullptr),
+      norm_func_(nullptr),
+      key_size_(0),
+      key_is_exact_(false),
+      batch_produced_(false),
+      external_(nullptr) {
   // No memory allocation
   LOG_DEBUG("Initialized Sorter for tuples of size %u bytes", tuple_size_);
 }
 
 Sorter::~Sorter() {
+  delete external_;
+  external_ = nullptr;
+
   uint64_t total_alloc = 0;
   for (const auto &iter : blocks_) {
     void *block = iter.first;
@@ -56,13 +307,34 @@ Sorter::~Sorter() {
 void Sorter::Init(Sorter &sorter, executor::ExecutorContext &exec_ctx,
                   ComparisonFunction func, uint32_t tuple_size) {
   new (&sorter) Sorter(*exec_ctx.GetPool(), func, tuple_size);
+  sorter.exec_ctx_ = &exec_ctx;
 }
 
 void Sorter::Destroy(Sorter &sorter) { sorter.~Sorter(); }
 
+void Sorter::UseNormalizedKeys(NormalizeFunction norm_func, uint32_t key_size,
+                               bool key_is_exact) {
+  PELOTON_ASSERT(key_size % 8 == 0 && key_size <= kMaxNormalizedKeySize);
+  norm_func_ = norm_func;
+  key_size_ = key_size;
+  key_is_exact_ = key_is_exact;
+}
+
+void Sorter::NormalizeStringPrefix(char *key, const char *str, uint32_t len,
+                                   uint32_t prefix_len, bool descending) {
+  uint32_t copy_len = std::min(len, prefix_len);
+  PELOTON_MEMCPY(key, str, copy_len);
+  PELOTON_MEMSET(key + copy_len, 0, prefix_len - copy_len);
+  if (descending) {
+    for (uint32_t i = 0; i < prefix_len; i++) {
+      key[i] = ~key[i];
+    }
+  }
+}
+
 char *Sorter::StoreTuple() {
-  // Make room for a new tuple
-  MakeRoomForNewTuple();
+  // Make room for a new tuple, spilling the buffered tuples if needed
+  MakeRoomForNewTuple(true);
 
   // Bump the position pointer, return location where call can write a tuple
   char *ret = buffer_pos_;
@@ -76,7 +348,13 @@ char *Sorter::StoreTuple() {
 }
 
 char *Sorter::StoreTupleForTopK(UNUSED_ATTRIBUTE uint64_t top_k) {
-  return StoreTuple();
+  // The heap is bounded by K tuples, it never spills
+  MakeRoomForNewTuple(false);
+
+  char *ret = buffer_pos_;
+  buffer_pos_ += tuple_size_;
+  tuples_.push_back(ret);
+  return ret;
 }
 
 void Sorter::StoreTupleForTopKFinish(uint64_t top_k) {
@@ -109,8 +387,24 @@ void Sorter::StoreTupleForTopKFinish(uint64_t top_k) {
 }
 
 void Sorter::Sort() {
+  // If runs were spilled, spill the rest and merge them all
+  if (external_ != nullptr) {
+    if (!tuples_.empty()) {
+      SpillRun();
+    }
+    StartMerge();
+    return;
+  }
+
+  SortInMemory();
+}
+
+void Sorter::SortInMemory() {
+  batch_produced_ = false;
+
   // Short-circuit
   if (tuples_.empty()) {
+    tuples_start_ = tuples_end_ = nullptr;
     return;
   }
 
@@ -118,12 +412,29 @@ void Sorter::Sort() {
   Timer<std::milli> timer;
   timer.Start();
 
-  // Sort the sucker
-  // TODO(pmenon): The standard std::sort is super slow. We should consider a
-  //               switch to IPS4O which is up to 3-4x faster.
-  auto cmp =
-      [this](char *left, char *right) { return cmp_func_(left, right) < 0; };
-  std::sort(tuples_.begin(), tuples_.end(), cmp);
+  // Sort the sucker, radix sorting on the normalized keys if we have them
+  if (norm_func_ != nullptr && tuples_.size() > kRadixSortCutoff) {
+    switch (key_size_) {
+      case 8:
+        RadixSort<8>(tuples_, norm_func_, cmp_func_, key_is_exact_);
+        break;
+      case 16:
+        RadixSort<16>(tuples_, norm_func_, cmp_func_, key_is_exact_);
+        break;
+      case 24:
+        RadixSort<24>(tuples_, norm_func_, cmp_func_, key_is_exact_);
+        break;
+      case 32:
+        RadixSort<32>(tuples_, norm_func_, cmp_func_, key_is_exact_);
+        break;
+      default:
+        PELOTON_ASSERT(false && "Unsupported normalized key size");
+    }
+  } else {
+    auto cmp =
+        [this](char *left, char *right) { return cmp_func_(left, right) < 0; };
+    std::sort(tuples_.begin(), tuples_.end(), cmp);
+  }
 
   // Setup pointers
   tuples_start_ = tuples_.data();
@@ -178,6 +489,30 @@ void Sorter::SortParallel(
   // The worker pool we use to execute parallel work
   auto &work_pool = threadpool::MonoQueuePool::GetExecutionInstance();
 
+  // If any thread-local sort spilled, spill the rest of each in parallel and
+  // merge all their runs, rather than merging in memory
+  bool spilled = std::any_of(sorters.begin(), sorters.end(),
+                             [](Sorter *sorter) { return sorter->HasSpilled(); });
+  if (spilled) {
+    common::synchronization::CountDownLatch latch(sorters.size());
+    for (auto *sorter : sorters) {
+      work_pool.SubmitTask([sorter, &latch]() {
+        if (sorter->NumTuples() > 0) {
+          sorter->SpillRun();
+        }
+        latch.CountDown();
+      });
+    }
+    latch.Await(0);
+
+    for (auto *sorter : sorters) {
+      TransferRuns(*sorter);
+      sorter->TransferMemoryBlocks(*this);
+    }
+    StartMerge();
+    return;
+  }
+
   // The main comparison function to compare two tuples
   auto comp =
       [this](char *left, char *right) { return cmp_func_(left, right) < 0; };
@@ -340,6 +675,7 @@ void Sorter::SortParallel(
 
   tuples_start_ = tuples_.data();
   tuples_end_ = tuples_start_ + tuples_.size();
+  batch_produced_ = false;
 
   timer.Stop();
   LOG_DEBUG("Merging sorted runs time: %.2lf ms", timer.GetDuration());
@@ -357,13 +693,165 @@ void Sorter::SortTopKParallel(
   tuples_end_ = tuples_start_ + tuples_.size();
 }
 
-void Sorter::MakeRoomForNewTuple() {
+bool Sorter::NextBatch() {
+  // An in-memory sort produces all its tuples at once
+  if (external_ == nullptr) {
+    bool has_batch = !batch_produced_;
+    batch_produced_ = true;
+    return has_batch;
+  }
+
+  if (external_->merger == nullptr) {
+    return false;
+  }
+
+  // Copy the next merged tuples into the batch
+  tuples_.clear();
+  char *pos = external_->batch;
+  const char *tuple;
+  while (tuples_.size() < kMergeBatchSize &&
+         (tuple = external_->merger->Next()) != nullptr) {
+    PELOTON_MEMCPY(pos, tuple, tuple_size_);
+    tuples_.push_back(pos);
+    pos += tuple_size_;
+  }
+
+  if (tuples_.empty()) {
+    external_->merger.reset();
+    tuples_start_ = tuples_end_ = nullptr;
+    return false;
+  }
+
+  tuples_start_ = tuples_.data();
+  tuples_end_ = tuples_start_ + tuples_.size();
+  return true;
+}
+
+bool Sorter::ShouldSpill() const {
+  return exec_ctx_ != nullptr &&
+         tuples_.size() * tuple_size_ >= kMinRunSize &&
+         exec_ctx_->ExceedsMemoryLimit(next_alloc_size_);
+}
+
+void Sorter::SpillRun() {
+  PELOTON_ASSERT(!tuples_.empty());
+
+  SortInMemory();
+
+  std::unique_ptr<SpillFile> run{new SpillFile()};
+  for (const char *tuple : tuples_) {
+    run->Write(tuple, tuple_size_);
+  }
+
+  if (exec_ctx_ != nullptr) {
+    exec_ctx_->AddSpilledBytes(run->Size());
+  }
+  LOG_DEBUG("Spilled a sorted run of %zu tuples (%.2lf KB)", tuples_.size(),
+            run->Size() / 1024.0);
+
+  if (external_ == nullptr) {
+    external_ = new ExternalSort();
+  }
+  external_->runs.push_back(std::move(run));
+
+  // Keep only the last (and largest) block, and start filling it again
+  auto last_block = blocks_.back();
+  blocks_.pop_back();
+  for (const auto &iter : blocks_) {
+    memory_.Free(iter.first);
+  }
+  blocks_.clear();
+  blocks_.push_back(last_block);
+
+  buffer_pos_ = reinterpret_cast<char *>(last_block.first);
+  buffer_end_ = buffer_pos_ + last_block.second;
+
+  tuples_.clear();
+  tuples_start_ = tuples_end_ = nullptr;
+}
+
+void Sorter::TransferRuns(Sorter &source) {
+  if (source.external_ == nullptr) {
+    return;
+  }
+  if (external_ == nullptr) {
+    external_ = new ExternalSort();
+  }
+  auto &runs = source.external_->runs;
+  for (auto &run : runs) {
+    external_->runs.push_back(std::move(run));
+  }
+  runs.clear();
+}
+
+void Sorter::StartMerge() {
+  PELOTON_ASSERT(external_ != nullptr);
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  // Merge runs in groups until they can be merged at once
+  auto &runs = external_->runs;
+  while (runs.size() > kMaxMergeFanIn) {
+    std::vector<std::unique_ptr<SpillFile>> inputs;
+    for (uint32_t i = 0; i < kMaxMergeFanIn; i++) {
+      inputs.push_back(std::move(runs[i]));
+    }
+    runs.erase(runs.begin(), runs.begin() + kMaxMergeFanIn);
+
+    std::unique_ptr<SpillFile> merged{new SpillFile()};
+    ExternalSort::Merger merger{std::move(inputs), tuple_size_, cmp_func_};
+    for (const char *tuple = merger.Next(); tuple != nullptr;
+         tuple = merger.Next()) {
+      merged->Write(tuple, tuple_size_);
+    }
+
+    if (exec_ctx_ != nullptr) {
+      exec_ctx_->AddSpilledBytes(merged->Size());
+      exec_ctx_->AddSpillPass();
+    }
+    runs.push_back(std::move(merged));
+  }
+
+  LOG_DEBUG("Merging %zu sorted runs", runs.size());
+
+  // The final merge is consumed batch by batch
+  if (exec_ctx_ != nullptr) {
+    exec_ctx_->AddSpillPass();
+  }
+  external_->merger.reset(
+      new ExternalSort::Merger{std::move(runs), tuple_size_, cmp_func_});
+  runs.clear();
+
+  if (external_->batch == nullptr) {
+    uint64_t batch_size = kMergeBatchSize * tuple_size_;
+    external_->batch = reinterpret_cast<char *>(memory_.Allocate(batch_size));
+    blocks_.emplace_back(external_->batch, batch_size);
+  }
+
+  tuples_.clear();
+  tuples_start_ = tuples_end_ = nullptr;
+
+  timer.Stop();
+  LOG_DEBUG("Intermediate merges took %.2lf ms", timer.GetDuration());
+}
+
+void Sorter::MakeRoomForNewTuple(bool can_spill) {
   bool has_room =
       (buffer_pos_ != nullptr && buffer_pos_ + tuple_size_ < buffer_end_);
   if (has_room) {
     return;
   }
 
+  // Rather than exceed the memory limit, write the buffered tuples to disk and
+  // reuse the current block
+  if (can_spill && ShouldSpill()) {
+    SpillRun();
+    if (buffer_pos_ + tuple_size_ < buffer_end_) {
+      return;
+    }
+  }
+
   PELOTON_ASSERT(next_alloc_size_ >= tuple_size_);
 
   LOG_TRACE("Allocating block of size %.2lf KB ...", next_alloc_size_ / 1024.0);
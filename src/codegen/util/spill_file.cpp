@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/codegen/util/spill_file.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/spill_file.h"
+
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "executor/executor_context.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+// The number of bytes a writer buffers per partition before writing them out
+static const uint64_t kWriteBufferSize = 64 * 1024;
+
+// The number of bits of the hash choosing the partition at each level, and the
+// multiplier spreading all bits of the hash into them
+static const uint32_t kPartitionBits = 4;
+static const uint64_t kPartitionMix = 0x9E3779B97F4A7C15ull;
+
+constexpr uint32_t SpillPartitions::kNumPartitions;
+constexpr uint32_t SpillPartitions::kMaxLevel;
+
+static_assert(SpillPartitions::kNumPartitions == (1u << kPartitionBits),
+              "The number of spill partitions must match the partition bits");
+static_assert(SpillPartitions::kMaxLevel * kPartitionBits <= 64,
+              "The spill levels can't use more bits than the hash has");
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// SpillFile
+///
+////////////////////////////////////////////////////////////////////////////////
+
+SpillFile::SpillFile() : file_(nullptr), size_(0) {
+  std::string path = settings::SettingsManager::GetString(
+                         settings::SettingId::spill_directory) +
+                     "/peloton_spill_XXXXXX";
+  std::vector<char> name(path.begin(), path.end());
+  name.push_back('\0');
+
+  int fd = mkstemp(name.data());
+  if (fd < 0) {
+    throw ExecutorException("Could not create spill file " + path + ": " +
+                            std::strerror(errno));
+  }
+
+  // The file is only reachable through the descriptor from now on
+  unlink(name.data());
+
+  file_ = fdopen(fd, "w+b");
+  if (file_ == nullptr) {
+    close(fd);
+    throw ExecutorException("Could not open spill file " + path + ": " +
+                            std::strerror(errno));
+  }
+}
+
+SpillFile::~SpillFile() {
+  if (file_ != nullptr) {
+    fclose(file_);
+  }
+}
+
+void SpillFile::Write(const char *data, uint64_t size) {
+  if (fwrite(data, 1, size, file_) != size) {
+    throw ExecutorException(std::string{"Could not write spill file: "} +
+                            std::strerror(errno));
+  }
+  size_ += size;
+}
+
+void SpillFile::Rewind() {
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    throw ExecutorException(std::string{"Could not rewind spill file: "} +
+                            std::strerror(errno));
+  }
+}
+
+uint64_t SpillFile::Read(char *data, uint64_t size) {
+  uint64_t read = fread(data, 1, size, file_);
+  if (read < size && ferror(file_)) {
+    throw ExecutorException(std::string{"Could not read spill file: "} +
+                            std::strerror(errno));
+  }
+  return read;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// SpillPartitions
+///
+////////////////////////////////////////////////////////////////////////////////
+
+SpillPartitions::SpillPartitions(executor::ExecutorContext &exec_ctx,
+                                 uint32_t record_size, const void *owner)
+    : exec_ctx_(exec_ctx),
+      record_size_(record_size),
+      owner_(owner),
+      level_(0),
+      spilled_(false) {
+  PELOTON_ASSERT(record_size_ >= sizeof(uint64_t));
+}
+
+bool SpillPartitions::ExceedsMemoryLimit(uint64_t bytes) const {
+  return exec_ctx_.ExceedsMemoryLimit(bytes);
+}
+
+void SpillPartitions::AddPass() { exec_ctx_.AddSpillPass(); }
+
+void SpillPartitions::TakeFiles() {
+  for (uint32_t part = 0; part < kNumPartitions; part++) {
+    if (files_[part] != nullptr) {
+      pending_.push_back(Partition{std::move(files_[part]), level_});
+    }
+  }
+  spilled_.store(false);
+}
+
+SpillPartitions::Partition SpillPartitions::PopPending() {
+  PELOTON_ASSERT(HasPending());
+  Partition partition = std::move(pending_.back());
+  pending_.pop_back();
+  return partition;
+}
+
+void SpillPartitions::Split(SpillPartitions::Partition partition) {
+  PELOTON_ASSERT(!HasSpilled());
+  PELOTON_ASSERT(partition.level + 1 < kMaxLevel);
+
+  LOG_DEBUG("Splitting spilled partition of %" PRIu64 " bytes at level %u",
+            partition.file->Size(), partition.level);
+
+  uint32_t level = level_;
+  level_ = partition.level + 1;
+
+  std::vector<char> records(kWriteBufferSize / record_size_ * record_size_);
+  partition.file->Rewind();
+  {
+    Writer writer{*this};
+    uint64_t read;
+    while ((read = partition.file->Read(records.data(), records.size())) > 0) {
+      for (uint64_t pos = 0; pos + record_size_ <= read; pos += record_size_) {
+        uint64_t hash;
+        PELOTON_MEMCPY(&hash, records.data() + pos, sizeof(uint64_t));
+        writer.Append(hash, records.data() + pos + sizeof(uint64_t));
+      }
+    }
+    writer.Finish();
+  }
+
+  TakeFiles();
+  level_ = level;
+  AddPass();
+}
+
+uint32_t SpillPartitions::PartitionOf(uint64_t hash) const {
+  uint32_t shift = 64 - kPartitionBits * (level_ + 1);
+  return static_cast<uint32_t>(((hash * kPartitionMix) >> shift) &
+                               (kNumPartitions - 1));
+}
+
+void SpillPartitions::WriteToPartition(uint32_t part, const char *data,
+                                       uint64_t size) {
+  latches_[part].Lock();
+  try {
+    if (files_[part] == nullptr) {
+      files_[part].reset(new SpillFile());
+    }
+    files_[part]->Write(data, size);
+  } catch (...) {
+    latches_[part].Unlock();
+    throw;
+  }
+  latches_[part].Unlock();
+
+  spilled_.store(true);
+  exec_ctx_.AddSpilledBytes(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// Writer
+///
+////////////////////////////////////////////////////////////////////////////////
+
+SpillPartitions::Writer::Writer(SpillPartitions &partitions)
+    : partitions_(partitions) {}
+
+SpillPartitions::Writer::~Writer() {
+  try {
+    Finish();
+  } catch (const ExecutorException &e) {
+    LOG_ERROR("%s", e.what());
+  }
+}
+
+void SpillPartitions::Writer::Append(uint64_t hash, const char *payload) {
+  uint32_t part = partitions_.PartitionOf(hash);
+  auto &buffer = buffers_[part];
+
+  auto *hash_bytes = reinterpret_cast<const char *>(&hash);
+  buffer.insert(buffer.end(), hash_bytes, hash_bytes + sizeof(uint64_t));
+  buffer.insert(buffer.end(), payload,
+                payload + partitions_.RecordSize() - sizeof(uint64_t));
+
+  if (buffer.size() >= kWriteBufferSize) {
+    partitions_.WriteToPartition(part, buffer.data(), buffer.size());
+    buffer.clear();
+  }
+}
+
+void SpillPartitions::Writer::Finish() {
+  for (uint32_t part = 0; part < kNumPartitions; part++) {
+    auto &buffer = buffers_[part];
+    if (!buffer.empty()) {
+      partitions_.WriteToPartition(part, buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
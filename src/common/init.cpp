@@ -12,6 +12,9 @@
 
 #include "common/init.h"
 
+#include <algorithm>
+#include <thread>
+
 #include <gflags/gflags.h>
 #include <google/protobuf/stubs/common.h>
 
@@ -21,7 +24,11 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "logging/checkpoint_manager_factory.h"
+#include "logging/log_manager_factory.h"
+#include "optimizer/stats/stats_storage.h"
 #include "settings/settings_manager.h"
+#include "storage/zone_map_manager.h"
 #include "threadpool/mono_queue_pool.h"
 #include "tuning/index_tuner.h"
 #include "tuning/layout_tuner.h"
@@ -51,7 +58,10 @@ void PelotonInit::Initialize() {
   // start parallel execution pool
   threadpool::MonoQueuePool::GetExecutionInstance().Startup();
 
-  int parallelism = (CONNECTION_THREAD_COUNT + 3) / 4;
+  // one active tile group and indirection array per core, so that concurrent
+  // inserts don't contend on them. a table allocates them on first use.
+  int parallelism = std::max<int>(std::thread::hardware_concurrency(),
+                                  (CONNECTION_THREAD_COUNT + 3) / 4);
   storage::DataTable::SetActiveTileGroupCount(parallelism);
   storage::DataTable::SetActiveIndirectionArrayCount(parallelism);
 
@@ -91,8 +101,27 @@ void PelotonInit::Initialize() {
 
   txn_manager.CommitTransaction(txn);
 
+  // start the log once the catalog is bootstrapped, so bootstrapping doesn't
+  // wait for group commits
+  if (settings::SettingsManager::GetBool(settings::SettingId::wal)) {
+    logging::LogManagerFactory::GetInstance().StartLogging();
+  }
+
+  // start periodic checkpoints
+  if (settings::SettingsManager::GetBool(settings::SettingId::checkpointing)) {
+    logging::CheckpointManagerFactory::GetInstance().StartCheckpointing();
+  }
+
   // Initialize the Statement Cache Manager
   StatementCacheManager::Init();
+
+  // start persisting in-memory zone maps to the catalog
+  storage::ZoneMapManager::GetInstance()->StartPersister();
+
+  // start refreshing stale table statistics
+  if (settings::SettingsManager::GetBool(settings::SettingId::auto_analyze)) {
+    optimizer::StatsStorage::GetInstance()->StartAutoAnalyze();
+  }
 }
 
 void PelotonInit::Shutdown() {
@@ -108,6 +137,19 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down the auto analyzer before the transactions stop
+  if (settings::SettingsManager::GetBool(settings::SettingId::auto_analyze)) {
+    optimizer::StatsStorage::GetInstance()->StopAutoAnalyze();
+  }
+
+  // shut down zone map persister
+  storage::ZoneMapManager::GetInstance()->StopPersister();
+
+  // shut down the checkpointer while the epochs still advance
+  if (settings::SettingsManager::GetBool(settings::SettingId::checkpointing)) {
+    logging::CheckpointManagerFactory::GetInstance().StopCheckpointing();
+  }
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
@@ -117,9 +159,17 @@ void PelotonInit::Shutdown() {
   // shutdown execution thread pool
   threadpool::MonoQueuePool::GetExecutionInstance().Shutdown();
 
+  // finish the background compilations
+  threadpool::MonoQueuePool::GetCompileInstance().Shutdown();
+
   // stop worker pool
   threadpool::MonoQueuePool::GetInstance().Shutdown();
 
+  // stop the log after the last commit
+  if (settings::SettingsManager::GetBool(settings::SettingId::wal)) {
+    logging::LogManagerFactory::GetInstance().StopLogging();
+  }
+
   // stop indextuner thread pool
   if (settings::SettingsManager::GetBool(settings::SettingId::brain)) {
     threadpool::MonoQueuePool::GetBrainInstance().Shutdown();
@@ -1597,6 +1597,9 @@ std::string JoinTypeToString(JoinType type) {
     case JoinType::SEMI: {
       return "SEMI";
     }
+    case JoinType::ANTI: {
+      return "ANTI";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for JoinType value '%d'",
@@ -1620,6 +1623,8 @@ JoinType StringToJoinType(const std::string &str) {
     return JoinType::OUTER;
   } else if (upper_str == "SEMI") {
     return JoinType::SEMI;
+  } else if (upper_str == "ANTI") {
+    return JoinType::ANTI;
   } else {
     throw ConversionException(StringUtil::Format(
         "No JoinType conversion from string '%s'", upper_str.c_str()));
@@ -2259,6 +2264,9 @@ std::string ProtocolTypeToString(ProtocolType type) {
     case ProtocolType::TIMESTAMP_ORDERING: {
       return "TIMESTAMP_ORDERING";
     }
+    case ProtocolType::OPTIMISTIC: {
+      return "OPTIMISTIC";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for ProtocolType value '%d'",
@@ -2274,6 +2282,8 @@ ProtocolType StringToProtocolType(const std::string &str) {
     return ProtocolType::INVALID;
   } else if (upper_str == "TIMESTAMP_ORDERING") {
     return ProtocolType::TIMESTAMP_ORDERING;
+  } else if (upper_str == "OPTIMISTIC") {
+    return ProtocolType::OPTIMISTIC;
   } else {
     throw ConversionException(StringUtil::Format(
         "No ProtocolType conversion from string '%s'", upper_str.c_str()));
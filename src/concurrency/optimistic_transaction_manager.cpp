@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimistic_transaction_manager.cpp
+//
+// Identification: src/concurrency/optimistic_transaction_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/optimistic_transaction_manager.h"
+
+#include <atomic>
+#include <cinttypes>
+
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_context.h"
+#include "storage/storage_manager.h"
+
+namespace peloton {
+namespace concurrency {
+
+OptimisticTransactionManager &OptimisticTransactionManager::GetInstance(
+    const ProtocolType protocol, const IsolationLevelType isolation,
+    const ConflictAvoidanceType conflict) {
+  static OptimisticTransactionManager txn_manager;
+
+  txn_manager.Init(protocol, isolation, conflict);
+
+  return txn_manager;
+}
+
+bool OptimisticTransactionManager::AcquireOwnership(
+    TransactionContext *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id) {
+  // readers leave no trace on the tuple, so there is no need to latch it.
+  if (tile_group_header->SetAtomicTransactionId(
+          tuple_id, current_txn->GetTransactionId()) == false) {
+    return false;
+  }
+
+  // keep the header the same as the timestamp ordering protocol leaves it.
+  tile_group_header->SetLastReaderCommitId(tuple_id,
+                                           current_txn->GetCommitId());
+  return true;
+}
+
+bool OptimisticTransactionManager::PerformRead(
+    TransactionContext *const current_txn, const ItemPointer &read_location,
+    storage::TileGroupHeader *tile_group_header, bool acquire_ownership) {
+  //////////////////////////////////////////////////////////
+  //// handle READ_ONLY, SNAPSHOT and READ_COMMITTED
+  //////////////////////////////////////////////////////////
+  // these don't set read timestamps under timestamp ordering either.
+  if (current_txn->IsReadOnly() ||
+      (current_txn->GetIsolationLevel() != IsolationLevelType::SERIALIZABLE &&
+       current_txn->GetIsolationLevel() !=
+           IsolationLevelType::REPEATABLE_READS)) {
+    return TimestampOrderingTransactionManager::PerformRead(
+        current_txn, read_location, tile_group_header, acquire_ownership);
+  }
+
+  //////////////////////////////////////////////////////////
+  //// handle SERIALIZABLE and REPEATABLE_READS
+  //////////////////////////////////////////////////////////
+  oid_t tuple_id = read_location.offset;
+
+  LOG_TRACE("PerformRead (%u, %u)\n", read_location.block,
+            read_location.offset);
+
+  if (IsOwner(current_txn, tile_group_header, tuple_id) == true) {
+    // this version must already be in the read/write set.
+    return true;
+  }
+
+  if (acquire_ownership == true) {
+    if (IsOwnable(current_txn, tile_group_header, tuple_id) == false) {
+      // Cannot own
+      return false;
+    }
+    if (AcquireOwnership(current_txn, tile_group_header, tuple_id) == false) {
+      // Cannot acquire ownership
+      return false;
+    }
+
+    // Record RWType::READ_OWN
+    current_txn->RecordReadOwn(read_location);
+    return true;
+  }
+
+  // a version owned by a concurrent transaction can still be read, the
+  // validation fails if the owner hasn't finished by then.
+  current_txn->RecordRead(read_location);
+  return true;
+}
+
+bool OptimisticTransactionManager::ValidateReadSet(
+    TransactionContext *const current_txn) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto transaction_id = current_txn->GetTransactionId();
+
+  oid_t last_tile_group_id = INVALID_OID;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+
+  for (const auto &tuple_entry : current_txn->GetReadWriteSet()) {
+    if (tuple_entry.second != RWType::READ) {
+      continue;
+    }
+
+    oid_t tile_group_id = tuple_entry.first.block;
+    oid_t tuple_slot = tuple_entry.first.offset;
+
+    if (tile_group_id != last_tile_group_id) {
+      tile_group_header =
+          storage_manager->GetTileGroup(tile_group_id)->GetHeader();
+      last_tile_group_id = tile_group_id;
+    }
+
+    // a concurrent transaction is writing a newer version.
+    auto tuple_txn_id = tile_group_header->GetTransactionId(tuple_slot);
+    if (tuple_txn_id != INITIAL_TXN_ID && tuple_txn_id != transaction_id) {
+      return false;
+    }
+
+    // a writer sets the end commit id before it releases the version, so the
+    // end commit id must be read after the owner to see it.
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // a concurrent transaction has committed a newer version.
+    if (tile_group_header->GetEndCommitId(tuple_slot) != MAX_CID) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ResultType OptimisticTransactionManager::CommitTransaction(
+    TransactionContext *const current_txn) {
+  if (current_txn->IsReadOnly() ||
+      (current_txn->GetIsolationLevel() != IsolationLevelType::SERIALIZABLE &&
+       current_txn->GetIsolationLevel() !=
+           IsolationLevelType::REPEATABLE_READS)) {
+    return TimestampOrderingTransactionManager::CommitTransaction(current_txn);
+  }
+
+  // the write set is locked already. the commit id is taken from the current
+  // epoch, which serializes the transaction after every transaction whose
+  // versions it has read.
+  cid_t commit_id = EpochManagerFactory::GetInstance().EnterEpoch(
+      current_txn->GetThreadId(), TimestampType::COMMIT);
+  current_txn->SetCommitId(commit_id);
+
+  COMPILER_MEMORY_FENCE;
+
+  if (ValidateReadSet(current_txn) == false) {
+    LOG_TRACE("Validation failed for txn : %" PRId64,
+              current_txn->GetTransactionId());
+    return AbortTransaction(current_txn);
+  }
+
+  return TimestampOrderingTransactionManager::CommitTransaction(current_txn);
+}
+
+}  // namespace concurrency
+}  // namespace peloton
@@ -597,13 +597,13 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   //////////////////////////////////////////////////////////
 
   auto storage_manager = storage::StorageManager::GetInstance();
-  auto &log_manager = logging::LogManager::GetInstance();
-
-  log_manager.StartLogging();
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
 
   // generate transaction id.
   cid_t end_commit_id = current_txn->GetCommitId();
 
+  log_manager.LogBegin(end_commit_id);
+
   auto &rw_set = current_txn->GetReadWriteSet();
   auto &rw_object_set = current_txn->GetCreateDropSet();
 
@@ -750,6 +750,7 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
 
   ResultType result = current_txn->GetResult();
 
+  // returns once the log records of this transaction are durable
   log_manager.LogEnd();
 
   EndTransaction(current_txn);
@@ -84,6 +84,7 @@ void TransactionContext::Init(const size_t thread_id,
   gc_object_set_ = std::make_shared<GCObjectSet>();
 
   on_commit_triggers_.reset();
+  on_end_callbacks_.clear();
 }
 
 RWType TransactionContext::GetRWType(const ItemPointer &location) {
@@ -94,6 +95,11 @@ RWType TransactionContext::GetRWType(const ItemPointer &location) {
   return RWType::INVALID;
 }
 
+void TransactionContext::RecordRead(const ItemPointer &location) {
+  // a version that is already in the read/write set keeps its type.
+  rw_set_.insert(std::make_pair(location, RWType::READ));
+}
+
 void TransactionContext::RecordReadOwn(const ItemPointer &location) {
   PELOTON_ASSERT(rw_set_.find(location) == rw_set_.end() ||
                  (rw_set_[location] != RWType::DELETE &&
@@ -157,5 +163,12 @@ void TransactionContext::ExecOnCommitTriggers() {
   }
 }
 
+void TransactionContext::ExecOnEndCallbacks() {
+  for (auto &callback : on_end_callbacks_) {
+    callback();
+  }
+  on_end_callbacks_.clear();
+}
+
 }  // namespace concurrency
 }  // namespace peloton
@@ -41,7 +41,8 @@ TransactionContext *TransactionManager::BeginTransaction(
     cid_t read_id = EpochManagerFactory::GetInstance().EnterEpoch(
         thread_id, TimestampType::SNAPSHOT_READ);
 
-    if (protocol_ == ProtocolType::TIMESTAMP_ORDERING) {
+    if (protocol_ == ProtocolType::TIMESTAMP_ORDERING ||
+        protocol_ == ProtocolType::OPTIMISTIC) {
       cid_t commit_id = EpochManagerFactory::GetInstance().EnterEpoch(
           thread_id, TimestampType::COMMIT);
 
@@ -75,6 +76,7 @@ void TransactionManager::EndTransaction(TransactionContext *current_txn) {
   if (current_txn->GetResult() == ResultType::SUCCESS) {
     current_txn->ExecOnCommitTriggers();
   }
+  current_txn->ExecOnEndCallbacks();
 
   // log RWSet and result stats
   const auto &stats_type = static_cast<StatsType>(
@@ -279,6 +279,8 @@ void AbstractJoinExecutor::BufferLeftTile(LogicalTile *left_tile) {
   switch (join_type_) {
     case JoinType::LEFT:
     case JoinType::OUTER:
+    case JoinType::SEMI:
+    case JoinType::ANTI:
       UpdateLeftJoinRowSets();
       break;
     default:
@@ -315,6 +317,8 @@ void AbstractJoinExecutor::UpdateJoinRowSets() {
   PELOTON_ASSERT(join_type_ != JoinType::INVALID);
   switch (join_type_) {
     case JoinType::LEFT:
+    case JoinType::SEMI:
+    case JoinType::ANTI:
       UpdateLeftJoinRowSets();
       break;
     case JoinType::RIGHT:
@@ -381,6 +385,10 @@ bool AbstractJoinExecutor::BuildOuterJoinOutput() {
       break;
     }
 
+    // Semi and anti joins produce the left rows with and without a match
+    case JoinType::SEMI:
+    case JoinType::ANTI: { return BuildLeftJoinOutput(); }
+
     case JoinType::INNER: { return false; }
 
     default: {
@@ -393,18 +401,30 @@ bool AbstractJoinExecutor::BuildOuterJoinOutput() {
 }
 /*
   * build left join output by adding null rows for every row from right tile
-  * which doesn't have a match
+  * which doesn't have a match. A semi join instead outputs the rows that do
+  * have a match.
   */
 
 bool AbstractJoinExecutor::BuildLeftJoinOutput() {
   while (left_matching_idx < no_matching_left_row_sets_.size()) {
-    if (no_matching_left_row_sets_[left_matching_idx].empty()) {
+    auto left_tile = left_result_tiles_[left_matching_idx].get();
+    auto &no_matching_rows = no_matching_left_row_sets_[left_matching_idx];
+    std::vector<oid_t> left_rows;
+    if (join_type_ == JoinType::SEMI) {
+      for (auto left_row_itr : *left_tile) {
+        if (no_matching_rows.count(left_row_itr) == 0) {
+          left_rows.push_back(left_row_itr);
+        }
+      }
+    } else {
+      left_rows.assign(no_matching_rows.begin(), no_matching_rows.end());
+    }
+    if (left_rows.empty()) {
       left_matching_idx++;
       continue;
     }
 
     std::unique_ptr<LogicalTile> output_tile(nullptr);
-    auto left_tile = left_result_tiles_[left_matching_idx].get();
     LogicalTile::PositionListsBuilder pos_lists_builder;
     if (right_result_tiles_.size() == 0) {
       // no tile information for right tile. construct a output tile from left
@@ -420,8 +440,8 @@ bool AbstractJoinExecutor::BuildLeftJoinOutput() {
       pos_lists_builder =
           LogicalTile::PositionListsBuilder(left_tile, right_tile);
     }
-    // add rows with null values on the left
-    for (auto left_row_itr : no_matching_left_row_sets_[left_matching_idx]) {
+    // add rows with null values on the right
+    for (auto left_row_itr : left_rows) {
       pos_lists_builder.AddRightNullRow(left_row_itr);
     }
 
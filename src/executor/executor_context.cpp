@@ -12,6 +12,7 @@
 
 #include "executor/executor_context.h"
 
+#include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
 
 namespace peloton {
@@ -28,7 +29,13 @@ ExecutorContext::ExecutorContext(concurrency::TransactionContext *transaction,
     : transaction_(transaction),
       parameters_(std::move(parameters)),
       storage_manager_(storage::StorageManager::GetInstance()),
-      thread_states_(pool_) {}
+      copy_input_(nullptr),
+      thread_states_(pool_),
+      memory_limit_(static_cast<size_t>(settings::SettingsManager::GetInt(
+                        settings::SettingId::query_memory_limit)) *
+                    1024 * 1024),
+      spilled_bytes_(0),
+      spill_passes_(0) {}
 
 concurrency::TransactionContext *ExecutorContext::GetTransaction() const {
   return transaction_;
@@ -46,10 +53,39 @@ codegen::QueryParameters &ExecutorContext::GetParams() { return parameters_; }
 
 type::EphemeralPool *ExecutorContext::GetPool() { return &pool_; }
 
+const std::string *ExecutorContext::GetCopyInput() const {
+  return copy_input_;
+}
+
+void ExecutorContext::SetCopyInput(const std::string *copy_input) {
+  copy_input_ = copy_input;
+}
+
 ExecutorContext::ThreadStates &ExecutorContext::GetThreadStates() {
   return thread_states_;
 }
 
+bool ExecutorContext::ExceedsMemoryLimit(size_t bytes) const {
+  return memory_limit_ != 0 &&
+         pool_.GetAllocatedBytes() + bytes > memory_limit_;
+}
+
+void ExecutorContext::AddSpilledBytes(uint64_t bytes) {
+  spilled_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void ExecutorContext::AddSpillPass() {
+  spill_passes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ExecutorContext::GetSpilledBytes() const {
+  return spilled_bytes_.load(std::memory_order_relaxed);
+}
+
+uint64_t ExecutorContext::GetSpillPasses() const {
+  return spill_passes_.load(std::memory_order_relaxed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// ThreadStates
@@ -67,7 +103,7 @@ void ExecutorContext::ThreadStates::Reset(const uint32_t state_size) {
   num_threads_ = 0;
   // Always fill out to nearest cache-line to prevent false sharing of states
   // between different threads.
-  uint32_t pad = state_size & ~CACHELINE_SIZE;
+  uint32_t pad = state_size & (CACHELINE_SIZE - 1);
   state_size_ = state_size + (pad != 0 ? CACHELINE_SIZE - pad : pad);
 }
 
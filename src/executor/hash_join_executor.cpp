@@ -76,6 +76,9 @@ bool HashJoinExecutor::DExecute() {
         BufferRightTile(children_[1]->GetOutput());
       }
       right_child_done_ = true;
+      right_has_null_key_ =
+          GetPlanNode<planner::HashJoinPlan>().IsNullAware() &&
+          HasNullRightKey();
     }
 
     // Get next tile from LEFT child
@@ -121,6 +124,14 @@ bool HashJoinExecutor::DExecute() {
       const ContainerTuple<executor::LogicalTile> left_tuple(
           left_tile, left_tile_itr, &left_hashed_col_ids);
 
+      // Semi and anti joins only record whether the left row has a match
+      if (join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
+        if (HasMatch(left_tuple, left_hashed_col_ids)) {
+          RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_itr);
+        }
+        continue;
+      }
+
       // Find matching tuples in the hash table built on top of the right table
       auto right_tuples = hash_table.find(left_tuple);
 
@@ -193,5 +204,72 @@ bool HashJoinExecutor::DExecute() {
   }
 }
 
+/**
+ * @brief Check whether a left row satisfies the join predicate with a row in
+ * the hash table. Null-aware anti joins also treat a NULL key as a match,
+ * as a row with a NULL key is not produced unless the right side is empty.
+ * @return true if the left row has a match, false otherwise.
+ */
+bool HashJoinExecutor::HasMatch(
+    const ContainerTuple<LogicalTile> &left_tuple,
+    const std::vector<oid_t> &left_hashed_col_ids) {
+  bool null_aware = GetPlanNode<planner::HashJoinPlan>().IsNullAware();
+  if (null_aware && right_has_null_key_) {
+    return true;
+  }
+  for (auto col_id : left_hashed_col_ids) {
+    if (left_tuple.GetValue(col_id).IsNull()) {
+      return null_aware;
+    }
+  }
+
+  auto &hash_table = hash_executor_->GetHashTable();
+  auto right_tuples = hash_table.find(left_tuple);
+  if (right_tuples == hash_table.end()) {
+    return false;
+  }
+  if (predicate_ == nullptr) {
+    return true;
+  }
+  // Evaluate the predicate on every right row with the same key, as it may
+  // hold for some of them only
+  for (auto &location : right_tuples->second) {
+    const ContainerTuple<LogicalTile> right_tuple(
+        right_result_tiles_[location.first].get(), location.second);
+    if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
+            .IsTrue()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Check whether a row of the right child has a NULL key.
+ * @return true if a right key is NULL, false otherwise.
+ */
+bool HashJoinExecutor::HasNullRightKey() {
+  std::vector<const expression::AbstractExpression *> right_hashed_cols;
+  GetPlanNode<planner::HashJoinPlan>().GetRightHashKeys(right_hashed_cols);
+  std::vector<oid_t> right_hashed_col_ids;
+  for (auto &hashkey : right_hashed_cols) {
+    PELOTON_ASSERT(hashkey->GetExpressionType() == ExpressionType::VALUE_TUPLE);
+    auto tuple_value =
+        reinterpret_cast<const expression::TupleValueExpression *>(hashkey);
+    right_hashed_col_ids.push_back(tuple_value->GetColumnId());
+  }
+
+  for (auto &right_tile : right_result_tiles_) {
+    for (auto right_tile_itr : *right_tile) {
+      for (auto col_id : right_hashed_col_ids) {
+        if (right_tile->GetValue(right_tile_itr, col_id).IsNull()) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -115,16 +115,28 @@ bool HybridScanExecutor::DInit() {
       current_tile_group_offset_ = START_OID;
     } else {
       current_tile_group_offset_ = indexed_tile_offset_ + 1;
+      oid_t tile_group_offset = current_tile_group_offset_;
+      if (tile_group_offset >= table_tile_group_count_) {
+        tile_group_offset = table_tile_group_count_ - 1;
+      }
+
+      // Skip the tile groups that have been compacted and freed
       std::shared_ptr<storage::TileGroup> tile_group;
-      if (current_tile_group_offset_ < table_tile_group_count_) {
-        tile_group = table_->GetTileGroup(current_tile_group_offset_);
-      } else {
-        tile_group = table_->GetTileGroup(table_tile_group_count_ - 1);
+      while (tile_group_offset < table_tile_group_count_) {
+        tile_group = table_->GetTileGroup(tile_group_offset++);
+        if (tile_group != nullptr) {
+          break;
+        }
       }
 
-      oid_t tuple_id = 0;
-      ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-      block_threshold = location.block;
+      if (tile_group != nullptr) {
+        oid_t tuple_id = 0;
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        block_threshold = location.block;
+      } else {
+        // The sequential scan finds nothing, keep all the index results
+        block_threshold = INVALID_OID;
+      }
     }
 
     result_itr_ = START_OID;
@@ -189,6 +201,9 @@ bool HybridScanExecutor::SeqScanUtil() {
   while (current_tile_group_offset_ < table_tile_group_count_) {
     LOG_TRACE("Current tile group offset : %u", current_tile_group_offset_);
     auto tile_group = table_->GetTileGroup(current_tile_group_offset_++);
+    if (tile_group == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group->GetHeader();
 
     oid_t active_tuple_count = tile_group->GetNextTupleSlot();
@@ -380,6 +395,10 @@ bool HybridScanExecutor::ExecPrimaryIndexLookup() {
 
     auto storage_manager = storage::StorageManager::GetInstance();
     auto tile_group = storage_manager->GetTileGroup(tuple_location.block);
+    // the tile group of a deleted tuple has been freed by the GC.
+    if (tile_group == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group.get()->GetHeader();
 
     // perform transaction read
@@ -217,6 +217,10 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   for (auto tuple_location_ptr : tuple_location_ptrs) {
     ItemPointer tuple_location = *tuple_location_ptr;
     auto tile_group = storage_manager->GetTileGroup(tuple_location.block);
+    // the tile group of a deleted tuple has been freed by the GC.
+    if (tile_group == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group.get()->GetHeader();
     size_t chain_length = 0;
 
@@ -464,6 +468,10 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
     ItemPointer tuple_location = *tuple_location_ptr;
     if (tuple_location.block != last_block) {
       tile_group = storage_manager->GetTileGroup(tuple_location.block);
+      // the tile group of a deleted tuple has been freed by the GC.
+      if (tile_group == nullptr) {
+        continue;
+      }
       tile_group_header = tile_group.get()->GetHeader();
     }
 #ifdef LOG_TRACE_ENABLED
@@ -15,6 +15,7 @@
 
 #include "catalog/schema.h"
 #include "common/macros.h"
+#include "executor/result_encoder.h"
 #include "storage/data_table.h"
 #include "storage/layout.h"
 #include "storage/tile.h"
@@ -171,7 +172,7 @@ type::Value LogicalTile::GetValue(oid_t tuple_id, oid_t column_id) {
 
   if (base_tuple_id == NULL_OID) {
     return type::ValueFactory::GetNullValueByType(
-        base_tile->GetSchema()->GetType(column_id));
+        base_tile->GetSchema()->GetType(cp.origin_column_id));
   } else {
     return base_tile->GetValue(base_tuple_id, cp.origin_column_id);
   }
@@ -435,59 +436,37 @@ std::vector<std::vector<std::string>> LogicalTile::GetAllValuesAsStrings(
     const std::vector<int> &result_format, bool use_to_string_null) {
   std::vector<std::vector<std::string>> string_tile;
   for (oid_t tuple_itr = 0; tuple_itr < total_tuples_; tuple_itr++) {
-    std::vector<std::string> row;
-    std::string empty_string;
     if (visible_rows_[tuple_itr] == false) continue;
+    std::vector<std::string> row(schema_.size());
     for (oid_t column_itr = 0; column_itr < schema_.size(); column_itr++) {
-      const LogicalTile::ColumnInfo &cp = schema_[column_itr];
-      oid_t base_tuple_id = position_lists_[cp.position_list_idx][tuple_itr];
-      // get the value from the base physical tile
-      type::Value val;
-      if (base_tuple_id == NULL_OID) {
-        val = type::ValueFactory::GetNullValueByType(
-            cp.base_tile->GetSchema()->GetType(cp.origin_column_id));
-      } else {
-        val = cp.base_tile->GetValue(base_tuple_id, cp.origin_column_id);
-      }
-
-      // LM: I put varchar here because we don't need to do endian conversion
-      // for them, and assuming binary and text for a varchar are the same.
-      if (result_format[column_itr] == 0 ||
-          cp.base_tile->GetSchema()->GetType(cp.origin_column_id) ==
-              type::TypeId::VARCHAR) {
-        // don't let to_string function decide what NULL value is
-        if (use_to_string_null == false && val.IsNull() == true) {
-          // materialize Null values as 0B string
-          row.push_back(empty_string);
-        } else {
-          // otherwise, materialize using ToString
-          row.push_back(val.ToString());
-        }
-      } else {
-        auto data_length =
-            cp.base_tile->GetSchema()->GetLength(cp.origin_column_id);
-        LOG_TRACE("data length: %ld", data_length);
-        char *val_binary = new char[data_length];
-        bool is_inlined = false;
-
-        val.SerializeTo(val_binary, is_inlined, nullptr);
-
-        // convert little endian to big endian...
-        // TODO: This is stupid.... But I think this hack is fine for now.
-        for (size_t i = 0; i < (data_length >> 1); ++i) {
-          auto tmp_char = val_binary[i];
-          val_binary[i] = val_binary[data_length - i - 1];
-          val_binary[data_length - i - 1] = tmp_char;
-        }
-
-        row.push_back(std::string(val_binary, data_length));
-      }
+      ResultEncoder::Encode(GetValue(tuple_itr, column_itr),
+                            ResultEncoder::GetFormat(result_format, column_itr),
+                            use_to_string_null, row[column_itr]);
     }
-    string_tile.push_back(row);
+    string_tile.push_back(std::move(row));
   }
   return string_tile;
 }
 
+void LogicalTile::GetAllValuesAsResults(const std::vector<int> &result_format,
+                                        std::vector<std::string> &values) {
+  std::vector<int> formats(schema_.size());
+  for (oid_t column_itr = 0; column_itr < schema_.size(); column_itr++) {
+    formats[column_itr] = ResultEncoder::GetFormat(result_format, column_itr);
+  }
+
+  values.reserve(values.size() + GetTupleCount() * schema_.size());
+  for (oid_t tuple_itr = 0; tuple_itr < total_tuples_; tuple_itr++) {
+    if (visible_rows_[tuple_itr] == false) continue;
+    for (oid_t column_itr = 0; column_itr < schema_.size(); column_itr++) {
+      // Encode in place, the value never goes through a temporary string
+      values.emplace_back();
+      ResultEncoder::Encode(GetValue(tuple_itr, column_itr),
+                            formats[column_itr], false, values.back());
+    }
+  }
+}
+
 const std::string LogicalTile::GetInfo() const {
   std::ostringstream os;
   os << "LOGICAL TILE [TotalTuples=" << total_tuples_ << "]" << std::endl;
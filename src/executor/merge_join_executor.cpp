@@ -93,7 +93,8 @@ bool MergeJoinExecutor::DExecute() {
       left_child_done_ = true;
       // if we know the join type is left join, we don't have to get the
       // tiles from right child anymore.
-      if (join_type_ == JoinType::LEFT || join_type_ == JoinType::INNER) {
+      if (join_type_ == JoinType::LEFT || join_type_ == JoinType::INNER ||
+          join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
         return BuildOuterJoinOutput();
       } else {
         // otherwise, try again
@@ -196,8 +197,12 @@ bool MergeJoinExecutor::DExecute() {
          left_tile_row_itr < left_end_row; left_tile_row_itr++) {
       for (size_t right_tile_row_itr = right_start_row;
            right_tile_row_itr < right_end_row; right_tile_row_itr++) {
-        // Insert a tuple into the output logical tile
-        pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
+        // Semi and anti joins output the left tuples after the join, so they
+        // only record the match
+        if (join_type_ != JoinType::SEMI && join_type_ != JoinType::ANTI) {
+          // Insert a tuple into the output logical tile
+          pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
+        }
 
         RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_row_itr);
         RecordMatchedRightRow(right_result_tiles_.size() - 1,
@@ -48,6 +48,8 @@ bool NestedLoopJoinExecutor::DInit() {
   right_result_itr_ = 0;
 
   PELOTON_ASSERT(left_result_tiles_.empty());
+  left_row_matched_ = false;
+  left_rows_.clear();
 
   return true;
 }
@@ -140,6 +142,11 @@ bool NestedLoopJoinExecutor::DExecute() {
 
         // Go over every pair of tuples in left and right logical tiles
         for (auto right_tile_row_itr : *right_tile) {
+          // Semi and anti joins only need one match for the left tuple
+          if (left_row_matched_) {
+            break;
+          }
+
           // Insert a tuple into the output logical tile
           // First, copy the elements in left logical tile's tuple
           LOG_TRACE("Insert a tuple into the output logical tile");
@@ -156,8 +163,16 @@ bool NestedLoopJoinExecutor::DExecute() {
               LOG_TRACE("Not math join predicate");
               continue;
             }
+            // A NULL predicate doesn't match for semi and anti joins either
+            if (IsSemiOrAntiJoin() && !eval.IsTrue()) {
+              continue;
+            }
             LOG_TRACE("Find a tuple with join predicate");
           }
+          if (IsSemiOrAntiJoin()) {
+            left_row_matched_ = true;
+            break;
+          }
           pos_lists_builder.AddRow(left_tile_row_itr_, right_tile_row_itr);
         }  // Outer loop of NLJ
 
@@ -179,12 +194,23 @@ bool NestedLoopJoinExecutor::DExecute() {
           LOG_TRACE("right child is done, but left is not, so reset right");
           children_[1]->ResetState();
 
+          // The right table decides whether a semi or anti join produces the
+          // left tuple
+          if ((join_type_ == JoinType::SEMI && left_row_matched_) ||
+              (join_type_ == JoinType::ANTI && !left_row_matched_)) {
+            left_rows_.push_back(left_tile_row_itr_);
+          }
+          left_row_matched_ = false;
+
           // When all right table is done, examine whether left tile is done
           // If left tile is done, next loop will directly execute child[0]
           if (left_tile_row_itr_ == left_tile_->GetTupleCount() - 1) {
             LOG_TRACE("left tile is done");
             // Set up flag and go the execute child 0 to get the next tile
             left_tile_done_ = true;
+            if (BuildSemiOrAntiJoinOutput()) {
+              return true;
+            }
           } else {
             // Move the row to the next one in left tile
             LOG_TRACE("Advance left row");
@@ -225,5 +251,28 @@ bool NestedLoopJoinExecutor::DExecute() {
   }  // end the very beginning for loop
 }
 
+/**
+ * @brief Output the tuples of the left tile a semi or anti join produces.
+ * @return true if there is an output tile, false otherwise.
+ */
+bool NestedLoopJoinExecutor::BuildSemiOrAntiJoinOutput() {
+  if (left_rows_.empty()) {
+    return false;
+  }
+
+  auto output_tile =
+      BuildOutputLogicalTile(left_tile_.get(), nullptr, proj_schema_);
+  LogicalTile::PositionListsBuilder pos_lists_builder(
+      &(left_tile_->GetPositionLists()), nullptr);
+  for (auto left_row_itr : left_rows_) {
+    pos_lists_builder.AddRightNullRow(left_row_itr);
+  }
+  left_rows_.clear();
+
+  output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+  SetOutput(output_tile.release());
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -20,6 +20,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
 #include "executor/executors.h"
+#include "executor/result_encoder.h"
 #include "settings/settings_manager.h"
 #include "storage/tuple_iterator.h"
 
@@ -36,8 +37,10 @@ static void CompileAndExecutePlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     concurrency::TransactionContext *txn,
     const std::vector<type::Value> &params,
+    const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    const std::string *copy_input) {
   LOG_TRACE("Compiling and executing query ...");
 
   // Perform binding
@@ -52,38 +55,52 @@ static void CompileAndExecutePlan(
   // The executor context for this execution
   executor::ExecutorContext executor_context{
       txn, codegen::QueryParameters(*plan, params)};
+  executor_context.SetCopyInput(copy_input);
 
   // Check if we have a cached compiled plan already
-  codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
+  std::shared_ptr<codegen::Query> query =
+      codegen::QueryCache::Instance().Find(plan);
   if (query == nullptr) {
     codegen::QueryCompiler compiler;
     auto compiled_query = compiler.Compile(
         *plan, executor_context.GetParams().GetQueryParametersMap(), consumer);
-    compiled_query->Compile();
+    if (settings::SettingsManager::GetBool(
+            settings::SettingId::codegen_adaptive)) {
+      compiled_query->CompileAsync();
+    } else {
+      compiled_query->Compile();
+    }
 
     // Grab an instance to the plan
-    query = compiled_query.get();
+    query = std::move(compiled_query);
 
     // Insert the compiled plan into the cache
-    codegen::QueryCache::Instance().Add(plan, std::move(compiled_query));
+    codegen::QueryCache::Instance().Add(plan, query);
   }
 
   // Execute the query!
-  query->Execute(executor_context, consumer);
+  codegen::Query::RuntimeStats runtime_stats;
+  query->Execute(executor_context, consumer, &runtime_stats);
 
   // Execution complete, setup the results
   executor::ExecutionResult result;
   result.m_processed = executor_context.num_processed;
+  result.m_spilled_bytes = executor_context.GetSpilledBytes();
+  result.m_spill_passes = executor_context.GetSpillPasses();
+  result.m_interpreted_ms = runtime_stats.interpreted_ms;
+  result.m_native_ms = runtime_stats.native_ms;
   result.m_result = ResultType::SUCCESS;
 
-  // Iterate over results
+  // Iterate over results, encoding each value in place
+  const auto &output_tuples = consumer.GetOutputTuples();
   std::vector<ResultValue> values;
-  for (const auto &tuple : consumer.GetOutputTuples()) {
+  values.reserve(output_tuples.size() * columns.size());
+  for (const auto &tuple : output_tuples) {
     for (uint32_t i = 0; i < tuple.tuple_.size(); i++) {
-      auto column_val = tuple.GetValue(i);
-      auto str = column_val.IsNull() ? "" : column_val.ToString();
-      LOG_TRACE("column content: [%s]", str.c_str());
-      values.push_back(std::move(str));
+      values.emplace_back();
+      ResultEncoder::Encode(tuple.GetValue(i),
+                            ResultEncoder::GetFormat(result_format, i), false,
+                            values.back());
     }
   }
 
@@ -127,17 +144,8 @@ static void InterpretPlan(
     // Some executors don't return logical tiles (e.g., Update).
     if (tile.get() != nullptr) {
       LOG_TRACE("Final Answer: %s", tile->GetInfo().c_str());
-      std::vector<std::vector<std::string>> tuples;
-      tuples = tile->GetAllValuesAsStrings(result_format, false);
-
-      // Construct the returned results
-      for (auto &tuple : tuples) {
-        for (unsigned int i = 0; i < tile->GetColumnCount(); i++) {
-          LOG_TRACE("column content: %s",
-                    tuple[i].c_str() != nullptr ? tuple[i].c_str() : "-empty-");
-          values.push_back(std::move(tuple[i]));
-        }
-      }
+      // Values are encoded straight into the returned results
+      tile->GetAllValuesAsResults(result_format, values);
     }
   }
 
@@ -154,7 +162,8 @@ void PlanExecutor::ExecutePlan(
     const std::vector<type::Value> &params,
     const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    const std::string *copy_input) {
   PELOTON_ASSERT(plan != nullptr && txn != nullptr);
   LOG_TRACE("PlanExecutor Start (Txn ID=%" PRId64 ")", txn->GetTransactionId());
 
@@ -163,7 +172,12 @@ void PlanExecutor::ExecutePlan(
 
   try {
     if (codegen_enabled && codegen::QueryCompiler::IsSupported(*plan)) {
-      CompileAndExecutePlan(plan, txn, params, on_complete);
+      CompileAndExecutePlan(plan, txn, params, result_format, on_complete,
+                            copy_input);
+    } else if (copy_input != nullptr) {
+      // Only the compiled CSV scan reads its rows from the COPY input
+      throw NotImplementedException(
+          "COPY FROM STDIN is only supported by compiled queries");
     } else {
       InterpretPlan(plan, txn, params, result_format, on_complete);
     }
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_encoder.cpp
+//
+// Identification: src/executor/result_encoder.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/result_encoder.h"
+
+#include <cstring>
+
+#include "function/date_functions.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// Dates and timestamps are sent relative to 2000-01-01 in binary format
+constexpr int32_t kPostgresEpochJulian = 2451545;
+constexpr int64_t kSecondsPerDay = 86400;
+constexpr int64_t kMicrosPerSecond = 1000000;
+
+template <typename T>
+void AppendBigEndian(ResultValue &result, T val) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, &val, sizeof(T));
+  for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+    result.push_back(static_cast<char>((bits >> shift) & 0xFF));
+  }
+}
+
+// Microseconds since 2000-01-01 00:00:00 of a timestamp. Timestamps are
+// packed as month, day, time zone, year, seconds of the day and
+// microseconds (see TimestampType::ToString()).
+int64_t TimestampToPostgresMicros(uint64_t tm) {
+  int64_t micro = tm % 1000000;
+  tm /= 1000000;
+  int64_t second_of_day = tm % 100000;
+  tm /= 100000;
+  int32_t year = tm % 10000;
+  tm /= 10000;
+  tm /= 27;  // time zone, the fields are already in local time
+  int32_t day = tm % 32;
+  tm /= 32;
+  int32_t month = tm;
+
+  int64_t days =
+      function::DateFunctions::DateToJulian(year, month, day) -
+      kPostgresEpochJulian;
+  return (days * kSecondsPerDay + second_of_day) * kMicrosPerSecond + micro;
+}
+
+}  // namespace
+
+void ResultEncoder::Encode(const type::Value &val, int format,
+                           bool use_to_string_null, ResultValue &result) {
+  result.clear();
+
+  if (val.IsNull()) {
+    // materialize Null values as 0B string, unless asked otherwise
+    if (use_to_string_null) {
+      result = val.ToString();
+    }
+    return;
+  }
+
+  switch (val.GetTypeId()) {
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY: {
+      // Text and binary format are the same bytes. Copy them straight from
+      // the value; its length includes the terminator for VARCHAR.
+      uint32_t len = val.GetLength();
+      if (len != 0 && val.GetTypeId() == type::TypeId::VARCHAR) {
+        len--;
+      }
+      result.assign(val.GetData(), len);
+      return;
+    }
+    default:
+      break;
+  }
+
+  if (format == kBinaryFormat) {
+    EncodeBinary(val, result);
+  } else {
+    result = val.ToString();
+  }
+}
+
+void ResultEncoder::EncodeBinary(const type::Value &val,
+                                 ResultValue &result) {
+  switch (val.GetTypeId()) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      // Both are described to the client as a one byte BOOLEAN
+      result.push_back(val.GetAs<int8_t>() != 0 ? 1 : 0);
+      break;
+    case type::TypeId::SMALLINT:
+      AppendBigEndian(result, val.GetAs<int16_t>());
+      break;
+    case type::TypeId::INTEGER:
+      AppendBigEndian(result, val.GetAs<int32_t>());
+      break;
+    case type::TypeId::BIGINT:
+      AppendBigEndian(result, val.GetAs<int64_t>());
+      break;
+    case type::TypeId::DECIMAL:
+      AppendBigEndian(result, val.GetAs<double>());
+      break;
+    case type::TypeId::DATE:
+      AppendBigEndian(result, val.GetAs<int32_t>() - kPostgresEpochJulian);
+      break;
+    case type::TypeId::TIMESTAMP:
+      AppendBigEndian(result,
+                      TimestampToPostgresMicros(val.GetAs<uint64_t>()));
+      break;
+    default:
+      // Described to the client as TEXT
+      result = val.ToString();
+      break;
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -17,6 +17,7 @@
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/executor_context.h"
+#include "executor/vectorized_filter.h"
 #include "expression/abstract_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "expression/conjunction_expression.h"
@@ -59,6 +60,8 @@ bool SeqScanExecutor::DInit() {
 
   old_predicate_ = predicate_;
 
+  vectorized_filter_ = VectorizedFilter::Create(predicate_, executor_context_);
+
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
 
@@ -95,7 +98,8 @@ bool SeqScanExecutor::DExecute() {
     while (children_[0]->Execute()) {
       std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
 
-      if (predicate_ != nullptr) {
+      if (predicate_ != nullptr &&
+          (vectorized_filter_ == nullptr || !FilterBatch(*tile))) {
         // Invalidate tuples that don't satisfy the predicate.
         for (oid_t tuple_id : *tile) {
           ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
@@ -154,6 +158,10 @@ bool SeqScanExecutor::DExecute() {
     while (current_tile_group_offset_ < table_tile_group_count_) {
       auto tile_group =
           target_table_->GetTileGroup(current_tile_group_offset_++);
+      // the tile group has been compacted and freed
+      if (tile_group == nullptr) {
+        continue;
+      }
       auto tile_group_header = tile_group->GetHeader();
 
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
@@ -162,48 +170,44 @@ bool SeqScanExecutor::DExecute() {
       // and applying the predicate.
       std::vector<oid_t> position_list;
       for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-
         auto visibility = transaction_manager.IsVisible(
             current_txn, tile_group_header, tuple_id);
 
         // check transaction visibility
         if (visibility == VisibilityType::OK) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-            auto res = transaction_manager.PerformRead(current_txn,
-                                                       location,
-                                                       tile_group_header,
-                                                       acquire_owner);
-            if (!res) {
-              transaction_manager.SetTransactionResult(current_txn,
-                                                       ResultType::FAILURE);
-              return res;
-            }
-          } else {
-            ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                     tuple_id);
-            LOG_TRACE("Evaluate predicate for a tuple");
-            auto eval =
-                predicate_->Evaluate(&tuple, nullptr, executor_context_);
-            LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-            if (eval.IsTrue()) {
-              position_list.push_back(tuple_id);
-              auto res = transaction_manager.PerformRead(current_txn,
-                                                         location,
-                                                         tile_group_header,
-                                                         acquire_owner);
-              if (!res) {
-                transaction_manager.SetTransactionResult(current_txn,
-                                                         ResultType::FAILURE);
-                return res;
-              } else {
-                LOG_TRACE("Sequential Scan Predicate Satisfied");
-              }
-            }
+          position_list.push_back(tuple_id);
+        }
+      }
+
+      // Evaluate the predicate over all visible tuples at once if possible,
+      // otherwise one tuple at a time.
+      if (predicate_ != nullptr &&
+          (vectorized_filter_ == nullptr ||
+           !vectorized_filter_->Filter(*tile_group, position_list))) {
+        size_t selected = 0;
+        for (oid_t tuple_id : position_list) {
+          ContainerTuple<storage::TileGroup> tuple(tile_group.get(), tuple_id);
+          LOG_TRACE("Evaluate predicate for a tuple");
+          auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_);
+          LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
+          if (eval.IsTrue()) {
+            position_list[selected++] = tuple_id;
           }
         }
+        position_list.resize(selected);
+      }
+
+      for (oid_t tuple_id : position_list) {
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        auto res = transaction_manager.PerformRead(current_txn,
+                                                   location,
+                                                   tile_group_header,
+                                                   acquire_owner);
+        if (!res) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return res;
+        }
       }
 
       // Don't return empty tiles
@@ -258,6 +262,28 @@ void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
   // we should eventually make prediate_ a unique_ptr
   new_predicate_.reset(new_predicate);
   predicate_ = new_predicate;
+  vectorized_filter_ = VectorizedFilter::Create(predicate_, executor_context_);
+}
+
+// Invalidate the rows of the logical tile that don't satisfy the predicate
+// with the vectorized filter. Returns false if the filter can't read the tile.
+bool SeqScanExecutor::FilterBatch(LogicalTile &tile) {
+  std::vector<oid_t> rows(tile.begin(), tile.end());
+  std::vector<oid_t> selection(rows);
+  if (!vectorized_filter_->Filter(tile, selection)) {
+    return false;
+  }
+
+  // Both are sorted, the rows missing in the selection failed the predicate
+  size_t selected = 0;
+  for (oid_t row : rows) {
+    if (selected < selection.size() && selection[selected] == row) {
+      selected++;
+    } else {
+      tile.RemoveVisibility(row);
+    }
+  }
+  return true;
 }
 
 // Transfer a list of equality predicate
@@ -23,6 +23,7 @@
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
 #include "storage/storage_manager.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace executor {
@@ -268,6 +269,8 @@ bool UpdateExecutor::DExecute() {
         // Execute the projections
         project_info_->Evaluate(&old_tuple, &old_tuple, nullptr,
                                 executor_context_);
+        target_table_->GetZoneMap()->UpdateOnUpdate(old_location.block,
+                                                    old_tuple);
 
         transaction_manager.PerformUpdate(current_txn, old_location);
         // we do not need to add any item pointer to statement-level write set
@@ -0,0 +1,392 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_filter.cpp
+//
+// Identification: src/executor/vectorized_filter.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/vectorized_filter.h"
+
+#include <cstring>
+#include <functional>
+
+#include "catalog/schema.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "type/limits.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+bool IsIntegerType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsComparison(ExpressionType type) {
+  switch (type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The comparison with its operands swapped, i.e., a < b is b > a
+ExpressionType FlipComparison(ExpressionType type) {
+  switch (type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return type;
+  }
+}
+
+// Copy the values of the selected tuples out of the tile, clearing the mask
+// of the NULL ones
+template <typename S, typename T>
+void GatherColumn(const char *base, size_t stride,
+                  const std::vector<oid_t> &selection,
+                  const std::vector<oid_t> *position_list, S null, T *values,
+                  uint8_t *mask) {
+  size_t count = selection.size();
+  for (size_t i = 0; i < count; i++) {
+    oid_t tuple_id = position_list == nullptr ? selection[i]
+                                              : (*position_list)[selection[i]];
+    if (tuple_id == NULL_OID) {
+      // The row of an outer join that has no match in this tile
+      values[i] = 0;
+      mask[i] = 0;
+      continue;
+    }
+    S value;
+    std::memcpy(&value, base + tuple_id * stride, sizeof(S));
+    values[i] = static_cast<T>(value);
+    mask[i] &= static_cast<uint8_t>(value != null);
+  }
+}
+
+// AND the comparison of the left values with the right values, or a single
+// right value if the stride is 0, into the mask
+template <typename T, typename Op>
+void CompareColumn(const T *left, const T *right, size_t right_stride,
+                   size_t count, uint8_t *mask, Op op) {
+  if (right_stride == 0) {
+    const T right_value = right[0];
+    for (size_t i = 0; i < count; i++) {
+      mask[i] &= static_cast<uint8_t>(op(left[i], right_value));
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      mask[i] &= static_cast<uint8_t>(op(left[i], right[i]));
+    }
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<VectorizedFilter> VectorizedFilter::Create(
+    const expression::AbstractExpression *predicate,
+    const ExecutorContext *executor_context) {
+  std::unique_ptr<VectorizedFilter> filter(new VectorizedFilter());
+  if (predicate == nullptr ||
+      !AddTerms(predicate, executor_context, filter->terms_)) {
+    return nullptr;
+  }
+  return filter;
+}
+
+bool VectorizedFilter::AddTerms(const expression::AbstractExpression *predicate,
+                                const ExecutorContext *executor_context,
+                                std::vector<Term> &terms) {
+  if (predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    return AddTerms(predicate->GetChild(0), executor_context, terms) &&
+           AddTerms(predicate->GetChild(1), executor_context, terms);
+  }
+  if (!IsComparison(predicate->GetExpressionType()) ||
+      predicate->GetChildrenSize() != 2) {
+    return false;
+  }
+
+  Term term;
+  term.comparison = predicate->GetExpressionType();
+  term.is_decimal = false;
+  if (!GetOperand(predicate->GetChild(0), executor_context, term.left,
+                  term.is_decimal) ||
+      !GetOperand(predicate->GetChild(1), executor_context, term.right,
+                  term.is_decimal)) {
+    return false;
+  }
+
+  // The kernels expect a column on the left
+  if (!term.left.is_column) {
+    if (!term.right.is_column) {
+      return false;
+    }
+    std::swap(term.left, term.right);
+    term.comparison = FlipComparison(term.comparison);
+  }
+  terms.push_back(std::move(term));
+  return true;
+}
+
+bool VectorizedFilter::GetOperand(
+    const expression::AbstractExpression *expression,
+    const ExecutorContext *executor_context, Operand &operand,
+    bool &is_decimal) {
+  type::TypeId type_id;
+  switch (expression->GetExpressionType()) {
+    case ExpressionType::VALUE_TUPLE: {
+      auto *tuple_value =
+          static_cast<const expression::TupleValueExpression *>(expression);
+      if (tuple_value->GetTupleId() != 0) {
+        return false;
+      }
+      operand.is_column = true;
+      operand.column_id = tuple_value->GetColumnId();
+      type_id = tuple_value->GetValueType();
+      break;
+    }
+    case ExpressionType::VALUE_CONSTANT: {
+      operand.is_column = false;
+      operand.constant =
+          static_cast<const expression::ConstantValueExpression *>(expression)
+              ->GetValue();
+      type_id = operand.constant.GetTypeId();
+      break;
+    }
+    case ExpressionType::VALUE_PARAMETER: {
+      if (executor_context == nullptr) {
+        return false;
+      }
+      const auto &params = executor_context->GetParamValues();
+      size_t idx =
+          static_cast<const expression::ParameterValueExpression *>(expression)
+              ->GetValueIdx();
+      if (idx >= params.size()) {
+        return false;
+      }
+      operand.is_column = false;
+      operand.constant = params[idx];
+      type_id = operand.constant.GetTypeId();
+      break;
+    }
+    default:
+      return false;
+  }
+
+  if (!operand.is_column && operand.constant.IsNull()) {
+    return false;
+  }
+  if (type_id == type::TypeId::DECIMAL) {
+    is_decimal = true;
+    return true;
+  }
+  return IsIntegerType(type_id);
+}
+
+bool VectorizedFilter::Filter(const storage::TileGroup &tile_group,
+                              std::vector<oid_t> &selection) const {
+  auto locate_column = [&tile_group](oid_t column_id,
+                                     ColumnLocation &location) {
+    oid_t tile_offset, tile_column_id;
+    tile_group.GetLayout().LocateTileAndColumn(column_id, tile_offset,
+                                               tile_column_id);
+    location.tile = tile_group.GetTile(tile_offset);
+    location.column_id = tile_column_id;
+    location.position_list = nullptr;
+  };
+  return FilterSelection(locate_column, selection);
+}
+
+bool VectorizedFilter::Filter(const LogicalTile &tile,
+                              std::vector<oid_t> &selection) const {
+  auto locate_column = [&tile](oid_t column_id, ColumnLocation &location) {
+    const auto &column_info = tile.GetColumnInfo(column_id);
+    location.tile = column_info.base_tile.get();
+    location.column_id = column_info.origin_column_id;
+    location.position_list =
+        &tile.GetPositionLists()[column_info.position_list_idx];
+  };
+  return FilterSelection(locate_column, selection);
+}
+
+template <typename LocateColumn>
+bool VectorizedFilter::FilterSelection(const LocateColumn &locate_column,
+                                       std::vector<oid_t> &selection) const {
+  // Locate all the columns first, so that the selection vector is untouched
+  // if one of them can't be read
+  std::vector<ColumnLocation> left_locations(terms_.size());
+  std::vector<ColumnLocation> right_locations(terms_.size());
+  for (size_t i = 0; i < terms_.size(); i++) {
+    const Term &term = terms_[i];
+    locate_column(term.left.column_id, left_locations[i]);
+    if (!CanGather(left_locations[i], term.is_decimal)) {
+      return false;
+    }
+    if (term.right.is_column) {
+      locate_column(term.right.column_id, right_locations[i]);
+      if (!CanGather(right_locations[i], term.is_decimal)) {
+        return false;
+      }
+    }
+  }
+
+  std::vector<uint8_t> mask;
+  std::vector<int64_t> left_integers, right_integers;
+  std::vector<double> left_decimals, right_decimals;
+  for (size_t i = 0; i < terms_.size() && !selection.empty(); i++) {
+    const Term &term = terms_[i];
+    size_t count = selection.size();
+    mask.assign(count, 1);
+
+    if (term.is_decimal) {
+      Gather(left_locations[i], selection, left_decimals, mask);
+      if (term.right.is_column) {
+        Gather(right_locations[i], selection, right_decimals, mask);
+      } else {
+        right_decimals.assign(
+            1, term.right.constant.CastAs(type::TypeId::DECIMAL)
+                   .GetAs<double>());
+      }
+      Compare(term.comparison, left_decimals.data(), right_decimals.data(),
+              term.right.is_column ? 1 : 0, count, mask);
+    } else {
+      Gather(left_locations[i], selection, left_integers, mask);
+      if (term.right.is_column) {
+        Gather(right_locations[i], selection, right_integers, mask);
+      } else {
+        right_integers.assign(
+            1, term.right.constant.CastAs(type::TypeId::BIGINT)
+                   .GetAs<int64_t>());
+      }
+      Compare(term.comparison, left_integers.data(), right_integers.data(),
+              term.right.is_column ? 1 : 0, count, mask);
+    }
+
+    // Compact the selection vector without branching on the mask
+    size_t selected = 0;
+    for (size_t j = 0; j < count; j++) {
+      selection[selected] = selection[j];
+      selected += mask[j];
+    }
+    selection.resize(selected);
+  }
+  return true;
+}
+
+bool VectorizedFilter::CanGather(const ColumnLocation &location,
+                                 bool is_decimal) {
+  type::TypeId type_id =
+      location.tile->GetSchema()->GetType(location.column_id);
+  return IsIntegerType(type_id) ||
+         (is_decimal && type_id == type::TypeId::DECIMAL);
+}
+
+template <typename T>
+void VectorizedFilter::Gather(const ColumnLocation &location,
+                              const std::vector<oid_t> &selection,
+                              std::vector<T> &values,
+                              std::vector<uint8_t> &mask) {
+  const catalog::Schema *schema = location.tile->GetSchema();
+  const char *base = location.tile->GetTupleLocation(0) +
+                     schema->GetOffset(location.column_id);
+  size_t stride = schema->GetLength();
+  values.resize(selection.size());
+  switch (schema->GetType(location.column_id)) {
+    case type::TypeId::TINYINT:
+      GatherColumn<int8_t>(base, stride, selection, location.position_list,
+                           type::PELOTON_INT8_NULL, values.data(), mask.data());
+      break;
+    case type::TypeId::SMALLINT:
+      GatherColumn<int16_t>(base, stride, selection, location.position_list,
+                            type::PELOTON_INT16_NULL, values.data(),
+                            mask.data());
+      break;
+    case type::TypeId::INTEGER:
+      GatherColumn<int32_t>(base, stride, selection, location.position_list,
+                            type::PELOTON_INT32_NULL, values.data(),
+                            mask.data());
+      break;
+    case type::TypeId::BIGINT:
+      GatherColumn<int64_t>(base, stride, selection, location.position_list,
+                            type::PELOTON_INT64_NULL, values.data(),
+                            mask.data());
+      break;
+    case type::TypeId::DECIMAL:
+      GatherColumn<double>(base, stride, selection, location.position_list,
+                           type::PELOTON_DECIMAL_NULL, values.data(),
+                           mask.data());
+      break;
+    default:
+      PELOTON_ASSERT(false);
+  }
+}
+
+template <typename T>
+void VectorizedFilter::Compare(ExpressionType comparison, const T *left,
+                               const T *right, size_t right_stride,
+                               size_t count, std::vector<uint8_t> &mask) {
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      CompareColumn(left, right, right_stride, count, mask.data(),
+                    std::equal_to<T>());
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      CompareColumn(left, right, right_stride, count, mask.data(),
+                    std::not_equal_to<T>());
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      CompareColumn(left, right, right_stride, count, mask.data(),
+                    std::less<T>());
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      CompareColumn(left, right, right_stride, count, mask.data(),
+                    std::greater<T>());
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      CompareColumn(left, right, right_stride, count, mask.data(),
+                    std::less_equal<T>());
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      CompareColumn(left, right, right_stride, count, mask.data(),
+                    std::greater_equal<T>());
+      break;
+    default:
+      PELOTON_ASSERT(false);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.cpp
+//
+// Identification: src/gc/tile_group_compactor.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "gc/tile_group_compactor.h"
+
+#include "common/container_tuple.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "gc/transaction_level_gc_manager.h"
+#include "planner/project_info.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace gc {
+
+void TileGroupCompactor::CompactTileGroup(const oid_t &tile_group_id,
+                                          const size_t &attempt) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto tile_group = storage_manager->GetTileGroup(tile_group_id);
+  // the table has been dropped in the meantime
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  storage::DataTable *table =
+      dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+  PELOTON_ASSERT(table != nullptr);
+
+  if (MoveTuplesOutOfTileGroup(table, tile_group) == true) {
+    LOG_DEBUG("Compacted tile group %u of table %u", tile_group_id,
+              table->GetOid());
+    return;
+  }
+
+  // the conflicting transactions are likely still running. rather than
+  // blocking a worker until they finish, the gc submits the tile group again
+  // once they have.
+  auto &gc_manager = TransactionLevelGCManager::GetInstance();
+  if (attempt + 1 < MAX_COMPACTION_ATTEMPTS) {
+    gc_manager.RetryCompaction(tile_group_id, attempt + 1);
+    return;
+  }
+
+  // give up for now. the free slots of the tile group can be reused again,
+  // and the GC hands it over once more when it reclaims another slot.
+  LOG_DEBUG("Failed to compact tile group %u", tile_group_id);
+  gc_manager.CancelCompaction(tile_group_id);
+}
+
+bool TileGroupCompactor::MoveTuplesOutOfTileGroup(
+    storage::DataTable *table, std::shared_ptr<storage::TileGroup> tile_group) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> executor_context(
+      new executor::ExecutorContext(txn));
+
+  // copy all the columns of the old version into the new version
+  TargetList target_list;
+  DirectMapList direct_map_list;
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; ++column_id) {
+    direct_map_list.emplace_back(column_id, std::make_pair(0, column_id));
+  }
+  planner::ProjectInfo project_info(std::move(target_list),
+                                    std::move(direct_map_list));
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto tile_group_header = tile_group->GetHeader();
+
+  oid_t tuple_count = tile_group->GetAllocatedTupleCount();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; ++tuple_id) {
+    // garbage versions are reclaimed by the GC, they don't need to move.
+    if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+        VisibilityType::OK) {
+      continue;
+    }
+
+    // the tuple is being updated or deleted by another transaction.
+    if (txn_manager.IsOwnable(txn, tile_group_header, tuple_id) == false ||
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+            false) {
+      txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+      txn_manager.AbortTransaction(txn);
+      return false;
+    }
+
+    // the slot comes from another tile group, as the slots of an immutable
+    // tile group are not reused.
+    ItemPointer old_location(tile_group_id, tuple_id);
+    ItemPointer new_location = table->AcquireVersion();
+    PELOTON_ASSERT(new_location.IsNull() == false);
+    PELOTON_ASSERT(new_location.block != tile_group_id);
+
+    auto new_tile_group = storage_manager->GetTileGroup(new_location.block);
+    ContainerTuple<storage::TileGroup> old_tuple(tile_group.get(), tuple_id);
+    ContainerTuple<storage::TileGroup> new_tuple(new_tile_group.get(),
+                                                 new_location.offset);
+    project_info.Evaluate(&new_tuple, &old_tuple, nullptr,
+                          executor_context.get());
+
+    // no indexed column changes, so the index entries are not touched. they
+    // reach the new version through the indirection pointer.
+    ItemPointer *indirection = tile_group_header->GetIndirection(tuple_id);
+    if (table->InstallVersion(&new_tuple, &(project_info.GetTargetList()), txn,
+                              indirection) == false) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+      txn_manager.AbortTransaction(txn);
+      return false;
+    }
+
+    txn_manager.PerformUpdate(txn, old_location, new_location);
+  }
+
+  return txn_manager.CommitTransaction(txn) == ResultType::SUCCESS;
+}
+
+}  // namespace gc
+}  // namespace peloton
@@ -17,10 +17,13 @@
 #include "common/container_tuple.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "gc/tile_group_compactor.h"
 #include "index/index.h"
 #include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
+#include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tuple.h"
 #include "threadpool/mono_queue_pool.h"
@@ -28,6 +31,10 @@
 namespace peloton {
 namespace gc {
 
+// the owner the gc sets on the newest version of a tuple while it deletes an
+// index entry of the tuple. no transaction has this id.
+static const txn_id_t GC_TXN_ID = MAX_TXN_ID;
+
 bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
   auto storage_manager = storage::StorageManager::GetInstance();
   auto tile_group = storage_manager->GetTileGroup(location.block).get();
@@ -66,6 +73,7 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
 
     int reclaimed_count = Reclaim(thread_id, expired_eid);
     int unlinked_count = Unlink(thread_id, expired_eid);
+    SubmitCompactions(expired_eid);
 
     if (is_running_ == false) {
       return;
@@ -93,6 +101,10 @@ void TransactionLevelGCManager::RecycleTransaction(
   if (!txn->IsReadOnly() && \
       txn->GetResult() != ResultType::SUCCESS && txn->IsGCSetEmpty() != true) {
     txn->SetEpochId(epoch_manager.GetNextEpochId());
+  } else if ((txn->GetCommitId() >> 32) > txn->GetEpochId()) {
+    // the transaction committed in a later epoch than it started. the
+    // versions it replaced stay visible to the transactions of that epoch.
+    txn->SetEpochId(txn->GetCommitId() >> 32);
   }
 
   // Add the transaction context to the lock-free queue
@@ -114,7 +126,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
         bool res = txn_ctx->GetEpochId() <= expired_eid;
         if (res == true) {
           // unlink versions from version chain and indexes
-          UnlinkVersions(txn_ctx);
+          UnlinkVersions(txn_ctx, expired_eid);
           // Add to the garbage map
           garbages.push_back(txn_ctx);
           tuple_counter++;
@@ -158,7 +170,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
       // belongs.
 
       // unlink versions from version chain and indexes
-      UnlinkVersions(txn_ctx);
+      UnlinkVersions(txn_ctx, expired_eid);
       // Add to the garbage map
       garbages.push_back(txn_ctx);
       tuple_counter++;
@@ -196,7 +208,7 @@ int TransactionLevelGCManager::Reclaim(const int &thread_id,
     // if the global expired epoch id is no less than the garbage version's
     // epoch id, then recycle the garbage version
     if (garbage_eid <= expired_eid) {
-      AddToRecycleMap(txn_ctx);
+      AddToRecycleMap(thread_id, txn_ctx);
 
       // Remove from the original map
       garbage_ctx_entry = reclaim_maps_[thread_id].erase(garbage_ctx_entry);
@@ -207,12 +219,20 @@ int TransactionLevelGCManager::Reclaim(const int &thread_id,
     }
   }
   LOG_TRACE("Marked %d txn contexts as recycled", gc_counter);
+
+  // free the dropped tile groups that no transaction can scan anymore
+  auto dropped_entry = dropped_tile_groups_[thread_id].begin();
+  while (dropped_entry != dropped_tile_groups_[thread_id].end() &&
+         dropped_entry->first <= expired_eid) {
+    FreeTileGroup(dropped_entry->second);
+    dropped_entry = dropped_tile_groups_[thread_id].erase(dropped_entry);
+  }
   return gc_counter;
 }
 
 // Multiple GC thread share the same recycle map
 void TransactionLevelGCManager::AddToRecycleMap(
-    concurrency::TransactionContext *txn_ctx) {
+    const int &thread_id, concurrency::TransactionContext *txn_ctx) {
   for (auto &entry : *(txn_ctx->GetGCSetPtr().get())) {
     auto storage_manager = storage::StorageManager::GetInstance();
     auto tile_group = storage_manager->GetTileGroup(entry.first);
@@ -230,24 +250,33 @@ void TransactionLevelGCManager::AddToRecycleMap(
         dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
     PELOTON_ASSERT(table != nullptr);
 
-    oid_t table_id = table->GetOid();
     auto tile_group_header = tile_group->GetHeader();
     PELOTON_ASSERT(tile_group_header != nullptr);
-    bool immutable = tile_group_header->GetImmutability();
 
     for (auto &element : entry.second) {
       // as this transaction has been committed, we should reclaim older
       // versions.
       ItemPointer location(entry.first, element.first);
 
+      // a committed delete also leaves its newer empty version behind.
+      ItemPointer empty_location = INVALID_ITEMPOINTER;
+      if (element.second == GCVersionType::COMMIT_DELETE) {
+        empty_location = tile_group_header->GetPrevItemPointer(element.first);
+      }
+
       // If the tuple being reset no longer exists, just skip it
       if (ResetTuple(location) == false) {
         continue;
       }
-      // if immutable is false and the entry for table_id exists.
-      if ((!immutable) &&
-          recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
-        recycle_queue_map_[table_id]->Enqueue(location);
+      RecycleTupleSlot(thread_id, table, tile_group.get(), location);
+
+      if (empty_location.IsNull() == false) {
+        auto empty_tile_group =
+            storage_manager->GetTileGroup(empty_location.block);
+        if (empty_tile_group != nullptr && ResetTuple(empty_location)) {
+          RecycleTupleSlot(thread_id, table, empty_tile_group.get(),
+                           empty_location);
+        }
       }
     }
   }
@@ -280,6 +309,171 @@ void TransactionLevelGCManager::AddToRecycleMap(
   delete txn_ctx;
 }
 
+void TransactionLevelGCManager::RecycleTupleSlot(
+    const int &thread_id, storage::DataTable *table,
+    storage::TileGroup *tile_group, const ItemPointer &location) {
+  oid_t table_id = table->GetOid();
+  // catalog tables don't reuse their slots
+  if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
+    return;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t recycled_count = tile_group_header->IncrementRecycled();
+  oid_t slot_count = tile_group->GetAllocatedTupleCount();
+
+  // the slots of an immutable tile group are not reused.
+  if (tile_group_header->GetImmutability() == true &&
+      KeepCompactingFreeSlot(tile_group, location) == true) {
+    if (recycled_count == slot_count) {
+      DropTileGroup(thread_id, table, location.block);
+    }
+    return;
+  }
+
+  recycle_queue_map_[table_id]->Enqueue(location);
+
+  // move the live tuples out of a full tile group whose slots are mostly
+  // free, so that it can be dropped. setting the tile group immutable keeps
+  // new versions out of it.
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::tile_group_compaction) == false ||
+      tile_group_header->GetCurrentNextTupleSlot() < slot_count) {
+    return;
+  }
+  double threshold = settings::SettingsManager::GetDouble(
+      settings::SettingId::tile_group_compaction_threshold);
+  if (slot_count - recycled_count < threshold * slot_count &&
+      tile_group_header->SetImmutability() == true) {
+    oid_t tile_group_id = location.block;
+    LOG_TRACE("Compacting tile group %u of table %u", tile_group_id,
+              table_id);
+    threadpool::MonoQueuePool::GetInstance().SubmitTask([tile_group_id] {
+      TileGroupCompactor::CompactTileGroup(tile_group_id);
+    });
+  }
+}
+
+bool TransactionLevelGCManager::KeepCompactingFreeSlot(
+    storage::TileGroup *tile_group, const ItemPointer &location) {
+  std::lock_guard<std::mutex> lock(compaction_lock_);
+  if (tile_group->GetHeader()->GetImmutability() == false) {
+    return false;
+  }
+  compacting_free_slots_[location.block].push_back(location);
+  return true;
+}
+
+void TransactionLevelGCManager::RetryCompaction(const oid_t &tile_group_id,
+                                                const size_t &attempt) {
+  eid_t current_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  std::lock_guard<std::mutex> lock(compaction_lock_);
+  compaction_retries_.emplace(current_eid,
+                              std::make_pair(tile_group_id, attempt));
+}
+
+void TransactionLevelGCManager::SubmitCompactions(const eid_t &expired_eid) {
+  std::vector<std::pair<oid_t, size_t>> compactions;
+  {
+    std::lock_guard<std::mutex> lock(compaction_lock_);
+    auto itr = compaction_retries_.begin();
+    while (itr != compaction_retries_.end() && itr->first <= expired_eid) {
+      compactions.push_back(itr->second);
+      itr = compaction_retries_.erase(itr);
+    }
+  }
+
+  for (auto &compaction : compactions) {
+    oid_t tile_group_id = compaction.first;
+    size_t attempt = compaction.second;
+    threadpool::MonoQueuePool::GetInstance().SubmitTask(
+        [tile_group_id, attempt] {
+          TileGroupCompactor::CompactTileGroup(tile_group_id, attempt);
+        });
+  }
+}
+
+void TransactionLevelGCManager::CancelCompaction(const oid_t &tile_group_id) {
+  std::vector<ItemPointer> free_slots;
+  oid_t table_id;
+  {
+    std::lock_guard<std::mutex> lock(compaction_lock_);
+    auto slots_itr = compacting_free_slots_.find(tile_group_id);
+    if (slots_itr != compacting_free_slots_.end()) {
+      free_slots.swap(slots_itr->second);
+      compacting_free_slots_.erase(slots_itr);
+    }
+
+    auto tile_group =
+        storage::StorageManager::GetInstance()->GetTileGroup(tile_group_id);
+    // the table has been dropped in the meantime
+    if (tile_group == nullptr) {
+      return;
+    }
+    table_id = tile_group->GetTableId();
+    tile_group->GetHeader()->ResetImmutability();
+  }
+
+  // the slots are still counted as recycled, so they are simply queued
+  auto queue_itr = recycle_queue_map_.find(table_id);
+  if (queue_itr == recycle_queue_map_.end()) {
+    return;
+  }
+  for (auto &location : free_slots) {
+    queue_itr->second->Enqueue(location);
+  }
+  LOG_TRACE("Cancelled the compaction of tile group %u, %lu slots are free",
+            tile_group_id, free_slots.size());
+}
+
+void TransactionLevelGCManager::DropTileGroup(const int &thread_id,
+                                              storage::DataTable *table,
+                                              const oid_t &tile_group_id) {
+  if (table->DropTileGroup(tile_group_id) == false) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(compaction_lock_);
+    compacting_free_slots_.erase(tile_group_id);
+  }
+
+  // the transactions that are active now may still hold the tile group.
+  eid_t safe_expired_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  dropped_tile_groups_[thread_id].insert(
+      std::make_pair(safe_expired_eid, tile_group_id));
+  LOG_TRACE("Dropped tile group %u of table %u", tile_group_id,
+            table->GetOid());
+}
+
+void TransactionLevelGCManager::FreeTileGroup(const oid_t &tile_group_id) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto tile_group = storage_manager->GetTileGroup(tile_group_id);
+  // the table has been dropped in the meantime
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  size_t tile_group_size =
+      tile_group->GetAllocatedTupleCount() * sizeof(storage::TupleHeader);
+  for (oid_t tile_itr = 0; tile_itr < tile_group->GetTileCount(); ++tile_itr) {
+    tile_group_size += tile_group->GetTile(tile_itr)->GetSize();
+  }
+
+  // the memory is released with the last reference to the tile group
+  storage_manager->DropTileGroup(tile_group_id);
+  tile_group.reset();
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementTileGroupFreed(
+        tile_group_size);
+  }
+  LOG_TRACE("Freed tile group %u (%lu bytes)", tile_group_id,
+            tile_group_size);
+}
+
 // this function returns a free tuple slot, if one exists
 // called by data_table.
 ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
@@ -291,7 +485,19 @@ ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
   PELOTON_ASSERT(recycle_queue_map_.find(table_id) != recycle_queue_map_.end());
   auto recycle_queue = recycle_queue_map_[table_id];
 
-  if (recycle_queue->Dequeue(location) == true) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  while (recycle_queue->Dequeue(location) == true) {
+    auto tile_group = storage_manager->GetTileGroup(location.block);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    // the tile group has been set immutable after the slot was recycled, it
+    // is being compacted.
+    if (tile_group->GetHeader()->GetImmutability() == true &&
+        KeepCompactingFreeSlot(tile_group.get(), location) == true) {
+      continue;
+    }
+    tile_group->GetHeader()->DecrementRecycled();
     LOG_TRACE("Reuse tuple(%u, %u) in table %u", location.block,
               location.offset, table_id);
     return location;
@@ -305,7 +511,8 @@ void TransactionLevelGCManager::ClearGarbage(int thread_id) {
     Unlink(thread_id, MAX_CID);
   }
 
-  while (reclaim_maps_[thread_id].size() != 0) {
+  while (reclaim_maps_[thread_id].size() != 0 ||
+         dropped_tile_groups_[thread_id].size() != 0) {
     Reclaim(thread_id, MAX_CID);
   }
 
@@ -319,20 +526,108 @@ void TransactionLevelGCManager::StopGC() {
   for (int thread_id = 0; thread_id < gc_thread_count_; ++thread_id) {
     ClearGarbage(thread_id);
   }
+
+  // nobody retries the pending compactions anymore
+  std::vector<oid_t> tile_group_ids;
+  {
+    std::lock_guard<std::mutex> lock(compaction_lock_);
+    for (auto &retry : compaction_retries_) {
+      tile_group_ids.push_back(retry.second.first);
+    }
+    compaction_retries_.clear();
+  }
+  for (auto tile_group_id : tile_group_ids) {
+    CancelCompaction(tile_group_id);
+  }
 }
 
 void TransactionLevelGCManager::UnlinkVersions(
-    concurrency::TransactionContext *txn_ctx) {
+    concurrency::TransactionContext *txn_ctx, const eid_t &expired_eid) {
+  IndexGarbageMap index_garbage;
   for (auto entry : *(txn_ctx->GetGCSetPtr().get())) {
     for (auto &element : entry.second) {
-      UnlinkVersion(ItemPointer(entry.first, element.first), element.second);
+      UnlinkVersion(ItemPointer(entry.first, element.first), element.second,
+                    expired_eid, index_garbage);
+    }
+  }
+  DeleteIndexEntries(index_garbage, expired_eid);
+}
+
+// whether the version has the key of the index.
+static bool HasKey(const AbstractTuple &version, const storage::Tuple *key,
+                   const std::vector<oid_t> &indexed_columns) {
+  for (size_t i = 0; i < indexed_columns.size(); ++i) {
+    if (version.GetValue(indexed_columns[i])
+            .CompareNotEquals(key->GetValue(i)) == CmpBool::CmpTrue) {
+      return false;
     }
   }
+  return true;
 }
 
-// delete a tuple from all its indexes it belongs to.
+bool TransactionLevelGCManager::IsKeyInUse(
+    const ItemPointer &location, ItemPointer *indirection,
+    const storage::Tuple *key, const std::vector<oid_t> &indexed_columns,
+    const eid_t &expired_eid) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+
+  // walk the version chain from the newest version.
+  ItemPointer version = *indirection;
+  ItemPointer newer_version = INVALID_ITEMPOINTER;
+  while (version.IsNull() == false) {
+    auto tile_group = storage_manager->GetTileGroup(version.block);
+    if (tile_group == nullptr) {
+      break;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+
+    if (newer_version.IsNull() == true) {
+      // the slot of the deleted tuple has been reused by another tuple.
+      if (tile_group_header->GetIndirection(version.offset) != indirection) {
+        break;
+      }
+      // the owner of the newest version may be inserting the keys of the
+      // version it creates. keep the entry to be safe.
+      txn_id_t txn_id = tile_group_header->GetTransactionId(version.offset);
+      if (txn_id != INITIAL_TXN_ID && txn_id != INVALID_TXN_ID &&
+          txn_id != GC_TXN_ID) {
+        return true;
+      }
+    } else if (!(tile_group_header->GetPrevItemPointer(version.offset) ==
+                 newer_version)) {
+      // the version has been unlinked from the chain in the meantime.
+      break;
+    }
+
+    // the version and all the older ones are invisible to every transaction.
+    cid_t end_cid = tile_group_header->GetEndCommitId(version.offset);
+    if (end_cid != MAX_CID && (end_cid >> 32) <= expired_eid) {
+      break;
+    }
+
+    // empty versions of deleted tuples and aborted versions have no keys.
+    if (!(version == location) &&
+        tile_group_header->GetTransactionId(version.offset) !=
+            INVALID_TXN_ID) {
+      ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                               version.offset);
+      if (HasKey(tuple, key, indexed_columns) == true) {
+        return true;
+      }
+    }
+
+    newer_version = version;
+    version = tile_group_header->GetNextItemPointer(version.offset);
+  }
+  return false;
+}
+
+// collect the entries of a tuple version that can be deleted from the
+// indexes it belongs to.
 void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
-                                              GCVersionType type) {
+                                              GCVersionType type,
+                                              const eid_t &expired_eid,
+                                              IndexGarbageMap &index_garbage) {
   // get indirection from the indirection array.
   auto tile_group =
       storage::StorageManager::GetInstance()->GetTileGroup(location.block);
@@ -343,8 +638,7 @@ void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
     return;
   }
 
-  auto tile_group_header =
-      storage::StorageManager::GetInstance()->GetTileGroup(location.block)->GetHeader();
+  auto tile_group_header = tile_group->GetHeader();
 
   ItemPointer *indirection = tile_group_header->GetIndirection(location.offset);
 
@@ -360,14 +654,17 @@ void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
       dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
   PELOTON_ASSERT(table != nullptr);
 
-  // NOTE: for now, we only consider unlinking tuple versions from primary
-  // indexes.
+  // the version whose entries are shared with the gc'd version, if the keys
+  // did not change.
+  ItemPointer other_location = INVALID_ITEMPOINTER;
+
   if (type == GCVersionType::COMMIT_UPDATE) {
     // the gc'd version is an old version.
     // this version needs to be reclaimed by the GC.
-    // if the version differs from the previous one in some columns where
-    // secondary indexes are built on, then we need to unlink the previous
-    // version from the secondary index.
+    // if the version differs from the next newer one in some columns where
+    // indexes are built on, then we need to unlink the old key from these
+    // indexes.
+    other_location = tile_group_header->GetPrevItemPointer(location.offset);
   } else if (type == GCVersionType::COMMIT_DELETE) {
     // the gc'd version is an old version.
     // need to recycle this version as well as its newer (empty) version.
@@ -375,35 +672,171 @@ void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
     // indexes.
   } else if (type == GCVersionType::ABORT_UPDATE) {
     // the gc'd version is a newly created version.
-    // if the version differs from the previous one in some columns where
-    // secondary indexes are built on, then we need to unlink this version
-    // from the secondary index.
-
+    // if the version differs from the restored old one in some columns where
+    // indexes are built on, then we need to unlink this version from these
+    // indexes.
+    other_location = tile_group_header->GetNextItemPointer(location.offset);
   } else if (type == GCVersionType::ABORT_DELETE) {
     // the gc'd version is a newly created empty version.
     // need to recycle this version.
     // no index manipulation needs to be made.
+    return;
   } else {
     PELOTON_ASSERT(type == GCVersionType::ABORT_INSERT ||
                    type == GCVersionType::COMMIT_INS_DEL ||
                    type == GCVersionType::ABORT_INS_DEL);
+  }
+
+  // find out the indexed columns that changed between the two versions.
+  std::vector<bool> changed_columns;
+  if (other_location.IsNull() == false) {
+    auto other_tile_group =
+        storage::StorageManager::GetInstance()->GetTileGroup(
+            other_location.block);
+    if (other_tile_group != nullptr) {
+      ContainerTuple<storage::TileGroup> other_tuple(other_tile_group.get(),
+                                                     other_location.offset);
+      changed_columns.resize(table->GetSchema()->GetColumnCount(), false);
+      for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
+        auto index = table->GetIndex(idx);
+        if (index == nullptr) continue;
+        for (auto column : index->GetKeySchema()->GetIndexedColumns()) {
+          if (changed_columns[column] == false &&
+              current_tuple.GetValue(column)
+                      .CompareNotEquals(other_tuple.GetValue(column)) ==
+                  CmpBool::CmpTrue) {
+            changed_columns[column] = true;
+          }
+        }
+      }
+    }
+  }
 
-    // attempt to unlink the version from all the indexes.
-    for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
-      auto index = table->GetIndex(idx);
-      if (index == nullptr) continue;
-      auto index_schema = index->GetKeySchema();
-      auto indexed_columns = index_schema->GetIndexedColumns();
+  for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
+    auto index = table->GetIndex(idx);
+    if (index == nullptr) continue;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    // the entry is shared with the other version if its key did not change.
+    if (changed_columns.empty() == false) {
+      bool key_changed = false;
+      for (auto column : indexed_columns) {
+        key_changed = key_changed || changed_columns[column];
+      }
+      if (key_changed == false) continue;
+    }
 
-      // build key.
-      std::unique_ptr<storage::Tuple> current_key(
-          new storage::Tuple(index_schema, true));
-      current_key->SetFromTuple(&current_tuple, indexed_columns,
-                                index->GetPool());
+    // build key.
+    std::unique_ptr<storage::Tuple> current_key(
+        new storage::Tuple(index_schema, true));
+    current_key->SetFromTuple(&current_tuple, indexed_columns,
+                              index->GetPool());
 
-      index->DeleteEntry(current_key.get(), indirection);
+    // an older or newer version may still need the entry.
+    if (IsKeyInUse(location, indirection, current_key.get(), indexed_columns,
+                   expired_eid) == true) {
+      continue;
     }
+
+    auto &garbage = index_garbage[index.get()];
+    garbage.index = index;
+    garbage.entries.push_back(
+        {std::move(current_key), indirection, location});
+  }
+}
+
+bool TransactionLevelGCManager::LockNewestVersion(ItemPointer *indirection,
+                                                  ItemPointer &newest_version) {
+  newest_version = INVALID_ITEMPOINTER;
+
+  ItemPointer version = *indirection;
+  if (version.IsNull() == true) {
+    return true;
+  }
+  auto tile_group =
+      storage::StorageManager::GetInstance()->GetTileGroup(version.block);
+  if (tile_group == nullptr) {
+    return true;
+  }
+  auto tile_group_header = tile_group->GetHeader();
+
+  // no writer can own a tuple whose slot has been reused by another tuple,
+  // or whose newest version is deleted or aborted.
+  if (tile_group_header->GetIndirection(version.offset) != indirection ||
+      tile_group_header->GetTransactionId(version.offset) == INVALID_TXN_ID) {
+    return true;
+  }
+
+  // fails if a writer owns the tuple.
+  if (tile_group_header->SetAtomicTransactionId(version.offset, GC_TXN_ID) ==
+      false) {
+    return false;
+  }
+
+  // a writer may have committed a newer version before the ownership was
+  // taken.
+  if (!(*indirection == version)) {
+    tile_group_header->SetTransactionId(version.offset, INITIAL_TXN_ID);
+    return false;
+  }
+
+  newest_version = version;
+  return true;
+}
+
+void TransactionLevelGCManager::UnlockNewestVersion(
+    const ItemPointer &newest_version) {
+  if (newest_version.IsNull() == true) {
+    return;
+  }
+  auto tile_group = storage::StorageManager::GetInstance()->GetTileGroup(
+      newest_version.block);
+  PELOTON_ASSERT(tile_group != nullptr);
+  tile_group->GetHeader()->SetTransactionId(newest_version.offset,
+                                            INITIAL_TXN_ID);
+}
+
+void TransactionLevelGCManager::DeleteIndexEntries(
+    IndexGarbageMap &index_garbage, const eid_t &expired_eid) {
+  size_t reclaimed_count = 0;
+  size_t reclaimed_bytes = 0;
+
+  for (auto &item : index_garbage) {
+    auto index = item.second.index.get();
+    auto indexed_columns = index->GetKeySchema()->GetIndexedColumns();
+    size_t footprint = index->GetMemoryFootprint();
+
+    for (auto &entry : item.second.entries) {
+      // a writer may have created a version with the same key after the
+      // entry was collected. keep writers away while the key is checked
+      // again and the entry is deleted.
+      ItemPointer newest_version;
+      if (LockNewestVersion(entry.indirection, newest_version) == false) {
+        continue;
+      }
+      if (IsKeyInUse(entry.location, entry.indirection, entry.key.get(),
+                     indexed_columns, expired_eid) == false &&
+          index->DeleteEntry(entry.key.get(), entry.indirection) == true) {
+        reclaimed_count++;
+      }
+      UnlockNewestVersion(newest_version);
+    }
+
+    size_t new_footprint = index->GetMemoryFootprint();
+    if (new_footprint < footprint) {
+      reclaimed_bytes += footprint - new_footprint;
+    }
+  }
+
+  if (reclaimed_count != 0 &&
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReclaimed(
+        reclaimed_count, reclaimed_bytes);
   }
+  LOG_TRACE("Deleted %lu index entries (%lu bytes)", reclaimed_count,
+            reclaimed_bytes);
 }
 
 }  // namespace gc
@@ -27,6 +27,10 @@
 // 10: latency
 // 11: cpu_time
 // 12: time_stamp
+// 13: spilled_bytes
+// 14: spill_passes
+// 15: interpreted_us
+// 16: native_us
 //
 //
 //===----------------------------------------------------------------------===//
@@ -64,6 +68,10 @@ class QueryMetricsCatalog : public AbstractCatalog {
                           int64_t latency,
                           int64_t cpu_time,
                           int64_t time_stamp,
+                          int64_t spilled_bytes,
+                          int64_t spill_passes,
+                          int64_t interpreted_us,
+                          int64_t native_us,
                           type::AbstractPool *pool);
 
   bool DeleteQueryMetrics(concurrency::TransactionContext *txn,
@@ -93,6 +101,10 @@ class QueryMetricsCatalog : public AbstractCatalog {
     LATENCY = 10,
     CPU_TIME = 11,
     TIME_STAMP = 12,
+    SPILLED_BYTES = 13,
+    SPILL_PASSES = 14,
+    INTERPRETED_US = 15,
+    NATIVE_US = 16,
     // Add new columns here in creation order
   };
 
@@ -170,7 +170,7 @@ class Schema : public Printable {
     indexed_columns_ = indexed_columns;
   }
 
-  inline const std::vector<oid_t> GetIndexedColumns() const {
+  inline const std::vector<oid_t> &GetIndexedColumns() const {
     return indexed_columns_;
   }
 
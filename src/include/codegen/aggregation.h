@@ -78,6 +78,18 @@ class Aggregation {
   void AdvanceValues(CodeGen &codegen, llvm::Value *space,
                      const std::vector<codegen::Value> &next) const;
 
+  // Merge the (partial) aggregates stored in the other storage space into the
+  // aggregates stored in the provided storage space. Used to combine the
+  // thread-local aggregates of parallel aggregations. Distinct aggregates
+  // cannot be merged.
+  void MergeValues(CodeGen &codegen, llvm::Value *space,
+                   llvm::Value *other_space) const;
+
+  // Can partial aggregates of the provided aggregates be merged? They can't if
+  // any aggregate needs a (global) hash table to track distinct values.
+  static bool CanMergeValues(
+      const std::vector<planner::AggregatePlan::AggTerm> &agg_terms);
+
   // Compute the final values of all the aggregates stored in the provided
   // storage space, inserting them into the provided output vector.
   void FinalizeValues(CodeGen &codegen, llvm::Value *space,
@@ -150,6 +162,12 @@ class Aggregation {
   void DoAdvanceValue(CodeGen &codegen, llvm::Value *space, ExpressionType type,
                       uint32_t storage_index, const codegen::Value &next) const;
 
+  // Merge a single component of an aggregate from the other storage space
+  void MergeValue(CodeGen &codegen, llvm::Value *space, ExpressionType type,
+                  uint32_t storage_index, llvm::Value *other_space,
+                  UpdateableStorage::NullBitmap &null_bitmap,
+                  UpdateableStorage::NullBitmap &other_null_bitmap) const;
+
   // Advancethe value of a specifig aggregate. Performs NULL check if necessary
   // and finally calls DoAdvanceValue()
   void AdvanceValue(CodeGen &codegen, llvm::Value *space,
@@ -30,6 +30,10 @@ class BufferAccessor {
   void Append(CodeGen &codegen, llvm::Value *buffer_ptr,
               const std::vector<codegen::Value> &tuple) const;
 
+  // Overwrite a non-NULL column of the buffered tuple at the given position
+  void SetValue(CodeGen &codegen, llvm::Value *tuple_ptr, uint32_t col_id,
+                const codegen::Value &value) const;
+
   struct IterateCallback;
   void Iterate(CodeGen &codegen, llvm::Value *buffer_ptr,
                IterateCallback &callback) const;
@@ -43,8 +47,11 @@ class BufferAccessor {
   uint32_t GetTupleSize() const { return storage_format_.GetStorageSize(); }
 
   struct IterateCallback {
-    virtual void ProcessEntry(
-        CodeGen &codegen, const std::vector<codegen::Value> &vals) const = 0;
+    // Invoked with the values of every buffered tuple, and the position of
+    // the tuple in the buffer
+    virtual void ProcessEntry(CodeGen &codegen,
+                              const std::vector<codegen::Value> &vals,
+                              llvm::Value *tuple_ptr) const = 0;
   };
 
  private:
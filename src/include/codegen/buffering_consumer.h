@@ -15,6 +15,8 @@
 #include <vector>
 #include <mutex>
 
+#include "tbb/enumerable_thread_specific.h"
+
 #include "codegen/compilation_context.h"
 #include "codegen/execution_consumer.h"
 #include "codegen/value.h"
@@ -82,12 +84,15 @@ class BufferingConsumer : public ExecutionConsumer {
   // The attributes we want to output
   std::vector<const planner::AttributeInfo *> output_ais_;
 
-  // The thread-safe buffer of output tuples
+  // The thread-safe buffer of output tuples. Every thread appends to its own
+  // local buffer without synchronization; the local buffers are merged into
+  // the output on first access after execution.
   struct Buffer {
     std::mutex mutex;
     std::vector<WrappedTuple> output;
+    tbb::enumerable_thread_specific<std::vector<WrappedTuple>> local_output;
   };
-  Buffer buffer_;
+  mutable Buffer buffer_;
 
   // The slot in the runtime state to find our state context
   QueryState::Id consumer_state_id_;
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -52,6 +54,9 @@ class CodeContext {
  public:
   using FuncPtr = void *;
 
+  /// Receives the object code generated by Compile()
+  using ObjectCallback = std::function<void(const char *, size_t)>;
+
   CodeContext();
   ~CodeContext();
 
@@ -85,6 +90,28 @@ class CodeContext {
   /// Compile all the code contained in this context
   void Compile();
 
+  /// Compute a digest of the IR in this context and the target it is compiled
+  /// for. Unlike the ID, it is the same for the same code in every process.
+  std::string GetDigest() const;
+
+  /// Check if the code embeds addresses of objects in this process, e.g., of
+  /// plan nodes. Its object code can't be used by other processes then.
+  bool HasProcessAddresses() const;
+
+  /// Let Compile() load the given object code instead of generating it. The
+  /// code must have been generated from the same IR, see GetDigest().
+  void SetCachedObject(std::string &&object) {
+    cached_object_ = std::move(object);
+  }
+
+  /// Check whether Compile() loads object code instead of generating it
+  bool HasCachedObject() const { return !cached_object_.empty(); }
+
+  /// Set a callback that receives the object code generated by Compile()
+  void SetObjectCallback(ObjectCallback callback) {
+    object_callback_ = std::move(callback);
+  }
+
   /// Retrieve the raw function pointer to the provided compiled LLVM function
   FuncPtr GetRawFunctionPointer(llvm::Function *fn) const;
 
@@ -118,6 +145,9 @@ class CodeContext {
   /// Get the globally unique identifier for this code
   uint64_t GetID() const { return id_; }
 
+  /// Get the number of bytes of memory the compiled code occupies
+  size_t GetCodeSize() const { return code_size_.load(); }
+
   /// Get the context
   llvm::LLVMContext &GetContext() const { return *context_; }
 
@@ -166,6 +196,10 @@ class CodeContext {
   std::string err_str_;
   std::unique_ptr<llvm::ExecutionEngine> engine_;
 
+  // The number of bytes the compiled code occupies, counted by the JIT's
+  // memory manager
+  std::atomic<size_t> code_size_;
+
   // Handy types we reuse often enough to cache here
   llvm::Type *bool_type_;
   llvm::Type *int8_type_;
@@ -189,6 +223,12 @@ class CodeContext {
 
   // Shows if the Verify() has been run
   bool is_verified_;
+
+  // The object code Compile() loads instead of generating it, if any
+  std::string cached_object_;
+
+  // Receives the object code generated by Compile(), if set
+  ObjectCallback object_callback_;
 };
 
 }  // namespace codegen
@@ -137,6 +137,7 @@ class CodeGen {
   llvm::Value *Memcmp(llvm::Value *ptr1, llvm::Value *ptr2,
                       llvm::Value *len);
   llvm::Value *Sqrt(llvm::Value *val);
+  llvm::Value *ByteSwap(llvm::Value *val);
 
   //===--------------------------------------------------------------------===//
   // Arithmetic with overflow logic - These methods perform the desired math op,
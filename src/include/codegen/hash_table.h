@@ -181,7 +181,7 @@ class HashTable {
   // Constructor
   HashTable();
   HashTable(CodeGen &codegen, const std::vector<type::Type> &key_type,
-            uint32_t value_size);
+            uint32_t value_size, bool track_matches = false);
 
   // Destructor
   virtual ~HashTable() = default;
@@ -216,6 +216,15 @@ class HashTable {
   void MergeLazyUnfinished(CodeGen &codegen, llvm::Value *global_ht,
                            llvm::Value *local_ht) const;
 
+  void BuildLazyPartitioned(CodeGen &codegen, llvm::Value *ht_ptr,
+                            llvm::Value *thread_states,
+                            uint32_t ht_state_offset) const;
+
+  void EnableSpilling(CodeGen &codegen, llvm::Value *ht_ptr,
+                      llvm::Value *exec_ctx_ptr, llvm::Value *owner_ptr) const;
+
+  llvm::Value *NextPass(CodeGen &codegen, llvm::Value *ht_ptr) const;
+
   virtual void Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                        IterateCallback &callback) const;
 
@@ -229,9 +238,25 @@ class HashTable {
 
   virtual void Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const;
 
+  /**
+   * When constructed to track matches, every entry carries a flag after its
+   * value that is cleared on insertion. These set and read the flag of the
+   * entry whose value is at the given pointer (i.e., the pointer provided to
+   * an iteration callback).
+   */
+  void MarkMatched(CodeGen &codegen, llvm::Value *value_ptr) const;
+  llvm::Value *IsMatched(CodeGen &codegen, llvm::Value *value_ptr) const;
+
+ private:
+  // Return a pointer to the match flag of the entry with the given value
+  llvm::Value *MatchFlagPtr(CodeGen &codegen, llvm::Value *value_ptr) const;
+
  private:
   uint32_t value_size_;
 
+  // Does every entry carry a match flag after its value?
+  bool track_matches_;
+
   // The storage strategy we use to store the lookup keys inside every HashEntry
   CompactStorage key_storage_;
 };
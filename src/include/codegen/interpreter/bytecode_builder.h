@@ -17,6 +17,7 @@
 #include <llvm/IR/CFG.h>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -44,16 +45,27 @@ namespace interpreter {
 
 class BytecodeBuilder {
  public:
+  /**
+   * Callback that provides a native function pointer for a LLVM function whose
+   * address is used as a value, e.g. a pipeline function that is passed to a
+   * runtime dispatcher.
+   */
+  using FunctionResolver = std::function<void *(const llvm::Function *)>;
+
   /**
    * Static method to create a bytecode function from a code context.
    * @param code_context CodeContext containing the LLVM function
    * @param function LLVM function that shall be interpreted later
+   * @param use_naive_register_allocator use the naive register allocation
+   * @param function_resolver resolves the addresses of LLVM functions used as
+   * values. Without it, such functions are not supported.
    * @return A BytecodeFunction object that can be passed to the
    * BytecodeInterpreter (several times).
    */
   static BytecodeFunction CreateBytecodeFunction(
       const CodeContext &code_context, const llvm::Function *function,
-      bool use_naive_register_allocator = false);
+      bool use_naive_register_allocator = false,
+      const FunctionResolver *function_resolver = nullptr);
 
  private:
   // These types definitions have the purpose to make the code better
@@ -83,7 +95,8 @@ class BytecodeBuilder {
 
  private:
   BytecodeBuilder(const CodeContext &code_context,
-                  const llvm::Function *function);
+                  const llvm::Function *function,
+                  const FunctionResolver *function_resolver);
 
   /**
    * Analyses the function to collect values and constants and gets
@@ -458,6 +471,12 @@ class BytecodeBuilder {
    * LLVM function that shall be translated
    */
   const llvm::Function *llvm_function_;
+
+  /**
+   * Resolves LLVM functions used as values to native function pointers
+   * (may be nullptr)
+   */
+  const FunctionResolver *function_resolver_;
 };
 
 class NotSupportedException : public std::runtime_error {
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// function_trampoline.h
+//
+// Identification: src/include/codegen/interpreter/function_trampoline.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <ffi.h>
+#include <atomic>
+#include <vector>
+
+#include "codegen/interpreter/bytecode_builder.h"
+#include "codegen/interpreter/bytecode_function.h"
+
+namespace peloton {
+namespace codegen {
+
+class CodeContext;
+
+namespace interpreter {
+
+/**
+ * A native entry point for a LLVM function whose address is used by the
+ * generated code, e.g. a pipeline function that the runtime dispatcher calls
+ * once per morsel, or a comparison function of a sorter.
+ *
+ * Calls through the entry point interpret the bytecode of the function until a
+ * native implementation is set. From then on, they call the native function.
+ * Callers that invoke the function repeatedly therefore switch from the
+ * interpreter to native code between two calls.
+ */
+class FunctionTrampoline {
+ public:
+  /**
+   * Creates the bytecode of the function and the entry point
+   * @param code_context CodeContext containing the LLVM function
+   * @param function LLVM function the trampoline calls
+   * @param function_resolver resolver for the functions used as values by
+   * this function
+   */
+  FunctionTrampoline(
+      const CodeContext &code_context, const llvm::Function *function,
+      const BytecodeBuilder::FunctionResolver *function_resolver);
+
+  ~FunctionTrampoline();
+
+  /// This class cannot be copy or move-constructed
+  DISALLOW_COPY_AND_MOVE(FunctionTrampoline);
+
+  /// Get the native entry point of this trampoline
+  void *GetEntryPoint() const { return entry_point_; }
+
+  /// Get the LLVM function the trampoline calls
+  const llvm::Function *GetFunction() const { return llvm_function_; }
+
+  /// Calls after this use the given native implementation of the function
+  void SetNativeFunction(void *native_function) {
+    native_function_.store(native_function, std::memory_order_release);
+  }
+
+ private:
+  // The libffi closure handler for calls through the entry point
+  static void Call(ffi_cif *call_interface, void *return_value,
+                   void **arguments, void *trampoline);
+
+  // Get the libffi type of a argument or return value
+  ffi_type *GetFFIType(const CodeContext &code_context, llvm::Type *type) const;
+
+ private:
+  // The LLVM function
+  const llvm::Function *llvm_function_;
+
+  // The bytecode of the function
+  BytecodeFunction bytecode_function_;
+
+  // The size of each argument in bytes
+  std::vector<size_t> argument_sizes_;
+
+  // The size of the return value in bytes (0 if the function returns void)
+  size_t return_size_;
+
+  // Whether the function returns a floating point value
+  bool returns_floating_point_;
+
+  // The libffi call interface of the function
+  std::vector<ffi_type *> argument_types_;
+  ffi_cif call_interface_;
+
+  // The libffi closure and its executable address
+  ffi_closure *closure_;
+  void *entry_point_;
+
+  // The native implementation, nullptr until it is available
+  std::atomic<void *> native_function_;
+};
+
+}  // namespace interpreter
+}  // namespace codegen
+}  // namespace peloton
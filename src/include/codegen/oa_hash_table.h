@@ -113,6 +113,39 @@ class OAHashTable : public HashTable {
   // register/value
   void Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const override;
 
+  // Generate code to read the hash value and the key stored in the given hash
+  // entry, returning a pointer to its value
+  llvm::Value *LoadEntry(CodeGen &codegen, llvm::Value *entry_ptr,
+                         llvm::Value *&hash,
+                         std::vector<codegen::Value> &key) const;
+
+  // Prepare the array of partition tables at the given address to be merged
+  // into (see util::OAHashTable::MergePartitioned())
+  void InitPartitions(CodeGen &codegen, llvm::Value *partitions_ptr) const;
+
+  // Merge the thread-local tables at the given offset into each thread state
+  // into the partition tables, in parallel, using the given merge function
+  void MergePartitioned(CodeGen &codegen, llvm::Value *partitions_ptr,
+                        llvm::Value *thread_states, uint32_t ht_state_offset,
+                        llvm::Function *merge_func) const;
+
+  // Destroy/cleanup the array of partition tables at the given address
+  void DestroyPartitions(CodeGen &codegen, llvm::Value *partitions_ptr) const;
+
+  // Bind the table at the given address to the memory limit of the query,
+  // spilling into the partitions of the given owner table
+  // (see util::OAHashTable::EnableSpilling())
+  void EnableSpilling(CodeGen &codegen, llvm::Value *ht_ptr,
+                      llvm::Value *exec_ctx_ptr, llvm::Value *owner_ptr) const;
+
+  // Spill the entries of the table, if it spilled before
+  void FlushSpilled(CodeGen &codegen, llvm::Value *ht_ptr) const;
+
+  // Load the next spilled partition into the table using the given merge
+  // function, returning whether there was one
+  llvm::Value *NextSpilledPartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                                    llvm::Function *merge_func) const;
+
   // Return the size of the hash entry
   // If the hash entry is initialized properly then this is the actual
   // size of the hash entry which should consist of three parts:
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache.h
+//
+// Identification: src/include/codegen/object_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "common/singleton.h"
+#include "util/hash_util.h"
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
+namespace codegen {
+
+class CodeContext;
+
+// Persistent cache of the object code of compiled queries, which spares the
+// queries the optimization and code generation after a restart. The cache is
+// implemented as a singleton.
+//
+// The object code of a query is kept in a file named after a fingerprint of
+// the plan and of the schemas of the tables the plan accesses. The file also
+// holds the digest of the unoptimized IR and the target of the code, and is
+// only used if both are the same. A file that doesn't match, e.g., because a
+// schema changed in a way the fingerprint misses, is replaced by the newly
+// compiled code.
+//
+// Code that embeds addresses of this process, e.g., of plan nodes, is valid in
+// this process only, and is never cached.
+class ObjectCache : public Singleton<ObjectCache> {
+ public:
+  // Set the directory the object code is kept in. Caching is disabled if the
+  // directory is empty.
+  void SetDirectory(const std::string &directory);
+
+  // Check whether the object code of queries is cached
+  bool IsEnabled() const;
+
+  // Attach the cache to the code of the given plan. If the cache has object
+  // code for it, returns true, and Compile() on the code context loads that
+  // code, so the IR doesn't need to be optimized. Otherwise, the code
+  // generated by Compile() is added to the cache.
+  bool Attach(const planner::AbstractPlan &plan, CodeContext &code_context);
+
+  // Remove all the object code in the cache directory
+  void Clear();
+
+  // Get the number of queries whose object code was found
+  uint64_t GetHitCount() const { return hit_count_; }
+
+  // Get the number of queries whose object code was not found
+  uint64_t GetMissCount() const { return miss_count_; }
+
+ private:
+  friend class Singleton<ObjectCache>;
+
+  ObjectCache();
+
+  // Get the directory, empty if caching is disabled
+  std::string GetDirectory() const;
+
+  // Fingerprint of the plan and of the schemas of the tables it accesses
+  static hash_t GetKey(const planner::AbstractPlan &plan);
+
+  // Read the object code of the file if its digest matches
+  static bool Load(const std::string &path, const std::string &digest,
+                   std::string &object);
+
+  // Write the object code and its digest to the file
+  static void Store(const std::string &path, const std::string &digest,
+                    const char *object, size_t size);
+
+ private:
+  mutable std::mutex directory_lock_;
+  std::string directory_;
+
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -26,8 +26,12 @@ class NestedLoopJoinPlan;
 
 namespace codegen {
 
+class IndexScanTranslator;
+
 //===----------------------------------------------------------------------===//
-// The translator for a block-wise nested loop join
+// The translator for a block-wise nested loop join. If the right child is an
+// index scan and the plan names the join columns, the join is instead executed
+// as an index nested-loop join: every left tuple probes the index on its own.
 //===----------------------------------------------------------------------===//
 class BlockNestedLoopJoinTranslator : public OperatorTranslator {
  public:
@@ -45,6 +49,8 @@ class BlockNestedLoopJoinTranslator : public OperatorTranslator {
 
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
 
+  void ProduceRemaining(ConsumerContext &context) const override;
+
  private:
   bool IsFromLeftChild(const Pipeline &pipeline) const;
 
@@ -53,6 +59,9 @@ class BlockNestedLoopJoinTranslator : public OperatorTranslator {
 
   void FindMatchesForRow(ConsumerContext &ctx, RowBatch::Row &row) const;
 
+  // Produce the buffered tuples of a semi or anti join that qualify
+  void ProduceLeftTuples(ConsumerContext &ctx) const;
+
  private:
   // The pipeline for the left subtree of the plan
   Pipeline left_pipeline_;
@@ -73,6 +82,14 @@ class BlockNestedLoopJoinTranslator : public OperatorTranslator {
   // This is the function called when enough tuples from the left side have been
   // buffered and we want to perform the BNLJ against the right input.
   AuxiliaryProducerFunction join_buffer_func_;
+
+  // The index scan on the right side probed with each left tuple, if this is
+  // an index nested-loop join
+  IndexScanTranslator *index_probe_;
+
+  // Does every buffered tuple carry a flag recording whether it found a
+  // partner? This is the case for semi and anti joins.
+  bool track_left_matches_;
 };
 
 }  // namespace codegen
@@ -47,6 +47,11 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // Consume!
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
 
+  // Thread-local aggregates when the child pipeline runs in parallel
+  void RegisterPipelineState(PipelineContext &pipeline_ctx) override;
+  void InitializePipelineState(PipelineContext &pipeline_ctx) override;
+  void FinishPipeline(PipelineContext &pipeline_ctx) override;
+
   // No state to tear down
   void TearDownQueryState() override;
 
@@ -73,6 +78,10 @@ class GlobalGroupByTranslator : public OperatorTranslator {
     uint32_t agg_index_;
   };
 
+  bool IsChildPipeline(const Pipeline &pipeline) const {
+    return pipeline == child_pipeline_;
+  }
+
  private:
   // The pipeline the child operator of this aggregation belongs to
   Pipeline child_pipeline_;
@@ -80,8 +89,14 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // The class responsible for handling the aggregation for all our aggregates
   Aggregation aggregation_;
 
+  // The type of the materialization buffer
+  llvm::StructType *mat_buffer_type_;
+
   // The ID of our materialization buffer in the runtime state
   QueryState::Id mat_buffer_id_;
+
+  // The ID of the thread-local materialization buffer in the pipeline state
+  PipelineContext::Id mat_buffer_tl_id_;
 };
 
 }  // namespace codegen
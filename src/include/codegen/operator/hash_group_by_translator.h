@@ -40,8 +40,8 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Codegen any initialization work for this operator
   void InitializeQueryState() override;
 
-  // Define any helper functions this translator needs
-  void DefineAuxiliaryFunctions() override {}
+  // Define the function merging thread-local hash tables, if needed
+  void DefineAuxiliaryFunctions() override;
 
   // The method that produces new tuples
   void Produce() const override;
@@ -50,6 +50,12 @@ class HashGroupByTranslator : public OperatorTranslator {
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
   void Consume(ConsumerContext &context, RowBatch &batch) const override;
 
+  // Thread-local hash tables when the child pipeline runs in parallel
+  void RegisterPipelineState(PipelineContext &pipeline_ctx) override;
+  void InitializePipelineState(PipelineContext &pipeline_ctx) override;
+  void FinishPipeline(PipelineContext &pipeline_ctx) override;
+  void TearDownPipelineState(PipelineContext &pipeline_ctx) override;
+
   // Codegen any cleanup work for this translator
   void TearDownQueryState() override;
 
@@ -175,13 +181,32 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Should this operator employ prefetching?
   bool UsePrefetching() const;
 
+  bool IsChildPipeline(const Pipeline &pipeline) const {
+    return pipeline == child_pipeline_;
+  }
+
  private:
   // The pipeline forming all child operators of this aggregation
   Pipeline child_pipeline_;
 
+  // Whether the child pipeline may aggregate into thread-local hash tables,
+  // and the hash tables may spill to disk
+  bool mergeable_;
+
   // The ID of the hash-table in the runtime state
   QueryState::Id hash_table_id_;
 
+  // The ID of the partitioned hash-tables the thread-local hash tables are
+  // merged into in the runtime state, if the child pipeline runs in parallel
+  QueryState::Id partitions_id_;
+
+  // The ID of the thread-local hash table in the pipeline state
+  PipelineContext::Id hash_table_tl_id_;
+
+  // The function merging the entries of a thread-local hash table into one of
+  // the partitioned hash-tables, or a spilled partition into the hash table
+  llvm::Function *merge_func_;
+
   // The hash table
   OAHashTable hash_table_;
 
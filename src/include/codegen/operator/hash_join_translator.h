@@ -47,6 +47,10 @@ class HashJoinTranslator : public OperatorTranslator {
   void Consume(ConsumerContext &context, RowBatch &batch) const override;
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
 
+  // Produce the build-side rows of outer, semi and anti joins once the probe
+  // side has been consumed
+  void ProduceRemaining(ConsumerContext &context) const override;
+
   void RegisterPipelineState(PipelineContext &pipeline_ctx) override;
   void InitializePipelineState(PipelineContext &pipeline_ctx) override;
   void TearDownPipelineState(PipelineContext &pipeline_ctx) override;
@@ -78,7 +82,17 @@ class HashJoinTranslator : public OperatorTranslator {
                      std::vector<codegen::Value> &values) const;
 
   void CodegenHashProbe(ConsumerContext &context, RowBatch::Row &row,
-                        std::vector<codegen::Value> &key) const;
+                        std::vector<codegen::Value> &key,
+                        llvm::Value *probe_matched) const;
+
+  // Place the build-side values of the hash table entry with the given key
+  // and value into the row
+  void RegisterLeftValues(CodeGen &codegen, RowBatch::Row &row,
+                          const std::vector<codegen::Value> &key,
+                          llvm::Value *data_area) const;
+
+  // Place NULLs for all build-side values into the row
+  void RegisterNullLeftValues(CodeGen &codegen, RowBatch::Row &row) const;
 
   /// Estimate the size of the constructed hash table
   uint64_t EstimateHashTableSize() const;
@@ -100,6 +114,9 @@ class HashJoinTranslator : public OperatorTranslator {
   /// Callback used when inserting a tuple in the hash table during build
   class InsertLeft;
 
+  /// Callback used to produce build-side tuples after the probe
+  class ProduceLeft;
+
  private:
   // The build-side pipeline
   Pipeline left_pipeline_;
@@ -129,6 +146,22 @@ class HashJoinTranslator : public OperatorTranslator {
 
   // Does this join need an output vector
   bool needs_output_vector_;
+
+  // Do we track which build-side tuples (in the hash table) and which
+  // probe-side tuples found a join partner? The former are produced after the
+  // probe (outer, semi and anti joins), the latter right after their probe
+  // (outer joins).
+  bool track_left_matches_;
+  bool track_right_matches_;
+
+  // Flags recording whether the probe side of a NULL-aware anti join produced
+  // any tuples, and whether any of them had a NULL key
+  QueryState::Id probe_nonempty_id_;
+  QueryState::Id probe_has_null_id_;
+
+  // Can the hash table spill to disk? The probe side is then produced once per
+  // pass over the spilled hash table.
+  bool spillable_;
 };
 
 }  // namespace codegen
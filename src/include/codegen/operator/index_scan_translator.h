@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator.h
+//
+// Identification: src/include/codegen/operator/index_scan_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/query_state.h"
+#include "codegen/scan_callback.h"
+#include "codegen/tile_group.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace planner {
+class IndexScanPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// An index scan. The index lookup itself, and resolving the version of every
+// tuple found that's visible to the transaction, happens in a runtime
+// IndexScanIterator. The generated code writes the scan key into the iterator,
+// then iterates over the batches of tuples it found, evaluating the residual
+// predicate and recording reads a batch at a time, in index order.
+//
+// An index scan may also serve as the inner side of an index nested-loop join.
+// In that case, the join writes some columns of the scan key (through
+// WriteProbeKey()) before each execution of the scan.
+//===----------------------------------------------------------------------===//
+class IndexScanTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  IndexScanTranslator(const planner::IndexScanPlan &scan,
+                      CompilationContext &context, Pipeline &pipeline);
+
+  // Initialize the index scan iterator
+  void InitializeQueryState() override;
+
+  // Index scans don't rely on any auxiliary functions
+  void DefineAuxiliaryFunctions() override {}
+
+  // The method that produces new tuples
+  void Produce() const override;
+
+  // Scans are leaves in the query plan and, hence, do not consume tuples
+  void Consume(ConsumerContext &, RowBatch &) const override {}
+  void Consume(ConsumerContext &, RowBatch::Row &) const override {}
+
+  // Clean up the index scan iterator
+  void TearDownQueryState() override;
+
+  // Let the given table columns be probed with values provided by a join. The
+  // plan's values for these columns (if any) are ignored. Returns false, and
+  // changes nothing, if the index doesn't cover all of the columns.
+  bool UseAsProbe(const std::vector<oid_t> &column_ids);
+
+  // Write the value of the probe column at the given position (in the list
+  // passed to UseAsProbe()) into the scan key
+  void WriteProbeKey(CodeGen &codegen, uint32_t probe_idx,
+                     const codegen::Value &value) const;
+
+ private:
+  // Write the given value into the given slot of the scan key
+  void WriteKeyValue(CodeGen &codegen, uint32_t key_idx,
+                     const codegen::Value &value) const;
+
+  // Load the table pointer
+  llvm::Value *LoadTablePtr(CodeGen &codegen) const;
+
+  // Plan accessor
+  const planner::IndexScanPlan &GetScanPlan() const;
+
+ private:
+  // Helper class declarations (defined in implementation)
+  class AttributeAccess;
+  class ScanConsumer;
+
+ private:
+  // The ID of the index scan iterator in the runtime query state
+  QueryState::Id iterator_id_;
+
+  // The scan key. Each key column is compared against the value of an
+  // expression from the plan, or against a value written by a join (in which
+  // case the expression is null).
+  std::vector<uint32_t> key_column_ids_;
+  std::vector<int32_t> expr_types_;
+  std::vector<const expression::AbstractExpression *> key_exprs_;
+
+  // The key slots written by a join, if this scan is used as a probe
+  std::vector<uint32_t> probe_slots_;
+
+  // The code-generating tile group accessor
+  codegen::TileGroup tile_group_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
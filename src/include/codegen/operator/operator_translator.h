@@ -89,6 +89,12 @@ class OperatorTranslator {
   virtual void Consume(ConsumerContext &context, RowBatch &batch) const;
   virtual void Consume(ConsumerContext &context, RowBatch::Row &row) const = 0;
 
+  /// The method that produces rows that depend on all the rows the pipeline
+  /// has consumed (e.g., the unmatched rows of an outer join). This is invoked
+  /// at the end of every serial pipeline the operator is a part of, after its
+  /// source has produced all its rows.
+  virtual void ProduceRemaining(ConsumerContext &) const {}
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -53,6 +53,14 @@ class OrderByTranslator : public OperatorTranslator {
   class ProduceResults;
   class SorterAttributeAccess;
 
+  // Define the function producing the normalized sort keys of tuples, if any
+  // of the sort columns can be normalized
+  void DefineNormalizeFunction();
+
+  // Have the sorter at the given location sort on normalized keys, if we have
+  // them
+  void UseNormalizedKeys(llvm::Value *sorter_ptr) const;
+
  private:
   // The child pipeline
   Pipeline child_pipeline_;
@@ -67,6 +75,13 @@ class OrderByTranslator : public OperatorTranslator {
   // The (generated) comparison function
   llvm::Function *compare_func_;
 
+  // The (generated) function producing normalized sort keys, null if the sort
+  // columns can't be normalized. The size of the keys, and whether they decide
+  // the order of tuples without the comparison function.
+  llvm::Function *normalize_func_;
+  uint32_t key_size_;
+  bool key_is_exact_;
+
   struct SortKeyInfo {
     // The sort key
     const planner::AttributeInfo *sort_key;
@@ -165,6 +165,17 @@ class Pipeline {
 
   const OperatorTranslator *NextStep();
 
+  /// Return the operators the rows of the given operator flow through in this
+  /// pipeline, from the closest one to the end of the pipeline
+  std::vector<const OperatorTranslator *> GetConsumers(
+      const OperatorTranslator *translator) const;
+
+  /// Save and restore the current position in the pipeline. Operators that
+  /// send more than one row up the pipeline along different control paths
+  /// must restore the position before sending each one.
+  uint32_t GetPosition() const { return pipeline_index_; }
+  void SetPosition(uint32_t position) { pipeline_index_ = position; }
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Stages
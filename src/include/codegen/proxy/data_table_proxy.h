@@ -25,6 +25,9 @@ PROXY(DataTable) {
 
   /// Proxy DataTable::GetTileGroupCount()
   DECLARE_METHOD(GetTileGroupCount);
+
+  /// Proxy DataTable::GetZoneMap()
+  DECLARE_METHOD(GetZoneMap);
 };
 
 TYPE_BUILDER(DataTable, storage::DataTable);
@@ -40,7 +40,8 @@ PROXY(ExecutorContext) {
   DECLARE_MEMBER(2, codegen::QueryParameters, params);
   DECLARE_MEMBER(3, storage::StorageManager *, storage_manager);
   DECLARE_MEMBER(4, peloton::type::EphemeralPool, pool);
-  DECLARE_MEMBER(5, executor::ExecutorContext::ThreadStates, thread_states);
+  DECLARE_MEMBER(5, char *, copy_input);
+  DECLARE_MEMBER(6, executor::ExecutorContext::ThreadStates, thread_states);
   DECLARE_TYPE;
 };
 
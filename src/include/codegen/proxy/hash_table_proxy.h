@@ -34,7 +34,7 @@ PROXY(HashTable) {
   DECLARE_MEMBER(4, char[sizeof(util::HashTable::EntryBuffer)], entry_buffer);
   DECLARE_MEMBER(5, uint64_t, num_elems);
   DECLARE_MEMBER(6, uint64_t, capacity);
-  DECLARE_MEMBER(7, char[sizeof(std::unique_ptr<char>)], stats);
+  DECLARE_MEMBER(7, char *, spill);
   DECLARE_TYPE;
 
   // Proxy all methods that will be called from codegen
@@ -44,6 +44,9 @@ PROXY(HashTable) {
   DECLARE_METHOD(BuildLazy);
   DECLARE_METHOD(ReserveLazy);
   DECLARE_METHOD(MergeLazyUnfinished);
+  DECLARE_METHOD(BuildLazyPartitioned);
+  DECLARE_METHOD(EnableSpilling);
+  DECLARE_METHOD(NextPass);
   DECLARE_METHOD(Destroy);
 };
 
@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_iterator_proxy.h
+//
+// Identification: src/include/codegen/proxy/index_scan_iterator_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/tile_group_proxy.h"
+#include "codegen/proxy/transaction_context_proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/util/index_scan_iterator.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(IndexScanIterator) {
+  DECLARE_MEMBER(0, char[sizeof(util::IndexScanIterator)], opaque);
+  DECLARE_TYPE;
+
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(GetKeyValues);
+  DECLARE_METHOD(Scan);
+  DECLARE_METHOD(NumBatches);
+  DECLARE_METHOD(GetTileGroup);
+  DECLARE_METHOD(FillSelectionVector);
+};
+
+TYPE_BUILDER(IndexScanIterator, codegen::util::IndexScanIterator);
+
+}  // namespace codegen
+}  // namespace peloton
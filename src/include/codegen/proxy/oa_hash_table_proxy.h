@@ -40,12 +40,20 @@ PROXY(OAHashTable) {
   DECLARE_MEMBER(6, int64_t, entry_size);
   DECLARE_MEMBER(7, int64_t, key_size);
   DECLARE_MEMBER(8, int64_t, value_size);
+  DECLARE_MEMBER(9, char *, memory);
+  DECLARE_MEMBER(10, char *, spill);
 
   DECLARE_TYPE;
 
   DECLARE_METHOD(Init);
   DECLARE_METHOD(StoreTuple);
   DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(InitPartitions);
+  DECLARE_METHOD(DestroyPartitions);
+  DECLARE_METHOD(MergePartitioned);
+  DECLARE_METHOD(EnableSpilling);
+  DECLARE_METHOD(FlushSpilled);
+  DECLARE_METHOD(NextSpilledPartition);
 };
 
 TYPE_BUILDER(KeyValueList, util::OAHashTable::KeyValueList);
@@ -33,6 +33,14 @@ PROXY(Sorter) {
   DECLARE_MEMBER(2, char **, tuples_end);
   DECLARE_MEMBER(3, char[sizeof(std::vector<std::pair<void *, uint64_t>>)],
                  opaque2);
+  DECLARE_MEMBER(4,
+                 char[sizeof(void *) +              // executor context
+                      sizeof(void *) +              // normalize function
+                      sizeof(uint32_t) +            // key size
+                      sizeof(bool) +                // key is exact
+                      sizeof(bool)],                // batch produced
+                 opaque3);
+  DECLARE_MEMBER(5, char *, external);
   DECLARE_TYPE;
   // clang-format on
 
@@ -45,6 +53,9 @@ PROXY(Sorter) {
   DECLARE_METHOD(SortParallel);
   DECLARE_METHOD(SortTopKParallel);
   DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(UseNormalizedKeys);
+  DECLARE_METHOD(NormalizeStringPrefix);
+  DECLARE_METHOD(NextBatch);
 };
 
 TYPE_BUILDER(Sorter, util::Sorter);
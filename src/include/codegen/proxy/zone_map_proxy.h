@@ -13,7 +13,7 @@
 #pragma once
 
 #include "codegen/proxy/proxy.h"
-#include "storage/zone_map_manager.h"
+#include "storage/zone_map.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -26,15 +26,17 @@ PROXY(PredicateInfo) {
   DECLARE_TYPE;
 };
 
-PROXY(ZoneMapManager) {
-  DECLARE_MEMBER(0, char[sizeof(storage::ZoneMapManager)], opaque);
+PROXY(ZoneMap) {
+  /// We don't need access to internal fields, so use an opaque byte array
+  DECLARE_MEMBER(0, char[sizeof(storage::ZoneMap)], opaque);
   DECLARE_TYPE;
+
+  /// Proxy ZoneMap::ShouldScanTileGroup()
   DECLARE_METHOD(ShouldScanTileGroup);
-  DECLARE_METHOD(GetInstance);
 };
 
 TYPE_BUILDER(PredicateInfo, storage::PredicateInfo);
-TYPE_BUILDER(ZoneMapManager, storage::ZoneMapManager);
+TYPE_BUILDER(ZoneMap, storage::ZoneMap);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
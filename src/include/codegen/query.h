@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
+
 #include "codegen/code_context.h"
 #include "codegen/parameter_cache.h"
 #include "codegen/query_parameters.h"
@@ -32,6 +36,10 @@ namespace codegen {
 
 class ExecutionConsumer;
 
+namespace interpreter {
+class BytecodeFunction;
+}  // namespace interpreter
+
 //===----------------------------------------------------------------------===//
 // A compiled query. An instance of this class can be created either by
 // providing a plan and its compiled function components through the constructor
@@ -50,6 +58,9 @@ class Query {
     double init_ms = 0.0;
     double plan_ms = 0.0;
     double tear_down_ms = 0.0;
+    // Time spent executing in the interpreter and as native code
+    double interpreted_ms = 0.0;
+    double native_ms = 0.0;
   };
 
   // We use this handy class for the parameters to the llvm functions
@@ -77,6 +88,9 @@ class Query {
   /// This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(Query);
 
+  /// Destructor. Waits for a background compilation to finish.
+  ~Query();
+
   /**
    * @brief Setup this query with the given JITed function components
    *
@@ -87,6 +101,22 @@ class Query {
   // Compiles the function in this query to native code
   void Compile(CompileStats *stats = nullptr);
 
+  /**
+   * @brief Compiles the functions in this query to native code in the
+   * background. Until the compilation finishes, executions of the query start
+   * in the interpreter and switch to native code as soon as it is available,
+   * i.e., at the next call of a query function or of a pipeline function for
+   * a morsel. Queries the interpreter doesn't support are compiled right away.
+   * The compilation runs on MonoQueuePool::GetCompileInstance(), so a burst of
+   * new queries doesn't start a thread for each of them.
+   */
+  void CompileAsync();
+
+  /// Check whether the native code of this query is available
+  bool IsCompiled() const {
+    return is_compiled_.load(std::memory_order_acquire);
+  }
+
   /**
    * @brief Executes the compiled query.
    *
@@ -126,6 +156,18 @@ class Query {
   void ExecuteInterpreter(FunctionArguments *function_arguments,
                           RuntimeStats *stats);
 
+  // Execute the query in the interpreter while it is compiled in the
+  // background, switching to native code once it is available
+  void ExecuteAdaptive(FunctionArguments *function_arguments,
+                       RuntimeStats *stats);
+
+  // Execute one of the query functions natively, if it has been compiled, or
+  // in the interpreter. Returns the execution time in milliseconds.
+  double ExecuteAdaptiveFunction(
+      compiled_function_t CompiledFunctions::*native_func,
+      const interpreter::BytecodeFunction &bytecode_func,
+      FunctionArguments *function_arguments, RuntimeStats *stats);
+
  private:
   // The query plan
   const planner::AbstractPlan &query_plan_;
@@ -136,6 +178,9 @@ class Query {
   // The size of the parameter the functions take
   QueryState query_state_;
 
+  // The size of the function arguments
+  size_t parameter_size_;
+
   // LLVM IR of the query functions
   LLVMFunctions llvm_functions_;
 
@@ -143,7 +188,17 @@ class Query {
   CompiledFunctions compiled_functions_;
 
   // Shows if the query has been compiled to native code
-  bool is_compiled_;
+  std::atomic<bool> is_compiled_;
+
+  // When the native code became available
+  std::chrono::steady_clock::time_point compiled_at_;
+
+  // The bytecode used until the background compilation finishes
+  struct AdaptiveState;
+  std::unique_ptr<AdaptiveState> adaptive_state_;
+
+  // The background compilation
+  std::shared_future<void> compile_future_;
 };
 
 }  // namespace codegen
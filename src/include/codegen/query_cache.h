@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <list>
+#include <unordered_map>
 
 #include "codegen/query.h"
+#include "common/platform.h"
 #include "common/synchronization/readwrite_latch.h"
 #include "common/singleton.h"
 #include "planner/abstract_plan.h"
@@ -22,24 +26,34 @@
 namespace peloton {
 namespace codegen {
 
-// Query cache implementation that maps an AbstractPlan with a CodeGen query
-// using LRU eviction policy. The cache is implemented as a singleton.
-// Potential enhancements (major):
-//   1) Persistency may increase the performance when rebooted
-//   2) Apply other eviction policies
-//     e.g. Keep some heavy compilation workloads by mixing policies
-//   3) Have a cache per table
-// Potential enhancements (minor):
-//   1) Manually keep some of the compiled results in the cache
-//   2) Configure the cache size
+// Query cache implementation that maps an AbstractPlan with a CodeGen query.
+// The cache is implemented as a singleton.
+//
+// The plans are spread over shards by their hash, each with its own latch, so
+// concurrent lookups of different plans don't contend. A lookup only takes the
+// latch of its shard in shared mode, as the recency of the queries is tracked
+// with a CLOCK reference bit rather than an LRU list. When the compiled code
+// of the cached queries exceeds the capacity, the CLOCK hand of the shard
+// sweeps over its queries and evicts the ones not used since its last pass.
+//
+// Each shard indexes its queries by the tables their plans access, so that
+// the queries of a table are removed without scanning the entire cache.
+//
+// The object code of the queries is persisted by the ObjectCache, so that it
+// doesn't need to be compiled again after a reboot.
+// Potential enhancements:
+//   1) Keep some heavy compilation workloads by weighing in compile times
+//   2) Manually keep some of the compiled results in the cache
 class QueryCache : public Singleton<QueryCache> {
  public:
-  // Find the cached query object with the given plan
-  Query *Find(const std::shared_ptr<planner::AbstractPlan> &key);
+  // Find the cached query object with the given plan. The query remains valid
+  // while the returned pointer is held, even if it is evicted in between.
+  std::shared_ptr<Query> Find(const std::shared_ptr<planner::AbstractPlan> &key);
 
-  // Add a plan and a query object to the cache
+  // Add a plan and a query object to the cache, evicting queries if the
+  // cache exceeds its capacity
   void Add(const std::shared_ptr<planner::AbstractPlan> &key,
-           std::unique_ptr<Query> &&val);
+           std::shared_ptr<Query> val);
 
   // Remove all the items in the cache
   void Clear();
@@ -48,36 +62,90 @@ class QueryCache : public Singleton<QueryCache> {
   void Remove(const oid_t table_oid);
 
   // Get the number of queries currently cached
-  size_t GetCount() const { return cache_map_.size(); }
+  size_t GetCount() const;
 
-  // Get the total capacity of the cache, i.e. max. no. of queries to be cached
+  // Get the memory occupied by the compiled code of the cached queries, in
+  // bytes
+  size_t GetSize() const;
+
+  // Get the total capacity of the cache in bytes, 0 if it is unlimited
   size_t GetCapacity() const { return capacity_; }
 
-  // Set the total capacity of the cache
-  void SetCapacity(size_t capacity) { Resize(capacity); }
+  // Set the total capacity of the cache in bytes, 0 for no limit
+  void SetCapacity(size_t capacity);
+
+  // Get the number of lookups that found a query
+  uint64_t GetHitCount() const;
+
+  // Get the number of lookups that didn't find a query
+  uint64_t GetMissCount() const;
+
+  // Get the number of queries evicted to stay within the capacity
+  uint64_t GetEvictionCount() const;
 
  private:
   friend class Singleton<QueryCache>;
 
-  QueryCache() {}
+  static constexpr size_t kNumShards = 64;
 
-  // Resize the cache in the LRU manner
-  void Resize(size_t target_size);
+  struct Entry {
+    Entry(std::shared_ptr<Query> &&query, size_t size)
+        : query(std::move(query)), size(size), referenced(true) {}
 
-  // Get the table Oid from the plan given
-  oid_t GetOidFromPlan(const planner::AbstractPlan &plan) const;
+    std::shared_ptr<Query> query;
 
- private:
-  std::list<std::pair<std::shared_ptr<planner::AbstractPlan>,
-                      std::unique_ptr<Query>>> query_list_;
+    // The memory occupied by the compiled code when the entry was last
+    // visited. Queries that were added while they compile grow afterwards.
+    size_t size;
+
+    // Set on every lookup, cleared by the CLOCK hand
+    std::atomic<bool> referenced;
+  };
+
+  using EntryList =
+      std::list<std::pair<std::shared_ptr<planner::AbstractPlan>, Entry>>;
 
-  std::unordered_map<std::shared_ptr<planner::AbstractPlan>,
-                     decltype(query_list_.begin()), planner::Hash,
-                     planner::Equal> cache_map_;
+  struct CACHE_ALIGNED Shard {
+    common::synchronization::ReadWriteLatch latch;
 
-  common::synchronization::ReadWriteLatch cache_lock_;
+    // The entries in the order of the CLOCK hand
+    EntryList entries;
+    EntryList::iterator hand = entries.end();
+
+    std::unordered_map<std::shared_ptr<planner::AbstractPlan>,
+                       EntryList::iterator, planner::Hash,
+                       planner::Equal> map;
+
+    // The entries of the plans accessing each table
+    std::unordered_multimap<oid_t, EntryList::iterator> table_index;
+
+    // The memory occupied by the compiled code of the entries
+    size_t size = 0;
+
+    std::atomic<uint64_t> hit_count{0};
+    std::atomic<uint64_t> miss_count{0};
+    std::atomic<uint64_t> eviction_count{0};
+  };
+
+  QueryCache();
+
+  Shard &GetShard(const planner::AbstractPlan &plan) {
+    return shards_[plan.Hash() % kNumShards];
+  }
+
+  // Evict entries of the shard until it is within the given capacity. The
+  // evicted queries are moved to the vector, so that they are destroyed after
+  // the latch is released.
+  void Evict(Shard &shard, size_t capacity,
+             std::vector<std::shared_ptr<Query>> &evicted);
+
+  // Remove the entry from the shard, returning its query
+  std::shared_ptr<Query> Erase(Shard &shard, EntryList::iterator entry);
+
+ private:
+  std::array<Shard, kNumShards> shards_;
 
-  size_t capacity_ = 0;
+  std::atomic<size_t> capacity_{0};
 };
 
 }  // namespace codegen
@@ -79,7 +79,10 @@ class RuntimeFunctions {
                                  ColumnLayoutInfo *infos, uint32_t num_cols);
   
   /**
-   * Execute a parallel scan over the given table in the given database.
+   * Execute a parallel scan over the given table in the given database. The
+   * table is split into morsels of consecutive tile groups that are handed out
+   * dynamically to one task per worker. The callback may therefore be invoked
+   * several times with the same thread state.
    *
    * @param query_state An opaque (but usually a JITed struct) state used during
    * query execution.
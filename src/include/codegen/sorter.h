@@ -43,6 +43,19 @@ class Sorter {
   void Init(CodeGen &codegen, llvm::Value *sorter_ptr,
             llvm::Value *executor_ctx, llvm::Value *comparison_func) const;
 
+  /**
+   * Have the given sorter instance radix sort on normalized keys
+   *
+   * @param codegen The codegen instance
+   * @param sorter_ptr A pointer to the runtime sorter
+   * @param normalize_func The function producing the normalized key of a tuple
+   * @param key_size The size of the normalized keys
+   * @param key_is_exact Do the keys capture the whole sort order?
+   */
+  void UseNormalizedKeys(CodeGen &codegen, llvm::Value *sorter_ptr,
+                         llvm::Value *normalize_func, uint32_t key_size,
+                         bool key_is_exact) const;
+
   /**
    * Store the given tuple into the sorter instance
    *
@@ -99,7 +112,8 @@ class Sorter {
                IterateCallback &callback) const;
 
   /**
-   * @brief Iterate over tuples in this sorter batch-at-a-time
+   * @brief Iterate over tuples in this sorter batch-at-a-time. Sorts that
+   * spilled to disk are iterated over one batch of merged tuples at a time.
    */
   void VectorizedIterate(CodeGen &codegen, llvm::Value *sorter_ptr,
                          uint32_t vector_size, uint64_t offset,
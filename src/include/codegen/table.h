@@ -57,7 +57,8 @@ class Table {
   llvm::Value *GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                             llvm::Value *tile_group_id) const;
 
-  llvm::Value *GetZoneMapManager(CodeGen &codegen) const;
+  /// Given a table instance, return its in-memory zone map.
+  llvm::Value *GetZoneMap(CodeGen &codegen, llvm::Value *table_ptr) const;
 
  private:
   // The table associated with this generator
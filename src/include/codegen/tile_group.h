@@ -45,6 +45,15 @@ class TileGroup {
                        llvm::Value *column_layouts, uint32_t batch_size,
                        ScanCallback &consumer) const;
 
+  // Generate code that passes the tuples with TIDs in the range
+  // [tid_start, tid_end) of the provided tile group to the consumer as a
+  // single batch. Unlike GenerateTidScan(), no loop is generated; this is meant
+  // for callers that already know which tuples they're interested in.
+  void GenerateTidRangeAccess(CodeGen &codegen, llvm::Value *tile_group_ptr,
+                              llvm::Value *column_layouts,
+                              llvm::Value *tid_start, llvm::Value *tid_end,
+                              ScanCallback &consumer) const;
+
   llvm::Value *GetNumTuples(CodeGen &codegen, llvm::Value *tile_group) const;
 
   llvm::Value *GetTileGroupId(CodeGen &codegen, llvm::Value *tile_group) const;
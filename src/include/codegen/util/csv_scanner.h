@@ -142,6 +142,16 @@ class CSVScanner {
    */
   static void Destroy(CSVScanner &scanner);
 
+  /**
+   * Scan the CSV data in the given in-memory buffer instead of the configured
+   * file. This is how rows streamed by a client through COPY ... FROM STDIN are
+   * read. The buffer must stay alive until Produce() returns.
+   *
+   * @param data The CSV data
+   * @param len The number of bytes of CSV data
+   */
+  void SetInput(const char *data, uint64_t len);
+
   /**
    * Produce all the rows stored in the configured CSV file
    */
@@ -180,6 +190,11 @@ class CSVScanner {
   // The CSV file handle
   peloton::util::File file_;
 
+  // The in-memory CSV data, if not reading from a file
+  const char *input_;
+  uint64_t input_len_;
+  uint64_t input_pos_;
+
   // The temporary read-buffer where raw file contents are first read into
   // TODO: make these unique_ptr's with a customer deleter
   char *buffer_;
@@ -14,6 +14,7 @@
 
 #include <cstdint>
 
+#include "codegen/util/spill_file.h"
 #include "executor/executor_context.h"
 
 namespace peloton {
@@ -45,6 +46,18 @@ namespace util {
  * thread-local hash tables to. Finally, calls to MergeLazyUnfinished() are
  * made concurrently from multiple threads to merge lazily-built thread-local
  * hash tables.
+ *
+ * Alternatively, BuildLazyPartitioned() performs the whole parallel build in
+ * one call. It radix-partitions the thread-local entries on the directory
+ * slot they map to and builds each (cache-sized) partition of the directory
+ * from a single thread, avoiding the CAS traffic and cache misses of merging
+ * all thread-local tables into the whole directory concurrently.
+ *
+ * A lazily built table can be bound to the memory limit of its query with
+ * EnableSpilling(). Instead of allocating beyond the limit, InsertLazy() then
+ * writes the entries inserted so far into spill partitions on disk. Such a
+ * table is probed in passes: the build loads as many spilled partitions as fit
+ * into memory, and each call to NextPass() replaces them with the next ones.
  */
 class HashTable {
  public:
@@ -135,6 +148,54 @@ class HashTable {
    */
   void MergeLazyUnfinished(HashTable &other);
 
+  /**
+   * Build this hash table over all the entries lazily inserted into the
+   * thread-local hash tables stored in the thread states argument, in
+   * parallel. This is an alternative to calling ReserveLazy() followed by a
+   * MergeLazyUnfinished() for each thread-local table.
+   *
+   * The build runs in two phases on the execution worker pool. First, each
+   * thread-local table is split into partitions on the high bits of the
+   * directory slot its entries map to. Each partition covers a contiguous,
+   * cache-sized range of the directory. Then, each partition is built by a
+   * single thread, without synchronization.
+   *
+   * @param thread_states Where thread-local hash tables are located
+   * @param hash_table_offset The offset into each state where the thread-local
+   * hash table can be found.
+   */
+  void BuildLazyPartitioned(
+      const executor::ExecutorContext::ThreadStates &thread_states,
+      uint32_t hash_table_offset);
+
+  /**
+   * Bind the provided (empty) table to the memory limit of the query, letting
+   * it spill lazily inserted entries to disk rather than allocate beyond the
+   * limit. Thread-local tables spill into the partitions of the global table.
+   *
+   * @param table The table to bind to the memory limit
+   * @param exec_ctx The context of the query
+   * @param owner The table whose spill partitions the table writes to; the
+   * table itself, if it isn't thread-local
+   */
+  static void EnableSpilling(HashTable &table,
+                             executor::ExecutorContext &exec_ctx,
+                             HashTable *owner);
+
+  /**
+   * Move on to the next pass over a built table that spilled. The entries of
+   * the current pass are dropped, and the next spilled partitions that fit
+   * into memory are loaded and built. A partition that doesn't fit on its own
+   * is split on the next bits of the hash first.
+   *
+   * Every entry of the table is part of exactly one pass, the first of which
+   * is built by BuildLazy() or BuildLazyPartitioned().
+   *
+   * @return True if the table holds the entries of a new pass, false if all
+   * entries were processed
+   */
+  bool NextPass();
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -245,6 +306,21 @@ class HashTable {
      */
     void TransferMemoryBlocks(EntryBuffer &target);
 
+    /**
+     * Drop all entries, keeping a single block of memory to allocate new
+     * entries from.
+     */
+    void Reset();
+
+    /** Would the next entry allocate a new block? */
+    bool IsFull() const { return entry_size_ > available_bytes_; }
+
+    /** The size of an entry */
+    uint32_t EntrySize() const { return entry_size_; }
+
+    /** The size of a block of entries */
+    uint64_t BlockSize() const;
+
    private:
     // This struct represents a chunk of heap memory. We chain together these
     // chunks to avoid the need for a std::vector.
@@ -276,6 +352,25 @@ class HashTable {
   // Resize the hash table
   void Resize();
 
+  // Allocate an entry, and append it to the list of lazily inserted entries
+  char *AppendLazy(uint64_t hash);
+
+  // Build the directory over the lazily inserted entries
+  void BuildDirectory();
+
+  // Should the table spill, rather than allocate another block of entries?
+  bool ShouldSpill() const;
+
+  // Write the lazily inserted entries to the spill partitions, and drop them
+  void SpillLazy();
+
+  // Drop all entries, and start over with an empty lazy table
+  void ResetLazy();
+
+  // Load the next pending spilled partitions that fit into memory, and build
+  // the directory over them. Returns false if no partition was pending.
+  bool LoadPass();
+
  private:
   // The memory allocator used for all allocations in this hash table
   ::peloton::type::AbstractPool &memory_;
@@ -293,8 +388,8 @@ class HashTable {
   uint64_t num_elems_;
   uint64_t capacity_;
 
-  // Info about partitions
-  // ...
+  // Where entries are spilled to, null if the table can't spill
+  SpillPartitions *spill_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_iterator.h
+//
+// Identification: src/include/codegen/util/index_scan_iterator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/item_pointer.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}  // namespace concurrency
+
+namespace index {
+class Index;
+}  // namespace index
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}  // namespace storage
+
+namespace codegen {
+namespace util {
+
+/**
+ * An IndexScanIterator performs the index lookup for an index scan in compiled
+ * code. Generated code writes the values of the scan key into the iterator
+ * (through GetKeyValues()) and calls Scan(). The iterator probes the index,
+ * walks the version chain of every entry it finds to the version visible to
+ * the transaction, and drops versions that no longer match the scan key.
+ *
+ * The surviving tuples are then exposed as a sequence of batches. A batch is a
+ * run of consecutive results (in index order) that live in the same tile group,
+ * so generated code can evaluate predicates and record reads a batch at a time
+ * while preserving the order the index produced them in.
+ */
+class IndexScanIterator {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param table The table the index belongs to
+   * @param index_oid The ID of the index to scan
+   * @param key_column_ids The table columns that appear in the scan key
+   * @param expr_types The comparison applied to each column in the scan key
+   * @param num_keys The number of columns in the scan key
+   * @param max_batch_size The maximum number of tuples in a batch
+   */
+  IndexScanIterator(storage::DataTable &table, oid_t index_oid,
+                    const uint32_t *key_column_ids, const int32_t *expr_types,
+                    uint32_t num_keys, uint32_t max_batch_size);
+
+  /**
+   * Initialization function. This is the entry point from codegen to
+   * initialize iterator instances.
+   */
+  static void Init(IndexScanIterator &iterator, storage::DataTable &table,
+                   uint32_t index_oid, const uint32_t *key_column_ids,
+                   const int32_t *expr_types, uint32_t num_keys,
+                   uint32_t max_batch_size);
+
+  /**
+   * Destruction function. This is the entry point from codegen to clean up
+   * iterator instances.
+   */
+  static void Destroy(IndexScanIterator &iterator);
+
+  /**
+   * Return the array of values of the scan key. Generated code writes the key
+   * into this array before each call to Scan().
+   */
+  char *GetKeyValues() { return reinterpret_cast<char *>(key_values_.data()); }
+
+  /**
+   * Probe the index with the current scan key and collect all the tuples that
+   * are visible to the given transaction
+   */
+  void Scan(concurrency::TransactionContext &txn);
+
+  /**
+   * Return the number of batches the last scan produced
+   */
+  uint32_t NumBatches() const {
+    return static_cast<uint32_t>(batches_.size());
+  }
+
+  /**
+   * Return the tile group all the tuples in the given batch belong to
+   */
+  storage::TileGroup *GetTileGroup(uint32_t batch_idx) const;
+
+  /**
+   * Write the TIDs of all tuples in the given batch into the provided selection
+   * vector, returning the number of TIDs written
+   */
+  uint32_t FillSelectionVector(uint32_t batch_idx,
+                               uint32_t *selection_vector) const;
+
+ private:
+  // Copy the scan key out of the key value array, casting each value to the
+  // type of the column it's compared against. Returns false if the scan can't
+  // produce any tuples (i.e., when comparing against NULL).
+  bool PrepareScanKey(std::vector<peloton::type::Value> &values);
+
+  // Walk the version chain starting at the given location to the version that
+  // is visible to the transaction, if any. Returns false if the transaction
+  // must abort.
+  bool FindVisibleVersion(concurrency::TransactionContext &txn,
+                          ItemPointer &location,
+                          std::shared_ptr<storage::TileGroup> &tile_group,
+                          bool &visible) const;
+
+  // Does the given version still match the scan key?
+  bool MatchesScanKey(storage::TileGroup &tile_group, oid_t tuple_offset,
+                      const std::vector<peloton::type::Value> &values) const;
+
+  // Append a visible tuple to the results, extending the last batch if the
+  // tuple lives in the same tile group
+  void AddResult(const std::shared_ptr<storage::TileGroup> &tile_group,
+                 const ItemPointer &location);
+
+ private:
+  // A run of results that live in the same tile group
+  struct Batch {
+    std::shared_ptr<storage::TileGroup> tile_group;
+    uint32_t start;
+    uint32_t end;
+  };
+
+  // The table and the index we're scanning
+  storage::DataTable &table_;
+  std::shared_ptr<index::Index> index_;
+
+  // The description of the scan key
+  std::vector<oid_t> key_column_ids_;
+  std::vector<ExpressionType> expr_types_;
+
+  // Versions must be checked against the scan key when the index may return
+  // entries that don't match it, i.e., for secondary indexes (whose entries
+  // may point to stale versions) and for open ranges
+  bool recheck_key_;
+
+  // The values of the scan key, written by generated code
+  std::vector<peloton::type::Value> key_values_;
+
+  // The maximum number of tuples in a batch
+  uint32_t max_batch_size_;
+
+  // The locations of all visible tuples, and the batches they're split into
+  std::vector<ItemPointer> locations_;
+  std::vector<Batch> batches_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
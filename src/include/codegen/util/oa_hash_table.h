@@ -14,6 +14,9 @@
 
 #include <functional>
 
+#include "codegen/util/spill_file.h"
+#include "executor/executor_context.h"
+
 namespace peloton {
 namespace codegen {
 namespace util {
@@ -30,12 +33,22 @@ namespace util {
 // key-value pair is stored inside the HashEntry itself to make common case
 // fast; all other values are stored sequentially in an external KeyValueList
 // structure, also in the form of key-value pair.
+//
+// Aggregation tables can be bound to the memory limit of their query. Such a
+// table allocates from the query's pool, and instead of growing beyond the
+// limit, writes all its entries into spill partitions on disk and starts over
+// empty. The spilled partitions are merged back one at a time once the input
+// is consumed.
 //===----------------------------------------------------------------------===//
 class OAHashTable {
  public:
   static uint32_t kDefaultInitialSize;
   static uint32_t kInitialKVListCapacity;
 
+  // The number of partitions thread-local tables are split into when they are
+  // merged in parallel
+  static constexpr uint32_t kNumMergePartitions = 64;
+
   // The structure used for holding multiple values having identical keys.
   // We maintain and grow this data structure in a manner similar to std::vector
   struct KeyValueList {
@@ -105,6 +118,97 @@ class OAHashTable {
    */
   static void Destroy(OAHashTable &table);
 
+  /**
+   * The function that merges the given entries of a thread-local table into
+   * a partition, i.e., that probes the partition with the key of each entry,
+   * combining the values if it is found, and inserting the entry otherwise.
+   */
+  using MergeFunction = void (*)(void *query_state, OAHashTable *partition,
+                                 HashEntry **entries, uint64_t num_entries);
+
+  /**
+   * Prepare an array of kNumMergePartitions partition tables to be merged
+   * into. Until then, the partitions hold no memory and can be destroyed.
+   *
+   * @param partitions The partition tables
+   */
+  static void InitPartitions(OAHashTable *partitions);
+
+  /**
+   * Clean up all resources allocated by the given partition tables
+   *
+   * @param partitions The partition tables
+   */
+  static void DestroyPartitions(OAHashTable *partitions);
+
+  /**
+   * Merge the thread-local tables stored in the thread states into the given
+   * partition tables, in parallel.
+   *
+   * The merge runs in two phases on the execution worker pool. First, the
+   * entries of each thread-local table are split into kNumMergePartitions
+   * partitions on the high bits of their (mixed) hash value. Then, each
+   * partition table is sized to the entries falling into it, and the entries
+   * of all thread-local tables are merged into it by a single thread, without
+   * synchronization. Entries of the same key always fall into the same
+   * partition, so the partitions hold disjoint sets of keys.
+   *
+   * The thread-local tables are left untouched.
+   *
+   * @param query_state The query state passed to the merge function
+   * @param thread_states Where thread-local tables are located
+   * @param table_offset The offset into each state where the thread-local table
+   * can be found
+   * @param partitions The kNumMergePartitions partition tables
+   * @param merge_func The function that merges entries into a partition
+   */
+  static void MergePartitioned(
+      void *query_state,
+      const executor::ExecutorContext::ThreadStates &thread_states,
+      uint32_t table_offset, OAHashTable *partitions,
+      MergeFunction merge_func);
+
+  /**
+   * Bind the provided (empty) table to the memory limit of the query, letting
+   * it spill its entries to disk rather than grow beyond the limit.
+   *
+   * If the query runs in parallel, thread-local tables spill into the
+   * partitions of the global table. MergePartitioned() then spills the
+   * thread-local tables instead of merging them, if any of them spilled.
+   *
+   * @param table The table to bind to the memory limit
+   * @param exec_ctx The context of the query
+   * @param owner The table whose spill partitions the table writes to; the
+   * table itself, if it isn't thread-local
+   */
+  static void EnableSpilling(OAHashTable &table,
+                             executor::ExecutorContext &exec_ctx,
+                             OAHashTable *owner);
+
+  /**
+   * If the provided table spilled, spill the entries it holds as well, such
+   * that all entries of a key are found in the same spilled partition. Called
+   * once all input is inserted, before the table is iterated.
+   *
+   * @param table The table that may have spilled
+   */
+  static void FlushSpilled(OAHashTable &table);
+
+  /**
+   * Load the next spilled partition into the provided (owning) table, merging
+   * the entries of each key with the given merge function. A partition that
+   * exceeds the memory limit again is split on the next bits of the hash, and
+   * its partitions are loaded one at a time instead.
+   *
+   * @param query_state The query state passed to the merge function
+   * @param table The table that owns the spill partitions
+   * @param merge_func The function that merges entries into the table
+   *
+   * @return True if a partition was loaded, false if all were processed
+   */
+  static bool NextSpilledPartition(void *query_state, OAHashTable &table,
+                                   MergeFunction merge_func);
+
   /**
    * Insert a key-value pair into the hash-table. Mostly used for testing.
    *
@@ -204,6 +308,24 @@ class OAHashTable {
   Iterator end();
 
  private:
+  // Allocate and free memory, from the pool of the query if the table is bound
+  // to its memory limit
+  void *Allocate(uint64_t size);
+  void Free(void *ptr);
+
+  // Should the table spill, rather than grow?
+  bool ShouldSpill() const;
+
+  // Write all entries to the spill partitions and empty the table
+  void SpillEntries();
+
+  // Remove all entries from the table, keeping its buckets
+  void Clear();
+
+  // Merge the entries of a spilled partition into this table
+  void MergeSpilled(void *query_state, SpillPartitions::Partition &partition,
+                    MergeFunction merge_func);
+
   // Initialize all slots in the given list to FREE state. This is called for
   // both initialization of the hash-table and during resizing since the resized
   // array must also be initialized.
@@ -271,6 +393,12 @@ class OAHashTable {
 
   // The size of the value itself
   uint64_t value_size_;
+
+  // The pool memory is allocated from, null for the heap
+  ::peloton::type::AbstractPool *memory_;
+
+  // Where entries are spilled to, null if the table can't spill
+  SpillPartitions *spill_;
 };
 
 template <typename Key, typename Value>
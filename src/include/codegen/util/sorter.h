@@ -34,6 +34,16 @@ namespace util {
  * Additionally, Sorter does not serialize elements into its memory space.
  * Instead, it allocates space for incoming tuples on demand and returns a
  * pointer to the call, relying on her to serialize into the space.
+ *
+ * Sorters can be given a function that produces a memcomparable, fixed-size
+ * normalized key for each tuple. The tuples are then radix sorted on these
+ * keys, calling the comparison function only to break ties between keys that
+ * don't capture the whole sort order (e.g., string prefixes).
+ *
+ * Sorters bound to the memory limit of their query (i.e., set up through
+ * Init()) write sorted runs to disk instead of growing beyond the limit. Once
+ * all input is inserted, the runs are merged and the sorted output is handed
+ * out in batches through NextBatch().
  */
 class Sorter {
  private:
@@ -46,6 +56,12 @@ class Sorter {
   using ComparisonFunction = int (*)(const char *left_tuple,
                                      const char *right_tuple);
 
+  using NormalizeFunction = void (*)(const char *tuple, char *key);
+
+  // The sizes of normalized keys the sorter supports. Key sizes must be a
+  // multiple of 8 bytes, up to this maximum.
+  static constexpr uint32_t kMaxNormalizedKeySize = 32;
+
   /**
    * Constructor to create and setup this sorter instance.
    *
@@ -89,6 +105,33 @@ class Sorter {
    */
   static void Destroy(Sorter &sorter);
 
+  /**
+   * Sort tuples on the normalized keys produced by the given function, rather
+   * than on comparisons only.
+   *
+   * @param norm_func The function writing the normalized key of a tuple
+   * @param key_size The size of the normalized keys in bytes, a multiple of 8
+   * no larger than kMaxNormalizedKeySize
+   * @param key_is_exact True if equal keys imply equal tuples in the sort
+   * order, false if the comparison function must break ties
+   */
+  void UseNormalizedKeys(NormalizeFunction norm_func, uint32_t key_size,
+                         bool key_is_exact);
+
+  /**
+   * Write the normalized key of a string column: a prefix of the string padded
+   * with zeros, inverted for descending orders. Called from the generated
+   * normalization functions.
+   *
+   * @param key Where the key of the column is written
+   * @param str The string
+   * @param len The length of the string
+   * @param prefix_len The number of key bytes the column occupies
+   * @param descending Is the column sorted in descending order?
+   */
+  static void NormalizeStringPrefix(char *key, const char *str, uint32_t len,
+                                    uint32_t prefix_len, bool descending);
+
   /**
    * Allocate space for a new input tuple in this sorter. It is assumed that the
    * size of the tuple is equivalent to the tuple size provided when this sorter
@@ -147,6 +190,16 @@ class Sorter {
       const executor::ExecutorContext::ThreadStates &thread_states,
       uint32_t sorter_offset, uint64_t top_k);
 
+  /**
+   * Move on to the next batch of sorted tuples, which are then found between
+   * the start and end of the sorter. Sorts that fit into memory produce all
+   * their tuples in a single batch, sorts that spilled produce the output of
+   * merging their runs batch by batch.
+   *
+   * @return True if a batch was produced, false if all tuples were produced
+   */
+  bool NextBatch();
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -156,6 +209,9 @@ class Sorter {
   /** Return the number tuples stored in this sorter instance */
   uint64_t NumTuples() const { return tuples_.size(); }
 
+  /** Has this sorter written sorted runs to disk? */
+  bool HasSpilled() const { return external_ != nullptr; }
+
   /** Iterators */
   TupleList::iterator begin() { return tuples_.begin(); }
   TupleList::iterator end() { return tuples_.end(); }
@@ -204,12 +260,46 @@ class Sorter {
   void TypedInsertAllForTopK(const std::vector<Tuple> &tuples, uint64_t top_k);
 
  private:
+  // The runs of a sort that spilled to disk, and the state of merging them
+  class ExternalSort;
+
   /**
    * Allocate room for a new tuple. If room is already available, return
    * immediately. If room has to be made, allocate a block of memory from the
-   * memory pool.
+   * memory pool, or spill the buffered tuples if allowed to and the block
+   * would exceed the memory limit.
+   *
+   * @param can_spill Can the buffered tuples be spilled to make room?
    */
-  void MakeRoomForNewTuple();
+  void MakeRoomForNewTuple(bool can_spill);
+
+  /**
+   * Sort the tuples buffered in memory.
+   */
+  void SortInMemory();
+
+  /**
+   * Should the buffered tuples be spilled rather than allocate the next block?
+   */
+  bool ShouldSpill() const;
+
+  /**
+   * Sort the tuples buffered in memory and write them to disk as a sorted run.
+   * All memory but the last block is returned to the pool, the last block is
+   * reused for new tuples.
+   */
+  void SpillRun();
+
+  /**
+   * Take custody of the runs spilled by the provided sorter.
+   */
+  void TransferRuns(Sorter &source);
+
+  /**
+   * Merge the spilled runs down to the number merged at once, and prepare the
+   * final merge that NextBatch() produces the sorted output from.
+   */
+  void StartMerge();
 
   /**
    * Transfer ownership of all allocated memory to the provided sorter instance.
@@ -259,6 +349,24 @@ class Sorter {
 
   // The memory blocks we've allocated (to store tuples) and their sizes
   std::vector<std::pair<void *, uint64_t>> blocks_;
+
+  // The context of the query whose memory limit the sorter is bound to, null
+  // if the sorter can't spill
+  executor::ExecutorContext *exec_ctx_;
+
+  // The function producing the normalized sort keys of tuples, null if the
+  // sorter only compares tuples, and the size of the keys
+  NormalizeFunction norm_func_;
+  uint32_t key_size_;
+
+  // Do the normalized keys capture the whole sort order?
+  bool key_is_exact_;
+
+  // Was the in-memory batch of sorted tuples produced through NextBatch()?
+  bool batch_produced_;
+
+  // The spilled runs, null if the sort fits into memory
+  ExternalSort *external_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/codegen/util/spill_file.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/synchronization/spin_latch.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace codegen {
+namespace util {
+
+/**
+ * A temporary file in the spill directory that a hash table writes its
+ * entries to when it runs out of memory. The file is unlinked as soon as it is
+ * created, so it disappears when it is closed, even if the query fails.
+ */
+class SpillFile {
+ public:
+  /** Create an empty temporary file */
+  SpillFile();
+
+  /** Close (and thereby delete) the file */
+  ~SpillFile();
+
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /** Append the given bytes to the end of the file */
+  void Write(const char *data, uint64_t size);
+
+  /** Move back to the start of the file to read it */
+  void Rewind();
+
+  /**
+   * Read the next bytes of the file.
+   *
+   * @return The number of bytes read, less than the given size only at the end
+   * of the file
+   */
+  uint64_t Read(char *data, uint64_t size);
+
+  /** The number of bytes written to the file */
+  uint64_t Size() const { return size_; }
+
+ private:
+  FILE *file_;
+  uint64_t size_;
+};
+
+/**
+ * The spill files of a hash table, one per partition of the hash values.
+ *
+ * A hash table that exceeds the memory limit of its query writes all its
+ * entries into the partitions, as records of the hash value followed by the
+ * key and value of an entry, and starts over empty. Once all input is
+ * consumed, the partitions are processed one at a time. A partition that
+ * still doesn't fit into memory is split into the partitions of the next
+ * level, each level choosing the partition on the next bits of the hash.
+ *
+ * The thread-local tables of a parallel build share the partitions of their
+ * global table, writing into them concurrently.
+ */
+class SpillPartitions {
+ public:
+  // The number of partitions (i.e., the fan-out) of a level
+  static constexpr uint32_t kNumPartitions = 16;
+
+  // The number of levels before the hash bits run out. Partitions of the
+  // last level are processed in memory, whatever their size.
+  static constexpr uint32_t kMaxLevel = 16;
+
+  /** A spill file to be processed, with the level it was partitioned at */
+  struct Partition {
+    std::unique_ptr<SpillFile> file;
+    uint32_t level;
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param exec_ctx The context of the query, holding its memory limit
+   * @param record_size The size of the records, including the hash value
+   * @param owner The table the partitions belong to, which frees them
+   */
+  SpillPartitions(executor::ExecutorContext &exec_ctx, uint32_t record_size,
+                  const void *owner);
+
+  DISALLOW_COPY_AND_MOVE(SpillPartitions);
+
+  /**
+   * Buffers the records written into each partition by one thread, and
+   * appends them to the partition files in large chunks.
+   */
+  class Writer {
+   public:
+    explicit Writer(SpillPartitions &partitions);
+
+    /** Flushes the buffered records */
+    ~Writer();
+
+    /** Append a record made of the hash and payload to its partition */
+    void Append(uint64_t hash, const char *payload);
+
+    /** Write all buffered records to the partition files */
+    void Finish();
+
+   private:
+    SpillPartitions &partitions_;
+    std::vector<char> buffers_[kNumPartitions];
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Accessors
+  ///
+  //////////////////////////////////////////////////////////////////////////////
+
+  executor::ExecutorContext &GetExecutorContext() const { return exec_ctx_; }
+
+  /// The table the partitions belong to
+  const void *Owner() const { return owner_; }
+
+  /// The size of the records, including the hash value
+  uint32_t RecordSize() const { return record_size_; }
+
+  /// The level records are currently partitioned at
+  uint32_t Level() const { return level_; }
+  void SetLevel(uint32_t level) { level_ = level; }
+
+  /// Can the table spill at the current level?
+  bool CanSpill() const { return level_ < kMaxLevel; }
+
+  /// Were records written to the partitions since they were last taken?
+  bool HasSpilled() const { return spilled_.load(); }
+
+  /// Would allocating the given number of bytes exceed the memory limit?
+  bool ExceedsMemoryLimit(uint64_t bytes) const;
+
+  /// Record a pass over a spilled partition
+  void AddPass();
+
+  //////////////////////////////////////////////////////////////////////////////
+  ///
+  /// Pending partitions
+  ///
+  //////////////////////////////////////////////////////////////////////////////
+
+  /**
+   * Move the partition files written so far into the pending partitions, and
+   * start over with no files at the current level.
+   */
+  void TakeFiles();
+
+  /// Are there pending partitions to process?
+  bool HasPending() const { return !pending_.empty(); }
+
+  /// The next pending partition
+  const Partition &NextPending() const { return pending_.back(); }
+
+  /// Remove the next pending partition
+  Partition PopPending();
+
+  /**
+   * Split the given partition into the partitions of the next level, which
+   * are added to the pending partitions.
+   */
+  void Split(Partition partition);
+
+ private:
+  // The partition a hash value falls into at the current level
+  uint32_t PartitionOf(uint64_t hash) const;
+
+  // Append the given records to the file of the partition
+  void WriteToPartition(uint32_t part, const char *data, uint64_t size);
+
+ private:
+  executor::ExecutorContext &exec_ctx_;
+  uint32_t record_size_;
+  const void *owner_;
+  uint32_t level_;
+  std::atomic<bool> spilled_;
+
+  // The files of the current level, created when they are first written
+  std::unique_ptr<SpillFile> files_[kNumPartitions];
+  common::synchronization::SpinLatch latches_[kNumPartitions];
+
+  // The partitions waiting to be processed
+  std::vector<Partition> pending_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -339,6 +339,8 @@ enum class NetworkMessageType : unsigned char {
   READY_FOR_QUERY = 'Z',
   ROW_DESCRIPTION = 'T',
   DATA_ROW = 'D',
+  COPY_IN_RESPONSE = 'G',
+  COPY_OUT_RESPONSE = 'H',
   // Errors
   HUMAN_READABLE_ERROR = 'M',
   SQLSTATE_CODE_ERROR = 'C',
@@ -351,6 +353,10 @@ enum class NetworkMessageType : unsigned char {
   PARSE_COMMAND = 'P',
   SIMPLE_QUERY_COMMAND = 'Q',
   CLOSE_COMMAND = 'C',
+  // COPY sub-protocol, sent by both sides
+  COPY_DATA = 'd',
+  COPY_DONE = 'c',
+  COPY_FAIL = 'f',
   // SSL willingness
   SSL_YES = 'S',
   SSL_NO = 'N',
@@ -373,7 +379,8 @@ enum class SqlStateErrorCode {
 
 enum class ProtocolType {
   INVALID = INVALID_TYPE_ID,
-  TIMESTAMP_ORDERING = 1  // timestamp ordering
+  TIMESTAMP_ORDERING = 1,  // timestamp ordering
+  OPTIMISTIC = 2           // optimistic concurrency control
 };
 std::string ProtocolTypeToString(ProtocolType type);
 ProtocolType StringToProtocolType(const std::string &str);
@@ -754,7 +761,8 @@ enum class JoinType {
   RIGHT = 2,                  // right
   INNER = 3,                  // inner
   OUTER = 4,                  // outer
-  SEMI = 5                    // IN+Subquery is SEMI
+  SEMI = 5,                   // IN+Subquery is SEMI
+  ANTI = 6                    // NOT IN+Subquery is ANTI
 };
 std::string JoinTypeToString(JoinType type);
 JoinType StringToJoinType(const std::string &str);
@@ -1366,6 +1374,10 @@ enum class RuleType : uint32_t {
   AGGREGATE_TO_PLAIN_AGGREGATE,
   INNER_JOIN_TO_NL_JOIN,
   INNER_JOIN_TO_HASH_JOIN,
+  SEMI_JOIN_TO_HASH_JOIN,
+  ANTI_JOIN_TO_HASH_JOIN,
+  SEMI_JOIN_TO_NL_JOIN,
+  ANTI_JOIN_TO_NL_JOIN,
   IMPLEMENT_DISTINCT,
   IMPLEMENT_LIMIT,
   EXPORT_EXTERNAL_FILE_TO_PHYSICAL,
@@ -1375,6 +1387,8 @@ enum class RuleType : uint32_t {
 
   // Rewrite rules (logical -> logical)
   PUSH_FILTER_THROUGH_JOIN,
+  PUSH_FILTER_THROUGH_SEMI_JOIN,
+  PUSH_FILTER_THROUGH_ANTI_JOIN,
   COMBINE_CONSECUTIVE_FILTER,
   EMBED_FILTER_INTO_GET,
   MARK_JOIN_GET_TO_INNER_JOIN,
@@ -1382,6 +1396,8 @@ enum class RuleType : uint32_t {
   MARK_JOIN_FILTER_TO_INNER_JOIN,
   PULL_FILTER_THROUGH_MARK_JOIN,
   PULL_FILTER_THROUGH_AGGREGATION,
+  PULL_FILTER_THROUGH_SEMI_JOIN,
+  PULL_FILTER_THROUGH_ANTI_JOIN,
 
   // Place holder to generate number of rules compile time
   NUM_RULES
@@ -1407,6 +1423,10 @@ const static std::string RULE_TYPES[] = {
     "AGGREGATE_TO_PLAIN_AGGREGATE",
     "INNER_JOIN_TO_NL_JOIN",
     "INNER_JOIN_TO_HASH_JOIN",
+    "SEMI_JOIN_TO_HASH_JOIN",
+    "ANTI_JOIN_TO_HASH_JOIN",
+    "SEMI_JOIN_TO_NL_JOIN",
+    "ANTI_JOIN_TO_NL_JOIN",
     "IMPLEMENT_DISTINCT",
     "IMPLEMENT_LIMIT",
     "EXPORT_EXTERNAL_FILE_TO_PHYSICAL",
@@ -1414,13 +1434,17 @@ const static std::string RULE_TYPES[] = {
     "RewriteDelimiter",
 
     "PUSH_FILTER_THROUGH_JOIN",
+    "PUSH_FILTER_THROUGH_SEMI_JOIN",
+    "PUSH_FILTER_THROUGH_ANTI_JOIN",
     "COMBINE_CONSECUTIVE_FILTER",
     "EMBED_FILTER_INTO_GET",
     "MARK_JOIN_GET_TO_INNER_JOIN",
     "MARK_JOIN_INNER_JOIN_TO_INNER_JOIN",
     "MARK_JOIN_FILTER_TO_INNER_JOIN",
     "PULL_FILTER_THROUGH_MARK_JOIN",
-    "PULL_FILTER_THROUGH_AGGREGATION"
+    "PULL_FILTER_THROUGH_AGGREGATION",
+    "PULL_FILTER_THROUGH_SEMI_JOIN",
+    "PULL_FILTER_THROUGH_ANTI_JOIN"
 };
 
 
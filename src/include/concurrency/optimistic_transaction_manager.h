@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimistic_transaction_manager.h
+//
+// Identification: src/include/concurrency/optimistic_transaction_manager.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "concurrency/timestamp_ordering_transaction_manager.h"
+
+namespace peloton {
+namespace concurrency {
+
+//===--------------------------------------------------------------------===//
+// optimistic concurrency control
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief      Class for optimistic (Silo-style) transaction manager.
+ *
+ * Writes lock the latest version of a tuple through its transaction id, the
+ * same way as timestamp ordering. Reads under SERIALIZABLE and
+ * REPEATABLE_READS don't touch the tuple header at all, they are recorded in
+ * the read set of the transaction instead.
+ *
+ * At commit, the transaction takes its commit id from the current epoch of the
+ * epoch manager and validates its read set: every version it read must still
+ * be the latest one (its end commit id is MAX_CID) and must not be locked by
+ * another transaction. Otherwise, a concurrent transaction has overwritten the
+ * version, and the transaction aborts.
+ *
+ * As in timestamp ordering, phantoms are not detected.
+ */
+class OptimisticTransactionManager : public TimestampOrderingTransactionManager {
+ public:
+  OptimisticTransactionManager() {}
+
+  /**
+   * @brief      Destroys the object.
+   */
+  virtual ~OptimisticTransactionManager() {}
+
+  /**
+   * @brief      Gets the instance.
+   *
+   * @param[in]  protocol   The protocol
+   * @param[in]  isolation  The isolation
+   * @param[in]  conflict   The conflict
+   *
+   * @return     The instance.
+   */
+  static OptimisticTransactionManager &GetInstance(
+      const ProtocolType protocol, const IsolationLevelType isolation,
+      const ConflictAvoidanceType conflict);
+
+  /**
+   * This method is used to acquire the ownership of a tuple for a transaction.
+   * There are no read timestamps to check, so it succeeds unless another
+   * transaction owns the tuple.
+   *
+   * @param      current_txn        The current transaction
+   * @param[in]  tile_group_header  The tile group header
+   * @param[in]  tuple_id           The tuple identifier
+   *
+   * @return     True if success, False otherwise.
+   */
+  virtual bool AcquireOwnership(
+      TransactionContext *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id);
+
+  /**
+   * @brief      Perform a read operation. The read is only added to the read
+   *             set, it is validated when the transaction commits.
+   *
+   * @param      current_txn        The current transaction
+   * @param[in]  location           The location of the tuple to be read
+   * @param[in]  tile_group_header  Pointer to the tile group header
+   * @param[in]  acquire_ownership  The acquire ownership
+   */
+  virtual bool PerformRead(TransactionContext *const current_txn,
+                           const ItemPointer &location,
+                           storage::TileGroupHeader *tile_group_header,
+                           bool acquire_ownership);
+
+  /**
+   * @brief      Validates the read set and commits a transaction. The
+   *             transaction is aborted if the validation fails.
+   *
+   * @param      current_txn  The current transaction
+   *
+   * @return     The result type
+   */
+  virtual ResultType CommitTransaction(TransactionContext *const current_txn);
+
+ private:
+  /**
+   * @brief      Checks that the versions read by the transaction have neither
+   *             been overwritten nor locked by other transactions.
+   *
+   * @param      current_txn  The current transaction
+   *
+   * @return     True if the read set is valid, False otherwise
+   */
+  bool ValidateReadSet(TransactionContext *const current_txn);
+};
+}
+}
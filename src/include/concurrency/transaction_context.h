@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
@@ -159,6 +160,8 @@ class TransactionContext : public Printable {
                                 index_oid, DDLType::DROP));
   }
 
+  void RecordRead(const ItemPointer &);
+
   void RecordReadOwn(const ItemPointer &);
 
   void RecordUpdate(const ItemPointer &);
@@ -184,6 +187,19 @@ class TransactionContext : public Printable {
 
   void ExecOnCommitTriggers();
 
+  /**
+   * @brief      Adds a callback that runs when the transaction ends, whether
+   *             it commits or aborts. The result and commit id are set by
+   *             then.
+   *
+   * @param      callback  The callback
+   */
+  void AddOnEndCallback(std::function<void()> callback) {
+    on_end_callbacks_.push_back(std::move(callback));
+  }
+
+  void ExecOnEndCallbacks();
+
   /**
    * @brief      Determines if in rw set.
    *
@@ -340,6 +356,8 @@ class TransactionContext : public Printable {
 
   std::unique_ptr<trigger::TriggerSet> on_commit_triggers_;
 
+  std::vector<std::function<void()>> on_end_callbacks_;
+
   /** one default transaction is NOT 'read only' unless it is marked 'read only' explicitly*/
   bool read_only_ = false;
 };
@@ -48,6 +48,10 @@ class AbstractJoinExecutor : public AbstractExecutor {
         return "JoinType::INNER";
       case JoinType::OUTER:
         return "JoinType::OUTER";
+      case JoinType::SEMI:
+        return "JoinType::SEMI";
+      case JoinType::ANTI:
+        return "JoinType::ANTI";
       case JoinType::INVALID:
       default:
         return "JoinType::INVALID";
@@ -137,6 +141,8 @@ class AbstractJoinExecutor : public AbstractExecutor {
     switch (join_type_) {
       case JoinType::LEFT:
       case JoinType::OUTER:
+      case JoinType::SEMI:
+      case JoinType::ANTI:
         no_matching_left_row_sets_[tile_idx].erase(row_idx);
         break;
       default:
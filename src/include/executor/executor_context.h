@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "codegen/query_parameters.h"
 #include "type/ephemeral_pool.h"
 #include "type/value.h"
@@ -61,6 +63,13 @@ class ExecutorContext {
   /// Return the memory pool for this particular query execution
   type::EphemeralPool *GetPool();
 
+  /// Return the rows streamed by the client for a COPY ... FROM STDIN, or
+  /// null if the query does not read from the client
+  const std::string *GetCopyInput() const;
+
+  /// Provide the rows streamed by the client for a COPY ... FROM STDIN
+  void SetCopyInput(const std::string *copy_input);
+
   class ThreadStates {
    public:
     explicit ThreadStates(type::EphemeralPool &pool);
@@ -91,6 +100,28 @@ class ExecutorContext {
 
   ThreadStates &GetThreadStates();
 
+  /// Return the memory (in bytes) the hash tables and sorts of this execution
+  /// may allocate from the pool, 0 if there is no limit
+  size_t GetMemoryLimit() const { return memory_limit_; }
+
+  /// Override the memory limit of this execution
+  void SetMemoryLimit(size_t memory_limit) { memory_limit_ = memory_limit; }
+
+  /// Would allocating the given number of bytes more exceed the memory limit?
+  bool ExceedsMemoryLimit(size_t bytes) const;
+
+  /// Record bytes written to spill files by this execution
+  void AddSpilledBytes(uint64_t bytes);
+
+  /// Record a pass over spilled partitions or sorted runs by this execution
+  void AddSpillPass();
+
+  /// Return the number of bytes written to spill files
+  uint64_t GetSpilledBytes() const;
+
+  /// Return the number of passes over spilled partitions
+  uint64_t GetSpillPasses() const;
+
   /// Number of processed tuples during execution
   uint32_t num_processed = 0;
 
@@ -103,8 +134,15 @@ class ExecutorContext {
   storage::StorageManager *storage_manager_;
   // Temporary memory pool for allocations done during execution
   type::EphemeralPool pool_;
+  // The rows sent by the client for COPY ... FROM STDIN
+  const std::string *copy_input_;
   // Container for all states of all thread participating in this execution
   ThreadStates thread_states_;
+  // The memory limit of the hash tables and sorts, 0 if there is no limit
+  size_t memory_limit_;
+  // What the hash tables and sorts of this execution spilled to disk
+  std::atomic<uint64_t> spilled_bytes_;
+  std::atomic<uint64_t> spill_passes_;
 };
 
 template <typename T>
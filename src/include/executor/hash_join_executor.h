@@ -40,8 +40,16 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  bool HasMatch(const ContainerTuple<LogicalTile> &left_tuple,
+                const std::vector<oid_t> &left_hashed_col_ids);
+
+  bool HasNullRightKey();
+
   HashExecutor *hash_executor_ = nullptr;
 
+  // Whether a row of the right child has a NULL key
+  bool right_has_null_key_ = false;
+
   bool hashed_ = false;
 
   std::deque<LogicalTile *> buffered_output_tiles;
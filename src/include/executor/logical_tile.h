@@ -108,6 +108,13 @@ class LogicalTile : public Printable {
   std::vector<std::vector<std::string>> GetAllValuesAsStrings(
       const std::vector<int> &result_format, bool use_to_string_null);
 
+  /**
+   * @brief Append the values of all visible rows to the given vector, row
+   * after row, encoded in the format of their column (see ResultEncoder).
+   */
+  void GetAllValuesAsResults(const std::vector<int> &result_format,
+                             std::vector<std::string> &values);
+
   // Get a string representation for debugging
   const std::string GetInfo() const;
 
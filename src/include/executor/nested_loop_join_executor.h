@@ -35,6 +35,12 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  inline bool IsSemiOrAntiJoin() const {
+    return join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI;
+  }
+
+  bool BuildSemiOrAntiJoinOutput();
+
   // Right child's result tiles iterator
   size_t right_result_itr_ = 0;
 
@@ -54,6 +60,12 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   // return the combine result when there is a matched right tile. So next time,
   // we will begin from the point of last time, if left_tile_done is false
   bool left_tile_done_ = true;
+
+  // Whether the current left tuple has a match, for semi and anti joins
+  bool left_row_matched_ = false;
+
+  // The tuples of the current left tile that a semi or anti join produces
+  std::vector<oid_t> left_rows_;
 };
 
 }  // namespace executor
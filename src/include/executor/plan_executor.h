@@ -40,8 +40,20 @@ struct ExecutionResult {
   // string of error message
   std::string m_error_message;
 
+  // bytes the hash tables wrote to spill files, and passes over them
+  uint64_t m_spilled_bytes;
+  uint64_t m_spill_passes;
+
+  // milliseconds the compiled query ran in the interpreter and as native code
+  double m_interpreted_ms;
+  double m_native_ms;
+
   ExecutionResult() {
     m_processed = 0;
+    m_spilled_bytes = 0;
+    m_spill_passes = 0;
+    m_interpreted_ms = 0.0;
+    m_native_ms = 0.0;
     m_result = ResultType::SUCCESS;
     m_error_message = "";
   }
@@ -57,8 +69,11 @@ class PlanExecutor {
    * @param plan The physical query plan that will be run
    * @param txn The transactional context the query will run in
    * @param params All parameters the query references
-   * @param result_format No idea ...
+   * @param result_format The format code (text or binary) of every output
+   * column, see ResultEncoder
    * @param on_complete The callback function to invoke when the query finishes.
+   * @param copy_input The CSV rows a COPY ... FROM STDIN loads, if any. Only
+   * compiled plans can read them, the interpreter fails such a plan.
    */
   static void ExecutePlan(
       std::shared_ptr<planner::AbstractPlan> plan,
@@ -66,7 +81,8 @@ class PlanExecutor {
       const std::vector<type::Value> &params,
       const std::vector<int> &result_format,
       std::function<void(executor::ExecutionResult,
-                         std::vector<ResultValue> &&)> on_complete);
+                         std::vector<ResultValue> &&)> on_complete,
+      const std::string *copy_input = nullptr);
 
   /**
    * @brief When a peloton node recvs a query plan, this function is invoked
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_encoder.h
+//
+// Identification: src/include/executor/result_encoder.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/statement.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Result Encoder
+//===--------------------------------------------------------------------===//
+
+/**
+ * Encodes result values the way the Postgres wire protocol sends them, in
+ * text or binary format as the client asked for in its Bind message. The
+ * network layer copies the encoded bytes into DataRow messages as they are.
+ *
+ * A NULL value is encoded as an empty string.
+ */
+class ResultEncoder {
+ public:
+  // Format codes of the Postgres protocol
+  static constexpr int kTextFormat = 0;
+  static constexpr int kBinaryFormat = 1;
+
+  /**
+   * @brief Encode a value into the given result, replacing its contents.
+   *
+   * @param val The value to encode
+   * @param format The format code of the value's column
+   * @param use_to_string_null Encode NULLs as the type's ToString() instead
+   *                           of an empty string
+   * @param result Where the encoded value is written
+   */
+  static void Encode(const type::Value &val, int format,
+                     bool use_to_string_null, ResultValue &result);
+
+  /**
+   * @brief The format code of a column. Columns the client did not give a
+   * format for are sent as text.
+   */
+  static int GetFormat(const std::vector<int> &result_format, size_t column) {
+    return column < result_format.size() ? result_format[column]
+                                         : kTextFormat;
+  }
+
+ private:
+  // Append the binary (big-endian) representation of the value
+  static void EncodeBinary(const type::Value &val, ResultValue &result);
+};
+
+}  // namespace executor
+}  // namespace peloton
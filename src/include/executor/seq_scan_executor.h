@@ -14,6 +14,7 @@
 
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
+#include "executor/vectorized_filter.h"
 
 namespace peloton {
 namespace executor {
@@ -55,6 +56,8 @@ class SeqScanExecutor : public AbstractScanExecutor {
   expression::AbstractExpression *ColumnValueToCmpExpr(
       const oid_t column_id, const type::Value &value);
 
+  bool FilterBatch(LogicalTile &tile);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -81,6 +84,9 @@ class SeqScanExecutor : public AbstractScanExecutor {
   // The original predicate, if it's not nullptr
   // we need to combine it with the undated predicate 
   const expression::AbstractExpression *old_predicate_;
+
+  /** @brief Evaluates the predicate a tile at a time, if it supports it. */
+  std::unique_ptr<VectorizedFilter> vectorized_filter_;
 };
 
 }  // namespace executor
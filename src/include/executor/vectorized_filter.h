@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_filter.h
+//
+// Identification: src/include/executor/vectorized_filter.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+class Tile;
+class TileGroup;
+}
+
+namespace executor {
+
+class ExecutorContext;
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Vectorized Filter
+//===--------------------------------------------------------------------===//
+
+/**
+ * Evaluates a scan predicate a batch of tuples at a time, instead of calling
+ * AbstractExpression::Evaluate() and materializing a type::Value per tuple.
+ *
+ * The filter refines a selection vector, the ids of the tuples that passed so
+ * far. For every term of the predicate, the values of the selected tuples are
+ * gathered from the tile into a typed column vector, the comparison kernel
+ * computes a byte mask over it, and the selection vector is compacted with the
+ * mask. The kernels are plain loops over contiguous arrays that the compiler
+ * turns into SIMD instructions.
+ *
+ * Only conjunctions of comparisons between integer or decimal columns and
+ * constants or parameters are supported. Create() returns nullptr for any
+ * other predicate, which is then evaluated a tuple at a time.
+ */
+class VectorizedFilter {
+ public:
+  /**
+   * @brief Build the filter of a predicate.
+   *
+   * @param predicate The predicate of the scan
+   * @param executor_context The context holding the values of the parameters
+   *
+   * @return The filter, nullptr if the predicate can't be vectorized
+   */
+  static std::unique_ptr<VectorizedFilter> Create(
+      const expression::AbstractExpression *predicate,
+      const ExecutorContext *executor_context);
+
+  /**
+   * @brief Remove the tuples that don't satisfy the predicate from the
+   * selection vector of the tile group. The order of the selected tuples is
+   * kept.
+   *
+   * @return false if a column has a type the filter can't read, in which
+   * case the selection vector is untouched
+   */
+  bool Filter(const storage::TileGroup &tile_group,
+              std::vector<oid_t> &selection) const;
+
+  /**
+   * @brief Remove the rows that don't satisfy the predicate from the
+   * selection vector of the logical tile. The order of the selected rows is
+   * kept.
+   *
+   * @return false if a column has a type the filter can't read, in which
+   * case the selection vector is untouched
+   */
+  bool Filter(const LogicalTile &tile, std::vector<oid_t> &selection) const;
+
+ private:
+  /** @brief A column or a constant a term compares */
+  struct Operand {
+    bool is_column;
+    oid_t column_id;
+    type::Value constant;
+  };
+
+  /** @brief A comparison of two operands */
+  struct Term {
+    ExpressionType comparison;
+    Operand left;
+    Operand right;
+    // Compare as doubles instead of 64-bit integers
+    bool is_decimal;
+  };
+
+  /** @brief Where the values of a column are found in a tile */
+  struct ColumnLocation {
+    const storage::Tile *tile;
+    oid_t column_id;
+    // Tuple ids in the tile, per selected row. nullptr if the selection
+    // vector holds the tuple ids of the tile itself.
+    const std::vector<oid_t> *position_list;
+  };
+
+  VectorizedFilter() = default;
+
+  static bool AddTerms(const expression::AbstractExpression *predicate,
+                       const ExecutorContext *executor_context,
+                       std::vector<Term> &terms);
+
+  static bool GetOperand(const expression::AbstractExpression *expression,
+                         const ExecutorContext *executor_context,
+                         Operand &operand, bool &is_decimal);
+
+  template <typename LocateColumn>
+  bool FilterSelection(const LocateColumn &locate_column,
+                       std::vector<oid_t> &selection) const;
+
+  static bool CanGather(const ColumnLocation &location, bool is_decimal);
+
+  template <typename T>
+  static void Gather(const ColumnLocation &location,
+                     const std::vector<oid_t> &selection, std::vector<T> &values,
+                     std::vector<uint8_t> &mask);
+
+  template <typename T>
+  static void Compare(ExpressionType comparison, const T *left,
+                      const T *right, size_t right_stride, size_t count,
+                      std::vector<uint8_t> &mask);
+
+ private:
+  std::vector<Term> terms_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.h
+//
+// Identification: src/include/gc/tile_group_compactor.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}
+
+namespace gc {
+
+#define MAX_COMPACTION_ATTEMPTS 8
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compactor
+//===--------------------------------------------------------------------===//
+
+/**
+ * The GC hands the full tile groups whose live tuples fall below the
+ * compaction threshold to the compactor, after marking them immutable so that
+ * their free slots are no longer reused.
+ *
+ * The compactor moves every live tuple out of the tile group with an update
+ * that copies the tuple to a slot in another tile group. The update installs
+ * the copy as the newest version and swings the indirection pointer to it, so
+ * the index entries stay valid and concurrent transactions see the tuple
+ * either before or after the move. The moved versions become garbage, and the
+ * GC frees the tile group once it has reclaimed all of its slots.
+ */
+class TileGroupCompactor {
+ public:
+  /**
+   * @brief Move the live tuples out of the tile group. When it conflicts with
+   * other transactions, the GC retries it after they have finished. The tile
+   * group becomes mutable again once all attempts have failed.
+   *
+   * @param attempt The number of attempts made before this one
+   */
+  static void CompactTileGroup(const oid_t &tile_group_id,
+                               const size_t &attempt = 0);
+
+  /**
+   * @brief Move the live tuples out of the tile group in one transaction
+   *
+   * @return true if the transaction committed
+   */
+  static bool MoveTuplesOutOfTileGroup(
+      storage::DataTable *table, std::shared_ptr<storage::TileGroup> tile_group);
+};
+
+}  // namespace gc
+}  // namespace peloton
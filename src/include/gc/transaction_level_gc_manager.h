@@ -14,6 +14,8 @@
 
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +30,17 @@
 #include "common/container/lock_free_queue.h"
 
 namespace peloton {
+
+namespace index {
+class Index;
+}
+
+namespace storage {
+class DataTable;
+class TileGroup;
+class Tuple;
+}
+
 namespace gc {
 
 #define MAX_QUEUE_LENGTH 100000
@@ -36,7 +49,9 @@ namespace gc {
 class TransactionLevelGCManager : public GCManager {
  public:
   TransactionLevelGCManager(const int thread_count)
-      : gc_thread_count_(thread_count), reclaim_maps_(thread_count) {
+      : gc_thread_count_(thread_count),
+        reclaim_maps_(thread_count),
+        dropped_tile_groups_(thread_count) {
     unlink_queues_.reserve(thread_count);
     for (int i = 0; i < gc_thread_count_; ++i) {
       std::shared_ptr<LockFreeQueue<concurrency::TransactionContext* >>
@@ -65,7 +80,14 @@ class TransactionLevelGCManager : public GCManager {
 
     reclaim_maps_.clear();
     reclaim_maps_.resize(gc_thread_count_);
+    dropped_tile_groups_.clear();
+    dropped_tile_groups_.resize(gc_thread_count_);
     recycle_queue_map_.clear();
+    {
+      std::lock_guard<std::mutex> lock(compaction_lock_);
+      compacting_free_slots_.clear();
+      compaction_retries_.clear();
+    }
 
     is_running_ = false;
   }
@@ -129,6 +151,15 @@ class TransactionLevelGCManager : public GCManager {
 
   int Reclaim(const int &thread_id, const eid_t &expired_eid);
 
+  // this function hands a tile group whose tuples could not be moved out
+  // back to the gc. the compactor tries again once the transactions that are
+  // active now have finished.
+  void RetryCompaction(const oid_t &tile_group_id, const size_t &attempt);
+
+  // this function makes a tile group mutable again after the compactor gave
+  // up, and makes the slots reclaimed in the meantime available for reuse.
+  void CancelCompaction(const oid_t &tile_group_id);
+
  private:
   inline unsigned int HashToThread(const size_t &thread_id) {
     return (unsigned int)thread_id % gc_thread_count_;
@@ -144,17 +175,83 @@ class TransactionLevelGCManager : public GCManager {
 
   void Running(const int &thread_id);
 
-  void AddToRecycleMap(concurrency::TransactionContext *txn_ctx);
+  void AddToRecycleMap(const int &thread_id,
+                       concurrency::TransactionContext *txn_ctx);
+
+  // this function makes a reset tuple slot available for reuse. the tile
+  // group is handed to the compactor once few of its slots are in use, and it
+  // is dropped once all of its slots have been reclaimed.
+  void RecycleTupleSlot(const int &thread_id, storage::DataTable *table,
+                        storage::TileGroup *tile_group,
+                        const ItemPointer &location);
+
+  // this function keeps a reclaimed slot of an immutable tile group aside
+  // until the compaction of the tile group succeeds or is cancelled. it
+  // returns false if the tile group is no longer immutable.
+  bool KeepCompactingFreeSlot(storage::TileGroup *tile_group,
+                              const ItemPointer &location);
+
+  // this function hands the compactions to retry that are due to the
+  // compactor.
+  void SubmitCompactions(const eid_t &expired_eid);
+
+  // this function removes an empty tile group from its table. the memory is
+  // freed by Reclaim() once no transaction can be scanning it anymore.
+  void DropTileGroup(const int &thread_id, storage::DataTable *table,
+                     const oid_t &tile_group_id);
+
+  // this function returns the memory of a dropped tile group.
+  void FreeTileGroup(const oid_t &tile_group_id);
 
   bool ResetTuple(const ItemPointer &);
 
+  // an index entry of a garbage version that no live version needs.
+  struct IndexGarbageEntry {
+    std::unique_ptr<storage::Tuple> key;
+    ItemPointer *indirection;
+    ItemPointer location;
+  };
+
+  // the garbage entries of an index, deleted in one batch.
+  struct IndexGarbage {
+    std::shared_ptr<index::Index> index;
+    std::vector<IndexGarbageEntry> entries;
+  };
+
+  typedef std::unordered_map<index::Index *, IndexGarbage> IndexGarbageMap;
+
   // this function iterates the gc context and unlinks every version
   // from the indexes.
   // this function will call the UnlinkVersion() function.
-  void UnlinkVersions(concurrency::TransactionContext *txn_ctx);
-
-  // this function unlinks a specified version from the index.
-  void UnlinkVersion(const ItemPointer location, const GCVersionType type);
+  void UnlinkVersions(concurrency::TransactionContext *txn_ctx,
+                      const eid_t &expired_eid);
+
+  // this function collects the index entries of a specified version that
+  // are no longer needed.
+  void UnlinkVersion(const ItemPointer location, const GCVersionType type,
+                     const eid_t &expired_eid, IndexGarbageMap &index_garbage);
+
+  // this function deletes the collected entries from their indexes and
+  // reports the reclaimed entries and memory to the stats.
+  void DeleteIndexEntries(IndexGarbageMap &index_garbage,
+                          const eid_t &expired_eid);
+
+  // this function takes the ownership of the newest version of a tuple, so
+  // that no writer can create a newer version until it is released. it
+  // returns false if a writer owns the tuple. newest_version is null if no
+  // writer can own the tuple anymore.
+  bool LockNewestVersion(ItemPointer *indirection,
+                         ItemPointer &newest_version);
+
+  // this function releases the ownership taken by LockNewestVersion().
+  void UnlockNewestVersion(const ItemPointer &newest_version);
+
+  // this function checks whether a version of the tuple other than the one at
+  // location may still be read or is being written, and has the key.
+  bool IsKeyInUse(const ItemPointer &location, ItemPointer *indirection,
+                  const storage::Tuple *key,
+                  const std::vector<oid_t> &indexed_columns,
+                  const eid_t &expired_eid);
 
  private:
   //===--------------------------------------------------------------------===//
@@ -181,11 +278,29 @@ class TransactionLevelGCManager : public GCManager {
   std::vector<std::multimap<cid_t, concurrency::TransactionContext* >>
       reclaim_maps_;
 
+  // multimaps for to-be-freed tile groups.
+  // The key is the epoch in which the tile group is dropped from its table,
+  // value is the tile group id.
+  // # dropped_tile_groups == # gc_threads
+  std::vector<std::multimap<eid_t, oid_t>> dropped_tile_groups_;
+
   // queues for to-be-reused tuples.
   // # recycle_queue_maps == # tables
   std::unordered_map<oid_t,
                      std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>>
       recycle_queue_map_;
+
+  // protects the state of the compactions below, and makes setting a tile
+  // group mutable again atomic with keeping its free slots aside.
+  std::mutex compaction_lock_;
+
+  // the free slots of immutable tile groups that are being compacted. the key
+  // is the tile group id.
+  std::unordered_map<oid_t, std::vector<ItemPointer>> compacting_free_slots_;
+
+  // the compactions to retry. the key is the epoch that must have expired
+  // first, value is the tile group id and the number of the next attempt.
+  std::multimap<eid_t, std::pair<oid_t, size_t>> compaction_retries_;
 };
 }
 }  // namespace peloton
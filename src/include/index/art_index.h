@@ -91,8 +91,9 @@ class ArtIndex : public Index {
     return IndexTypeToString(GetIndexMethodType());
   }
 
-  // TODO(pmenon): Implement me
-  size_t GetMemoryFootprint() override { return 0; }
+  /// Return the size of the keys and values stored in the tree, inner nodes
+  /// are not counted
+  size_t GetMemoryFootprint() override;
 
   // TODO(pmenon): Implement me
   bool NeedGC() override { return false; }
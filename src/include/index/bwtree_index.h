@@ -98,8 +98,7 @@ class BWTreeIndex : public Index {
 
   std::string GetTypeName() const override;
 
-  // TODO: Implement this
-  size_t GetMemoryFootprint() override { return 0; }
+  size_t GetMemoryFootprint() override;
   
   bool NeedGC() override {
     return container.NeedGarbageCollection();
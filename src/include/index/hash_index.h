@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.h
+//
+// Identification: src/include/index/hash_index.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "libcuckoo/cuckoohash_map.hh"
+
+#include "common/internal_types.h"
+#include "common/platform.h"
+#include "index/index.h"
+
+#define HASH_TEMPLATE_ARGUMENTS                                           \
+  template <typename KeyType, typename ValueType, typename KeyComparator, \
+            typename KeyEqualityChecker, typename KeyHashFunc,            \
+            typename ValueEqualityChecker>
+
+#define HASH_INDEX_TYPE                                                   \
+  HashIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker,        \
+            KeyHashFunc, ValueEqualityChecker>
+
+namespace peloton {
+namespace index {
+
+/**
+ * Hash index implementation backed by a concurrent cuckoo hash map.
+ *
+ * Every key maps to the list of values indexed under it, and all operations
+ * on a key (including conditional inserts) happen under the lock of the
+ * buckets holding it. Point lookups are therefore O(1) and do not traverse
+ * any tree. The index has no key order: range and full scans visit every
+ * entry and filter with the key comparator.
+ *
+ * Deleting the last value of a key leaves an empty value list behind, which
+ * is cheap to reuse when the key gets inserted again (e.g. on a new version).
+ * PerformGC() removes the empty lists that are left.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename KeyEqualityChecker, typename KeyHashFunc,
+          typename ValueEqualityChecker>
+class HashIndex : public Index {
+  friend class IndexFactory;
+
+  using ValueList = std::vector<ValueType>;
+
+  using MapType =
+      cuckoohash_map<KeyType, ValueList, KeyHashFunc, KeyEqualityChecker>;
+
+ public:
+  HashIndex(IndexMetadata *metadata);
+
+  ~HashIndex();
+
+  bool InsertEntry(const storage::Tuple *key, ItemPointer *value) override;
+
+  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value) override;
+
+  bool CondInsertEntry(const storage::Tuple *key, ItemPointer *value,
+                       std::function<bool(const void *)> predicate) override;
+
+  void Scan(const std::vector<type::Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            ScanDirectionType scan_direction, std::vector<ValueType> &result,
+            const ConjunctionScanPredicate *csp_p) override;
+
+  void ScanLimit(const std::vector<type::Value> &values,
+                 const std::vector<oid_t> &key_column_ids,
+                 const std::vector<ExpressionType> &expr_types,
+                 ScanDirectionType scan_direction,
+                 std::vector<ValueType> &result,
+                 const ConjunctionScanPredicate *csp_p, uint64_t limit,
+                 uint64_t offset) override;
+
+  void ScanAllKeys(std::vector<ValueType> &result) override;
+
+  void ScanKey(const storage::Tuple *key,
+               std::vector<ValueType> &result) override;
+
+  std::string GetTypeName() const override;
+
+  size_t GetMemoryFootprint() override;
+
+  bool NeedGC() override;
+
+  void PerformGC() override;
+
+ private:
+  // Append all values of the given key to the result
+  void GetValue(const KeyType &index_key, std::vector<ValueType> &result);
+
+  // The number of slots the map starts out with
+  static constexpr size_t kInitialCapacity = 1 << 10;
+
+ protected:
+  // equality checker and comparator
+  KeyComparator comparator;
+  KeyEqualityChecker equals;
+  ValueEqualityChecker value_equals;
+
+  // container
+  MapType container;
+
+  // The number of keys whose value list is empty
+  std::atomic<size_t> num_empty_keys;
+};
+
+}  // namespace index
+}  // namespace peloton
@@ -12,6 +12,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "common/platform.h"
+
 namespace peloton {
 namespace index {
 
@@ -21,10 +33,776 @@ namespace index {
 #define SKIPLIST_TEMPLATE_ARGUMENTS                                       \
   template <typename KeyType, typename ValueType, typename KeyComparator, \
             typename KeyEqualityChecker, typename ValueEqualityChecker>
+
+/*
+ * class SkipListUtil - Per-thread state shared by all skiplists
+ */
+class SkipListUtil {
+ public:
+  /*
+   * GetThreadSlot() - A small number that is fixed for the calling thread
+   *
+   * Threads use it to pick the epoch counter they announce themselves in.
+   * Different threads may get the same slot.
+   */
+  static size_t GetThreadSlot();
+
+  /*
+   * RandomHeight() - A random tower height in [1, max_height]
+   *
+   * Every level is kept with probability 1/4
+   */
+  static int RandomHeight(int max_height);
+};
+
+/*
+ * class SkipList - Lock-free skiplist that maps keys to values
+ *
+ * Every key-value pair is a tower of nodes. The bottom level is a lock-free
+ * sorted linked list (Harris), and the upper levels are shortcuts over it.
+ * A node is deleted by setting the lowest bit of its next pointers from the
+ * top level down (logical deletion). The thread that marks the bottom level
+ * owns the delete. Any traversal that runs into a marked node unlinks it.
+ *
+ * The list may hold several values under the same key (one node each), in
+ * which case they are adjacent on the bottom level. A key-value pair is
+ * only ever stored once. New nodes are always linked at the front of the
+ * run of their key, so inserts of the same key conflict on the same
+ * pointer. Checking the run and linking the node is therefore atomic with
+ * respect to other inserts of the key, which makes unique keys and
+ * conditional inserts possible without locks.
+ *
+ * Nodes that were unlinked are reclaimed with epochs. Every operation
+ * announces the current epoch on a per-thread-slot counter. Unlinked nodes
+ * are labeled with an epoch no reader that can still see them is older
+ * than, and freed once every reader of that epoch has left.
+ *
+ * Iteration goes forward and backward, and iterators keep their epoch for
+ * as long as they live. Backward iteration has no back pointers to follow.
+ * Instead it searches for the predecessor of the current key, and buffers
+ * the values of one key at a time.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator,
           typename KeyEqualityChecker, typename ValueEqualityChecker>
 class SkipList {
-  // TODO: Add your declarations here
+ public:
+  // Maximum tower height. With branching factor 4 this comfortably covers
+  // billions of entries.
+  static constexpr int kMaxHeight = 16;
+
+  // Number of epoch counters threads are spread across
+  static constexpr size_t kNumEpochSlots = 64;
+
+  // The number of unlinked nodes after which deleting threads try to
+  // reclaim memory themselves
+  static constexpr size_t kGCInterval = 1024;
+
+ private:
+  /*
+   * struct Node - A tower. The next pointers of all levels are allocated
+   *               right after the struct.
+   */
+  struct Node {
+    KeyType key;
+    ValueType value;
+    int height;
+    // Set once the inserting thread no longer touches the tower
+    std::atomic<bool> fully_linked;
+    // Link in the list of unlinked nodes waiting to be freed
+    Node *gc_next;
+
+    std::atomic<Node *> *Next() {
+      return reinterpret_cast<std::atomic<Node *> *>(this + 1);
+    }
+  };
+
+  /*
+   * struct EpochSlot - Number of threads in each of the two latest epochs
+   *                    that announced themselves in this slot
+   */
+  struct EpochSlot {
+    std::atomic<int64_t> active[2];
+    char padding[CACHELINE_SIZE - 2 * sizeof(std::atomic<int64_t>)];
+  };
+
+ public:
+  /*
+   * class EpochGuard - Keeps the nodes a thread can see from being freed
+   *                    for as long as the guard lives
+   */
+  class EpochGuard {
+   public:
+    explicit EpochGuard(SkipList *list)
+        : list_(list), slot_(SkipListUtil::GetThreadSlot() % kNumEpochSlots) {
+      epoch_ = list_->JoinEpoch(slot_);
+    }
+
+    EpochGuard(EpochGuard &&other)
+        : list_(other.list_), slot_(other.slot_), epoch_(other.epoch_) {
+      other.list_ = nullptr;
+    }
+
+    ~EpochGuard() {
+      if (list_ != nullptr) {
+        list_->LeaveEpoch(slot_, epoch_);
+      }
+    }
+
+    uint64_t GetEpoch() const { return epoch_; }
+
+   private:
+    DISALLOW_COPY(EpochGuard);
+
+    SkipList *list_;
+    size_t slot_;
+    uint64_t epoch_;
+  };
+
+  /*
+   * class ForwardIterator - Visits the live key-value pairs in key order
+   */
+  class ForwardIterator {
+   public:
+    ForwardIterator(ForwardIterator &&other) = default;
+
+    bool IsEnd() const { return node_ == nullptr; }
+
+    const KeyType &GetKey() const { return node_->key; }
+
+    const ValueType &GetValue() const { return node_->value; }
+
+    ForwardIterator &operator++() {
+      node_ = list_->NextLive(node_);
+      return *this;
+    }
+
+   private:
+    friend class SkipList;
+
+    ForwardIterator(SkipList *list, const KeyType *low_key)
+        : list_(list), guard_(list) {
+      Node *pred = (low_key == nullptr ? list_->head_
+                                       : list_->FindLast(low_key, false));
+      node_ = list_->NextLive(pred);
+    }
+
+    DISALLOW_COPY(ForwardIterator);
+
+    SkipList *list_;
+    EpochGuard guard_;
+    Node *node_;
+  };
+
+  /*
+   * class ReverseIterator - Visits the live key-value pairs in reverse key
+   *                         order
+   */
+  class ReverseIterator {
+   public:
+    ReverseIterator(ReverseIterator &&other) = default;
+
+    bool IsEnd() const { return run_.empty(); }
+
+    const KeyType &GetKey() const { return run_[pos_]->key; }
+
+    const ValueType &GetValue() const { return run_[pos_]->value; }
+
+    ReverseIterator &operator++() {
+      if (pos_ > 0) {
+        pos_--;
+      } else {
+        KeyType key = run_.front()->key;
+        LoadPrevRun(list_->FindLast(&key, false));
+      }
+      return *this;
+    }
+
+   private:
+    friend class SkipList;
+
+    ReverseIterator(SkipList *list, const KeyType *high_key)
+        : list_(list), guard_(list) {
+      LoadPrevRun(list_->FindLast(high_key, true));
+    }
+
+    // Load the live nodes of the key of the given node, moving further back
+    // if all of them have been deleted
+    void LoadPrevRun(Node *node) {
+      while (true) {
+        run_.clear();
+        if (node == list_->head_) {
+          return;
+        }
+        KeyType key = node->key;
+        Node *start = list_->FindLast(&key, false);
+        for (Node *curr = list_->NextLive(start);
+             curr != nullptr && list_->key_eq_(curr->key, key);
+             curr = list_->NextLive(curr)) {
+          run_.push_back(curr);
+        }
+        if (!run_.empty()) {
+          pos_ = run_.size() - 1;
+          return;
+        }
+        node = start;
+      }
+    }
+
+    DISALLOW_COPY(ReverseIterator);
+
+    SkipList *list_;
+    EpochGuard guard_;
+    std::vector<Node *> run_;
+    size_t pos_ = 0;
+  };
+
+  SkipList()
+      : key_cmp_{},
+        key_eq_{},
+        value_eq_{},
+        head_{nullptr},
+        global_epoch_{kFirstEpoch},
+        num_retired_{0},
+        memory_usage_{0} {
+    head_ = AllocateNode(KeyType{}, ValueType{}, kMaxHeight);
+    for (auto &slot : epoch_slots_) {
+      slot.active[0] = 0;
+      slot.active[1] = 0;
+    }
+    for (auto &retired : retired_) {
+      retired = nullptr;
+    }
+  }
+
+  ~SkipList() {
+    // Nodes that are still linked
+    Node *curr = GetUnmarked(head_->Next()[0].load());
+    while (curr != nullptr) {
+      Node *next = GetUnmarked(curr->Next()[0].load());
+      FreeNode(curr);
+      curr = next;
+    }
+    FreeNode(head_);
+
+    // Nodes that were unlinked but not freed yet
+    for (auto &retired : retired_) {
+      FreeNodeList(retired.exchange(nullptr));
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(SkipList);
+
+  //===--------------------------------------------------------------------===//
+  // Modifiers
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * Insert() - Insert a key-value pair
+   *
+   * Returns false if the pair already exists, or if unique_key is set and
+   * there is any value under the key
+   */
+  bool Insert(const KeyType &key, const ValueType &value, bool unique_key) {
+    return InsertInternal(key, value, [this, &value, unique_key](
+                                          const ValueType &existing) {
+      return unique_key || value_eq_(existing, value);
+    });
+  }
+
+  /*
+   * ConditionalInsert() - Insert a key-value pair only if the predicate is
+   *                       false for all values under the key
+   *
+   * predicate_satisfied is set if the insert did not happen because of the
+   * predicate. Returns whether the pair was inserted.
+   */
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const void *)> predicate,
+                         bool *predicate_satisfied) {
+    *predicate_satisfied = false;
+    return InsertInternal(key, value, [this, &value, &predicate,
+                                       predicate_satisfied](
+                                          const ValueType &existing) {
+      if (predicate(existing)) {
+        *predicate_satisfied = true;
+        return true;
+      }
+      return value_eq_(existing, value);
+    });
+  }
+
+  /*
+   * Delete() - Delete a key-value pair. Returns false if it does not exist.
+   */
+  bool Delete(const KeyType &key, const ValueType &value) {
+    {
+      EpochGuard guard{this};
+      Node *preds[kMaxHeight];
+      Node *succs[kMaxHeight];
+
+      Node *target = nullptr;
+      while (target == nullptr) {
+        FindRun(key, preds, succs);
+        for (Node *curr = succs[0];
+             curr != nullptr && key_eq_(curr->key, key);
+             curr = NextLive(curr)) {
+          if (!IsMarked(curr->Next()[0].load()) &&
+              value_eq_(curr->value, value)) {
+            target = curr;
+            break;
+          }
+        }
+        if (target == nullptr) {
+          return false;
+        }
+
+        // The inserting thread finishes linking the tower before it returns,
+        // so this only waits when the delete races with the insert itself
+        while (!target->fully_linked.load()) {
+          std::this_thread::yield();
+        }
+
+        if (!MarkNode(target)) {
+          // Somebody else deleted it first. Check whether the pair is back.
+          target = nullptr;
+        }
+      }
+
+      UnlinkNode(target);
+      Retire(target, guard);
+    }
+
+    if (num_retired_.load() >= kGCInterval) {
+      PerformGarbageCollection();
+    }
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Lookups
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * GetValue() - Append all values under the key to the result
+   */
+  void GetValue(const KeyType &key, std::vector<ValueType> &result) {
+    EpochGuard guard{this};
+    for (Node *curr = NextLive(FindLast(&key, false));
+         curr != nullptr && key_eq_(curr->key, key); curr = NextLive(curr)) {
+      result.push_back(curr->value);
+    }
+  }
+
+  // Iterate from the first key
+  ForwardIterator Begin() { return ForwardIterator{this, nullptr}; }
+
+  // Iterate from the first key that is not less than the given key
+  ForwardIterator Begin(const KeyType &low_key) {
+    return ForwardIterator{this, &low_key};
+  }
+
+  // Iterate backward from the last key
+  ReverseIterator RBegin() { return ReverseIterator{this, nullptr}; }
+
+  // Iterate backward from the last key that is not greater than the given key
+  ReverseIterator RBegin(const KeyType &high_key) {
+    return ReverseIterator{this, &high_key};
+  }
+
+  bool KeyCmpLessEqual(const KeyType &lhs, const KeyType &rhs) const {
+    return !key_cmp_(rhs, lhs);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Memory
+  //===--------------------------------------------------------------------===//
+
+  size_t GetMemoryFootprint() const { return memory_usage_.load(); }
+
+  bool NeedGarbageCollection() const { return num_retired_.load() > 0; }
+
+  /*
+   * PerformGarbageCollection() - Free the unlinked nodes no thread can see
+   *
+   * Advances the epoch as far as the threads still running allow, which is
+   * up to two epochs past the oldest running operation. Only one thread
+   * collects at a time; others return right away.
+   */
+  void PerformGarbageCollection() {
+    std::unique_lock<std::mutex> lock{gc_latch_, std::try_to_lock};
+    if (!lock.owns_lock()) {
+      return;
+    }
+    // Nodes are labeled one epoch past their unlinker, and it takes two
+    // advances to drain an epoch, so three rounds free everything that was
+    // unlinked before this call if no operation is running
+    for (int round = 0; round < 3; round++) {
+      if (!TryAdvanceEpoch()) {
+        break;
+      }
+    }
+  }
+
+ private:
+  // Epochs start at two so that the epoch before the previous one is valid
+  static constexpr uint64_t kFirstEpoch = 2;
+
+  //===--------------------------------------------------------------------===//
+  // Marked pointers
+  //===--------------------------------------------------------------------===//
+
+  static bool IsMarked(Node *node) {
+    return (reinterpret_cast<uintptr_t>(node) & 1) != 0;
+  }
+
+  static Node *GetMarked(Node *node) {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(node) | 1);
+  }
+
+  static Node *GetUnmarked(Node *node) {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(node) &
+                                    ~static_cast<uintptr_t>(1));
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Traversal
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * FindRun() - Find the last node before the run of the key (preds) and the
+   *             first node of the run or after it (succs) on every level
+   *
+   * Marked nodes on the way are unlinked
+   */
+  void FindRun(const KeyType &key, Node **preds, Node **succs) {
+  retry:
+    Node *pred = head_;
+    for (int level = kMaxHeight - 1; level >= 0; level--) {
+      Node *curr = GetUnmarked(pred->Next()[level].load());
+      while (curr != nullptr) {
+        Node *succ = curr->Next()[level].load();
+        if (IsMarked(succ)) {
+          Node *expected = curr;
+          if (!pred->Next()[level].compare_exchange_strong(
+                  expected, GetUnmarked(succ))) {
+            goto retry;
+          }
+          curr = GetUnmarked(succ);
+          continue;
+        }
+        if (!key_cmp_(curr->key, key)) {
+          break;
+        }
+        pred = curr;
+        curr = succ;
+      }
+      preds[level] = pred;
+      succs[level] = curr;
+    }
+  }
+
+  /*
+   * FindLast() - The last node on the bottom level whose key is less than
+   *              (or equal to, if inclusive) the given key. A null key finds
+   *              the last node of the list.
+   *
+   * This is read-only. The node returned may be deleted, and is the head if
+   * there is no such node.
+   */
+  Node *FindLast(const KeyType *key, bool inclusive) const {
+    Node *pred = head_;
+    for (int level = kMaxHeight - 1; level >= 0; level--) {
+      Node *curr = GetUnmarked(pred->Next()[level].load());
+      while (curr != nullptr &&
+             (key == nullptr || key_cmp_(curr->key, *key) ||
+              (inclusive && !key_cmp_(*key, curr->key)))) {
+        pred = curr;
+        curr = GetUnmarked(curr->Next()[level].load());
+      }
+    }
+    return pred;
+  }
+
+  // The first node after the given one on the bottom level that is not
+  // deleted
+  static Node *NextLive(Node *node) {
+    Node *curr = GetUnmarked(node->Next()[0].load());
+    while (curr != nullptr && IsMarked(curr->Next()[0].load())) {
+      curr = GetUnmarked(curr->Next()[0].load());
+    }
+    return curr;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Insert and delete
+  //===--------------------------------------------------------------------===//
+
+  /*
+   * InsertInternal() - Link a new tower at the front of the run of the key
+   *                    unless conflicts() is true for a value in the run
+   */
+  template <typename ConflictCheck>
+  bool InsertInternal(const KeyType &key, const ValueType &value,
+                      ConflictCheck conflicts) {
+    EpochGuard guard{this};
+    Node *preds[kMaxHeight];
+    Node *succs[kMaxHeight];
+    Node *new_node = nullptr;
+
+    while (true) {
+      FindRun(key, preds, succs);
+
+      for (Node *curr = succs[0]; curr != nullptr && key_eq_(curr->key, key);
+           curr = NextLive(curr)) {
+        if (!IsMarked(curr->Next()[0].load()) && conflicts(curr->value)) {
+          if (new_node != nullptr) {
+            // It was never published
+            FreeNode(new_node);
+          }
+          return false;
+        }
+      }
+
+      if (new_node == nullptr) {
+        new_node = AllocateNode(key, value, SkipListUtil::RandomHeight(
+                                                kMaxHeight));
+      }
+      for (int level = 0; level < new_node->height; level++) {
+        new_node->Next()[level].store(succs[level]);
+      }
+
+      // Any other insert of this key also links before succs[0]
+      Node *expected = succs[0];
+      if (preds[0]->Next()[0].compare_exchange_strong(expected, new_node)) {
+        break;
+      }
+    }
+
+    // The pair is in; the upper levels only speed up searches
+    for (int level = 1; level < new_node->height; level++) {
+      while (true) {
+        Node *succ = succs[level];
+        Node *curr_next = new_node->Next()[level].load();
+        if (IsMarked(curr_next)) {
+          // Deleted in the meantime, stop linking
+          new_node->fully_linked.store(true);
+          return true;
+        }
+        if (curr_next != succ &&
+            !new_node->Next()[level].compare_exchange_strong(curr_next,
+                                                             succ)) {
+          continue;
+        }
+        Node *expected = succ;
+        if (preds[level]->Next()[level].compare_exchange_strong(expected,
+                                                                new_node)) {
+          break;
+        }
+        FindRun(key, preds, succs);
+      }
+    }
+
+    new_node->fully_linked.store(true);
+    return true;
+  }
+
+  /*
+   * MarkNode() - Logically delete a node by marking its next pointers from
+   *              the top down. Returns true if this thread marked the bottom
+   *              level and therefore owns the delete.
+   */
+  bool MarkNode(Node *node) {
+    for (int level = node->height - 1; level >= 1; level--) {
+      Node *succ = node->Next()[level].load();
+      while (!IsMarked(succ)) {
+        node->Next()[level].compare_exchange_weak(succ, GetMarked(succ));
+      }
+    }
+    Node *succ = node->Next()[0].load();
+    while (!IsMarked(succ)) {
+      if (node->Next()[0].compare_exchange_weak(succ, GetMarked(succ))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*
+   * UnlinkNode() - Make sure a marked node is not linked on any level
+   *
+   * The node is somewhere in the run of its key, so the run is walked on
+   * every level and all marked nodes in it are unlinked
+   */
+  void UnlinkNode(Node *target) {
+    const KeyType &key = target->key;
+  retry:
+    Node *pred = head_;
+    for (int level = kMaxHeight - 1; level >= 0; level--) {
+      // Find the last node before the run, as in FindRun()
+      Node *curr = GetUnmarked(pred->Next()[level].load());
+      while (curr != nullptr) {
+        Node *succ = curr->Next()[level].load();
+        if (IsMarked(succ)) {
+          Node *expected = curr;
+          if (!pred->Next()[level].compare_exchange_strong(
+                  expected, GetUnmarked(succ))) {
+            goto retry;
+          }
+          curr = GetUnmarked(succ);
+          continue;
+        }
+        if (!key_cmp_(curr->key, key)) {
+          break;
+        }
+        pred = curr;
+        curr = succ;
+      }
+
+      if (level >= target->height) {
+        continue;
+      }
+
+      // Walk the run at this level
+      Node *run_pred = pred;
+      while (curr != nullptr && key_eq_(curr->key, key)) {
+        Node *succ = curr->Next()[level].load();
+        if (IsMarked(succ)) {
+          Node *expected = curr;
+          if (!run_pred->Next()[level].compare_exchange_strong(
+                  expected, GetUnmarked(succ))) {
+            goto retry;
+          }
+          if (curr == target) {
+            break;
+          }
+          curr = GetUnmarked(succ);
+          continue;
+        }
+        run_pred = curr;
+        curr = succ;
+      }
+    }
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Epochs
+  //===--------------------------------------------------------------------===//
+
+  uint64_t JoinEpoch(size_t slot) {
+    while (true) {
+      uint64_t epoch = global_epoch_.load();
+      epoch_slots_[slot].active[epoch & 1].fetch_add(1);
+      // If the epoch moved on in between, the collector might not have seen
+      // us. Try again in the new epoch.
+      if (global_epoch_.load() == epoch) {
+        return epoch;
+      }
+      epoch_slots_[slot].active[epoch & 1].fetch_sub(1);
+    }
+  }
+
+  void LeaveEpoch(size_t slot, uint64_t epoch) {
+    epoch_slots_[slot].active[epoch & 1].fetch_sub(1);
+  }
+
+  /*
+   * Retire() - Hand over an unlinked node for reclamation
+   *
+   * While the unlinking thread is in epoch e, the global epoch is at most
+   * e + 1, so no thread that can still see the node is newer than e + 1
+   */
+  void Retire(Node *node, const EpochGuard &guard) {
+    uint64_t label = guard.GetEpoch() + 1;
+    auto &retired = retired_[label % 3];
+    node->gc_next = retired.load();
+    while (!retired.compare_exchange_weak(node->gc_next, node)) {
+    }
+    num_retired_++;
+  }
+
+  /*
+   * TryAdvanceEpoch() - Move from epoch e to e + 1 if no thread is left in
+   *                     epoch e - 1, and free the nodes labeled e - 1
+   *
+   * Must be called with the GC latch held
+   */
+  bool TryAdvanceEpoch() {
+    uint64_t epoch = global_epoch_.load();
+    uint64_t prev_epoch = epoch - 1;
+    for (auto &slot : epoch_slots_) {
+      if (slot.active[prev_epoch & 1].load() != 0) {
+        return false;
+      }
+    }
+    // Threads only join the current epoch, and unlinkers in epoch e label
+    // with e + 1, so nobody adds to this list any more
+    Node *garbage = retired_[prev_epoch % 3].exchange(nullptr);
+    global_epoch_.store(epoch + 1);
+
+    size_t freed = FreeNodeList(garbage);
+    num_retired_ -= freed;
+    LOG_TRACE("SkipList GC: freed %zu nodes, epoch is now %lu", freed,
+              epoch + 1);
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Allocation
+  //===--------------------------------------------------------------------===//
+
+  static size_t NodeSize(int height) {
+    return sizeof(Node) + height * sizeof(std::atomic<Node *>);
+  }
+
+  Node *AllocateNode(const KeyType &key, const ValueType &value, int height) {
+    void *mem = ::operator new(NodeSize(height));
+    Node *node = new (mem) Node{key, value, height, {false}, nullptr};
+    for (int level = 0; level < height; level++) {
+      new (&node->Next()[level]) std::atomic<Node *>{nullptr};
+    }
+    memory_usage_ += NodeSize(height);
+    return node;
+  }
+
+  void FreeNode(Node *node) {
+    memory_usage_ -= NodeSize(node->height);
+    node->~Node();
+    ::operator delete(node);
+  }
+
+  size_t FreeNodeList(Node *node) {
+    size_t count = 0;
+    while (node != nullptr) {
+      Node *next = node->gc_next;
+      FreeNode(node);
+      node = next;
+      count++;
+    }
+    return count;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Data Members
+  //===--------------------------------------------------------------------===//
+
+  KeyComparator key_cmp_;
+  KeyEqualityChecker key_eq_;
+  ValueEqualityChecker value_eq_;
+
+  // Tower of full height before the first node. Its key is never looked at.
+  Node *head_;
+
+  std::atomic<uint64_t> global_epoch_;
+  EpochSlot epoch_slots_[kNumEpochSlots];
+
+  // Unlinked nodes by label epoch modulo 3
+  std::atomic<Node *> retired_[3];
+  std::atomic<size_t> num_retired_;
+
+  // Only one thread collects garbage at a time
+  std::mutex gc_latch_;
+
+  std::atomic<size_t> memory_usage_;
 };
 
 }  // namespace index
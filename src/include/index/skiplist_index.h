@@ -4,7 +4,7 @@
 //
 // skiplist_index.h
 //
-// Identification: src/index/skiplist_index.h
+// Identification: src/include/index/skiplist_index.h
 //
 // Copyright (c) 2015-17, Carnegie Mellon University Database Group
 //
@@ -33,6 +33,11 @@ namespace index {
 /**
  * Skiplist-based index implementation.
  *
+ * The container is a lock-free skiplist, so unlike the BwTree there are no
+ * delta chains to consolidate and no node splits: inserts into the hot end
+ * of the key space (e.g. monotonically increasing timestamps) cost the same
+ * as anywhere else. Scans can go in both directions.
+ *
  * @see Index
  */
 template <typename KeyType, typename ValueType, typename KeyComparator,
@@ -51,18 +56,18 @@ class SkipListIndex : public Index {
 
   ~SkipListIndex();
 
-  bool InsertEntry(const storage::Tuple *key, ItemPointer *value);
+  bool InsertEntry(const storage::Tuple *key, ItemPointer *value) override;
 
-  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value);
+  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value) override;
 
   bool CondInsertEntry(const storage::Tuple *key, ItemPointer *value,
-                       std::function<bool(const void *)> predicate);
+                       std::function<bool(const void *)> predicate) override;
 
   void Scan(const std::vector<type::Value> &values,
             const std::vector<oid_t> &key_column_ids,
             const std::vector<ExpressionType> &expr_types,
             ScanDirectionType scan_direction, std::vector<ValueType> &result,
-            const ConjunctionScanPredicate *csp_p);
+            const ConjunctionScanPredicate *csp_p) override;
 
   void ScanLimit(const std::vector<type::Value> &values,
                  const std::vector<oid_t> &key_column_ids,
@@ -70,22 +75,20 @@ class SkipListIndex : public Index {
                  ScanDirectionType scan_direction,
                  std::vector<ValueType> &result,
                  const ConjunctionScanPredicate *csp_p, uint64_t limit,
-                 uint64_t offset);
+                 uint64_t offset) override;
 
-  void ScanAllKeys(std::vector<ValueType> &result);
+  void ScanAllKeys(std::vector<ValueType> &result) override;
 
-  void ScanKey(const storage::Tuple *key, std::vector<ValueType> &result);
+  void ScanKey(const storage::Tuple *key,
+               std::vector<ValueType> &result) override;
 
-  std::string GetTypeName() const;
+  std::string GetTypeName() const override;
 
-  // TODO: Implement this
-  size_t GetMemoryFootprint() { return 0; }
+  size_t GetMemoryFootprint() override;
 
-  // TODO: Implement this
-  bool NeedGC() { return false; }
+  bool NeedGC() override;
 
-  // TODO: Implement this
-  void PerformGC() { return; }
+  void PerformGC() override;
 
  protected:
   // equality checker and comparator
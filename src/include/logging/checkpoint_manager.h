@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <thread>
 
@@ -61,6 +62,12 @@ class CheckpointManager {
 
   virtual size_t GetTableCount() { return 0; }
 
+  virtual cid_t DoCheckpoint() { return INVALID_CID; }
+
+  virtual bool DoRecovery(const std::vector<std::string> &logging_dirs UNUSED_ATTRIBUTE) {
+    return false;
+  }
+
  protected:
   volatile bool is_running_;
 };
@@ -46,6 +46,8 @@ public:
 
   inline size_t GetSize() { return size_; }
 
+  inline size_t GetCapacity() { return log_buffer_capacity_; }
+
   inline size_t GetEpochId() { return eid_; }
 
   inline size_t GetThreadId() { return thread_id_; }
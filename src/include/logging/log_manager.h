@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <thread>
 
@@ -49,6 +50,8 @@ class LogManager {
   // Get status of whether logging threads are running or not
   bool GetStatus() { return this->is_running_; }
 
+  virtual void SetDirectories(const std::vector<std::string> &logging_dirs UNUSED_ATTRIBUTE) {}
+
   virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) {}
 
   virtual void StartLogging() {}
@@ -61,7 +64,7 @@ class LogManager {
 
   virtual size_t GetTableCount() { return 0; }
 
-  virtual void LogBegin() {}
+  virtual void LogBegin(const cid_t &commit_id UNUSED_ATTRIBUTE) {}
 
   virtual void LogEnd() {}
 
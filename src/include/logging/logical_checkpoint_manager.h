@@ -12,15 +12,57 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
 #include "logging/checkpoint_manager.h"
 
 namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}
+
+class SerializeInput;
+class SerializeOutput;
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
 // logical checkpoint Manager
 //===--------------------------------------------------------------------===//
 
+/**
+ * checkpoint directory layout :
+ *
+ * dir_name + "/checkpoint_" + checkpoint_cid + "/table_" + database_id + "_" +
+ * table_id + "_" + writer_id
+ *
+ * A checkpoint holds every tuple version that is visible at checkpoint_cid,
+ * which is the first commit id of an epoch. Each writer thread writes the
+ * tile groups it is handed to its own file per table. A checkpoint is complete
+ * once its metadata file exists, older checkpoints are removed after that.
+ *
+ * checkpoint file layout : the values of one tuple after another, in the
+ * format of the log.
+ *
+ * Checkpoints don't block transactions: the checkpoint runs in a transaction
+ * that keeps the versions it reads from being collected, and it waits for the
+ * transactions of earlier epochs to finish before it reads.
+ *
+ * Recovery loads the latest checkpoint and replays the log records of the
+ * transactions that committed at or after its commit id, up to the persistent
+ * epoch. Log records and checkpoint tuples are grouped by table and restored
+ * in parallel, the indexes are filled as the tuples are inserted.
+ */
 class LogicalCheckpointManager : public CheckpointManager {
  public:
   LogicalCheckpointManager(const LogicalCheckpointManager &) = delete;
@@ -28,7 +70,8 @@ class LogicalCheckpointManager : public CheckpointManager {
   LogicalCheckpointManager(LogicalCheckpointManager &&) = delete;
   LogicalCheckpointManager &operator=(LogicalCheckpointManager &&) = delete;
 
-  LogicalCheckpointManager(const int thread_count) : checkpointer_thread_count_(thread_count) {}
+  LogicalCheckpointManager(const int thread_count)
+      : checkpointer_thread_count_(thread_count) {}
 
   virtual ~LogicalCheckpointManager() {}
 
@@ -39,11 +82,15 @@ class LogicalCheckpointManager : public CheckpointManager {
 
   virtual void Reset() { is_running_ = false; }
 
-  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) {}
+  void SetDirectory(const std::string &checkpoint_dir);
+
+  const std::string &GetDirectory() const { return checkpoint_dir_; }
+
+  virtual void StartCheckpointing(std::vector<std::unique_ptr<std::thread>> &checkpointer_threads) override;
 
-  virtual void StartLogging() {}
+  virtual void StartCheckpointing() override;
 
-  virtual void StopLogging() {}
+  virtual void StopCheckpointing() override;
 
   virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
@@ -51,9 +98,88 @@ class LogicalCheckpointManager : public CheckpointManager {
 
   virtual size_t GetTableCount() { return 0; }
 
+  /**
+   * @brief Write a checkpoint of all tables that are not catalog tables
+   *
+   * @return The commit id the checkpoint is consistent at, INVALID_CID if it
+   * failed
+   */
+  virtual cid_t DoCheckpoint() override;
+
+  /**
+   * @brief Restore the tables from the latest checkpoint and the log in the
+   * given directories. The tables must exist and be empty, and the log must
+   * not be running. A new checkpoint replaces the log that was replayed.
+   *
+   * @return true if a checkpoint or a log was found
+   */
+  virtual bool DoRecovery(const std::vector<std::string> &logging_dirs) override;
+
+  // The commit id of the latest complete checkpoint, INVALID_CID if there is
+  // none
+  cid_t GetLatestCheckpointCid();
+
+ private:
+  // The serialized tuples of a table, and how many copies of each are live
+  typedef std::unordered_map<std::string, int64_t> TupleCounts;
+
+  // database id and table id
+  typedef std::pair<oid_t, oid_t> TableId;
+
+  // The main loop of the checkpointer thread
+  void Running();
+
+  cid_t CreateCheckpoint();
+
+  // Serialize the tuples of the tile group that are visible at checkpoint_cid
+  void WriteTileGroup(storage::TileGroup *tile_group, const cid_t checkpoint_cid,
+                      SerializeOutput &output);
+
+  // Add the tuples of a checkpoint file to the tuple counts
+  bool LoadCheckpointFile(const std::string &path, storage::DataTable *table,
+                          TupleCounts &tuples);
+
+  // Add the committed transactions of a log record stream to the tuple counts
+  void ReplayLogStream(const std::string &stream, const cid_t checkpoint_cid,
+                       std::map<TableId, TupleCounts> &tables);
+
+  // Insert the live tuples into the tables, filling their indexes
+  void InsertTuples(const std::vector<storage::DataTable *> &tables,
+                    const std::vector<TupleCounts> &tuples);
+
+  std::string GetCheckpointPath(const cid_t checkpoint_cid) const {
+    return checkpoint_dir_ + "/" + checkpoint_dirname_prefix_ + "_" +
+           std::to_string(checkpoint_cid);
+  }
+
+  // Run task(0) ... task(task_count - 1) on thread_count threads
+  static void RunTasks(const size_t task_count, const size_t thread_count,
+                       const std::function<void(size_t)> &task);
+
+  // Read the values of one tuple, returning its serialized form
+  static std::string ReadTuple(SerializeInput &input, const catalog::Schema *schema);
+
  private:
   int checkpointer_thread_count_;
 
+  std::string checkpoint_dir_;
+
+  std::vector<std::unique_ptr<std::thread>> checkpointer_threads_;
+
+  // Only one checkpoint or recovery at a time
+  std::mutex checkpoint_mutex_;
+
+  // Wakes the checkpointer thread up when checkpointing stops
+  std::mutex running_mutex_;
+  std::condition_variable running_cv_;
+
+  const std::string checkpoint_dirname_prefix_ = "checkpoint";
+  const std::string checkpoint_filename_prefix_ = "table";
+  const std::string metadata_filename_ = "metadata";
+
+  // The files written by the log manager
+  const std::string logging_filename_prefix_ = "log";
+  const std::string pepoch_filename_ = "pepoch";
 };
 
 }  // namespace logging
@@ -12,9 +12,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
+
+#include "common/synchronization/spin_latch.h"
 #include "logging/log_manager.h"
+#include "logging/logical_logger.h"
 
 namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
@@ -24,20 +36,30 @@ namespace logging {
 
 /**
  * logging file name layout :
- * 
- * dir_name + "/" + prefix + "_" + epoch_id
  *
+ * dir_name + "/" + prefix + "_" + logger_id + "_" + epoch_id
  *
- * logging file layout :
+ * where epoch_id is the epoch of the first frame in the file.
+ * The persistent epoch is appended to dir_name + "/pepoch" in the first
+ * directory every time it advances.
+ *
+ * logging record layout :
  *
  *  -----------------------------------------------------------------------------
- *  | txn_id | database_id | table_id | operation_type | data | ... | txn_end_flag
+ *  | BEGIN | cid | operation_type | database_id | table_id | data | ... | COMMIT | cid
  *  -----------------------------------------------------------------------------
  *
+ * data is the tuple for inserts, the old tuple for deletes, and the old tuple
+ * followed by the new tuple for updates.
+ *
  * NOTE: this layout is designed for logical logging.
  *
  * NOTE: tuple length can be obtained from the table schema.
  *
+ * Group commit: a transaction logs in the epoch that is current when it
+ * starts logging, and its commit returns once every logger has persisted
+ * that epoch. Each worker thread appends to its own buffers, and one logger
+ * thread per log directory flushes the buffers of its workers.
  */
 
 class LogicalLogManager : public LogManager {
@@ -47,7 +69,11 @@ class LogicalLogManager : public LogManager {
   LogicalLogManager(LogicalLogManager &&) = delete;
   LogicalLogManager &operator=(LogicalLogManager &&) = delete;
 
-  LogicalLogManager(const int thread_count) : logger_thread_count_(thread_count) {}
+  LogicalLogManager(const int thread_count)
+      : logger_thread_count_(thread_count),
+        running_logger_count_(0),
+        generation_(0),
+        persist_epoch_id_(INVALID_EID) {}
 
   virtual ~LogicalLogManager() {}
 
@@ -56,73 +82,101 @@ class LogicalLogManager : public LogManager {
     return log_manager;
   }
 
-  // virtual void SetDirectories(const std::vector<std::string> &logging_dirs) override {
-  //   logger_dirs_ = logging_dirs;
+  virtual void SetDirectories(const std::vector<std::string> &logging_dirs) override;
 
-  //   if (logging_dirs.size() > 0) {
-  //     pepoch_dir_ = logging_dirs.at(0);
-  //   }
-  //   // check the existence of logging directories.
-  //   // if not exists, then create the directory.
-  //   for (auto logging_dir : logging_dirs) {
-  //     if (LoggingUtil::CheckDirectoryExistence(logging_dir.c_str()) == false) {
-  //       LOG_INFO("Logging directory %s is not accessible or does not exist", logging_dir.c_str());
-  //       bool res = LoggingUtil::CreateDirectory(logging_dir.c_str(), 0700);
-  //       if (res == false) {
-  //         LOG_ERROR("Cannot create directory: %s", logging_dir.c_str());
-  //       }
-  //     }
-  //   }
+  virtual const std::vector<std::string> &GetDirectories() {
+    return logger_dirs_;
+  }
+
+  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> &logger_threads) override;
 
-  //   logger_count_ = logging_dirs.size();
-  //   for (size_t i = 0; i < logger_count_; ++i) {
-  //     loggers_.emplace_back(new PhyLogLogger(i, logging_dirs.at(i)));
-  //   }
-  // }
+  virtual void StartLogging() override;
 
-  // virtual const std::vector<std::string> &GetDirectories() override {
-  //   return logger_dirs_;
-  // }
+  /**
+   * @brief Stop the loggers after they flushed everything. Must not be called
+   * while transactions are committing.
+   */
+  virtual void StopLogging() override;
 
+  virtual void RegisterTable(const oid_t &table_id) override;
 
-  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) override {}
+  virtual void DeregisterTable(const oid_t &table_id) override;
 
-  virtual void StartLogging() override {}
+  virtual size_t GetTableCount() override;
 
-  virtual void StopLogging() override {}
+  virtual void LogBegin(const cid_t &commit_id) override;
 
-  virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) override {}
+  /**
+   * @brief Hand the records of the transaction to its logger, and wait until
+   * they are durable.
+   */
+  virtual void LogEnd() override;
 
-  virtual void DeregisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) override {}
+  virtual void LogInsert(const ItemPointer &tuple_pos) override;
 
-  virtual size_t GetTableCount() override { return 0; }
+  virtual void LogUpdate(const ItemPointer &new_tuple_pos) override;
 
-  virtual void LogBegin() override {}
+  virtual void LogDelete(const ItemPointer &old_tuple_pos) override;
 
-  virtual void LogEnd() override {}
+  // The epoch up to which every committed transaction is durable
+  eid_t GetPersistentEpochId() const { return persist_epoch_id_.load(); }
 
-  virtual void LogInsert(const ItemPointer & UNUSED_ATTRIBUTE) override {}
-  
-  virtual void LogUpdate(const ItemPointer & UNUSED_ATTRIBUTE) override {}
-  
-  virtual void LogDelete(const ItemPointer & UNUSED_ATTRIBUTE) override { }
+  // The number of bytes written to disk by all loggers
+  uint64_t GetBytesFlushed() const;
+
+  // The number of fsyncs issued by all loggers
+  uint64_t GetSyncCount() const;
+
+ private:
+  // The main loop of a logger thread
+  void Running(const size_t logger_id);
+
+  // The log state of the calling thread, registered on first use
+  LogWorkerContext *GetWorkerContext();
+
+  // Serialize a tuple version into the transaction of the worker
+  void WriteTuple(LogWorkerContext *worker, storage::TileGroup *tile_group,
+                  const oid_t tuple_offset);
+
+  void WriteRecordHeader(LogWorkerContext *worker, const LogRecordType type,
+                         storage::TileGroup *tile_group);
+
+  // Move the transaction of the worker into its buffers
+  void PublishTransaction(LogWorkerContext *worker);
+
+  // Advance the persistent epoch to the minimum over all loggers
+  void UpdatePersistentEpoch();
 
  private:
   int logger_thread_count_;
 
-  // std::atomic<oid_t> worker_count_;
+  std::vector<std::string> logger_dirs_;
+
+  std::vector<std::unique_ptr<LogicalLogger>> loggers_;
+
+  // Logger threads owned by this manager, see StartLogging()
+  std::vector<std::unique_ptr<std::thread>> logger_threads_;
 
-  // std::vector<std::string> logger_dirs_;
+  // The number of loggers that haven't finished their last flush
+  std::atomic<size_t> running_logger_count_;
 
-  // std::vector<std::shared_ptr<PhyLogLogger>> loggers_;
+  // Worker contexts of all threads that logged since the last start
+  common::synchronization::SpinLatch worker_lock_;
+  std::vector<std::shared_ptr<LogWorkerContext>> workers_;
 
-  // std::unique_ptr<std::thread> pepoch_thread_;
-  // volatile bool is_running_;
+  // Bumped on every start, so threads drop contexts of an earlier run
+  std::atomic<uint64_t> generation_;
 
-  // std::string pepoch_dir_;
+  // Committing transactions wait here for their epoch to become durable
+  std::mutex persist_mutex_;
+  std::condition_variable persist_cv_;
+  std::atomic<eid_t> persist_epoch_id_;
+  FileHandle pepoch_file_;
 
-  // const std::string pepoch_filename_ = "pepoch";
+  common::synchronization::SpinLatch table_lock_;
+  std::unordered_set<oid_t> tables_;
 
+  const std::string pepoch_filename_ = "pepoch";
 };
 
 }  // namespace logging
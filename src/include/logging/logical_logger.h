@@ -4,7 +4,7 @@
 //
 // logical_logger.h
 //
-// Identification: src/logging/logical_logger.h
+// Identification: src/include/logging/logical_logger.h
 //
 // Copyright (c) 2015-16, Carnegie Mellon University Database Group
 //
@@ -12,137 +12,150 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <string>
 #include <vector>
-#include <thread>
-#include <list>
-#include <stack>
-#include <unordered_map>
 
-#include "concurrency/transaction_context.h"
-#include "concurrency/epoch_manager.h"
+#include "common/internal_types.h"
+#include "common/synchronization/spin_latch.h"
 #include "logging/log_buffer.h"
-#include "logging/log_record.h"
 #include "logging/log_buffer_pool.h"
-#include "logging/log_manager.h"
-#include "logging/worker_context.h"
-#include "type/types.h"
-#include "common/serializer.h"
-#include "common/lockfree_queue.h"
-#include "common/logger.h"
-#include "common/pool.h"
-#include "common/synchronization/spin_lock.h"
+#include "type/serializeio.h"
 
 namespace peloton {
-  
-namespace storage {
-  class TileGroupHeader;
-}
-
 namespace logging {
 
-  class PhyLogLogger {
-
-  public:
-    PhyLogLogger(const size_t &logger_id, const std::string &log_dir) :
-      logger_id_(logger_id),
-      log_dir_(log_dir),
-      logger_thread_(nullptr),
-      is_running_(false),
-      logger_output_buffer_(), 
-      persist_epoch_id_(INVALID_EID),
-      worker_map_lock_(), 
-      worker_map_() {}
-
-    ~PhyLogLogger() {}
-
-    void StartRecovery(const size_t checkpoint_eid, const size_t persist_eid, const size_t recovery_thread_count);
-    void StartIndexRebulding(const size_t logger_count);
-
-    void WaitForRecovery();
-    void WaitForIndexRebuilding();
-
-    void StartLogging() {
-      is_running_ = true;
-      logger_thread_.reset(new std::thread(&PhyLogLogger::Run, this));
-    }
-
-    void StopLogging() {
-      is_running_ = false;
-      logger_thread_->join();
-    }
-
-    void RegisterWorker(WorkerContext *phylog_worker_ctx);
-    void DeregisterWorker(WorkerContext *phylog_worker_ctx);
-
-    size_t GetPersistEpochId() const {
-      return persist_epoch_id_;
-    }
-
-
-private:
-  void Run();
-
-  void PersistEpochBegin(FileHandle &file_handle, const size_t epoch_id);
-  void PersistEpochEnd(FileHandle &file_handle, const size_t epoch_id);
-  void PersistLogBuffer(FileHandle &file_handle, std::unique_ptr<LogBuffer> log_buffer);
-
-  std::string GetLogFileFullPath(size_t epoch_id) {
-    return log_dir_ + "/" + logging_filename_prefix_ + "_" + std::to_string(logger_id_) + "_" + std::to_string(epoch_id);
+//===--------------------------------------------------------------------===//
+// Worker Context
+//===--------------------------------------------------------------------===//
+
+/**
+ * The log state of one worker thread. A worker serializes the records of a
+ * transaction into txn_output, and appends them to its current buffer when
+ * the transaction commits. Buffers never mix epochs: a buffer is sealed when
+ * it is full or when the worker commits in a later epoch.
+ */
+struct LogWorkerContext {
+  LogWorkerContext(const size_t worker_id)
+      : worker_id(worker_id),
+        buffer_pool(worker_id),
+        current_eid(MAX_EID),
+        current_cid(INVALID_CID) {}
+
+  size_t worker_id;
+
+  // Buffers are taken by the worker and given back by its logger
+  LogBufferPool buffer_pool;
+
+  // Protects the buffers and the epoch below, shared with the logger
+  common::synchronization::SpinLatch latch;
+
+  // The buffer this worker appends to
+  std::unique_ptr<LogBuffer> current_buffer;
+
+  // Buffers waiting to be flushed
+  std::vector<std::unique_ptr<LogBuffer>> sealed_buffers;
+
+  // The epoch of the transaction being logged, MAX_EID if there is none
+  eid_t current_eid;
+
+  // The records of the transaction being logged, only used by the worker
+  CopySerializeOutput txn_output;
+  cid_t current_cid;
+};
+
+//===--------------------------------------------------------------------===//
+// Logical Logger
+//===--------------------------------------------------------------------===//
+
+/**
+ * A logger flushes the buffers of its workers into the log files of one
+ * directory. Every flush is a round: the logger works out the epoch all of
+ * its workers are done with, and writes out the full buffers. When that
+ * epoch is past the one persisted before, it writes out all other buffers as
+ * well and fsyncs the file, which makes every epoch up to it durable. There is
+ * at most one fsync per round, shared by all transactions of these epochs.
+ *
+ * Log file layout, a sequence of frames:
+ *
+ *  ------------------------------------------------------
+ *  | epoch_id | worker_id | length | payload | ...
+ *  ------------------------------------------------------
+ *
+ * The payloads of the frames of one worker form a stream of records, a
+ * transaction may span several frames of the same worker.
+ */
+class LogicalLogger {
+ public:
+  LogicalLogger(const size_t logger_id, const std::string &log_dir);
+
+  ~LogicalLogger();
+
+  void RegisterWorker(const std::shared_ptr<LogWorkerContext> &worker);
+
+  /**
+   * @brief Write out the buffers of all workers, and sync the log file if an
+   * epoch closed.
+   *
+   * @param current_eid The current global epoch. No worker of this logger
+   * starts logging a transaction in an earlier epoch after this call.
+   *
+   * @return The epoch up to which the log of this logger is durable
+   */
+  eid_t Flush(const eid_t current_eid);
+
+  /**
+   * @brief Close the log file
+   */
+  void Close();
+
+  eid_t GetPersistEpochId() const { return persist_eid_.load(); }
+
+  uint64_t GetBytesFlushed() const { return bytes_flushed_.load(); }
+
+  uint64_t GetSyncCount() const { return sync_count_.load(); }
+
+  std::string GetLogFileFullPath(const eid_t epoch_id) const {
+    return log_dir_ + "/" + logging_filename_prefix_ + "_" +
+           std::to_string(logger_id_) + "_" + std::to_string(epoch_id);
   }
 
-  void GetSortedLogFileIdList(const size_t checkpoint_eid, const size_t persist_eid);
-  
-  void RunRecoveryThread(const size_t thread_id, const size_t checkpoint_eid, const size_t persist_eid);
-
-  void RunSecIndexRebuildThread(const size_t logger_count);
-
-  void RebuildSecIndexForTable(const size_t logger_count, storage::DataTable *table);
-
-  bool ReplayLogFile(const size_t thread_id, FileHandle &file_handle, size_t checkpoint_eid, size_t pepoch_eid);
-  bool InstallTupleRecord(LogRecordType type, storage::Tuple *tuple, storage::DataTable *table, cid_t cur_cid);
-
-  // Return value is the swapped txn id, either INVALID_TXNID or INITIAL_TXNID
-  txn_id_t LockTuple(storage::TileGroupHeader *tg_header, oid_t tuple_offset);
-  void UnlockTuple(storage::TileGroupHeader *tg_header, oid_t tuple_offset, txn_id_t new_txn_id);
-
-  private:
-    size_t logger_id_;
-    std::string log_dir_;
+ private:
+  // Write out the buffers and give them back to the worker
+  void WriteBuffers(LogWorkerContext &worker,
+                    std::vector<std::unique_ptr<LogBuffer>> &buffers);
 
-    // recovery threads
-    std::vector<std::unique_ptr<std::thread>> recovery_threads_;
-    std::vector<size_t> file_eids_;
-    std::atomic<int> max_replay_file_id_;
+  // Append one buffer to the log file as a frame
+  size_t WriteBuffer(LogBuffer &buffer);
 
-    /* Recovery */
-    // TODO: Check if we can discard the recovery pool after the recovery is done.
-    // Since every thing is copied to the tile group and tile group related pool
-    std::vector<std::unique_ptr<VarlenPool>> recovery_pools_;
-    
-    // logger thread
-    std::unique_ptr<std::thread> logger_thread_;
-    volatile bool is_running_;
+  // Start a new log file beginning at the given epoch
+  bool OpenLogFile(const eid_t epoch_id);
 
-    /* File system related */
-    CopySerializeOutput logger_output_buffer_;
+  // Flush the file to disk
+  void Sync();
 
-    /* Log buffers */
-    size_t persist_epoch_id_;
+ private:
+  size_t logger_id_;
+  std::string log_dir_;
 
-    // The spin lock to protect the worker map.
-    // We only update this map when creating/terminating a new worker
-    common::synchronization::SpinLatch worker_map_lock_;
+  // The workers of this logger
+  common::synchronization::SpinLatch worker_lock_;
+  std::vector<std::shared_ptr<LogWorkerContext>> workers_;
 
-    // map from worker id to the worker's context.
-    std::unordered_map<oid_t, std::shared_ptr<WorkerContext>> worker_map_;
-  
-    const std::string logging_filename_prefix_ = "log";
+  FileHandle file_handle_;
+  size_t unsynced_bytes_;
+  bool failed_;
 
-    const size_t sleep_period_us_ = 40000;
+  std::atomic<eid_t> persist_eid_;
+  std::atomic<uint64_t> bytes_flushed_;
+  std::atomic<uint64_t> sync_count_;
 
-    const int new_file_interval_ = 500; // 500 milliseconds.
-  };
+  const std::string logging_filename_prefix_ = "log";
 
+  // Start a new file once the current one grows past this size
+  const size_t max_log_file_size_ = 64 * 1024 * 1024;
+};
 
-}
-}
\ No newline at end of file
+}  // namespace logging
+}  // namespace peloton
@@ -29,9 +29,16 @@
 // Packet content macros
 #define NULL_CONTENT_SIZE (-1)
 
+// Bytes of DataRow messages that are packed into one response packet
+#define DATA_ROW_BATCH_SIZE (8 * SOCKET_BUFFER_SIZE)
+
+// Bytes of CSV data that COPY ... FROM STDIN buffers before loading them
+#define COPY_CHUNK_SIZE (16 * 1024 * 1024)
+
 namespace peloton {
 
 namespace parser {
+class CopyStatement;
 class ExplainStatement;
 }  // namespace parser
 
@@ -140,7 +147,8 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // Sends the attribute headers required by SELECT queries
   void PutTupleDescriptor(const std::vector<FieldInfo> &tuple_descriptor);
 
-  // Send each row, one packet at a time, used by SELECT queries
+  // Send the rows in DataRow messages, many rows per packet, used by SELECT
+  // queries. The values are already encoded in their result format.
   void SendDataRows(std::vector<ResultValue> &results, int colcount);
 
   // Used to send a packet that indicates the completion of a query. Also has
@@ -188,6 +196,39 @@ class PostgresProtocolHandler : public ProtocolHandler {
 
   void ExecQueryMessageGetResult(ResultType status);
 
+  /* Start a COPY ... FROM STDIN or COPY ... TO STDOUT */
+  ProcessResult ExecCopyMessage(parser::CopyStatement &copy_stmt,
+                                const size_t thread_id);
+
+  /* Process a COPY_DATA message of a COPY ... FROM STDIN */
+  ProcessResult ExecCopyDataMessage(InputPacket *pkt, const size_t thread_id);
+
+  /* Process the COPY_DONE message that ends a COPY ... FROM STDIN */
+  ProcessResult ExecCopyDoneMessage(const size_t thread_id);
+
+  /* Process the COPY_FAIL message that aborts a COPY ... FROM STDIN */
+  void ExecCopyFailMessage(InputPacket *pkt);
+
+  // Load the first len bytes of buffered COPY data, which end on a row
+  ProcessResult LoadCopyChunk(size_t len, const size_t thread_id);
+
+  // Return where the last complete row of buffered COPY data ends, or 0
+  size_t FindCopyRowEnd();
+
+  // Commit a COPY ... FROM STDIN, or just end it if it failed
+  void CompleteCopyIn();
+
+  // Sends the CopyInResponse or CopyOutResponse that starts a COPY
+  void SendCopyResponse(NetworkMessageType type);
+
+  // Send the rows of a COPY ... TO STDOUT as CSV in CopyData messages, many
+  // rows per packet
+  void SendCopyData(std::vector<ResultValue> &results, int colcount);
+
+  void ExecCopyInGetResult(ResultType status);
+
+  void ExecCopyOutGetResult(ResultType status);
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -202,6 +243,32 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // global txn state
   NetworkTransactionStateType txn_state_;
 
+  // COPY ... FROM STDIN / TO STDOUT running on this connection
+  enum class CopyState { NONE, COPY_IN, COPY_IN_FAILED, COPY_OUT };
+  CopyState copy_state_ = CopyState::NONE;
+
+  // The number of columns and CSV format of the running COPY
+  int copy_num_cols_ = 0;
+  char copy_delimiter_ = ',';
+  char copy_quote_ = '"';
+  char copy_escape_ = '"';
+
+  // CopyData received but not loaded yet, and the rows being loaded now
+  std::string copy_buffer_;
+  std::string copy_chunk_;
+
+  // How far copy_buffer_ was scanned for row ends, whether that position is
+  // inside a quoted value, and the end of the last complete row found
+  size_t copy_scan_pos_ = 0;
+  bool copy_in_quote_ = false;
+  size_t copy_row_end_ = 0;
+
+  // Set once the client sent COPY_DONE
+  bool copy_done_ = false;
+
+  // Rows loaded by COPY ... FROM STDIN so far
+  size_t copy_rows_ = 0;
+
   // state to manage skipped queries
   bool skipped_stmt_ = false;
   std::string skipped_query_string_;
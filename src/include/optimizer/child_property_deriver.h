@@ -47,10 +47,14 @@ class ChildPropertyDeriver : public OperatorVisitor {
   void Visit(const PhysicalLeftNLJoin *) override;
   void Visit(const PhysicalRightNLJoin *) override;
   void Visit(const PhysicalOuterNLJoin *) override;
+  void Visit(const PhysicalSemiNLJoin *) override;
+  void Visit(const PhysicalAntiNLJoin *) override;
   void Visit(const PhysicalInnerHashJoin *) override;
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalSemiHashJoin *) override;
+  void Visit(const PhysicalAntiHashJoin *) override;
   void Visit(const PhysicalInsert *) override;
   void Visit(const PhysicalInsertSelect *) override;
   void Visit(const PhysicalDelete *) override;
@@ -63,6 +67,7 @@ class ChildPropertyDeriver : public OperatorVisitor {
 
  private:
   void DeriveForJoin();
+  void DeriveForSemiOrAntiJoin();
   std::shared_ptr<PropertySet> requirements_;
   /**
    * @brief The derived output property set and input property sets, note that a
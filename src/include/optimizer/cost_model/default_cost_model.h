@@ -89,6 +89,12 @@ class DefaultCostModel : public AbstractCostModel {
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftNLJoin *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightNLJoin *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterNLJoin *op) {}
+  void Visit(UNUSED_ATTRIBUTE const PhysicalSemiNLJoin *op) {
+    output_cost_ = NLJoinCost();
+  }
+  void Visit(UNUSED_ATTRIBUTE const PhysicalAntiNLJoin *op) {
+    output_cost_ = NLJoinCost();
+  }
   void Visit(UNUSED_ATTRIBUTE const PhysicalInnerHashJoin *op) {
     auto left_child_rows =
         memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
@@ -100,6 +106,12 @@ class DefaultCostModel : public AbstractCostModel {
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) {}
+  void Visit(UNUSED_ATTRIBUTE const PhysicalSemiHashJoin *op) {
+    output_cost_ = SemiOrAntiJoinCost();
+  }
+  void Visit(UNUSED_ATTRIBUTE const PhysicalAntiHashJoin *op) {
+    output_cost_ = SemiOrAntiJoinCost();
+  }
   void Visit(UNUSED_ATTRIBUTE const PhysicalInsert *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalInsertSelect *op) {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) {}
@@ -126,6 +138,23 @@ class DefaultCostModel : public AbstractCostModel {
 
  private:
 
+  double NLJoinCost() {
+    auto left_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+    auto right_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
+    return left_child_rows * right_child_rows * DEFAULT_TUPLE_COST;
+  }
+
+  double SemiOrAntiJoinCost() {
+    // Both sides are read once, the build side a second time after the probe
+    auto left_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+    auto right_child_rows =
+        memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
+    return (2 * left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST;
+  }
+
   double HashCost() {
     auto child_num_rows =
         memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
@@ -104,6 +104,12 @@ class PostgresCostModel : public AbstractCostModel {
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftNLJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightNLJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterNLJoin *op) override {}
+  void Visit(UNUSED_ATTRIBUTE const PhysicalSemiNLJoin *op) override {
+    output_cost_ = NLJoinCost();
+  }
+  void Visit(UNUSED_ATTRIBUTE const PhysicalAntiNLJoin *op) override {
+    output_cost_ = NLJoinCost();
+  }
 
   /* The main idea of this cost estimate is that the comparisons done is the outer
  * table (probe side) times tuples
@@ -178,6 +184,12 @@ class PostgresCostModel : public AbstractCostModel {
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) override {}
+  void Visit(UNUSED_ATTRIBUTE const PhysicalSemiHashJoin *op) override {
+    output_cost_ = SemiOrAntiJoinCost();
+  }
+  void Visit(UNUSED_ATTRIBUTE const PhysicalAntiHashJoin *op) override {
+    output_cost_ = SemiOrAntiJoinCost();
+  }
   void Visit(UNUSED_ATTRIBUTE const PhysicalInsert *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalInsertSelect *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) override{}
@@ -204,6 +216,23 @@ class PostgresCostModel : public AbstractCostModel {
   }
 
  private:
+  double NLJoinCost() {
+    auto left_child_rows = std::max(
+        0, memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows());
+    auto right_child_rows = std::max(
+        0, memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows());
+    return left_child_rows * right_child_rows * DEFAULT_TUPLE_COST;
+  }
+
+  double SemiOrAntiJoinCost() {
+    // Both sides are read once, the build side a second time after the probe
+    auto left_child_rows = std::max(
+        0, memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows());
+    auto right_child_rows = std::max(
+        0, memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows());
+    return (2 * left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST;
+  }
+
   double HashCost() {
     auto child_num_rows =
         memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
@@ -83,6 +83,14 @@ class TrivialCostModel : public AbstractCostModel {
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightNLJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterNLJoin *op) override {}
 
+  void Visit(UNUSED_ATTRIBUTE const PhysicalSemiNLJoin *op) override {
+    output_cost_ = 2.f;
+  }
+
+  void Visit(UNUSED_ATTRIBUTE const PhysicalAntiNLJoin *op) override {
+    output_cost_ = 2.f;
+  }
+
   void Visit(UNUSED_ATTRIBUTE const PhysicalInnerHashJoin *op) override {
     output_cost_ = 1.f;
   }
@@ -90,6 +98,14 @@ class TrivialCostModel : public AbstractCostModel {
   void Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) override {}
+
+  void Visit(UNUSED_ATTRIBUTE const PhysicalSemiHashJoin *op) override {
+    output_cost_ = 1.f;
+  }
+
+  void Visit(UNUSED_ATTRIBUTE const PhysicalAntiHashJoin *op) override {
+    output_cost_ = 1.f;
+  }
   void Visit(UNUSED_ATTRIBUTE const PhysicalInsert *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalInsertSelect *op) override {}
   void Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) override{}
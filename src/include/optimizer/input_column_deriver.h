@@ -69,6 +69,10 @@ class InputColumnDeriver : public OperatorVisitor {
 
   void Visit(const PhysicalOuterNLJoin *) override;
 
+  void Visit(const PhysicalSemiNLJoin *) override;
+
+  void Visit(const PhysicalAntiNLJoin *) override;
+
   void Visit(const PhysicalInnerHashJoin *) override;
 
   void Visit(const PhysicalLeftHashJoin *) override;
@@ -77,6 +81,10 @@ class InputColumnDeriver : public OperatorVisitor {
 
   void Visit(const PhysicalOuterHashJoin *) override;
 
+  void Visit(const PhysicalSemiHashJoin *) override;
+
+  void Visit(const PhysicalAntiHashJoin *) override;
+
   void Visit(const PhysicalInsert *) override;
 
   void Visit(const PhysicalInsertSelect *) override;
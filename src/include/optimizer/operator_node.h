@@ -39,6 +39,7 @@ enum class OpType {
   RightJoin,
   OuterJoin,
   SemiJoin,
+  AntiJoin,
   LogicalAggregateAndGroupBy,
   LogicalInsert,
   LogicalInsertSelect,
@@ -62,10 +63,14 @@ enum class OpType {
   LeftNLJoin,
   RightNLJoin,
   OuterNLJoin,
+  SemiNLJoin,
+  AntiNLJoin,
   InnerHashJoin,
   LeftHashJoin,
   RightHashJoin,
   OuterHashJoin,
+  SemiHashJoin,
+  AntiHashJoin,
   Insert,
   InsertSelect,
   Delete,
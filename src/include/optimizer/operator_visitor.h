@@ -37,10 +37,14 @@ class OperatorVisitor {
   virtual void Visit(const PhysicalLeftNLJoin *) {}
   virtual void Visit(const PhysicalRightNLJoin *) {}
   virtual void Visit(const PhysicalOuterNLJoin *) {}
+  virtual void Visit(const PhysicalSemiNLJoin *) {}
+  virtual void Visit(const PhysicalAntiNLJoin *) {}
   virtual void Visit(const PhysicalInnerHashJoin *) {}
   virtual void Visit(const PhysicalLeftHashJoin *) {}
   virtual void Visit(const PhysicalRightHashJoin *) {}
   virtual void Visit(const PhysicalOuterHashJoin *) {}
+  virtual void Visit(const PhysicalSemiHashJoin *) {}
+  virtual void Visit(const PhysicalAntiHashJoin *) {}
   virtual void Visit(const PhysicalInsert *) {}
   virtual void Visit(const PhysicalInsertSelect *) {}
   virtual void Visit(const PhysicalDelete *) {}
@@ -66,6 +70,7 @@ class OperatorVisitor {
   virtual void Visit(const LogicalRightJoin *) {}
   virtual void Visit(const LogicalOuterJoin *) {}
   virtual void Visit(const LogicalSemiJoin *) {}
+  virtual void Visit(const LogicalAntiJoin *) {}
   virtual void Visit(const LogicalAggregateAndGroupBy *) {}
   virtual void Visit(const LogicalInsert *) {}
   virtual void Visit(const LogicalInsertSelect *) {}
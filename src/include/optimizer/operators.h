@@ -234,9 +234,35 @@ class LogicalOuterJoin : public OperatorNode<LogicalOuterJoin> {
 //===--------------------------------------------------------------------===//
 class LogicalSemiJoin : public OperatorNode<LogicalSemiJoin> {
  public:
-  static Operator make(expression::AbstractExpression *condition = nullptr);
+  static Operator make();
 
-  std::shared_ptr<expression::AbstractExpression> join_predicate;
+  static Operator make(std::vector<AnnotatedExpression> &conditions);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  std::vector<AnnotatedExpression> join_predicates;
+};
+
+//===--------------------------------------------------------------------===//
+// AntiJoin
+//===--------------------------------------------------------------------===//
+class LogicalAntiJoin : public OperatorNode<LogicalAntiJoin> {
+ public:
+  static Operator make(bool null_aware);
+
+  static Operator make(std::vector<AnnotatedExpression> &conditions,
+                       bool null_aware);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  std::vector<AnnotatedExpression> join_predicates;
+
+  // Does the join have the NULL semantics of NOT IN?
+  bool null_aware;
 };
 
 //===--------------------------------------------------------------------===//
@@ -543,6 +569,46 @@ class PhysicalOuterNLJoin : public OperatorNode<PhysicalOuterNLJoin> {
       std::shared_ptr<expression::AbstractExpression> join_predicate);
 };
 
+//===--------------------------------------------------------------------===//
+// SemiNLJoin
+//===--------------------------------------------------------------------===//
+class PhysicalSemiNLJoin : public OperatorNode<PhysicalSemiNLJoin> {
+ public:
+  static Operator make(
+      std::vector<AnnotatedExpression> conditions,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  std::vector<AnnotatedExpression> join_predicates;
+};
+
+//===--------------------------------------------------------------------===//
+// AntiNLJoin
+//===--------------------------------------------------------------------===//
+class PhysicalAntiNLJoin : public OperatorNode<PhysicalAntiNLJoin> {
+ public:
+  static Operator make(
+      std::vector<AnnotatedExpression> conditions,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  std::vector<AnnotatedExpression> join_predicates;
+};
+
 //===--------------------------------------------------------------------===//
 // InnerHashJoin
 //===--------------------------------------------------------------------===//
@@ -593,6 +659,50 @@ class PhysicalOuterHashJoin : public OperatorNode<PhysicalOuterHashJoin> {
       std::shared_ptr<expression::AbstractExpression> join_predicate);
 };
 
+//===--------------------------------------------------------------------===//
+// SemiHashJoin
+//===--------------------------------------------------------------------===//
+class PhysicalSemiHashJoin : public OperatorNode<PhysicalSemiHashJoin> {
+ public:
+  static Operator make(
+      std::vector<AnnotatedExpression> conditions,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  std::vector<AnnotatedExpression> join_predicates;
+};
+
+//===--------------------------------------------------------------------===//
+// AntiHashJoin
+//===--------------------------------------------------------------------===//
+class PhysicalAntiHashJoin : public OperatorNode<PhysicalAntiHashJoin> {
+ public:
+  static Operator make(
+      std::vector<AnnotatedExpression> conditions,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys,
+      bool null_aware);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  std::vector<AnnotatedExpression> join_predicates;
+
+  // Does the join have the NULL semantics of NOT IN?
+  bool null_aware;
+};
+
 //===--------------------------------------------------------------------===//
 // PhysicalInsert
 //===--------------------------------------------------------------------===//
@@ -71,6 +71,10 @@ class PlanGenerator : public OperatorVisitor {
 
   void Visit(const PhysicalOuterNLJoin *) override;
 
+  void Visit(const PhysicalSemiNLJoin *) override;
+
+  void Visit(const PhysicalAntiNLJoin *) override;
+
   void Visit(const PhysicalInnerHashJoin *) override;
 
   void Visit(const PhysicalLeftHashJoin *) override;
@@ -79,6 +83,10 @@ class PlanGenerator : public OperatorVisitor {
 
   void Visit(const PhysicalOuterHashJoin *) override;
 
+  void Visit(const PhysicalSemiHashJoin *) override;
+
+  void Visit(const PhysicalAntiHashJoin *) override;
+
   void Visit(const PhysicalInsert *) override;
 
   void Visit(const PhysicalInsertSelect *) override;
@@ -150,6 +158,41 @@ class PlanGenerator : public OperatorVisitor {
    *  the output plan produciing output columns is generated
    */
   void BuildProjectionPlan();
+
+  /**
+   * @brief Generate a nested-loop join plan from the children plans, looping
+   *  over the right child for the tuples of the left child
+   *
+   * @param join_type The type of the join
+   * @param join_predicates The join predicates
+   * @param left_keys The join keys of the left child
+   * @param right_keys The join keys of the right child
+   */
+  void BuildNestedLoopJoinPlan(
+      JoinType join_type,
+      const std::vector<AnnotatedExpression> &join_predicates,
+      const std::vector<std::unique_ptr<expression::AbstractExpression>>
+          &left_keys,
+      const std::vector<std::unique_ptr<expression::AbstractExpression>>
+          &right_keys);
+
+  /**
+   * @brief Generate a hash join plan from the children plans, building the
+   *  hash table on the left child and probing it with the right child
+   *
+   * @param join_type The type of the join
+   * @param null_aware If the join is a NULL-aware anti join (i.e., NOT IN)
+   * @param join_predicates The join predicates
+   * @param left_keys The hash keys of the left child
+   * @param right_keys The hash keys of the right child
+   */
+  void BuildHashJoinPlan(
+      JoinType join_type, bool null_aware,
+      const std::vector<AnnotatedExpression> &join_predicates,
+      const std::vector<std::unique_ptr<expression::AbstractExpression>>
+          &left_keys,
+      const std::vector<std::unique_ptr<expression::AbstractExpression>>
+          &right_keys);
   void BuildAggregatePlan(
       AggregateType aggr_type,
       const std::vector<std::shared_ptr<expression::AbstractExpression>>
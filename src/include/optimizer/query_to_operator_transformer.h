@@ -98,6 +98,19 @@ class QueryToOperatorTransformer : public SqlNodeVisitor {
   bool GenerateSubquerytree(expression::AbstractExpression *expr,
                             oid_t child_id, bool single_join = false);
 
+  /**
+   * @brief Transform a conjunctive predicate of the form (a IN sub-query),
+   *  (EXISTS sub-query), or their negations, into a semi or anti join between
+   *  the current output and the sub-query. IN becomes an equality predicate of
+   *  the join.
+   *
+   * @param expr The conjunctive predicate
+   *
+   * @return If the predicate was transformed into a join, return true, return
+   *  false otherwise
+   */
+  bool GenerateSemiOrAntiJoin(expression::AbstractExpression *expr);
+
   /**
    * @brief Decide if a conjunctive predicate is supported. We need to extract
    * conjunction predicate first then call this function to decide if the
@@ -251,6 +251,66 @@ class InnerJoinToInnerHashJoin : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief (Logical Semi Join -> Semi Hash Join)
+ */
+class SemiJoinToSemiHashJoin : public Rule {
+ public:
+  SemiJoinToSemiHashJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
+/**
+ * @brief (Logical Anti Join -> Anti Hash Join)
+ */
+class AntiJoinToAntiHashJoin : public Rule {
+ public:
+  AntiJoinToAntiHashJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
+/**
+ * @brief (Logical Semi Join -> Semi Nested-Loop Join)
+ */
+class SemiJoinToSemiNLJoin : public Rule {
+ public:
+  SemiJoinToSemiNLJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
+/**
+ * @brief (Logical Anti Join -> Anti Nested-Loop Join)
+ */
+class AntiJoinToAntiNLJoin : public Rule {
+ public:
+  AntiJoinToAntiNLJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
 /**
  * @brief (Logical Distinct -> Physical Distinct)
  */
@@ -318,6 +378,38 @@ class PushFilterThroughJoin : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief perform predicate push-down to push a filter through a semi join. The
+ *  semi join only produces rows from its left child, so predicates on the left
+ *  child are evaluated below the join
+ */
+class PushFilterThroughSemiJoin : public Rule {
+ public:
+  PushFilterThroughSemiJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
+/**
+ * @brief perform predicate push-down to push a filter through an anti join
+ */
+class PushFilterThroughAntiJoin : public Rule {
+ public:
+  PushFilterThroughAntiJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
 /**
  * @brief Combine multiple filters into one single filter using conjunction
  */
@@ -372,9 +464,9 @@ class EmbedFilterIntoGet : public Rule {
 // then turn mark-join into a regular join operator
 enum class UnnestPromise { Low = 1, High };
 // TODO(boweic): MarkJoin and SingleJoin should not be transformed into inner
-// join. Sometimes MarkJoin could be transformed into semi-join, but for now we
-// do not have these operators in the llvm cogen engine. Once we have those, we
-// should not use the following rules in the rewrite phase
+// join. IN and EXISTS sub-queries are already turned into semi and anti joins,
+// which are only transformed into inner joins when they can't be implemented
+// with a hash join
 ///////////////////////////////////////////////////////////////////////////////
 /// MarkJoinGetToInnerJoin
 class MarkJoinToInnerJoin : public Rule {
@@ -441,5 +533,39 @@ class PullFilterThroughAggregation : public Rule {
                  std::vector<std::shared_ptr<OperatorExpression>> &transformed,
                  OptimizeContext *context) const override;
 };
+
+///////////////////////////////////////////////////////////////////////////////
+/// PullFilterThroughSemiJoin
+class PullFilterThroughSemiJoin : public Rule {
+ public:
+  PullFilterThroughSemiJoin();
+
+  int Promise(GroupExpression *group_expr,
+              OptimizeContext *context) const override;
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// PullFilterThroughAntiJoin
+class PullFilterThroughAntiJoin : public Rule {
+ public:
+  PullFilterThroughAntiJoin();
+
+  int Promise(GroupExpression *group_expr,
+              OptimizeContext *context) const override;
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
 }  // namespace optimizer
 }  // namespace peloton
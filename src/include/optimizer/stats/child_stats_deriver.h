@@ -37,11 +37,15 @@ class ChildStatsDeriver : public OperatorVisitor {
   void Visit(const LogicalRightJoin *) override;
   void Visit(const LogicalOuterJoin *) override;
   void Visit(const LogicalSemiJoin *) override;
+  void Visit(const LogicalAntiJoin *) override;
   void Visit(const LogicalAggregateAndGroupBy *) override;
 
  private:
   void PassDownRequiredCols();
   void PassDownColumn(expression::AbstractExpression* col);
+  // Pass down the required columns and all columns the join predicates use
+  void PassDownJoinColumns(
+      const std::vector<AnnotatedExpression> &join_predicates);
   ExprSet required_cols_;
   GroupExpression *gexpr_;
   Memo *memo_;
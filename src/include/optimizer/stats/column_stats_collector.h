@@ -46,13 +46,20 @@ class ColumnStatsCollector {
 
   void AddValue(const type::Value& value);
 
-  double GetFracNull();
+  // Merge the stats of another part of the same column
+  void Merge(const ColumnStatsCollector& other);
 
-  inline std::vector<ValueFrequencyPair> GetCommonValueAndFrequency() {
-    return topk_.GetAllOrderedMaxFirst();
+  // The values added are a sample of the column, which has about
+  // scale_factor times as many values
+  inline void SetScaleFactor(double scale_factor) {
+    scale_factor_ = scale_factor;
   }
 
-  inline uint64_t GetCardinality() { return hll_.EstimateCardinality(); }
+  double GetFracNull();
+
+  std::vector<ValueFrequencyPair> GetCommonValueAndFrequency();
+
+  uint64_t GetCardinality();
 
   inline double GetCardinalityError() { return hll_.RelativeError(); }
 
@@ -79,6 +86,7 @@ class ColumnStatsCollector {
 
   size_t null_count_ = 0;
   size_t total_count_ = 0;
+  double scale_factor_ = 1;
 
   ColumnStatsCollector(const ColumnStatsCollector&);
   void operator=(const ColumnStatsCollector&);
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "common/logger.h"
+#include "common/macros.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace peloton {
@@ -120,6 +121,19 @@ class CountMinSketch {
     }
   }
 
+  // Add the counts of a sketch with the same dimensions, e.g., of another
+  // part of the same column. The number of distinct items is not additive,
+  // the larger one of the two is kept as a lower bound.
+  void Merge(const CountMinSketch& other) {
+    PELOTON_ASSERT(depth == other.depth && width == other.width);
+    for (int i = 0; i < depth; i++) {
+      for (int j = 0; j < width; j++) {
+        table[i][j] += other.table[i][j];
+      }
+    }
+    size = std::max(size, other.size);
+  }
+
   uint64_t EstimateItemCount(int64_t item) {
     uint64_t count = UINT64_MAX;
     std::vector<int> bins = getHashBins(item);
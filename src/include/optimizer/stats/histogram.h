@@ -89,6 +89,23 @@ class Histogram {
     }
   }
 
+  /*
+   * Input: a histogram h with the same number of bins
+   *
+   * Update the histogram that represents the set S U S', where S' is the set
+   * represented by h (Algorithm 2). Keep bin number unchanged.
+   */
+  void Merge(const Histogram &other) {
+    for (const Bin &bin : other.bins) {
+      InsertBin(bin);
+      if (bins.size() > max_bins_) {
+        MergeTwoBinsWithMinGap();
+      }
+    }
+    minimum_ = std::min(minimum_, other.minimum_);
+    maximum_ = std::max(maximum_, other.maximum_);
+  }
+
   /*
    * Input: a point b such that p1 < b < pB
    *
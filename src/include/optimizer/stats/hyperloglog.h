@@ -41,6 +41,13 @@ class HyperLogLog {
     hll_->Update(StatsUtil::HashValue(value));
   }
 
+  // Merge the registers of another HLL with the same precision, which then
+  // estimates the cardinality of the union of both inputs
+  void Merge(const HyperLogLog& other) {
+    PELOTON_ASSERT(precision_ == other.precision_);
+    hll_->Merge(other.hll_);
+  }
+
   uint64_t EstimateCardinality() {
     uint64_t cardinality = hll_->Estimate();
     LOG_TRACE("Estimated cardinality: %" PRId64, cardinality);
@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_cache.h
+//
+// Identification: src/include/optimizer/stats/stats_cache.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "common/synchronization/readwrite_latch.h"
+
+namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}
+
+namespace optimizer {
+
+class ColumnStats;
+
+// The stats of the columns of a table by column id
+using ColumnStatsMap = std::map<oid_t, std::shared_ptr<ColumnStats>>;
+
+//===--------------------------------------------------------------------===//
+// StatsCache
+//===--------------------------------------------------------------------===//
+// Keeps the column stats of the tables deserialized in memory, so that the
+// optimizer doesn't read them from the catalog on every planning pass. The
+// cached stats are shared by all readers and must be copied before they are
+// modified.
+//
+// The stats of a table are dropped when a transaction starts rewriting them,
+// and nothing is cached for the table until that transaction ends. Every
+// rewrite bumps the version of the table's stats. Stats read from the catalog
+// are only cached if the version didn't change since the lookup, and the
+// snapshot they were read in includes the last rewrite, so that a reader
+// doesn't cache stats that were outdated by a concurrent ANALYZE.
+class StatsCache {
+ public:
+  // Global Singleton
+  static StatsCache *GetInstance();
+
+  // Get the cached stats of a table, nullptr if they are not cached. On a
+  // miss, the version of the stats is returned to install them with.
+  std::shared_ptr<const ColumnStatsMap> Find(oid_t table_id,
+                                             uint64_t &version);
+
+  // Cache the stats of a table read from the catalog by the transaction,
+  // unless they were rewritten since the lookup
+  void Install(oid_t table_id, uint64_t version,
+               concurrency::TransactionContext *txn,
+               std::shared_ptr<const ColumnStatsMap> column_stats);
+
+  // Drop the stats of a table, as the transaction is about to rewrite them
+  void BeginUpdate(oid_t table_id, concurrency::TransactionContext *txn);
+
+  // Drop the stats of a table, e.g., when it is dropped
+  void Invalidate(oid_t table_id);
+
+  // Drop the stats of all tables
+  void Clear();
+
+  // Get the number of tables whose stats are cached
+  size_t GetCount() const;
+
+  // Get the number of lookups that found the stats of the table
+  uint64_t GetHitCount() const { return hit_count_; }
+
+  // Get the number of lookups that didn't find the stats of the table
+  uint64_t GetMissCount() const { return miss_count_; }
+
+ private:
+  struct Entry {
+    std::shared_ptr<const ColumnStatsMap> column_stats;
+
+    // Bumped whenever the stats are dropped
+    uint64_t version = 0;
+
+    // The number of transactions currently rewriting the stats
+    size_t writer_count = 0;
+
+    // The commit id of the last transaction that rewrote the stats
+    cid_t update_cid = 0;
+  };
+
+  StatsCache() {}
+
+  DISALLOW_COPY_AND_MOVE(StatsCache);
+
+  void EndUpdate(oid_t table_id, cid_t commit_id);
+
+ private:
+  common::synchronization::ReadWriteLatch latch_;
+
+  std::unordered_map<oid_t, Entry> entries_;
+
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -17,6 +17,7 @@
 namespace peloton {
 namespace optimizer {
 
+class Group;
 class Memo;
 class TableStats;
 
@@ -36,11 +37,33 @@ class StatsCalculator : public OperatorVisitor {
   void Visit(const LogicalRightJoin *) override;
   void Visit(const LogicalOuterJoin *) override;
   void Visit(const LogicalSemiJoin *) override;
+  void Visit(const LogicalAntiJoin *) override;
   void Visit(const LogicalAggregateAndGroupBy *) override;
   void Visit(const LogicalLimit *) override;
   void Visit(const LogicalDistinct *) override;
 
  private:
+  /**
+   * @brief Semi and anti joins produce at most one row for every row of their
+   * left child. We estimate the fraction of left rows that have a match, and
+   * an anti join produces the remaining rows.
+   *
+   * @param join_predicates The predicates of the join
+   * @param anti Whether this is an anti join
+   */
+  void CalculateStatsForSemiOrAntiJoin(
+      const std::vector<AnnotatedExpression> &join_predicates, bool anti);
+  /**
+   * @brief Return the estimated fraction of the rows of the left child of a
+   * semi join that satisfy a join predicate for at least one right row
+   *
+   * @param left_child_group The group of the left child
+   * @param right_child_group The group of the right child
+   * @param expr The join predicate
+   */
+  double CalculateSelectivityForSemiJoinPredicate(
+      Group *left_child_group, Group *right_child_group,
+      const expression::AbstractExpression *expr);
   /**
    * @brief Add the base table stats if the base table maintain stats, or else
    * use default stats
@@ -14,8 +14,14 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 #include "optimizer/stats/column_stats_collector.h"
+#include "optimizer/stats/stats_cache.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #include "common/macros.h"
 #include "common/internal_types.h"
@@ -81,9 +87,57 @@ class StatsStorage {
   ResultType AnalayzeStatsForColumns(storage::DataTable *table,
                                      std::vector<std::string> column_names);
 
+  /* Functions for keeping the stats up to date */
+
+  bool IsStale(storage::DataTable *table);
+
+  size_t AnalyzeStaleTables();
+
+  void StartAutoAnalyze();
+
+  void StopAutoAnalyze();
+
  private:
+  // The modifications of a table when its stats were last collected
+  struct AnalyzeState {
+    size_t modification_count;
+    size_t row_count;
+  };
+
+  // How often the auto analyzer looks for stale tables
+  static constexpr int kAutoAnalyzeIntervalMs = 10 * 1000;
+
+  // The stats of a table are stale once the modifications since they were
+  // collected exceed the threshold plus the scale factor times the row count
+  static constexpr size_t kAutoAnalyzeThreshold = 1000;
+  static constexpr double kAutoAnalyzeScaleFactor = 0.1;
+
+  // The tile groups sampled by the auto analyzer if no sample size is set
+  static constexpr size_t kAutoAnalyzeSampleTileGroups = 64;
+
   std::unique_ptr<type::AbstractPool> pool_;
 
+  std::mutex analyze_state_mutex_;
+
+  std::unordered_map<oid_t, AnalyzeState> analyze_states_;
+
+  std::atomic<bool> auto_analyze_running_;
+
+  std::mutex auto_analyze_mutex_;
+
+  std::condition_variable auto_analyze_cv_;
+
+  std::thread auto_analyze_thread_;
+
+  ResultType AnalyzeTable(storage::DataTable *table,
+                          size_t sample_tile_group_count,
+                          concurrency::TransactionContext *txn);
+
+  void RunAutoAnalyze();
+
+  std::shared_ptr<const ColumnStatsMap> GetColumnStatsMap(
+      oid_t database_id, oid_t table_id, concurrency::TransactionContext *txn);
+
   std::shared_ptr<ColumnStats> ConvertVectorToColumnStats(
       oid_t database_id, oid_t table_id, oid_t column_id,
       std::unique_ptr<std::vector<type::Value>> &column_stats_vector);
@@ -24,14 +24,23 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 // TableStatsCollector
 //===--------------------------------------------------------------------===//
+// Collects the stats of all the columns of a table. The tile groups are split
+// into ranges that are scanned in parallel, each into its own stats, which
+// are merged in the end.
+//
+// If a sample size is given, only a random sample of that many tile groups is
+// scanned (block sampling), and the stats are scaled up to the entire table.
 class TableStatsCollector {
  public:
-  TableStatsCollector(storage::DataTable* table);
+  TableStatsCollector(storage::DataTable* table,
+                      size_t sample_tile_group_count = 0);
 
   ~TableStatsCollector();
 
   void CollectColumnStats();
 
+  inline bool IsSampled() { return sampled_; }
+
   inline size_t GetActiveTupleCount() { return active_tuple_count_; }
 
   inline size_t GetColumnCount() { return column_count_; }
@@ -44,11 +53,20 @@ class TableStatsCollector {
   std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors_;
   size_t active_tuple_count_;
   size_t column_count_;
+  size_t sample_tile_group_count_;
+  bool sampled_;
 
   TableStatsCollector(const TableStatsCollector&);
   void operator=(const TableStatsCollector&);
 
-  void InitColumnStatsCollectors();
+  void InitColumnStatsCollectors(
+      std::vector<std::unique_ptr<ColumnStatsCollector>>& collectors);
+
+  // Collect the stats of the tile groups at the offsets in [begin, end),
+  // returning the number of active tuples in them
+  size_t CollectTileGroups(
+      const std::vector<size_t>& tile_group_offsets, size_t begin, size_t end,
+      std::vector<std::unique_ptr<ColumnStatsCollector>>& collectors) const;
 };
 
 }  // namespace optimizer
@@ -9,6 +9,7 @@
 #include "common/logger.h"
 #include "count_min_sketch.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <cinttypes>
@@ -569,6 +570,34 @@ class TopKElements {
     AddFreqItem(e);
   }
 
+  /*
+   * Merge the elements and the sketch of another TopKElements with the same k,
+   * e.g., of another part of the same column. The top k elements of the union
+   * are taken from the top k elements of both, with their counts estimated
+   * by the merged sketch.
+   */
+  void Merge(const TopKElements& other) {
+    cmsketch.Merge(other.cmsketch);
+
+    std::vector<ApproxTopEntry> entries = tkq.retrieve_all();
+    for (const auto& entry : other.tkq.retrieve_all()) {
+      if (std::find(entries.begin(), entries.end(), entry) == entries.end()) {
+        entries.push_back(entry);
+      }
+    }
+
+    tkq = TopKQueue{tkq.get_k()};
+    for (auto& entry : entries) {
+      const auto& elem = entry.approx_top_elem;
+      if (elem.item_type == ApproxTopEntryElem::ElemType::INT_TYPE) {
+        entry.approx_count = cmsketch.EstimateItemCount(elem.int_item);
+      } else {
+        entry.approx_count = cmsketch.EstimateItemCount(elem.str_item.c_str());
+      }
+      tkq.push(entry);
+    }
+  }
+
   /*
    * Peloton type compatible / adaptor
    */
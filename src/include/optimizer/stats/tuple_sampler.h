@@ -39,6 +39,8 @@ class TupleSampler {
   }
 
   size_t AcquireSampleTuples(size_t target_sample_count);
+
+  std::vector<size_t> SampleTileGroupOffsets(size_t target_sample_count);
   bool GetTupleInTileGroup(storage::TileGroup *tile_group, size_t tuple_offset,
                            std::unique_ptr<storage::Tuple> &tuple);
 
@@ -55,6 +55,13 @@ class HashJoinPlan : public AbstractJoinPlan {
 
   void SetBloomFilterFlag(bool flag) { build_bloomfilter_ = flag; }
 
+  /// Does this (anti) join follow the NULL semantics of NOT IN? A left row is
+  /// then not produced if its key is NULL and the right side isn't empty, and
+  /// no left row is produced if the right side has a NULL key.
+  bool IsNullAware() const { return null_aware_; }
+
+  void SetNullAware(bool null_aware) { null_aware_ = null_aware; }
+
   const std::string GetInfo() const override { return "HashJoinPlan"; }
 
   void GetLeftHashKeys(
@@ -87,6 +94,9 @@ class HashJoinPlan : public AbstractJoinPlan {
 
   // Flag indicating whether we build a bloom filter
   bool build_bloomfilter_;
+
+  // Flag indicating whether an anti join has the NULL semantics of NOT IN
+  bool null_aware_;
 };
 
 }  // namespace planner
@@ -129,6 +129,12 @@ class IndexScanPlan : public AbstractScan {
     return runtime_keys_;
   }
 
+  // The expressions producing the value of each column in the scan key. These
+  // are the runtime keys, if the plan has any, or otherwise expressions
+  // standing in for the constants and parameters in the plan's value list.
+  std::vector<const expression::AbstractExpression *> GetKeyValueExpressions()
+      const;
+
   inline PlanNodeType GetPlanNodeType() const {
     return PlanNodeType::INDEXSCAN;
   }
@@ -157,6 +163,18 @@ class IndexScanPlan : public AbstractScan {
 
   void SetParameterValues(std::vector<type::Value> *values);
 
+  hash_t Hash() const override;
+
+  bool operator==(const AbstractPlan &rhs) const override;
+  bool operator!=(const AbstractPlan &rhs) const override {
+    return !(*this == rhs);
+  }
+
+  void VisitParameters(
+      codegen::QueryParametersMap &map,
+      std::vector<peloton::type::Value> &values,
+      const std::vector<peloton::type::Value> &values_from_user) override;
+
   std::unique_ptr<AbstractPlan> Copy() const {
     std::vector<expression::AbstractExpression *> new_runtime_keys;
     for (auto *key : runtime_keys_) {
@@ -200,6 +218,10 @@ class IndexScanPlan : public AbstractScan {
 
   const std::vector<expression::AbstractExpression *> runtime_keys_;
 
+  // Expressions for the values in values_with_params_, used by the codegen
+  // engine to parameterize the scan key
+  std::vector<std::unique_ptr<expression::AbstractExpression>> key_value_exprs_;
+
   // whether the index scan range is left open
   bool left_open_ = false;
 
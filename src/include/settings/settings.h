@@ -116,6 +116,19 @@ SETTING_int(gc_num_threads,
             1, 128,
             true, true)
 
+// Tile groups whose live tuples fall below the threshold are compacted by
+// moving the tuples into other tile groups, the emptied tile group is freed
+SETTING_bool(tile_group_compaction,
+             "Enable compaction of sparse tile groups (default: false)",
+             false,
+             true, true)
+
+SETTING_double(tile_group_compaction_threshold,
+               "Fraction of live tuples below which a full tile group is compacted (default: 0.25)",
+               0.25,
+               0.0, 1.0,
+               true, true)
+
 SETTING_bool(parallel_execution,
              "Enable parallel execution of queries (default: true)",
              true,
@@ -127,10 +140,77 @@ SETTING_int(min_parallel_table_scan_size,
             1, std::numeric_limits<int32_t>::max(),
             true, true)
 
+SETTING_int(parallel_morsel_size,
+            "Number of tile groups in each unit of work (morsel) handed out to workers during parallel execution (default: 1)",
+            1,
+            1, 1024,
+            true, true)
+
+// Hash aggregations, hash joins and sorts spill to disk rather than allocate
+// more. Aggregations with DISTINCT terms can't merge spilled groups, and a
+// hash join only spills if it is an inner join whose rows go to the output
+// directly, the others ignore the limit.
+SETTING_int(query_memory_limit,
+            "Memory a query may allocate for its hash tables and sorts in MB "
+            "before they spill to disk, 0 for no limit (default: 0). "
+            "DISTINCT aggregates and hash joins other than inner joins "
+            "feeding the output ignore the limit.",
+            0,
+            0, std::numeric_limits<int32_t>::max(),
+            true, true)
+
+SETTING_string(spill_directory,
+               "Directory of the temporary files hash tables and sorts "
+               "spill to (default: /tmp)",
+               "/tmp",
+               false, false)
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
 
+// Enable or disable the write ahead log
+SETTING_bool(wal,
+             "Enable the logical redo log (default: false)",
+             false,
+             false, false)
+
+// Log directories, one log flusher thread is started per directory
+SETTING_string(wal_directories,
+               "Comma separated list of log directories (default: ./peloton_wal)",
+               "./peloton_wal",
+               false, false)
+
+// Time between two log flushes. A flush issues one fsync for all the epochs
+// that closed since the previous flush.
+SETTING_int(wal_fsync_interval,
+            "Time (in us) between two flushes of the log (default: 1000)",
+            1000,
+            10, 1000 * 1000,
+            true, true)
+
+//===----------------------------------------------------------------------===//
+// CHECKPOINTS
+//===----------------------------------------------------------------------===//
+
+// Enable or disable periodic checkpoints
+SETTING_bool(checkpointing,
+             "Enable periodic checkpoints of the tables (default: false)",
+             false,
+             false, false)
+
+// Checkpoint directory, only the latest complete checkpoint is kept
+SETTING_string(checkpoint_directory,
+               "Checkpoint directory (default: ./peloton_checkpoint)",
+               "./peloton_checkpoint",
+               false, false)
+
+SETTING_int(checkpoint_interval,
+            "Time (in s) between two checkpoints (default: 30)",
+            30,
+            1, 24 * 60 * 60,
+            true, true)
+
 //===----------------------------------------------------------------------===//
 // ERROR REPORTING AND LOGGING
 //===----------------------------------------------------------------------===//
@@ -204,6 +284,34 @@ SETTING_bool(codegen_interpreter,
              "Force interpretation of generated llvm code (default: false)",
              false, true, true)
 
+SETTING_bool(codegen_adaptive,
+             "Start executing new queries in the interpreter while they are "
+             "compiled in the background (default: false)",
+             false, true, true)
+
+// Size of the worker pool compiling queries in the background
+SETTING_int(codegen_compile_worker_pool_size,
+            "Number of threads compiling queries in the background "
+            "(default: 2)",
+            2,
+            1, 16,
+            false, false)
+
+// Memory the compiled code of the cached queries may occupy
+SETTING_int(codegen_query_cache_size,
+            "Memory of the compiled code kept in the query cache in MB, "
+            "0 for no limit (default: 0)",
+            0,
+            0, 65536,
+            false, false)
+
+// Object code cache directory, compiled queries are not persisted if it is empty
+SETTING_string(codegen_object_cache_directory,
+               "Directory of the persistent cache of compiled queries "
+               "(default: empty, disabled)",
+               "",
+               false, false)
+
 SETTING_bool(print_ir_stats,
              "Print statistics on generated IR (default: false)",
              false,
@@ -227,6 +335,20 @@ SETTING_bool(hash_join_bloom_filter,
              false,
              true, true)
 
+// Number of tile groups ANALYZE samples, 0 scans the entire table
+SETTING_int(analyze_sample_tile_groups,
+            "Number of tile groups sampled to collect table statistics, "
+            "0 to scan all of them (default: 0)",
+            0,
+            0, std::numeric_limits<int32_t>::max(),
+            true, true)
+
+// Refresh the statistics of tables that were modified since the last ANALYZE
+SETTING_bool(auto_analyze,
+             "Enable automatic refresh of stale table statistics (default: false)",
+             false,
+             false, false)
+
 SETTING_int(task_execution_timeout,
             "Maximum allowed length of time (in ms) for task "
                 "execution step of optimizer, "
@@ -21,6 +21,7 @@
 #include "common/container/lock_free_queue.h"
 #include "common/platform.h"
 #include "common/synchronization/spin_latch.h"
+#include "statistics/counter_metric.h"
 #include "statistics/database_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
@@ -79,6 +80,24 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric &GetTxnLatencyMetric();
 
+  // Returns the time commits waited for the log to become durable
+  LatencyMetric &GetCommitLatencyMetric();
+
+  // Returns the number of bytes written to the log
+  CounterMetric &GetLogBytesFlushed() { return log_bytes_flushed_; }
+
+  // Returns the number of dead index entries removed by the GC
+  CounterMetric &GetIndexEntriesReclaimed() { return index_entries_reclaimed_; }
+
+  // Returns the index memory released by the GC
+  CounterMetric &GetIndexBytesReclaimed() { return index_bytes_reclaimed_; }
+
+  // Returns the number of tile groups freed by the GC
+  CounterMetric &GetTileGroupsFreed() { return tile_groups_freed_; }
+
+  // Returns the tile group memory released by the GC
+  CounterMetric &GetTileGroupBytesFreed() { return tile_group_bytes_freed_; }
+
   // Increment the read stat for given tile group
   void IncrementTableReads(oid_t tile_group_id);
 
@@ -110,6 +129,21 @@ class BackendStatsContext {
   // Increment the abortion stat for given database
   void IncrementTxnAborted(oid_t database_id);
 
+  // Increment the number of bytes written to the log
+  void IncrementLogBytesFlushed(size_t bytes);
+
+  // Increment the number of index entries and bytes reclaimed by the GC
+  void IncrementIndexReclaimed(size_t entry_count, size_t bytes);
+
+  // Increment the number of tile groups and bytes freed by the GC
+  void IncrementTileGroupFreed(size_t bytes);
+
+  // Increment the bytes spilled to disk and the passes over them by the query
+  void IncrementQuerySpill(uint64_t bytes, uint64_t passes);
+
+  // Increment the time the compiled query ran in the interpreter and natively
+  void IncrementQueryExecutionTime(double interpreted_ms, double native_ms);
+
   // Initialize the query stat
   void InitQueryMetric(const std::shared_ptr<Statement> statement,
                        const std::shared_ptr<QueryMetric::QueryParams> params);
@@ -170,6 +204,20 @@ class BackendStatsContext {
   // Latencies recorded by this worker
   LatencyMetric txn_latencies_;
 
+  // Log flush latencies of the commits of this worker
+  LatencyMetric commit_latencies_;
+
+  // Bytes written to the log by this logger
+  CounterMetric log_bytes_flushed_{MetricType::COUNTER};
+
+  // Dead index entries removed by the GC thread of this context
+  CounterMetric index_entries_reclaimed_{MetricType::COUNTER};
+  CounterMetric index_bytes_reclaimed_{MetricType::COUNTER};
+
+  // Compacted tile groups freed by the GC thread of this context
+  CounterMetric tile_groups_freed_{MetricType::COUNTER};
+  CounterMetric tile_group_bytes_freed_{MetricType::COUNTER};
+
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
 
@@ -18,6 +18,7 @@
 #include "common/internal_types.h"
 #include "statistics/abstract_metric.h"
 #include "statistics/access_metric.h"
+#include "statistics/counter_metric.h"
 #include "statistics/latency_metric.h"
 #include "statistics/processor_metric.h"
 #include "util/string_util.h"
@@ -77,6 +78,14 @@ class QueryMetric : public AbstractMetric {
 
   inline ProcessorMetric &GetProcessorMetric() { return processor_metric_; }
 
+  inline CounterMetric &GetSpilledBytes() { return spilled_bytes_; }
+
+  inline CounterMetric &GetSpillPasses() { return spill_passes_; }
+
+  inline CounterMetric &GetInterpretedTime() { return interpreted_us_; }
+
+  inline CounterMetric &GetNativeTime() { return native_us_; }
+
   inline std::string GetName() const { return query_name_; }
 
   inline oid_t GetDatabaseId() const { return database_id_; }
@@ -124,6 +133,14 @@ class QueryMetric : public AbstractMetric {
 
   // Processor metric
   ProcessorMetric processor_metric_{MetricType::PROCESSOR};
+
+  // The bytes hash tables spilled to disk, and the passes over them
+  CounterMetric spilled_bytes_{MetricType::COUNTER};
+  CounterMetric spill_passes_{MetricType::COUNTER};
+
+  // The microseconds the compiled query ran in the interpreter and natively
+  CounterMetric interpreted_us_{MetricType::COUNTER};
+  CounterMetric native_us_{MetricType::COUNTER};
 };
 
 }  // namespace stats
@@ -124,6 +124,8 @@ class StatsAggregator {
 
   int64_t total_prev_txn_committed_;
 
+  int64_t total_prev_log_bytes_;
+
   // Stats aggregator background thread
   std::thread aggregator_thread_;
 
@@ -66,6 +66,7 @@ namespace storage {
 class Tuple;
 class TileGroup;
 class IndirectionArray;
+class ZoneMap;
 
 //===--------------------------------------------------------------------===//
 // DataTable
@@ -156,6 +157,15 @@ class DataTable : public AbstractTable {
 
   size_t GetTileGroupCount() const;
 
+  // Remove a tile group that holds no data from the table, its offset stays
+  // reserved. The caller frees it in the storage manager once no transaction
+  // can still be scanning it. Returns false if the table has no such tile
+  // group
+  bool DropTileGroup(const oid_t &tile_group_id);
+
+  // Whether this table belongs to the catalog
+  bool IsCatalogTable() const { return is_catalog_; }
+
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(std::shared_ptr<const Layout> layout);
 
@@ -230,6 +240,13 @@ class DataTable : public AbstractTable {
 
   void ResetDirty();
 
+  //===--------------------------------------------------------------------===//
+  // ZONE MAPS
+  //===--------------------------------------------------------------------===//
+
+  // The in-memory zone maps of the tile groups in this table
+  ZoneMap *GetZoneMap() const { return zone_map_.get(); }
+
   //===--------------------------------------------------------------------===//
   // LAYOUT TUNER
   //===--------------------------------------------------------------------===//
@@ -333,6 +350,15 @@ class DataTable : public AbstractTable {
 
   oid_t AddDefaultIndirectionArray(const size_t &active_indirection_array_id);
 
+  // get the active tile group of a shard. it is added when a thread of the
+  // shard first needs it, so a table only pays for the shards that insert.
+  std::shared_ptr<storage::TileGroup> GetActiveTileGroup(
+      const size_t &active_tile_group_id);
+
+  // get the active indirection array of a shard, adding it if needed.
+  std::shared_ptr<storage::IndirectionArray> GetActiveIndirectionArray(
+      const size_t &active_indirection_array_id);
+
   // Drop all tile groups of the table. Used by recovery
   void DropTileGroups();
 
@@ -384,6 +410,9 @@ class DataTable : public AbstractTable {
   // number of tuples allocated per tilegroup
   size_t tuples_per_tilegroup_;
 
+  // catalog tables are rebuilt by the catalog, not by recovery
+  const bool is_catalog_;
+
   // TILE GROUPS
   LockFreeArray<oid_t> tile_groups_;
 
@@ -398,6 +427,9 @@ class DataTable : public AbstractTable {
   // data table mutex
   std::mutex data_table_mutex_;
 
+  // serializes adding the first tile group or indirection array of a shard
+  std::mutex active_shard_mutex_;
+
   // INDEXES
   LockFreeArray<std::shared_ptr<index::Index>> indexes_;
 
@@ -411,6 +443,9 @@ class DataTable : public AbstractTable {
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
+  // ZONE MAPS
+  std::unique_ptr<ZoneMap> zone_map_;
+
   // Last used layout_oid. Used while creating new layouts
   // Initialized to COLUMN_STORE_OID since its the highest predefined value.
   std::atomic<oid_t> current_layout_oid_;
@@ -88,6 +88,7 @@ class TileGroupHeader : public Printable {
     num_tuple_slots = other.num_tuple_slots;
     next_tuple_slot.store(other.next_tuple_slot);
     immutable = other.immutable;
+    num_recycled.store(other.num_recycled);
 
     // copy tuple header values
     for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -263,6 +264,17 @@ class TileGroupHeader : public Printable {
 
   inline bool GetImmutability() const { return immutable; }
 
+  /*
+  * @brief The number of slots that the GC has reclaimed and that are not in
+  use again. Once it reaches the number of slots of an immutable tile group,
+  the tile group holds no data and can be freed.
+  */
+  inline oid_t IncrementRecycled() { return ++num_recycled; }
+
+  inline oid_t DecrementRecycled() { return --num_recycled; }
+
+  inline oid_t GetNumRecycled() const { return num_recycled; }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -301,6 +313,9 @@ class TileGroupHeader : public Printable {
   // Immmutable Flag. Should be set by the indextuner to be true.
   // By default it will be set to false.
   bool immutable;
+
+  // number of reclaimed tuple slots that are not reused
+  std::atomic<oid_t> num_recycled;
 };
 
 }  // namespace storage
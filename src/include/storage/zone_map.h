@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tbb/concurrent_vector.h"
+
+#include "common/container/cuckoo_map.h"
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace storage {
+
+class TileGroup;
+
+struct PredicateInfo {
+  int col_id;
+  int comparison_operator;
+  type::Value predicate_value;
+};
+
+//===--------------------------------------------------------------------===//
+// ZoneMap
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief The in-memory zone maps of all tile groups in a single DataTable.
+ *
+ * The zone map of a tile group is an immutable, versioned snapshot that is
+ * published by atomically swapping a pointer. Scans deciding whether to skip
+ * a tile group therefore never latch and never touch the catalog. Writers
+ * build a new snapshot (copy-on-write) and install it. Installed snapshots
+ * are handed to the ZoneMapManager, which persists them to the zone map
+ * catalog in the background.
+ *
+ * Zone maps are kept conservative under concurrent writes: a slot handed out
+ * in a tile group that has a zone map either widens it (when the tuple is
+ * known up front, e.g., inserts) or drops it (when the contents are written
+ * later, e.g., new versions of updates). A version updated in place by its
+ * owner widens it with the new values.
+ */
+class ZoneMap {
+ public:
+  /** The statistics of one column in one tile group. min and max only cover
+   * non-null values; they are INVALID if every value in the column is NULL. */
+  struct ColumnZoneMap {
+    type::Value min;
+    type::Value max;
+    uint32_t null_count;
+  };
+
+  /** An immutable snapshot of the zone maps of all columns in a tile group */
+  struct TileGroupZoneMap {
+    oid_t tile_group_offset;
+    uint64_t version;
+    std::vector<ColumnZoneMap> columns;
+  };
+
+  ZoneMap(oid_t database_oid, oid_t table_oid);
+
+  DISALLOW_COPY_AND_MOVE(ZoneMap);
+
+  /**
+   * @brief Get the current zone map snapshot of a tile group
+   *
+   * @param tile_group_offset The 0-based offset of the tile group in the table
+   *
+   * @return The snapshot, or nullptr if the tile group has no zone map
+   */
+  std::shared_ptr<const TileGroupZoneMap> GetTileGroupZoneMap(
+      oid_t tile_group_offset) const;
+
+  // Compute the zone map of the given tile group and install it
+  std::shared_ptr<const TileGroupZoneMap> BuildTileGroupZoneMap(
+      oid_t tile_group_offset, TileGroup &tile_group,
+      bool persist_in_background = true);
+
+  // Widen the zone map (if any) of the tile group to cover the tuple
+  void UpdateOnInsert(oid_t tile_group_id, const AbstractTuple &tuple);
+
+  // Widen the zone map (if any) of the tile group to cover a version its owner
+  // has updated in place. The old values may still be visible to others, so
+  // they stay covered.
+  void UpdateOnUpdate(oid_t tile_group_id, const AbstractTuple &tuple) {
+    UpdateOnInsert(tile_group_id, tuple);
+  }
+
+  // Drop the zone map (if any) of the tile group
+  void Invalidate(oid_t tile_group_id);
+
+  // Drop all zone maps of the table
+  void Clear();
+
+  /**
+   * @brief Check the parsed predicates of a scan against the zone map of the
+   * given tile group. Called from generated code for every tile group.
+   *
+   * @return True if tile group needs to be scanned, false if it can be skipped
+   */
+  bool ShouldScanTileGroup(PredicateInfo *parsed_predicates,
+                           int32_t num_predicates,
+                           int64_t tile_group_offset) const;
+
+  // The version of the most recently installed snapshot
+  uint64_t GetVersion() const { return version_.load(); }
+
+  // The number of tile groups that currently have a zone map
+  size_t GetZoneMapCount() const { return num_zone_maps_.load(); }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // Utilities
+  //===--------------------------------------------------------------------===//
+
+  std::shared_ptr<const TileGroupZoneMap> Install(
+      oid_t tile_group_offset, std::shared_ptr<TileGroupZoneMap> new_zone_map,
+      bool persist_in_background);
+
+  static void WidenColumn(ColumnZoneMap &column, const type::Value &value);
+
+  static bool CheckPredicate(const PredicateInfo &predicate,
+                             const ColumnZoneMap &column);
+
+  //===--------------------------------------------------------------------===//
+  // Data Members
+  //===--------------------------------------------------------------------===//
+
+  const oid_t database_oid_;
+
+  const oid_t table_oid_;
+
+  // Snapshots indexed by tile group offset. Slots are only ever accessed
+  // through std::atomic_load/std::atomic_store.
+  tbb::concurrent_vector<std::shared_ptr<const TileGroupZoneMap>> zone_maps_;
+
+  // Tile group id -> offset, only for tile groups that had a zone map built.
+  // Used by writers, which only know the tile group id of a slot.
+  CuckooMap<oid_t, oid_t> tile_group_offsets_;
+
+  std::atomic<size_t> num_zone_maps_;
+
+  std::atomic<uint64_t> version_;
+};
+
+}  // namespace storage
+}  // namespace peloton
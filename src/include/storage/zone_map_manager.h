@@ -12,10 +12,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
+#include "common/container/lock_free_queue.h"
 #include "common/macros.h"
 #include "common/internal_types.h"
+#include "storage/zone_map.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -29,12 +35,6 @@ namespace storage {
 class DataTable;
 class TileGroup;
 
-struct PredicateInfo {
-  int col_id;
-  int comparison_operator;
-  type::Value predicate_value;
-};
-
 class ZoneMapManager {
  public:
   typedef struct ColumnStatistics {
@@ -72,6 +72,20 @@ class ZoneMapManager {
 
   bool ZoneMapTableExists();
 
+  //===--------------------------------------------------------------------===//
+  // Background Persistence
+  //===--------------------------------------------------------------------===//
+
+  void EnqueueForPersistence(
+      oid_t database_id, oid_t table_id,
+      std::shared_ptr<const ZoneMap::TileGroupZoneMap> zone_map);
+
+  size_t PersistPendingZoneMaps();
+
+  void StartPersister();
+
+  void StopPersister();
+
  private:
   //===--------------------------------------------------------------------===//
   // Utilities
@@ -86,41 +100,39 @@ class ZoneMapManager {
   std::unique_ptr<ZoneMapManager::ColumnStatistics> GetResultVectorAsZoneMap(
       std::unique_ptr<std::vector<type::Value>> &result_vector);
 
-  static bool CheckEqual(const type::Value &predicate_val,
-                         ColumnStatistics *stats) {
-    const type::Value &min = stats->min;
-    const type::Value &max = stats->max;
-    return (min.CompareLessThanEquals(predicate_val)) == CmpBool::CmpTrue &&
-           (max.CompareGreaterThanEquals(predicate_val) == CmpBool::CmpTrue);
-  }
-
-  static bool CheckLessThan(const type::Value &predicate_val,
-                            ColumnStatistics *stats) {
-    return predicate_val.CompareGreaterThan(stats->min) == CmpBool::CmpTrue;
-  }
+  void PersistTileGroupZoneMap(oid_t database_id, oid_t table_id,
+                               const ZoneMap::TileGroupZoneMap &zone_map,
+                               concurrency::TransactionContext *txn);
 
-  static bool CheckLessThanEquals(const type::Value &predicate_val,
-                                  ColumnStatistics *stats) {
-    return predicate_val.CompareGreaterThanEquals(stats->min) ==
-           CmpBool::CmpTrue;
-  }
-
-  static bool CheckGreaterThan(const type::Value &predicate_val,
-                               ColumnStatistics *stats) {
-    return predicate_val.CompareLessThan(stats->max) == CmpBool::CmpTrue;
-  }
-
-  static bool CheckGreaterThanEquals(const type::Value &predicate_val,
-                                     ColumnStatistics *stats) {
-    return predicate_val.CompareLessThanEquals(stats->max) == CmpBool::CmpTrue;
-  }
+  void RunPersister();
 
   //===--------------------------------------------------------------------===//
   // Data Members
   //===--------------------------------------------------------------------===//
+
+  /** A zone map snapshot waiting to be written to the catalog */
+  struct PendingZoneMap {
+    oid_t database_id;
+    oid_t table_id;
+    std::shared_ptr<const ZoneMap::TileGroupZoneMap> zone_map;
+  };
+
+  // How often the persister drains the pending queue
+  static constexpr int kPersistIntervalMs = 1000;
+
   std::unique_ptr<type::AbstractPool> pool_;
 
   bool zone_map_table_exists;
+
+  LockFreeQueue<PendingZoneMap> pending_zone_maps_;
+
+  std::atomic<bool> persister_running_;
+
+  std::mutex persister_mutex_;
+
+  std::condition_variable persister_cv_;
+
+  std::thread persister_thread_;
 };
 
 }  // namespace storage
@@ -19,7 +19,7 @@ namespace peloton {
 namespace threadpool {
 
 /**
- * @brief Wrapper class for single queue and single pool.
+ * @brief Wrapper class for a single work-stealing worker pool.
  */
 class MonoQueuePool {
  public:
@@ -35,16 +35,22 @@ class MonoQueuePool {
   template <typename F>
   void SubmitTask(const F &func);
 
+  /// Submit a task that should preferably run on the given worker
+  template <typename F>
+  void SubmitTask(const F &func, uint32_t worker_hint);
+
   uint32_t NumWorkers() const { return worker_pool_.NumWorkers(); }
 
+  WorkerPoolMetrics GetMetrics() const { return worker_pool_.GetMetrics(); }
+
   /// Instances for various components
   static MonoQueuePool &GetInstance();
   // TODO(Tianyu): Rename to (Brain)QueryHistoryLog or something
   static MonoQueuePool &GetBrainInstance();
   static MonoQueuePool &GetExecutionInstance();
+  static MonoQueuePool &GetCompileInstance();
 
  private:
-  TaskQueue task_queue_;
   WorkerPool worker_pool_;
   bool is_running_;
 };
@@ -58,8 +64,7 @@ class MonoQueuePool {
 inline MonoQueuePool::MonoQueuePool(const std::string &name,
                                     uint32_t task_queue_size,
                                     uint32_t worker_pool_size)
-    : task_queue_(task_queue_size),
-      worker_pool_(name, worker_pool_size, task_queue_),
+    : worker_pool_(name, worker_pool_size, task_queue_size),
       is_running_(false) {}
 
 inline MonoQueuePool::~MonoQueuePool() {
@@ -83,7 +88,15 @@ inline void MonoQueuePool::SubmitTask(const F &func) {
   if (!is_running_) {
     Startup();
   }
-  task_queue_.Enqueue(std::move(func));
+  worker_pool_.SubmitTask(func);
+}
+
+template <typename F>
+inline void MonoQueuePool::SubmitTask(const F &func, uint32_t worker_hint) {
+  if (!is_running_) {
+    Startup();
+  }
+  worker_pool_.SubmitTask(func, worker_hint);
 }
 
 inline MonoQueuePool &MonoQueuePool::GetInstance() {
@@ -137,5 +150,22 @@ inline MonoQueuePool &MonoQueuePool::GetExecutionInstance() {
   return brain_queue_pool;
 }
 
+inline MonoQueuePool &MonoQueuePool::GetCompileInstance() {
+  int32_t task_queue_size = settings::SettingsManager::GetInt(
+      settings::SettingId::monoqueue_task_queue_size);
+  int32_t worker_pool_size = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_compile_worker_pool_size);
+
+  PELOTON_ASSERT(task_queue_size > 0);
+  PELOTON_ASSERT(worker_pool_size > 0);
+
+  std::string name = "compile-pool";
+
+  static MonoQueuePool compile_queue_pool(
+      name, static_cast<uint32_t>(task_queue_size),
+      static_cast<uint32_t>(worker_pool_size));
+  return compile_queue_pool;
+}
+
 }  // namespace threadpool
 }  // namespace peloton
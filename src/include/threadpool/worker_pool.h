@@ -13,27 +13,59 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "common/container/lock_free_queue.h"
+#include "common/synchronization/spin_latch.h"
 
 namespace peloton {
 namespace threadpool {
 
-using TaskQueue = peloton::LockFreeQueue<std::function<void()>>;
+/**
+ * @brief Counters a worker pool keeps about the tasks it runs.
+ */
+struct WorkerPoolMetrics {
+  // The number of tasks submitted to the pool
+  uint64_t num_submitted = 0;
+  // The number of tasks the workers picked up
+  uint64_t num_dequeued = 0;
+  // The number of tasks a worker took from the queue of another worker
+  uint64_t num_stolen = 0;
+  // The number of times a worker went to sleep because it found no task
+  uint64_t num_parked = 0;
+  // The number of tasks submitted, but not picked up by a worker yet
+  uint64_t queue_depth = 0;
+  // The time tasks waited between being submitted and being picked up
+  uint64_t total_wait_ns = 0;
+  uint64_t max_wait_ns = 0;
+};
 
 /**
  * @brief A worker pool that maintains a group of worker threads. This pool is
  * restartable, meaning it can be started again after it has been shutdown.
  * Calls to Startup() and Shutdown() are thread-safe and idempotent.
+ *
+ * Every worker has its own task queue. Tasks submitted by a worker of the pool
+ * go to its own queue, tasks submitted by any other thread go to a queue shared
+ * by all workers, and tasks with an affinity go to the queue of that worker.
+ * A worker takes tasks from its own queue first, then from the shared queue,
+ * and steals from the other workers when both are empty. A worker that finds no
+ * task at all sleeps on a condition variable until a task is submitted, so idle
+ * pools don't burn CPU and new tasks are picked up right away.
  */
 class WorkerPool {
  public:
+  using Task = std::function<void()>;
+
   WorkerPool(const std::string &pool_name, uint32_t num_workers,
-             TaskQueue &task_queue);
+             uint32_t task_queue_size);
 
   /**
    * @brief Start this worker pool. Thread-safe and idempotent.
@@ -41,10 +73,25 @@ class WorkerPool {
   void Startup();
 
   /**
-   * @brief Shutdown this worker pool. Thread-safe and idempotent.
+   * @brief Shutdown this worker pool. Thread-safe and idempotent. Tasks that
+   * were already submitted are run before the workers exit.
    */
   void Shutdown();
 
+  /**
+   * @brief Submit a task to any worker of this pool
+   */
+  void SubmitTask(Task task);
+
+  /**
+   * @brief Submit a task that should preferably run on the given worker. The
+   * task may still be stolen by another worker if that one is idle.
+   *
+   * @param task The task to run
+   * @param worker_hint The preferred worker, modulo the number of workers
+   */
+  void SubmitTask(Task task, uint32_t worker_hint);
+
   /**
    * @brief Access the number of worker threads in this pool
    *
@@ -52,6 +99,42 @@ class WorkerPool {
    */
   uint32_t NumWorkers() const { return num_workers_; }
 
+  /**
+   * @brief Return the counters of this pool since it was created
+   */
+  WorkerPoolMetrics GetMetrics() const;
+
+ private:
+  // A task with the time it was submitted, in nanoseconds
+  struct QueuedTask {
+    Task func;
+    uint64_t submit_time;
+  };
+
+  // The task queue of a single worker
+  struct WorkerQueue {
+    common::synchronization::SpinLatch latch;
+    std::deque<QueuedTask> tasks;
+  };
+
+  // The main loop of every worker thread
+  void WorkerLoop(uint32_t worker_id);
+
+  // Find the next task for the given worker, stealing if necessary
+  bool NextTask(uint32_t worker_id, QueuedTask &task);
+
+  // Remove the oldest task of the given worker queue
+  bool PopTask(WorkerQueue &queue, QueuedTask &task);
+
+  // Run a task that was just taken from a queue
+  void RunTask(QueuedTask &task);
+
+  // Count a new task before it is queued
+  void CountTask();
+
+  // Wake up a sleeping worker, if any, to run a new task
+  void WakeWorker();
+
  private:
   // The name of this pool
   std::string pool_name_;
@@ -61,8 +144,25 @@ class WorkerPool {
   uint32_t num_workers_;
   // Flag indicating whether the pool is running
   std::atomic_bool is_running_;
-  // The queue where workers pick up tasks
-  TaskQueue &task_queue_;
+  // The queue of every worker
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  // The queue for tasks submitted from outside the pool
+  LockFreeQueue<QueuedTask> shared_queue_;
+  // The number of tasks in all queues
+  std::atomic<uint64_t> num_pending_;
+
+  // Idle workers sleep on this condition variable
+  std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+  std::atomic<uint32_t> num_parked_workers_;
+
+  // Metrics
+  std::atomic<uint64_t> num_submitted_;
+  std::atomic<uint64_t> num_dequeued_;
+  std::atomic<uint64_t> num_stolen_;
+  std::atomic<uint64_t> num_parked_;
+  std::atomic<uint64_t> total_wait_ns_;
+  std::atomic<uint64_t> max_wait_ns_;
 };
 
 }  // namespace threadpool
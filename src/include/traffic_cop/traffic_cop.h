@@ -73,10 +73,13 @@ class TrafficCop {
       size_t thread_id = 0);
 
   // Helper to handle txn-specifics for the plan-tree of a statement.
+  // copy_input holds the rows loaded by a COPY ... FROM STDIN plan, if any,
+  // and must stay alive until the execution completes.
   executor::ExecutionResult ExecuteHelper(
       std::shared_ptr<planner::AbstractPlan> plan,
       const std::vector<type::Value> &params, std::vector<ResultValue> &result,
-      const std::vector<int> &result_format, size_t thread_id = 0);
+      const std::vector<int> &result_format, size_t thread_id = 0,
+      const std::string *copy_input = nullptr);
 
   // Prepare a statement using the parse tree
   std::shared_ptr<Statement> PrepareStatement(
@@ -104,6 +107,16 @@ class TrafficCop {
 
   ResultType ExecuteStatementGetResult();
 
+  // COPY ... FROM STDIN executes its plan once for every chunk of rows the
+  // client streams in. Unlike ExecuteStatementPlanGetResult(), collecting the
+  // result of a chunk keeps a single-statement txn open so that the whole load
+  // commits or aborts together in CommitCopyIn().
+  ResultType ExecuteCopyChunkGetResult();
+
+  // Commit the single-statement txn of a COPY ... FROM STDIN after its last
+  // chunk was loaded. Inside a txn block this does nothing.
+  ResultType CommitCopyIn();
+
   void SetTaskCallback(void (*task_callback)(void *), void *task_callback_arg) {
     task_callback_ = task_callback;
     task_callback_arg_ = task_callback_arg;
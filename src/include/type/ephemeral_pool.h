@@ -12,9 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
-#include <unordered_set>
+#include <unordered_map>
 
 #include "common/macros.h"
 #include "common/synchronization/spin_latch.h"
@@ -38,12 +39,21 @@ class EphemeralPool : public AbstractPool {
 
   void Free(void *ptr) override;
 
+  // The number of bytes allocated and not freed yet
+  size_t GetAllocatedBytes() const {
+    return allocated_bytes_.load(std::memory_order_relaxed);
+  }
+
  public:
-  // Location list
-  std::unordered_set<char *> locations_;
+  // Location list, with the size of each location
+  std::unordered_map<char *, size_t> locations_;
 
   // Spin lock protecting location list
   common::synchronization::SpinLatch pool_lock_;
+
+ private:
+  // The total size of the locations
+  std::atomic<size_t> allocated_bytes_{0};
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,8 +64,8 @@ class EphemeralPool : public AbstractPool {
 
 inline EphemeralPool::~EphemeralPool() {
   pool_lock_.Lock();
-  for (auto location : locations_) {
-    delete[] location;
+  for (auto &location : locations_) {
+    delete[] location.first;
   }
   pool_lock_.Unlock();
 }
@@ -64,17 +74,24 @@ inline void *EphemeralPool::Allocate(size_t size) {
   auto location = new char[size];
 
   pool_lock_.Lock();
-  locations_.insert(location);
+  locations_.emplace(location, size);
   pool_lock_.Unlock();
+  allocated_bytes_.fetch_add(size, std::memory_order_relaxed);
 
   return location;
 }
 
 inline void EphemeralPool::Free(void *ptr) {
   auto *cptr = (char *)ptr;
+  size_t size = 0;
   pool_lock_.Lock();
-  locations_.erase(cptr);
+  auto location = locations_.find(cptr);
+  if (location != locations_.end()) {
+    size = location->second;
+    locations_.erase(location);
+  }
   pool_lock_.Unlock();
+  allocated_bytes_.fetch_sub(size, std::memory_order_relaxed);
   delete[] cptr;
 }
 
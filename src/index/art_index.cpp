@@ -232,6 +232,12 @@ void ArtIndex::ScanRange(const art::Key &start, const art::Key &end,
   }
 }
 
+size_t ArtIndex::GetMemoryFootprint() {
+  // Leaves only hold the value, the key bytes are spread over the inner nodes
+  return GetNumberOfTuples() *
+         (GetKeySchema()->GetLength() + sizeof(ItemPointer *));
+}
+
 void ArtIndex::SetLoadKeyFunc(art::Tree::LoadKeyFunction load_func, void *ctx) {
   container_.setLoadKeyFunc(load_func, ctx);
 }
@@ -60,6 +60,10 @@ bool BWTREE_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
     ret = container.Insert(index_key, value, false);
   }
 
+  if (ret == true) {
+    IncreaseNumberOfTuplesBy(1);
+  }
+
   if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
   }
@@ -90,6 +94,11 @@ bool BWTREE_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
   // it is unnecessary for us to allocate memory
   bool ret = container.Delete(index_key, value);
 
+  if (ret == true) {
+    delete_count = 1;
+    DecreaseNumberOfTuplesBy(1);
+  }
+
   if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
         delete_count, metadata);
@@ -122,6 +131,7 @@ bool BWTREE_INDEX_TYPE::CondInsertEntry(
   if (predicate_satisfied == false) {
     // So it should always succeed?
     assert(ret == true);
+    IncreaseNumberOfTuplesBy(1);
   } else {
     assert(ret == false);
   }
@@ -294,6 +304,15 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
 BWTREE_TEMPLATE_ARGUMENTS
 std::string BWTREE_INDEX_TYPE::GetTypeName() const { return "BWTree"; }
 
+/*
+ * GetMemoryFootprint() - The size of the key-value pairs in the leaf nodes.
+ *                        Inner nodes and delta chains are not counted
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+size_t BWTREE_INDEX_TYPE::GetMemoryFootprint() {
+  return GetNumberOfTuples() * (sizeof(KeyType) + sizeof(ValueType));
+}
+
 // IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
 
 template class BWTreeIndex<CompactIntsKey<1>, ItemPointer *,
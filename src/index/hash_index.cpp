@@ -0,0 +1,395 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.cpp
+//
+// Identification: src/index/hash_index.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "index/hash_index.h"
+
+#include "common/logger.h"
+#include "index/index_key.h"
+#include "index/scan_optimizer.h"
+#include "settings/settings_manager.h"
+#include "statistics/stats_aggregator.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+HASH_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::HashIndex(IndexMetadata *metadata)
+    :  // Base class
+      Index{metadata},
+      // Key "less than" relation comparator, only used by range scans
+      comparator{},
+      // Key equality checker
+      equals{},
+      // Value equality checker
+      value_equals{},
+      container{kInitialCapacity},
+      num_empty_keys{0} {
+  return;
+}
+
+HASH_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::~HashIndex() {}
+
+/*
+ * InsertEntry() - insert a key-value pair into the map
+ *
+ * If the key value pair already exists in the map, or if the index has unique
+ * keys and the key is already mapped to some value, just return false
+ */
+HASH_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                  ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  const bool unique_keys = HasUniqueKeys();
+  bool ret = true;
+
+  auto insert_fn = [this, value, unique_keys, &ret](ValueList &values) {
+    if (unique_keys && !values.empty()) {
+      ret = false;
+      return;
+    }
+    for (const auto &existing : values) {
+      if (value_equals(existing, value)) {
+        ret = false;
+        return;
+      }
+    }
+    // Reusing a value list left empty by deletes
+    if (values.empty()) {
+      num_empty_keys--;
+    }
+    values.push_back(value);
+  };
+
+  // Only build a new value list if the key is not in the map yet
+  if (!container.update_fn(index_key, insert_fn)) {
+    container.upsert(index_key, insert_fn, ValueList{value});
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  LOG_TRACE("InsertEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
+  return ret;
+}
+
+/*
+ * DeleteEntry() - Removes a key-value pair
+ *
+ * If the key-value pair does not exists yet in the map return false. The
+ * value list of the key stays in the map even if it becomes empty, and is
+ * reclaimed by PerformGC()
+ */
+HASH_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                  ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = false;
+  container.update_fn(index_key, [this, value, &ret](ValueList &values) {
+    for (auto itr = values.begin(); itr != values.end(); itr++) {
+      if (value_equals(*itr, value)) {
+        // Order within a key does not matter
+        *itr = values.back();
+        values.pop_back();
+        ret = true;
+        break;
+      }
+    }
+    if (ret && values.empty()) {
+      num_empty_keys++;
+    }
+  });
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        ret ? 1 : 0, metadata);
+  }
+
+  LOG_TRACE("DeleteEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
+  return ret;
+}
+
+/*
+ * CondInsertEntry() - Insert a key-value pair only if the predicate is false
+ *                     for all values already mapped by the key
+ *
+ * The check and the insert happen under the same bucket lock, so they are
+ * atomic with respect to every other operation on the key
+ */
+HASH_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::CondInsertEntry(
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = true;
+  auto insert_fn = [this, value, &predicate, &ret](ValueList &values) {
+    for (const auto &existing : values) {
+      if (predicate(existing) || value_equals(existing, value)) {
+        ret = false;
+        return;
+      }
+    }
+    if (values.empty()) {
+      num_empty_keys--;
+    }
+    values.push_back(value);
+  };
+
+  if (!container.update_fn(index_key, insert_fn)) {
+    container.upsert(index_key, insert_fn, ValueList{value});
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  return ret;
+}
+
+/*
+ * Scan() - Scans the index using index scan optimizer
+ *
+ * Point queries are answered with a single hash lookup. Since there is no
+ * order among the keys, all other scans iterate over the whole map while it
+ * is locked, keeping only keys between the low key and the high key
+ */
+HASH_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::Scan(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  LOG_TRACE("Scan() Point Query = %d; Full Scan = %d ", csp_p->IsPointQuery(),
+            csp_p->IsFullIndexScan());
+
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    GetValue(point_query_key, result);
+  } else if (csp_p->IsFullIndexScan() == true) {
+    auto locked_table = container.lock_table();
+    for (const auto &entry : locked_table) {
+      result.insert(result.end(), entry.second.begin(), entry.second.end());
+    }
+  } else {
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+
+    auto locked_table = container.lock_table();
+    for (const auto &entry : locked_table) {
+      if (comparator(entry.first, index_low_key) ||
+          comparator(index_high_key, entry.first)) {
+        continue;
+      }
+      result.insert(result.end(), entry.second.begin(), entry.second.end());
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+/*
+ * ScanLimit() - Scan the index with predicate and limit/offset
+ *
+ * Keys are not ordered, so there is no first qualified key to stop at and
+ * this is a regular scan. The executor applies the limit
+ */
+HASH_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanLimit(
+    const std::vector<type::Value> &value_list,
+    const std::vector<oid_t> &tuple_column_id_list,
+    const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, UNUSED_ATTRIBUTE uint64_t limit,
+    UNUSED_ATTRIBUTE uint64_t offset) {
+  Scan(value_list, tuple_column_id_list, expr_list, scan_direction, result,
+       csp_p);
+}
+
+HASH_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  {
+    auto locked_table = container.lock_table();
+    for (const auto &entry : locked_table) {
+      result.insert(result.end(), entry.second.begin(), entry.second.end());
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+}
+
+HASH_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                              std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  GetValue(index_key, result);
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+}
+
+HASH_TEMPLATE_ARGUMENTS
+std::string HASH_INDEX_TYPE::GetTypeName() const { return "Hash"; }
+
+/*
+ * GetMemoryFootprint() - The size of the slot array plus the value lists.
+ *                        This takes the lock of the whole map
+ */
+HASH_TEMPLATE_ARGUMENTS
+size_t HASH_INDEX_TYPE::GetMemoryFootprint() {
+  size_t footprint = container.bucket_count() * MapType::slot_per_bucket *
+                     sizeof(typename MapType::value_type);
+
+  auto locked_table = container.lock_table();
+  for (const auto &entry : locked_table) {
+    footprint += entry.second.capacity() * sizeof(ValueType);
+  }
+  return footprint;
+}
+
+/*
+ * NeedGC() - Whether at least a quarter of the keys have no values left
+ */
+HASH_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::NeedGC() {
+  return num_empty_keys.load() > container.size() / 4;
+}
+
+/*
+ * PerformGC() - Remove all keys whose value list is empty
+ *
+ * The keys are collected while the map is locked, and then erased one by one
+ * only if their value list is still empty, since a concurrent insert might
+ * have reused it in the meantime. num_empty_keys is only changed under the
+ * lock of the key, so it stays exact across concurrent inserts and deletes
+ */
+HASH_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::PerformGC() {
+  LOG_TRACE("Hash Index Garbage Collection!");
+
+  std::vector<KeyType> empty_keys;
+  {
+    auto locked_table = container.lock_table();
+    for (const auto &entry : locked_table) {
+      if (entry.second.empty()) {
+        empty_keys.push_back(entry.first);
+      }
+    }
+  }
+
+  for (const auto &empty_key : empty_keys) {
+    container.erase_fn(empty_key, [this](ValueList &values) {
+      if (!values.empty()) {
+        return false;
+      }
+      num_empty_keys--;
+      return true;
+    });
+  }
+
+  LOG_TRACE("Removed %zu empty keys", empty_keys.size());
+}
+
+HASH_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::GetValue(const KeyType &index_key,
+                               std::vector<ValueType> &result) {
+  // update_fn() runs the function under the lock of the key's buckets, which
+  // lets us read the value list in place instead of copying it out
+  container.update_fn(index_key, [&result](ValueList &values) {
+    result.insert(result.end(), values.begin(), values.end());
+  });
+}
+
+// IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
+
+template class HashIndex<CompactIntsKey<1>, ItemPointer *,
+                         CompactIntsComparator<1>,
+                         CompactIntsEqualityChecker<1>, CompactIntsHasher<1>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<2>, ItemPointer *,
+                         CompactIntsComparator<2>,
+                         CompactIntsEqualityChecker<2>, CompactIntsHasher<2>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<3>, ItemPointer *,
+                         CompactIntsComparator<3>,
+                         CompactIntsEqualityChecker<3>, CompactIntsHasher<3>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<4>, ItemPointer *,
+                         CompactIntsComparator<4>,
+                         CompactIntsEqualityChecker<4>, CompactIntsHasher<4>,
+                         ItemPointerComparator>;
+
+// Generic key
+template class HashIndex<GenericKey<4>, ItemPointer *,
+                         FastGenericComparator<4>, GenericEqualityChecker<4>,
+                         GenericHasher<4>, ItemPointerComparator>;
+template class HashIndex<GenericKey<8>, ItemPointer *,
+                         FastGenericComparator<8>, GenericEqualityChecker<8>,
+                         GenericHasher<8>, ItemPointerComparator>;
+template class HashIndex<GenericKey<16>, ItemPointer *,
+                         FastGenericComparator<16>,
+                         GenericEqualityChecker<16>, GenericHasher<16>,
+                         ItemPointerComparator>;
+template class HashIndex<GenericKey<64>, ItemPointer *,
+                         FastGenericComparator<64>,
+                         GenericEqualityChecker<64>, GenericHasher<64>,
+                         ItemPointerComparator>;
+template class HashIndex<GenericKey<256>, ItemPointer *,
+                         FastGenericComparator<256>,
+                         GenericEqualityChecker<256>, GenericHasher<256>,
+                         ItemPointerComparator>;
+
+// Tuple key
+template class HashIndex<TupleKey, ItemPointer *, TupleKeyComparator,
+                         TupleKeyEqualityChecker, TupleKeyHasher,
+                         ItemPointerComparator>;
+
+}  // namespace index
+}  // namespace peloton
@@ -15,7 +15,29 @@
 namespace peloton {
 namespace index {
 
-// Add your function definitions here
+size_t SkipListUtil::GetThreadSlot() {
+  static std::atomic<size_t> next_slot{0};
+  thread_local size_t slot = next_slot.fetch_add(1);
+  return slot;
+}
+
+int SkipListUtil::RandomHeight(int max_height) {
+  // xorshift64, seeded differently for every thread
+  thread_local uint64_t state =
+      0x9E3779B97F4A7C15ull * (GetThreadSlot() + 1);
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+
+  // Every pair of random bits keeps one more level with probability 1/4
+  uint64_t bits = state;
+  int height = 1;
+  while (height < max_height && (bits & 3) == 0) {
+    height++;
+    bits >>= 2;
+  }
+  return height;
+}
 
 }  // namespace index
 }  // namespace peloton
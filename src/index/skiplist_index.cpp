@@ -14,6 +14,7 @@
 #include "common/logger.h"
 #include "index/index_key.h"
 #include "index/scan_optimizer.h"
+#include "settings/settings_manager.h"
 #include "statistics/stats_aggregator.h"
 #include "storage/tuple.h"
 
@@ -27,8 +28,8 @@ SKIPLIST_INDEX_TYPE::SkipListIndex(IndexMetadata *metadata)
       // Key "less than" relation comparator
       comparator{},
       // Key equality checker
-      equals{} {
-  // TODO: Add your implementation here
+      equals{},
+      container{} {
   return;
 }
 
@@ -41,11 +42,21 @@ SKIPLIST_INDEX_TYPE::~SkipListIndex() {}
  * If the key value pair already exists in the map, just return false
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
-bool SKIPLIST_INDEX_TYPE::InsertEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value) {
-  bool ret = false;
-  // TODO: Add your implementation here
+bool SKIPLIST_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                      ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Insert(index_key, value, HasUniqueKeys());
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  LOG_TRACE("InsertEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
   return ret;
 }
 
@@ -55,72 +66,216 @@ bool SKIPLIST_INDEX_TYPE::InsertEntry(
  * If the key-value pair does not exists yet in the map return false
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
-bool SKIPLIST_INDEX_TYPE::DeleteEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value) {
-  bool ret = false;
-  // TODO: Add your implementation here
+bool SKIPLIST_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                      ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Delete(index_key, value);
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        ret ? 1 : 0, metadata);
+  }
+
+  LOG_TRACE("DeleteEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(), (ret ? "SUCCESS" : "FAIL"));
+
   return ret;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
 bool SKIPLIST_INDEX_TYPE::CondInsertEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value,
-    UNUSED_ATTRIBUTE std::function<bool(const void *)> predicate) {
-  bool ret = false;
-  // TODO: Add your implementation here
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Checking the predicate and inserting happen in one step, so no other
+  // insert of the key can sneak in between
+  bool predicate_satisfied = false;
+  bool ret = container.ConditionalInsert(index_key, value, predicate,
+                                         &predicate_satisfied);
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  LOG_TRACE("CondInsertEntry(key=%s, val=%s) [%s]", key->GetInfo().c_str(),
+            IndexUtil::GetInfo(value).c_str(),
+            (ret ? "SUCCESS"
+                 : (predicate_satisfied ? "PREDICATE SATISFIED" : "FAIL")));
+
   return ret;
 }
 
 /*
  * Scan() - Scans a range inside the index using index scan optimizer
  *
+ * The scan optimizer specifies whether a scan is point query, full scan
+ * or interval scan. Full and interval scans go backward from the high key
+ * if the scan direction asks for it, so the result is in descending order.
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
 void SKIPLIST_INDEX_TYPE::Scan(
     UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
     UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
     UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result,
-    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p) {
-  // TODO: Add your implementation here
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  LOG_TRACE("Scan() Point Query = %d; Full Scan = %d ", csp_p->IsPointQuery(),
+            csp_p->IsFullIndexScan());
+
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    container.GetValue(point_query_key, result);
+  } else if (csp_p->IsFullIndexScan() == true) {
+    if (scan_direction == ScanDirectionType::FORWARD) {
+      for (auto scan_itr = container.Begin(); scan_itr.IsEnd() == false;
+           ++scan_itr) {
+        result.push_back(scan_itr.GetValue());
+      }
+    } else {
+      for (auto scan_itr = container.RBegin(); scan_itr.IsEnd() == false;
+           ++scan_itr) {
+        result.push_back(scan_itr.GetValue());
+      }
+    }
+  } else {
+    const storage::Tuple *low_key_p = csp_p->GetLowKey();
+    const storage::Tuple *high_key_p = csp_p->GetHighKey();
+
+    LOG_TRACE("Partial scan low key: %s\n high key: %s",
+              low_key_p->GetInfo().c_str(), high_key_p->GetInfo().c_str());
+
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(low_key_p);
+    index_high_key.SetFromKey(high_key_p);
+
+    if (scan_direction == ScanDirectionType::FORWARD) {
+      for (auto scan_itr = container.Begin(index_low_key);
+           (scan_itr.IsEnd() == false) &&
+               (container.KeyCmpLessEqual(scan_itr.GetKey(), index_high_key));
+           ++scan_itr) {
+        result.push_back(scan_itr.GetValue());
+      }
+    } else {
+      for (auto scan_itr = container.RBegin(index_high_key);
+           (scan_itr.IsEnd() == false) &&
+               (container.KeyCmpLessEqual(index_low_key, scan_itr.GetKey()));
+           ++scan_itr) {
+        result.push_back(scan_itr.GetValue());
+      }
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
 /*
  * ScanLimit() - Scan the index with predicate and limit/offset
  *
+ * limit == 1 and offset == 0 is what MIN() and MAX() get translated to. In
+ * that case only the first key in the range from the given direction is
+ * fetched. As with the BwTree, the key is not checked against non-exact
+ * bounds.
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
 void SKIPLIST_INDEX_TYPE::ScanLimit(
-    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
-    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
-    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result,
-    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p,
-    UNUSED_ATTRIBUTE uint64_t limit, UNUSED_ATTRIBUTE uint64_t offset) {
-  // TODO: Add your implementation here
+    const std::vector<type::Value> &value_list,
+    const std::vector<oid_t> &tuple_column_id_list,
+    const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (csp_p->IsPointQuery() == false && limit == 1 && offset == 0 &&
+      scan_direction != ScanDirectionType::INVALID) {
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+
+    if (scan_direction == ScanDirectionType::FORWARD) {
+      auto scan_itr = container.Begin(index_low_key);
+      if ((scan_itr.IsEnd() == false) &&
+          (container.KeyCmpLessEqual(scan_itr.GetKey(), index_high_key))) {
+        result.push_back(scan_itr.GetValue());
+      }
+    } else {
+      auto scan_itr = container.RBegin(index_high_key);
+      if ((scan_itr.IsEnd() == false) &&
+          (container.KeyCmpLessEqual(index_low_key, scan_itr.GetKey()))) {
+        result.push_back(scan_itr.GetValue());
+      }
+    }
+  } else {
+    Scan(value_list, tuple_column_id_list, expr_list, scan_direction, result,
+         csp_p);
+  }
+
   return;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
-void SKIPLIST_INDEX_TYPE::ScanAllKeys(
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result) {
-  // TODO: Add your implementation here
+void SKIPLIST_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  for (auto it = container.Begin(); it.IsEnd() == false; ++it) {
+    result.push_back(it.GetValue());
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
   return;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
-void SKIPLIST_INDEX_TYPE::ScanKey(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result) {
-  // TODO: Add your implementation here
+void SKIPLIST_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                                  std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.GetValue(index_key, result);
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
+SKIPLIST_TEMPLATE_ARGUMENTS
+size_t SKIPLIST_INDEX_TYPE::GetMemoryFootprint() {
+  return container.GetMemoryFootprint();
+}
+
+SKIPLIST_TEMPLATE_ARGUMENTS
+bool SKIPLIST_INDEX_TYPE::NeedGC() {
+  return container.NeedGarbageCollection();
+}
+
+SKIPLIST_TEMPLATE_ARGUMENTS
+void SKIPLIST_INDEX_TYPE::PerformGC() {
+  container.PerformGarbageCollection();
+}
+
 SKIPLIST_TEMPLATE_ARGUMENTS
 std::string SKIPLIST_INDEX_TYPE::GetTypeName() const { return "SkipList"; }
 
@@ -0,0 +1,751 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_checkpoint_manager.cpp
+//
+// Identification: src/logging/logical_checkpoint_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_checkpoint_manager.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <tuple>
+
+#include <boost/filesystem.hpp>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/serializeio.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+// The tuples of a checkpoint file are buffered up to this size
+constexpr size_t kWriteBufferSize = 1024 * 1024;
+
+// The number of tuples recovery inserts in one transaction
+constexpr size_t kInsertBatchSize = 10000;
+
+// The size of a log frame header: the epoch, the worker and the length
+constexpr size_t kFrameHeaderSize =
+    sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint32_t);
+
+struct CheckpointFile {
+  FILE *file = nullptr;
+  CopySerializeOutput output;
+};
+
+size_t GetRecoveryThreadCount() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+const char *GetPosition(SerializeInput &input) {
+  return static_cast<const char *>(input.getRawPointer(0));
+}
+
+bool ReadFile(const std::string &path, std::string &content) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) return false;
+
+  bool success = false;
+  if (fseek(file, 0, SEEK_END) == 0) {
+    long size = ftell(file);
+    if (size >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+      content.resize(static_cast<size_t>(size));
+      success = size == 0 || fread(&content[0], size, 1, file) == 1;
+    }
+  }
+  fclose(file);
+  return success;
+}
+
+bool SyncFile(FILE *file) {
+  return fflush(file) == 0 && fsync(fileno(file)) == 0;
+}
+
+// Make the entries of a directory durable
+bool SyncDirectory(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool success = fsync(fd) == 0;
+  close(fd);
+  return success;
+}
+
+// Parse file names of the form prefix_id_id..., returning false if the name
+// doesn't match
+bool ParseFileName(const std::string &name, const std::string &prefix,
+                   const size_t id_count, std::vector<uint64_t> &ids) {
+  auto parts = StringUtil::Split(name, '_');
+  if (parts.size() != id_count + 1 || parts[0] != prefix) return false;
+
+  ids.clear();
+  for (size_t i = 1; i < parts.size(); i++) {
+    char *end = nullptr;
+    uint64_t id = strtoull(parts[i].c_str(), &end, 10);
+    if (parts[i].empty() || *end != '\0') return false;
+    ids.push_back(id);
+  }
+  return true;
+}
+
+std::vector<std::string> ListDirectory(const std::string &path) {
+  std::vector<std::string> names;
+  boost::system::error_code error;
+  boost::filesystem::directory_iterator itr(path, error), end;
+  for (; !error && itr != end; itr.increment(error)) {
+    names.push_back(itr->path().filename().string());
+  }
+  return names;
+}
+
+}  // namespace
+
+void LogicalCheckpointManager::SetDirectory(const std::string &checkpoint_dir) {
+  checkpoint_dir_ = checkpoint_dir;
+
+  boost::system::error_code error;
+  boost::filesystem::create_directories(checkpoint_dir_, error);
+  if (error) {
+    LOG_ERROR("Cannot create directory %s: %s", checkpoint_dir_.c_str(),
+              error.message().c_str());
+  }
+}
+
+void LogicalCheckpointManager::StartCheckpointing(
+    std::vector<std::unique_ptr<std::thread>> &checkpointer_threads) {
+  if (is_running_ == true) return;
+
+  if (checkpoint_dir_.empty()) {
+    SetDirectory(settings::SettingsManager::GetString(
+        settings::SettingId::checkpoint_directory));
+  }
+
+  is_running_ = true;
+
+  // the writers of a checkpoint are started by the checkpoint itself
+  checkpointer_threads.resize(1);
+  checkpointer_threads[0].reset(
+      new std::thread(&LogicalCheckpointManager::Running, this));
+}
+
+void LogicalCheckpointManager::StartCheckpointing() {
+  StartCheckpointing(checkpointer_threads_);
+}
+
+void LogicalCheckpointManager::StopCheckpointing() {
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    if (is_running_ == false) return;
+    is_running_ = false;
+  }
+  running_cv_.notify_all();
+
+  for (auto &checkpointer_thread : checkpointer_threads_) {
+    checkpointer_thread->join();
+  }
+  checkpointer_threads_.clear();
+}
+
+void LogicalCheckpointManager::Running() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(running_mutex_);
+      auto interval = std::chrono::seconds(settings::SettingsManager::GetInt(
+          settings::SettingId::checkpoint_interval));
+      running_cv_.wait_for(lock, interval,
+                           [this] { return is_running_ == false; });
+    }
+    if (is_running_ == false) break;
+
+    DoCheckpoint();
+  }
+}
+
+cid_t LogicalCheckpointManager::DoCheckpoint() {
+  std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+  return CreateCheckpoint();
+}
+
+cid_t LogicalCheckpointManager::CreateCheckpoint() {
+  if (checkpoint_dir_.empty()) {
+    SetDirectory(settings::SettingsManager::GetString(
+        settings::SettingId::checkpoint_directory));
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // The garbage collector doesn't reclaim the versions visible at the
+  // checkpoint while this transaction runs
+  auto txn = txn_manager.BeginTransaction();
+  eid_t epoch_id = txn->GetEpochId();
+  cid_t checkpoint_cid = epoch_id << 32;
+
+  // Transactions of earlier epochs still stamp their versions, wait for them
+  while (true) {
+    eid_t expired_eid = epoch_manager.GetExpiredEpochId();
+    if (expired_eid == MAX_EID || expired_eid + 1 >= epoch_id) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The tile groups of all tables, catalog tables are rebuilt by the catalog
+  std::vector<storage::DataTable *> tables;
+  std::vector<std::pair<size_t, size_t>> tile_groups;
+  auto storage_manager = storage::StorageManager::GetInstance();
+  for (oid_t database_offset = 0;
+       database_offset < storage_manager->GetDatabaseCount();
+       database_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(database_offset);
+    for (oid_t table_offset = 0; table_offset < database->GetTableCount();
+         table_offset++) {
+      auto table = database->GetTable(table_offset);
+      if (table->IsCatalogTable()) continue;
+
+      size_t tile_group_count = table->GetTileGroupCount();
+      for (size_t offset = 0; offset < tile_group_count; offset++) {
+        tile_groups.emplace_back(tables.size(), offset);
+      }
+      tables.push_back(table);
+    }
+  }
+
+  std::string checkpoint_path = GetCheckpointPath(checkpoint_cid);
+  boost::system::error_code error;
+  boost::filesystem::remove_all(checkpoint_path, error);
+  boost::filesystem::create_directories(checkpoint_path, error);
+  if (error) {
+    LOG_ERROR("Cannot create directory %s: %s", checkpoint_path.c_str(),
+              error.message().c_str());
+    txn_manager.CommitTransaction(txn);
+    return INVALID_CID;
+  }
+
+  // Writers take tile groups one by one, and write the tuples of each table
+  // to their own file
+  size_t writer_count = std::max(checkpointer_thread_count_, 1);
+  std::atomic<size_t> next_tile_group(0);
+  std::atomic<bool> failed(false);
+  RunTasks(writer_count, writer_count, [&](size_t writer_id) {
+    std::unordered_map<size_t, std::unique_ptr<CheckpointFile>> files;
+
+    auto write_out = [&failed](CheckpointFile &file) {
+      auto &output = file.output;
+      if (output.Size() > 0 &&
+          fwrite(output.Data(), output.Size(), 1, file.file) != 1) {
+        failed = true;
+      }
+      output.Reset();
+    };
+
+    for (size_t i = next_tile_group++; i < tile_groups.size() && !failed;
+         i = next_tile_group++) {
+      auto table = tables[tile_groups[i].first];
+      auto tile_group = table->GetTileGroup(tile_groups[i].second);
+      if (tile_group == nullptr) continue;
+
+      auto &file = files[tile_groups[i].first];
+      if (file == nullptr) {
+        std::string path = checkpoint_path + "/" +
+                           checkpoint_filename_prefix_ + "_" +
+                           std::to_string(table->GetDatabaseOid()) + "_" +
+                           std::to_string(table->GetOid()) + "_" +
+                           std::to_string(writer_id);
+        file.reset(new CheckpointFile());
+        file->file = fopen(path.c_str(), "wb");
+        if (file->file == nullptr) {
+          LOG_ERROR("Cannot open %s: %s", path.c_str(), strerror(errno));
+          failed = true;
+          break;
+        }
+      }
+
+      WriteTileGroup(tile_group.get(), checkpoint_cid, file->output);
+      if (file->output.Size() >= kWriteBufferSize) write_out(*file);
+    }
+
+    for (auto &entry : files) {
+      auto &file = *entry.second;
+      if (file.file == nullptr) continue;
+      write_out(file);
+      if (!SyncFile(file.file)) failed = true;
+      fclose(file.file);
+    }
+  });
+
+  // Nothing else is read from the tables
+  txn_manager.CommitTransaction(txn);
+
+  // The metadata file marks the checkpoint as complete
+  std::string metadata_path = checkpoint_path + "/" + metadata_filename_;
+  FILE *metadata_file = failed ? nullptr : fopen(metadata_path.c_str(), "wb");
+  bool complete =
+      metadata_file != nullptr &&
+      fwrite(&checkpoint_cid, sizeof(checkpoint_cid), 1, metadata_file) == 1 &&
+      SyncFile(metadata_file);
+  if (metadata_file != nullptr) fclose(metadata_file);
+  complete = complete && SyncDirectory(checkpoint_path) &&
+             SyncDirectory(checkpoint_dir_);
+
+  if (!complete) {
+    LOG_ERROR("Cannot write checkpoint %" PRIu64 ": %s", checkpoint_cid,
+              strerror(errno));
+    boost::filesystem::remove_all(checkpoint_path, error);
+    return INVALID_CID;
+  }
+
+  // Older checkpoints are not needed anymore, and neither are incomplete ones
+  std::vector<uint64_t> ids;
+  for (auto &name : ListDirectory(checkpoint_dir_)) {
+    if (ParseFileName(name, checkpoint_dirname_prefix_, 1, ids) &&
+        ids[0] < checkpoint_cid) {
+      boost::filesystem::remove_all(GetCheckpointPath(ids[0]), error);
+    }
+  }
+
+  LOG_INFO("Checkpoint %" PRIu64 " written: %zu tile groups of %zu tables",
+           checkpoint_cid, tile_groups.size(), tables.size());
+  return checkpoint_cid;
+}
+
+void LogicalCheckpointManager::WriteTileGroup(storage::TileGroup *tile_group,
+                                              const cid_t checkpoint_cid,
+                                              SerializeOutput &output) {
+  auto tile_group_header = tile_group->GetHeader();
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  oid_t tuple_count = tile_group->GetNextTupleSlot();
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    // A version is in the checkpoint if it was committed before the
+    // checkpoint, and not replaced or deleted before it. Versions of running
+    // transactions carry MAX_CID until they commit in a later epoch.
+    if (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID) {
+      continue;
+    }
+    cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+    cid_t end_cid = tile_group_header->GetEndCommitId(tuple_id);
+    if (begin_cid >= checkpoint_cid || end_cid < checkpoint_cid) continue;
+
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      tile_group->GetValue(tuple_id, column_id).SerializeTo(output);
+    }
+  }
+}
+
+cid_t LogicalCheckpointManager::GetLatestCheckpointCid() {
+  if (checkpoint_dir_.empty()) {
+    SetDirectory(settings::SettingsManager::GetString(
+        settings::SettingId::checkpoint_directory));
+  }
+
+  cid_t latest_cid = INVALID_CID;
+  std::vector<uint64_t> ids;
+  for (auto &name : ListDirectory(checkpoint_dir_)) {
+    if (!ParseFileName(name, checkpoint_dirname_prefix_, 1, ids)) continue;
+
+    std::string content;
+    cid_t checkpoint_cid;
+    if (!ReadFile(GetCheckpointPath(ids[0]) + "/" + metadata_filename_,
+                  content) ||
+        content.size() != sizeof(checkpoint_cid)) {
+      continue;
+    }
+    PELOTON_MEMCPY(&checkpoint_cid, content.data(), sizeof(checkpoint_cid));
+    latest_cid = std::max(latest_cid, checkpoint_cid);
+  }
+  return latest_cid;
+}
+
+bool LogicalCheckpointManager::DoRecovery(
+    const std::vector<std::string> &logging_dirs) {
+  std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  size_t thread_count = GetRecoveryThreadCount();
+  std::vector<uint64_t> ids;
+
+  // The files of the latest checkpoint, by table
+  cid_t checkpoint_cid = GetLatestCheckpointCid();
+  std::map<TableId, std::vector<std::string>> checkpoint_files;
+  if (checkpoint_cid != INVALID_CID) {
+    std::string checkpoint_path = GetCheckpointPath(checkpoint_cid);
+    for (auto &name : ListDirectory(checkpoint_path)) {
+      if (ParseFileName(name, checkpoint_filename_prefix_, 3, ids)) {
+        checkpoint_files[TableId(ids[0], ids[1])].push_back(checkpoint_path +
+                                                            "/" + name);
+      }
+    }
+  }
+
+  // Only the epochs up to the persistent one are replayed, later ones were
+  // not acknowledged to any client
+  eid_t persist_eid = INVALID_EID;
+  std::string content;
+  if (!logging_dirs.empty() &&
+      ReadFile(logging_dirs[0] + "/" + pepoch_filename_, content) &&
+      content.size() >= sizeof(persist_eid)) {
+    size_t last = content.size() / sizeof(persist_eid) - 1;
+    PELOTON_MEMCPY(&persist_eid, content.data() + last * sizeof(persist_eid),
+                   sizeof(persist_eid));
+  }
+
+  // Each directory holds the files of one logger, in epoch order
+  std::vector<std::vector<std::string>> log_files(logging_dirs.size());
+  size_t log_file_count = 0;
+  for (size_t dir_id = 0; dir_id < logging_dirs.size(); dir_id++) {
+    std::vector<std::pair<uint64_t, std::string>> files;
+    for (auto &name : ListDirectory(logging_dirs[dir_id])) {
+      if (ParseFileName(name, logging_filename_prefix_, 2, ids)) {
+        files.emplace_back(ids[1], logging_dirs[dir_id] + "/" + name);
+      }
+    }
+    std::sort(files.begin(), files.end());
+    for (auto &file : files) {
+      log_files[dir_id].push_back(file.second);
+    }
+    log_file_count += files.size();
+  }
+
+  if (checkpoint_cid == INVALID_CID && log_file_count == 0) return false;
+
+  // Split the frames of every logger into the record streams of its workers
+  std::vector<std::map<uint32_t, std::string>> worker_streams(
+      logging_dirs.size());
+  std::atomic<eid_t> max_eid(checkpoint_cid >> 32);
+  RunTasks(logging_dirs.size(), thread_count, [&](size_t dir_id) {
+    for (auto &path : log_files[dir_id]) {
+      std::string file_content;
+      if (!ReadFile(path, file_content)) {
+        LOG_ERROR("Cannot read %s: %s", path.c_str(), strerror(errno));
+        continue;
+      }
+
+      size_t position = 0;
+      while (position + kFrameHeaderSize <= file_content.size()) {
+        uint64_t epoch_id;
+        uint32_t worker_id;
+        uint32_t length;
+        const char *header = file_content.data() + position;
+        PELOTON_MEMCPY(&epoch_id, header, sizeof(epoch_id));
+        PELOTON_MEMCPY(&worker_id, header + sizeof(epoch_id),
+                       sizeof(worker_id));
+        PELOTON_MEMCPY(&length, header + sizeof(epoch_id) + sizeof(worker_id),
+                       sizeof(length));
+
+        // a frame torn by a crash
+        if (position + kFrameHeaderSize + length > file_content.size()) break;
+
+        if (epoch_id <= persist_eid) {
+          worker_streams[dir_id][worker_id].append(header + kFrameHeaderSize,
+                                                   length);
+        }
+        eid_t seen_eid = max_eid.load();
+        while (seen_eid < epoch_id &&
+               !max_eid.compare_exchange_weak(seen_eid, epoch_id)) {
+        }
+        position += kFrameHeaderSize + length;
+      }
+    }
+  });
+
+  // Replay the streams in parallel, each into its own tuple counts
+  std::vector<const std::string *> streams;
+  for (auto &dir_streams : worker_streams) {
+    for (auto &stream : dir_streams) {
+      streams.push_back(&stream.second);
+    }
+  }
+  std::vector<std::map<TableId, TupleCounts>> log_tuples(streams.size());
+  RunTasks(streams.size(), thread_count, [&](size_t stream_id) {
+    ReplayLogStream(*streams[stream_id], checkpoint_cid, log_tuples[stream_id]);
+  });
+
+  // The tables to restore
+  std::vector<TableId> table_ids;
+  for (auto &entry : checkpoint_files) {
+    table_ids.push_back(entry.first);
+  }
+  for (auto &stream_tuples : log_tuples) {
+    for (auto &entry : stream_tuples) {
+      table_ids.push_back(entry.first);
+    }
+  }
+  std::sort(table_ids.begin(), table_ids.end());
+  table_ids.erase(std::unique(table_ids.begin(), table_ids.end()),
+                  table_ids.end());
+
+  std::vector<storage::DataTable *> tables;
+  std::vector<TableId> restored_table_ids;
+  for (auto &table_id : table_ids) {
+    storage::DataTable *table;
+    try {
+      table =
+          storage_manager->GetTableWithOid(table_id.first, table_id.second);
+    } catch (CatalogException &e) {
+      LOG_ERROR("Cannot restore table %u of database %u: %s", table_id.second,
+                table_id.first, e.what());
+      continue;
+    }
+    if (table->IsCatalogTable()) continue;
+    tables.push_back(table);
+    restored_table_ids.push_back(table_id);
+  }
+
+  // Merge the checkpoint and the log table by table
+  std::vector<TupleCounts> table_tuples(tables.size());
+  RunTasks(tables.size(), thread_count, [&](size_t i) {
+    auto &tuples = table_tuples[i];
+    auto &table_id = restored_table_ids[i];
+
+    auto files = checkpoint_files.find(table_id);
+    if (files != checkpoint_files.end()) {
+      for (auto &path : files->second) {
+        if (!LoadCheckpointFile(path, tables[i], tuples)) {
+          LOG_ERROR("Cannot read %s: %s", path.c_str(), strerror(errno));
+        }
+      }
+    }
+
+    // Inserts and deletes add up, the order of the transactions doesn't
+    // matter for the final counts
+    for (auto &stream_tuples : log_tuples) {
+      auto entry = stream_tuples.find(table_id);
+      if (entry == stream_tuples.end()) continue;
+      for (auto &tuple : entry->second) {
+        tuples[tuple.first] += tuple.second;
+      }
+    }
+  });
+  log_tuples.clear();
+  worker_streams.clear();
+
+  // New transactions commit after all the replayed ones
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  if (epoch_manager.GetCurrentEpochId() <= max_eid.load()) {
+    epoch_manager.SetCurrentEpochId(max_eid.load() + 1);
+  }
+
+  InsertTuples(tables, table_tuples);
+
+  // The recovered tuples are committed in the current epoch, the checkpoint
+  // that replaces the log must start in a later one to include them
+  eid_t recovered_eid = epoch_manager.GetCurrentEpochId();
+  epoch_manager.SetCurrentEpochId(recovered_eid + 1);
+
+  LOG_INFO("Recovered %zu tables from checkpoint %" PRIu64
+           " and %zu log files up to epoch %" PRIu64,
+           tables.size(), checkpoint_cid, log_file_count, persist_eid);
+
+  // The replayed log is replaced by a checkpoint, so that no frame of it is
+  // mistaken for a frame of the next run
+  if (log_file_count > 0) {
+    if (CreateCheckpoint() == INVALID_CID) {
+      LOG_ERROR("Cannot checkpoint the recovered tables, the log is kept");
+    } else {
+      for (auto &dir_files : log_files) {
+        for (auto &path : dir_files) {
+          unlink(path.c_str());
+        }
+      }
+      unlink((logging_dirs[0] + "/" + pepoch_filename_).c_str());
+    }
+  }
+
+  return true;
+}
+
+bool LogicalCheckpointManager::LoadCheckpointFile(const std::string &path,
+                                                  storage::DataTable *table,
+                                                  TupleCounts &tuples) {
+  std::string content;
+  if (!ReadFile(path, content)) return false;
+
+  auto schema = table->GetSchema();
+  ReferenceSerializeInput input(content.data(), content.size());
+  const char *end = content.data() + content.size();
+  while (GetPosition(input) < end) {
+    tuples[ReadTuple(input, schema)]++;
+  }
+  return true;
+}
+
+void LogicalCheckpointManager::ReplayLogStream(
+    const std::string &stream, const cid_t checkpoint_cid,
+    std::map<TableId, TupleCounts> &tables) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  std::map<TableId, storage::DataTable *> table_cache;
+
+  // The tuples the current transaction inserted (+1) and deleted (-1),
+  // counted once it committed
+  std::vector<std::tuple<TableId, std::string, int64_t>> records;
+
+  ReferenceSerializeInput input(stream.data(), stream.size());
+  const char *end = stream.data() + stream.size();
+  while (GetPosition(input) < end) {
+    auto record_type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+    switch (record_type) {
+      case LogRecordType::TRANSACTION_BEGIN: {
+        input.ReadLong();
+        records.clear();
+        break;
+      }
+      case LogRecordType::TRANSACTION_COMMIT: {
+        cid_t commit_id = input.ReadLong();
+        // earlier transactions are in the checkpoint
+        if (commit_id >= checkpoint_cid) {
+          for (auto &record : records) {
+            tables[std::get<0>(record)][std::get<1>(record)] +=
+                std::get<2>(record);
+          }
+        }
+        records.clear();
+        break;
+      }
+      case LogRecordType::TUPLE_INSERT:
+      case LogRecordType::TUPLE_DELETE:
+      case LogRecordType::TUPLE_UPDATE: {
+        TableId table_id;
+        table_id.first = input.ReadInt();
+        table_id.second = input.ReadInt();
+
+        auto &table = table_cache[table_id];
+        if (table == nullptr) {
+          try {
+            table = storage_manager->GetTableWithOid(table_id.first,
+                                                     table_id.second);
+          } catch (CatalogException &e) {
+            // without the schema the rest of the stream can't be read
+            LOG_ERROR("Cannot replay the log of table %u of database %u: %s",
+                      table_id.second, table_id.first, e.what());
+            return;
+          }
+        }
+
+        // updates carry the old tuple followed by the new one
+        auto schema = table->GetSchema();
+        if (record_type != LogRecordType::TUPLE_INSERT) {
+          records.emplace_back(table_id, ReadTuple(input, schema), -1);
+        }
+        if (record_type != LogRecordType::TUPLE_DELETE) {
+          records.emplace_back(table_id, ReadTuple(input, schema), 1);
+        }
+        break;
+      }
+      default: {
+        LOG_ERROR("Unknown log record type %d",
+                  static_cast<int>(record_type));
+        return;
+      }
+    }
+  }
+}
+
+void LogicalCheckpointManager::InsertTuples(
+    const std::vector<storage::DataTable *> &tables,
+    const std::vector<TupleCounts> &tuples) {
+  // Batches of live tuples of one table
+  std::vector<std::pair<size_t, std::vector<const std::string *>>> batches;
+  for (size_t i = 0; i < tables.size(); i++) {
+    for (auto &entry : tuples[i]) {
+      if (entry.second < 0) {
+        LOG_ERROR("The log deletes a tuple of table %s that doesn't exist",
+                  tables[i]->GetName().c_str());
+      }
+      for (int64_t copy = 0; copy < entry.second; copy++) {
+        if (batches.empty() || batches.back().first != i ||
+            batches.back().second.size() == kInsertBatchSize) {
+          batches.emplace_back(i, std::vector<const std::string *>());
+        }
+        batches.back().second.push_back(&entry.first);
+      }
+    }
+  }
+
+  // The batches are inserted in parallel, which fills the indexes of the
+  // tables in parallel as well
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  RunTasks(batches.size(), GetRecoveryThreadCount(), [&](size_t batch_id) {
+    auto table = tables[batches[batch_id].first];
+    auto schema = table->GetSchema();
+    oid_t column_count = schema->GetColumnCount();
+    type::EphemeralPool pool;
+
+    auto txn = txn_manager.BeginTransaction();
+    for (auto data : batches[batch_id].second) {
+      ReferenceSerializeInput input(data->data(), data->size());
+      storage::Tuple tuple(schema, true);
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        tuple.SetValue(column_id, type::Value::DeserializeFrom(
+                                      input, schema->GetType(column_id)),
+                       &pool);
+      }
+
+      // foreign keys hold for the recovered state, but not for every order of
+      // inserting it
+      ItemPointer *index_entry_ptr = nullptr;
+      ItemPointer location =
+          table->InsertTuple(&tuple, txn, &index_entry_ptr, false);
+      if (location.block == INVALID_OID) {
+        LOG_ERROR("Cannot restore a tuple of table %s",
+                  table->GetName().c_str());
+        continue;
+      }
+      txn_manager.PerformInsert(txn, location, index_entry_ptr);
+    }
+    txn_manager.CommitTransaction(txn);
+  });
+}
+
+void LogicalCheckpointManager::RunTasks(
+    const size_t task_count, const size_t thread_count,
+    const std::function<void(size_t)> &task) {
+  std::atomic<size_t> next_task(0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < std::min(task_count, thread_count); i++) {
+    threads.emplace_back([&] {
+      for (size_t task_id = next_task++; task_id < task_count;
+           task_id = next_task++) {
+        task(task_id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+std::string LogicalCheckpointManager::ReadTuple(SerializeInput &input,
+                                                const catalog::Schema *schema) {
+  const char *begin = GetPosition(input);
+  oid_t column_count = schema->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    type::Value::DeserializeFrom(input, schema->GetType(column_id));
+  }
+  return std::string(begin, GetPosition(input) - begin);
+}
+
+}  // namespace logging
+}  // namespace peloton
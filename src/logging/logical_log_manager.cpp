@@ -0,0 +1,414 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_manager.cpp
+//
+// Identification: src/logging/logical_log_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_log_manager.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+#include "storage/abstract_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+// The log state of the current thread, and the run of the log manager it
+// belongs to
+thread_local LogWorkerContext *current_worker = nullptr;
+thread_local uint64_t current_generation = 0;
+
+// The size of a transaction begin record: the type and the commit id
+constexpr size_t kTxnRecordSize = sizeof(int8_t) + sizeof(int64_t);
+
+bool IsStatsEnabled() {
+  return static_cast<StatsType>(settings::SettingsManager::GetInt(
+             settings::SettingId::stats_mode)) != StatsType::INVALID;
+}
+
+}  // namespace
+
+void LogicalLogManager::SetDirectories(
+    const std::vector<std::string> &logging_dirs) {
+  logger_dirs_ = logging_dirs;
+
+  // check the existence of logging directories.
+  // if not exists, then create the directory.
+  for (auto &logging_dir : logger_dirs_) {
+    struct stat info;
+    if (stat(logging_dir.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+      LOG_INFO("Logging directory %s is not accessible or does not exist",
+               logging_dir.c_str());
+      if (mkdir(logging_dir.c_str(), 0700) != 0) {
+        LOG_ERROR("Cannot create directory: %s", logging_dir.c_str());
+      }
+    }
+  }
+}
+
+void LogicalLogManager::StartLogging(
+    std::vector<std::unique_ptr<std::thread>> &logger_threads) {
+  if (is_running_ == true) return;
+
+  if (logger_dirs_.empty()) {
+    SetDirectories(StringUtil::Split(
+        settings::SettingsManager::GetString(
+            settings::SettingId::wal_directories),
+        ','));
+  }
+  if (logger_dirs_.empty()) {
+    LOG_ERROR("No logging directory, the log is not started");
+    return;
+  }
+
+  std::string pepoch_path = logger_dirs_[0] + "/" + pepoch_filename_;
+  auto file = fopen(pepoch_path.c_str(), "ab");
+  if (file == NULL) {
+    LOG_ERROR("Cannot open %s: %s, the log is not started",
+              pepoch_path.c_str(), strerror(errno));
+    return;
+  }
+  pepoch_file_ = FileHandle(file, fileno(file), 0);
+
+  // one logger per directory
+  loggers_.clear();
+  for (size_t i = 0; i < logger_dirs_.size(); i++) {
+    loggers_.emplace_back(new LogicalLogger(i, logger_dirs_[i]));
+  }
+  running_logger_count_ = loggers_.size();
+  persist_epoch_id_ = INVALID_EID;
+
+  worker_lock_.Lock();
+  workers_.clear();
+  worker_lock_.Unlock();
+  generation_++;
+
+  is_running_ = true;
+
+  logger_threads.resize(loggers_.size());
+  for (size_t i = 0; i < loggers_.size(); i++) {
+    logger_threads[i].reset(
+        new std::thread(&LogicalLogManager::Running, this, i));
+  }
+}
+
+void LogicalLogManager::StartLogging() { StartLogging(logger_threads_); }
+
+void LogicalLogManager::StopLogging() {
+  if (is_running_ == false) return;
+  is_running_ = false;
+
+  // The loggers flush what is left before exiting
+  for (auto &logger_thread : logger_threads_) {
+    logger_thread->join();
+  }
+  logger_threads_.clear();
+  while (running_logger_count_.load() > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(persist_mutex_);
+    persist_cv_.notify_all();
+  }
+
+  fclose(pepoch_file_.file);
+  pepoch_file_ = FileHandle();
+}
+
+void LogicalLogManager::RegisterTable(const oid_t &table_id) {
+  table_lock_.Lock();
+  tables_.insert(table_id);
+  table_lock_.Unlock();
+}
+
+void LogicalLogManager::DeregisterTable(const oid_t &table_id) {
+  table_lock_.Lock();
+  tables_.erase(table_id);
+  table_lock_.Unlock();
+}
+
+size_t LogicalLogManager::GetTableCount() {
+  table_lock_.Lock();
+  size_t table_count = tables_.size();
+  table_lock_.Unlock();
+  return table_count;
+}
+
+void LogicalLogManager::LogBegin(const cid_t &commit_id) {
+  if (is_running_ == false) return;
+
+  auto worker = GetWorkerContext();
+  worker->txn_output.Reset();
+  worker->current_cid = commit_id;
+
+  // The logger reads the current epoch before looking at the workers, so it
+  // either sees this transaction or only persists earlier epochs
+  worker->latch.Lock();
+  worker->current_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  worker->latch.Unlock();
+
+  worker->txn_output.WriteEnumInSingleByte(
+      static_cast<int>(LogRecordType::TRANSACTION_BEGIN));
+  worker->txn_output.WriteLong(commit_id);
+}
+
+void LogicalLogManager::LogEnd() {
+  if (is_running_ == false) return;
+
+  auto worker = GetWorkerContext();
+  if (worker->current_eid == MAX_EID) return;
+
+  const eid_t epoch_id = worker->current_eid;
+
+  // A transaction that changed nothing has nothing to wait for
+  bool has_records = worker->txn_output.Size() > kTxnRecordSize;
+
+  bool stats_enabled = has_records && IsStatsEnabled();
+  if (stats_enabled) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetCommitLatencyMetric()
+        .StartTimer();
+  }
+
+  if (has_records) {
+    worker->txn_output.WriteEnumInSingleByte(
+        static_cast<int>(LogRecordType::TRANSACTION_COMMIT));
+    worker->txn_output.WriteLong(worker->current_cid);
+    PublishTransaction(worker);
+  }
+
+  worker->latch.Lock();
+  worker->current_eid = MAX_EID;
+  worker->latch.Unlock();
+
+  if (has_records == false) return;
+
+  {
+    std::unique_lock<std::mutex> lock(persist_mutex_);
+    persist_cv_.wait(lock, [this, epoch_id] {
+      return persist_epoch_id_.load() >= epoch_id || is_running_ == false;
+    });
+  }
+
+  if (stats_enabled) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetCommitLatencyMetric()
+        .RecordLatency();
+  }
+}
+
+void LogicalLogManager::LogInsert(const ItemPointer &tuple_pos) {
+  if (is_running_ == false) return;
+
+  auto worker = GetWorkerContext();
+  if (worker->current_eid == MAX_EID) return;
+
+  auto tile_group =
+      storage::StorageManager::GetInstance()->GetTileGroup(tuple_pos.block);
+  WriteRecordHeader(worker, LogRecordType::TUPLE_INSERT, tile_group.get());
+  WriteTuple(worker, tile_group.get(), tuple_pos.offset);
+}
+
+void LogicalLogManager::LogUpdate(const ItemPointer &new_tuple_pos) {
+  if (is_running_ == false) return;
+
+  auto worker = GetWorkerContext();
+  if (worker->current_eid == MAX_EID) return;
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto new_tile_group = storage_manager->GetTileGroup(new_tuple_pos.block);
+
+  // The new version links to the version it replaces
+  ItemPointer old_tuple_pos =
+      new_tile_group->GetHeader()->GetNextItemPointer(new_tuple_pos.offset);
+  auto old_tile_group = storage_manager->GetTileGroup(old_tuple_pos.block);
+
+  WriteRecordHeader(worker, LogRecordType::TUPLE_UPDATE, new_tile_group.get());
+  WriteTuple(worker, old_tile_group.get(), old_tuple_pos.offset);
+  WriteTuple(worker, new_tile_group.get(), new_tuple_pos.offset);
+}
+
+void LogicalLogManager::LogDelete(const ItemPointer &old_tuple_pos) {
+  if (is_running_ == false) return;
+
+  auto worker = GetWorkerContext();
+  if (worker->current_eid == MAX_EID) return;
+
+  auto tile_group =
+      storage::StorageManager::GetInstance()->GetTileGroup(old_tuple_pos.block);
+  WriteRecordHeader(worker, LogRecordType::TUPLE_DELETE, tile_group.get());
+  WriteTuple(worker, tile_group.get(), old_tuple_pos.offset);
+}
+
+uint64_t LogicalLogManager::GetBytesFlushed() const {
+  uint64_t bytes_flushed = 0;
+  for (auto &logger : loggers_) {
+    bytes_flushed += logger->GetBytesFlushed();
+  }
+  return bytes_flushed;
+}
+
+uint64_t LogicalLogManager::GetSyncCount() const {
+  uint64_t sync_count = 0;
+  for (auto &logger : loggers_) {
+    sync_count += logger->GetSyncCount();
+  }
+  return sync_count;
+}
+
+void LogicalLogManager::Running(const size_t logger_id) {
+  auto &logger = *loggers_[logger_id];
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  while (true) {
+    bool running = is_running_;
+
+    // Once stopped, no transaction is logging anymore and the current epoch
+    // can be persisted as well
+    eid_t current_eid = epoch_manager.GetCurrentEpochId();
+    if (running == false) current_eid++;
+
+    uint64_t bytes_flushed = logger.GetBytesFlushed();
+    logger.Flush(current_eid);
+    if (IsStatsEnabled()) {
+      stats::BackendStatsContext::GetInstance()->IncrementLogBytesFlushed(
+          logger.GetBytesFlushed() - bytes_flushed);
+    }
+
+    UpdatePersistentEpoch();
+
+    if (running == false) break;
+
+    // Commits arriving until the next round share its fsync
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(settings::SettingsManager::GetInt(
+            settings::SettingId::wal_fsync_interval)));
+  }
+
+  logger.Close();
+  running_logger_count_--;
+}
+
+LogWorkerContext *LogicalLogManager::GetWorkerContext() {
+  uint64_t generation = generation_.load();
+  if (current_generation != generation) {
+    worker_lock_.Lock();
+    size_t worker_id = workers_.size();
+    std::shared_ptr<LogWorkerContext> worker(new LogWorkerContext(worker_id));
+    workers_.push_back(worker);
+    worker_lock_.Unlock();
+
+    // spread the workers over the loggers
+    loggers_[worker_id % loggers_.size()]->RegisterWorker(worker);
+
+    current_worker = worker.get();
+    current_generation = generation;
+  }
+  return current_worker;
+}
+
+void LogicalLogManager::WriteRecordHeader(LogWorkerContext *worker,
+                                          const LogRecordType type,
+                                          storage::TileGroup *tile_group) {
+  auto &output = worker->txn_output;
+  output.WriteEnumInSingleByte(static_cast<int>(type));
+  output.WriteInt(tile_group->GetDatabaseId());
+  output.WriteInt(tile_group->GetTableId());
+}
+
+void LogicalLogManager::WriteTuple(LogWorkerContext *worker,
+                                   storage::TileGroup *tile_group,
+                                   const oid_t tuple_offset) {
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    tile_group->GetValue(tuple_offset, column_id)
+        .SerializeTo(worker->txn_output);
+  }
+}
+
+void LogicalLogManager::PublishTransaction(LogWorkerContext *worker) {
+  const char *data = worker->txn_output.Data();
+  size_t remaining = worker->txn_output.Size();
+  const eid_t epoch_id = worker->current_eid;
+  std::unique_ptr<LogBuffer> new_buffer;
+
+  worker->latch.Lock();
+  while (remaining > 0) {
+    auto &buffer = worker->current_buffer;
+
+    // Buffers never mix epochs. Large transactions continue in the next
+    // buffer of the same worker.
+    if (buffer != nullptr && (buffer->GetEpochId() != epoch_id ||
+                              buffer->GetSize() == buffer->GetCapacity())) {
+      worker->sealed_buffers.push_back(std::move(buffer));
+    }
+
+    if (buffer == nullptr) {
+      if (new_buffer == nullptr) {
+        // The pool waits for the logger to give buffers back, and the logger
+        // needs the latch for that
+        worker->latch.Unlock();
+        new_buffer = worker->buffer_pool.GetBuffer(epoch_id);
+        worker->latch.Lock();
+        continue;
+      }
+      buffer = std::move(new_buffer);
+    }
+
+    size_t length =
+        std::min(remaining, buffer->GetCapacity() - buffer->GetSize());
+    buffer->WriteData(data, length);
+    data += length;
+    remaining -= length;
+  }
+  worker->latch.Unlock();
+
+  PELOTON_ASSERT(new_buffer == nullptr);
+}
+
+void LogicalLogManager::UpdatePersistentEpoch() {
+  std::lock_guard<std::mutex> lock(persist_mutex_);
+
+  eid_t persist_eid = MAX_EID;
+  for (auto &logger : loggers_) {
+    persist_eid = std::min(persist_eid, logger->GetPersistEpochId());
+  }
+  if (persist_eid <= persist_epoch_id_.load()) return;
+
+  // Recovery replays no epoch past the last one recorded here
+  if (fwrite(&persist_eid, sizeof(persist_eid), 1, pepoch_file_.file) != 1 ||
+      fflush(pepoch_file_.file) != 0 || fsync(pepoch_file_.fd) != 0) {
+    LOG_ERROR("Cannot persist epoch %" PRIu64 ": %s", persist_eid,
+              strerror(errno));
+    return;
+  }
+
+  persist_epoch_id_ = persist_eid;
+  persist_cv_.notify_all();
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_logger.cpp
+//
+// Identification: src/logging/logical_logger.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_logger.h"
+
+#include <unistd.h>
+#include <cstring>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace logging {
+
+LogicalLogger::LogicalLogger(const size_t logger_id, const std::string &log_dir)
+    : logger_id_(logger_id),
+      log_dir_(log_dir),
+      file_handle_(),
+      unsynced_bytes_(0),
+      failed_(false),
+      persist_eid_(INVALID_EID),
+      bytes_flushed_(0),
+      sync_count_(0) {}
+
+LogicalLogger::~LogicalLogger() { Close(); }
+
+void LogicalLogger::RegisterWorker(
+    const std::shared_ptr<LogWorkerContext> &worker) {
+  worker_lock_.Lock();
+  workers_.push_back(worker);
+  worker_lock_.Unlock();
+}
+
+eid_t LogicalLogger::Flush(const eid_t current_eid) {
+  // Every epoch before the current one is done, unless a worker is still
+  // logging a transaction in it
+  eid_t persist_eid = current_eid - 1;
+
+  worker_lock_.Lock();
+  auto workers = workers_;
+  worker_lock_.Unlock();
+
+  // Full buffers are written out right away, so workers get them back soon
+  for (auto &worker : workers) {
+    std::vector<std::unique_ptr<LogBuffer>> buffers;
+
+    worker->latch.Lock();
+    if (worker->current_eid != MAX_EID && worker->current_eid <= persist_eid) {
+      persist_eid = worker->current_eid - 1;
+    }
+    buffers.swap(worker->sealed_buffers);
+    worker->latch.Unlock();
+
+    WriteBuffers(*worker, buffers);
+  }
+
+  // Durability can't be promised anymore once a write failed
+  if (failed_ == true || persist_eid <= persist_eid_.load()) {
+    return persist_eid_.load();
+  }
+
+  // An epoch closed, everything logged so far goes to disk with one fsync
+  for (auto &worker : workers) {
+    std::vector<std::unique_ptr<LogBuffer>> buffers;
+
+    worker->latch.Lock();
+    buffers.swap(worker->sealed_buffers);
+    if (worker->current_buffer != nullptr &&
+        worker->current_buffer->Empty() == false) {
+      buffers.push_back(std::move(worker->current_buffer));
+    }
+    worker->latch.Unlock();
+
+    WriteBuffers(*worker, buffers);
+  }
+  Sync();
+
+  if (failed_ == false) {
+    persist_eid_ = persist_eid;
+  }
+  return persist_eid_.load();
+}
+
+void LogicalLogger::Close() {
+  if (file_handle_.file == nullptr) return;
+  Sync();
+  fclose(file_handle_.file);
+  file_handle_ = FileHandle();
+}
+
+void LogicalLogger::WriteBuffers(
+    LogWorkerContext &worker, std::vector<std::unique_ptr<LogBuffer>> &buffers) {
+  for (auto &buffer : buffers) {
+    size_t bytes = WriteBuffer(*buffer);
+    unsynced_bytes_ += bytes;
+    buffer->Reset();
+    worker.buffer_pool.PutBuffer(std::move(buffer));
+  }
+}
+
+size_t LogicalLogger::WriteBuffer(LogBuffer &buffer) {
+  if (file_handle_.file == nullptr ||
+      file_handle_.size >= max_log_file_size_) {
+    Close();
+    if (OpenLogFile(buffer.GetEpochId()) == false) {
+      failed_ = true;
+      return 0;
+    }
+  }
+
+  // frame header
+  uint64_t epoch_id = buffer.GetEpochId();
+  uint32_t worker_id = static_cast<uint32_t>(buffer.GetThreadId());
+  uint32_t length = static_cast<uint32_t>(buffer.GetSize());
+  char header[sizeof(epoch_id) + sizeof(worker_id) + sizeof(length)];
+  PELOTON_MEMCPY(header, &epoch_id, sizeof(epoch_id));
+  PELOTON_MEMCPY(header + sizeof(epoch_id), &worker_id, sizeof(worker_id));
+  PELOTON_MEMCPY(header + sizeof(epoch_id) + sizeof(worker_id), &length,
+                 sizeof(length));
+
+  if (fwrite(header, sizeof(header), 1, file_handle_.file) != 1 ||
+      fwrite(buffer.GetData(), length, 1, file_handle_.file) != 1) {
+    LOG_ERROR("Error occurred in fwrite(%s)", strerror(errno));
+    failed_ = true;
+    return 0;
+  }
+
+  size_t bytes = sizeof(header) + length;
+  file_handle_.size += bytes;
+  return bytes;
+}
+
+bool LogicalLogger::OpenLogFile(const eid_t epoch_id) {
+  std::string path = GetLogFileFullPath(epoch_id);
+  // Never truncate a log file written by an earlier run
+  auto file = fopen(path.c_str(), "ab");
+  if (file == NULL) {
+    LOG_ERROR("Cannot open log file %s: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  file_handle_.file = file;
+  file_handle_.fd = fileno(file);
+  file_handle_.size = 0;
+  LOG_TRACE("Logger %d opened log file %s", (int)logger_id_, path.c_str());
+  return true;
+}
+
+void LogicalLogger::Sync() {
+  if (file_handle_.file == nullptr || unsynced_bytes_ == 0) return;
+
+  int ret = fflush(file_handle_.file);
+  if (ret != 0) {
+    LOG_ERROR("Error occurred in fflush(%s)", strerror(errno));
+  }
+  ret = fsync(file_handle_.fd);
+  if (ret != 0) {
+    LOG_ERROR("Error occurred in fsync(%s)", strerror(errno));
+    failed_ = true;
+  }
+
+  bytes_flushed_ += unsynced_bytes_;
+  sync_count_++;
+  unsynced_bytes_ = 0;
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -18,6 +18,7 @@
 #include "common/internal_types.h"
 #include "common/macros.h"
 #include "common/portal.h"
+#include "executor/result_encoder.h"
 #include "expression/expression_util.h"
 #include "network/marshal.h"
 #include "network/peloton_server.h"
@@ -238,6 +239,18 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
         return ProcessResult::COMPLETE;
       }
       traffic_cop_->SetParamVal(std::vector<type::Value>());
+
+      // COPY from or to the client streams its rows over this connection
+      if (query_type == QueryType::QUERY_COPY &&
+          traffic_cop_->GetStatement()->GetPlanTree() != nullptr) {
+        auto &copy_stmt = static_cast<parser::CopyStatement &>(
+            *traffic_cop_->GetStatement()->GetStmtParseTreeList()->GetStatement(
+                0));
+        if (copy_stmt.file_path.empty()) {
+          return ExecCopyMessage(copy_stmt, thread_id);
+        }
+      }
+
       bool unnamed = false;
       result_format_ = std::vector<int>(
           traffic_cop_->GetStatement()->GetTupleDescriptor().size(), 0);
@@ -269,6 +282,7 @@ ResultType PostgresProtocolHandler::ExecQueryExplain(
         traffic_cop_->GetColumnFieldForValueType("Query plan",
                                                  type::TypeId::VARCHAR)};
     stmt->SetTupleDescriptor(tuple_descriptor);
+    result_format_ = std::vector<int>(tuple_descriptor.size(), 0);
     traffic_cop_->SetResult(plan_info);
     status = ResultType::SUCCESS;
   } else {
@@ -308,6 +322,208 @@ void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
   SendReadyForQuery(NetworkTransactionStateType::IDLE);
 }
 
+// COPY ... FROM STDIN / TO STDOUT
+ProcessResult PostgresProtocolHandler::ExecCopyMessage(
+    parser::CopyStatement &copy_stmt, const size_t thread_id) {
+  auto plan = traffic_cop_->GetStatement()->GetPlanTree();
+
+  // The rows being copied are produced by the only child of the plan: the CSV
+  // scan below the insert of COPY FROM, or the query below the export of
+  // COPY TO
+  PELOTON_ASSERT(plan->GetChildrenSize() == 1);
+  std::vector<oid_t> columns;
+  plan->GetChild(0)->GetOutputColumns(columns);
+  copy_num_cols_ = static_cast<int>(columns.size());
+  copy_delimiter_ = copy_stmt.delimiter;
+  copy_quote_ = copy_stmt.quote;
+  copy_escape_ = copy_stmt.escape;
+
+  if (copy_stmt.is_from) {
+    // Nothing runs until the client sends enough data to fill a chunk
+    copy_state_ = CopyState::COPY_IN;
+    copy_buffer_.clear();
+    copy_scan_pos_ = 0;
+    copy_in_quote_ = false;
+    copy_row_end_ = 0;
+    copy_done_ = false;
+    copy_rows_ = 0;
+    result_format_.clear();
+    SendCopyResponse(NetworkMessageType::COPY_IN_RESPONSE);
+    return ProcessResult::COMPLETE;
+  }
+
+  // Run the query below the export, the client gets its rows instead of a file
+  copy_state_ = CopyState::COPY_OUT;
+  std::shared_ptr<planner::AbstractPlan> query_plan(
+      plan, plan->GetChildren()[0].get());
+  result_format_ = std::vector<int>(copy_num_cols_, 0);
+  auto status = traffic_cop_->ExecuteHelper(
+      query_plan, traffic_cop_->GetParamVal(), traffic_cop_->GetResult(),
+      result_format_, thread_id);
+  if (traffic_cop_->GetQueuing()) {
+    return ProcessResult::PROCESSING;
+  }
+  ExecCopyOutGetResult(status.m_result);
+  return ProcessResult::COMPLETE;
+}
+
+ProcessResult PostgresProtocolHandler::ExecCopyDataMessage(
+    InputPacket *pkt, const size_t thread_id) {
+  // Data is dropped if no COPY is loading it, e.g. after a failed chunk
+  if (copy_state_ != CopyState::COPY_IN) {
+    return ProcessResult::COMPLETE;
+  }
+
+  copy_buffer_.append(pkt->Begin(), pkt->End());
+  if (copy_buffer_.size() < COPY_CHUNK_SIZE) {
+    return ProcessResult::COMPLETE;
+  }
+
+  // Load all complete rows, unless a single row is larger than a chunk
+  size_t row_end = FindCopyRowEnd();
+  if (row_end == 0) {
+    return ProcessResult::COMPLETE;
+  }
+  return LoadCopyChunk(row_end, thread_id);
+}
+
+ProcessResult PostgresProtocolHandler::ExecCopyDoneMessage(
+    const size_t thread_id) {
+  if (copy_state_ != CopyState::COPY_IN &&
+      copy_state_ != CopyState::COPY_IN_FAILED) {
+    return ProcessResult::COMPLETE;
+  }
+
+  // Load whatever is left, the last row may not have its newline
+  copy_done_ = true;
+  if (copy_state_ == CopyState::COPY_IN && !copy_buffer_.empty()) {
+    if (copy_buffer_.back() != '\n') {
+      copy_buffer_.push_back('\n');
+    }
+    return LoadCopyChunk(copy_buffer_.size(), thread_id);
+  }
+  CompleteCopyIn();
+  return ProcessResult::COMPLETE;
+}
+
+void PostgresProtocolHandler::ExecCopyFailMessage(InputPacket *pkt) {
+  if (copy_state_ != CopyState::COPY_IN &&
+      copy_state_ != CopyState::COPY_IN_FAILED) {
+    return;
+  }
+
+  std::string reason;
+  PacketGetString(pkt, pkt->len, reason);
+  if (copy_state_ == CopyState::COPY_IN) {
+    traffic_cop_->ProcessInvalidStatement();
+    SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                        "COPY from stdin failed: " + reason}});
+    copy_state_ = CopyState::COPY_IN_FAILED;
+  }
+  CompleteCopyIn();
+}
+
+ProcessResult PostgresProtocolHandler::LoadCopyChunk(size_t len,
+                                                     const size_t thread_id) {
+  // The rows are moved out of the buffer, so more data can be buffered while
+  // they load. A partial row at the end stays behind.
+  copy_chunk_.assign(copy_buffer_, 0, len);
+  copy_buffer_.erase(0, len);
+  copy_scan_pos_ = (copy_scan_pos_ > len ? copy_scan_pos_ - len : 0);
+  copy_row_end_ = 0;
+
+  auto status = traffic_cop_->ExecuteHelper(
+      traffic_cop_->GetStatement()->GetPlanTree(), traffic_cop_->GetParamVal(),
+      traffic_cop_->GetResult(), result_format_, thread_id, &copy_chunk_);
+  if (traffic_cop_->GetQueuing()) {
+    return ProcessResult::PROCESSING;
+  }
+  ExecCopyInGetResult(status.m_result);
+  return ProcessResult::COMPLETE;
+}
+
+size_t PostgresProtocolHandler::FindCopyRowEnd() {
+  // Newlines within quoted values do not end a row
+  const char quote = copy_quote_;
+  const char escape = (copy_quote_ == copy_escape_ ? '\0' : copy_escape_);
+
+  size_t pos = copy_scan_pos_;
+  for (; pos < copy_buffer_.size(); pos++) {
+    char c = copy_buffer_[pos];
+    if (copy_in_quote_ && escape != '\0' && c == escape) {
+      // Skip the escaped character
+      pos++;
+    } else if (c == quote) {
+      copy_in_quote_ = !copy_in_quote_;
+    } else if (c == '\n' && !copy_in_quote_) {
+      copy_row_end_ = pos + 1;
+    }
+  }
+  copy_scan_pos_ = pos;
+  return copy_row_end_;
+}
+
+void PostgresProtocolHandler::ExecCopyInGetResult(ResultType status) {
+  if (status == ResultType::SUCCESS) {
+    copy_rows_ += traffic_cop_->getRowsAffected();
+  } else if (copy_state_ == CopyState::COPY_IN) {
+    // Report the error right away, the rest of the data is ignored
+    std::string error_message = traffic_cop_->GetErrorMessage();
+    if (status == ResultType::TO_ABORT) {
+      error_message =
+          "current transaction is aborted, commands ignored until end of "
+          "transaction block";
+    } else if (error_message.empty()) {
+      error_message = "COPY from stdin failed";
+    }
+    SendErrorResponse(
+        {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
+    copy_state_ = CopyState::COPY_IN_FAILED;
+    copy_buffer_.clear();
+  }
+  copy_chunk_.clear();
+
+  if (copy_done_) {
+    CompleteCopyIn();
+  }
+}
+
+void PostgresProtocolHandler::CompleteCopyIn() {
+  if (copy_state_ == CopyState::COPY_IN) {
+    auto status = traffic_cop_->CommitCopyIn();
+    if (status == ResultType::SUCCESS) {
+      CompleteCommand(QueryType::QUERY_COPY, copy_rows_);
+    } else {
+      SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                          "COPY from stdin failed to commit"}});
+    }
+  }
+
+  // Release the buffers, a bulk load leaves them large
+  copy_state_ = CopyState::NONE;
+  std::string().swap(copy_buffer_);
+  std::string().swap(copy_chunk_);
+  SendReadyForQuery(NetworkTransactionStateType::IDLE);
+}
+
+void PostgresProtocolHandler::ExecCopyOutGetResult(ResultType status) {
+  copy_state_ = CopyState::NONE;
+  if (status == ResultType::SUCCESS) {
+    SendCopyResponse(NetworkMessageType::COPY_OUT_RESPONSE);
+    SendCopyData(traffic_cop_->GetResult(), copy_num_cols_);
+
+    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+    pkt->msg_type = NetworkMessageType::COPY_DONE;
+    responses_.push_back(std::move(pkt));
+
+    CompleteCommand(QueryType::QUERY_COPY, traffic_cop_->getRowsAffected());
+  } else {
+    SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                        traffic_cop_->GetErrorMessage()}});
+  }
+  SendReadyForQuery(NetworkTransactionStateType::IDLE);
+}
+
 /*
  * exec_parse_message - handle PARSE message
  */
@@ -860,8 +1076,18 @@ void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
 }
 
 void PostgresProtocolHandler::GetResult() {
+  // A chunk of COPY ... FROM STDIN does not end the statement
+  if (copy_state_ == CopyState::COPY_IN) {
+    ExecCopyInGetResult(traffic_cop_->ExecuteCopyChunkGetResult());
+    return;
+  }
+
   traffic_cop_->ExecuteStatementPlanGetResult();
   auto status = traffic_cop_->ExecuteStatementGetResult();
+  if (copy_state_ == CopyState::COPY_OUT) {
+    ExecCopyOutGetResult(status);
+    return;
+  }
   switch (protocol_type_) {
     case NetworkProtocolType::POSTGRES_JDBC:
       LOG_TRACE("JDBC result");
@@ -1095,6 +1321,20 @@ ProcessResult PostgresProtocolHandler::ProcessNormalPacket(
       LOG_TRACE("CLOSE_COMMAND");
       ExecCloseMessage(pkt);
     } break;
+    case NetworkMessageType::COPY_DATA: {
+      LOG_TRACE("COPY_DATA");
+      return ExecCopyDataMessage(pkt, thread_id);
+    }
+    case NetworkMessageType::COPY_DONE: {
+      LOG_TRACE("COPY_DONE");
+      SetFlushFlag(true);
+      return ExecCopyDoneMessage(thread_id);
+    }
+    case NetworkMessageType::COPY_FAIL: {
+      LOG_TRACE("COPY_FAIL");
+      SetFlushFlag(true);
+      ExecCopyFailMessage(pkt);
+    } break;
     case NetworkMessageType::TERMINATE_COMMAND: {
       LOG_TRACE("TERMINATE_COMMAND");
       SetFlushFlag(true);
@@ -1130,7 +1370,8 @@ void PostgresProtocolHandler::PutTupleDescriptor(
   pkt->msg_type = NetworkMessageType::ROW_DESCRIPTION;
   PacketPutInt(pkt.get(), tuple_descriptor.size(), 2);
 
-  for (auto col : tuple_descriptor) {
+  for (size_t i = 0; i < tuple_descriptor.size(); i++) {
+    const auto &col = tuple_descriptor[i];
     PacketPutStringWithTerminator(pkt.get(), std::get<0>(col));
     // TODO: Table Oid (int32)
     PacketPutInt(pkt.get(), 0, 4);
@@ -1142,8 +1383,9 @@ void PostgresProtocolHandler::PutTupleDescriptor(
     PacketPutInt(pkt.get(), std::get<2>(col), 2);
     // Type modifier (int32)
     PacketPutInt(pkt.get(), -1, 4);
-    // Format code for text
-    PacketPutInt(pkt.get(), 0, 2);
+    // Format code the column is sent in, as requested by Bind
+    PacketPutInt(pkt.get(),
+                 executor::ResultEncoder::GetFormat(result_format_, i), 2);
   }
   responses_.push_back(std::move(pkt));
 }
@@ -1154,13 +1396,31 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
 
   size_t numrows = results.size() / colcount;
 
-  // 1 packet per row
+  // Rows are framed here and packed back to back into large packets, so a
+  // row costs neither an allocation nor a separate header write
+  std::unique_ptr<OutputPacket> pkt;
   for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
-    pkt->msg_type = NetworkMessageType::DATA_ROW;
+    // Length of the message: itself, the column count and every column
+    size_t row_len = sizeof(int32_t) + sizeof(int16_t);
+    for (int j = 0; j < colcount; j++) {
+      row_len += sizeof(int32_t) + results[i * colcount + j].size();
+    }
+
+    if (pkt != nullptr && pkt->len + 1 + row_len > DATA_ROW_BATCH_SIZE) {
+      responses_.push_back(std::move(pkt));
+    }
+    if (pkt == nullptr) {
+      pkt.reset(new OutputPacket());
+      pkt->msg_type = NetworkMessageType::DATA_ROW;
+      pkt->skip_header_write = true;
+      pkt->buf.reserve(std::max<size_t>(DATA_ROW_BATCH_SIZE, row_len + 1));
+    }
+
+    PacketPutByte(pkt.get(), static_cast<uchar>(NetworkMessageType::DATA_ROW));
+    PacketPutInt(pkt.get(), row_len, 4);
     PacketPutInt(pkt.get(), colcount, 2);
     for (int j = 0; j < colcount; j++) {
-      auto content = results[i * colcount + j];
+      auto &content = results[i * colcount + j];
       if (content.size() == 0) {
         // content is NULL
         PacketPutInt(pkt.get(), NULL_CONTENT_SIZE, 4);
@@ -1172,8 +1432,70 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
         PacketPutString(pkt.get(), content);
       }
     }
-    responses_.push_back(std::move(pkt));
   }
+  responses_.push_back(std::move(pkt));
+  traffic_cop_->setRowsAffected(numrows);
+}
+
+void PostgresProtocolHandler::SendCopyResponse(NetworkMessageType type) {
+  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  pkt->msg_type = type;
+  // Overall format and the format of every column, all text
+  PacketPutByte(pkt.get(), 0);
+  PacketPutInt(pkt.get(), copy_num_cols_, 2);
+  for (int i = 0; i < copy_num_cols_; i++) {
+    PacketPutInt(pkt.get(), 0, 2);
+  }
+  responses_.push_back(std::move(pkt));
+}
+
+void PostgresProtocolHandler::SendCopyData(std::vector<ResultValue> &results,
+                                           int colcount) {
+  if (results.empty() || colcount == 0) return;
+
+  size_t numrows = results.size() / colcount;
+
+  // Values holding any of these are quoted
+  const char special[] = {copy_delimiter_, copy_quote_, copy_escape_, '\n',
+                          '\r', '\0'};
+
+  // Every row is one CopyData message, framed like the rows of SendDataRows()
+  std::string line;
+  std::unique_ptr<OutputPacket> pkt;
+  for (size_t i = 0; i < numrows; i++) {
+    line.clear();
+    for (int j = 0; j < colcount; j++) {
+      if (j > 0) line.push_back(copy_delimiter_);
+      auto &content = results[i * colcount + j];
+      if (content.find_first_of(special) == std::string::npos) {
+        line.append(content);
+        continue;
+      }
+      line.push_back(copy_quote_);
+      for (char c : content) {
+        if (c == copy_quote_ || c == copy_escape_) line.push_back(copy_escape_);
+        line.push_back(c);
+      }
+      line.push_back(copy_quote_);
+    }
+    line.push_back('\n');
+
+    size_t msg_len = sizeof(int32_t) + line.size();
+    if (pkt != nullptr && pkt->len + 1 + msg_len > DATA_ROW_BATCH_SIZE) {
+      responses_.push_back(std::move(pkt));
+    }
+    if (pkt == nullptr) {
+      pkt.reset(new OutputPacket());
+      pkt->msg_type = NetworkMessageType::COPY_DATA;
+      pkt->skip_header_write = true;
+      pkt->buf.reserve(std::max<size_t>(DATA_ROW_BATCH_SIZE, msg_len + 1));
+    }
+
+    PacketPutByte(pkt.get(), static_cast<uchar>(NetworkMessageType::COPY_DATA));
+    PacketPutInt(pkt.get(), msg_len, 4);
+    PacketPutString(pkt.get(), line);
+  }
+  responses_.push_back(std::move(pkt));
   traffic_cop_->setRowsAffected(numrows);
 }
 
@@ -1258,6 +1580,9 @@ void PostgresProtocolHandler::Reset() {
   skipped_stmt_ = false;
   skipped_query_string_.clear();
   portals_.clear();
+  copy_state_ = CopyState::NONE;
+  std::string().swap(copy_buffer_);
+  std::string().swap(copy_chunk_);
 }
 
 }  // namespace network
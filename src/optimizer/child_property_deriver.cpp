@@ -162,6 +162,12 @@ void ChildPropertyDeriver::Visit(const PhysicalInnerNLJoin *) {
 void ChildPropertyDeriver::Visit(const PhysicalLeftNLJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalRightNLJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalOuterNLJoin *) {}
+void ChildPropertyDeriver::Visit(const PhysicalSemiNLJoin *) {
+  DeriveForSemiOrAntiJoin();
+}
+void ChildPropertyDeriver::Visit(const PhysicalAntiNLJoin *) {
+  DeriveForSemiOrAntiJoin();
+}
 void ChildPropertyDeriver::Visit(const PhysicalInnerHashJoin *) {
   DeriveForJoin();
 }
@@ -169,6 +175,12 @@ void ChildPropertyDeriver::Visit(const PhysicalInnerHashJoin *) {
 void ChildPropertyDeriver::Visit(const PhysicalLeftHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalRightHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalOuterHashJoin *) {}
+void ChildPropertyDeriver::Visit(const PhysicalSemiHashJoin *) {
+  DeriveForSemiOrAntiJoin();
+}
+void ChildPropertyDeriver::Visit(const PhysicalAntiHashJoin *) {
+  DeriveForSemiOrAntiJoin();
+}
 void ChildPropertyDeriver::Visit(const PhysicalInsert *) {
   vector<shared_ptr<PropertySet>> child_input_properties;
 
@@ -246,5 +258,13 @@ void ChildPropertyDeriver::DeriveForJoin() {
     }
   }
 }
+
+void ChildPropertyDeriver::DeriveForSemiOrAntiJoin() {
+  // The join produces its rows once the probe is done, in the order of the
+  // hash table, so it can't provide any property
+  output_.push_back(make_pair(
+      make_shared<PropertySet>(),
+      vector<shared_ptr<PropertySet>>(2, make_shared<PropertySet>())));
+}
 }  // namespace optimizer
 }  // namespace peloton
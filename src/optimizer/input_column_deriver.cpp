@@ -157,6 +157,14 @@ void InputColumnDeriver::Visit(const PhysicalRightNLJoin *) {}
 
 void InputColumnDeriver::Visit(const PhysicalOuterNLJoin *) {}
 
+void InputColumnDeriver::Visit(const PhysicalSemiNLJoin *op) {
+  JoinHelper(op);
+}
+
+void InputColumnDeriver::Visit(const PhysicalAntiNLJoin *op) {
+  JoinHelper(op);
+}
+
 void InputColumnDeriver::Visit(const PhysicalInnerHashJoin *op) {
   JoinHelper(op);
 }
@@ -167,6 +175,14 @@ void InputColumnDeriver::Visit(const PhysicalRightHashJoin *) {}
 
 void InputColumnDeriver::Visit(const PhysicalOuterHashJoin *) {}
 
+void InputColumnDeriver::Visit(const PhysicalSemiHashJoin *op) {
+  JoinHelper(op);
+}
+
+void InputColumnDeriver::Visit(const PhysicalAntiHashJoin *op) {
+  JoinHelper(op);
+}
+
 void InputColumnDeriver::Visit(const PhysicalInsert *) {
   output_input_cols_ =
       pair<vector<AbstractExpression *>, vector<vector<AbstractExpression *>>>{
@@ -284,6 +300,26 @@ void InputColumnDeriver::JoinHelper(const BaseOperatorNode *op) {
     join_conds = &(join_op->join_predicates);
     left_keys = &(join_op->left_keys);
     right_keys = &(join_op->right_keys);
+  } else if (op->GetType() == OpType::SemiNLJoin) {
+    auto join_op = reinterpret_cast<const PhysicalSemiNLJoin *>(op);
+    join_conds = &(join_op->join_predicates);
+    left_keys = &(join_op->left_keys);
+    right_keys = &(join_op->right_keys);
+  } else if (op->GetType() == OpType::AntiNLJoin) {
+    auto join_op = reinterpret_cast<const PhysicalAntiNLJoin *>(op);
+    join_conds = &(join_op->join_predicates);
+    left_keys = &(join_op->left_keys);
+    right_keys = &(join_op->right_keys);
+  } else if (op->GetType() == OpType::SemiHashJoin) {
+    auto join_op = reinterpret_cast<const PhysicalSemiHashJoin *>(op);
+    join_conds = &(join_op->join_predicates);
+    left_keys = &(join_op->left_keys);
+    right_keys = &(join_op->right_keys);
+  } else if (op->GetType() == OpType::AntiHashJoin) {
+    auto join_op = reinterpret_cast<const PhysicalAntiHashJoin *>(op);
+    join_conds = &(join_op->join_predicates);
+    left_keys = &(join_op->left_keys);
+    right_keys = &(join_op->right_keys);
   }
 
   ExprSet input_cols_set;
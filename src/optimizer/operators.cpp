@@ -334,15 +334,77 @@ Operator LogicalOuterJoin::make(expression::AbstractExpression *condition) {
 }
 
 //===--------------------------------------------------------------------===//
-// OuterJoin
+// SemiJoin
 //===--------------------------------------------------------------------===//
-Operator LogicalSemiJoin::make(expression::AbstractExpression *condition) {
+Operator LogicalSemiJoin::make() {
   LogicalSemiJoin *join = new LogicalSemiJoin;
-  join->join_predicate =
-      std::shared_ptr<expression::AbstractExpression>(condition);
+  join->join_predicates = {};
+  return Operator(join);
+}
+
+Operator LogicalSemiJoin::make(std::vector<AnnotatedExpression> &conditions) {
+  LogicalSemiJoin *join = new LogicalSemiJoin;
+  join->join_predicates = std::move(conditions);
   return Operator(join);
 }
 
+hash_t LogicalSemiJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return hash;
+}
+
+bool LogicalSemiJoin::operator==(const BaseOperatorNode &r) {
+  if (r.GetType() != OpType::SemiJoin) return false;
+  const LogicalSemiJoin &node = *static_cast<const LogicalSemiJoin *>(&r);
+  if (join_predicates.size() != node.join_predicates.size()) return false;
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->ExactlyEquals(
+            *node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// AntiJoin
+//===--------------------------------------------------------------------===//
+Operator LogicalAntiJoin::make(bool null_aware) {
+  LogicalAntiJoin *join = new LogicalAntiJoin;
+  join->join_predicates = {};
+  join->null_aware = null_aware;
+  return Operator(join);
+}
+
+Operator LogicalAntiJoin::make(std::vector<AnnotatedExpression> &conditions,
+                               bool null_aware) {
+  LogicalAntiJoin *join = new LogicalAntiJoin;
+  join->join_predicates = std::move(conditions);
+  join->null_aware = null_aware;
+  return Operator(join);
+}
+
+hash_t LogicalAntiJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return HashUtil::CombineHashes(hash, HashUtil::Hash(&null_aware));
+}
+
+bool LogicalAntiJoin::operator==(const BaseOperatorNode &r) {
+  if (r.GetType() != OpType::AntiJoin) return false;
+  const LogicalAntiJoin &node = *static_cast<const LogicalAntiJoin *>(&r);
+  if (null_aware != node.null_aware) return false;
+  if (join_predicates.size() != node.join_predicates.size()) return false;
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->ExactlyEquals(
+            *node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Aggregate
 //===--------------------------------------------------------------------===//
@@ -751,6 +813,100 @@ Operator PhysicalOuterNLJoin::make(
   return Operator(join);
 }
 
+//===--------------------------------------------------------------------===//
+// SemiNLJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalSemiNLJoin::make(
+    std::vector<AnnotatedExpression> conditions,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys) {
+  PhysicalSemiNLJoin *join = new PhysicalSemiNLJoin();
+  join->join_predicates = std::move(conditions);
+  join->left_keys = std::move(left_keys);
+  join->right_keys = std::move(right_keys);
+  return Operator(join);
+}
+
+hash_t PhysicalSemiNLJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &expr : left_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &expr : right_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return hash;
+}
+
+bool PhysicalSemiNLJoin::operator==(const BaseOperatorNode &r) {
+  if (r.GetType() != OpType::SemiNLJoin) return false;
+  const PhysicalSemiNLJoin &node =
+      *static_cast<const PhysicalSemiNLJoin *>(&r);
+  if (join_predicates.size() != node.join_predicates.size() ||
+      left_keys.size() != node.left_keys.size() ||
+      right_keys.size() != node.right_keys.size())
+    return false;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (!left_keys[i]->ExactlyEquals(*node.left_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < right_keys.size(); i++) {
+    if (!right_keys[i]->ExactlyEquals(*node.right_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->ExactlyEquals(
+            *node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// AntiNLJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalAntiNLJoin::make(
+    std::vector<AnnotatedExpression> conditions,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys) {
+  PhysicalAntiNLJoin *join = new PhysicalAntiNLJoin();
+  join->join_predicates = std::move(conditions);
+  join->left_keys = std::move(left_keys);
+  join->right_keys = std::move(right_keys);
+  return Operator(join);
+}
+
+hash_t PhysicalAntiNLJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &expr : left_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &expr : right_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return hash;
+}
+
+bool PhysicalAntiNLJoin::operator==(const BaseOperatorNode &r) {
+  if (r.GetType() != OpType::AntiNLJoin) return false;
+  const PhysicalAntiNLJoin &node =
+      *static_cast<const PhysicalAntiNLJoin *>(&r);
+  if (join_predicates.size() != node.join_predicates.size() ||
+      left_keys.size() != node.left_keys.size() ||
+      right_keys.size() != node.right_keys.size())
+    return false;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (!left_keys[i]->ExactlyEquals(*node.left_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < right_keys.size(); i++) {
+    if (!right_keys[i]->ExactlyEquals(*node.right_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->ExactlyEquals(
+            *node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // InnerHashJoin
 //===--------------------------------------------------------------------===//
@@ -828,6 +984,103 @@ Operator PhysicalOuterHashJoin::make(
   return Operator(join);
 }
 
+//===--------------------------------------------------------------------===//
+// SemiHashJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalSemiHashJoin::make(
+    std::vector<AnnotatedExpression> conditions,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys) {
+  PhysicalSemiHashJoin *join = new PhysicalSemiHashJoin();
+  join->join_predicates = std::move(conditions);
+  join->left_keys = std::move(left_keys);
+  join->right_keys = std::move(right_keys);
+  return Operator(join);
+}
+
+hash_t PhysicalSemiHashJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &expr : left_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &expr : right_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return hash;
+}
+
+bool PhysicalSemiHashJoin::operator==(const BaseOperatorNode &r) {
+  if (r.GetType() != OpType::SemiHashJoin) return false;
+  const PhysicalSemiHashJoin &node =
+      *static_cast<const PhysicalSemiHashJoin *>(&r);
+  if (join_predicates.size() != node.join_predicates.size() ||
+      left_keys.size() != node.left_keys.size() ||
+      right_keys.size() != node.right_keys.size())
+    return false;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (!left_keys[i]->ExactlyEquals(*node.left_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < right_keys.size(); i++) {
+    if (!right_keys[i]->ExactlyEquals(*node.right_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->ExactlyEquals(
+            *node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// AntiHashJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalAntiHashJoin::make(
+    std::vector<AnnotatedExpression> conditions,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys,
+    bool null_aware) {
+  PhysicalAntiHashJoin *join = new PhysicalAntiHashJoin();
+  join->join_predicates = std::move(conditions);
+  join->left_keys = std::move(left_keys);
+  join->right_keys = std::move(right_keys);
+  join->null_aware = null_aware;
+  return Operator(join);
+}
+
+hash_t PhysicalAntiHashJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &expr : left_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &expr : right_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return HashUtil::CombineHashes(hash, HashUtil::Hash(&null_aware));
+}
+
+bool PhysicalAntiHashJoin::operator==(const BaseOperatorNode &r) {
+  if (r.GetType() != OpType::AntiHashJoin) return false;
+  const PhysicalAntiHashJoin &node =
+      *static_cast<const PhysicalAntiHashJoin *>(&r);
+  if (null_aware != node.null_aware) return false;
+  if (join_predicates.size() != node.join_predicates.size() ||
+      left_keys.size() != node.left_keys.size() ||
+      right_keys.size() != node.right_keys.size())
+    return false;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (!left_keys[i]->ExactlyEquals(*node.left_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < right_keys.size(); i++) {
+    if (!right_keys[i]->ExactlyEquals(*node.right_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->ExactlyEquals(
+            *node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // PhysicalInsert
 //===--------------------------------------------------------------------===//
@@ -1027,6 +1280,8 @@ std::string OperatorNode<LogicalOuterJoin>::name_ = "LogicalOuterJoin";
 template <>
 std::string OperatorNode<LogicalSemiJoin>::name_ = "LogicalSemiJoin";
 template <>
+std::string OperatorNode<LogicalAntiJoin>::name_ = "LogicalAntiJoin";
+template <>
 std::string OperatorNode<LogicalAggregateAndGroupBy>::name_ =
     "LogicalAggregateAndGroupBy";
 template <>
@@ -1067,6 +1322,10 @@ std::string OperatorNode<PhysicalRightNLJoin>::name_ = "PhysicalRightNLJoin";
 template <>
 std::string OperatorNode<PhysicalOuterNLJoin>::name_ = "PhysicalOuterNLJoin";
 template <>
+std::string OperatorNode<PhysicalSemiNLJoin>::name_ = "PhysicalSemiNLJoin";
+template <>
+std::string OperatorNode<PhysicalAntiNLJoin>::name_ = "PhysicalAntiNLJoin";
+template <>
 std::string OperatorNode<PhysicalInnerHashJoin>::name_ =
     "PhysicalInnerHashJoin";
 template <>
@@ -1078,6 +1337,10 @@ template <>
 std::string OperatorNode<PhysicalOuterHashJoin>::name_ =
     "PhysicalOuterHashJoin";
 template <>
+std::string OperatorNode<PhysicalSemiHashJoin>::name_ = "PhysicalSemiHashJoin";
+template <>
+std::string OperatorNode<PhysicalAntiHashJoin>::name_ = "PhysicalAntiHashJoin";
+template <>
 std::string OperatorNode<PhysicalInsert>::name_ = "PhysicalInsert";
 template <>
 std::string OperatorNode<PhysicalInsertSelect>::name_ = "PhysicalInsertSelect";
@@ -1129,6 +1392,8 @@ OpType OperatorNode<LogicalOuterJoin>::type_ = OpType::OuterJoin;
 template <>
 OpType OperatorNode<LogicalSemiJoin>::type_ = OpType::SemiJoin;
 template <>
+OpType OperatorNode<LogicalAntiJoin>::type_ = OpType::AntiJoin;
+template <>
 OpType OperatorNode<LogicalAggregateAndGroupBy>::type_ =
     OpType::LogicalAggregateAndGroupBy;
 template <>
@@ -1172,6 +1437,10 @@ OpType OperatorNode<PhysicalRightNLJoin>::type_ = OpType::RightNLJoin;
 template <>
 OpType OperatorNode<PhysicalOuterNLJoin>::type_ = OpType::OuterNLJoin;
 template <>
+OpType OperatorNode<PhysicalSemiNLJoin>::type_ = OpType::SemiNLJoin;
+template <>
+OpType OperatorNode<PhysicalAntiNLJoin>::type_ = OpType::AntiNLJoin;
+template <>
 OpType OperatorNode<PhysicalInnerHashJoin>::type_ = OpType::InnerHashJoin;
 template <>
 OpType OperatorNode<PhysicalLeftHashJoin>::type_ = OpType::LeftHashJoin;
@@ -1180,6 +1449,10 @@ OpType OperatorNode<PhysicalRightHashJoin>::type_ = OpType::RightHashJoin;
 template <>
 OpType OperatorNode<PhysicalOuterHashJoin>::type_ = OpType::OuterHashJoin;
 template <>
+OpType OperatorNode<PhysicalSemiHashJoin>::type_ = OpType::SemiHashJoin;
+template <>
+OpType OperatorNode<PhysicalAntiHashJoin>::type_ = OpType::AntiHashJoin;
+template <>
 OpType OperatorNode<PhysicalInsert>::type_ = OpType::Insert;
 template <>
 OpType OperatorNode<PhysicalInsertSelect>::type_ = OpType::InsertSelect;
@@ -249,38 +249,8 @@ void PlanGenerator::Visit(const PhysicalDistinct *) {
 }
 
 void PlanGenerator::Visit(const PhysicalInnerNLJoin *op) {
-  std::unique_ptr<const planner::ProjectInfo> proj_info;
-  std::shared_ptr<const catalog::Schema> proj_schema;
-  GenerateProjectionForJoin(proj_info, proj_schema);
-
-  auto join_predicate =
-      expression::ExpressionUtil::JoinAnnotatedExprs(op->join_predicates);
-  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
-                                                 join_predicate.get());
-  expression::ExpressionUtil::ConvertToTvExpr(join_predicate.get(),
-                                              children_expr_map_);
-
-  vector<oid_t> left_keys;
-  vector<oid_t> right_keys;
-  for (auto &expr : op->left_keys) {
-    PELOTON_ASSERT(children_expr_map_[0].find(expr.get()) !=
-                   children_expr_map_[0].end());
-    left_keys.push_back(children_expr_map_[0][expr.get()]);
-  }
-  for (auto &expr : op->right_keys) {
-    PELOTON_ASSERT(children_expr_map_[1].find(expr.get()) !=
-                   children_expr_map_[1].end());
-    right_keys.emplace_back(children_expr_map_[1][expr.get()]);
-  }
-
-  auto join_plan =
-      unique_ptr<planner::AbstractPlan>(new planner::NestedLoopJoinPlan(
-          JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
-          left_keys, right_keys));
-
-  join_plan->AddChild(move(children_plans_[0]));
-  join_plan->AddChild(move(children_plans_[1]));
-  output_plan_ = move(join_plan);
+  BuildNestedLoopJoinPlan(JoinType::INNER, op->join_predicates, op->left_keys,
+                          op->right_keys);
 }
 
 void PlanGenerator::Visit(const PhysicalLeftNLJoin *) {}
@@ -289,51 +259,29 @@ void PlanGenerator::Visit(const PhysicalRightNLJoin *) {}
 
 void PlanGenerator::Visit(const PhysicalOuterNLJoin *) {}
 
-void PlanGenerator::Visit(const PhysicalInnerHashJoin *op) {
-  std::unique_ptr<const planner::ProjectInfo> proj_info;
-  std::shared_ptr<const catalog::Schema> proj_schema;
-  GenerateProjectionForJoin(proj_info, proj_schema);
-
-  auto join_predicate =
-      expression::ExpressionUtil::JoinAnnotatedExprs(op->join_predicates);
-  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
-                                                 join_predicate.get());
-  expression::ExpressionUtil::ConvertToTvExpr(join_predicate.get(),
-                                              children_expr_map_);
+void PlanGenerator::Visit(const PhysicalSemiNLJoin *op) {
+  BuildNestedLoopJoinPlan(JoinType::SEMI, op->join_predicates, op->left_keys,
+                          op->right_keys);
+}
 
-  vector<unique_ptr<const expression::AbstractExpression>> left_keys;
-  vector<unique_ptr<const expression::AbstractExpression>> right_keys;
-  vector<ExprMap> l_child_map{move(children_expr_map_[0])};
-  vector<ExprMap> r_child_map{move(children_expr_map_[1])};
-  for (auto &expr : op->left_keys) {
-    auto left_key = expr->Copy();
-    expression::ExpressionUtil::EvaluateExpression(l_child_map, left_key);
-    left_keys.emplace_back(left_key);
-  }
-  for (auto &expr : op->right_keys) {
-    auto right_key = expr->Copy();
-    expression::ExpressionUtil::EvaluateExpression(r_child_map, right_key);
-    right_keys.emplace_back(right_key);
-  }
-  // Evaluate Expr for hash plan
-  vector<unique_ptr<const expression::AbstractExpression>> hash_keys;
-  for (auto &expr : op->right_keys) {
-    auto hash_key = expr->Copy();
-    expression::ExpressionUtil::EvaluateExpression(r_child_map, hash_key);
-    hash_keys.emplace_back(hash_key);
-  }
+void PlanGenerator::Visit(const PhysicalAntiNLJoin *op) {
+  BuildNestedLoopJoinPlan(JoinType::ANTI, op->join_predicates, op->left_keys,
+                          op->right_keys);
+}
 
-  unique_ptr<planner::HashPlan> hash_plan(new planner::HashPlan(hash_keys));
-  hash_plan->AddChild(move(children_plans_[1]));
+void PlanGenerator::Visit(const PhysicalInnerHashJoin *op) {
+  BuildHashJoinPlan(JoinType::INNER, false, op->join_predicates, op->left_keys,
+                    op->right_keys);
+}
 
-  auto join_plan = unique_ptr<planner::AbstractPlan>(new planner::HashJoinPlan(
-      JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
-      left_keys, right_keys, settings::SettingsManager::GetBool(
-                                 settings::SettingId::hash_join_bloom_filter)));
+void PlanGenerator::Visit(const PhysicalSemiHashJoin *op) {
+  BuildHashJoinPlan(JoinType::SEMI, false, op->join_predicates, op->left_keys,
+                    op->right_keys);
+}
 
-  join_plan->AddChild(move(children_plans_[0]));
-  join_plan->AddChild(move(hash_plan));
-  output_plan_ = move(join_plan);
+void PlanGenerator::Visit(const PhysicalAntiHashJoin *op) {
+  BuildHashJoinPlan(JoinType::ANTI, op->null_aware, op->join_predicates,
+                    op->left_keys, op->right_keys);
 }
 
 void PlanGenerator::Visit(const PhysicalLeftHashJoin *) {}
@@ -484,6 +432,97 @@ PlanGenerator::GeneratePredicateForScan(
   return predicate;
 }
 
+void PlanGenerator::BuildNestedLoopJoinPlan(
+    JoinType join_type, const vector<AnnotatedExpression> &join_predicates,
+    const vector<unique_ptr<expression::AbstractExpression>> &left_keys,
+    const vector<unique_ptr<expression::AbstractExpression>> &right_keys) {
+  std::unique_ptr<const planner::ProjectInfo> proj_info;
+  std::shared_ptr<const catalog::Schema> proj_schema;
+  GenerateProjectionForJoin(proj_info, proj_schema);
+
+  auto join_predicate =
+      expression::ExpressionUtil::JoinAnnotatedExprs(join_predicates);
+  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                 join_predicate.get());
+  expression::ExpressionUtil::ConvertToTvExpr(join_predicate.get(),
+                                              children_expr_map_);
+
+  vector<oid_t> left_key_ids;
+  vector<oid_t> right_key_ids;
+  for (auto &expr : left_keys) {
+    PELOTON_ASSERT(children_expr_map_[0].find(expr.get()) !=
+                   children_expr_map_[0].end());
+    left_key_ids.push_back(children_expr_map_[0][expr.get()]);
+  }
+  for (auto &expr : right_keys) {
+    PELOTON_ASSERT(children_expr_map_[1].find(expr.get()) !=
+                   children_expr_map_[1].end());
+    right_key_ids.emplace_back(children_expr_map_[1][expr.get()]);
+  }
+
+  auto join_plan =
+      unique_ptr<planner::AbstractPlan>(new planner::NestedLoopJoinPlan(
+          join_type, move(join_predicate), move(proj_info), proj_schema,
+          left_key_ids, right_key_ids));
+
+  join_plan->AddChild(move(children_plans_[0]));
+  join_plan->AddChild(move(children_plans_[1]));
+  output_plan_ = move(join_plan);
+}
+
+void PlanGenerator::BuildHashJoinPlan(
+    JoinType join_type, bool null_aware,
+    const vector<AnnotatedExpression> &join_predicates,
+    const vector<unique_ptr<expression::AbstractExpression>> &left_keys,
+    const vector<unique_ptr<expression::AbstractExpression>> &right_keys) {
+  std::unique_ptr<const planner::ProjectInfo> proj_info;
+  std::shared_ptr<const catalog::Schema> proj_schema;
+  GenerateProjectionForJoin(proj_info, proj_schema);
+
+  auto join_predicate =
+      expression::ExpressionUtil::JoinAnnotatedExprs(join_predicates);
+  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                 join_predicate.get());
+  expression::ExpressionUtil::ConvertToTvExpr(join_predicate.get(),
+                                              children_expr_map_);
+
+  vector<unique_ptr<const expression::AbstractExpression>> plan_left_keys;
+  vector<unique_ptr<const expression::AbstractExpression>> plan_right_keys;
+  vector<ExprMap> l_child_map{move(children_expr_map_[0])};
+  vector<ExprMap> r_child_map{move(children_expr_map_[1])};
+  for (auto &expr : left_keys) {
+    auto left_key = expr->Copy();
+    expression::ExpressionUtil::EvaluateExpression(l_child_map, left_key);
+    plan_left_keys.emplace_back(left_key);
+  }
+  for (auto &expr : right_keys) {
+    auto right_key = expr->Copy();
+    expression::ExpressionUtil::EvaluateExpression(r_child_map, right_key);
+    plan_right_keys.emplace_back(right_key);
+  }
+  // Evaluate Expr for hash plan
+  vector<unique_ptr<const expression::AbstractExpression>> hash_keys;
+  for (auto &expr : right_keys) {
+    auto hash_key = expr->Copy();
+    expression::ExpressionUtil::EvaluateExpression(r_child_map, hash_key);
+    hash_keys.emplace_back(hash_key);
+  }
+
+  unique_ptr<planner::HashPlan> hash_plan(new planner::HashPlan(hash_keys));
+  hash_plan->AddChild(move(children_plans_[1]));
+
+  auto join_plan = unique_ptr<planner::HashJoinPlan>(new planner::HashJoinPlan(
+      join_type, move(join_predicate), move(proj_info), proj_schema,
+      plan_left_keys, plan_right_keys,
+      settings::SettingsManager::GetBool(
+          settings::SettingId::hash_join_bloom_filter)));
+  join_plan->SetNullAware(null_aware);
+
+  join_plan->AddChild(move(children_plans_[0]));
+  join_plan->AddChild(move(hash_plan));
+  output_plan_ = move(join_plan);
+}
+
 void PlanGenerator::BuildProjectionPlan() {
   if (output_cols_ == required_cols_) {
     return;
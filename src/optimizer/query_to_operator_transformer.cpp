@@ -146,6 +146,8 @@ void QueryToOperatorTransformer::Visit(parser::JoinDefinition *node) {
   switch (node->type) {
     case JoinType::INNER: {
       predicates_ = CollectPredicates(node->condition.get(), predicates_);
+      // Sub-queries in the condition are joined with the right child
+      right_expr = output_expr_;
       join_expr =
           std::make_shared<OperatorExpression>(LogicalInnerJoin::make());
       break;
@@ -166,8 +168,9 @@ void QueryToOperatorTransformer::Visit(parser::JoinDefinition *node) {
       break;
     }
     case JoinType::SEMI: {
+      auto join_predicates = util::ExtractPredicates(node->condition.get());
       join_expr = std::make_shared<OperatorExpression>(
-          LogicalSemiJoin::make(node->condition->Copy()));
+          LogicalSemiJoin::make(join_predicates));
       break;
     }
     default:
@@ -413,14 +416,7 @@ void QueryToOperatorTransformer::Visit(
 
 void QueryToOperatorTransformer::Visit(expression::ComparisonExpression *expr) {
   auto expr_type = expr->GetExpressionType();
-  if (expr->GetExpressionType() == ExpressionType::COMPARE_IN) {
-    if (GenerateSubquerytree(expr, 1)) {
-      // TODO(boweic): Should use IN to preserve the semantic, for now we do not
-      // have semi-join so use = to transform into inner join
-      expr->SetExpressionType(ExpressionType::COMPARE_EQUAL);
-    }
-
-  } else if (expr_type == ExpressionType::COMPARE_EQUAL ||
+  if (expr_type == ExpressionType::COMPARE_EQUAL ||
              expr_type == ExpressionType::COMPARE_GREATERTHAN ||
              expr_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO ||
              expr_type == ExpressionType::COMPARE_LESSTHAN ||
@@ -438,15 +434,8 @@ void QueryToOperatorTransformer::Visit(expression::ComparisonExpression *expr) {
 }
 
 void QueryToOperatorTransformer::Visit(expression::OperatorExpression *expr) {
-  // TODO(boweic): We may want to do the rewrite (exist -> in) in the binder
-  if (expr->GetExpressionType() == ExpressionType::OPERATOR_EXISTS) {
-    if (GenerateSubquerytree(expr, 0)) {
-      // Already reset the child to column, we need to transform exist to
-      // not-null to preserve semantic
-      expr->SetExpressionType(ExpressionType::OPERATOR_IS_NOT_NULL);
-    }
-  }
-
+  // IN and EXISTS with a sub-query are only supported as conjunctive
+  // predicates, which are turned into semi and anti joins before we get here
   expr->AcceptChildren(this);
 }
 
@@ -491,11 +480,18 @@ std::vector<AnnotatedExpression> QueryToOperatorTransformer::CollectPredicates(
       throw Exception("Predicate type not supported yet");
     }
   }
-  // Accept will change the expression, e.g. (a in (select b from test)) into
-  // (a IN test.b), after the rewrite, we can extract the table aliases
-  // information correctly
-  expr->Accept(this);
-  return util::ExtractPredicates(expr, predicates);
+  for (const auto &pred : predicate_ptrs) {
+    // IN, EXISTS and their negations join the sub-query directly
+    if (GenerateSemiOrAntiJoin(pred)) {
+      continue;
+    }
+    // Accept will change the expression, e.g. (a = (select b from test)) into
+    // (a = test.b), after the rewrite, we can extract the table aliases
+    // information correctly
+    pred->Accept(this);
+    predicates = util::ExtractPredicates(pred, predicates);
+  }
+  return predicates;
 }
 
 bool QueryToOperatorTransformer::IsSupportedConjunctivePredicate(
@@ -519,6 +515,13 @@ bool QueryToOperatorTransformer::IsSupportedConjunctivePredicate(
       expr->GetChild(0)->GetExpressionType() == ExpressionType::ROW_SUBQUERY) {
     return true;
   }
+  // Subquery with NOT IN or NOT EXIST
+  if (expr_type == ExpressionType::OPERATOR_NOT) {
+    auto child_type = expr->GetChild(0)->GetExpressionType();
+    return (child_type == ExpressionType::COMPARE_IN ||
+            child_type == ExpressionType::OPERATOR_EXISTS) &&
+           IsSupportedConjunctivePredicate(expr->GetModifiableChild(0));
+  }
   // Subquery with other operator
   if (expr_type == ExpressionType::COMPARE_EQUAL ||
       expr_type == ExpressionType::COMPARE_GREATERTHAN ||
@@ -576,6 +579,83 @@ bool QueryToOperatorTransformer::IsSupportedSubSelect(
   return true;
 }
 
+bool QueryToOperatorTransformer::GenerateSemiOrAntiJoin(
+    expression::AbstractExpression *expr) {
+  bool negated = expr->GetExpressionType() == ExpressionType::OPERATOR_NOT;
+  auto pred = negated ? expr->GetModifiableChild(0) : expr;
+  auto pred_type = pred->GetExpressionType();
+  oid_t child_id;
+  if (pred_type == ExpressionType::COMPARE_IN) {
+    child_id = 1;
+  } else if (pred_type == ExpressionType::OPERATOR_EXISTS) {
+    child_id = 0;
+  } else {
+    return false;
+  }
+  auto subquery_expr = pred->GetChild(child_id);
+  if (subquery_expr->GetExpressionType() != ExpressionType::ROW_SUBQUERY) {
+    return false;
+  }
+  auto sub_select =
+      static_cast<const expression::SubqueryExpression *>(subquery_expr)
+          ->GetSubSelect()
+          .get();
+  if (!IsSupportedSubSelect(sub_select)) {
+    throw Exception("Sub-select not supported");
+  }
+  // We only support subselect with single row
+  if (sub_select->select_list.size() != 1) {
+    throw Exception("Array in predicates not supported");
+  }
+
+  // NOT IN is false for every row once the sub-query produces a NULL, so the
+  // anti join has to see all of the sub-query's output at once. We only
+  // support it when it can be implemented with a NULL-aware hash join.
+  bool null_aware = negated && pred_type == ExpressionType::COMPARE_IN;
+  if (null_aware) {
+    auto select_col = sub_select->select_list.at(0).get();
+    auto where_depth = sub_select->where_clause == nullptr
+                           ? -1
+                           : sub_select->where_clause->GetDepth();
+    bool correlated = (where_depth >= 0 && where_depth < sub_select->depth) ||
+                      (select_col->GetDepth() >= 0 &&
+                       select_col->GetDepth() < sub_select->depth);
+    if (correlated ||
+        pred->GetChild(0)->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+        select_col->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      throw Exception(
+          "NOT IN is only supported between a column and an uncorrelated "
+          "sub-select of a single column");
+    }
+  }
+
+  auto left_expr = output_expr_;
+  sub_select->Accept(this);
+  auto right_expr = output_expr_;
+
+  // IN compares against the column selected in the sub-select, EXISTS only
+  // requires the sub-select to produce a row
+  std::vector<AnnotatedExpression> join_predicates;
+  if (pred_type == ExpressionType::COMPARE_IN) {
+    pred->SetChild(child_id, sub_select->select_list.at(0)->Copy());
+    pred->SetExpressionType(ExpressionType::COMPARE_EQUAL);
+    join_predicates = util::ExtractPredicates(pred);
+  }
+
+  std::shared_ptr<OperatorExpression> join_expr;
+  if (negated) {
+    join_expr = std::make_shared<OperatorExpression>(
+        LogicalAntiJoin::make(join_predicates, null_aware));
+  } else {
+    join_expr = std::make_shared<OperatorExpression>(
+        LogicalSemiJoin::make(join_predicates));
+  }
+  join_expr->PushChild(left_expr);
+  join_expr->PushChild(right_expr);
+  output_expr_ = join_expr;
+  return true;
+}
+
 bool QueryToOperatorTransformer::GenerateSubquerytree(
     expression::AbstractExpression *expr, oid_t child_id, bool single_join) {
   // Get potential subquery
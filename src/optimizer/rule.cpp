@@ -43,12 +43,20 @@ RuleSet::RuleSet() {
   AddImplementationRule(new LogicalQueryDerivedGetToPhysical());
   AddImplementationRule(new InnerJoinToInnerNLJoin());
   AddImplementationRule(new InnerJoinToInnerHashJoin());
+  AddImplementationRule(new SemiJoinToSemiHashJoin());
+  AddImplementationRule(new AntiJoinToAntiHashJoin());
+  AddImplementationRule(new SemiJoinToSemiNLJoin());
+  AddImplementationRule(new AntiJoinToAntiNLJoin());
   AddImplementationRule(new ImplementDistinct());
   AddImplementationRule(new ImplementLimit());
   AddImplementationRule(new LogicalExportToPhysicalExport());
 
   AddRewriteRule(RewriteRuleSetName::PREDICATE_PUSH_DOWN,
                  new PushFilterThroughJoin());
+  AddRewriteRule(RewriteRuleSetName::PREDICATE_PUSH_DOWN,
+                 new PushFilterThroughSemiJoin());
+  AddRewriteRule(RewriteRuleSetName::PREDICATE_PUSH_DOWN,
+                 new PushFilterThroughAntiJoin());
   AddRewriteRule(RewriteRuleSetName::PREDICATE_PUSH_DOWN,
                  new PushFilterThroughAggregation());
   AddRewriteRule(RewriteRuleSetName::PREDICATE_PUSH_DOWN,
@@ -62,6 +70,10 @@ RuleSet::RuleSet() {
                  new MarkJoinToInnerJoin());
   AddRewriteRule(RewriteRuleSetName::UNNEST_SUBQUERY,
                  new PullFilterThroughAggregation());
+  AddRewriteRule(RewriteRuleSetName::UNNEST_SUBQUERY,
+                 new PullFilterThroughSemiJoin());
+  AddRewriteRule(RewriteRuleSetName::UNNEST_SUBQUERY,
+                 new PullFilterThroughAntiJoin());
 }
 
 }  // namespace optimizer
@@ -15,6 +15,7 @@
 #include "catalog/column_catalog.h"
 #include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
+#include "common/exception.h"
 #include "optimizer/operators.h"
 #include "optimizer/optimizer_metadata.h"
 #include "optimizer/properties.h"
@@ -284,6 +285,10 @@ void GetToIndexScan::Transform(
       for (auto &index_id_object_pair : get->table->GetIndexCatalogEntries()) {
         auto &index_id = index_id_object_pair.first;
         auto &index = index_id_object_pair.second;
+        // Hash indexes have no key order
+        if (index->GetIndexType() == IndexType::HASH) {
+          continue;
+        }
         auto &index_col_ids = index->GetKeyAttrs();
         // We want to ensure that Sort(a, b, c, d, e) can fit Sort(a, b, c)
         size_t l_num_sort_columns = index_col_ids.size();
@@ -375,33 +380,63 @@ void GetToIndexScan::Transform(
 
     // Find match index for the predicates
     auto index_objects = get->table->GetIndexCatalogEntries();
+    std::vector<std::shared_ptr<OperatorExpression>> index_scans;
+    std::vector<std::shared_ptr<OperatorExpression>> hash_index_scans;
     for (auto &index_id_object_pair : index_objects) {
       auto &index_id = index_id_object_pair.first;
       auto &index_object = index_id_object_pair.second;
+      bool is_hash_index = index_object->GetIndexType() == IndexType::HASH;
       std::vector<oid_t> index_key_column_id_list;
       std::vector<ExpressionType> index_expr_type_list;
       std::vector<type::Value> index_value_list;
       std::unordered_set<oid_t> index_col_set(
           index_object->GetKeyAttrs().begin(),
           index_object->GetKeyAttrs().end());
+      std::unordered_set<oid_t> equality_col_set;
       for (size_t offset = 0; offset < key_column_id_list.size(); offset++) {
         auto col_id = key_column_id_list[offset];
-        if (index_col_set.find(col_id) != index_col_set.end()) {
-          index_key_column_id_list.push_back(col_id);
-          index_expr_type_list.push_back(expr_type_list[offset]);
-          index_value_list.push_back(value_list[offset]);
+        if (index_col_set.find(col_id) == index_col_set.end()) {
+          continue;
+        }
+        // A hash index can only answer equality predicates
+        if (is_hash_index &&
+            expr_type_list[offset] != ExpressionType::COMPARE_EQUAL) {
+          continue;
         }
+        index_key_column_id_list.push_back(col_id);
+        index_expr_type_list.push_back(expr_type_list[offset]);
+        index_value_list.push_back(value_list[offset]);
+        if (expr_type_list[offset] == ExpressionType::COMPARE_EQUAL) {
+          equality_col_set.insert(col_id);
+        }
+      }
+      if (index_key_column_id_list.empty()) {
+        continue;
       }
-      // Add transformed plan
-      if (!index_key_column_id_list.empty()) {
-        auto index_scan_op = PhysicalIndexScan::make(
-            get->get_id, get->table, get->table_alias, get->predicates,
-            get->is_for_update, index_id, index_key_column_id_list,
-            index_expr_type_list, index_value_list);
-        transformed.push_back(
+      // A hash index is only usable for a point lookup, i.e. with equality
+      // predicates on all of its key columns
+      if (is_hash_index && equality_col_set.size() != index_col_set.size()) {
+        continue;
+      }
+      auto index_scan_op = PhysicalIndexScan::make(
+          get->get_id, get->table, get->table_alias, get->predicates,
+          get->is_for_update, index_id, index_key_column_id_list,
+          index_expr_type_list, index_value_list);
+      if (is_hash_index) {
+        hash_index_scans.push_back(
+            std::make_shared<OperatorExpression>(index_scan_op));
+      } else {
+        index_scans.push_back(
             std::make_shared<OperatorExpression>(index_scan_op));
       }
     }
+
+    // Add transformed plans. A point lookup in a hash index never does more
+    // work than a lookup in an ordered index, so prefer it when possible.
+    auto &chosen_scans = hash_index_scans.empty() ? index_scans
+                                                  : hash_index_scans;
+    transformed.insert(transformed.end(), chosen_scans.begin(),
+                       chosen_scans.end());
   }
 }
 
@@ -756,6 +791,183 @@ void InnerJoinToInnerHashJoin::Transform(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// SemiJoinToSemiHashJoin
+namespace {
+// Extract the keys of a hash join from the equality predicates that compare a
+// column of the left child with a column of the right child
+void ExtractHashJoinKeys(
+    const std::shared_ptr<OperatorExpression> &input, OptimizeContext *context,
+    const std::vector<AnnotatedExpression> &join_predicates,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys) {
+  auto &children = input->Children();
+  PELOTON_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+  auto &left_group_alias =
+      context->metadata->memo.GetGroupByID(left_group_id)->GetTableAliases();
+  auto &right_group_alias =
+      context->metadata->memo.GetGroupByID(right_group_id)->GetTableAliases();
+  util::ExtractEquiJoinKeys(join_predicates, left_keys, right_keys,
+                            left_group_alias, right_group_alias);
+  PELOTON_ASSERT(right_keys.size() == left_keys.size());
+}
+
+// Can the join be implemented with a hash join?
+bool HasHashJoinKeys(const std::shared_ptr<OperatorExpression> &input,
+                     OptimizeContext *context,
+                     const std::vector<AnnotatedExpression> &join_predicates) {
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  ExtractHashJoinKeys(input, context, join_predicates, left_keys, right_keys);
+  return !left_keys.empty();
+}
+}  // namespace
+
+SemiJoinToSemiHashJoin::SemiJoinToSemiHashJoin() {
+  type_ = RuleType::SEMI_JOIN_TO_HASH_JOIN;
+
+  match_pattern = std::make_shared<Pattern>(OpType::SemiJoin);
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+}
+
+bool SemiJoinToSemiHashJoin::Check(std::shared_ptr<OperatorExpression> plan,
+                                   OptimizeContext *context) const {
+  return HasHashJoinKeys(plan, context,
+                         plan->Op().As<LogicalSemiJoin>()->join_predicates);
+}
+
+void SemiJoinToSemiHashJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  const auto *semi_join = input->Op().As<LogicalSemiJoin>();
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  ExtractHashJoinKeys(input, context, semi_join->join_predicates, left_keys,
+                      right_keys);
+  PELOTON_ASSERT(!left_keys.empty());
+
+  auto result_plan =
+      std::make_shared<OperatorExpression>(PhysicalSemiHashJoin::make(
+          semi_join->join_predicates, left_keys, right_keys));
+  result_plan->PushChild(input->Children()[0]);
+  result_plan->PushChild(input->Children()[1]);
+
+  transformed.push_back(result_plan);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// AntiJoinToAntiHashJoin
+AntiJoinToAntiHashJoin::AntiJoinToAntiHashJoin() {
+  type_ = RuleType::ANTI_JOIN_TO_HASH_JOIN;
+
+  match_pattern = std::make_shared<Pattern>(OpType::AntiJoin);
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+}
+
+bool AntiJoinToAntiHashJoin::Check(std::shared_ptr<OperatorExpression> plan,
+                                   OptimizeContext *context) const {
+  return HasHashJoinKeys(plan, context,
+                         plan->Op().As<LogicalAntiJoin>()->join_predicates);
+}
+
+void AntiJoinToAntiHashJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  const auto *anti_join = input->Op().As<LogicalAntiJoin>();
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  ExtractHashJoinKeys(input, context, anti_join->join_predicates, left_keys,
+                      right_keys);
+  PELOTON_ASSERT(!left_keys.empty());
+
+  auto result_plan =
+      std::make_shared<OperatorExpression>(PhysicalAntiHashJoin::make(
+          anti_join->join_predicates, left_keys, right_keys,
+          anti_join->null_aware));
+  result_plan->PushChild(input->Children()[0]);
+  result_plan->PushChild(input->Children()[1]);
+
+  transformed.push_back(result_plan);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// SemiJoinToSemiNLJoin
+SemiJoinToSemiNLJoin::SemiJoinToSemiNLJoin() {
+  type_ = RuleType::SEMI_JOIN_TO_NL_JOIN;
+
+  match_pattern = std::make_shared<Pattern>(OpType::SemiJoin);
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+}
+
+bool SemiJoinToSemiNLJoin::Check(std::shared_ptr<OperatorExpression> plan,
+                                 OptimizeContext *context) const {
+  // Joins with an equality between the children are hash joins
+  return !HasHashJoinKeys(plan, context,
+                          plan->Op().As<LogicalSemiJoin>()->join_predicates);
+}
+
+void SemiJoinToSemiNLJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  const auto *semi_join = input->Op().As<LogicalSemiJoin>();
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  auto result_plan = std::make_shared<OperatorExpression>(
+      PhysicalSemiNLJoin::make(semi_join->join_predicates, left_keys,
+                               right_keys));
+  result_plan->PushChild(input->Children()[0]);
+  result_plan->PushChild(input->Children()[1]);
+
+  transformed.push_back(result_plan);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// AntiJoinToAntiNLJoin
+AntiJoinToAntiNLJoin::AntiJoinToAntiNLJoin() {
+  type_ = RuleType::ANTI_JOIN_TO_NL_JOIN;
+
+  match_pattern = std::make_shared<Pattern>(OpType::AntiJoin);
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+}
+
+bool AntiJoinToAntiNLJoin::Check(std::shared_ptr<OperatorExpression> plan,
+                                 OptimizeContext *context) const {
+  // Joins with an equality between the children are hash joins. The nested
+  // loop doesn't implement the NULL semantics of NOT IN, which always has one.
+  const auto *anti_join = plan->Op().As<LogicalAntiJoin>();
+  return !anti_join->null_aware &&
+         !HasHashJoinKeys(plan, context, anti_join->join_predicates);
+}
+
+void AntiJoinToAntiNLJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  const auto *anti_join = input->Op().As<LogicalAntiJoin>();
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  auto result_plan = std::make_shared<OperatorExpression>(
+      PhysicalAntiNLJoin::make(anti_join->join_predicates, left_keys,
+                               right_keys));
+  result_plan->PushChild(input->Children()[0]);
+  result_plan->PushChild(input->Children()[1]);
+
+  transformed.push_back(result_plan);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// ImplementDistinct
 ImplementDistinct::ImplementDistinct() {
@@ -1017,6 +1229,139 @@ void PushFilterThroughAggregation::Transform(
   bottom_operator->PushChild(input->Children()[0]->Children()[0]);
   transformed.push_back(output);
 }
+///////////////////////////////////////////////////////////////////////////////
+/// PushFilterThroughSemiJoin
+namespace {
+// Split the predicates of a filter on top of a semi or anti join into the ones
+// that can be evaluated on the left child of the join, and the rest
+void SplitPredicatesForLeftChild(
+    const std::shared_ptr<OperatorExpression> &input, OptimizeContext *context,
+    std::vector<AnnotatedExpression> &left_predicates,
+    std::vector<AnnotatedExpression> &other_predicates) {
+  auto &join_children = input->Children().at(0)->Children();
+  auto left_group_id = join_children[0]->Op().As<LeafOperator>()->origin_group;
+  const auto &left_group_aliases_set =
+      context->metadata->memo.GetGroupByID(left_group_id)->GetTableAliases();
+
+  for (auto &predicate : input->Op().As<LogicalFilter>()->predicates) {
+    if (util::IsSubset(left_group_aliases_set, predicate.table_alias_set)) {
+      left_predicates.emplace_back(predicate);
+    } else {
+      other_predicates.emplace_back(predicate);
+    }
+  }
+}
+
+// Build the new left child of a join after a filter was pushed through it
+std::shared_ptr<OperatorExpression> PushDownToLeftChild(
+    const std::shared_ptr<OperatorExpression> &join_op_expr,
+    std::vector<AnnotatedExpression> &left_predicates) {
+  auto left_child = join_op_expr->Children()[0];
+  if (left_predicates.empty()) {
+    return left_child;
+  }
+  auto left_filter = std::make_shared<OperatorExpression>(
+      LogicalFilter::make(left_predicates));
+  left_filter->PushChild(left_child);
+  return left_filter;
+}
+}  // namespace
+
+PushFilterThroughSemiJoin::PushFilterThroughSemiJoin() {
+  type_ = RuleType::PUSH_FILTER_THROUGH_SEMI_JOIN;
+
+  std::shared_ptr<Pattern> child(std::make_shared<Pattern>(OpType::SemiJoin));
+  child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+
+  match_pattern = std::make_shared<Pattern>(OpType::LogicalFilter);
+  match_pattern->AddChild(child);
+}
+
+bool PushFilterThroughSemiJoin::Check(std::shared_ptr<OperatorExpression>,
+                                      OptimizeContext *) const {
+  return true;
+}
+
+void PushFilterThroughSemiJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  LOG_TRACE("PushFilterThroughSemiJoin::Transform");
+  auto join_op_expr = input->Children().at(0);
+
+  std::vector<AnnotatedExpression> left_predicates;
+  std::vector<AnnotatedExpression> join_predicates;
+  SplitPredicatesForLeftChild(input, context, left_predicates,
+                              join_predicates);
+
+  // Whatever can't be evaluated on the left child is a join predicate, which
+  // is equivalent for a semi join
+  auto &pre_join_predicates =
+      join_op_expr->Op().As<LogicalSemiJoin>()->join_predicates;
+  join_predicates.insert(join_predicates.end(), pre_join_predicates.begin(),
+                         pre_join_predicates.end());
+  std::shared_ptr<OperatorExpression> output =
+      std::make_shared<OperatorExpression>(
+          LogicalSemiJoin::make(join_predicates));
+  output->PushChild(PushDownToLeftChild(join_op_expr, left_predicates));
+  output->PushChild(join_op_expr->Children()[1]);
+
+  transformed.push_back(output);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// PushFilterThroughAntiJoin
+PushFilterThroughAntiJoin::PushFilterThroughAntiJoin() {
+  type_ = RuleType::PUSH_FILTER_THROUGH_ANTI_JOIN;
+
+  std::shared_ptr<Pattern> child(std::make_shared<Pattern>(OpType::AntiJoin));
+  child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+
+  match_pattern = std::make_shared<Pattern>(OpType::LogicalFilter);
+  match_pattern->AddChild(child);
+}
+
+bool PushFilterThroughAntiJoin::Check(std::shared_ptr<OperatorExpression>,
+                                      OptimizeContext *) const {
+  return true;
+}
+
+void PushFilterThroughAntiJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  LOG_TRACE("PushFilterThroughAntiJoin::Transform");
+  auto join_op_expr = input->Children().at(0);
+
+  std::vector<AnnotatedExpression> left_predicates;
+  std::vector<AnnotatedExpression> other_predicates;
+  SplitPredicatesForLeftChild(input, context, left_predicates,
+                              other_predicates);
+  if (left_predicates.empty()) {
+    // Nothing to push
+    return;
+  }
+
+  std::shared_ptr<OperatorExpression> join =
+      std::make_shared<OperatorExpression>(join_op_expr->Op());
+  join->PushChild(PushDownToLeftChild(join_op_expr, left_predicates));
+  join->PushChild(join_op_expr->Children()[1]);
+
+  // Unlike for semi joins, the other predicates would change the result of the
+  // join if they became join predicates, so they stay on top of the join
+  if (other_predicates.empty()) {
+    transformed.push_back(join);
+    return;
+  }
+  std::shared_ptr<OperatorExpression> output =
+      std::make_shared<OperatorExpression>(
+          LogicalFilter::make(other_predicates));
+  output->PushChild(join);
+  transformed.push_back(output);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// CombineConsecutiveFilter
 CombineConsecutiveFilter::CombineConsecutiveFilter() {
@@ -1363,5 +1708,148 @@ void PullFilterThroughAggregation::Transform(
 
   transformed.push_back(output);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+/// PullFilterThroughSemiJoin
+namespace {
+// Pull the correlated predicates out of the filter on the right child of a
+// semi or anti join, i.e., the predicates that refer to columns of the left
+// child. Returns the new right child of the join.
+std::shared_ptr<OperatorExpression> PullCorrelatedPredicates(
+    const std::shared_ptr<OperatorExpression> &input, OptimizeContext *context,
+    std::vector<AnnotatedExpression> &correlated_predicates) {
+  auto &filter_expr = input->Children()[1];
+  auto child_group_id =
+      filter_expr->Children()[0]->Op().As<LeafOperator>()->origin_group;
+  const auto &child_group_aliases_set =
+      context->metadata->memo.GetGroupByID(child_group_id)->GetTableAliases();
+
+  std::vector<AnnotatedExpression> normal_predicates;
+  for (auto &predicate : filter_expr->Op().As<LogicalFilter>()->predicates) {
+    if (util::IsSubset(child_group_aliases_set, predicate.table_alias_set)) {
+      normal_predicates.emplace_back(predicate);
+    } else {
+      correlated_predicates.emplace_back(predicate);
+    }
+  }
+
+  if (normal_predicates.empty()) {
+    return filter_expr->Children()[0];
+  }
+  std::shared_ptr<OperatorExpression> new_filter =
+      std::make_shared<OperatorExpression>(
+          LogicalFilter::make(normal_predicates));
+  new_filter->PushChild(filter_expr->Children()[0]);
+  return new_filter;
+}
+}  // namespace
+
+PullFilterThroughSemiJoin::PullFilterThroughSemiJoin() {
+  type_ = RuleType::PULL_FILTER_THROUGH_SEMI_JOIN;
+
+  match_pattern = std::make_shared<Pattern>(OpType::SemiJoin);
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  auto filter = std::make_shared<Pattern>(OpType::LogicalFilter);
+  filter->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(filter);
+}
+
+int PullFilterThroughSemiJoin::Promise(GroupExpression *group_expr,
+                                       OptimizeContext *context) const {
+  (void)context;
+  auto root_type = match_pattern->Type();
+  // This rule is not applicable
+  if (root_type != OpType::Leaf && root_type != group_expr->Op().GetType()) {
+    return 0;
+  }
+  return static_cast<int>(UnnestPromise::High);
+}
+
+bool PullFilterThroughSemiJoin::Check(
+    UNUSED_ATTRIBUTE std::shared_ptr<OperatorExpression> plan,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  return true;
+}
+
+void PullFilterThroughSemiJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  LOG_TRACE("PullFilterThroughSemiJoin::Transform");
+  std::vector<AnnotatedExpression> join_predicates;
+  auto right_child = PullCorrelatedPredicates(input, context, join_predicates);
+  if (join_predicates.empty()) {
+    // No need to pull
+    return;
+  }
+
+  // The correlated predicates decide which rows of the sub-query match a row
+  // of the outer query, so they become join predicates
+  auto &pre_join_predicates =
+      input->Op().As<LogicalSemiJoin>()->join_predicates;
+  join_predicates.insert(join_predicates.end(), pre_join_predicates.begin(),
+                         pre_join_predicates.end());
+  std::shared_ptr<OperatorExpression> output =
+      std::make_shared<OperatorExpression>(
+          LogicalSemiJoin::make(join_predicates));
+  output->PushChild(input->Children()[0]);
+  output->PushChild(right_child);
+
+  transformed.push_back(output);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// PullFilterThroughAntiJoin
+PullFilterThroughAntiJoin::PullFilterThroughAntiJoin() {
+  type_ = RuleType::PULL_FILTER_THROUGH_ANTI_JOIN;
+
+  match_pattern = std::make_shared<Pattern>(OpType::AntiJoin);
+  match_pattern->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  auto filter = std::make_shared<Pattern>(OpType::LogicalFilter);
+  filter->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern->AddChild(filter);
+}
+
+int PullFilterThroughAntiJoin::Promise(GroupExpression *group_expr,
+                                       OptimizeContext *context) const {
+  (void)context;
+  auto root_type = match_pattern->Type();
+  // This rule is not applicable
+  if (root_type != OpType::Leaf && root_type != group_expr->Op().GetType()) {
+    return 0;
+  }
+  return static_cast<int>(UnnestPromise::High);
+}
+
+bool PullFilterThroughAntiJoin::Check(
+    UNUSED_ATTRIBUTE std::shared_ptr<OperatorExpression> plan,
+    UNUSED_ATTRIBUTE OptimizeContext *context) const {
+  return true;
+}
+
+void PullFilterThroughAntiJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  LOG_TRACE("PullFilterThroughAntiJoin::Transform");
+  std::vector<AnnotatedExpression> join_predicates;
+  auto right_child = PullCorrelatedPredicates(input, context, join_predicates);
+  if (join_predicates.empty()) {
+    // No need to pull
+    return;
+  }
+
+  const auto *anti_join = input->Op().As<LogicalAntiJoin>();
+  join_predicates.insert(join_predicates.end(),
+                         anti_join->join_predicates.begin(),
+                         anti_join->join_predicates.end());
+  std::shared_ptr<OperatorExpression> output =
+      std::make_shared<OperatorExpression>(
+          LogicalAntiJoin::make(join_predicates, anti_join->null_aware));
+  output->PushChild(input->Children()[0]);
+  output->PushChild(right_child);
+
+  transformed.push_back(output);
+}
 }  // namespace optimizer
 }  // namespace peloton
@@ -34,20 +34,17 @@ vector<ExprSet> ChildStatsDeriver::DeriveInputStats(GroupExpression *gexpr,
 // TODO(boweic): support stats derivation for derivedGet
 void ChildStatsDeriver::Visit(const LogicalQueryDerivedGet *) {}
 void ChildStatsDeriver::Visit(const LogicalInnerJoin *op) {
-  PassDownRequiredCols();
-  for (auto &annotated_expr : op->join_predicates) {
-    auto predicate = annotated_expr.expr.get();
-    ExprSet expr_set;
-    expression::ExpressionUtil::GetTupleValueExprs(expr_set, predicate);
-    for (auto &col : expr_set) {
-      PassDownColumn(col);
-    }
-  }
+  PassDownJoinColumns(op->join_predicates);
 }
 void ChildStatsDeriver::Visit(UNUSED_ATTRIBUTE const LogicalLeftJoin *) {}
 void ChildStatsDeriver::Visit(UNUSED_ATTRIBUTE const LogicalRightJoin *) {}
 void ChildStatsDeriver::Visit(UNUSED_ATTRIBUTE const LogicalOuterJoin *) {}
-void ChildStatsDeriver::Visit(const LogicalSemiJoin *) {}
+void ChildStatsDeriver::Visit(const LogicalSemiJoin *op) {
+  PassDownJoinColumns(op->join_predicates);
+}
+void ChildStatsDeriver::Visit(const LogicalAntiJoin *op) {
+  PassDownJoinColumns(op->join_predicates);
+}
 // TODO(boweic): support stats of aggregation
 void ChildStatsDeriver::Visit(const LogicalAggregateAndGroupBy *) {
   PassDownRequiredCols();
@@ -60,6 +57,19 @@ void ChildStatsDeriver::PassDownRequiredCols() {
   }
 }
 
+void ChildStatsDeriver::PassDownJoinColumns(
+    const std::vector<AnnotatedExpression> &join_predicates) {
+  PassDownRequiredCols();
+  for (auto &annotated_expr : join_predicates) {
+    auto predicate = annotated_expr.expr.get();
+    ExprSet expr_set;
+    expression::ExpressionUtil::GetTupleValueExprs(expr_set, predicate);
+    for (auto &col : expr_set) {
+      PassDownColumn(col);
+    }
+  }
+}
+
 void ChildStatsDeriver::PassDownColumn(expression::AbstractExpression *col) {
   PELOTON_ASSERT(col->GetExpressionType() == ExpressionType::VALUE_TUPLE);
   auto tv_expr = reinterpret_cast<expression::TupleValueExpression *>(col);
@@ -52,6 +52,37 @@ void ColumnStatsCollector::AddValue(const type::Value &value) {
   }
 }
 
+void ColumnStatsCollector::Merge(const ColumnStatsCollector &other) {
+  PELOTON_ASSERT(column_type_ == other.column_type_);
+  hll_.Merge(other.hll_);
+  hist_.Merge(other.hist_);
+  topk_.Merge(other.topk_);
+  null_count_ += other.null_count_;
+  total_count_ += other.total_count_;
+}
+
+std::vector<ColumnStatsCollector::ValueFrequencyPair>
+ColumnStatsCollector::GetCommonValueAndFrequency() {
+  auto value_freqs = topk_.GetAllOrderedMaxFirst();
+  for (auto &value_freq : value_freqs) {
+    value_freq.second *= scale_factor_;
+  }
+  return value_freqs;
+}
+
+uint64_t ColumnStatsCollector::GetCardinality() {
+  uint64_t cardinality = hll_.EstimateCardinality();
+
+  // A sample doesn't tell how many values it has missed. Like PostgreSQL, we
+  // assume the column is unique if (nearly) all the sampled values are
+  // distinct, and that the sample has seen all the values otherwise.
+  size_t non_null_count = total_count_ - null_count_;
+  if (scale_factor_ > 1 && cardinality >= 0.95 * non_null_count) {
+    cardinality = static_cast<uint64_t>(cardinality * scale_factor_);
+  }
+  return cardinality;
+}
+
 double ColumnStatsCollector::GetFracNull() {
   if (total_count_ == 0) {
     LOG_TRACE("Cannot calculate stats for table size 0.");
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_cache.cpp
+//
+// Identification: src/optimizer/stats/stats_cache.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/stats_cache.h"
+
+#include <algorithm>
+
+#include "concurrency/transaction_context.h"
+
+namespace peloton {
+namespace optimizer {
+
+// Get instance of the global stats cache
+StatsCache *StatsCache::GetInstance() {
+  static StatsCache global_stats_cache;
+  return &global_stats_cache;
+}
+
+std::shared_ptr<const ColumnStatsMap> StatsCache::Find(oid_t table_id,
+                                                       uint64_t &version) {
+  latch_.ReadLock();
+  auto it = entries_.find(table_id);
+  if (it != entries_.end() && it->second.column_stats != nullptr) {
+    auto column_stats = it->second.column_stats;
+    latch_.Unlock();
+    hit_count_++;
+    return column_stats;
+  }
+  latch_.Unlock();
+
+  // Create the entry, so that the stats can be installed later on
+  latch_.WriteLock();
+  version = entries_[table_id].version;
+  latch_.Unlock();
+  miss_count_++;
+  return nullptr;
+}
+
+void StatsCache::Install(oid_t table_id, uint64_t version,
+                         concurrency::TransactionContext *txn,
+                         std::shared_ptr<const ColumnStatsMap> column_stats) {
+  latch_.WriteLock();
+  auto it = entries_.find(table_id);
+  if (it != entries_.end()) {
+    Entry &entry = it->second;
+    if (entry.version == version && entry.writer_count == 0 &&
+        txn->GetReadId() > entry.update_cid) {
+      entry.column_stats = std::move(column_stats);
+    }
+  }
+  latch_.Unlock();
+}
+
+void StatsCache::BeginUpdate(oid_t table_id,
+                             concurrency::TransactionContext *txn) {
+  latch_.WriteLock();
+  Entry &entry = entries_[table_id];
+  entry.writer_count++;
+  entry.version++;
+  entry.column_stats.reset();
+  latch_.Unlock();
+
+  txn->AddOnEndCallback(
+      [this, table_id, txn]() { EndUpdate(table_id, txn->GetCommitId()); });
+}
+
+void StatsCache::EndUpdate(oid_t table_id, cid_t commit_id) {
+  latch_.WriteLock();
+  auto it = entries_.find(table_id);
+  if (it != entries_.end()) {
+    Entry &entry = it->second;
+    entry.writer_count--;
+    entry.version++;
+    entry.update_cid = std::max(entry.update_cid, commit_id);
+    entry.column_stats.reset();
+  }
+  latch_.Unlock();
+}
+
+void StatsCache::Invalidate(oid_t table_id) {
+  latch_.WriteLock();
+  auto it = entries_.find(table_id);
+  if (it != entries_.end()) {
+    // Keep the bookkeeping of transactions still rewriting the stats
+    if (it->second.writer_count == 0) {
+      entries_.erase(it);
+    } else {
+      it->second.version++;
+      it->second.column_stats.reset();
+    }
+  }
+  latch_.Unlock();
+}
+
+void StatsCache::Clear() {
+  latch_.WriteLock();
+  for (auto &entry : entries_) {
+    entry.second.version++;
+    entry.second.column_stats.reset();
+  }
+  latch_.Unlock();
+}
+
+size_t StatsCache::GetCount() const {
+  size_t count = 0;
+  latch_.ReadLock();
+  for (const auto &entry : entries_) {
+    if (entry.second.column_stats != nullptr) {
+      count++;
+    }
+  }
+  latch_.Unlock();
+  return count;
+}
+
+}  // namespace optimizer
+}  // namespace peloton
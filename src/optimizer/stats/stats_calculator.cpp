@@ -158,7 +158,12 @@ void StatsCalculator::Visit(const LogicalInnerJoin *op) {
 void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalLeftJoin *op) {}
 void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalRightJoin *op) {}
 void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalOuterJoin *op) {}
-void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalSemiJoin *op) {}
+void StatsCalculator::Visit(const LogicalSemiJoin *op) {
+  CalculateStatsForSemiOrAntiJoin(op->join_predicates, false);
+}
+void StatsCalculator::Visit(const LogicalAntiJoin *op) {
+  CalculateStatsForSemiOrAntiJoin(op->join_predicates, true);
+}
 void StatsCalculator::Visit(const LogicalAggregateAndGroupBy *) {
   // TODO(boweic): For now we just pass the stats needed without any
   // computation,
@@ -212,6 +217,79 @@ void StatsCalculator::Visit(const LogicalDistinct *) {
   }
 }
 
+void StatsCalculator::CalculateStatsForSemiOrAntiJoin(
+    const std::vector<AnnotatedExpression> &join_predicates, bool anti) {
+  PELOTON_ASSERT(gexpr_->GetChildrenGroupsSize() == 2);
+  auto left_child_group = memo_->GetGroupByID(gexpr_->GetChildGroupId(0));
+  auto right_child_group = memo_->GetGroupByID(gexpr_->GetChildGroupId(1));
+  auto root_group = memo_->GetGroupByID(gexpr_->GetGroupID());
+  if (root_group->GetNumRows() == -1) {
+    // Fraction of the left rows that have a match. Without a right row
+    // nothing matches, and without predicates every left row matches.
+    double selectivity = right_child_group->GetNumRows() > 0 ? 1.f : 0.f;
+    for (auto &annotated_expr : join_predicates) {
+      selectivity *= CalculateSelectivityForSemiJoinPredicate(
+          left_child_group, right_child_group, annotated_expr.expr.get());
+    }
+    if (anti) {
+      selectivity = 1.f - selectivity;
+    }
+    root_group->SetNumRows(
+        static_cast<size_t>(left_child_group->GetNumRows() * selectivity));
+  }
+  for (auto &col : required_cols_) {
+    PELOTON_ASSERT(col->GetExpressionType() == ExpressionType::VALUE_TUPLE);
+    auto column_name = reinterpret_cast<expression::TupleValueExpression *>(col)
+                           ->GetColFullName();
+    auto child_group = left_child_group;
+    if (!left_child_group->HasColumnStats(column_name)) {
+      PELOTON_ASSERT(right_child_group->HasColumnStats(column_name));
+      child_group = right_child_group;
+    }
+    std::shared_ptr<ColumnStats> column_stats =
+        std::make_shared<ColumnStats>(*child_group->GetStats(column_name));
+    column_stats->num_rows = root_group->GetNumRows();
+    root_group->AddStats(column_name, column_stats);
+  }
+}
+
+double StatsCalculator::CalculateSelectivityForSemiJoinPredicate(
+    Group *left_child_group, Group *right_child_group,
+    const expression::AbstractExpression *expr) {
+  // Only an equality between a column of each child has a better estimate
+  if (expr->GetExpressionType() != ExpressionType::COMPARE_EQUAL ||
+      expr->GetChild(0)->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      expr->GetChild(1)->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    return DEFAULT_SELECTIVITY;
+  }
+  auto left_col_name =
+      reinterpret_cast<const expression::TupleValueExpression *>(
+          expr->GetChild(0))->GetColFullName();
+  auto right_col_name =
+      reinterpret_cast<const expression::TupleValueExpression *>(
+          expr->GetChild(1))->GetColFullName();
+  if (!left_child_group->HasColumnStats(left_col_name)) {
+    std::swap(left_col_name, right_col_name);
+  }
+  if (!left_child_group->HasColumnStats(left_col_name) ||
+      !right_child_group->HasColumnStats(right_col_name)) {
+    return DEFAULT_SELECTIVITY;
+  }
+  auto left_stats = left_child_group->GetStats(left_col_name);
+  auto right_stats = right_child_group->GetStats(right_col_name);
+  double left_distinct = std::min(
+      left_stats->cardinality, static_cast<double>(left_stats->num_rows));
+  double right_distinct = std::min(
+      right_stats->cardinality, static_cast<double>(right_stats->num_rows));
+  if (left_distinct <= 0 || right_distinct <= 0) {
+    return DEFAULT_SELECTIVITY;
+  }
+  // Assume the distinct values of the child with fewer of them are all found
+  // in the other child. A NULL key never matches.
+  return std::min(right_distinct / left_distinct, 1.0) *
+         (1.0 - left_stats->frac_null);
+}
+
 void StatsCalculator::AddBaseTableStats(
     expression::AbstractExpression *col,
     std::shared_ptr<TableStats> table_stats,
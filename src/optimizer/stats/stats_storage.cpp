@@ -16,7 +16,9 @@
 #include "catalog/column_stats_catalog.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/stats_cache.h"
 #include "optimizer/stats/table_stats.h"
+#include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
 #include "type/ephemeral_pool.h"
 
@@ -34,7 +36,7 @@ StatsStorage *StatsStorage::GetInstance() {
  * In the construcotr, `pg_column_stats` table and `samples_db` database are
  * created.
  */
-StatsStorage::StatsStorage() {
+StatsStorage::StatsStorage() : auto_analyze_running_(false) {
   pool_.reset(new type::EphemeralPool());
   CreateStatsTableInCatalog();
 }
@@ -117,6 +119,7 @@ void StatsStorage::InsertOrUpdateColumnStats(
     single_statement_txn = true;
     txn = txn_manager.BeginTransaction();
   }
+  StatsCache::GetInstance()->BeginUpdate(table_id, txn);
   column_stats_catalog->DeleteColumnStats(txn, database_id, table_id, column_id);
   column_stats_catalog->InsertColumnStats(txn,
                                           database_id,
@@ -138,24 +141,63 @@ void StatsStorage::InsertOrUpdateColumnStats(
 }
 
 /**
- * GetColumnStatsByID - Query the 'pg_column_stats' table to get the column
- * stats by IDs.
+ * GetColumnStatsByID - Get the column stats by IDs from the stats cache, or
+ * the 'pg_column_stats' table if they are not cached.
  */
 std::shared_ptr<ColumnStats> StatsStorage::GetColumnStatsByID(oid_t database_id,
                                                               oid_t table_id,
                                                               oid_t column_id) {
+  auto column_stats_map = GetColumnStatsMap(database_id, table_id, nullptr);
+  auto it = column_stats_map->find(column_id);
+  if (it == column_stats_map->end()) {
+    LOG_TRACE(
+        "ColumnStatsCollector not found for db: %u, table: %u, column: %u",
+        database_id, table_id, column_id);
+    return nullptr;
+  }
+  return it->second;
+}
+
+/**
+ * GetColumnStatsMap - Get the stats of all columns of the table from the stats
+ * cache. On a miss, they are read from the 'pg_column_stats' table and
+ * deserialized once, in the given transaction or a transaction of its own.
+ */
+std::shared_ptr<const ColumnStatsMap> StatsStorage::GetColumnStatsMap(
+    oid_t database_id, oid_t table_id, concurrency::TransactionContext *txn) {
+  auto stats_cache = StatsCache::GetInstance();
+  uint64_t version;
+  auto column_stats_map = stats_cache->Find(table_id, version);
+  if (column_stats_map != nullptr) {
+    return column_stats_map;
+  }
+
   auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-  auto txn = txn_manager.BeginTransaction();
-  // std::unique_ptr<std::vector<type::Value>> column_stats_vector
-  auto column_stats_vector = column_stats_catalog->GetColumnStats(txn,
-                                                                  database_id,
-                                                                  table_id,
-                                                                  column_id);
-  txn_manager.CommitTransaction(txn);
+  bool single_statement_txn = false;
+  if (txn == nullptr) {
+    single_statement_txn = true;
+    txn = txn_manager.BeginTransaction();
+  }
+  std::map<oid_t, std::unique_ptr<std::vector<type::Value>>> column_stats_rows;
+  column_stats_catalog->GetTableStats(txn,
+                                      database_id,
+                                      table_id,
+                                      column_stats_rows);
+
+  std::shared_ptr<ColumnStatsMap> new_column_stats_map(new ColumnStatsMap());
+  for (auto it = column_stats_rows.begin(); it != column_stats_rows.end();
+       ++it) {
+    new_column_stats_map->emplace(
+        it->first, ConvertVectorToColumnStats(database_id, table_id, it->first,
+                                              it->second));
+  }
+  stats_cache->Install(table_id, version, txn, new_column_stats_map);
 
-  return ConvertVectorToColumnStats(database_id, table_id, column_id,
-                                    column_stats_vector);
+  if (single_statement_txn) {
+    txn_manager.CommitTransaction(txn);
+  }
+  return new_column_stats_map;
 }
 
 /**
@@ -221,32 +263,27 @@ std::shared_ptr<ColumnStats> StatsStorage::ConvertVectorToColumnStats(
 }
 
 /**
- * GetTableStats - This function queries the column_stats_catalog for the table
- *stats.
+ * GetTableStats - This function gets the table stats from the stats cache, or
+ * the column_stats_catalog if they are not cached.
  *
  * The return value is the shared_ptr of TableStats wrapper.
  */
 std::shared_ptr<TableStats> StatsStorage::GetTableStats(
     oid_t database_id, oid_t table_id, concurrency::TransactionContext *txn) {
-  auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
-  std::map<oid_t, std::unique_ptr<std::vector<type::Value>>> column_stats_map;
-  column_stats_catalog->GetTableStats(txn,
-                                      database_id,
-                                      table_id,
-                                      column_stats_map);
+  auto column_stats_map = GetColumnStatsMap(database_id, table_id, txn);
 
   std::vector<std::shared_ptr<ColumnStats>> column_stats_ptrs;
-  for (auto it = column_stats_map.begin(); it != column_stats_map.end(); ++it) {
-    column_stats_ptrs.push_back(ConvertVectorToColumnStats(
-        database_id, table_id, it->first, it->second));
+  for (auto it = column_stats_map->begin(); it != column_stats_map->end();
+       ++it) {
+    column_stats_ptrs.push_back(it->second);
   }
 
   return std::shared_ptr<TableStats>(new TableStats(column_stats_ptrs));
 }
 
 /**
- * GetTableStats - This function query the column_stats_catalog for the table
- *stats.
+ * GetTableStats - This function gets the table stats from the stats cache, or
+ * the column_stats_catalog if they are not cached.
  * In this function, the column ids are specified.
  *
  * The return value is the shared_ptr of TableStats wrapper.
@@ -254,19 +291,13 @@ std::shared_ptr<TableStats> StatsStorage::GetTableStats(
 std::shared_ptr<TableStats> StatsStorage::GetTableStats(
     oid_t database_id, oid_t table_id, std::vector<oid_t> column_ids,
     concurrency::TransactionContext *txn) {
-  auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
-  std::map<oid_t, std::unique_ptr<std::vector<type::Value>>> column_stats_map;
-  column_stats_catalog->GetTableStats(txn,
-                                      database_id,
-                                      table_id,
-                                      column_stats_map);
+  auto column_stats_map = GetColumnStatsMap(database_id, table_id, txn);
 
   std::vector<std::shared_ptr<ColumnStats>> column_stats_ptrs;
   for (oid_t col_id : column_ids) {
-    auto it = column_stats_map.find(col_id);
-    if (it != column_stats_map.end()) {
-      column_stats_ptrs.push_back(ConvertVectorToColumnStats(
-          database_id, table_id, col_id, it->second));
+    auto it = column_stats_map->find(col_id);
+    if (it != column_stats_map->end()) {
+      column_stats_ptrs.push_back(it->second);
     }
   }
 
@@ -297,10 +328,9 @@ ResultType StatsStorage::AnalyzeStatsForAllTables(
     for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
       auto table = database->GetTable(table_offset);
       LOG_DEBUG("Analyzing table: %s", table->GetName().c_str());
-      std::unique_ptr<TableStatsCollector> table_stats_collector(
-          new TableStatsCollector(table));
-      table_stats_collector->CollectColumnStats();
-      InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+      AnalyzeTable(table, settings::SettingsManager::GetInt(
+                              settings::SettingId::analyze_sample_tile_groups),
+                   txn);
     }
   }
   return ResultType::SUCCESS;
@@ -317,11 +347,10 @@ ResultType StatsStorage::AnalyzeStatsForTable(
               table->GetName().c_str());
     return ResultType::FAILURE;
   }
-  std::unique_ptr<TableStatsCollector> table_stats_collector(
-      new TableStatsCollector(table));
-  table_stats_collector->CollectColumnStats();
-  InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
-  return ResultType::SUCCESS;
+  return AnalyzeTable(table,
+                      settings::SettingsManager::GetInt(
+                          settings::SettingId::analyze_sample_tile_groups),
+                      txn);
 }
 
 // TODO: Implement it.
@@ -331,5 +360,124 @@ ResultType StatsStorage::AnalayzeStatsForColumns(
   return ResultType::FAILURE;
 }
 
+/**
+ * IsStale - This function checks whether the table was modified enough since
+ * its stats were last collected for them to be refreshed. Every insert, update
+ * and delete creates a tuple version, so the versions allocated in the table
+ * count its modifications.
+ */
+bool StatsStorage::IsStale(storage::DataTable *table) {
+  size_t modification_count = table->GetTupleCount();
+  AnalyzeState state{0, 0};
+  {
+    std::lock_guard<std::mutex> lock(analyze_state_mutex_);
+    auto it = analyze_states_.find(table->GetOid());
+    if (it != analyze_states_.end()) {
+      state = it->second;
+    }
+  }
+  size_t modifications = modification_count - state.modification_count;
+  return modifications >
+         kAutoAnalyzeThreshold + kAutoAnalyzeScaleFactor * state.row_count;
+}
+
+/**
+ * AnalyzeStaleTables - This function refreshes the stats of all the stale
+ * tables, each in its own transaction. Unless a sample size is set, a fixed
+ * number of tile groups is sampled to bound the cost of a refresh.
+ *
+ * The return value is the number of tables analyzed.
+ */
+size_t StatsStorage::AnalyzeStaleTables() {
+  size_t sample_tile_group_count = settings::SettingsManager::GetInt(
+      settings::SettingId::analyze_sample_tile_groups);
+  if (sample_tile_group_count == 0) {
+    sample_tile_group_count = kAutoAnalyzeSampleTileGroups;
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  size_t analyzed_count = 0;
+  oid_t database_count = storage_manager->GetDatabaseCount();
+  for (oid_t db_offset = 0; db_offset < database_count; db_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(db_offset);
+    if (database->GetOid() == CATALOG_DATABASE_OID) {
+      continue;
+    }
+    oid_t table_count = database->GetTableCount();
+    for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+      auto table = database->GetTable(table_offset);
+      if (!IsStale(table)) {
+        continue;
+      }
+      LOG_DEBUG("Refreshing stale stats of table: %s",
+                table->GetName().c_str());
+      auto txn = txn_manager.BeginTransaction();
+      AnalyzeTable(table, sample_tile_group_count, txn);
+      if (txn_manager.CommitTransaction(txn) == ResultType::SUCCESS) {
+        analyzed_count++;
+      }
+    }
+  }
+  return analyzed_count;
+}
+
+void StatsStorage::StartAutoAnalyze() {
+  if (auto_analyze_running_.exchange(true)) {
+    return;
+  }
+  auto_analyze_thread_ = std::thread(&StatsStorage::RunAutoAnalyze, this);
+  LOG_INFO("Started auto analyzer");
+}
+
+void StatsStorage::StopAutoAnalyze() {
+  {
+    std::lock_guard<std::mutex> lock(auto_analyze_mutex_);
+    if (!auto_analyze_running_.exchange(false)) {
+      return;
+    }
+  }
+  auto_analyze_cv_.notify_all();
+  auto_analyze_thread_.join();
+  LOG_INFO("Stopped auto analyzer");
+}
+
+void StatsStorage::RunAutoAnalyze() {
+  std::unique_lock<std::mutex> lock(auto_analyze_mutex_);
+  while (auto_analyze_running_.load()) {
+    auto_analyze_cv_.wait_for(
+        lock, std::chrono::milliseconds(kAutoAnalyzeIntervalMs));
+    if (!auto_analyze_running_.load()) {
+      break;
+    }
+    lock.unlock();
+    UNUSED_ATTRIBUTE size_t analyzed_count = AnalyzeStaleTables();
+    LOG_TRACE("Refreshed the stats of %lu tables", analyzed_count);
+    lock.lock();
+  }
+}
+
+/**
+ * AnalyzeTable - This function collects the stats of the table, sampling the
+ * given number of tile groups unless it is 0, and stores them in the
+ * column_stats_catalog.
+ */
+ResultType StatsStorage::AnalyzeTable(storage::DataTable *table,
+                                      size_t sample_tile_group_count,
+                                      concurrency::TransactionContext *txn) {
+  // Read the counter first, so that the modifications made during the scan
+  // count towards the next refresh
+  size_t modification_count = table->GetTupleCount();
+  std::unique_ptr<TableStatsCollector> table_stats_collector(
+      new TableStatsCollector(table, sample_tile_group_count));
+  table_stats_collector->CollectColumnStats();
+  InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+
+  std::lock_guard<std::mutex> lock(analyze_state_mutex_);
+  analyze_states_[table->GetOid()] = {
+      modification_count, table_stats_collector->GetActiveTupleCount()};
+  return ResultType::SUCCESS;
+}
+
 }  // namespace optimizer
 }  // namespace peloton
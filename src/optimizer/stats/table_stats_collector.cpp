@@ -12,9 +12,13 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
+#include <thread>
 
 #include "common/macros.h"
+#include "optimizer/stats/tuple_sampler.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "common/internal_types.h"
@@ -23,11 +27,21 @@
 namespace peloton {
 namespace optimizer {
 
-TableStatsCollector::TableStatsCollector(storage::DataTable *table)
+namespace {
+
+// The minimum number of tile groups worth scanning in a thread of its own
+const size_t kMinTileGroupsPerThread = 8;
+
+}  // namespace
+
+TableStatsCollector::TableStatsCollector(storage::DataTable *table,
+                                         size_t sample_tile_group_count)
     : table_(table),
       column_stats_collectors_{},
       active_tuple_count_{0},
-      column_count_{0} {}
+      column_count_{0},
+      sample_tile_group_count_{sample_tile_group_count},
+      sampled_{false} {}
 
 TableStatsCollector::~TableStatsCollector() {}
 
@@ -40,16 +54,86 @@ void TableStatsCollector::CollectColumnStats() {
     return;
   }
 
-  InitColumnStatsCollectors();
+  InitColumnStatsCollectors(column_stats_collectors_);
 
+  // Set indexes in the column stats collectors.
+  for (auto &column_set : table_->GetIndexColumns()) {
+    auto column_id = *(column_set.begin());
+    column_stats_collectors_[column_id]->SetColumnIndexed();
+  }
+
+  // Pick the tile groups to scan
   size_t tile_group_count = table_->GetTileGroupCount();
-  // Collect stats for all tile groups.
-  for (size_t offset = 0; offset < tile_group_count; offset++) {
+  std::vector<size_t> offsets;
+  if (sample_tile_group_count_ != 0 &&
+      sample_tile_group_count_ < tile_group_count) {
+    TupleSampler sampler{table_};
+    offsets = sampler.SampleTileGroupOffsets(sample_tile_group_count_);
+    sampled_ = true;
+  } else {
+    offsets.resize(tile_group_count);
+    std::iota(offsets.begin(), offsets.end(), 0);
+  }
+
+  size_t thread_count = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      (offsets.size() + kMinTileGroupsPerThread - 1) / kMinTileGroupsPerThread);
+  size_t range_size =
+      thread_count == 0 ? 0 : (offsets.size() + thread_count - 1) / thread_count;
+
+  // Every other thread collects into its own stats, which are merged into the
+  // stats of this thread
+  std::vector<std::vector<std::unique_ptr<ColumnStatsCollector>>> partial_stats(
+      thread_count > 1 ? thread_count - 1 : 0);
+  std::vector<size_t> active_tuple_counts(partial_stats.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < partial_stats.size(); i++) {
+    InitColumnStatsCollectors(partial_stats[i]);
+    size_t begin = std::min((i + 1) * range_size, offsets.size());
+    size_t end = std::min(begin + range_size, offsets.size());
+    threads.emplace_back([this, &offsets, &partial_stats, &active_tuple_counts,
+                          i, begin, end]() {
+      active_tuple_counts[i] =
+          CollectTileGroups(offsets, begin, end, partial_stats[i]);
+    });
+  }
+
+  active_tuple_count_ =
+      CollectTileGroups(offsets, 0, std::min(range_size, offsets.size()),
+                        column_stats_collectors_);
+
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+    active_tuple_count_ += active_tuple_counts[i];
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      column_stats_collectors_[column_id]->Merge(*partial_stats[i][column_id]);
+    }
+  }
+
+  // Scale the stats of the sample up to the entire table
+  if (sampled_ && !offsets.empty()) {
+    double scale_factor = static_cast<double>(tile_group_count) / offsets.size();
+    active_tuple_count_ =
+        static_cast<size_t>(active_tuple_count_ * scale_factor);
+    for (auto &column_stats_collector : column_stats_collectors_) {
+      column_stats_collector->SetScaleFactor(scale_factor);
+    }
+  }
+}
+
+size_t TableStatsCollector::CollectTileGroups(
+    const std::vector<size_t> &tile_group_offsets, size_t begin, size_t end,
+    std::vector<std::unique_ptr<ColumnStatsCollector>> &collectors) const {
+  size_t active_tuple_count = 0;
+  for (size_t i = begin; i < end; i++) {
     std::shared_ptr<storage::TileGroup> tile_group =
-        table_->GetTileGroup(offset);
+        table_->GetTileGroup(tile_group_offsets[i]);
+    if (tile_group == nullptr) {
+      continue;
+    }
     storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
     oid_t tuple_count = tile_group->GetAllocatedTupleCount();
-    active_tuple_count_ += tile_group_header->GetActiveTupleCount();
+    active_tuple_count += tile_group_header->GetActiveTupleCount();
     // Collect stats for all tuples in the tile group.
     for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
       txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
@@ -57,27 +141,23 @@ void TableStatsCollector::CollectColumnStats() {
         // Collect stats for all columns.
         for (oid_t column_id = 0; column_id < column_count_; column_id++) {
           type::Value value = tile_group->GetValue(tuple_id, column_id);
-          column_stats_collectors_[column_id]->AddValue(value);
+          collectors[column_id]->AddValue(value);
         } /* column */
       }
     } /* tuple */
   }   /* tile group */
+  return active_tuple_count;
 }
 
-void TableStatsCollector::InitColumnStatsCollectors() {
+void TableStatsCollector::InitColumnStatsCollectors(
+    std::vector<std::unique_ptr<ColumnStatsCollector>> &collectors) {
   oid_t database_id = table_->GetDatabaseOid();
   oid_t table_id = table_->GetOid();
   for (oid_t column_id = 0; column_id < column_count_; column_id++) {
     std::unique_ptr<ColumnStatsCollector> colstats(new ColumnStatsCollector(
         database_id, table_id, column_id, schema_->GetType(column_id),
         table_->GetName()+"."+schema_->GetColumn(column_id).GetName()));
-    column_stats_collectors_.push_back(std::move(colstats));
-  }
-
-  // Set indexes in the column stats collectors.
-  for (auto &column_set : table_->GetIndexColumns()) {
-    auto column_id = *(column_set.begin());
-    column_stats_collectors_[column_id]->SetColumnIndexed();
+    collectors.push_back(std::move(colstats));
   }
 }
 
@@ -11,7 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "optimizer/stats/tuple_sampler.h"
+#include <algorithm>
 #include <cinttypes>
+#include <numeric>
+#include <random>
 
 #include "storage/data_table.h"
 #include "storage/tile.h"
@@ -46,6 +49,9 @@ size_t TupleSampler::AcquireSampleTuples(size_t target_sample_count) {
     rand_tilegroup_offset = rand() % tile_group_count;
     storage::TileGroup *tile_group =
         table->GetTileGroup(rand_tilegroup_offset).get();
+    if (tile_group == nullptr) {
+      continue;
+    }
     oid_t tuple_per_group = tile_group->GetActiveTupleCount();
     LOG_TRACE("tile_group: offset: %lu, addr: %p, tuple_per_group: %u",
               rand_tilegroup_offset, tile_group, tuple_per_group);
@@ -71,6 +77,32 @@ size_t TupleSampler::AcquireSampleTuples(size_t target_sample_count) {
   return sampled_tuples.size();
 }
 
+/**
+ * SampleTileGroupOffsets - Pick a certain number of distinct tile groups of
+ * the table at random, for block sampling: all tuples of the picked tile
+ * groups are used, which reads far fewer tile groups than sampling the same
+ * number of tuples one by one. The offsets are returned in ascending order.
+ */
+std::vector<size_t> TupleSampler::SampleTileGroupOffsets(
+    size_t target_sample_count) {
+  size_t tile_group_count = table->GetTileGroupCount();
+  std::vector<size_t> offsets(tile_group_count);
+  std::iota(offsets.begin(), offsets.end(), 0);
+  if (target_sample_count >= tile_group_count) {
+    return offsets;
+  }
+
+  // Partial Fisher-Yates shuffle
+  std::mt19937 generator{std::random_device{}()};
+  for (size_t i = 0; i < target_sample_count; i++) {
+    std::uniform_int_distribution<size_t> distribution{i, tile_group_count - 1};
+    std::swap(offsets[i], offsets[distribution(generator)]);
+  }
+  offsets.resize(target_sample_count);
+  std::sort(offsets.begin(), offsets.end());
+  return offsets;
+}
+
 /**
  * GetTupleInTileGroup - This function is a helper function to get a tuple in
  * a tile group.
@@ -14,6 +14,7 @@
 #include "common/internal_types.h"
 #include "expression/constant_value_expression.h"
 #include "expression/expression_util.h"
+#include "expression/parameter_value_expression.h"
 #include "storage/data_table.h"
 
 namespace peloton {
@@ -47,6 +48,18 @@ IndexScanPlan::IndexScanPlan(storage::DataTable *table,
     values_.push_back(val.Copy());
   }
 
+  // The codegen engine reads the scan key from the query parameters, so each
+  // value becomes either a parameter or a (parameterizable) constant
+  for (const auto &val : values_with_params_) {
+    if (val.GetTypeId() == type::TypeId::PARAMETER_OFFSET) {
+      key_value_exprs_.emplace_back(
+          new expression::ParameterValueExpression(val.GetAs<int32_t>()));
+    } else {
+      key_value_exprs_.emplace_back(
+          new expression::ConstantValueExpression(val));
+    }
+  }
+
   // Check whether the scan range is left/right open. Because the index itself
   // is not able to handle that exactly, we must have extra logic in
   // IndexScanExecutor to handle that case.
@@ -94,5 +107,106 @@ void IndexScanPlan::SetParameterValues(std::vector<type::Value> *values) {
   }
 }
 
+std::vector<const expression::AbstractExpression *>
+IndexScanPlan::GetKeyValueExpressions() const {
+  std::vector<const expression::AbstractExpression *> exprs;
+  if (!runtime_keys_.empty()) {
+    exprs.insert(exprs.end(), runtime_keys_.begin(), runtime_keys_.end());
+  } else {
+    for (const auto &expr : key_value_exprs_) {
+      exprs.push_back(expr.get());
+    }
+  }
+  return exprs;
+}
+
+hash_t IndexScanPlan::Hash() const {
+  auto type = GetPlanNodeType();
+  hash_t hash = HashUtil::Hash(&type);
+
+  hash = HashUtil::CombineHashes(hash, GetTable()->Hash());
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&index_id_));
+  if (GetPredicate() != nullptr) {
+    hash = HashUtil::CombineHashes(hash, GetPredicate()->Hash());
+  }
+
+  for (auto &column_id : GetColumnIds()) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&column_id));
+  }
+
+  // The scan key. The values themselves are parameterized.
+  for (uint32_t i = 0; i < key_column_ids_.size(); i++) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&key_column_ids_[i]));
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&expr_types_[i]));
+  }
+  for (const auto *expr : GetKeyValueExpressions()) {
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  }
+
+  auto is_update = IsForUpdate();
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&is_update));
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&limit_));
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&descend_));
+
+  return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
+}
+
+bool IndexScanPlan::operator==(const AbstractPlan &rhs) const {
+  if (GetPlanNodeType() != rhs.GetPlanNodeType()) return false;
+
+  auto &other = static_cast<const planner::IndexScanPlan &>(rhs);
+  auto *table = GetTable();
+  auto *other_table = other.GetTable();
+  PELOTON_ASSERT(table && other_table);
+  if (*table != *other_table) return false;
+
+  if (GetIndexId() != other.GetIndexId()) return false;
+
+  // Predicate
+  auto *pred = GetPredicate();
+  auto *other_pred = other.GetPredicate();
+  if ((pred == nullptr && other_pred != nullptr) ||
+      (pred != nullptr && other_pred == nullptr))
+    return false;
+  if (pred && *pred != *other_pred) return false;
+
+  // Column Ids
+  if (GetColumnIds() != other.GetColumnIds()) return false;
+
+  // Scan key
+  if (GetKeyColumnIds() != other.GetKeyColumnIds() ||
+      GetExprTypes() != other.GetExprTypes())
+    return false;
+  auto key_exprs = GetKeyValueExpressions();
+  auto other_key_exprs = other.GetKeyValueExpressions();
+  if (key_exprs.size() != other_key_exprs.size()) return false;
+  for (size_t i = 0; i < key_exprs.size(); i++) {
+    if (*key_exprs[i] != *other_key_exprs[i]) return false;
+  }
+
+  if (IsForUpdate() != other.IsForUpdate() || GetLimit() != other.GetLimit() ||
+      GetDescend() != other.GetDescend())
+    return false;
+
+  return AbstractPlan::operator==(rhs);
+}
+
+void IndexScanPlan::VisitParameters(
+    codegen::QueryParametersMap &map, std::vector<peloton::type::Value> &values,
+    const std::vector<peloton::type::Value> &values_from_user) {
+  AbstractPlan::VisitParameters(map, values, values_from_user);
+
+  for (const auto *expr : GetKeyValueExpressions()) {
+    const_cast<expression::AbstractExpression *>(expr)->VisitParameters(
+        map, values, values_from_user);
+  }
+
+  auto *predicate =
+      const_cast<expression::AbstractExpression *>(GetPredicate());
+  if (predicate != nullptr) {
+    predicate->VisitParameters(map, values, values_from_user);
+  }
+}
+
 }  // namespace planner
 }  // namespace peloton
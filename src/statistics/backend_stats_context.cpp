@@ -48,7 +48,8 @@ BackendStatsContext *BackendStatsContext::GetInstance() {
 
 BackendStatsContext::BackendStatsContext(size_t max_latency_history,
                                          bool regiser_to_aggregator)
-    : txn_latencies_(MetricType::LATENCY, max_latency_history) {
+    : txn_latencies_(MetricType::LATENCY, max_latency_history),
+      commit_latencies_(MetricType::LATENCY, max_latency_history) {
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
@@ -111,6 +112,10 @@ LatencyMetric &BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
+LatencyMetric &BackendStatsContext::GetCommitLatencyMetric() {
+  return commit_latencies_;
+}
+
 void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
   oid_t table_id =
       storage::StorageManager::GetInstance()->GetTileGroup(tile_group_id)->GetTableId();
@@ -221,6 +226,39 @@ void BackendStatsContext::IncrementTxnAborted(oid_t database_id) {
   CompleteQueryMetric();
 }
 
+void BackendStatsContext::IncrementLogBytesFlushed(size_t bytes) {
+  log_bytes_flushed_.Increment(bytes);
+}
+
+void BackendStatsContext::IncrementIndexReclaimed(size_t entry_count,
+                                                  size_t bytes) {
+  index_entries_reclaimed_.Increment(entry_count);
+  index_bytes_reclaimed_.Increment(bytes);
+}
+
+void BackendStatsContext::IncrementTileGroupFreed(size_t bytes) {
+  tile_groups_freed_.Increment();
+  tile_group_bytes_freed_.Increment(bytes);
+}
+
+void BackendStatsContext::IncrementQuerySpill(uint64_t bytes,
+                                              uint64_t passes) {
+  if (ongoing_query_metric_ != nullptr) {
+    ongoing_query_metric_->GetSpilledBytes().Increment(bytes);
+    ongoing_query_metric_->GetSpillPasses().Increment(passes);
+  }
+}
+
+void BackendStatsContext::IncrementQueryExecutionTime(double interpreted_ms,
+                                                      double native_ms) {
+  if (ongoing_query_metric_ != nullptr) {
+    ongoing_query_metric_->GetInterpretedTime().Increment(
+        static_cast<int64_t>(interpreted_ms * 1000));
+    ongoing_query_metric_->GetNativeTime().Increment(
+        static_cast<int64_t>(native_ms * 1000));
+  }
+}
+
 void BackendStatsContext::InitQueryMetric(
     const std::shared_ptr<Statement> statement,
     const std::shared_ptr<QueryMetric::QueryParams> params) {
@@ -239,6 +277,13 @@ void BackendStatsContext::Aggregate(BackendStatsContext &source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
   txn_latencies_.ComputeLatencies();
+  commit_latencies_.Aggregate(source.commit_latencies_);
+  commit_latencies_.ComputeLatencies();
+  log_bytes_flushed_.Aggregate(source.log_bytes_flushed_);
+  index_entries_reclaimed_.Aggregate(source.index_entries_reclaimed_);
+  index_bytes_reclaimed_.Aggregate(source.index_bytes_reclaimed_);
+  tile_groups_freed_.Aggregate(source.tile_groups_freed_);
+  tile_group_bytes_freed_.Aggregate(source.tile_group_bytes_freed_);
 
   // Aggregate all per-database metrics
   for (auto &database_item : source.database_metrics_) {
@@ -273,6 +318,12 @@ void BackendStatsContext::Aggregate(BackendStatsContext &source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  commit_latencies_.Reset();
+  log_bytes_flushed_.Reset();
+  index_entries_reclaimed_.Reset();
+  index_bytes_reclaimed_.Reset();
+  tile_groups_freed_.Reset();
+  tile_group_bytes_freed_.Reset();
 
   for (auto &database_item : database_metrics_) {
     database_item.second->Reset();
@@ -334,6 +385,7 @@ std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
   ss << txn_latencies_.GetInfo() << std::endl;
+  ss << "LOG FLUSH " << commit_latencies_.GetInfo() << std::endl;
 
   for (auto &database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
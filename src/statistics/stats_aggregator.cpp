@@ -29,7 +29,8 @@ StatsAggregator::StatsAggregator(int64_t aggregation_interval_ms)
       aggregated_stats_(LATENCY_MAX_HISTORY_AGGREGATOR, false),
       aggregation_interval_ms_(aggregation_interval_ms),
       thread_number_(0),
-      total_prev_txn_committed_(0) {
+      total_prev_txn_committed_(0),
+      total_prev_log_bytes_(0) {
   pool_.reset(new type::EphemeralPool());
   try {
     ofs_.open(peloton_stats_directory_, std::ofstream::out);
@@ -111,6 +112,20 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
   LOG_TRACE("Moving avg. throughput: %lf txn/s", weighted_avg_throughput);
   LOG_TRACE("Current throughput:     %lf txn/s", throughput_);
 
+  // Bytes written to the log during this interval
+  int64_t current_log_bytes =
+      aggregated_stats_.GetLogBytesFlushed().GetCounter();
+  double log_throughput = (double)(current_log_bytes - total_prev_log_bytes_) /
+                          STATS_AGGREGATION_INTERVAL_MS * 1000;
+  total_prev_log_bytes_ = current_log_bytes;
+  LOG_TRACE("Log throughput:         %lf bytes/s", log_throughput);
+  LOG_TRACE("Index entries reclaimed: %" PRId64 " (%" PRId64 " bytes)",
+            aggregated_stats_.GetIndexEntriesReclaimed().GetCounter(),
+            aggregated_stats_.GetIndexBytesReclaimed().GetCounter());
+  LOG_TRACE("Tile groups freed:      %" PRId64 " (%" PRId64 " bytes)",
+            aggregated_stats_.GetTileGroupsFreed().GetCounter(),
+            aggregated_stats_.GetTileGroupBytesFreed().GetCounter());
+
   // Write the stats to metric tables
   UpdateMetrics();
 
@@ -121,7 +136,8 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
       ofs_ << "Weighted avg. throughput=" << weighted_avg_throughput
            << std::endl;
       ofs_ << "Average throughput=" << avg_throughput_ << std::endl;
-      ofs_ << "Current throughput=" << throughput_;
+      ofs_ << "Current throughput=" << throughput_ << std::endl;
+      ofs_ << "Log throughput=" << log_throughput;
     } catch (std::ofstream::failure &e) {
       LOG_ERROR("Error when writing to the stats log file %s", e.what());
     }
@@ -178,6 +194,10 @@ void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp,
                              (int64_t) latency,
                              (int64_t) (cpu_system + cpu_user),
                              time_stamp,
+                             query_metric->GetSpilledBytes().GetCounter(),
+                             query_metric->GetSpillPasses().GetCounter(),
+                             query_metric->GetInterpretedTime().GetCounter(),
+                             query_metric->GetNativeTime().GetCounter(),
                              pool_.get());
 
     LOG_TRACE("Query Metric Tuple inserted");
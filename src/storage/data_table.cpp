@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <mutex>
 #include <utility>
 
@@ -36,6 +37,7 @@
 #include "storage/tile_group_factory.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 #include "tuning/clusterer.h"
 #include "tuning/sample.h"
 
@@ -54,6 +56,25 @@ namespace storage {
 
 oid_t DataTable::invalid_tile_group_id = -1;
 
+// The active tile group and indirection array the calling thread inserts
+// into. Threads are spread over them round-robin when they insert for the
+// first time, so that concurrent inserts don't contend on the same slots.
+static size_t GetActiveShard() {
+  static std::atomic<size_t> next_shard(0);
+  static thread_local size_t shard = next_shard++;
+  return shard;
+}
+
+// A key buffer of the calling thread that is reused across inserts, so that
+// building an index key doesn't allocate.
+static char *GetKeyBuffer(const catalog::Schema *key_schema) {
+  static thread_local std::vector<char> key_buffer;
+  if (key_buffer.size() < key_schema->GetLength()) {
+    key_buffer.resize(key_schema->GetLength());
+  }
+  return key_buffer.data();
+}
+
 size_t DataTable::default_active_tilegroup_count_ = 1;
 size_t DataTable::default_active_indirection_array_count_ = 1;
 
@@ -66,6 +87,8 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
       database_oid(database_oid),
       table_name(table_name),
       tuples_per_tilegroup_(tuples_per_tilegroup),
+      is_catalog_(is_catalog),
+      zone_map_(new ZoneMap(database_oid, table_oid)),
       current_layout_oid_(ATOMIC_VAR_INIT(COLUMN_STORE_LAYOUT_OID)),
       adapt_table_(adapt_table),
       trigger_list_(new trigger::TriggerList()) {
@@ -80,15 +103,11 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
   active_tile_groups_.resize(active_tilegroup_count_);
 
   active_indirection_arrays_.resize(active_indirection_array_count_);
-  // Create tile groups.
-  for (size_t i = 0; i < active_tilegroup_count_; ++i) {
-    AddDefaultTileGroup(i);
-  }
 
-  // Create indirection layers.
-  for (size_t i = 0; i < active_indirection_array_count_; ++i) {
-    AddDefaultIndirectionArray(i);
-  }
+  // Create the tile group and the indirection layer of the first shard. The
+  // other shards get theirs on their first insert.
+  AddDefaultTileGroup(0);
+  AddDefaultIndirectionArray(0);
 }
 
 DataTable::~DataTable() {
@@ -111,6 +130,7 @@ DataTable::~DataTable() {
 
   // drop all indirection arrays
   for (auto indirection_array : active_indirection_arrays_) {
+    if (indirection_array == nullptr) continue;
     auto oid = indirection_array->GetOid();
     catalog_manager.DropIndirectionArray(oid);
   }
@@ -217,21 +237,22 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
       auto tile_group = storage::StorageManager::GetInstance()->GetTileGroup(
           free_item_pointer.block);
       tile_group->CopyTuple(tuple, free_item_pointer.offset);
+      zone_map_->UpdateOnInsert(free_item_pointer.block, *tuple);
+    } else {
+      zone_map_->Invalidate(free_item_pointer.block);
     }
     return free_item_pointer;
   }
   //====================================================
 
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+  size_t active_tile_group_id = GetActiveShard() % active_tilegroup_count_;
   std::shared_ptr<storage::TileGroup> tile_group;
   oid_t tuple_slot = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
 
   // get valid tuple.
+  tile_group = GetActiveTileGroup(active_tile_group_id);
   while (true) {
-    // get the last tile group.
-    tile_group = active_tile_groups_[active_tile_group_id];
-
     tuple_slot = tile_group->InsertTuple(tuple);
 
     // now we have already obtained a new tuple slot.
@@ -239,6 +260,14 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
       tile_group_id = tile_group->GetTileGroupId();
       break;
     }
+
+    // the tile group is full and is being replaced, try the next one instead
+    // of waiting for it. shards that have not inserted yet are skipped.
+    do {
+      active_tile_group_id =
+          (active_tile_group_id + 1) % active_tilegroup_count_;
+      tile_group = active_tile_groups_[active_tile_group_id];
+    } while (tile_group == nullptr);
   }
 
   // if this is the last tuple slot we can get
@@ -251,6 +280,13 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
             tile_group_count_.load(), tile_group->GetTileGroupId(),
             tile_group.get());
 
+  // Keep the zone map of the tile group (if any) covering the new slot
+  if (tuple != nullptr) {
+    zone_map_->UpdateOnInsert(tile_group_id, *tuple);
+  } else {
+    zone_map_->Invalidate(tile_group_id);
+  }
+
   // Set tuple location
   ItemPointer location(tile_group_id, tuple_slot);
 
@@ -404,13 +440,13 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   int index_count = GetIndexCount();
 
   size_t active_indirection_array_id =
-      number_of_tuples_ % active_indirection_array_count_;
+      GetActiveShard() % active_indirection_array_count_;
 
   size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
 
+  auto active_indirection_array =
+      GetActiveIndirectionArray(active_indirection_array_id);
   while (true) {
-    auto active_indirection_array =
-        active_indirection_arrays_[active_indirection_array_id];
     indirection_offset = active_indirection_array->AllocateIndirection();
 
     if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
@@ -418,6 +454,13 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
           active_indirection_array->GetIndirectionByOffset(indirection_offset);
       break;
     }
+
+    do {
+      active_indirection_array_id =
+          (active_indirection_array_id + 1) % active_indirection_array_count_;
+      active_indirection_array =
+          active_indirection_arrays_[active_indirection_array_id];
+    } while (active_indirection_array == nullptr);
   }
 
   (*index_entry_ptr)->block = location.block;
@@ -430,9 +473,11 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
+  // the lambda is small enough to be stored in the std::function itself.
   std::function<bool(const void *)> fn =
-      std::bind(&concurrency::TransactionManager::IsOccupied,
-                &transaction_manager, transaction, std::placeholders::_1);
+      [&transaction_manager, transaction](const void *position_ptr) {
+        return transaction_manager.IsOccupied(transaction, position_ptr);
+      };
 
   // Since this is NOT protected by a lock, concurrent insert may happen.
   bool res = true;
@@ -442,9 +487,9 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
     auto index = GetIndex(index_itr);
     if (index == nullptr) continue;
     auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
-    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    const auto &indexed_columns = index_schema->GetIndexedColumns();
+    storage::Tuple key(index_schema, GetKeyBuffer(index_schema));
+    key.SetFromTuple(tuple, indexed_columns, index->GetPool());
 
     switch (index->GetIndexType()) {
       case IndexConstraintType::PRIMARY_KEY:
@@ -452,12 +497,12 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
         // get unique tuple from primary/unique index.
         // if in this index there has been a visible or uncommitted
         // <key, location> pair, this constraint is violated
-        res = index->CondInsertEntry(key.get(), *index_entry_ptr, fn);
+        res = index->CondInsertEntry(&key, *index_entry_ptr, fn);
       } break;
 
       case IndexConstraintType::DEFAULT:
       default:
-        index->InsertEntry(key.get(), *index_entry_ptr);
+        index->InsertEntry(&key, *index_entry_ptr);
         break;
     }
 
@@ -496,9 +541,11 @@ bool DataTable::InsertInSecondaryIndexes(
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
+  // the lambda is small enough to be stored in the std::function itself.
   std::function<bool(const void *)> fn =
-      std::bind(&concurrency::TransactionManager::IsOccupied,
-                &transaction_manager, transaction, std::placeholders::_1);
+      [&transaction_manager, transaction](const void *position_ptr) {
+        return transaction_manager.IsOccupied(transaction, position_ptr);
+      };
 
   // Check existence for primary/unique indexes
   // Since this is NOT protected by a lock, concurrent insert may happen.
@@ -506,7 +553,7 @@ bool DataTable::InsertInSecondaryIndexes(
     auto index = GetIndex(index_itr);
     if (index == nullptr) continue;
     auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
+    const auto &indexed_columns = index_schema->GetIndexedColumns();
 
     if (index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       continue;
@@ -527,18 +574,18 @@ bool DataTable::InsertInSecondaryIndexes(
     }
 
     // Key attributes are updated, insert a new entry in all secondary index
-    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+    storage::Tuple key(index_schema, GetKeyBuffer(index_schema));
 
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    key.SetFromTuple(tuple, indexed_columns, index->GetPool());
 
     switch (index->GetIndexType()) {
       case IndexConstraintType::PRIMARY_KEY:
       case IndexConstraintType::UNIQUE: {
-        res = index->CondInsertEntry(key.get(), index_entry_ptr, fn);
+        res = index->CondInsertEntry(&key, index_entry_ptr, fn);
       } break;
       case IndexConstraintType::DEFAULT:
       default:
-        index->InsertEntry(key.get(), index_entry_ptr);
+        index->InsertEntry(&key, index_entry_ptr);
         break;
     }
     LOG_TRACE("Index constraint check on %s passed.", index->GetName().c_str());
@@ -868,6 +915,34 @@ oid_t DataTable::AddDefaultIndirectionArray(
   return indirection_array_id;
 }
 
+std::shared_ptr<storage::IndirectionArray>
+DataTable::GetActiveIndirectionArray(
+    const size_t &active_indirection_array_id) {
+  auto indirection_array =
+      active_indirection_arrays_[active_indirection_array_id];
+  if (indirection_array == nullptr) {
+    std::lock_guard<std::mutex> lock(active_shard_mutex_);
+    if (active_indirection_arrays_[active_indirection_array_id] == nullptr) {
+      AddDefaultIndirectionArray(active_indirection_array_id);
+    }
+    indirection_array = active_indirection_arrays_[active_indirection_array_id];
+  }
+  return indirection_array;
+}
+
+std::shared_ptr<storage::TileGroup> DataTable::GetActiveTileGroup(
+    const size_t &active_tile_group_id) {
+  auto tile_group = active_tile_groups_[active_tile_group_id];
+  if (tile_group == nullptr) {
+    std::lock_guard<std::mutex> lock(active_shard_mutex_);
+    if (active_tile_groups_[active_tile_group_id] == nullptr) {
+      AddDefaultTileGroup(active_tile_group_id);
+    }
+    tile_group = active_tile_groups_[active_tile_group_id];
+  }
+  return tile_group;
+}
+
 oid_t DataTable::AddDefaultTileGroup() {
   size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
   return AddDefaultTileGroup(active_tile_group_id);
@@ -1005,10 +1080,25 @@ void DataTable::DropTileGroups() {
 
   // Clear array
   tile_groups_.Clear();
+  zone_map_->Clear();
 
   tile_group_count_ = 0;
 }
 
+bool DataTable::DropTileGroup(const oid_t &tile_group_id) {
+  size_t tile_group_count = tile_group_count_;
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    if (tile_groups_.Find(offset) == tile_group_id) {
+      // scans skip the offsets of dropped tile groups
+      tile_groups_.Erase(offset, invalid_tile_group_id);
+      zone_map_->Invalidate(tile_group_id);
+      LOG_TRACE("Dropped tile group %u at offset %lu", tile_group_id, offset);
+      return true;
+    }
+  }
+  return false;
+}
+
 //===--------------------------------------------------------------------===//
 // INDEX
 //===--------------------------------------------------------------------===//
@@ -1212,6 +1302,9 @@ storage::TileGroup *DataTable::TransformTileGroup(
   // Get orig tile group from catalog
   auto storage_tilegroup = storage::StorageManager::GetInstance();
   auto tile_group = storage_tilegroup->GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    return nullptr;
+  }
   auto diff = tile_group->GetLayout().GetLayoutDifference(*default_layout_);
 
   // Check threshold for transformation
@@ -17,6 +17,7 @@
 #include "common/logger.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "optimizer/stats/stats_cache.h"
 #include "storage/database.h"
 #include "storage/table_factory.h"
 
@@ -78,6 +79,9 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     // Deregister table from Query Cache manager
     codegen::QueryCache::Instance().Remove(table_oid);
 
+    // Drop the cached optimizer stats of the table
+    optimizer::StatsCache::GetInstance()->Invalidate(table_oid);
+
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
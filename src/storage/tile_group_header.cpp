@@ -36,7 +36,8 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
       tile_group(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      num_recycled(0) {
   tuple_headers_.reset(new TupleHeader[tuple_count]);
 
   // Set MVCC Initial Value
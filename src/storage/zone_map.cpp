@@ -0,0 +1,255 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map_manager.h"
+
+namespace peloton {
+namespace storage {
+
+ZoneMap::ZoneMap(oid_t database_oid, oid_t table_oid)
+    : database_oid_(database_oid),
+      table_oid_(table_oid),
+      num_zone_maps_(0),
+      version_(0) {}
+
+std::shared_ptr<const ZoneMap::TileGroupZoneMap> ZoneMap::GetTileGroupZoneMap(
+    oid_t tile_group_offset) const {
+  if (tile_group_offset >= zone_maps_.size()) {
+    return nullptr;
+  }
+  return std::atomic_load(&zone_maps_[tile_group_offset]);
+}
+
+/**
+ * @brief Compute the zone map of every column of the given tile group from
+ * all the versions it holds and install it. Invisible versions are included,
+ * which only makes the zone map wider and hence never wrong.
+ *
+ * @param tile_group_offset The 0-based offset of the tile group in the table
+ * @param tile_group The tile group to summarize
+ * @param persist_in_background Whether the ZoneMapManager should write the
+ * new zone map to the catalog in the background
+ *
+ * @return The installed snapshot
+ */
+std::shared_ptr<const ZoneMap::TileGroupZoneMap> ZoneMap::BuildTileGroupZoneMap(
+    oid_t tile_group_offset, TileGroup &tile_group,
+    bool persist_in_background) {
+  std::shared_ptr<TileGroupZoneMap> zone_map(new TileGroupZoneMap());
+  zone_map->tile_group_offset = tile_group_offset;
+
+  oid_t num_columns = tile_group.GetLayout().GetColumnCount();
+  oid_t num_tuple_slots = tile_group.GetNextTupleSlot();
+  zone_map->columns.resize(num_columns);
+
+  for (oid_t col_itr = 0; col_itr < num_columns; col_itr++) {
+    auto &column = zone_map->columns[col_itr];
+    column.null_count = 0;
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+      WidenColumn(column, tile_group.GetValue(tuple_itr, col_itr));
+    }
+  }
+
+  // Remember where the tile group lives so writers can find its zone map
+  tile_group_offsets_.Upsert(tile_group.GetTileGroupId(), tile_group_offset);
+
+  return Install(tile_group_offset, std::move(zone_map),
+                 persist_in_background);
+}
+
+/**
+ * @brief Widen the zone map of the tile group holding a newly inserted tuple.
+ * This is a no-op for tile groups without a zone map, which is the common
+ * case since zone maps are usually only built for immutable tile groups.
+ *
+ * @param tile_group_id The global ID of the tile group the tuple went into
+ * @param tuple The inserted tuple
+ */
+void ZoneMap::UpdateOnInsert(oid_t tile_group_id, const AbstractTuple &tuple) {
+  if (num_zone_maps_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  oid_t tile_group_offset;
+  if (!tile_group_offsets_.Find(tile_group_id, tile_group_offset)) {
+    return;
+  }
+
+  auto old_zone_map = GetTileGroupZoneMap(tile_group_offset);
+  if (old_zone_map == nullptr) {
+    return;
+  }
+
+  // Copy-on-write. If another writer installs a snapshot in the meantime, it
+  // may not cover this tuple, so retry against the newer snapshot.
+  while (old_zone_map != nullptr) {
+    std::shared_ptr<TileGroupZoneMap> new_zone_map(
+        new TileGroupZoneMap(*old_zone_map));
+    for (oid_t col_itr = 0; col_itr < new_zone_map->columns.size();
+         col_itr++) {
+      WidenColumn(new_zone_map->columns[col_itr], tuple.GetValue(col_itr));
+    }
+    new_zone_map->version = ++version_;
+
+    std::shared_ptr<const TileGroupZoneMap> desired = new_zone_map;
+    if (std::atomic_compare_exchange_strong(&zone_maps_[tile_group_offset],
+                                            &old_zone_map, desired)) {
+      ZoneMapManager::GetInstance()->EnqueueForPersistence(
+          database_oid_, table_oid_, desired);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Drop the zone map of a tile group whose slot is about to be written
+ * with contents we do not know yet.
+ *
+ * @param tile_group_id The global ID of the tile group
+ */
+void ZoneMap::Invalidate(oid_t tile_group_id) {
+  if (num_zone_maps_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  oid_t tile_group_offset;
+  if (!tile_group_offsets_.Find(tile_group_id, tile_group_offset)) {
+    return;
+  }
+
+  auto old_zone_map = std::atomic_exchange(
+      &zone_maps_[tile_group_offset],
+      std::shared_ptr<const TileGroupZoneMap>());
+  if (old_zone_map != nullptr) {
+    num_zone_maps_--;
+    version_++;
+  }
+}
+
+void ZoneMap::Clear() {
+  for (size_t offset = 0; offset < zone_maps_.size(); offset++) {
+    std::atomic_store(&zone_maps_[offset],
+                      std::shared_ptr<const TileGroupZoneMap>());
+  }
+  tile_group_offsets_.Clear();
+  num_zone_maps_ = 0;
+  version_++;
+}
+
+/**
+ * @brief Check the predicates against the zone map of the tile group. All
+ * predicates are conjunctive, so a single predicate that cannot be satisfied
+ * by the zone map is enough to skip the tile group.
+ *
+ * @param parsed_predicates The predicates of the scan
+ * @param num_predicates The number of predicates
+ * @param tile_group_offset The 0-based offset of the tile group in the table
+ *
+ * @return True if tile group needs to be scanned, false if it can be skipped
+ */
+bool ZoneMap::ShouldScanTileGroup(PredicateInfo *parsed_predicates,
+                                  int32_t num_predicates,
+                                  int64_t tile_group_offset) const {
+  if (num_predicates == 0) {
+    return true;
+  }
+
+  auto zone_map = GetTileGroupZoneMap(static_cast<oid_t>(tile_group_offset));
+  if (zone_map == nullptr) {
+    return true;
+  }
+
+  for (int32_t i = 0; i < num_predicates; i++) {
+    const auto &predicate = parsed_predicates[i];
+    PELOTON_ASSERT(predicate.col_id >= 0 &&
+                   static_cast<size_t>(predicate.col_id) <
+                       zone_map->columns.size());
+    if (!CheckPredicate(predicate, zone_map->columns[predicate.col_id])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Utilities
+//===--------------------------------------------------------------------===//
+
+std::shared_ptr<const ZoneMap::TileGroupZoneMap> ZoneMap::Install(
+    oid_t tile_group_offset, std::shared_ptr<TileGroupZoneMap> new_zone_map,
+    bool persist_in_background) {
+  new_zone_map->version = ++version_;
+  std::shared_ptr<const TileGroupZoneMap> zone_map = std::move(new_zone_map);
+
+  zone_maps_.grow_to_at_least(tile_group_offset + 1);
+  auto old_zone_map =
+      std::atomic_exchange(&zone_maps_[tile_group_offset], zone_map);
+  if (old_zone_map == nullptr) {
+    num_zone_maps_++;
+  }
+
+  if (persist_in_background) {
+    ZoneMapManager::GetInstance()->EnqueueForPersistence(database_oid_,
+                                                         table_oid_, zone_map);
+  }
+  return zone_map;
+}
+
+void ZoneMap::WidenColumn(ColumnZoneMap &column, const type::Value &value) {
+  if (value.IsNull()) {
+    column.null_count++;
+    return;
+  }
+  // min and max stay INVALID until the first non-null value shows up
+  if (column.min.GetTypeId() == type::TypeId::INVALID ||
+      value.CompareLessThan(column.min) == CmpBool::CmpTrue) {
+    column.min = value.Copy();
+  }
+  if (column.max.GetTypeId() == type::TypeId::INVALID ||
+      value.CompareGreaterThan(column.max) == CmpBool::CmpTrue) {
+    column.max = value.Copy();
+  }
+}
+
+bool ZoneMap::CheckPredicate(const PredicateInfo &predicate,
+                             const ColumnZoneMap &column) {
+  // Comparisons against NULL are never true, so a tile group in which the
+  // column is all NULL never satisfies the predicate.
+  if (column.min.GetTypeId() == type::TypeId::INVALID) {
+    return false;
+  }
+
+  const type::Value &value = predicate.predicate_value;
+  switch (predicate.comparison_operator) {
+    case (int)ExpressionType::COMPARE_EQUAL:
+      return column.min.CompareLessThanEquals(value) == CmpBool::CmpTrue &&
+             column.max.CompareGreaterThanEquals(value) == CmpBool::CmpTrue;
+    case (int)ExpressionType::COMPARE_LESSTHAN:
+      return value.CompareGreaterThan(column.min) == CmpBool::CmpTrue;
+    case (int)ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return value.CompareGreaterThanEquals(column.min) == CmpBool::CmpTrue;
+    case (int)ExpressionType::COMPARE_GREATERTHAN:
+      return value.CompareLessThan(column.max) == CmpBool::CmpTrue;
+    case (int)ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return value.CompareLessThanEquals(column.max) == CmpBool::CmpTrue;
+    default: { throw Exception{"Invalid expression type for translation "}; }
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -12,6 +12,10 @@
 
 #include "storage/zone_map_manager.h"
 
+#include <chrono>
+#include <map>
+#include <tuple>
+
 #include "catalog/catalog.h"
 #include "catalog/zone_map_catalog.h"
 #include "catalog/database_catalog.h"
@@ -32,7 +36,8 @@ ZoneMapManager *ZoneMapManager::GetInstance() {
   return &global_zone_map_manager;
 }
 
-ZoneMapManager::ZoneMapManager() {
+ZoneMapManager::ZoneMapManager()
+    : pending_zone_maps_(1024), persister_running_(false) {
   zone_map_table_exists = false;
   pool_.reset(new type::EphemeralPool());
 }
@@ -64,7 +69,10 @@ void ZoneMapManager::CreateZoneMapsForTable(
   for (size_t i = 0; i < num_tile_groups; i++) {
     auto tile_group = table->GetTileGroup(i);
     auto tile_group_ptr = tile_group.get();
-    PELOTON_ASSERT(tile_group_ptr != nullptr);
+    // skip the tile groups that have been compacted and freed
+    if (tile_group_ptr == nullptr) {
+      continue;
+    }
     auto tile_group_header = tile_group_ptr->GetHeader();
     PELOTON_ASSERT(tile_group_header != nullptr);
     bool immutable = tile_group_header->GetImmutability();
@@ -76,7 +84,10 @@ void ZoneMapManager::CreateZoneMapsForTable(
 
 /**
  * @brief The function creates zone maps for a given tile group. If it already
- * exists it is deleted and replaced with the updated values.
+ * exists it is replaced with the updated values. The in-memory zone map of the
+ * table is updated right away. If a transaction is given, the zone map is also
+ * written to the catalog under it; otherwise it is persisted in the
+ * background.
  *
  * @param table The table we're creating the zone map for
  * @param tile_group_idx The ID of the tile group we're creating the zone map
@@ -87,34 +98,42 @@ void ZoneMapManager::CreateOrUpdateZoneMapForTileGroup(
     concurrency::TransactionContext *txn) {
   LOG_DEBUG("Creating Zone Maps for TileGroupId : %u", tile_group_idx);
 
-  oid_t database_id = table->GetDatabaseOid();
-  oid_t table_id = table->GetOid();
-  auto schema = table->GetSchema();
-  size_t num_columns = schema->GetColumnCount();
   auto tile_group = table->GetTileGroup(tile_group_idx);
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  bool persist_in_background = (txn == nullptr);
+  auto zone_map = table->GetZoneMap()->BuildTileGroupZoneMap(
+      tile_group_idx, *tile_group, persist_in_background);
+
+  if (!persist_in_background) {
+    PersistTileGroupZoneMap(table->GetDatabaseOid(), table->GetOid(),
+                            *zone_map, txn);
+  }
+}
 
-  for (oid_t col_itr = 0; col_itr < num_columns; col_itr++) {
-    // Set temp min and temp max as the first value.
-    type::Value min = tile_group->GetValue(0, col_itr);
-    type::Value max = tile_group->GetValue(0, col_itr);
-    // Iterate over all tuples in this column
-    oid_t num_tuple_slots = tile_group->GetAllocatedTupleCount();
-    for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
-      type::Value current_val = tile_group->GetValue(tuple_itr, col_itr);
-      if (current_val.CompareGreaterThan(max) == CmpBool::CmpTrue) {
-        max = current_val;
-      }
-      if (current_val.CompareLessThan(min) == CmpBool::CmpTrue) {
-        min = current_val;
-      }
+/**
+ * @brief Write the zone map of every column of a tile group to the catalog.
+ * Columns that only hold NULLs have no min/max and are left out, which makes
+ * catalog readers scan the tile group.
+ */
+void ZoneMapManager::PersistTileGroupZoneMap(
+    oid_t database_id, oid_t table_id, const ZoneMap::TileGroupZoneMap &zone_map,
+    concurrency::TransactionContext *txn) {
+  for (oid_t col_itr = 0; col_itr < zone_map.columns.size(); col_itr++) {
+    const auto &column = zone_map.columns[col_itr];
+    if (column.min.GetTypeId() == type::TypeId::INVALID) {
+      continue;
     }
-    type::TypeId val_type = min.GetTypeId();
-    std::string converted_min = min.ToString();
-    std::string converted_max = max.ToString();
+    type::TypeId val_type = column.min.GetTypeId();
+    std::string converted_min = column.min.ToString();
+    std::string converted_max = column.max.ToString();
     std::string converted_type = TypeIdToString(val_type);
 
-    CreateOrUpdateZoneMapInCatalog(database_id, table_id, tile_group_idx,
-                                   col_itr, converted_min, converted_max,
+    CreateOrUpdateZoneMapInCatalog(database_id, table_id,
+                                   zone_map.tile_group_offset, col_itr,
+                                   converted_min, converted_max,
                                    converted_type, txn);
   }
 }
@@ -218,8 +237,8 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 }
 
 /**
- * The function compares the predicate against the zone map for the column
- * present in catalog.
+ * The function compares the predicate against the in-memory zone map of the
+ * table. The catalog is not consulted.
  *
  * @param parsed predicates array
  * @param num_predicates
@@ -231,51 +250,8 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 bool ZoneMapManager::ShouldScanTileGroup(
     storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
     storage::DataTable *table, int64_t tile_group_idx) {
-  for (int32_t i = 0; i < num_predicates; i++) {
-    // Extract the col_id, operator and predicate_value
-    int col_id = parsed_predicates[i].col_id;
-    int comparison_operator = parsed_predicates[i].comparison_operator;
-    type::Value predicate_value = parsed_predicates[i].predicate_value;
-
-    oid_t database_id = table->GetDatabaseOid();
-    oid_t table_id = table->GetOid();
-
-    std::unique_ptr<ZoneMapManager::ColumnStatistics> stats =
-        GetZoneMapFromCatalog(database_id, table_id, tile_group_idx, col_id);
-
-    if (stats == nullptr) {
-      return true;
-    }
-    switch (comparison_operator) {
-      case (int)ExpressionType::COMPARE_EQUAL:
-        if (!CheckEqual(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_LESSTHAN:
-        if (!CheckLessThan(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_LESSTHANOREQUALTO:
-        if (!CheckLessThanEquals(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_GREATERTHAN:
-        if (!CheckGreaterThan(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_GREATERTHANOREQUALTO:
-        if (!CheckGreaterThanEquals(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      default: { throw Exception{"Invalid expression type for translation "}; }
-    }
-  }
-  return true;
+  return table->GetZoneMap()->ShouldScanTileGroup(
+      parsed_predicates, num_predicates, tile_group_idx);
 }
 
 /**
@@ -285,5 +261,93 @@ bool ZoneMapManager::ShouldScanTileGroup(
  */
 bool ZoneMapManager::ZoneMapTableExists() { return zone_map_table_exists; }
 
+//===--------------------------------------------------------------------===//
+// Background Persistence
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Queue a freshly installed in-memory zone map for being written to the
+ * catalog by the persister thread.
+ */
+void ZoneMapManager::EnqueueForPersistence(
+    oid_t database_id, oid_t table_id,
+    std::shared_ptr<const ZoneMap::TileGroupZoneMap> zone_map) {
+  pending_zone_maps_.Enqueue(
+      PendingZoneMap{database_id, table_id, std::move(zone_map)});
+}
+
+/**
+ * @brief Drain the pending queue and write the zone maps to the catalog in a
+ * single transaction. If a tile group was updated several times since the
+ * last drain, only its newest zone map is written.
+ *
+ * @return The number of tile group zone maps written
+ */
+size_t ZoneMapManager::PersistPendingZoneMaps() {
+  std::map<std::tuple<oid_t, oid_t, oid_t>, PendingZoneMap> latest;
+  PendingZoneMap pending;
+  while (pending_zone_maps_.Dequeue(pending)) {
+    auto key = std::make_tuple(pending.database_id, pending.table_id,
+                               pending.zone_map->tile_group_offset);
+    auto iter = latest.find(key);
+    if (iter == latest.end() ||
+        iter->second.zone_map->version < pending.zone_map->version) {
+      latest[key] = std::move(pending);
+    }
+  }
+
+  if (latest.empty() || !ZoneMapTableExists()) {
+    return 0;
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  for (const auto &entry : latest) {
+    const auto &zone_map = entry.second;
+    PersistTileGroupZoneMap(zone_map.database_id, zone_map.table_id,
+                            *zone_map.zone_map, txn);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  LOG_TRACE("Persisted %lu zone maps", latest.size());
+  return latest.size();
+}
+
+void ZoneMapManager::StartPersister() {
+  if (persister_running_.exchange(true)) {
+    return;
+  }
+  persister_thread_ = std::thread(&ZoneMapManager::RunPersister, this);
+  LOG_INFO("Started zone map persister");
+}
+
+void ZoneMapManager::StopPersister() {
+  {
+    std::lock_guard<std::mutex> lock(persister_mutex_);
+    if (!persister_running_.exchange(false)) {
+      return;
+    }
+  }
+  persister_cv_.notify_all();
+  persister_thread_.join();
+
+  // Flush whatever was installed since the last round
+  PersistPendingZoneMaps();
+  LOG_INFO("Stopped zone map persister");
+}
+
+void ZoneMapManager::RunPersister() {
+  std::unique_lock<std::mutex> lock(persister_mutex_);
+  while (persister_running_.load()) {
+    persister_cv_.wait_for(lock, std::chrono::milliseconds(kPersistIntervalMs));
+    if (!persister_running_.load()) {
+      break;
+    }
+    lock.unlock();
+    PersistPendingZoneMaps();
+    lock.lock();
+  }
+}
+
 }  // namespace storage
 }  // namespace peloton
\ No newline at end of file
@@ -12,6 +12,8 @@
 
 #include "threadpool/worker_pool.h"
 
+#include <chrono>
+
 #include "common/logger.h"
 
 namespace peloton {
@@ -19,44 +21,47 @@ namespace threadpool {
 
 namespace {
 
-void WorkerFunc(std::string thread_name, std::atomic_bool *is_running,
-                TaskQueue *task_queue) {
-  constexpr auto kMinPauseTime = std::chrono::microseconds(1);
-  constexpr auto kMaxPauseTime = std::chrono::microseconds(1000);
-
-  LOG_INFO("Thread %s starting ...", thread_name.c_str());
+// The pool and the id of the worker running on the current thread, if any
+thread_local WorkerPool *current_pool = nullptr;
+thread_local uint32_t current_worker_id = 0;
 
-  auto pause_time = kMinPauseTime;
-  while (is_running->load() || !task_queue->IsEmpty()) {
-    std::function<void()> task;
-    if (!task_queue->Dequeue(task)) {
-      // Polling with exponential back-off
-      std::this_thread::sleep_for(pause_time);
-      pause_time = std::min(pause_time * 2, kMaxPauseTime);
-    } else {
-      task();
-      pause_time = kMinPauseTime;
-    }
-  }
+// The number of times a worker looks for tasks again before going to sleep.
+// Bursts of tasks often arrive right after a task finished.
+constexpr uint32_t kSpinRounds = 16;
 
-  LOG_INFO("Thread %s exiting ...", thread_name.c_str());
+uint64_t NowNanos() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
 }
 
 }  // namespace
 
 WorkerPool::WorkerPool(const std::string &pool_name, uint32_t num_workers,
-                       TaskQueue &task_queue)
+                       uint32_t task_queue_size)
     : pool_name_(pool_name),
       num_workers_(num_workers),
       is_running_(false),
-      task_queue_(task_queue) {}
+      shared_queue_(task_queue_size),
+      num_pending_(0),
+      num_parked_workers_(0),
+      num_submitted_(0),
+      num_dequeued_(0),
+      num_stolen_(0),
+      num_parked_(0),
+      total_wait_ns_(0),
+      max_wait_ns_(0) {
+  for (uint32_t i = 0; i < num_workers_; i++) {
+    worker_queues_.emplace_back(new WorkerQueue());
+  }
+}
 
 void WorkerPool::Startup() {
   bool running = false;
   if (is_running_.compare_exchange_strong(running, true)) {
-    for (size_t i = 0; i < num_workers_; i++) {
-      std::string name = pool_name_ + "-worker-" + std::to_string(i);
-      workers_.emplace_back(WorkerFunc, name, &is_running_, &task_queue_);
+    for (uint32_t i = 0; i < num_workers_; i++) {
+      workers_.emplace_back(&WorkerPool::WorkerLoop, this, i);
     }
   }
 }
@@ -64,7 +69,11 @@ void WorkerPool::Startup() {
 void WorkerPool::Shutdown() {
   bool running = true;
   if (is_running_.compare_exchange_strong(running, false)) {
-    is_running_ = false;
+    {
+      // Wake up all sleeping workers so they see the pool is shutting down
+      std::lock_guard<std::mutex> lock(park_mutex_);
+      park_cv_.notify_all();
+    }
     for (auto &worker : workers_) {
       worker.join();
     }
@@ -72,5 +81,147 @@ void WorkerPool::Shutdown() {
   }
 }
 
+void WorkerPool::SubmitTask(Task task) {
+  QueuedTask queued{std::move(task), NowNanos()};
+  CountTask();
+  if (current_pool == this) {
+    // Tasks spawned by a worker stay with it, they likely share its data
+    auto &queue = *worker_queues_[current_worker_id];
+    queue.latch.Lock();
+    queue.tasks.emplace_back(std::move(queued));
+    queue.latch.Unlock();
+  } else {
+    shared_queue_.Enqueue(std::move(queued));
+  }
+  WakeWorker();
+}
+
+void WorkerPool::SubmitTask(Task task, uint32_t worker_hint) {
+  QueuedTask queued{std::move(task), NowNanos()};
+  CountTask();
+  auto &queue = *worker_queues_[worker_hint % num_workers_];
+  queue.latch.Lock();
+  queue.tasks.emplace_back(std::move(queued));
+  queue.latch.Unlock();
+  WakeWorker();
+}
+
+WorkerPoolMetrics WorkerPool::GetMetrics() const {
+  WorkerPoolMetrics metrics;
+  metrics.num_submitted = num_submitted_.load();
+  metrics.num_dequeued = num_dequeued_.load();
+  metrics.num_stolen = num_stolen_.load();
+  metrics.num_parked = num_parked_.load();
+  metrics.queue_depth = num_pending_.load();
+  metrics.total_wait_ns = total_wait_ns_.load();
+  metrics.max_wait_ns = max_wait_ns_.load();
+  return metrics;
+}
+
+void WorkerPool::CountTask() {
+  // Tasks are counted before they are queued, so a worker never takes a task
+  // that isn't counted yet
+  num_submitted_++;
+  num_pending_++;
+}
+
+void WorkerPool::WakeWorker() {
+  // A worker counts itself as parked before checking for pending tasks a last
+  // time, and tasks are counted before checking for parked workers here, so
+  // one of the two always sees the other.
+  if (num_parked_workers_.load() > 0) {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_one();
+  }
+}
+
+void WorkerPool::WorkerLoop(uint32_t worker_id) {
+  std::string thread_name = pool_name_ + "-worker-" + std::to_string(worker_id);
+  LOG_INFO("Thread %s starting ...", thread_name.c_str());
+
+  current_pool = this;
+  current_worker_id = worker_id;
+
+  QueuedTask task;
+  uint32_t spin_rounds = 0;
+  while (true) {
+    if (NextTask(worker_id, task)) {
+      RunTask(task);
+      spin_rounds = 0;
+      continue;
+    }
+
+    if (spin_rounds++ < kSpinRounds) {
+      std::this_thread::yield();
+      continue;
+    }
+    spin_rounds = 0;
+
+    // Nothing to do, sleep until a task is submitted. Pending tasks are always
+    // drained before shutting down.
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    if (num_pending_.load() > 0) continue;
+    if (!is_running_.load()) break;
+
+    num_parked_workers_++;
+    num_parked_++;
+    park_cv_.wait(lock, [this] {
+      return num_pending_.load() > 0 || !is_running_.load();
+    });
+    num_parked_workers_--;
+  }
+
+  current_pool = nullptr;
+  LOG_INFO("Thread %s exiting ...", thread_name.c_str());
+}
+
+bool WorkerPool::NextTask(uint32_t worker_id, QueuedTask &task) {
+  // Our own queue first, then the tasks from outside the pool
+  if (PopTask(*worker_queues_[worker_id], task) ||
+      shared_queue_.Dequeue(task)) {
+    num_pending_--;
+    return true;
+  }
+
+  // Steal from the other workers, starting at our neighbour so that thieves
+  // spread out over the victims
+  for (uint32_t i = 1; i < num_workers_; i++) {
+    auto &victim = *worker_queues_[(worker_id + i) % num_workers_];
+    if (PopTask(victim, task)) {
+      num_pending_--;
+      num_stolen_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool WorkerPool::PopTask(WorkerQueue &queue, QueuedTask &task) {
+  queue.latch.Lock();
+  if (queue.tasks.empty()) {
+    queue.latch.Unlock();
+    return false;
+  }
+  task = std::move(queue.tasks.front());
+  queue.tasks.pop_front();
+  queue.latch.Unlock();
+  return true;
+}
+
+void WorkerPool::RunTask(QueuedTask &task) {
+  uint64_t wait_ns = NowNanos() - task.submit_time;
+  num_dequeued_++;
+  total_wait_ns_ += wait_ns;
+  uint64_t max_wait_ns = max_wait_ns_.load();
+  while (wait_ns > max_wait_ns &&
+         !max_wait_ns_.compare_exchange_weak(max_wait_ns, wait_ns)) {
+  }
+
+  task.func();
+
+  // Release whatever the task captured before waiting for the next one
+  task.func = nullptr;
+}
+
 }  // namespace threadpool
 }  // namespace peloton
@@ -152,7 +152,8 @@ ResultType TrafficCop::ExecuteStatementGetResult() {
 executor::ExecutionResult TrafficCop::ExecuteHelper(
     std::shared_ptr<planner::AbstractPlan> plan,
     const std::vector<type::Value> &params, std::vector<ResultValue> &result,
-    const std::vector<int> &result_format, size_t thread_id) {
+    const std::vector<int> &result_format, size_t thread_id,
+    const std::string *copy_input) {
   auto &curr_state = GetCurrentTxnState();
 
   concurrency::TransactionContext *txn;
@@ -191,10 +192,11 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
   };
 
   auto &pool = threadpool::MonoQueuePool::GetInstance();
-  pool.SubmitTask([plan, txn, &params, &result_format, on_complete] {
-    executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
-                                        on_complete);
-  });
+  pool.SubmitTask(
+      [plan, txn, &params, &result_format, on_complete, copy_input] {
+        executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
+                                            on_complete, copy_input);
+      });
 
   is_queuing_ = true;
 
@@ -206,6 +208,19 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
 void TrafficCop::ExecuteStatementPlanGetResult() {
   if (p_status_.m_result == ResultType::FAILURE) return;
 
+  // The plan ran on a worker thread, record what it spilled and how long it
+  // ran in each mode in the metric of the query on this thread
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    auto *stats_context = stats::BackendStatsContext::GetInstance();
+    if (p_status_.m_spilled_bytes > 0) {
+      stats_context->IncrementQuerySpill(p_status_.m_spilled_bytes,
+                                         p_status_.m_spill_passes);
+    }
+    stats_context->IncrementQueryExecutionTime(p_status_.m_interpreted_ms,
+                                               p_status_.m_native_ms);
+  }
+
   auto txn_result = GetCurrentTxnState().first->GetResult();
   if (single_statement_txn_ || txn_result == ResultType::FAILURE) {
     LOG_TRACE("About to commit/abort: single stmt: %d,txn_result: %s",
@@ -232,6 +247,24 @@ void TrafficCop::ExecuteStatementPlanGetResult() {
   }
 }
 
+ResultType TrafficCop::ExecuteCopyChunkGetResult() {
+  auto status = ExecuteStatementGetResult();
+  if (status == ResultType::TO_ABORT) return status;
+
+  // A failed chunk fails the whole COPY, abort it like an invalid statement
+  if (status == ResultType::FAILURE ||
+      GetCurrentTxnState().first->GetResult() == ResultType::FAILURE) {
+    ProcessInvalidStatement();
+    return ResultType::FAILURE;
+  }
+  return status;
+}
+
+ResultType TrafficCop::CommitCopyIn() {
+  if (!single_statement_txn_) return ResultType::SUCCESS;
+  return CommitQueryHelper();
+}
+
 /*
  * Prepare a statement based on parse tree. Begin a transaction if necessary.
  * If the query is not issued in a transaction (if txn_stack is empty and it's
@@ -161,6 +161,10 @@ TEST_F(CatalogTests, CreatingTable) {
                            1,
                            1,
                            1,
+                           0,
+                           0,
+                           0,
+                           0,
                            pool.get());
   auto param1 = catalog->GetSystemCatalogs(database_object->GetDatabaseOid())
                     ->GetQueryMetricsCatalog()
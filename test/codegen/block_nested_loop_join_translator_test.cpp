@@ -56,6 +56,11 @@ class BlockNestedLoopJoinTranslatorTest : public PelotonCodeGenTest {
                    const std::vector<oid_t> &right_join_cols,
                    std::vector<codegen::WrappedTuple> &results);
 
+  // Semi and anti joins only output the columns of the left table
+  void PerformSemiOrAntiJoinTest(JoinType join_type,
+                                 ExpressionPtr &&predicate,
+                                 std::vector<codegen::WrappedTuple> &results);
+
   type::Value GetCol(const AbstractTuple &t, JoinOutputColPos p);
 };
 
@@ -104,6 +109,39 @@ void BlockNestedLoopJoinTranslatorTest::PerformTest(
   results = buffer.GetOutputTuples();
 }
 
+void BlockNestedLoopJoinTranslatorTest::PerformSemiOrAntiJoinTest(
+    JoinType join_type, ExpressionPtr &&predicate,
+    std::vector<codegen::WrappedTuple> &results) {
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(0, 1)},
+                                   {2, std::make_pair(0, 2)}};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  auto schema = std::shared_ptr<const catalog::Schema>(new catalog::Schema(
+      {GetTestColumn(0), GetTestColumn(1), GetTestColumn(2)}));
+
+  PlanPtr nlj_plan{new planner::NestedLoopJoinPlan(
+      join_type, std::move(predicate), std::move(projection), schema, {}, {})};
+
+  PlanPtr left_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})};
+  PlanPtr right_scan{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+  nlj_plan->AddChild(std::move(left_scan));
+  nlj_plan->AddChild(std::move(right_scan));
+
+  planner::BindingContext context;
+  nlj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+
+  CompileAndExecute(*nlj_plan, buffer);
+
+  results = buffer.GetOutputTuples();
+}
+
 type::Value BlockNestedLoopJoinTranslatorTest::GetCol(const AbstractTuple &t,
                                                       JoinOutputColPos p) {
   return t.GetValue(static_cast<oid_t>(p));
@@ -268,5 +306,63 @@ TEST_F(BlockNestedLoopJoinTranslatorTest, NonEqualityJoin) {
   }
 }
 
+TEST_F(BlockNestedLoopJoinTranslatorTest, SemiAndAntiJoin) {
+  // Every left tuple except the first (A = 0) has many right tuples with a
+  // smaller B, but must be produced only once
+  {
+    LOG_INFO(
+        "Testing: "
+        "SELECT * FROM table1 WHERE EXISTS "
+        "(SELECT * FROM table2 WHERE table1.A > table2.B)");
+    bool left_side = true;
+    auto left_a_col = ColRefExpr(type::TypeId::INTEGER, left_side, 0);
+    auto right_b_col = ColRefExpr(type::TypeId::INTEGER, !left_side, 1);
+    auto left_a_gt_right_b =
+        CmpGtExpr(std::move(left_a_col), std::move(right_b_col));
+
+    std::vector<codegen::WrappedTuple> results;
+    PerformSemiOrAntiJoinTest(JoinType::SEMI, std::move(left_a_gt_right_b),
+                              results);
+
+    EXPECT_EQ(19, results.size());
+    for (const auto &t : results) {
+      EXPECT_TRUE(GetCol(t, JoinOutputColPos::Table1_ColA)
+                      .CompareNotEquals(type::ValueFactory::GetIntegerValue(
+                          0)) == CmpBool::CmpTrue);
+    }
+  }
+
+  {
+    LOG_INFO(
+        "Testing: "
+        "SELECT * FROM table1 WHERE NOT EXISTS "
+        "(SELECT * FROM table2 WHERE table1.A > table2.B)");
+    bool left_side = true;
+    auto left_a_col = ColRefExpr(type::TypeId::INTEGER, left_side, 0);
+    auto right_b_col = ColRefExpr(type::TypeId::INTEGER, !left_side, 1);
+    auto left_a_gt_right_b =
+        CmpGtExpr(std::move(left_a_col), std::move(right_b_col));
+
+    std::vector<codegen::WrappedTuple> results;
+    PerformSemiOrAntiJoinTest(JoinType::ANTI, std::move(left_a_gt_right_b),
+                              results);
+
+    ASSERT_EQ(1, results.size());
+    EXPECT_TRUE(GetCol(results[0], JoinOutputColPos::Table1_ColA)
+                    .CompareEquals(type::ValueFactory::GetIntegerValue(0)) ==
+                CmpBool::CmpTrue);
+  }
+
+  {
+    LOG_INFO(
+        "Testing: "
+        "SELECT * FROM table1 WHERE NOT EXISTS (SELECT * FROM table2)");
+    std::vector<codegen::WrappedTuple> results;
+    PerformSemiOrAntiJoinTest(JoinType::ANTI, nullptr, results);
+
+    EXPECT_EQ(0, results.size());
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
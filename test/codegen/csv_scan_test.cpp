@@ -157,6 +157,43 @@ TEST_F(CSVScanTest, MixedStringTest) {
   EXPECT_EQ(rows.size(), rows_read);
 }
 
+TEST_F(CSVScanTest, MemoryInputTest) {
+  // Rows streamed by a client (COPY FROM STDIN) are scanned from memory. Use
+  // enough rows to span several read-buffers, some with quoted newlines.
+  std::vector<codegen::type::Type> types = {{type::TypeId::INTEGER, false},
+                                            {type::TypeId::VARCHAR, false}};
+  const uint32_t num_rows = 10000;
+  std::string csv_data;
+  for (uint32_t i = 0; i < num_rows; i++) {
+    csv_data.append(std::to_string(i))
+        .append(i % 7 == 0 ? ",\"multi\nline\"\n" : ",single line\n");
+  }
+  ASSERT_GT(csv_data.size(), codegen::util::CSVScanner::kDefaultBufferSize);
+
+  uint32_t rows_read = 0;
+  State state = {
+      .scanner = nullptr,
+      .callback = [&rows_read](const codegen::util::CSVScanner::Column *cols) {
+        EXPECT_EQ(std::to_string(rows_read),
+                  std::string(cols[0].ptr, cols[0].len));
+        EXPECT_EQ(rows_read % 7 == 0 ? "multi\nline" : "single line",
+                  std::string(cols[1].ptr, cols[1].len));
+        rows_read++;
+      }};
+
+  // No file, the input is set explicitly
+  auto &pool = *TestingHarness::GetInstance().GetTestingPool();
+  codegen::util::CSVScanner scanner(pool, "", types.data(),
+                                    static_cast<uint32_t>(types.size()),
+                                    CSVRowCallback,
+                                    reinterpret_cast<void *>(&state));
+  scanner.SetInput(csv_data.data(), csv_data.size());
+  state.scanner = &scanner;
+  scanner.Produce();
+
+  EXPECT_EQ(num_rows, rows_read);
+}
+
 TEST_F(CSVScanTest, CatchErrorsTest) {
   ////////////////////////////////////////////////////////////////////
   ///
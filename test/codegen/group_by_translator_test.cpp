@@ -14,6 +14,7 @@
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/query_compiler.h"
 #include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
 #include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
 #include "expression/tuple_value_expression.h"
@@ -455,5 +456,205 @@ TEST_F(GroupByTranslatorTest, MinAndMax) {
               CmpBool::CmpTrue);
 }
 
+TEST_F(GroupByTranslatorTest, ParallelGlobalAggregation) {
+  //
+  // SELECT COUNT(*), SUM(a), MAX(a), MIN(b) FROM table2;
+  //
+  // The scan spans several tile groups and runs in parallel, so each worker
+  // aggregates the morsels it scans into thread-local aggregates that are
+  // merged at the end of the pipeline.
+  //
+
+  LOG_INFO("Query: SELECT COUNT(*), SUM(a), MAX(a), MIN(b) FROM table2;");
+
+  uint32_t num_rows = 5 * DEFAULT_TUPLES_PER_TILEGROUP;
+  oid_t table_id = test_table_oids[1];
+  LoadTestTable(table_id, num_rows);
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {
+      {0, {1, 0}}, {1, {1, 1}}, {2, {1, 2}}, {3, {1, 3}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregations
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+      {ExpressionType::AGGREGATE_SUM,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+      {ExpressionType::AGGREGATE_MAX,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+      {ExpressionType::AGGREGATE_MIN,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)}};
+
+  // 3) No grouping
+  std::vector<oid_t> gb_cols = {};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::BIGINT, 8, "COUNT_STAR"},
+                           {type::TypeId::INTEGER, 4, "SUM_A"},
+                           {type::TypeId::INTEGER, 4, "MAX_A"},
+                           {type::TypeId::INTEGER, 4, "MIN_B"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+
+  // 6) The (parallel) scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(table_id), nullptr, {0, 1}, true)};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // Compile it all
+  CompileAndExecute(*agg_plan, buffer);
+
+  // There should only be a single output row
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+
+  // Column 'a' holds row ID * 10 and column 'b' holds row ID * 10 + 1
+  int64_t sum_a = 10 * (static_cast<int64_t>(num_rows) - 1) * num_rows / 2;
+  EXPECT_TRUE(results[0].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(num_rows)) ==
+              CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(1).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(sum_a)) ==
+              CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(2).CompareEquals(
+                  type::ValueFactory::GetBigIntValue((num_rows - 1) * 10)) ==
+              CmpBool::CmpTrue);
+  EXPECT_TRUE(results[0].GetValue(3).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(1)) ==
+              CmpBool::CmpTrue);
+}
+
+TEST_F(GroupByTranslatorTest, ParallelHashAggregation) {
+  //
+  // SELECT a, COUNT(*), SUM(b), AVG(b), MAX(b) FROM table3 GROUP BY a;
+  //
+  // The scan spans several tile groups and runs in parallel, so each worker
+  // aggregates into its own hash table. Every group appears in the morsels of
+  // all workers, and the partial aggregates of the workers are merged.
+  //
+
+  LOG_INFO(
+      "Query: SELECT a, COUNT(*), SUM(b), AVG(b), MAX(b) FROM table3 GROUP BY "
+      "a;");
+
+  // Load rows with a small number of distinct values of 'a', where 'b' holds
+  // the row ID
+  const uint32_t num_rows = 5 * DEFAULT_TUPLES_PER_TILEGROUP;
+  const int32_t num_groups = 100;
+  oid_t table_id = test_table_oids[2];
+  auto &table = GetTestTable(table_id);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+  auto *pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<int64_t> counts(num_groups, 0), sums(num_groups, 0),
+      maxes(num_groups, 0);
+  for (uint32_t rowid = 0; rowid < num_rows; rowid++) {
+    int32_t group = rowid % num_groups;
+    storage::Tuple tuple{table.GetSchema(), true};
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(group));
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(rowid));
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(rowid));
+    tuple.SetValue(
+        3, type::ValueFactory::GetVarcharValue(std::to_string(rowid)), pool);
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer tuple_slot_id =
+        table.InsertTuple(&tuple, txn, &index_entry_ptr);
+    txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+
+    counts[group]++;
+    sums[group] += rowid;
+    maxes[group] = rowid;
+  }
+  txn_manager.CommitTransaction(txn);
+
+  // 1) Set up projection (just a direct map)
+  DirectMapList direct_map_list = {
+      {0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}, {3, {1, 2}}, {4, {1, 3}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  // 2) Setup the aggregations
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+      {ExpressionType::AGGREGATE_SUM,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)},
+      {ExpressionType::AGGREGATE_AVG,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)},
+      {ExpressionType::AGGREGATE_MAX,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)}};
+
+  // 3) The grouping column
+  std::vector<oid_t> gb_cols = {0};
+
+  // 4) The output schema
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                           {type::TypeId::BIGINT, 8, "COUNT_STAR"},
+                           {type::TypeId::BIGINT, 8, "SUM_B"},
+                           {type::TypeId::DECIMAL, 8, "AVG_B"},
+                           {type::TypeId::INTEGER, 4, "MAX_B"}})};
+
+  // 5) Finally, the aggregation node
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+
+  // 6) The (parallel) scan that feeds the aggregation
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(table_id), nullptr, {0, 1}, true)};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3, 4}, context};
+
+  // Compile it all
+  CompileAndExecute(*agg_plan, buffer);
+
+  // Every group is produced exactly once, with the aggregates of all its rows
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(num_groups, results.size());
+
+  std::vector<bool> seen(num_groups, false);
+  for (const auto &tuple : results) {
+    int32_t group = tuple.GetValue(0).GetAs<int32_t>();
+    ASSERT_TRUE(group >= 0 && group < num_groups);
+    EXPECT_FALSE(seen[group]);
+    seen[group] = true;
+
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(
+                    type::ValueFactory::GetBigIntValue(counts[group])) ==
+                CmpBool::CmpTrue);
+    EXPECT_TRUE(tuple.GetValue(2).CompareEquals(
+                    type::ValueFactory::GetBigIntValue(sums[group])) ==
+                CmpBool::CmpTrue);
+    EXPECT_DOUBLE_EQ(static_cast<double>(sums[group]) / counts[group],
+                     tuple.GetValue(3).GetAs<double>());
+    EXPECT_TRUE(tuple.GetValue(4).CompareEquals(
+                    type::ValueFactory::GetBigIntValue(maxes[group])) ==
+                CmpBool::CmpTrue);
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
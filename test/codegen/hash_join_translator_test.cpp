@@ -16,6 +16,7 @@
 #include "expression/comparison_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "storage/table_factory.h"
+#include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
 #include "planner/hash_plan.h"
 #include "planner/seq_scan_plan.h"
@@ -45,6 +46,131 @@ class HashJoinTranslatorTest : public PelotonCodeGenTest {
   storage::DataTable &GetRightTable() const {
     return GetTestTable(RightTableId());
   }
+
+  // Join the left and right tables on column "a", after filtering each with
+  // the given predicate. The output has columns "a" and "b" of the left table
+  // and, unless the join is a semi or anti join, of the right table.
+  std::vector<codegen::WrappedTuple> ExecuteJoin(JoinType join_type,
+                                                 ExpressionPtr left_predicate,
+                                                 ExpressionPtr right_predicate,
+                                                 bool null_aware = false) {
+    bool right_output =
+        join_type != JoinType::SEMI && join_type != JoinType::ANTI;
+
+    DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                     {1, std::make_pair(0, 1)}};
+    std::vector<catalog::Column> columns = {
+        TestingExecutorUtil::GetColumnInfo(0),
+        TestingExecutorUtil::GetColumnInfo(1)};
+    if (right_output) {
+      direct_map_list.push_back({2, std::make_pair(1, 0)});
+      direct_map_list.push_back({3, std::make_pair(1, 1)});
+      columns.push_back(TestingExecutorUtil::GetColumnInfo(0));
+      columns.push_back(TestingExecutorUtil::GetColumnInfo(1));
+    }
+    std::unique_ptr<planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    auto schema =
+        std::shared_ptr<const catalog::Schema>(new catalog::Schema(columns));
+
+    std::vector<ConstExpressionPtr> left_hash_keys;
+    left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<ConstExpressionPtr> right_hash_keys;
+    right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<ConstExpressionPtr> hash_keys;
+    hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+    std::unique_ptr<planner::HashJoinPlan> hj_plan{new planner::HashJoinPlan(
+        join_type, nullptr, std::move(projection), schema, left_hash_keys,
+        right_hash_keys, true)};
+    hj_plan->SetNullAware(null_aware);
+    std::unique_ptr<planner::HashPlan> hash_plan{
+        new planner::HashPlan(hash_keys)};
+
+    std::unique_ptr<planner::AbstractPlan> left_scan{new planner::SeqScanPlan(
+        &GetLeftTable(), left_predicate.release(), {0, 1})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{new planner::SeqScanPlan(
+        &GetRightTable(), right_predicate.release(), {0, 1})};
+
+    hash_plan->AddChild(std::move(right_scan));
+    hj_plan->AddChild(std::move(left_scan));
+    hj_plan->AddChild(std::move(hash_plan));
+
+    EXPECT_TRUE(codegen::QueryCompiler::IsSupported(*hj_plan));
+
+    planner::BindingContext context;
+    hj_plan->PerformBinding(context);
+
+    std::vector<oid_t> output_cols = {0, 1};
+    if (right_output) {
+      output_cols.push_back(2);
+      output_cols.push_back(3);
+    }
+    codegen::BufferingConsumer buffer{output_cols, context};
+    CompileAndExecute(*hj_plan, buffer);
+    return buffer.GetOutputTuples();
+  }
+
+  // The tables of the spilling tests. A hash table on either of them doesn't
+  // fit into kSpillMemoryLimit.
+  static constexpr uint32_t kSpillRows = 20000;
+  static constexpr size_t kSpillMemoryLimit = 256 * 1024;
+
+  oid_t SpillLeftTableId() const { return test_table_oids[2]; }
+
+  oid_t SpillRightTableId() const { return test_table_oids[3]; }
+
+  void LoadSpillTables() {
+    LoadTestTable(SpillLeftTableId(), kSpillRows);
+    LoadTestTable(SpillRightTableId(), kSpillRows);
+  }
+
+  // Join the spill tables on column "a". The output has columns "a" and "b"
+  // of the left table and column "b" of the right table.
+  std::unique_ptr<planner::AbstractPlan> BuildSpillJoin() {
+    DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                     {1, std::make_pair(0, 1)},
+                                     {2, std::make_pair(1, 1)}};
+    std::unique_ptr<planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    auto schema = std::shared_ptr<const catalog::Schema>(
+        new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1),
+                             TestingExecutorUtil::GetColumnInfo(1)}));
+
+    std::vector<ConstExpressionPtr> left_hash_keys;
+    left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<ConstExpressionPtr> right_hash_keys;
+    right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<ConstExpressionPtr> hash_keys;
+    hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+    std::unique_ptr<planner::AbstractPlan> hj_plan{new planner::HashJoinPlan(
+        JoinType::INNER, nullptr, std::move(projection), schema,
+        left_hash_keys, right_hash_keys)};
+    std::unique_ptr<planner::AbstractPlan> hash_plan{
+        new planner::HashPlan(hash_keys)};
+
+    std::unique_ptr<planner::AbstractPlan> left_scan{new planner::SeqScanPlan(
+        &GetTestTable(SpillLeftTableId()), nullptr, {0, 1})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{new planner::SeqScanPlan(
+        &GetTestTable(SpillRightTableId()), nullptr, {0, 1})};
+
+    hash_plan->AddChild(std::move(right_scan));
+    hj_plan->AddChild(std::move(left_scan));
+    hj_plan->AddChild(std::move(hash_plan));
+    return hj_plan;
+  }
+
+  // Filter on column "a" of either table
+  ExpressionPtr ColALessThan(int32_t value) {
+    return CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 0),
+                     ConstIntExpr(value));
+  }
+  ExpressionPtr ColAAtLeast(int32_t value) {
+    return CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0),
+                      ConstIntExpr(value));
+  }
 };
 
 TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
@@ -127,5 +253,264 @@ TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
   }
 }
 
+TEST_F(HashJoinTranslatorTest, LeftOuterJoin) {
+  //
+  // SELECT l.a, l.b, r.a, r.b
+  // FROM left_table l LEFT JOIN right_table r ON l.a = r.a AND r.a < 100
+  //
+
+  const auto results =
+      ExecuteJoin(JoinType::LEFT, nullptr, ColALessThan(100));
+
+  // Every left row is produced, only the ones with a < 100 have a partner
+  ASSERT_EQ(20, results.size());
+  uint32_t num_unmatched = 0;
+  for (const auto &tuple : results) {
+    auto left_a = tuple.GetValue(0).GetAs<int32_t>();
+    if (left_a < 100) {
+      EXPECT_EQ(CmpBool::CmpTrue,
+                tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+    } else {
+      EXPECT_TRUE(tuple.GetValue(2).IsNull());
+      EXPECT_TRUE(tuple.GetValue(3).IsNull());
+      num_unmatched++;
+    }
+  }
+  EXPECT_EQ(10, num_unmatched);
+}
+
+TEST_F(HashJoinTranslatorTest, RightOuterJoin) {
+  //
+  // SELECT l.a, l.b, r.a, r.b
+  // FROM left_table l RIGHT JOIN right_table r ON l.a = r.a AND l.a < 50
+  //
+
+  const auto results =
+      ExecuteJoin(JoinType::RIGHT, ColALessThan(50), nullptr);
+
+  // Every right row is produced, only the ones with a < 50 have a partner
+  ASSERT_EQ(80, results.size());
+  uint32_t num_unmatched = 0;
+  for (const auto &tuple : results) {
+    auto right_a = tuple.GetValue(2).GetAs<int32_t>();
+    if (right_a < 50) {
+      EXPECT_EQ(CmpBool::CmpTrue,
+                tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+    } else {
+      EXPECT_TRUE(tuple.GetValue(0).IsNull());
+      EXPECT_TRUE(tuple.GetValue(1).IsNull());
+      num_unmatched++;
+    }
+  }
+  EXPECT_EQ(75, num_unmatched);
+}
+
+TEST_F(HashJoinTranslatorTest, FullOuterJoin) {
+  //
+  // SELECT l.a, l.b, r.a, r.b
+  // FROM (SELECT * FROM left_table WHERE a >= 50) l
+  // FULL OUTER JOIN (SELECT * FROM right_table WHERE a < 100) r ON l.a = r.a
+  //
+
+  const auto results =
+      ExecuteJoin(JoinType::OUTER, ColAAtLeast(50), ColALessThan(100));
+
+  // Matches for 50 <= a < 100, left rows for a >= 100, right rows for a < 50
+  ASSERT_EQ(20, results.size());
+  uint32_t num_matched = 0, num_left_only = 0, num_right_only = 0;
+  for (const auto &tuple : results) {
+    if (tuple.GetValue(0).IsNull()) {
+      EXPECT_LT(tuple.GetValue(2).GetAs<int32_t>(), 50);
+      num_right_only++;
+    } else if (tuple.GetValue(2).IsNull()) {
+      EXPECT_GE(tuple.GetValue(0).GetAs<int32_t>(), 100);
+      num_left_only++;
+    } else {
+      EXPECT_EQ(CmpBool::CmpTrue,
+                tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+      num_matched++;
+    }
+  }
+  EXPECT_EQ(5, num_matched);
+  EXPECT_EQ(10, num_left_only);
+  EXPECT_EQ(5, num_right_only);
+}
+
+TEST_F(HashJoinTranslatorTest, SemiJoin) {
+  //
+  // SELECT a, b FROM left_table
+  // WHERE a IN (SELECT a FROM right_table WHERE a < 100)
+  //
+
+  const auto results =
+      ExecuteJoin(JoinType::SEMI, nullptr, ColALessThan(100));
+
+  // Each left row with a partner is produced exactly once
+  ASSERT_EQ(10, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_LT(tuple.GetValue(0).GetAs<int32_t>(), 100);
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, AntiJoin) {
+  //
+  // SELECT a, b FROM left_table
+  // WHERE NOT EXISTS (SELECT * FROM right_table
+  //                   WHERE right_table.a = left_table.a AND a < 100)
+  //
+
+  const auto results =
+      ExecuteJoin(JoinType::ANTI, nullptr, ColALessThan(100));
+
+  // Only the left rows without a partner are produced
+  ASSERT_EQ(10, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_GE(tuple.GetValue(0).GetAs<int32_t>(), 100);
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, NullAwareAntiJoinWithEmptyProbe) {
+  //
+  // SELECT a, b FROM left_table
+  // WHERE a NOT IN (SELECT a FROM right_table WHERE a < 0)
+  //
+
+  const auto results =
+      ExecuteJoin(JoinType::ANTI, nullptr, ColALessThan(0), true);
+
+  // Nothing is IN an empty set
+  EXPECT_EQ(20, results.size());
+}
+
+TEST_F(HashJoinTranslatorTest, SpillingJoin) {
+  //
+  // SELECT table3.a, table3.b, table4.b
+  // FROM table3 JOIN table4 ON table3.a = table4.a
+  //
+
+  LoadSpillTables();
+  auto hj_plan = BuildSpillJoin();
+
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+  auto stats = CompileAndExecute(*hj_plan, buffer, kSpillMemoryLimit);
+
+  // The hash table is built in passes over the spilled rows, every row of the
+  // left table finds its partner in exactly one of them
+  EXPECT_GT(stats.spilled_bytes, 0);
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(kSpillRows, results.size());
+  std::vector<uint32_t> counts(kSpillRows, 0);
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(1).CompareEquals(tuple.GetValue(2)));
+    counts[tuple.GetValue(0).GetAs<int32_t>() / 10]++;
+  }
+  for (uint32_t i = 0; i < kSpillRows; i++) {
+    EXPECT_EQ(1, counts[i]) << "Row " << i << " joined " << counts[i]
+                            << " times";
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, SpillingJoinWithGroupBy) {
+  //
+  // SELECT table3.b, COUNT(*)
+  // FROM table3 JOIN table4 ON table3.a = table4.a
+  // GROUP BY table3.b
+  //
+
+  LoadSpillTables();
+
+  DirectMapList direct_map_list = {{0, {0, 1}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto *tve_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR, tve_expr}};
+  std::vector<oid_t> gb_cols = {1};
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_B"},
+                           {type::TypeId::BIGINT, 8, "COUNT_B"}})};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+  agg_plan->AddChild(BuildSpillJoin());
+
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*agg_plan, buffer, kSpillMemoryLimit);
+
+  // Every row of the join is aggregated exactly once
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(kSpillRows, results.size());
+  std::vector<uint32_t> counts(kSpillRows, 0);
+  for (const auto &tuple : results) {
+    EXPECT_EQ(1, tuple.GetValue(1).GetAs<int64_t>());
+    counts[tuple.GetValue(0).GetAs<int32_t>() / 10]++;
+  }
+  for (uint32_t i = 0; i < kSpillRows; i++) {
+    EXPECT_EQ(1, counts[i]) << "Group " << i << " produced " << counts[i]
+                            << " times";
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, SpillingJoinBelowHashJoinBuild) {
+  //
+  // SELECT j.a, table1.a
+  // FROM (SELECT table3.a, table3.b, table4.b
+  //       FROM table3 JOIN table4 ON table3.a = table4.a) AS j
+  // JOIN table1 ON j.a = table1.a
+  //
+
+  LoadSpillTables();
+
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(1, 0)}};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0)}));
+
+  std::vector<ConstExpressionPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+  std::vector<ConstExpressionPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+  std::vector<ConstExpressionPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::unique_ptr<planner::AbstractPlan> hj_plan{new planner::HashJoinPlan(
+      JoinType::INNER, nullptr, std::move(projection), schema, left_hash_keys,
+      right_hash_keys)};
+  std::unique_ptr<planner::AbstractPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+  std::unique_ptr<planner::AbstractPlan> right_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1})};
+
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(BuildSpillJoin());
+  hj_plan->AddChild(std::move(hash_plan));
+
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*hj_plan, buffer, kSpillMemoryLimit);
+
+  // The build side of the outer join holds every row of the inner join once,
+  // so each of the 20 rows of table1 finds a single partner
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::CmpTrue,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
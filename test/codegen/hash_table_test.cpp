@@ -19,6 +19,7 @@
 #include "common/harness.h"
 #include "common/timer.h"
 #include "codegen/util/hash_table.h"
+#include "executor/executor_context.h"
 
 namespace peloton {
 namespace test {
@@ -314,5 +315,121 @@ TEST_F(HashTableTest, ParallelMerge) {
   }
 }
 
+TEST_F(HashTableTest, ParallelPartitionedBuild) {
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t to_insert = 100000;
+
+  // Allocate hash tables for each thread
+  executor::ExecutorContext exec_ctx{nullptr};
+
+  auto &thread_states = exec_ctx.GetThreadStates();
+  thread_states.Reset(sizeof(codegen::util::HashTable));
+  thread_states.Allocate(num_threads);
+
+  // The global hash table
+  codegen::util::HashTable global_table{*exec_ctx.GetPool(), sizeof(Key),
+                                        sizeof(Value)};
+
+  // Insert function
+  auto insert_fn = [&exec_ctx](uint64_t tid) {
+    // Get the local table for this thread
+    auto *table = reinterpret_cast<codegen::util::HashTable *>(
+        exec_ctx.GetThreadStates().AccessThreadState(tid));
+
+    // Initialize it
+    codegen::util::HashTable::Init(*table, exec_ctx, sizeof(Key),
+                                   sizeof(Value));
+
+    // Insert keys disjoint from other threads
+    for (uint32_t i = tid * to_insert, end = i + to_insert; i != end; i++) {
+      Key k{static_cast<uint32_t>(tid), i};
+      Value v = {.v1 = k.k2, .v2 = k.k1, .v3 = 3, .v4 = 4444};
+      table->TypedInsertLazy(k.Hash(), k, v);
+    }
+  };
+
+  // First insert into thread local tables in parallel
+  LaunchParallelTest(num_threads, insert_fn);
+
+  // Now build the global table from the thread-local tables
+  global_table.BuildLazyPartitioned(thread_states, 0);
+
+  // Clean up local tables
+  for (uint32_t tid = 0; tid < num_threads; tid++) {
+    auto *table = reinterpret_cast<codegen::util::HashTable *>(
+        thread_states.AccessThreadState(tid));
+    EXPECT_EQ(0, table->NumElements());
+    codegen::util::HashTable::Destroy(*table);
+  }
+
+  // Now probe global
+  EXPECT_EQ(to_insert * num_threads, global_table.NumElements());
+  EXPECT_LE(global_table.NumElements(), global_table.Capacity());
+  for (uint32_t tid = 0; tid < num_threads; tid++) {
+    for (uint32_t i = tid * to_insert, end = i + to_insert; i != end; i++) {
+      Key key{tid, i};
+      uint32_t count = 0;
+      std::function<void(const Value &v)> f = [&key, &count](const Value &v) {
+        EXPECT_EQ(key.k2, v.v1)
+            << "Value's [v1] found in table doesn't match insert key";
+        EXPECT_EQ(key.k1, v.v2) << "Key " << key << " inserted by thread "
+                                << key.k1 << " but value was inserted by "
+                                << "thread " << v.v2;
+        count++;
+      };
+      global_table.TypedProbe(key.Hash(), key, f);
+      EXPECT_EQ(1, count) << "Found duplicate keys in unique key test";
+    }
+  }
+}
+
+TEST_F(HashTableTest, CanSpillLazyInserts) {
+  // The table allocates from the pool of the query, bound to its memory limit
+  executor::ExecutorContext exec_ctx{nullptr};
+  exec_ctx.SetMemoryLimit(256 * 1024);
+
+  codegen::util::HashTable table{*exec_ctx.GetPool(), sizeof(Key),
+                                 sizeof(Value)};
+  codegen::util::HashTable::EnableSpilling(table, exec_ctx, &table);
+
+  constexpr uint32_t to_insert = 50000;
+  constexpr uint32_t num_dups = 2;
+
+  // Insert keys
+  for (uint32_t i = 0; i < to_insert; i++) {
+    Key k{num_dups, i};
+    for (uint32_t dup = 0; dup < num_dups; dup++) {
+      Value v = {.v1 = k.k2, .v2 = dup, .v3 = 3, .v4 = 4};
+      table.TypedInsertLazy(k.Hash(), k, v);
+    }
+  }
+
+  // The entries don't fit into memory
+  table.BuildLazy();
+  EXPECT_GT(exec_ctx.GetSpilledBytes(), 0);
+
+  // Every key is found in exactly one pass, with all its duplicates
+  std::vector<uint32_t> counts(to_insert, 0);
+  uint32_t num_passes = 0;
+  do {
+    num_passes++;
+    for (uint32_t i = 0; i < to_insert; i++) {
+      Key k{num_dups, i};
+      std::function<void(const Value &v)> f = [&k, &counts](const Value &v) {
+        EXPECT_EQ(k.k2, v.v1);
+        counts[k.k2]++;
+      };
+      table.TypedProbe(k.Hash(), k, f);
+    }
+  } while (table.NextPass());
+
+  EXPECT_GT(num_passes, 1);
+  EXPECT_GE(exec_ctx.GetSpillPasses(), num_passes);
+  for (uint32_t i = 0; i < to_insert; i++) {
+    EXPECT_EQ(num_dups, counts[i]) << "Key " << i << " found " << counts[i]
+                                   << " times";
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
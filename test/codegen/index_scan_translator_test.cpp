@@ -0,0 +1,210 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator_test.cpp
+//
+// Identification: test/codegen/index_scan_translator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_cache.h"
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "index/index.h"
+#include "planner/index_scan_plan.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class IndexScanTranslatorTest : public PelotonCodeGenTest {
+ public:
+  IndexScanTranslatorTest() : PelotonCodeGenTest(), num_rows_to_insert(100) {
+    // Load the table with the primary key on column "a"
+    LoadTestTable(IndexedTableId(), num_rows_to_insert);
+  }
+
+  oid_t IndexedTableId() const { return test_table_oids[4]; }
+
+  storage::DataTable &GetIndexedTable() const {
+    return GetTestTable(IndexedTableId());
+  }
+
+  // Describe a lookup that compares column "a" against the given value
+  planner::IndexScanPlan::IndexScanDesc IndexScanDescOnA(
+      ExpressionType cmp_type, int32_t value) const {
+    return planner::IndexScanPlan::IndexScanDesc{
+        GetIndexedTable().GetIndex(0)->GetOid(),
+        {0},
+        {cmp_type},
+        {type::ValueFactory::GetIntegerValue(value)},
+        {}};
+  }
+
+  // Create an index scan over columns "a" and "b" of the indexed table that
+  // compares column "a" against the given value
+  std::shared_ptr<planner::IndexScanPlan> IndexScanOnA(
+      ExpressionType cmp_type, int32_t value,
+      expression::AbstractExpression *predicate = nullptr) {
+    return std::make_shared<planner::IndexScanPlan>(
+        &GetIndexedTable(), predicate, std::vector<oid_t>{0, 1},
+        IndexScanDescOnA(cmp_type, value));
+  }
+
+ private:
+  uint32_t num_rows_to_insert;
+};
+
+TEST_F(IndexScanTranslatorTest, PointLookup) {
+  //
+  // SELECT a, b FROM table5 WHERE a = 200;
+  //
+
+  auto scan = IndexScanOnA(ExpressionType::COMPARE_EQUAL, 200);
+  ASSERT_TRUE(codegen::QueryCompiler::IsSupported(*scan));
+
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*scan, buffer);
+
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(CmpBool::CmpTrue, results[0].GetValue(0).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(200)));
+  EXPECT_EQ(CmpBool::CmpTrue, results[0].GetValue(1).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(201)));
+}
+
+TEST_F(IndexScanTranslatorTest, RangeScanWithPredicate) {
+  //
+  // SELECT a, b FROM table5 WHERE a >= 500 AND b < 801;
+  //
+
+  auto *b_lt_801 =
+      CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(801))
+          .release();
+  auto scan = IndexScanOnA(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 500,
+                           b_lt_801);
+
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*scan, buffer);
+
+  // Rows with "a" in [500, 790] qualify, and come out in index order
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(30, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    auto expected = type::ValueFactory::GetIntegerValue(500 + i * 10);
+    EXPECT_EQ(CmpBool::CmpTrue, results[i].GetValue(0).CompareEquals(expected));
+  }
+}
+
+TEST_F(IndexScanTranslatorTest, KeyValuesAreParameterized) {
+  //
+  // SELECT a, b FROM table5 WHERE a = 100;
+  // SELECT a, b FROM table5 WHERE a = 300;
+  //
+
+  auto scan_1 = IndexScanOnA(ExpressionType::COMPARE_EQUAL, 100);
+  auto scan_2 = IndexScanOnA(ExpressionType::COMPARE_EQUAL, 300);
+  auto scan_3 = IndexScanOnA(ExpressionType::COMPARE_LESSTHAN, 300);
+
+  planner::BindingContext context_1;
+  scan_1->PerformBinding(context_1);
+  planner::BindingContext context_2;
+  scan_2->PerformBinding(context_2);
+  planner::BindingContext context_3;
+  scan_3->PerformBinding(context_3);
+
+  // Only the key values differ, so the plans share a compiled query
+  EXPECT_EQ(scan_1->Hash(), scan_2->Hash());
+  EXPECT_TRUE(*scan_1 == *scan_2);
+  EXPECT_FALSE(*scan_1 == *scan_3);
+
+  bool cached;
+  codegen::BufferingConsumer buffer_1{{0, 1}, context_1};
+  CompileAndExecuteCache(scan_1, buffer_1, cached);
+  EXPECT_FALSE(cached);
+
+  codegen::BufferingConsumer buffer_2{{0, 1}, context_2};
+  CompileAndExecuteCache(scan_2, buffer_2, cached);
+  EXPECT_TRUE(cached);
+
+  const auto &results_1 = buffer_1.GetOutputTuples();
+  const auto &results_2 = buffer_2.GetOutputTuples();
+  ASSERT_EQ(1, results_1.size());
+  ASSERT_EQ(1, results_2.size());
+  EXPECT_EQ(CmpBool::CmpTrue, results_1[0].GetValue(0).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(100)));
+  EXPECT_EQ(CmpBool::CmpTrue, results_2[0].GetValue(0).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(300)));
+
+  codegen::QueryCache::Instance().Clear();
+}
+
+TEST_F(IndexScanTranslatorTest, IndexNestedLoopJoin) {
+  //
+  // SELECT table1.a, table1.b, table5.a, table5.b
+  // FROM table1 INNER JOIN table5 ON table1.a = table5.a;
+  //
+
+  // Load the outer table
+  LoadTestTable(test_table_oids[0], 20);
+
+  bool left_side = true;
+  auto left_a_eq_right_a =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, left_side, 0),
+                ColRefExpr(type::TypeId::INTEGER, !left_side, 0));
+
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(0, 1)},
+                                   {2, std::make_pair(1, 0)},
+                                   {3, std::make_pair(1, 1)}};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({GetTestColumn(0), GetTestColumn(1),
+                           GetTestColumn(0), GetTestColumn(1)}));
+
+  // The index scan key is overwritten by each outer tuple
+  PlanPtr nlj_plan{new planner::NestedLoopJoinPlan(
+      JoinType::INNER, std::move(left_a_eq_right_a), std::move(projection),
+      schema, {0}, {0})};
+  PlanPtr left_scan{new planner::SeqScanPlan(&GetTestTable(test_table_oids[0]),
+                                             nullptr, {0, 1})};
+  PlanPtr right_scan{new planner::IndexScanPlan(
+      &GetIndexedTable(), nullptr, {0, 1},
+      IndexScanDescOnA(ExpressionType::COMPARE_EQUAL, 0))};
+  nlj_plan->AddChild(std::move(left_scan));
+  nlj_plan->AddChild(std::move(right_scan));
+
+  planner::BindingContext context;
+  nlj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+  CompileAndExecute(*nlj_plan, buffer);
+
+  // Every outer tuple finds its single partner through the index
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(20, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    auto expected = type::ValueFactory::GetIntegerValue(i * 10);
+    EXPECT_EQ(CmpBool::CmpTrue, results[i].GetValue(0).CompareEquals(expected));
+    EXPECT_EQ(CmpBool::CmpTrue, results[i].GetValue(2).CompareEquals(expected));
+    EXPECT_EQ(CmpBool::CmpTrue,
+              results[i].GetValue(1).CompareEquals(results[i].GetValue(3)));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
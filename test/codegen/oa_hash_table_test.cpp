@@ -21,6 +21,7 @@
 #include "codegen/util/oa_hash_table.h"
 #include "codegen/util/hash_table.h"
 #include "common/timer.h"
+#include "executor/executor_context.h"
 #include "type/ephemeral_pool.h"
 
 namespace peloton {
@@ -133,6 +134,74 @@ TEST_F(OAHashTableTest, CanIterate) {
   EXPECT_EQ(3, dup_count);
 }
 
+namespace {
+
+using OAHashTable = codegen::util::OAHashTable;
+
+// Add the count to the group of the key
+void CountGroup(OAHashTable &table, uint64_t hash,
+                const OAHashTableTest::Key &key, uint64_t count) {
+  std::function<void(const uint64_t &)> merge = [count](const uint64_t &agg) {
+    const_cast<uint64_t &>(agg) += count;
+  };
+  if (!table.Probe(hash, key, merge)) {
+    table.Insert(hash, key, count);
+  }
+}
+
+// The merge function of spilled partitions
+void MergeCounts(void *, OAHashTable *table, OAHashTable::HashEntry **entries,
+                 uint64_t num_entries) {
+  for (uint64_t i = 0; i < num_entries; i++) {
+    auto *entry = entries[i];
+    const auto &key =
+        *reinterpret_cast<const OAHashTableTest::Key *>(entry->data);
+    const auto &count = *reinterpret_cast<const uint64_t *>(
+        entry->data + sizeof(OAHashTableTest::Key));
+    CountGroup(*table, entry->hash, key, count);
+  }
+}
+
+}  // namespace
+
+TEST_F(OAHashTableTest, CanSpillGroups) {
+  // The table allocates from the pool of the query, bound to its memory limit
+  executor::ExecutorContext exec_ctx{nullptr};
+  exec_ctx.SetMemoryLimit(64 * 1024);
+
+  OAHashTable table{sizeof(Key), sizeof(uint64_t)};
+  OAHashTable::EnableSpilling(table, exec_ctx, &table);
+
+  constexpr uint32_t num_groups = 20000;
+  constexpr uint32_t num_rows = 4 * num_groups;
+
+  // Count the rows of each group
+  for (uint32_t i = 0; i < num_rows; i++) {
+    Key k{1, i % num_groups};
+    CountGroup(table, Hash(k), k, 1);
+  }
+  OAHashTable::FlushSpilled(table);
+
+  // The groups don't fit into memory, all of them are spilled
+  EXPECT_GT(exec_ctx.GetSpilledBytes(), 0);
+  EXPECT_EQ(0, table.NumEntries());
+
+  // Every group is found in exactly one partition, with all its rows
+  std::vector<uint64_t> counts(num_groups, 0);
+  while (OAHashTable::NextSpilledPartition(nullptr, table, MergeCounts)) {
+    for (auto iter = table.begin(), end = table.end(); iter != end; ++iter) {
+      const auto &key = *reinterpret_cast<const Key *>(iter.Key());
+      EXPECT_EQ(0, counts[key.k2]) << "Group " << key.k2 << " found twice";
+      counts[key.k2] += *reinterpret_cast<const uint64_t *>(iter.Value());
+    }
+  }
+
+  EXPECT_GT(exec_ctx.GetSpillPasses(), 0);
+  for (uint32_t i = 0; i < num_groups; i++) {
+    EXPECT_EQ(num_rows / num_groups, counts[i]) << "Group " << i;
+  }
+}
+
 TEST_F(OAHashTableTest, MicroBenchmark) {
   uint32_t num_runs = 10;
 
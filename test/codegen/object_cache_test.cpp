@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache_test.cpp
+//
+// Identification: test/codegen/object_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <boost/filesystem.hpp>
+
+#include "codegen/object_cache.h"
+#include "codegen/testing_codegen_util.h"
+#include "planner/seq_scan_plan.h"
+
+namespace peloton {
+namespace test {
+
+static const std::string kObjectCacheDir = "./object_cache_test";
+
+class ObjectCacheTest : public PelotonCodeGenTest {
+ public:
+  ObjectCacheTest() : PelotonCodeGenTest(), num_rows_to_insert(64) {
+    // Load test table
+    LoadTestTable(TestTableId(), num_rows_to_insert);
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+  oid_t TestTableId() { return test_table_oids[0]; }
+
+  // SELECT a, b FROM table WHERE b > a;
+  std::unique_ptr<planner::SeqScanPlan> GetColumnCompareScan() {
+    auto *a_col_exp =
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+    auto *b_col_exp =
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+    auto *b_gt_a = new expression::ComparisonExpression(
+        ExpressionType::COMPARE_GREATERTHAN, b_col_exp, a_col_exp);
+    return std::unique_ptr<planner::SeqScanPlan>(new planner::SeqScanPlan(
+        &GetTestTable(TestTableId()), b_gt_a, {0, 1}));
+  }
+
+  // SELECT a, b FROM table WHERE a >= 40;
+  std::unique_ptr<planner::SeqScanPlan> GetZoneMappableScan() {
+    auto *a_col_exp =
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+    auto *a_gte_40 = new expression::ComparisonExpression(
+        ExpressionType::COMPARE_GREATERTHANOREQUALTO, a_col_exp,
+        PelotonCodeGenTest::ConstIntExpr(40).release());
+    return std::unique_ptr<planner::SeqScanPlan>(new planner::SeqScanPlan(
+        &GetTestTable(TestTableId()), a_gte_40, {0, 1}));
+  }
+
+  size_t ScanAndCount(planner::SeqScanPlan &scan) {
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    CompileAndExecute(scan, buffer);
+    return buffer.GetOutputTuples().size();
+  }
+
+ private:
+  uint32_t num_rows_to_insert;
+};
+
+TEST_F(ObjectCacheTest, ReuseObjectCode) {
+  auto &object_cache = codegen::ObjectCache::Instance();
+  object_cache.SetDirectory(kObjectCacheDir);
+  object_cache.Clear();
+  EXPECT_TRUE(object_cache.IsEnabled());
+
+  uint64_t hits = object_cache.GetHitCount();
+  uint64_t misses = object_cache.GetMissCount();
+
+  // The first compilation generates the object code and stores it
+  auto scan_1 = GetColumnCompareScan();
+  EXPECT_EQ(NumRowsInTestTable(), ScanAndCount(*scan_1));
+  EXPECT_EQ(hits, object_cache.GetHitCount());
+  EXPECT_EQ(misses + 1, object_cache.GetMissCount());
+
+  // An equal plan, e.g., after a restart, loads the stored object code
+  auto scan_2 = GetColumnCompareScan();
+  EXPECT_EQ(NumRowsInTestTable(), ScanAndCount(*scan_2));
+  EXPECT_EQ(hits + 1, object_cache.GetHitCount());
+  EXPECT_EQ(misses + 1, object_cache.GetMissCount());
+
+  // The zone map predicate is passed to the runtime by its address, so the
+  // code is not cached at all
+  auto scan_3 = GetZoneMappableScan();
+  EXPECT_EQ(NumRowsInTestTable() - 4, ScanAndCount(*scan_3));
+  EXPECT_EQ(hits + 1, object_cache.GetHitCount());
+  EXPECT_EQ(misses + 1, object_cache.GetMissCount());
+
+  // Nothing is found once the cache is cleared
+  object_cache.Clear();
+  auto scan_4 = GetColumnCompareScan();
+  EXPECT_EQ(NumRowsInTestTable(), ScanAndCount(*scan_4));
+  EXPECT_EQ(hits + 1, object_cache.GetHitCount());
+  EXPECT_EQ(misses + 2, object_cache.GetMissCount());
+
+  object_cache.SetDirectory("");
+  EXPECT_FALSE(object_cache.IsEnabled());
+  boost::filesystem::remove_all(kObjectCacheDir);
+}
+
+}  // namespace test
+}  // namespace peloton
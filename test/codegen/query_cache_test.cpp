@@ -652,6 +652,54 @@ TEST_F(QueryCacheTest, CacheNestedLoopJoinPlan) {
   EXPECT_FALSE(found);
 }
 
+TEST_F(QueryCacheTest, EvictionAndTableRemoval) {
+  auto &query_cache = codegen::QueryCache::Instance();
+  query_cache.Clear();
+  uint64_t hits = query_cache.GetHitCount();
+  uint64_t misses = query_cache.GetMissCount();
+  uint64_t evictions = query_cache.GetEvictionCount();
+
+  // The scan accesses the test table, the join both tables
+  auto scan_plan = GetSeqScanPlan();
+  auto hj_plan = GetHashJoinPlan();
+  planner::BindingContext scan_context, hj_context;
+  scan_plan->PerformBinding(scan_context);
+  hj_plan->PerformBinding(hj_context);
+
+  bool cached;
+  codegen::BufferingConsumer scan_buffer_1{{0}, scan_context};
+  CompileAndExecuteCache(scan_plan, scan_buffer_1, cached);
+  EXPECT_FALSE(cached);
+  codegen::BufferingConsumer hj_buffer{{0, 1, 2, 3}, hj_context};
+  CompileAndExecuteCache(hj_plan, hj_buffer, cached);
+  EXPECT_FALSE(cached);
+  codegen::BufferingConsumer scan_buffer_2{{0}, scan_context};
+  CompileAndExecuteCache(scan_plan, scan_buffer_2, cached);
+  EXPECT_TRUE(cached);
+
+  EXPECT_EQ(hits + 1, query_cache.GetHitCount());
+  EXPECT_EQ(misses + 2, query_cache.GetMissCount());
+  EXPECT_EQ(2, query_cache.GetCount());
+  EXPECT_LT(0, query_cache.GetSize());
+
+  // Only the join accesses the right table
+  query_cache.Remove(RightTableId());
+  EXPECT_EQ(1, query_cache.GetCount());
+  EXPECT_EQ(nullptr, query_cache.Find(hj_plan));
+  EXPECT_NE(nullptr, query_cache.Find(scan_plan));
+
+  // A query that is in use stays valid after it is evicted
+  auto query = query_cache.Find(scan_plan);
+  query_cache.SetCapacity(1);
+  EXPECT_EQ(0, query_cache.GetCount());
+  EXPECT_EQ(0, query_cache.GetSize());
+  EXPECT_EQ(evictions + 1, query_cache.GetEvictionCount());
+  EXPECT_EQ(scan_plan->Hash(), query->GetPlan().Hash());
+
+  query_cache.SetCapacity(0);
+  query_cache.Clear();
+}
+
 TEST_F(QueryCacheTest, PerformanceBenchmark) {
   codegen::QueryCache::Instance().Clear();
   Timer<std::ratio<1, 1000>> timer1, timer2;
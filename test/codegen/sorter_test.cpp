@@ -40,6 +40,21 @@ static int CompareTuplesForAscending(const char *a, const char *b) {
   return at->col_b - bt->col_b;
 }
 
+// The normalized key of TestTuples: column B, big-endian, padded to 8 bytes
+static void NormalizeTuple(const char *tuple, char *key) {
+  const auto *tt = reinterpret_cast<const TestTuple *>(tuple);
+  for (uint32_t i = 0; i < 8; i++) {
+    key[i] = (i < 4 ? static_cast<char>(tt->col_b >> (24 - 8 * i)) : 0);
+  }
+}
+
+// A key that only captures part of the order: column B divided by ten
+static void NormalizeTuplePrefix(const char *tuple, char *key) {
+  TestTuple prefix = *reinterpret_cast<const TestTuple *>(tuple);
+  prefix.col_b /= 10;
+  NormalizeTuple(reinterpret_cast<const char *>(&prefix), key);
+}
+
 class SorterTest : public PelotonTest {
  public:
   std::unique_ptr<executor::ExecutorContext> ctx;
@@ -121,6 +136,57 @@ TEST_F(SorterTest, CanSortTuples) {
   TestSort(100);
 }
 
+TEST_F(SorterTest, CanSortOnNormalizedKeys) {
+  for (bool key_is_exact : {true, false}) {
+    codegen::util::Sorter sorter{Pool(), CompareTuplesForAscending,
+                                 sizeof(TestTuple)};
+    sorter.UseNormalizedKeys(
+        key_is_exact ? NormalizeTuple : NormalizeTuplePrefix, 8, key_is_exact);
+
+    uint64_t num_tuples = 100000;
+    LoadSorter(sorter, num_tuples);
+    sorter.Sort();
+
+    CheckSorted(sorter, true);
+    EXPECT_EQ(num_tuples, sorter.NumTuples());
+  }
+}
+
+TEST_F(SorterTest, CanSpillSortedRuns) {
+  // The sorter is bound to the memory limit of the query
+  ExecCtx().SetMemoryLimit(1024 * 1024);
+
+  alignas(codegen::util::Sorter) char storage[sizeof(codegen::util::Sorter)];
+  auto &sorter = *reinterpret_cast<codegen::util::Sorter *>(storage);
+  codegen::util::Sorter::Init(sorter, ExecCtx(), CompareTuplesForAscending,
+                              sizeof(TestTuple));
+  sorter.UseNormalizedKeys(NormalizeTuple, 8, true);
+
+  uint64_t num_tuples = 500000;
+  LoadSorter(sorter, num_tuples);
+  sorter.Sort();
+
+  // The tuples don't fit into memory
+  EXPECT_TRUE(sorter.HasSpilled());
+  EXPECT_GT(ExecCtx().GetSpilledBytes(), num_tuples * sizeof(TestTuple) / 2);
+
+  // The merged runs are produced in order, batch by batch
+  uint64_t num_produced = 0;
+  uint32_t last_col_b = 0;
+  while (sorter.NextBatch()) {
+    for (auto iter : sorter) {
+      const auto *tt = reinterpret_cast<const TestTuple *>(iter);
+      EXPECT_LE(last_col_b, tt->col_b);
+      last_col_b = tt->col_b;
+      num_produced++;
+    }
+  }
+  EXPECT_EQ(num_tuples, num_produced);
+  EXPECT_GT(ExecCtx().GetSpillPasses(), 0);
+
+  codegen::util::Sorter::Destroy(sorter);
+}
+
 TEST_F(SorterTest, BenchmarkSorter) {
   // Test sorting 5 million input tuples
   TestSort(5000000);
@@ -15,6 +15,7 @@
 #include "codegen/query_compiler.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
 #include "expression/conjunction_expression.h"
 #include "expression/operator_expression.h"
 #include "planner/seq_scan_plan.h"
@@ -636,6 +637,58 @@ TEST_F(TableScanTranslatorTest, ScanWithModuloPredicate) {
                                   type::ValueFactory::GetIntegerValue(1)));
 }
 
+TEST_F(TableScanTranslatorTest, AdaptiveParallelScan) {
+  //
+  // SELECT a, b, c FROM table where a >= 20;
+  //
+  // The query starts in the interpreter while it is compiled in the
+  // background. The morsels of the parallel scan switch to native code once
+  // the compilation finishes.
+  //
+
+  // Setup the predicate
+  ExpressionPtr a_gt_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+
+  // Setup the (parallel) scan plan node
+  auto &table = GetTestTable(TestTableId());
+  planner::SeqScanPlan scan{&table, a_gt_20.release(), {0, 1, 2}, true};
+
+  // Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // Compile the query in the background
+  codegen::QueryParameters parameters(scan, {});
+  codegen::BufferingConsumer compile_buffer{{0, 1, 2}, context};
+  auto query = codegen::QueryCompiler().Compile(
+      scan, parameters.GetQueryParametersMap(), compile_buffer);
+  query->CompileAsync();
+
+  // Execute the query until it has been compiled, every execution must produce
+  // the same results
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  codegen::Query::RuntimeStats stats;
+  bool compiled;
+  do {
+    compiled = query->IsCompiled();
+
+    codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+    auto *txn = txn_manager.BeginTransaction();
+    executor::ExecutorContext exec_ctx{txn,
+                                       codegen::QueryParameters(scan, {})};
+    stats = codegen::Query::RuntimeStats();
+    query->Execute(exec_ctx, buffer, &stats);
+    txn_manager.CommitTransaction(txn);
+
+    EXPECT_EQ(NumRowsInTestTable() - 2, buffer.GetOutputTuples().size());
+  } while (!compiled);
+
+  // The last execution started after the compilation had finished
+  EXPECT_EQ(0.0, stats.interpreted_ms);
+  EXPECT_LT(0.0, stats.native_ms);
+}
+
 TEST_F(TableScanTranslatorTest, ScanRowLayout) {
   //
   // Creates a table with LayoutType::ROW and
@@ -272,7 +272,8 @@ void PelotonCodeGenTest::CreateAndLoadTableWithLayout(
 }
 
 PelotonCodeGenTest::CodeGenStats PelotonCodeGenTest::CompileAndExecute(
-    planner::AbstractPlan &plan, codegen::ExecutionConsumer &consumer) {
+    planner::AbstractPlan &plan, codegen::ExecutionConsumer &consumer,
+    size_t memory_limit) {
   codegen::QueryParameters parameters(plan, {});
 
   // Start a transaction.
@@ -286,12 +287,16 @@ PelotonCodeGenTest::CodeGenStats PelotonCodeGenTest::CompileAndExecute(
 
   // Executor context
   executor::ExecutorContext exec_ctx{txn, std::move(parameters)};
+  if (memory_limit != 0) {
+    exec_ctx.SetMemoryLimit(memory_limit);
+  }
 
   // Compile Query to native code
   query->Compile();
 
   // Execute the quer
   query->Execute(exec_ctx, consumer, &stats.runtime_stats);
+  stats.spilled_bytes = exec_ctx.GetSpilledBytes();
 
   // Commit the transaction.
   txn_manager.CommitTransaction(txn);
@@ -312,15 +317,16 @@ PelotonCodeGenTest::CodeGenStats PelotonCodeGenTest::CompileAndExecuteCache(
 
   // Compile
   CodeGenStats stats;
-  codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
+  std::shared_ptr<codegen::Query> query =
+      codegen::QueryCache::Instance().Find(plan);
   cached = (query != nullptr);
   if (query == nullptr) {
     codegen::QueryCompiler compiler;
     auto compiled_query = compiler.Compile(
         *plan, exec_ctx.GetParams().GetQueryParametersMap(), consumer);
     compiled_query->Compile();
-    query = compiled_query.get();
-    codegen::QueryCache::Instance().Add(plan, std::move(compiled_query));
+    query = std::move(compiled_query);
+    codegen::QueryCache::Instance().Add(plan, query);
   }
 
   // Execute the query.
@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimistic_transaction_manager_test.cpp
+//
+// Identification: test/concurrency/optimistic_transaction_manager_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "concurrency/testing_transaction_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Optimistic TransactionContext Tests
+//===--------------------------------------------------------------------===//
+
+class OptimisticTransactionManagerTests : public PelotonTest {};
+
+TEST_F(OptimisticTransactionManagerTests, ValidationTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::OPTIMISTIC, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // a read doesn't block a later write of a transaction with a smaller
+  // timestamp, the reader has committed before the writer validates.
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    scheduler.Txn(1).Read(1);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Update(0, 1);
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+  }
+
+  // the version read by T0 is overwritten before T0 commits
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(1).Update(0, 1);
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(0).Update(1, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Read(1);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::ABORTED, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[2].results[1]);
+  }
+
+  // the version read by T0 is locked by T1 when T0 commits
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    scheduler.Txn(1).Update(0, 1);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Update(1, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Read(1);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::ABORTED, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(0, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+    EXPECT_EQ(0, scheduler.schedules[2].results[1]);
+  }
+
+  // write-write conflicts are still detected when the tuple is written
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(1).Update(0, 2);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(2).Read(0);
+    scheduler.Txn(2).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(ResultType::ABORTED, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+  }
+
+  // reads of a transaction's own writes are not validated
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(1, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Update(0, 1);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(0, scheduler.schedules[0].results[0]);
+    EXPECT_EQ(1, scheduler.schedules[0].results[1]);
+  }
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+// Each transaction reads both keys and writes their maximum plus one to the
+// key of its thread. In a serial order every commit raises the maximum by
+// one, a stale read that passes the validation commits a duplicate.
+static void IncrementMaximum(storage::DataTable *table,
+                             std::atomic<int> *commit_count,
+                             uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  for (int i = 0; i < 500; i++) {
+    auto txn = txn_manager.BeginTransaction();
+    int values[2];
+    bool success =
+        TestingTransactionUtil::ExecuteRead(txn, table, 0, values[0]) &&
+        TestingTransactionUtil::ExecuteRead(txn, table, 1, values[1]) &&
+        TestingTransactionUtil::ExecuteUpdate(
+            txn, table, thread_itr % 2, std::max(values[0], values[1]) + 1);
+    if (!success || txn->GetResult() == ResultType::FAILURE) {
+      txn_manager.AbortTransaction(txn);
+      continue;
+    }
+    if (txn_manager.CommitTransaction(txn) == ResultType::SUCCESS) {
+      (*commit_count)++;
+    }
+  }
+}
+
+TEST_F(OptimisticTransactionManagerTests, ConcurrentValidationTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::OPTIMISTIC, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  concurrency::EpochManagerFactory::GetInstance().Reset();
+  storage::DataTable *table = TestingTransactionUtil::CreateTable(2);
+
+  // writers commit while the others validate the versions they release
+  std::atomic<int> commit_count(0);
+  LaunchParallelTest(4, IncrementMaximum, table, &commit_count);
+
+  auto txn = txn_manager.BeginTransaction();
+  int values[2];
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, values[0]));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 1, values[1]));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_LT(0, commit_count.load());
+  EXPECT_EQ(commit_count.load(), std::max(values[0], values[1]));
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+}  // namespace test
+}  // namespace peloton
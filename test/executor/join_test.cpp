@@ -146,6 +146,19 @@ TEST_F(JoinTests, JoinTypesTest) {
   }
 }
 
+TEST_F(JoinTests, SemiAndAntiJoinTest) {
+  // Go over all join algorithms
+  for (auto join_algorithm : join_algorithms) {
+    LOG_TRACE("JOIN ALGORITHM :: %s",
+              PlanNodeTypeToString(join_algorithm).c_str());
+    for (auto join_type : {JoinType::SEMI, JoinType::ANTI}) {
+      LOG_TRACE("JOIN TYPE :: %s", JoinTypeToString(join_type).c_str());
+      ExecuteJoinTest(join_algorithm, join_type, BASIC_TEST);
+      ExecuteJoinTest(join_algorithm, join_type, RIGHT_TABLE_EMPTY);
+    }
+  }
+}
+
 TEST_F(JoinTests, ComplicatedTest) {
   // Go over all join algorithms
   for (auto join_algorithm : join_algorithms) {
@@ -563,7 +576,8 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
   } else if (join_test_type == LEFT_TABLE_EMPTY) {
     ExpectEmptyTileResult(&left_table_scan_executor);
   } else if (join_test_type == RIGHT_TABLE_EMPTY) {
-    if (join_type == JoinType::INNER || join_type == JoinType::RIGHT) {
+    if (join_type == JoinType::INNER || join_type == JoinType::RIGHT ||
+        join_type == JoinType::SEMI) {
       ExpectMoreThanOneTileResults(&left_table_scan_executor,
                                    left_table_logical_tile_ptrs);
     } else {
@@ -788,6 +802,17 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
         EXPECT_EQ(tuples_with_null, 5);
         break;
 
+      // Semi and anti joins only produce the columns of the left table
+      case JoinType::SEMI:
+        EXPECT_EQ(result_tuple_count, 10);
+        EXPECT_EQ(tuples_with_null, 10);
+        break;
+
+      case JoinType::ANTI:
+        EXPECT_EQ(result_tuple_count, 5);
+        EXPECT_EQ(tuples_with_null, 5);
+        break;
+
       default:
         throw Exception("Unsupported join type : " +
                         JoinTypeToString(join_type));
@@ -903,6 +928,16 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
         EXPECT_EQ(tuples_with_null, 15);
         break;
 
+      case JoinType::SEMI:
+        EXPECT_EQ(result_tuple_count, 0);
+        EXPECT_EQ(tuples_with_null, 0);
+        break;
+
+      case JoinType::ANTI:
+        EXPECT_EQ(result_tuple_count, 15);
+        EXPECT_EQ(tuples_with_null, 15);
+        break;
+
       default:
         throw Exception("Unsupported join type : " +
                         JoinTypeToString(join_type));
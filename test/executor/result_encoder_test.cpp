@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_encoder_test.cpp
+//
+// Identification: test/executor/result_encoder_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "common/harness.h"
+
+#include "executor/result_encoder.h"
+#include "function/date_functions.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Result Encoder Tests
+//===--------------------------------------------------------------------===//
+
+class ResultEncoderTests : public PelotonTest {};
+
+namespace {
+
+std::string Encode(const type::Value &val, int format) {
+  ResultValue result = "stale contents";
+  executor::ResultEncoder::Encode(val, format, false, result);
+  return result;
+}
+
+}  // namespace
+
+TEST_F(ResultEncoderTests, TextFormatTest) {
+  const int text = executor::ResultEncoder::kTextFormat;
+  EXPECT_EQ("42", Encode(type::ValueFactory::GetIntegerValue(42), text));
+  EXPECT_EQ("-7", Encode(type::ValueFactory::GetBigIntValue(-7), text));
+  EXPECT_EQ("abc", Encode(type::ValueFactory::GetVarcharValue("abc"), text));
+  EXPECT_EQ("", Encode(type::ValueFactory::GetVarcharValue(""), text));
+
+  // NULLs are empty unless asked for their string representation
+  auto null_val = type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER);
+  EXPECT_EQ("", Encode(null_val, text));
+  ResultValue result;
+  executor::ResultEncoder::Encode(null_val, text, true, result);
+  EXPECT_EQ(null_val.ToString(), result);
+}
+
+TEST_F(ResultEncoderTests, BinaryFormatTest) {
+  const int binary = executor::ResultEncoder::kBinaryFormat;
+
+  EXPECT_EQ(std::string("\x01", 1),
+            Encode(type::ValueFactory::GetBooleanValue(true), binary));
+  EXPECT_EQ(std::string("\xFF\xFE", 2),
+            Encode(type::ValueFactory::GetSmallIntValue(-2), binary));
+  EXPECT_EQ(std::string("\x01\x02\x03\x04", 4),
+            Encode(type::ValueFactory::GetIntegerValue(0x01020304), binary));
+  EXPECT_EQ(std::string("\x00\x00\x00\x01\x00\x00\x00\x02", 8),
+            Encode(type::ValueFactory::GetBigIntValue(0x100000002LL), binary));
+  // IEEE 754 double 1.5
+  EXPECT_EQ(std::string("\x3F\xF8\x00\x00\x00\x00\x00\x00", 8),
+            Encode(type::ValueFactory::GetDecimalValue(1.5), binary));
+
+  // Strings are the same in both formats
+  EXPECT_EQ("abc",
+            Encode(type::ValueFactory::GetVarcharValue("abc"), binary));
+
+  // Dates are days since 2000-01-01
+  auto date = type::ValueFactory::GetDateValue(
+      function::DateFunctions::DateToJulian(2000, 1, 3));
+  EXPECT_EQ(std::string("\x00\x00\x00\x02", 4), Encode(date, binary));
+
+  // Timestamps are microseconds since 2000-01-01 00:00:00. This one is
+  // 2000-01-02 00:00:01.000005+00.
+  uint64_t packed = ((((1 * 32 + 2) * 27 + 12) * 10000ULL + 2000) * 100000 + 1) *
+                        1000000 +
+                    5;
+  int64_t micros = (86400LL + 1) * 1000000 + 5;
+  std::string expected;
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    expected.push_back(static_cast<char>((micros >> shift) & 0xFF));
+  }
+  EXPECT_EQ(expected,
+            Encode(type::ValueFactory::GetTimestampValue(packed), binary));
+
+  // NULLs are empty in binary format as well
+  EXPECT_EQ("", Encode(type::ValueFactory::GetNullValueByType(
+                           type::TypeId::BIGINT),
+                       binary));
+}
+
+}  // namespace test
+}  // namespace peloton
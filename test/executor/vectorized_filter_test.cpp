@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_filter_test.cpp
+//
+// Identification: test/executor/vectorized_filter_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "common/container_tuple.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "executor/vectorized_filter.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class VectorizedFilterTests : public PelotonTest {};
+
+namespace {
+
+expression::AbstractExpression *ColumnExpr(type::TypeId type_id,
+                                           oid_t column_id) {
+  return new expression::TupleValueExpression(type_id, 0, column_id);
+}
+
+expression::AbstractExpression *ConstExpr(const type::Value &value) {
+  return new expression::ConstantValueExpression(value);
+}
+
+expression::AbstractExpression *CmpExpr(ExpressionType type,
+                                        expression::AbstractExpression *left,
+                                        expression::AbstractExpression *right) {
+  return new expression::ComparisonExpression(type, left, right);
+}
+
+// Check that the filter selects the same tuples as the predicate evaluated a
+// tuple at a time
+void CheckFilter(storage::DataTable *table,
+                 const expression::AbstractExpression &predicate,
+                 size_t expected_count) {
+  auto filter = executor::VectorizedFilter::Create(&predicate, nullptr);
+  ASSERT_NE(nullptr, filter);
+
+  size_t count = 0;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    std::vector<oid_t> selection(tile_group->GetNextTupleSlot());
+    std::iota(selection.begin(), selection.end(), 0);
+
+    std::vector<oid_t> expected;
+    for (oid_t tuple_id : selection) {
+      ContainerTuple<storage::TileGroup> tuple(tile_group.get(), tuple_id);
+      if (predicate.Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+        expected.push_back(tuple_id);
+      }
+    }
+
+    EXPECT_TRUE(filter->Filter(*tile_group, selection));
+    EXPECT_EQ(expected, selection);
+    count += selection.size();
+  }
+  EXPECT_EQ(expected_count, count);
+}
+
+}  // namespace
+
+TEST_F(VectorizedFilterTests, CompareColumnsAndConstants) {
+  const int tuple_count = 20 * TESTS_TUPLES_PER_TILEGROUP;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Column a holds 10 * i, column c holds 10 * i + 2
+  // a >= 100 AND c < 502.5
+  std::unique_ptr<expression::AbstractExpression> range(
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          CmpExpr(ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                  ColumnExpr(type::TypeId::INTEGER, 0),
+                  ConstExpr(type::ValueFactory::GetIntegerValue(100))),
+          CmpExpr(ExpressionType::COMPARE_LESSTHAN,
+                  ColumnExpr(type::TypeId::DECIMAL, 2),
+                  ConstExpr(type::ValueFactory::GetDecimalValue(502.5)))));
+  CheckFilter(table.get(), *range, 41);
+
+  // 55 > a, with the constant on the left
+  std::unique_ptr<expression::AbstractExpression> flipped(
+      CmpExpr(ExpressionType::COMPARE_GREATERTHAN,
+              ConstExpr(type::ValueFactory::GetBigIntValue(55)),
+              ColumnExpr(type::TypeId::INTEGER, 0)));
+  CheckFilter(table.get(), *flipped, 6);
+
+  // b != a compares two columns
+  std::unique_ptr<expression::AbstractExpression> columns(
+      CmpExpr(ExpressionType::COMPARE_NOTEQUAL,
+              ColumnExpr(type::TypeId::INTEGER, 1),
+              ColumnExpr(type::TypeId::INTEGER, 0)));
+  CheckFilter(table.get(), *columns, tuple_count);
+
+  // Strings are evaluated a tuple at a time
+  std::unique_ptr<expression::AbstractExpression> strings(
+      CmpExpr(ExpressionType::COMPARE_EQUAL,
+              ColumnExpr(type::TypeId::VARCHAR, 3),
+              ConstExpr(type::ValueFactory::GetVarcharValue("3"))));
+  EXPECT_EQ(nullptr, executor::VectorizedFilter::Create(strings.get(), nullptr));
+}
+
+}  // namespace test
+}  // namespace peloton
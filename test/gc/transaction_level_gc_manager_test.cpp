@@ -13,14 +13,17 @@
 #include "concurrency/testing_transaction_util.h"
 #include "executor/testing_executor_util.h"
 #include "common/harness.h"
+#include "gc/tile_group_compactor.h"
 #include "gc/transaction_level_gc_manager.h"
 #include "concurrency/epoch_manager.h"
 
 #include "catalog/catalog.h"
+#include "index/index_factory.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 
@@ -493,5 +496,261 @@ TEST_F(TransactionLevelGCManagerTests, ImmutabilityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+/*
+Brief Summary : This test checks that the gc removes the index entries of
+old versions. An update that changes the key of a secondary index leaves the
+old key behind, the gc should delete it once no transaction can read the old
+version. Entries that are shared with the new version must stay.
+*/
+TEST_F(TransactionLevelGCManagerTests, IndexEntryTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("indexentrydb");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      0, "TABLE2", db_id, 12348, 1235, true));
+
+  // create a secondary index on the value column
+  std::vector<oid_t> key_attrs = {1};
+  auto tuple_schema = table->GetSchema();
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+  auto index_metadata = new index::IndexMetadata(
+      "secondary_btree_index", 1236, 12348, db_id, IndexType::BWTREE,
+      IndexConstraintType::DEFAULT, tuple_schema, key_schema, key_attrs, false);
+  std::shared_ptr<index::Index> secondary_index(
+      index::IndexFactory::GetIndex(index_metadata));
+  table->AddIndex(secondary_index);
+  auto primary_index = table->GetIndex(0);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table.get(), 0, 10));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // change the secondary key
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0, 20));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  EXPECT_EQ(1, primary_index->GetNumberOfTuples());
+  EXPECT_EQ(2, secondary_index->GetNumberOfTuples());
+  auto footprint = secondary_index->GetMemoryFootprint();
+
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, expired_eid);
+  auto reclaimed_count = gc_manager.Reclaim(0, expired_eid);
+  auto unlinked_count = gc_manager.Unlink(0, expired_eid);
+  EXPECT_EQ(0, reclaimed_count);
+  EXPECT_EQ(1, unlinked_count);
+
+  // the old secondary key is gone, the primary key is still needed
+  EXPECT_EQ(1, primary_index->GetNumberOfTuples());
+  EXPECT_EQ(1, secondary_index->GetNumberOfTuples());
+  EXPECT_GT(footprint, secondary_index->GetMemoryFootprint());
+
+  std::vector<ItemPointer *> results;
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(10), nullptr);
+  secondary_index->ScanKey(key.get(), results);
+  EXPECT_EQ(0, results.size());
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(20), nullptr);
+  secondary_index->ScanKey(key.get(), results);
+  EXPECT_EQ(1, results.size());
+
+  // an update that keeps the secondary key keeps its entry
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0, 20));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  epoch_manager.SetCurrentEpochId(3);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(2, expired_eid);
+  gc_manager.Reclaim(0, expired_eid);
+  unlinked_count = gc_manager.Unlink(0, expired_eid);
+  EXPECT_EQ(1, unlinked_count);
+  EXPECT_EQ(1, secondary_index->GetNumberOfTuples());
+
+  // a delete removes all the keys
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table.get(), 0));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  epoch_manager.SetCurrentEpochId(4);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(3, expired_eid);
+  gc_manager.Reclaim(0, expired_eid);
+  unlinked_count = gc_manager.Unlink(0, expired_eid);
+  EXPECT_EQ(1, unlinked_count);
+  EXPECT_EQ(0, primary_index->GetNumberOfTuples());
+  EXPECT_EQ(0, secondary_index->GetNumberOfTuples());
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("indexentrydb");
+}
+
+/*
+Brief Summary : This test checks that the gc frees a tile group once the
+compactor has moved its live tuples out. The tile group is dropped from the
+table when all of its slots are recycled, and freed one epoch later.
+*/
+TEST_F(TransactionLevelGCManagerTests, CompactionTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("compactiondb");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE1", db_id, 12349, 1237, true, tuples_per_tilegroup));
+
+  auto tile_group = (table.get())->GetTileGroup(0);
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  tile_group->GetHeader()->SetImmutability();
+  tile_group.reset();
+
+  // delete all but the last tuple of the 1st tile group
+  for (int key = 0; key < 4; key++) {
+    EXPECT_TRUE(DeleteTuple(table.get(), key) == ResultType::SUCCESS);
+  }
+
+  // move the last tuple out
+  gc::TileGroupCompactor::CompactTileGroup(tile_group_id);
+  oid_t num_tile_groups = (table.get())->GetTileGroupCount();
+
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, expired_eid);
+  auto reclaimed_count = gc_manager.Reclaim(0, expired_eid);
+  auto unlinked_count = gc_manager.Unlink(0, expired_eid);
+  EXPECT_EQ(0, reclaimed_count);
+  EXPECT_EQ(5, unlinked_count);
+
+  // all the slots are recycled, the table drops the tile group
+  epoch_manager.SetCurrentEpochId(3);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(2, expired_eid);
+  reclaimed_count = gc_manager.Reclaim(0, expired_eid);
+  unlinked_count = gc_manager.Unlink(0, expired_eid);
+  EXPECT_EQ(5, reclaimed_count);
+  EXPECT_EQ(0, unlinked_count);
+  EXPECT_TRUE((table.get())->GetTileGroup(0) == nullptr);
+  EXPECT_TRUE(storage_manager->GetTileGroup(tile_group_id) != nullptr);
+
+  // the tile group is freed once no transaction can be scanning it
+  epoch_manager.SetCurrentEpochId(4);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(3, expired_eid);
+  gc_manager.Reclaim(0, expired_eid);
+  EXPECT_TRUE(storage_manager->GetTileGroup(tile_group_id) == nullptr);
+  EXPECT_EQ(num_tile_groups, (table.get())->GetTileGroupCount());
+
+  // the free slots come from other tile groups
+  auto location = gc_manager.ReturnFreeSlot((table.get())->GetOid());
+  EXPECT_FALSE(location.IsNull());
+  EXPECT_NE(tile_group_id, location.block);
+
+  // the moved tuple and the other tuples can still be read
+  std::vector<int> results;
+  for (int key = 4; key < num_key; key++) {
+    EXPECT_TRUE(SelectTuple(table.get(), key, results) == ResultType::SUCCESS);
+    EXPECT_EQ(1, results.size());
+    EXPECT_NE(-1, results[0]);
+  }
+  EXPECT_TRUE(SelectTuple(table.get(), 0, results) == ResultType::SUCCESS);
+  EXPECT_EQ(-1, results[0]);
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("compactiondb");
+}
+
+/*
+Brief Summary : This test checks that the slots reclaimed while a tile group
+is being compacted are not lost when the compaction is cancelled. They must
+become available for reuse again once the tile group is mutable.
+*/
+TEST_F(TransactionLevelGCManagerTests, CancelCompactionTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  // create database
+  auto database = TestingExecutorUtil::InitializeDatabase("cancelcompactiondb");
+  oid_t db_id = database->GetOid();
+  EXPECT_TRUE(storage_manager->HasDatabase(db_id));
+
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE1", db_id, 12350, 1238, true, tuples_per_tilegroup));
+
+  auto tile_group = (table.get())->GetTileGroup(0);
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  auto tile_group_header = tile_group->GetHeader();
+  tile_group_header->SetImmutability();
+
+  // the slot of the deleted tuple is reclaimed while the tile group is
+  // immutable
+  EXPECT_TRUE(DeleteTuple(table.get(), 2) == ResultType::SUCCESS);
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  gc_manager.Reclaim(0, expired_eid);
+  EXPECT_EQ(1, gc_manager.Unlink(0, expired_eid));
+  epoch_manager.SetCurrentEpochId(3);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, gc_manager.Reclaim(0, expired_eid));
+  gc_manager.Unlink(0, expired_eid);
+
+  auto location = gc_manager.ReturnFreeSlot((table.get())->GetOid());
+  EXPECT_TRUE(location.IsNull());
+
+  // the compactor gives up, the slot can be reused again
+  gc_manager.CancelCompaction(tile_group_id);
+  EXPECT_FALSE(tile_group_header->GetImmutability());
+  location = gc_manager.ReturnFreeSlot((table.get())->GetOid());
+  EXPECT_FALSE(location.IsNull());
+  EXPECT_EQ(tile_group_id, location.block);
+  EXPECT_EQ(0, tile_group_header->GetNumRecycled());
+
+  tile_group.reset();
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("cancelcompactiondb");
+}
+
 }  // namespace test
 }  // namespace peloton
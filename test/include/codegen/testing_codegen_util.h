@@ -71,6 +71,7 @@ class PelotonCodeGenTest : public PelotonTest {
   struct CodeGenStats {
     codegen::QueryCompiler::CompileStats compile_stats;
     codegen::Query::RuntimeStats runtime_stats;
+    uint64_t spilled_bytes = 0;
   };
 
   virtual ~PelotonCodeGenTest();
@@ -106,9 +107,11 @@ class PelotonCodeGenTest : public PelotonTest {
                                     oid_t tile_group_count, oid_t column_count,
                                     bool is_inlined);
 
-  // Compile and execute the given plan
+  // Compile and execute the given plan, with the given memory limit in bytes
+  // if it isn't 0
   CodeGenStats CompileAndExecute(
-      planner::AbstractPlan &plan, codegen::ExecutionConsumer &consumer);
+      planner::AbstractPlan &plan, codegen::ExecutionConsumer &consumer,
+      size_t memory_limit = 0);
 
   CodeGenStats CompileAndExecuteCache(
       std::shared_ptr<planner::AbstractPlan> plan,
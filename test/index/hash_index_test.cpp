@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index_test.cpp
+//
+// Identification: test/index/hash_index_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "gtest/gtest.h"
+
+#include "index/index.h"
+#include "index/testing_index_util.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Hash Index Tests
+//===--------------------------------------------------------------------===//
+
+class HashIndexTests : public PelotonTest {};
+
+TEST_F(HashIndexTests, BasicTest) {
+  TestingIndexUtil::BasicTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, MultiMapInsertTest) {
+  TestingIndexUtil::MultiMapInsertTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, UniqueKeyInsertTest) {
+  TestingIndexUtil::UniqueKeyInsertTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, UniqueKeyDeleteTest) {
+  TestingIndexUtil::UniqueKeyDeleteTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyDeleteTest) {
+  TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, MultiThreadedInsertTest) {
+  TestingIndexUtil::MultiThreadedInsertTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyMultiThreadedTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyMultiThreadedStressTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::HASH);
+}
+
+TEST_F(HashIndexTests, CondInsertAndGCTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> location_ptrs;
+
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(IndexType::HASH, false),
+      TestingIndexUtil::DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, type::ValueFactory::GetIntegerValue(100), pool);
+  key0->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+
+  auto *item0 = TestingIndexUtil::item0.get();
+  auto *item1 = TestingIndexUtil::item1.get();
+
+  // The predicate rejects the insert if item0 is already there
+  auto predicate = [item0](const void *value) {
+    return reinterpret_cast<const ItemPointer *>(value) == item0;
+  };
+
+  EXPECT_TRUE(index->CondInsertEntry(key0.get(), item0, predicate));
+  EXPECT_FALSE(index->CondInsertEntry(key0.get(), item1, predicate));
+  index->ScanKey(key0.get(), location_ptrs);
+  ASSERT_EQ(1, location_ptrs.size());
+  EXPECT_EQ(item0, location_ptrs[0]);
+  location_ptrs.clear();
+
+  // Deleting the last value leaves an empty key behind for GC
+  EXPECT_TRUE(index->DeleteEntry(key0.get(), item0));
+  EXPECT_TRUE(index->NeedGC());
+  index->PerformGC();
+  EXPECT_FALSE(index->NeedGC());
+
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(0, location_ptrs.size());
+  location_ptrs.clear();
+
+  // The key can be inserted again after being collected
+  EXPECT_TRUE(index->CondInsertEntry(key0.get(), item1, predicate));
+  index->ScanKey(key0.get(), location_ptrs);
+  ASSERT_EQ(1, location_ptrs.size());
+  EXPECT_EQ(item1, location_ptrs[0]);
+  location_ptrs.clear();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -14,7 +14,10 @@
 #include "gtest/gtest.h"
 
 #include "common/internal_types.h"
+#include "index/index.h"
 #include "index/testing_index_util.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace test {
@@ -26,45 +29,102 @@ namespace test {
 class SkipListIndexTests : public PelotonTest {};
 
 TEST_F(SkipListIndexTests, BasicTest) {
-  // TestingIndexUtil::BasicTest(IndexType::SKIPLIST);
-  EXPECT_EQ(2, 1+1);
+  TestingIndexUtil::BasicTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, MultiMapInsertTest) {
+  TestingIndexUtil::MultiMapInsertTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, UniqueKeyInsertTest) {
+  TestingIndexUtil::UniqueKeyInsertTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, UniqueKeyDeleteTest) {
+  TestingIndexUtil::UniqueKeyDeleteTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyDeleteTest) {
+  TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, MultiThreadedInsertTest) {
+  TestingIndexUtil::MultiThreadedInsertTest(IndexType::SKIPLIST);
 }
 
-//TEST_F(SkipListIndexTests, MultiMapInsertTest) {
-//  TestingIndexUtil::MultiMapInsertTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, UniqueKeyInsertTest) {
-//  TestingIndexUtil::UniqueKeyInsertTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, UniqueKeyDeleteTest) {
-//  TestingIndexUtil::UniqueKeyDeleteTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyDeleteTest) {
-//  TestingIndexUtil::NonUniqueKeyDeleteTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, MultiThreadedInsertTest) {
-//  TestingIndexUtil::MultiThreadedInsertTest(IndexType::SKIPLIST);
-//}
-//
 //TEST_F(SkipListIndexTests, UniqueKeyMultiThreadedTest) {
 //  TestingIndexUtil::UniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
 //}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedTest) {
-//  TestingIndexUtil::NonUniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest) {
-//  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest(IndexType::SKIPLIST);
-//}
-//
-//TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
-//  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::SKIPLIST);
-//}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
+  TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::SKIPLIST);
+}
+
+TEST_F(SkipListIndexTests, ScanDirectionAndGCTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> forward;
+  std::vector<ItemPointer *> backward;
+
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(IndexType::SKIPLIST, false),
+      TestingIndexUtil::DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // Two values under every key, inserted out of key order
+  const int num_keys = 100;
+  std::vector<std::unique_ptr<ItemPointer>> items;
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (int i = 0; i < num_keys; i++) {
+    int k = (i * 37) % num_keys;
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(k), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    for (int v = 0; v < 2; v++) {
+      items.emplace_back(new ItemPointer(k, v));
+      EXPECT_TRUE(index->InsertEntry(key.get(), items.back().get()));
+    }
+  }
+
+  auto k_low = type::ValueFactory::GetIntegerValue(10);
+  auto k_high = type::ValueFactory::GetIntegerValue(89);
+  std::vector<ExpressionType> expr_types = {
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO};
+
+  index->ScanTest({k_low, k_high}, {0, 0}, expr_types,
+                  ScanDirectionType::FORWARD, forward);
+  index->ScanTest({k_low, k_high}, {0, 0}, expr_types,
+                  ScanDirectionType::BACKWARD, backward);
+
+  // Forward goes up by key, backward visits the same entries in reverse
+  ASSERT_EQ(160, forward.size());
+  ASSERT_EQ(forward.size(), backward.size());
+  for (size_t i = 0; i < forward.size(); i++) {
+    EXPECT_EQ(10 + i / 2, forward[i]->block);
+    EXPECT_EQ(forward[i], backward[backward.size() - 1 - i]);
+  }
+
+  // Deleted entries wait in the skiplist until they are collected
+  for (auto &item : items) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(item->block), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    EXPECT_TRUE(index->DeleteEntry(key.get(), item.get()));
+  }
+  EXPECT_TRUE(index->NeedGC());
+  index->PerformGC();
+  EXPECT_FALSE(index->NeedGC());
+
+  forward.clear();
+  index->ScanAllKeys(forward);
+  EXPECT_EQ(0, forward.size());
+}
 
 }  // namespace test
 }  // namespace peloton
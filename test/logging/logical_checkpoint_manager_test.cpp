@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_checkpoint_manager_test.cpp
+//
+// Identification: test/logging/logical_checkpoint_manager_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <boost/filesystem.hpp>
+
+#include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/checkpoint_manager_factory.h"
+#include "logging/logical_checkpoint_manager.h"
+#include "logging/logical_log_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Logical Checkpoint Manager Tests
+//===--------------------------------------------------------------------===//
+
+class LogicalCheckpointManagerTests : public PelotonTest {};
+
+static const std::string kCheckpointDir = "./logical_checkpoint_manager_test";
+static const std::string kLogDir = "./logical_checkpoint_manager_test_log";
+
+// The state of the test table after the logged transactions
+static void CheckRecoveredTable(storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  int result;
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, result));
+  EXPECT_EQ(1, result);
+  TestingTransactionUtil::ExecuteRead(txn, table, 1, result);
+  EXPECT_EQ(-1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 2, result));
+  EXPECT_EQ(5, result);
+  for (int key = 3; key < 10; key++) {
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, key, result));
+    EXPECT_EQ(0, result);
+  }
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 100, result));
+  EXPECT_EQ(100, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+}
+
+static size_t GetLogFileCount() {
+  size_t count = 0;
+  boost::filesystem::directory_iterator itr(kLogDir), end;
+  for (; itr != end; itr++) {
+    if (itr->path().filename().string().compare(0, 4, "log_") == 0) count++;
+  }
+  return count;
+}
+
+TEST_F(LogicalCheckpointManagerTests, RecoveryTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  std::unique_ptr<std::thread> epoch_thread;
+  epoch_manager.Reset();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.SetDirectories({kLogDir});
+  log_manager.StartLogging();
+
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  EXPECT_EQ(&checkpoint_manager,
+            &logging::CheckpointManagerFactory::GetInstance());
+  checkpoint_manager.SetDirectory(kCheckpointDir);
+  EXPECT_EQ(INVALID_CID, checkpoint_manager.GetLatestCheckpointCid());
+
+  // Logged before the checkpoint, recovery must not apply it twice
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 2, 5));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  cid_t checkpoint_cid = checkpoint_manager.DoCheckpoint();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+  EXPECT_EQ(checkpoint_cid, checkpoint_manager.GetLatestCheckpointCid());
+
+  // Logged after the checkpoint
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 100, 100));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  log_manager.StopLogging();
+  EXPECT_LT(0, GetLogFileCount());
+
+  // Restart with an empty table
+  auto database = storage::StorageManager::GetInstance()->GetDatabaseWithOid(
+      CATALOG_DATABASE_OID);
+  database->DropTableWithOid(TEST_TABLE_OID);
+  table = TestingTransactionUtil::CreateTable(0);
+
+  EXPECT_TRUE(checkpoint_manager.DoRecovery({kLogDir}));
+
+  // The indexes are rebuilt as well
+  CheckRecoveredTable(table);
+
+  // The replayed log is replaced by a new checkpoint
+  cid_t recovered_cid = checkpoint_manager.GetLatestCheckpointCid();
+  EXPECT_LT(checkpoint_cid, recovered_cid);
+  EXPECT_EQ(0, GetLogFileCount());
+
+  // Restart again, the new checkpoint alone holds the recovered tuples
+  database->DropTableWithOid(TEST_TABLE_OID);
+  table = TestingTransactionUtil::CreateTable(0);
+
+  EXPECT_TRUE(checkpoint_manager.DoRecovery({kLogDir}));
+  CheckRecoveredTable(table);
+  EXPECT_EQ(recovered_cid, checkpoint_manager.GetLatestCheckpointCid());
+
+  // Nothing to recover once the checkpoint directory is gone
+  boost::filesystem::remove_all(kCheckpointDir);
+  checkpoint_manager.SetDirectory(kCheckpointDir);
+  EXPECT_FALSE(checkpoint_manager.DoRecovery({kLogDir}));
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  boost::filesystem::remove_all(kCheckpointDir);
+  boost::filesystem::remove_all(kLogDir);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_manager_test.cpp
+//
+// Identification: test/logging/logical_log_manager_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/log_manager_factory.h"
+#include "logging/logical_log_manager.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Logical Log Manager Tests
+//===--------------------------------------------------------------------===//
+
+class LogicalLogManagerTests : public PelotonTest {};
+
+static const std::string kLogDir = "./logical_log_manager_test";
+
+static size_t GetFileSize(const std::string &path) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) return 0;
+  return static_cast<size_t>(info.st_size);
+}
+
+static std::vector<std::string> GetLogFiles() {
+  std::vector<std::string> log_files;
+  DIR *dir = opendir(kLogDir.c_str());
+  if (dir == nullptr) return log_files;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 4, "log_") == 0) {
+      log_files.push_back(kLogDir + "/" + name);
+    }
+  }
+  closedir(dir);
+  return log_files;
+}
+
+void InsertTuples(storage::DataTable *table, int txn_count,
+                  uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  for (int i = 0; i < txn_count; i++) {
+    int key = static_cast<int>(1000 * (thread_itr + 1) + i);
+    auto txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, key, key));
+    EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  }
+}
+
+TEST_F(LogicalLogManagerTests, GroupCommitTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  std::unique_ptr<std::thread> epoch_thread;
+  epoch_manager.Reset();
+  epoch_manager.StartEpoch(epoch_thread);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  EXPECT_EQ(&log_manager, &logging::LogManagerFactory::GetInstance());
+  log_manager.SetDirectories({kLogDir});
+  log_manager.StartLogging();
+
+  // A commit returns once its records are on disk
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 100, 100));
+  eid_t epoch_id = txn->GetEpochId();
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_GE(log_manager.GetPersistentEpochId(), epoch_id);
+  EXPECT_LT(0, log_manager.GetBytesFlushed());
+
+  // Read-only transactions don't write to the log
+  uint64_t bytes_flushed = log_manager.GetBytesFlushed();
+  txn = txn_manager.BeginTransaction();
+  int result;
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, result));
+  EXPECT_EQ(1, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_EQ(bytes_flushed, log_manager.GetBytesFlushed());
+
+  // Concurrent commits share fsyncs
+  const int thread_count = 4;
+  const int txn_count = 10;
+  uint64_t sync_count = log_manager.GetSyncCount();
+  LaunchParallelTest(thread_count, InsertTuples, table, txn_count);
+  EXPECT_LT(log_manager.GetSyncCount() - sync_count,
+            static_cast<uint64_t>(thread_count * txn_count));
+
+  log_manager.StopLogging();
+
+  // Every flushed byte is in the log files, and the persistent epoch is
+  // recorded
+  size_t log_size = 0;
+  for (auto &log_file : GetLogFiles()) {
+    log_size += GetFileSize(log_file);
+  }
+  EXPECT_EQ(log_manager.GetBytesFlushed(), log_size);
+  std::string pepoch_file = kLogDir + "/pepoch";
+  EXPECT_LT(0, GetFileSize(pepoch_file));
+  EXPECT_EQ(0, GetFileSize(pepoch_file) % sizeof(eid_t));
+
+  // Commits don't go to the log once it is stopped
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 200, 200));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_EQ(log_size, log_manager.GetBytesFlushed());
+
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+
+  for (auto &log_file : GetLogFiles()) {
+    unlink(log_file.c_str());
+  }
+  unlink(pepoch_file.c_str());
+  rmdir(kLogDir.c_str());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_test.cpp
+//
+// Identification: test/network/copy_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/harness.h"
+#include "gtest/gtest.h"
+#include "common/logger.h"
+#include "network/peloton_server.h"
+#include "network/postgres_protocol_handler.h"
+#include "util/string_util.h"
+#include <libpq-fe.h> /* libpq is needed for the COPY sub-protocol */
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Copy Tests
+//===--------------------------------------------------------------------===//
+
+class CopyTests : public PelotonTest {};
+
+// Runs a statement that does not return a COPY response, and returns whether
+// it ended with the expected status
+static bool Exec(PGconn *conn, const std::string &query,
+                 ExecStatusType expected) {
+  PGresult *res = PQexec(conn, query.c_str());
+  bool ok = (PQresultStatus(res) == expected);
+  if (!ok) {
+    LOG_INFO("[CopyTest] '%s' failed: %s", query.c_str(),
+             PQresultErrorMessage(res));
+  }
+  PQclear(res);
+  return ok;
+}
+
+static int CountRows(PGconn *conn, const std::string &table) {
+  PGresult *res = PQexec(conn, ("SELECT COUNT(*) FROM " + table).c_str());
+  int count = -1;
+  if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) == 1) {
+    count = std::stoi(PQgetvalue(res, 0, 0));
+  }
+  PQclear(res);
+  return count;
+}
+
+// Sends all CopyData messages and the CopyDone or CopyFail that ends them,
+// and returns the result of the COPY command
+static PGresult *CopyIn(PGconn *conn, const std::string &query,
+                        const std::vector<std::string> &messages,
+                        const char *fail_reason = nullptr) {
+  PGresult *res = PQexec(conn, query.c_str());
+  EXPECT_EQ(PGRES_COPY_IN, PQresultStatus(res));
+  PQclear(res);
+
+  for (const auto &message : messages) {
+    EXPECT_EQ(1, PQputCopyData(conn, message.data(),
+                               static_cast<int>(message.size())));
+  }
+  EXPECT_EQ(1, PQputCopyEnd(conn, fail_reason));
+
+  res = PQgetResult(conn);
+  // Drain the connection so it can run the next command
+  PGresult *extra;
+  while ((extra = PQgetResult(conn)) != nullptr) {
+    PQclear(extra);
+  }
+  return res;
+}
+
+void CopyTest(int port) {
+  PGconn *conn = PQconnectdb(
+      StringUtil::Format("host=127.0.0.1 port=%d user=default_database "
+                         "sslmode=disable application_name=psql",
+                         port)
+          .c_str());
+  ASSERT_EQ(CONNECTION_OK, PQstatus(conn));
+
+  EXPECT_TRUE(Exec(conn, "DROP TABLE IF EXISTS copy_test;", PGRES_COMMAND_OK));
+  EXPECT_TRUE(Exec(conn, "CREATE TABLE copy_test(id INT, name VARCHAR(100));",
+                   PGRES_COMMAND_OK));
+
+  // Rows are split across CopyData messages, and a quoted value holds a
+  // newline that must not end its row. The last row has no newline.
+  PGresult *res = CopyIn(conn, "COPY copy_test FROM STDIN;",
+                         {"1,Han LI\n2,\"Shaokun", "\nZOU\"\n3,Yi", "lei CHU"});
+  EXPECT_EQ(PGRES_COMMAND_OK, PQresultStatus(res));
+  EXPECT_STREQ("3", PQcmdTuples(res));
+  PQclear(res);
+  EXPECT_EQ(3, CountRows(conn, "copy_test"));
+
+  // CopyFail aborts the whole load
+  res = CopyIn(conn, "COPY copy_test FROM STDIN;", {"4,a\n5,b\n"},
+               "client gave up");
+  EXPECT_EQ(PGRES_FATAL_ERROR, PQresultStatus(res));
+  PQclear(res);
+  EXPECT_EQ(3, CountRows(conn, "copy_test"));
+
+  // COPY TO STDOUT sends one CopyData message per row, with values quoted as
+  // in the input
+  res = PQexec(conn, "COPY copy_test TO STDOUT;");
+  EXPECT_EQ(PGRES_COPY_OUT, PQresultStatus(res));
+  PQclear(res);
+  std::vector<std::string> rows;
+  char *buf;
+  int len;
+  while ((len = PQgetCopyData(conn, &buf, 0)) > 0) {
+    rows.emplace_back(buf, len);
+    PQfreemem(buf);
+  }
+  EXPECT_EQ(-1, len);
+  res = PQgetResult(conn);
+  EXPECT_EQ(PGRES_COMMAND_OK, PQresultStatus(res));
+  PQclear(res);
+  std::sort(rows.begin(), rows.end());
+  std::vector<std::string> expected = {"1,Han LI\n", "2,\"Shaokun\nZOU\"\n",
+                                       "3,Yilei CHU\n"};
+  EXPECT_EQ(expected, rows);
+
+  // Enough data for several chunks, sent in messages that do not line up
+  // with row boundaries. All chunks commit together.
+  EXPECT_TRUE(Exec(conn, "DROP TABLE IF EXISTS copy_bulk;", PGRES_COMMAND_OK));
+  EXPECT_TRUE(Exec(conn, "CREATE TABLE copy_bulk(id INT, name VARCHAR(100));",
+                   PGRES_COMMAND_OK));
+  const std::string padding(80, 'x');
+  std::string data;
+  int num_rows = 0;
+  while (data.size() < 2 * COPY_CHUNK_SIZE + COPY_CHUNK_SIZE / 2) {
+    data.append(std::to_string(num_rows++) + "," + padding + "\n");
+  }
+  std::vector<std::string> messages;
+  for (size_t pos = 0; pos < data.size(); pos += 65521) {
+    messages.push_back(data.substr(pos, 65521));
+  }
+  res = CopyIn(conn, "COPY copy_bulk FROM STDIN;", messages);
+  EXPECT_EQ(PGRES_COMMAND_OK, PQresultStatus(res));
+  EXPECT_EQ(std::to_string(num_rows), PQcmdTuples(res));
+  PQclear(res);
+  EXPECT_EQ(num_rows, CountRows(conn, "copy_bulk"));
+
+  PQfinish(conn);
+  LOG_INFO("[CopyTest] Client has closed");
+}
+
+TEST_F(CopyTests, CopyTest) {
+  peloton::PelotonInit::Initialize();
+  LOG_INFO("Server initialized");
+  peloton::network::PelotonServer server;
+
+  int port = 15721;
+  try {
+    server.SetPort(port);
+    server.SetupServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception when launching server");
+  }
+  std::thread serverThread([&]() { server.ServerLoop(); });
+
+  CopyTest(port);
+
+  server.Close();
+  serverThread.join();
+  LOG_INFO("Peloton is shutting down");
+  peloton::PelotonInit::Shutdown();
+  LOG_INFO("Peloton has shut down");
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -41,5 +41,24 @@ TEST_F(CardinalityTest, EstimatedCardinalityTestWithPredicate) {
   EXPECT_GE(num_rows, plan->GetCardinality());
 }
 
+TEST_F(CardinalityTest, EstimatedCardinalityTestWithSemiAndAntiJoin) {
+
+  // Every key of the small table is in the large table, so a quarter of the
+  // large table has a match
+  const int num_rows = 20;
+  const int num_sub_rows = 5;
+  OptimizerTestUtil::CreateTable("large", num_rows);
+  OptimizerTestUtil::CreateTable("small", num_sub_rows);
+
+  auto semi_plan =
+      GeneratePlan("SELECT a FROM large WHERE a IN (SELECT a FROM small);");
+  EXPECT_NEAR(num_sub_rows, semi_plan->GetCardinality(), 1);
+
+  auto anti_plan = GeneratePlan(
+      "SELECT a FROM large WHERE NOT EXISTS (SELECT a FROM small WHERE "
+      "small.a = large.a);");
+  EXPECT_NEAR(num_rows - num_sub_rows, anti_plan->GetCardinality(), 1);
+}
+
 }
 }
@@ -163,5 +163,25 @@ TEST_F(HyperLogLogTests, DataTypeTest) {
   hll.EstimateCardinality();
 }
 
+// Sketches of disjoint halves merge into the sketch of the whole.
+TEST_F(HyperLogLogTests, MergeTest) {
+  HyperLogLog hll_1{};
+  HyperLogLog hll_2{};
+  int threshold = 10000;
+  double error = hll_1.RelativeError();
+  for (int i = 0; i < threshold; i++) {
+    type::Value v = type::ValueFactory::GetIntegerValue(i);
+    if (i % 2 == 0) {
+      hll_1.Update(v);
+    } else {
+      hll_2.Update(v);
+    }
+  }
+  hll_1.Merge(hll_2);
+  uint64_t cardinality = hll_1.EstimateCardinality();
+  EXPECT_LE(cardinality, threshold * (1 + error));
+  EXPECT_GE(cardinality, threshold * (1 - error));
+}
+
 }  // namespace test
 }  // namespace peloton
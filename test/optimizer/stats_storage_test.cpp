@@ -14,6 +14,7 @@
 
 #include "optimizer/stats/stats_storage.h"
 #include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/stats_cache.h"
 #include "optimizer/stats/table_stats.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
@@ -252,5 +253,47 @@ TEST_F(StatsStorageTests, GetTableStatsTest) {
   EXPECT_EQ(table_stats->num_rows, tuple_count);
 }
 
+TEST_F(StatsStorageTests, StatsCacheTest) {
+  StatsStorage *stats_storage = StatsStorage::GetInstance();
+  StatsCache *stats_cache = StatsCache::GetInstance();
+  stats_cache->Clear();
+
+  oid_t database_id = 1;
+  oid_t table_id = 3;
+  oid_t column_id = 4;
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           10, 8, 0.5, "12", "3", "1,5,7",
+                                           "random0");
+
+  // The first lookup reads the catalog, the second one is served by the cache
+  uint64_t hits = stats_cache->GetHitCount();
+  auto column_stats_ptr =
+      stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
+  EXPECT_EQ(hits, stats_cache->GetHitCount());
+  EXPECT_EQ(column_stats_ptr,
+            stats_storage->GetColumnStatsByID(database_id, table_id, column_id));
+  EXPECT_EQ(hits + 1, stats_cache->GetHitCount());
+  EXPECT_EQ(10, column_stats_ptr->num_rows);
+
+  // Nothing is cached while a transaction rewrites the stats
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           20, 16, 0.5, "24", "6", "2,10,14",
+                                           "random1", false, txn);
+  stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
+  uint64_t version;
+  EXPECT_EQ(nullptr, stats_cache->Find(table_id, version));
+
+  // Its stats are read once it committed
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(20, stats_storage->GetColumnStatsByID(database_id, table_id,
+                                                  column_id)->num_rows);
+  EXPECT_NE(nullptr, stats_cache->Find(table_id, version));
+
+  stats_cache->Invalidate(table_id);
+  EXPECT_EQ(nullptr, stats_cache->Find(table_id, version));
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -86,6 +86,39 @@ TEST_F(TableStatsCollectorTests, SingleColumnTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// The tile groups are scanned in parallel, or only a sample of them
+TEST_F(TableStatsCollectorTests, ParallelAndSampledTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable());
+  int nrow = 100 * TESTS_TUPLES_PER_TILEGROUP;
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TableStatsCollector stats{data_table.get()};
+  stats.CollectColumnStats();
+  EXPECT_FALSE(stats.IsSampled());
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  auto column_stats_collector = stats.GetColumnStats(0);
+  uint64_t cardinality = column_stats_collector->GetCardinality();
+  double cardinality_error = column_stats_collector->GetCardinalityError();
+  EXPECT_GE(cardinality, nrow * (1 - cardinality_error));
+  EXPECT_LE(cardinality, nrow * (1 + cardinality_error));
+
+  // Every tile group is full, so the sample scales up to the exact count.
+  // The column is unique, so its cardinality scales up as well.
+  TableStatsCollector sampled_stats{data_table.get(), 20};
+  sampled_stats.CollectColumnStats();
+  EXPECT_TRUE(sampled_stats.IsSampled());
+  EXPECT_EQ(sampled_stats.GetActiveTupleCount(), nrow);
+  column_stats_collector = sampled_stats.GetColumnStats(0);
+  cardinality = column_stats_collector->GetCardinality();
+  EXPECT_GE(cardinality, nrow * (1 - 2 * cardinality_error));
+  EXPECT_LE(cardinality, nrow * (1 + 2 * cardinality_error));
+}
+
 // Table with four columns with types Integer, Varchar, Decimal and Timestamp
 // BOOLEAN insertion seems not supported.
 TEST_F(TableStatsCollectorTests, MultiColumnTableTest) {
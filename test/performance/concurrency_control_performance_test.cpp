@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// concurrency_control_performance_test.cpp
+//
+// Identification: test/performance/concurrency_control_performance_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "common/harness.h"
+#include "common/timer.h"
+#include "concurrency/testing_transaction_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Concurrency Control Performance Tests
+//===--------------------------------------------------------------------===//
+
+class ConcurrencyControlPerformanceTests : public PelotonTest {};
+
+static const int kKeyCount = 1000;
+static const int kHotKeyCount = 10;
+static const int kOperationsPerTxn = 10;
+
+std::atomic<size_t> committed_txn_count;
+std::atomic<size_t> aborted_txn_count;
+
+//===------------------------------===//
+// Utility
+//===------------------------------===//
+
+// YCSB-style workload: 90% reads and 10% updates, with half of the operations
+// going to a small set of hot keys
+void RunContendedTransactions(storage::DataTable *table, size_t txn_count,
+                              uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::mt19937 generator(thread_itr);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::uniform_int_distribution<int> hot_key(0, kHotKeyCount - 1);
+  std::uniform_int_distribution<int> cold_key(kHotKeyCount, kKeyCount - 1);
+
+  for (size_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    auto txn = txn_manager.BeginTransaction();
+    bool success = true;
+    for (int op_itr = 0; op_itr < kOperationsPerTxn && success; op_itr++) {
+      int key = percent(generator) < 50 ? hot_key(generator)
+                                        : cold_key(generator);
+      if (percent(generator) < 90) {
+        int result;
+        success = TestingTransactionUtil::ExecuteRead(txn, table, key, result);
+      } else {
+        success = TestingTransactionUtil::ExecuteUpdate(txn, table, key,
+                                                        op_itr);
+      }
+      success = success && txn->GetResult() != ResultType::FAILURE;
+    }
+
+    if (success == false) {
+      txn_manager.AbortTransaction(txn);
+      aborted_txn_count++;
+    } else if (txn_manager.CommitTransaction(txn) == ResultType::SUCCESS) {
+      committed_txn_count++;
+    } else {
+      aborted_txn_count++;
+    }
+  }
+}
+
+TEST_F(ConcurrencyControlPerformanceTests, ContentionTest) {
+  // Run the same contended workload under each protocol
+  std::vector<ProtocolType> protocol_types = {ProtocolType::TIMESTAMP_ORDERING,
+                                              ProtocolType::OPTIMISTIC};
+  size_t thread_count =
+      std::max<size_t>(4, std::thread::hardware_concurrency());
+  size_t txns_per_thread = 1000;
+
+  for (auto protocol_type : protocol_types) {
+    concurrency::TransactionManagerFactory::Configure(
+        protocol_type, IsolationLevelType::SERIALIZABLE,
+        ConflictAvoidanceType::ABORT);
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable(kKeyCount);
+
+    committed_txn_count = 0;
+    aborted_txn_count = 0;
+
+    Timer<> timer;
+    timer.Start();
+
+    LaunchParallelTest(thread_count, RunContendedTransactions, table,
+                       txns_per_thread);
+
+    timer.Stop();
+    UNUSED_ATTRIBUTE double throughput =
+        committed_txn_count / timer.GetDuration();
+    UNUSED_ATTRIBUTE double abort_rate =
+        100.0 * aborted_txn_count / (thread_count * txns_per_thread);
+    LOG_INFO("Protocol: %s, threads: %lu, commits per second: %.0lf, "
+             "abort rate: %.1lf%%",
+             ProtocolTypeToString(protocol_type).c_str(), thread_count,
+             throughput, abort_rate);
+
+    EXPECT_EQ(thread_count * txns_per_thread,
+              committed_txn_count + aborted_txn_count);
+    EXPECT_LT(0, committed_txn_count);
+  }
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+}  // namespace test
+}  // namespace peloton
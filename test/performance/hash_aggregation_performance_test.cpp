@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_aggregation_performance_test.cpp
+//
+// Identification: test/performance/hash_aggregation_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "murmur3/MurmurHash3.h"
+
+#include "codegen/util/oa_hash_table.h"
+#include "common/harness.h"
+#include "common/timer.h"
+#include "executor/executor_context.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Hash Aggregation Performance Tests
+//
+// Compares the two ways of computing SUM() and COUNT() (i.e., the partial
+// aggregates of AVG()) per group, over a growing number of groups:
+//  - Serial: a single thread aggregates into a single OAHashTable
+//  - Parallel: each thread aggregates into its own OAHashTable, and the
+//    thread-local tables are merged with MergePartitioned()
+//===--------------------------------------------------------------------===//
+
+class HashAggregationPerformanceTest : public PelotonTest {};
+
+namespace {
+
+using OAHashTable = codegen::util::OAHashTable;
+
+struct GroupKey {
+  uint64_t k;
+  bool operator==(const GroupKey &rhs) const { return k == rhs.k; }
+  uint64_t Hash() const {
+    return MurmurHash3_x86_32(&k, sizeof(uint64_t), 12345);
+  }
+};
+
+struct GroupValue {
+  uint64_t sum, count;
+};
+
+// Add the partial aggregates to the group of the key
+void Aggregate(OAHashTable &table, uint64_t hash, const GroupKey &key,
+               const GroupValue &value) {
+  std::function<void(const GroupValue &)> merge = [&value](
+      const GroupValue &agg) {
+    auto &group = const_cast<GroupValue &>(agg);
+    group.sum += value.sum;
+    group.count += value.count;
+  };
+  if (!table.Probe(hash, key, merge)) {
+    table.Insert(hash, key, value);
+  }
+}
+
+// The merge function of the partitions
+void MergeGroups(void *, OAHashTable *partition,
+                 OAHashTable::HashEntry **entries, uint64_t num_entries) {
+  for (uint64_t i = 0; i < num_entries; i++) {
+    auto *entry = entries[i];
+    const auto &key = *reinterpret_cast<const GroupKey *>(entry->data);
+    const auto &value =
+        *reinterpret_cast<const GroupValue *>(entry->data + sizeof(GroupKey));
+    Aggregate(*partition, entry->hash, key, value);
+  }
+}
+
+// Check the number of groups and the total count of all groups
+void CheckGroups(OAHashTable &table, uint64_t &num_groups,
+                 uint64_t &num_rows) {
+  for (auto iter = table.begin(), end = table.end(); iter != end; ++iter) {
+    num_groups++;
+    num_rows += reinterpret_cast<const GroupValue *>(iter.Value())->count;
+  }
+}
+
+double SerialAggregation(uint64_t num_rows, uint64_t num_groups) {
+  OAHashTable table{sizeof(GroupKey), sizeof(GroupValue)};
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  for (uint64_t i = 0; i < num_rows; i++) {
+    GroupKey key{i % num_groups};
+    Aggregate(table, key.Hash(), key, GroupValue{i, 1});
+  }
+
+  timer.Stop();
+
+  uint64_t groups = 0, rows = 0;
+  CheckGroups(table, groups, rows);
+  EXPECT_EQ(num_groups, groups);
+  EXPECT_EQ(num_rows, rows);
+  return timer.GetDuration();
+}
+
+double ParallelAggregation(uint32_t num_threads, uint64_t num_rows,
+                           uint64_t num_groups) {
+  executor::ExecutorContext exec_ctx{nullptr};
+  auto &thread_states = exec_ctx.GetThreadStates();
+  thread_states.Reset(sizeof(OAHashTable));
+  thread_states.Allocate(num_threads);
+
+  std::vector<char> partition_space(sizeof(OAHashTable) *
+                                    OAHashTable::kNumMergePartitions);
+  auto *partitions = reinterpret_cast<OAHashTable *>(partition_space.data());
+  OAHashTable::InitPartitions(partitions);
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  // Each thread pre-aggregates a disjoint range of rows, that covers all groups
+  uint64_t rows_per_thread = num_rows / num_threads;
+  auto aggregate_fn = [&thread_states, num_threads, num_rows,
+                       num_groups, rows_per_thread](uint64_t tid) {
+    auto *table =
+        reinterpret_cast<OAHashTable *>(thread_states.AccessThreadState(tid));
+    OAHashTable::Init(*table, sizeof(GroupKey), sizeof(GroupValue),
+                      OAHashTable::kDefaultInitialSize);
+
+    uint64_t start = tid * rows_per_thread;
+    uint64_t end =
+        (tid == num_threads - 1) ? num_rows : start + rows_per_thread;
+    for (uint64_t i = start; i < end; i++) {
+      GroupKey key{i % num_groups};
+      Aggregate(*table, key.Hash(), key, GroupValue{i, 1});
+    }
+  };
+  LaunchParallelTest(num_threads, aggregate_fn);
+
+  OAHashTable::MergePartitioned(nullptr, thread_states, 0, partitions,
+                                MergeGroups);
+
+  timer.Stop();
+
+  uint64_t groups = 0, rows = 0;
+  for (uint32_t part = 0; part < OAHashTable::kNumMergePartitions; part++) {
+    CheckGroups(partitions[part], groups, rows);
+  }
+  EXPECT_EQ(num_groups, groups);
+  EXPECT_EQ(num_rows, rows);
+
+  OAHashTable::DestroyPartitions(partitions);
+  for (uint32_t tid = 0; tid < num_threads; tid++) {
+    OAHashTable::Destroy(
+        *reinterpret_cast<OAHashTable *>(thread_states.AccessThreadState(tid)));
+  }
+  return timer.GetDuration();
+}
+
+// Compare both ways over every number of groups
+void SerialVsParallel(uint64_t num_rows,
+                      const std::vector<uint64_t> &group_counts) {
+  auto num_threads = std::max(
+      threadpool::MonoQueuePool::GetExecutionInstance().NumWorkers(), 1u);
+
+  for (auto num_groups : group_counts) {
+    double serial_ms = SerialAggregation(num_rows, num_groups);
+    double parallel_ms = ParallelAggregation(num_threads, num_rows, num_groups);
+    LOG_INFO(
+        "%lu rows, %lu groups, %u threads: serial %.2lf ms, parallel %.2lf ms "
+        "(%.2lfx)",
+        num_rows, num_groups, num_threads, serial_ms, parallel_ms,
+        serial_ms / parallel_ms);
+  }
+}
+
+}  // namespace
+
+TEST_F(HashAggregationPerformanceTest, SerialVsParallelAggregation) {
+  SerialVsParallel(1000000, {10, 1000, 100000, 1000000});
+}
+
+// The full sweep needs more than 10 GB of memory, run it explicitly with
+// --gtest_also_run_disabled_tests
+TEST_F(HashAggregationPerformanceTest,
+       DISABLED_LargeSerialVsParallelAggregation) {
+  SerialVsParallel(100000000, {10, 1000, 100000, 10000000, 100000000});
+}
+
+}  // namespace test
+}  // namespace peloton
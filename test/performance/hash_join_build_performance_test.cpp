@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_join_build_performance_test.cpp
+//
+// Identification: test/performance/hash_join_build_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "murmur3/MurmurHash3.h"
+
+#include "codegen/util/hash_table.h"
+#include "common/harness.h"
+#include "common/timer.h"
+#include "executor/executor_context.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Hash Join Build Performance Tests
+//
+// Compares the two ways of building the global hash table of a parallel hash
+// join from thread-local tables:
+//  - Merge: ReserveLazy() + concurrent MergeLazyUnfinished() of each table
+//  - Partitioned: BuildLazyPartitioned()
+//===--------------------------------------------------------------------===//
+
+class HashJoinBuildPerformanceTest : public PelotonTest {};
+
+namespace {
+
+// The build-side tuple: a join key and a payload
+struct BuildKey {
+  uint64_t k;
+  bool operator==(const BuildKey &rhs) const { return k == rhs.k; }
+  uint64_t Hash() const {
+    return MurmurHash3_x86_32(&k, sizeof(uint64_t), 12345);
+  }
+};
+
+struct BuildValue {
+  uint64_t v1, v2;
+};
+
+// Fill one thread-local hash table per thread with a disjoint range of keys
+void LoadThreadLocalTables(executor::ExecutorContext &exec_ctx,
+                           uint32_t num_threads, uint64_t num_rows) {
+  auto &thread_states = exec_ctx.GetThreadStates();
+  thread_states.Reset(sizeof(codegen::util::HashTable));
+  thread_states.Allocate(num_threads);
+
+  uint64_t rows_per_thread = num_rows / num_threads;
+  auto insert_fn = [&exec_ctx, num_threads, num_rows,
+                    rows_per_thread](uint64_t tid) {
+    auto *table = reinterpret_cast<codegen::util::HashTable *>(
+        exec_ctx.GetThreadStates().AccessThreadState(tid));
+    codegen::util::HashTable::Init(*table, exec_ctx, sizeof(BuildKey),
+                                   sizeof(BuildValue));
+
+    uint64_t start = tid * rows_per_thread;
+    uint64_t end =
+        (tid == num_threads - 1) ? num_rows : start + rows_per_thread;
+    for (uint64_t i = start; i < end; i++) {
+      BuildKey key{i};
+      BuildValue val{i, tid};
+      table->TypedInsertLazy(key.Hash(), key, val);
+    }
+  };
+  LaunchParallelTest(num_threads, insert_fn);
+}
+
+void DestroyThreadLocalTables(executor::ExecutorContext &exec_ctx) {
+  auto &thread_states = exec_ctx.GetThreadStates();
+  for (uint32_t tid = 0; tid < thread_states.NumThreads(); tid++) {
+    codegen::util::HashTable::Destroy(
+        *reinterpret_cast<codegen::util::HashTable *>(
+            thread_states.AccessThreadState(tid)));
+  }
+}
+
+// Probe a sample of the keys to make sure the build was correct
+void CheckBuild(codegen::util::HashTable &table, uint64_t num_rows) {
+  EXPECT_EQ(num_rows, table.NumElements());
+  uint64_t step = std::max<uint64_t>(num_rows / 1000, 1);
+  for (uint64_t i = 0; i < num_rows; i += step) {
+    BuildKey key{i};
+    uint32_t count = 0;
+    std::function<void(const BuildValue &)> f =
+        [&key, &count](const BuildValue &v) {
+          EXPECT_EQ(key.k, v.v1);
+          count++;
+        };
+    table.TypedProbe(key.Hash(), key, f);
+    EXPECT_EQ(1, count);
+  }
+}
+
+double MergeBuild(uint32_t num_threads, uint64_t num_rows) {
+  executor::ExecutorContext exec_ctx{nullptr};
+  LoadThreadLocalTables(exec_ctx, num_threads, num_rows);
+
+  auto &thread_states = exec_ctx.GetThreadStates();
+  codegen::util::HashTable global_table{*exec_ctx.GetPool(), sizeof(BuildKey),
+                                        sizeof(BuildValue)};
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  global_table.ReserveLazy(thread_states, 0);
+  auto merge_fn = [&global_table, &thread_states](uint64_t tid) {
+    global_table.MergeLazyUnfinished(
+        *reinterpret_cast<codegen::util::HashTable *>(
+            thread_states.AccessThreadState(tid)));
+  };
+  LaunchParallelTest(num_threads, merge_fn);
+
+  timer.Stop();
+
+  CheckBuild(global_table, num_rows);
+  DestroyThreadLocalTables(exec_ctx);
+  return timer.GetDuration();
+}
+
+double PartitionedBuild(uint32_t num_threads, uint64_t num_rows) {
+  executor::ExecutorContext exec_ctx{nullptr};
+  LoadThreadLocalTables(exec_ctx, num_threads, num_rows);
+
+  auto &thread_states = exec_ctx.GetThreadStates();
+  codegen::util::HashTable global_table{*exec_ctx.GetPool(), sizeof(BuildKey),
+                                        sizeof(BuildValue)};
+
+  Timer<std::milli> timer;
+  timer.Start();
+
+  global_table.BuildLazyPartitioned(thread_states, 0);
+
+  timer.Stop();
+
+  CheckBuild(global_table, num_rows);
+  DestroyThreadLocalTables(exec_ctx);
+  return timer.GetDuration();
+}
+
+}  // namespace
+
+TEST_F(HashJoinBuildPerformanceTest, MergeVsPartitionedBuild) {
+  auto num_threads = std::max(
+      threadpool::MonoQueuePool::GetExecutionInstance().NumWorkers(), 1u);
+
+  std::vector<uint64_t> input_sizes = {10000000, 50000000, 100000000};
+  for (auto num_rows : input_sizes) {
+    double merge_ms = MergeBuild(num_threads, num_rows);
+    double partitioned_ms = PartitionedBuild(num_threads, num_rows);
+    LOG_INFO(
+        "%lu rows, %u threads: merge build %.2lf ms, partitioned build %.2lf "
+        "ms (%.2lfx)",
+        num_rows, num_threads, merge_ms, partitioned_ms,
+        merge_ms / partitioned_ms);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
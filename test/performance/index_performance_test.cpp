@@ -13,6 +13,9 @@
 #include "common/harness.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <vector>
 
@@ -365,10 +368,194 @@ static void TestIndexPerformance(const IndexType &index_type) {
   return;
 }
 
+//===--------------------------------------------------------------------===//
+// Workloads for comparing index types
+//
+// Every thread records the latency of each operation in its own slot of
+// latencies, so that the tail can be reported next to the throughput.
+//===--------------------------------------------------------------------===//
+
+using LatencyList = std::vector<std::vector<double>>;
+
+static void SetKey(storage::Tuple *key, size_t i) {
+  auto key_value = type::ValueFactory::GetIntegerValue(i);
+  key->SetValue(0, key_value, nullptr);
+  key->SetValue(1, key_value, nullptr);
+}
+
+/*
+ * AppendInsertTest() - All threads insert ever increasing keys, like
+ *                      timestamps, so they all hit the end of the index
+ */
+static void AppendInsertTest(index::Index *index, size_t num_key,
+                             std::atomic<size_t> *next_key,
+                             LatencyList *latencies, uint64_t thread_id) {
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  auto &thread_latencies = (*latencies)[thread_id];
+
+  for (size_t j = 0; j < num_key; j++) {
+    SetKey(key.get(), next_key->fetch_add(1));
+
+    auto start = std::chrono::steady_clock::now();
+    auto status = index->InsertEntry(key.get(), item.get());
+    thread_latencies.push_back(
+        std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count());
+    EXPECT_TRUE(status);
+  }
+}
+
+/*
+ * RangeScanTest() - Each thread scans short ranges of a loaded index
+ */
+static void RangeScanTest(index::Index *index, size_t num_scan,
+                          size_t total_key, size_t range_size,
+                          LatencyList *latencies, uint64_t thread_id) {
+  auto &thread_latencies = (*latencies)[thread_id];
+  std::vector<ItemPointer *> result;
+
+  for (size_t j = 0; j < num_scan; j++) {
+    size_t low = ((thread_id + 1) * 7919 * (j + 1)) % (total_key - range_size);
+    std::vector<type::Value> values = {
+        type::ValueFactory::GetIntegerValue(low),
+        type::ValueFactory::GetIntegerValue(low + range_size - 1)};
+
+    result.clear();
+    auto start = std::chrono::steady_clock::now();
+    index->ScanTest(values, {0, 0},
+                    {ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                     ExpressionType::COMPARE_LESSTHANOREQUALTO},
+                    ScanDirectionType::FORWARD, result);
+    thread_latencies.push_back(
+        std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count());
+    EXPECT_EQ(range_size, result.size());
+  }
+}
+
+/*
+ * MixedTest() - Half point lookups of loaded keys, a quarter inserts of new
+ *               keys and a quarter deletes of the keys the thread inserted
+ */
+static void MixedTest(index::Index *index, size_t num_op, size_t total_key,
+                      LatencyList *latencies, uint64_t thread_id) {
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  auto &thread_latencies = (*latencies)[thread_id];
+  std::vector<ItemPointer *> result;
+
+  // New keys of this thread start after the loaded ones and do not overlap
+  // with those of other threads
+  size_t next_insert = total_key + thread_id * num_op;
+  size_t next_delete = next_insert;
+
+  for (size_t j = 0; j < num_op; j++) {
+    auto start = std::chrono::steady_clock::now();
+    if (j % 4 == 1) {
+      SetKey(key.get(), next_insert++);
+      EXPECT_TRUE(index->InsertEntry(key.get(), item.get()));
+    } else if (j % 4 == 3) {
+      SetKey(key.get(), next_delete++);
+      EXPECT_TRUE(index->DeleteEntry(key.get(), item.get()));
+    } else {
+      SetKey(key.get(), ((thread_id + 1) * 104729 * (j + 1)) % total_key);
+      result.clear();
+      index->ScanKey(key.get(), result);
+      EXPECT_EQ(1, result.size());
+    }
+    thread_latencies.push_back(
+        std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count());
+  }
+}
+
+/*
+ * ReportLatencies() - Log the throughput and the tail latency of a workload
+ */
+static void ReportLatencies(const std::string &workload,
+                            const IndexType &index_type, double duration,
+                            LatencyList &latencies) {
+  std::vector<double> all;
+  for (auto &thread_latencies : latencies) {
+    all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+    thread_latencies.clear();
+  }
+  std::sort(all.begin(), all.end());
+  PELOTON_ASSERT(all.empty() == false);
+
+  LOG_INFO(
+      "%s :: Type=%s; Duration=%.2lf; Ops/s=%.0lf; p50=%.2lfus; "
+      "p99=%.2lfus; p99.9=%.2lfus; max=%.2lfus",
+      workload.c_str(), IndexTypeToString(index_type).c_str(), duration,
+      all.size() / duration, all[all.size() / 2], all[all.size() * 99 / 100],
+      all[all.size() * 999 / 1000], all.back());
+}
+
+/*
+ * CompareIndexPerformance() - Run the comparison workloads against an index
+ *                             of the given type
+ */
+static void CompareIndexPerformance(const IndexType &index_type) {
+  std::vector<ItemPointer *> location_ptrs;
+  std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+  size_t num_thread = 4;
+  size_t num_key = 1024 * 256;
+  size_t total_key = num_thread * num_key;
+  LatencyList latencies(num_thread);
+
+  Timer<> timer;
+
+  // Insert-heavy: ever increasing keys
+  std::atomic<size_t> next_key{0};
+  timer.Start();
+  LaunchParallelTest(num_thread, AppendInsertTest, index.get(), num_key,
+                     &next_key, &latencies);
+  timer.Stop();
+  ReportLatencies("AppendInsert", index_type, timer.GetDuration(), latencies);
+
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(total_key, location_ptrs.size());
+  location_ptrs.clear();
+
+  // Scan-heavy: ranges of 100 keys
+  size_t num_scan = 1024 * 16;
+  timer.Start();
+  LaunchParallelTest(num_thread, RangeScanTest, index.get(), num_scan,
+                     total_key, 100, &latencies);
+  timer.Stop();
+  ReportLatencies("RangeScan", index_type, timer.GetDuration(), latencies);
+
+  // Mixed
+  timer.Start();
+  LaunchParallelTest(num_thread, MixedTest, index.get(), num_key, total_key,
+                     &latencies);
+  timer.Stop();
+  ReportLatencies("Mixed", index_type, timer.GetDuration(), latencies);
+
+  if (index->NeedGC() == true) {
+    index->PerformGC();
+  }
+
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(total_key, location_ptrs.size());
+  location_ptrs.clear();
+
+  delete tuple_schema;
+}
+
 TEST_F(IndexPerformanceTests, BwTreeMultiThreadedTest) {
   TestIndexPerformance(IndexType::BWTREE);
 }
 
+TEST_F(IndexPerformanceTests, SkipListMultiThreadedTest) {
+  TestIndexPerformance(IndexType::SKIPLIST);
+}
+
+TEST_F(IndexPerformanceTests, BwTreeVsSkipListTest) {
+  CompareIndexPerformance(IndexType::BWTREE);
+  CompareIndexPerformance(IndexType::SKIPLIST);
+}
+
 // TEST_F(IndexPerformanceTests, BTreeMultiThreadedTest) {
 //  TestIndexPerformance(IndexType::BTREE);
 //}
@@ -11,8 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <atomic>
@@ -84,6 +86,42 @@ void InsertTuple(storage::DataTable *table, type::AbstractPool *pool,
   txn_manager.CommitTransaction(txn);
 }
 
+void InsertTuplesWithIndexes(storage::DataTable *table,
+                             type::AbstractPool *pool, oid_t tuple_count,
+                             UNUSED_ATTRIBUTE uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  const oid_t batch_size = 100;
+
+  // The tuple is reused, only the inlined columns change between inserts
+  std::unique_ptr<storage::Tuple> tuple(
+      TestingExecutorUtil::GetTuple(table, 0, pool));
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr += batch_size) {
+    auto txn = txn_manager.BeginTransaction();
+    for (oid_t batch_itr = 0;
+         batch_itr < batch_size && tuple_itr + batch_itr < tuple_count;
+         batch_itr++) {
+      int tuple_id = ++loader_tuple_id;
+      tuple->SetValue(0, type::ValueFactory::GetIntegerValue(
+                             TestingExecutorUtil::PopulatedValue(tuple_id, 0)),
+                      pool);
+      tuple->SetValue(1, type::ValueFactory::GetIntegerValue(
+                             TestingExecutorUtil::PopulatedValue(tuple_id, 1)),
+                      pool);
+      tuple->SetValue(2, type::ValueFactory::GetDecimalValue(
+                             TestingExecutorUtil::PopulatedValue(tuple_id, 2)),
+                      pool);
+
+      ItemPointer *index_entry_ptr = nullptr;
+      ItemPointer location =
+          table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+      EXPECT_FALSE(location.IsNull());
+      txn_manager.PerformInsert(txn, location, index_entry_ptr);
+    }
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
 TEST_F(InsertPerformanceTests, LoadingTest) {
   // We are going to simply load tile groups concurrently in this test
   // WARNING: This test may potentially run for a long time if
@@ -158,5 +196,44 @@ TEST_F(InsertPerformanceTests, LoadingTest) {
                bytes_to_megabytes_converter);
 }
 
+TEST_F(InsertPerformanceTests, ScalabilityTest) {
+  // Insert through the indexes with a growing number of threads, each of
+  // them with its own active tile group and indirection array
+  oid_t tuples_per_thread = 10000;
+  size_t max_thread_count =
+      std::max<size_t>(32, std::thread::hardware_concurrency());
+
+  auto active_tile_group_count = storage::DataTable::GetActiveTileGroupCount();
+  auto active_indirection_array_count =
+      storage::DataTable::GetActiveIndirectionArrayCount();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  for (size_t thread_count = 1; thread_count <= max_thread_count;
+       thread_count *= 2) {
+    storage::DataTable::SetActiveTileGroupCount(thread_count);
+    storage::DataTable::SetActiveIndirectionArrayCount(thread_count);
+    std::unique_ptr<storage::DataTable> data_table(
+        TestingExecutorUtil::CreateTable(TEST_TUPLES_PER_TILEGROUP, true));
+
+    Timer<> timer;
+    timer.Start();
+
+    LaunchParallelTest(thread_count, InsertTuplesWithIndexes, data_table.get(),
+                       testing_pool, tuples_per_thread);
+
+    timer.Stop();
+    UNUSED_ATTRIBUTE double throughput =
+        thread_count * tuples_per_thread / timer.GetDuration();
+    LOG_INFO("Threads: %lu, inserts per second: %.0lf", thread_count,
+             throughput);
+
+    EXPECT_EQ(thread_count * tuples_per_thread, data_table->GetTupleCount());
+  }
+
+  storage::DataTable::SetActiveTileGroupCount(active_tile_group_count);
+  storage::DataTable::SetActiveIndirectionArrayCount(
+      active_indirection_array_count);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_scan_performance_test.cpp
+//
+// Identification: test/performance/vectorized_scan_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+
+#include "codegen/counting_consumer.h"
+#include "common/harness.h"
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "expression/conjunction_expression.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Vectorized Scan Performance Tests
+//
+// Compares a filtered sequential scan in the interpreted engine, whose
+// predicate is evaluated a batch at a time, with the same scan compiled to
+// native code. The interpreted scan is meant to stay within 2-3x of the
+// compiled one.
+//===--------------------------------------------------------------------===//
+
+class VectorizedScanPerformanceTest : public PelotonCodeGenTest {
+ public:
+  static constexpr uint32_t kNumRows = 200000;
+  static constexpr uint32_t kNumRuns = 5;
+
+  VectorizedScanPerformanceTest() : PelotonCodeGenTest() {
+    LoadTestTable(TestTableId(), kNumRows);
+  }
+
+  oid_t TestTableId() const { return test_table_oids[0]; }
+
+  // a >= 10 * kNumRows / 4 AND b < 10 * 3 * kNumRows / 4, half of the rows
+  std::unique_ptr<planner::SeqScanPlan> BuildScan() {
+    auto a_gte = CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0),
+                            ConstIntExpr(10 * kNumRows / 4));
+    auto b_lt = CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 1),
+                          ConstIntExpr(10 * 3 * kNumRows / 4));
+    auto *predicate = new expression::ConjunctionExpression(
+        ExpressionType::CONJUNCTION_AND, a_gte.release(), b_lt.release());
+    return std::unique_ptr<planner::SeqScanPlan>(new planner::SeqScanPlan(
+        &GetTestTable(TestTableId()), predicate, {0, 1}));
+  }
+
+  // Run the scan in the interpreted engine, return the time it took
+  double ExecuteInterpreted(const planner::SeqScanPlan &plan,
+                            uint64_t &num_results) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+    executor::ExecutorContext exec_ctx{txn};
+    executor::SeqScanExecutor executor{&plan, &exec_ctx};
+
+    Timer<std::milli> timer;
+    timer.Start();
+    num_results = 0;
+    EXPECT_TRUE(executor.Init());
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> tile(executor.GetOutput());
+      num_results += tile->GetTupleCount();
+    }
+    timer.Stop();
+
+    txn_manager.CommitTransaction(txn);
+    return timer.GetDuration();
+  }
+
+  // Run the compiled scan, return the time the native code took
+  double ExecuteCompiled(planner::SeqScanPlan &plan, uint64_t &num_results) {
+    codegen::CountingConsumer consumer;
+    auto stats = CompileAndExecute(plan, consumer);
+    num_results = consumer.GetCount();
+    return stats.runtime_stats.plan_ms;
+  }
+};
+
+TEST_F(VectorizedScanPerformanceTest, InterpretedVsCompiledScan) {
+  auto scan = BuildScan();
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  double interpreted_ms = 0.0, compiled_ms = 0.0;
+  for (uint32_t run = 0; run < kNumRuns; run++) {
+    uint64_t interpreted_results, compiled_results;
+    interpreted_ms += ExecuteInterpreted(*scan, interpreted_results);
+    compiled_ms += ExecuteCompiled(*scan, compiled_results);
+    EXPECT_EQ(kNumRows / 2, interpreted_results);
+    EXPECT_EQ(kNumRows / 2, compiled_results);
+  }
+  interpreted_ms /= kNumRuns;
+  compiled_ms /= kNumRuns;
+
+  LOG_INFO("%u rows: interpreted %.2lf ms, compiled %.2lf ms (%.2lfx)",
+           kNumRows, interpreted_ms, compiled_ms,
+           interpreted_ms / std::max(compiled_ms, 0.001));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_pool_performance_test.cpp
+//
+// Identification: test/performance/worker_pool_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/synchronization/count_down_latch.h"
+#include "common/timer.h"
+#include "threadpool/worker_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Worker Pool Performance Tests
+//
+// Measures how quickly tasks are dispatched to the workers:
+//  - Latency: the time between submitting a task to an idle pool and a worker
+//    starting to run it, one task at a time
+//  - Throughput: the number of empty tasks per second that a number of
+//    submitting threads can push through the pool
+//===--------------------------------------------------------------------===//
+
+class WorkerPoolPerformanceTest : public PelotonTest {};
+
+namespace {
+
+uint64_t NowNanos() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void MeasureDispatchLatency(uint32_t num_workers, uint32_t num_tasks) {
+  threadpool::WorkerPool pool("latency-pool", num_workers, 1024);
+  pool.Startup();
+
+  std::vector<uint64_t> latencies;
+  latencies.reserve(num_tasks);
+  for (uint32_t i = 0; i < num_tasks; i++) {
+    // Give the workers time to go idle, a burst after a quiet period is the
+    // case the old polling loop handled worst
+    if (i % 100 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::atomic<uint64_t> start_time{0};
+    uint64_t submit_time = NowNanos();
+    pool.SubmitTask([&start_time] { start_time = NowNanos(); });
+    while (start_time.load() == 0) {
+      std::this_thread::yield();
+    }
+    latencies.push_back(start_time.load() - submit_time);
+  }
+  pool.Shutdown();
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    auto idx = static_cast<size_t>(p * (latencies.size() - 1));
+    return latencies[idx] / 1000.0;
+  };
+  LOG_INFO(
+      "%u workers, %u tasks: dispatch latency p50 %.2lf us, p99 %.2lf us, "
+      "max %.2lf us",
+      num_workers, num_tasks, percentile(0.5), percentile(0.99),
+      percentile(1.0));
+}
+
+void MeasureThroughput(uint32_t num_workers, uint32_t num_submitters,
+                       uint32_t tasks_per_submitter) {
+  threadpool::WorkerPool pool("throughput-pool", num_workers, 1024);
+  pool.Startup();
+
+  uint32_t num_tasks = num_submitters * tasks_per_submitter;
+  common::synchronization::CountDownLatch latch{num_tasks};
+
+  Timer<std::milli> timer;
+  timer.Start();
+  LaunchParallelTest(num_submitters, [&pool, &latch,
+                                      tasks_per_submitter](uint64_t) {
+    for (uint32_t i = 0; i < tasks_per_submitter; i++) {
+      pool.SubmitTask([&latch] { latch.CountDown(); });
+    }
+  });
+  latch.Await(0);
+  timer.Stop();
+
+  auto metrics = pool.GetMetrics();
+  pool.Shutdown();
+
+  LOG_INFO(
+      "%u workers, %u submitters: %.0lf tasks/s, avg wait %.2lf us, max wait "
+      "%.2lf us, %lu stolen, %lu parks",
+      num_workers, num_submitters, num_tasks / timer.GetDuration() * 1000,
+      metrics.total_wait_ns / 1000.0 / metrics.num_dequeued,
+      metrics.max_wait_ns / 1000.0, metrics.num_stolen, metrics.num_parked);
+}
+
+}  // namespace
+
+TEST_F(WorkerPoolPerformanceTest, DispatchLatency) {
+  for (uint32_t num_workers : {1, 4, 8}) {
+    MeasureDispatchLatency(num_workers, 1000);
+  }
+}
+
+TEST_F(WorkerPoolPerformanceTest, DispatchThroughput) {
+  for (uint32_t num_workers : {1, 4, 8}) {
+    for (uint32_t num_submitters : {1, 4}) {
+      MeasureThroughput(num_workers, num_submitters, 250000);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
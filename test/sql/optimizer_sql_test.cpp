@@ -19,6 +19,7 @@
 #include "optimizer/optimizer.h"
 #include "planner/create_plan.h"
 #include "planner/order_by_plan.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 
 using std::shared_ptr;
@@ -766,6 +767,68 @@ TEST_F(OptimizerSQLTests, NestedQueryTest) {
       "select B.a from test as B where exists (select b as a from test as T "
       "where a = B.a and exists (select c from test where T.c = c));",
       {"1", "2", "3", "4"}, false);
+  TestUtil(
+      "select B.a from test as B where not exists (select b from test2 where "
+      "a = B.a);",
+      {"4"}, false);
+  TestUtil(
+      "select a from test where b not in (select b from test2 where a > 2);",
+      {"1", "2"}, false);
+
+  // A NULL in the sub-select means no row can be NOT IN it
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test2 VALUES (6, NULL, '5th');");
+  TestUtil("select a from test where b not in (select b from test2);", {},
+           false);
+}
+
+TEST_F(OptimizerSQLTests, InterpretedNestedQueryTest) {
+  // Semi and anti joins must also work when the plan isn't compiled
+  bool codegen =
+      settings::SettingsManager::GetBool(settings::SettingId::codegen);
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, false);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test2(a int primary key, b int, c varchar(32))");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test2 VALUES (1, 22, '1st');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test2 VALUES (2, 11, '2nd');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test2 VALUES (3, 33, '3rd');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test2 VALUES (5, 00, '4th');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test2 VALUES (6, 11, '5th');");
+
+  // Hash joins. A left row with several matches is produced once.
+  TestUtil(
+      "select B.a from test as B where exists (select b as a from test2 where "
+      "a = B.a);",
+      {"1", "2", "3"}, false);
+  TestUtil("select a from test where b in (select b from test2);",
+           {"1", "2", "3", "4"}, false);
+  TestUtil(
+      "select B.a from test as B where not exists (select b from test2 where "
+      "a = B.a);",
+      {"4"}, false);
+  TestUtil(
+      "select a from test where b not in (select b from test2 where a > 2);",
+      {"1"}, false);
+
+  // Nested-loop joins, as there is no equality between the two sides
+  TestUtil("select a from test where exists (select a from test2 where a > 5);",
+           {"1", "2", "3", "4"}, false);
+  TestUtil(
+      "select a from test where not exists (select a from test2 where a > 5);",
+      {}, false);
+  TestUtil(
+      "select a from test where not exists (select a from test2 where a > "
+      "10);",
+      {"1", "2", "3", "4"}, false);
+
+  // A NULL in the sub-select means no row can be NOT IN it
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test2 VALUES (7, NULL, '6th');");
+  TestUtil("select a from test where b not in (select b from test2);", {},
+           false);
+
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, codegen);
 }
 
 TEST_F(OptimizerSQLTests, NestedQueryWithAggregationTest) {
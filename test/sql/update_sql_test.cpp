@@ -17,7 +17,10 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/create_executor.h"
 #include "planner/create_plan.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
+#include "storage/data_table.h"
+#include "storage/zone_map_manager.h"
 
 namespace peloton {
 namespace test {
@@ -633,5 +636,56 @@ TEST_F(UpdateSQLTests, AttributeOrderUpdateSQLTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(UpdateSQLTests, InPlaceUpdateZoneMapTest) {
+  // A transaction that updates its own version does so in place. The zone map
+  // of the tile group must cover the new value, or scans skip the tile group.
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(a INT, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 1);");
+
+  txn = txn_manager.BeginTransaction();
+  auto table = catalog->GetTableWithName(txn, DEFAULT_DB_NAME,
+                                         DEFAULT_SCHEMA_NAME, "test");
+  txn_manager.CommitTransaction(txn);
+  auto zone_map_manager = storage::ZoneMapManager::GetInstance();
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    zone_map_manager->CreateOrUpdateZoneMapForTileGroup(table, offset,
+                                                        nullptr);
+  }
+
+  // Update with the compiled and with the interpreted update executor, the
+  // scan is compiled either way since only compiled scans skip tile groups
+  bool codegen =
+      settings::SettingsManager::GetBool(settings::SettingId::codegen);
+  for (int key : {2, 3}) {
+    settings::SettingsManager::SetBool(settings::SettingId::codegen,
+                                       key == 2);
+    std::string value = std::to_string(key * 1000);
+    TestingSQLUtil::ExecuteSQLQuery("BEGIN;");
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (" +
+                                    std::to_string(key) + ", " +
+                                    std::to_string(key) + ");");
+    TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = " + value +
+                                    " WHERE a = " + std::to_string(key) +
+                                    ";");
+    TestingSQLUtil::ExecuteSQLQuery("COMMIT;");
+
+    settings::SettingsManager::SetBool(settings::SettingId::codegen, true);
+    TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+        "SELECT a FROM test WHERE b = " + value + ";", {std::to_string(key)});
+  }
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, codegen);
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
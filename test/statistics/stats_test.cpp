@@ -207,6 +207,21 @@ TEST_F(StatsTests, MultiThreadStatsTest) {
   catalog->DropDatabaseWithName(txn, "emp_db");
   txn_manager.CommitTransaction(txn);
 }
+
+TEST_F(StatsTests, QueryExecutionTimeTest) {
+  auto context = stats::BackendStatsContext::GetInstance();
+  std::shared_ptr<Statement> stmt(new Statement("SELECT", "SELECT 1;"));
+  context->InitQueryMetric(stmt, nullptr);
+
+  // The times of the compiled query are recorded in microseconds
+  context->IncrementQueryExecutionTime(1.5, 0.25);
+  context->IncrementQueryExecutionTime(0.5, 2.0);
+
+  auto *query_metric = context->GetOnGoingQueryMetric();
+  EXPECT_EQ(2000, query_metric->GetInterpretedTime().GetCounter());
+  EXPECT_EQ(2250, query_metric->GetNativeTime().GetCounter());
+}
+
 //
 // TEST_F(StatsTests, PerThreadStatsTest) {
 //  FLAGS_stats_mode = STATS_TYPE_ENABLE;
@@ -418,6 +418,65 @@ TEST_F(ZoneMapTests, ZoneMapMultiColumnConjunctionPredicateTest) {
   pred4->ClearParsedPredicates();
   delete conj_pred;
 }
+
+TEST_F(ZoneMapTests, ZoneMapInMemoryMaintenanceTest) {
+  std::unique_ptr<storage::DataTable> data_table(CreateTestTable());
+  storage::ZoneMapManager *zone_map_manager =
+      storage::ZoneMapManager::GetInstance();
+  storage::ZoneMap *zone_map = data_table->GetZoneMap();
+  oid_t last_tile_group = data_table->GetTileGroupCount() - 1;
+
+  // The immutable tile groups got their zone maps when the table was created
+  EXPECT_EQ(last_tile_group, zone_map->GetZoneMapCount());
+  auto tile_group_zone_map = zone_map->GetTileGroupZoneMap(1);
+  ASSERT_NE(nullptr, tile_group_zone_map);
+  EXPECT_EQ(50, tile_group_zone_map->columns[0].min.GetAs<int>());
+  EXPECT_EQ(90, tile_group_zone_map->columns[0].max.GetAs<int>());
+  EXPECT_EQ(0, tile_group_zone_map->columns[0].null_count);
+
+  // The active tile group is still empty, so its zone map rules out any value
+  zone_map_manager->CreateOrUpdateZoneMapForTileGroup(data_table.get(),
+                                                      last_tile_group, nullptr);
+  EXPECT_EQ(last_tile_group + 1, zone_map->GetZoneMapCount());
+  std::vector<storage::PredicateInfo> predicates(1);
+  predicates[0].col_id = 0;
+  predicates[0].comparison_operator = (int)ExpressionType::COMPARE_EQUAL;
+  predicates[0].predicate_value = type::ValueFactory::GetIntegerValue(1000);
+  EXPECT_FALSE(
+      zone_map->ShouldScanTileGroup(predicates.data(), 1, last_tile_group));
+
+  // Inserting into the tile group widens its zone map
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  auto tuple = TestingExecutorUtil::GetTuple(data_table.get(), 100,
+                                             testing_pool);
+  auto txn = txn_manager.BeginTransaction();
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer location =
+      data_table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_TRUE(
+      zone_map->ShouldScanTileGroup(predicates.data(), 1, last_tile_group));
+  predicates[0].predicate_value = type::ValueFactory::GetIntegerValue(10);
+  EXPECT_FALSE(
+      zone_map->ShouldScanTileGroup(predicates.data(), 1, last_tile_group));
+
+  // The widened zone map reaches the catalog through the persister
+  EXPECT_LE(1, zone_map_manager->PersistPendingZoneMaps());
+  auto stats = zone_map_manager->GetZoneMapFromCatalog(
+      data_table->GetDatabaseOid(), data_table->GetOid(), last_tile_group, 0);
+  ASSERT_NE(nullptr, stats);
+  EXPECT_EQ(1000, stats->min.GetAs<int>());
+  EXPECT_EQ(1000, stats->max.GetAs<int>());
+
+  // A slot whose contents are written later drops the zone map
+  data_table->AcquireVersion();
+  EXPECT_EQ(nullptr, zone_map->GetTileGroupZoneMap(last_tile_group));
+  EXPECT_TRUE(
+      zone_map->ShouldScanTileGroup(predicates.data(), 1, last_tile_group));
+}
 }
 }  // End test namespace
-}  // End peloton namespace
\ No newline at end of file
+}  // End peloton namespace
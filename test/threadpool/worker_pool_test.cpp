@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_pool_test.cpp
+//
+// Identification: test/threadpool/worker_pool_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+
+#include "common/harness.h"
+#include "common/synchronization/count_down_latch.h"
+#include "threadpool/worker_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Worker Pool Tests
+//===--------------------------------------------------------------------===//
+
+class WorkerPoolTests : public PelotonTest {};
+
+TEST_F(WorkerPoolTests, BasicTest) {
+  threadpool::WorkerPool pool("test-pool", 4, 1024);
+  pool.Startup();
+
+  const uint32_t num_tasks = 10000;
+  std::atomic<uint32_t> counter{0};
+  common::synchronization::CountDownLatch latch{num_tasks};
+  for (uint32_t i = 0; i < num_tasks; i++) {
+    pool.SubmitTask([&counter, &latch] {
+      counter++;
+      latch.CountDown();
+    });
+  }
+  latch.Await(0);
+  EXPECT_EQ(num_tasks, counter.load());
+
+  auto metrics = pool.GetMetrics();
+  EXPECT_EQ(num_tasks, metrics.num_submitted);
+  EXPECT_EQ(num_tasks, metrics.num_dequeued);
+  EXPECT_EQ(0, metrics.queue_depth);
+  EXPECT_GE(metrics.total_wait_ns, metrics.max_wait_ns);
+
+  pool.Shutdown();
+}
+
+TEST_F(WorkerPoolTests, StealingTest) {
+  threadpool::WorkerPool pool("test-pool", 4, 1024);
+  pool.Startup();
+
+  // Worker 0 gets all the tasks and blocks on the first one, so the others
+  // can only be run by stealing them
+  const uint32_t num_tasks = 100;
+  std::atomic<bool> release{false};
+  common::synchronization::CountDownLatch latch{num_tasks};
+  pool.SubmitTask(
+      [&release, &latch] {
+        while (!release.load()) std::this_thread::yield();
+        latch.CountDown();
+      },
+      0);
+  common::synchronization::CountDownLatch others{num_tasks - 1};
+  for (uint32_t i = 1; i < num_tasks; i++) {
+    pool.SubmitTask(
+        [&latch, &others] {
+          latch.CountDown();
+          others.CountDown();
+        },
+        0);
+  }
+  others.Await(0);
+  release = true;
+  latch.Await(0);
+
+  EXPECT_GT(pool.GetMetrics().num_stolen, 0);
+  pool.Shutdown();
+}
+
+TEST_F(WorkerPoolTests, NestedSubmitTest) {
+  threadpool::WorkerPool pool("test-pool", 2, 1024);
+  pool.Startup();
+
+  // Tasks spawned from within a task are run as well
+  const uint32_t fanout = 100;
+  common::synchronization::CountDownLatch latch{fanout};
+  pool.SubmitTask([&pool, &latch] {
+    for (uint32_t i = 0; i < fanout; i++) {
+      pool.SubmitTask([&latch] { latch.CountDown(); });
+    }
+  });
+  latch.Await(0);
+  pool.Shutdown();
+}
+
+TEST_F(WorkerPoolTests, RestartTest) {
+  threadpool::WorkerPool pool("test-pool", 2, 1024);
+
+  // Tasks submitted before shutting down are drained
+  std::atomic<uint32_t> counter{0};
+  for (uint32_t round = 0; round < 3; round++) {
+    pool.Startup();
+    for (uint32_t i = 0; i < 100; i++) {
+      pool.SubmitTask([&counter] { counter++; });
+    }
+    pool.Shutdown();
+    EXPECT_EQ((round + 1) * 100, counter.load());
+  }
+
+  // Shutdown is idempotent
+  pool.Shutdown();
+}
+
+}  // namespace test
+}  // namespace peloton